@@ -0,0 +1,218 @@
+#!/bin/sh
+
+usage () {
+cat <<EOF
+usage: benchmark.sh [ <option> ... ] [ <cnf> ... ]
+
+-h | --help                 print this command line option summary
+-b | --baseline <csv>       compare results against this baseline
+-c | --configurations       read configurations from '<stdin>'
+-l | --list <file>          read additional instances from file
+-o | --output <csv>         write results to this file
+-r | --repeat <n>           run each instance '<n>' times (keep fastest)
+-t | --threshold <percent>  maximum slowdown (default '10' percent)
+
+Runs the solver with '--stats=json' on the adders 'cnfs/add*.cnf' and the
+given instances (or those listed in the file given with '--list') and
+writes one line per configuration and instance to the CSV file (default
+'benchmark.csv') with conflicts and propagations per second, ticks, the
+maximum resident set size, process time split by profile and clause
+allocations per conflict.
+
+By default the already built solver is benchmarked. With '-c' the solver
+is configured and compiled for each configuration read from '<stdin>',
+one per line, for instance produced by 'gencombi':
+
+  ./gencombi | ./benchmark.sh -c
+
+Note that afterwards the solver stays configured with the last one.
+
+If a baseline is given (for instance a copy of a previous 'benchmark.csv')
+then the results of matching configurations and instances are compared.
+The script fails if results differ or process time increased by more than
+the threshold (instances running less than 0.05 seconds are ignored).
+EOF
+  exit 0
+}
+
+if [ -t 1 ]
+then
+  BOLD="\033[1m"
+  NORMAL="\033[0m"
+  RED="\033[1;31m"
+  GREEN="\033[1;32m"
+fi
+
+die () {
+  echo "${BOLD}benchmark.sh: ${RED}error: ${NORMAL}$*" 1>&2
+  exit 1
+}
+
+msg () {
+  echo "${BOLD}benchmark.sh: ${NORMAL}$*"
+}
+
+baseline=""
+configurations=no
+instances=""
+output=benchmark.csv
+repeat=1
+threshold=10
+
+while [ $# -gt 0 ]
+do
+  case $1 in
+    -h|--help) usage;;
+    -b|--baseline)
+      [ $# -gt 1 ] || die "argument to '$1' missing"
+      shift; baseline="$1"
+      [ -f "$baseline" ] || die "can not find baseline '$baseline'";;
+    -c|--configurations) configurations=yes;;
+    -l|--list)
+      [ $# -gt 1 ] || die "argument to '$1' missing"
+      shift
+      [ -f "$1" ] || die "can not find instance list '$1'"
+      instances="$instances `cat $1`";;
+    -o|--output)
+      [ $# -gt 1 ] || die "argument to '$1' missing"
+      shift; output="$1";;
+    -r|--repeat)
+      [ $# -gt 1 ] || die "argument to '$1' missing"
+      shift; repeat="$1"
+      [ "$repeat" -gt 0 ] 2>/dev/null || die "invalid repeat '$repeat'";;
+    -t|--threshold)
+      [ $# -gt 1 ] || die "argument to '$1' missing"
+      shift; threshold="$1"
+      [ "$threshold" -ge 0 ] 2>/dev/null || \
+        die "invalid threshold '$threshold'";;
+    -*) die "invalid option '$1' (try '-h')";;
+    *) [ -f "$1" ] || die "can not find instance '$1'"
+       instances="$instances $1";;
+  esac
+  shift
+done
+
+instances="`ls cnfs/add*.cnf` $instances"
+
+[ "$baseline" = "$output" ] && \
+  die "baseline and output file '$output' are the same"
+
+# Fields taken from the JSON statistics in this order (after configuration,
+# instance and result) as columns of the CSV file.
+
+fields="conflicts propagations ticks process_time conflicts_per_second \
+propagations_per_second memory parse_time focused_time stable_time \
+reduce_time eliminate_time subsume_time vivify_time probe_time \
+allocations_per_conflict"
+
+header="configuration,instance,result"
+for field in $fields
+do
+  header="$header,$field"
+done
+echo "$header" > "$output" || die "can not write '$output'"
+
+# Run the solver once on the given instance and extract the CSV line.
+
+run_once () {
+  ./satch -q -n --stats=json $1 2>&1 >/dev/null | \
+  awk -v fields="$fields" '
+/^  "[a-z_]*": / {
+  name = $1; gsub (/[":]/, "", name)
+  value = $2; sub (/,$/, "", value)
+  values[name] = value
+}
+END {
+  line = values["result"]
+  n = split (fields, list, " ")
+  for (i = 1; i <= n; i++)
+    line = line "," values[list[i]]
+  print line
+}'
+}
+
+# Run all instances with the currently built solver.
+
+benchmark () {
+  configuration="$1"
+  msg "benchmarking '$configuration'"
+  for instance in $instances
+  do
+    best=""
+    i=0
+    while [ $i -lt $repeat ]
+    do
+      line="`run_once $instance`"
+      [ "$line" ] || die "running '$instance' failed"
+      if [ "$best" ]
+      then
+        best="`echo \"$best\" \"$line\" | awk '{
+	  split ($1, a, ","); split ($2, b, ",")
+	  print (b[5] < a[5] ? $2 : $1) }'`"
+      else
+        best="$line"
+      fi
+      i=`expr $i + 1`
+    done
+    echo "$configuration,$instance,$best" >> "$output"
+    seconds="`echo $best | awk -F, '{print $5}'`"
+    echo "$instance $seconds seconds"
+  done
+}
+
+if [ $configurations = yes ]
+then
+  while IFS= read -r command
+  do
+    $command 1>/dev/null 2>/dev/null || die "'$command' failed"
+    make satch 1>/dev/null 2>/dev/null || \
+      die "'make satch' failed for '$command'"
+    benchmark "$command"
+  done
+else
+  [ -f satch ] || \
+    die "could not find 'satch': run './configure && make' first"
+  [ -f .config ] || die "could not find '.config'"
+  benchmark "`cat .config`"
+fi
+
+msg "wrote '$output'"
+
+[ "$baseline" ] || exit 0
+
+msg "comparing '$output' against baseline '$baseline'"
+
+awk -F, -v threshold=$threshold \
+    -v red="$RED" -v green="$GREEN" -v normal="$NORMAL" '
+FNR == 1 { next }
+NR == FNR { base[$1 "," $2] = $0; next }
+{
+  key = $1 "," $2
+  if (!(key in base))
+    next
+  split (base[key], b, ",")
+  compared++
+  if (b[3] != $3)
+    {
+      printf "%sresult changed%s %s (%s before %s now)\n", \
+        red, normal, key, b[3], $3
+      failed++
+      next
+    }
+  if ($7 < 0.05 && b[7] < 0.05)
+    next
+  change = b[7] ? 100 * ($7 - b[7]) / b[7] : 0
+  ticks = $6 != b[6] ? " (ticks changed)" : ""
+  if (change > threshold)
+    {
+      printf "%sslowdown%s %.1f%% %s (%s before %s now seconds)%s\n", \
+        red, normal, change, key, b[7], $7, ticks
+      failed++
+    }
+  else
+    printf "%sok%s %+.1f%% %s%s\n", green, normal, change, key, ticks
+}
+END {
+  printf "compared %d results with %d failures\n", compared, failed
+  exit (failed > 0)
+}' "$baseline" "$output" || die "regression against '$baseline'"
@@ -4,7 +4,7 @@
 // of the SAT competition.  More precisely we only have DRUP semantics,
 // where added clauses are implied by the formula (also called "asymmetric
 // tautologies" or AT).  It checks learned clauses and deletion of clauses
-// on-the-fly in a slow forward manner and thus is meant for testing and
+// on-the-fly in a forward manner and thus is meant for testing and
 // debugging purposes only.  The code depends on the header-only-file
 // implementation of a generic stack in 'stack.h'. Therefore this checker
 // can easily be used for other SAT solvers by just linking against
@@ -15,6 +15,12 @@
 // expected by DRUP/DRAT and useful to find clauses that have been forgotten
 // to be deleted (from the checker or in general have been 'lost').
 
+// Propagation uses watch vectors with blocking literals and all clauses are
+// kept in a hash table with open addressing which allows to find deleted
+// clauses without traversing watch lists.  Optionally the checker runs in
+// a separate thread ('checker_asynchronous') which receives the literals
+// and clause operations through a queue and checks them in the background.
+
 /*------------------------------------------------------------------------*/
 #include "catch.h"
 #include "colors.h"
@@ -32,11 +38,20 @@
 #include <stdio.h>
 #include <string.h>
 
+// Asynchronous checking uses POSIX threads as portfolio solving does and
+// is not available if the latter is disabled ('NPORTFOLIO').
+
+#ifndef NPORTFOLIO
+#include <pthread.h>
+#endif
+
 /*------------------------------------------------------------------------*/
 
 #define INVALID				UINT_MAX
 #define MAX_SIZE_T			(~(size_t)0)
 #define GARBAGE_COLLECTION_INTERVAL	10000
+#define MINIMUM_TABLE_SIZE		1024
+#define QUEUE_SIZE			(1u << 16)
 
 /*------------------------------------------------------------------------*/
 
@@ -56,22 +71,72 @@ NOT (unsigned lit)
 
 struct clause
 {
-  struct clause *next[2];	// As in 'PicoSAT' and original 'Chaff'.
+  unsigned garbage;		// Satisfied and about to be collected.
   unsigned size;		// The size of the variadic literal array.
   unsigned literals[];		// The actual literals of 'size'.
 };
 
+// The first two literals of a clause are watched.  The blocking literal
+// is another literal of the clause (initially the other watched literal)
+// and if it is true the clause does not have to be visited.
+
+struct watch
+{
+  unsigned blocking;
+  struct clause *clause;
+};
+
+struct watches
+{
+  struct watch *begin, *end, *allocated;
+};
+
+// The hash table uses linear probing and keeps the hash value next to the
+// clause pointer in order to avoid accessing clauses with another hash.
+
+struct bucket
+{
+  size_t hash;
+  struct clause *clause;	// Zero if the bucket is empty.
+};
+
+#ifndef NPORTFOLIO
+
+// Literals and operations are copied to a buffer which is handed over to
+// the checker thread as soon it is full.  The checker thread only works on
+// the handed over buffer while 'busy' is set.
+
+struct queue
+{
+  pthread_t thread;		// Thread checking handed over buffers.
+  pthread_mutex_t lock;		// Protects 'busy' and 'stop'.
+  pthread_cond_t handed;	// Signals hand-over and completed checks.
+  struct int_stack handed_over;	// Owned by the checker thread if busy.
+  int busy;			// Handed over buffer not checked yet.
+  int stop;			// Checker thread should terminate.
+};
+
+#endif
+
 struct checker
 {
   size_t size;			// Number of allocated literals.
   int inconsistent;		// Empty clause added or learned.
   signed char *marks;		// Mark bits for clause simplification
   signed char *values;		// Values '-1', '0', '1'.
-  struct clause **watches;	// Singly linked lists through 'next'.
+  struct watches *watches;	// Watch vectors of literals.
+
+  struct bucket *table;		// Hash table of all clauses.
+  size_t capacity;		// Number of buckets (a power of two).
 
   struct unsigned_stack trail;	// Partial assignment trail.
   struct unsigned_stack clause;	// Temporary clause added or deleted.
 
+#ifndef NPORTFOLIO
+  struct int_stack buffer;	// Operations not handed over yet.
+  struct queue *queue;		// Non-zero if checking asynchronously.
+#endif
+
   // Limits to control garbage collection frequency (and avoid thrashing).
   //
   unsigned new_units;
@@ -293,20 +358,21 @@ checker_assign (struct checker *checker, unsigned lit)
 
 // This is standard boolean constraint propagation until completion.  The
 // function returns zero iff a conflict was found.  Otherwise watch lists
-// are used and updated.  The watching scheme follows the one from 'PicoSAT'
-// and the original 'Chaff' SAT solvers with two links in each clause for
-// the two watched literals at the first two positions.  Replacement of
-// watches is otherwise standard.  We do not use blocking literals though.
+// are used and updated.  The first two literals of a clause are watched
+// and watches contain a blocking literal.  If the blocking literal is true
+// the clause is skipped and if the other watched literal is true it
+// becomes the new blocking literal.  Replacement of watches is standard.
 
 static int
 checker_propagate (struct checker *checker)
 {
   const signed char *const values = checker->values;
-  struct clause **const watches = checker->watches;
+  struct watches *const watches = checker->watches;
 
   size_t propagate = 0;
+  int res = 1;
 
-  while (propagate < SIZE_STACK (checker->trail))
+  while (res && propagate < SIZE_STACK (checker->trail))
     {
       const unsigned lit = ACCESS (checker->trail, propagate);
       propagate++;
@@ -314,28 +380,32 @@ checker_propagate (struct checker *checker)
       const unsigned not_lit = NOT (lit);
       assert (not_lit < checker->size);
 
-      struct clause **p = watches + not_lit;
-      struct clause *c;
+      struct watches *const lit_watches = watches + not_lit;
+      struct watch *q = lit_watches->begin;
+      const struct watch *p = q, *const end = lit_watches->end;
 
-      while ((c = *p))
+      while (p != end)
 	{
+	  const struct watch watch = *q++ = *p++;
+	  if (values[watch.blocking] > 0)
+	    continue;
+	  struct clause *const c = watch.clause;
 	  const size_t size = c->size;
 	  assert (size > 1);
-	  unsigned *literals = c->literals;
-	  const unsigned *end = literals + size;
-	  const unsigned pos = (literals[1] == not_lit);
-	  assert (literals[pos] == not_lit);
-	  const unsigned other = literals[!pos];
+	  unsigned *const literals = c->literals;
+	  const unsigned other = literals[0] ^ literals[1] ^ not_lit;
+	  assert (literals[0] == not_lit || literals[1] == not_lit);
 	  const signed char other_value = values[other];
 	  if (other_value > 0)
 	    {
-	      p = &c->next[pos];
+	      q[-1].blocking = other;
 	      continue;
 	    }
+	  const unsigned *const end_literals = literals + size;
 	  unsigned replacement = INVALID;
 	  signed char replacement_value = -1;
 	  unsigned *r;
-	  for (r = literals + 2; r != end; r++)
+	  for (r = literals + 2; r != end_literals; r++)
 	    {
 	      replacement = *r;
 	      replacement_value = values[replacement];
@@ -344,23 +414,31 @@ checker_propagate (struct checker *checker)
 	    }
 	  if (replacement_value >= 0)
 	    {
+	      literals[0] = other;
+	      literals[1] = replacement;
 	      *r = not_lit;
-	      *p = c->next[pos];
-	      literals[pos] = replacement;
-	      c->next[pos] = watches[replacement];
-	      watches[replacement] = c;
+	      const struct watch new_watch = { other, c };
+	      PUSH (watches[replacement], new_watch);
+	      q--;
 	    }
 	  else if (other_value < 0)
-	    return 0;
+	    {
+	      res = 0;
+	      break;
+	    }
 	  else
 	    {
 	      assert (!other_value);
 	      checker_assign (checker, other);
-	      p = &c->next[pos];
 	    }
 	}
+
+      while (p != end)
+	*q++ = *p++;
+      lit_watches->end = q;
     }
-  return 1;
+
+  return res;
 }
 
 // Backtracking just pops literals from the trail and unassigns them.
@@ -381,80 +459,130 @@ checker_backtrack (struct checker *checker)
 
 /*------------------------------------------------------------------------*/
 
-// We do not use a global stack of clauses and thus can only reach all
-// clauses through the watch lists.  For garbage collection as well as
-// deleting clauses during releasing the checker we need to make sure not to
-// traverse deleted clauses though.  The strategy to avoid this is as
-// follows. We first disconnect from all clauses the second watch.  Then
-// deleting clauses can be done by following first watch links only.
+// Clauses are hashed independently of the order of their literals, since
+// the order of literals of added and deleted clauses might differ and the
+// checker also reorders literals while propagating.
+
+static size_t
+checker_hash_literal (unsigned lit)
+{
+  size_t res = lit + 1;
+  res *= (size_t) 0x9e3779b97f4a7c15ull;
+  res ^= res >> 15;
+  res *= (size_t) 0xbf58476d1ce4e5b9ull;
+  res ^= res >> 13;
+  return res;
+}
+
+static size_t
+checker_hash_clause (struct checker *checker)
+{
+  size_t res = 0;
+  for (all_elements_on_stack (unsigned, lit, checker->clause))
+      res += checker_hash_literal (lit);
+  return res;
+}
+
+static void
+checker_insert_bucket (struct bucket *table, size_t capacity,
+		       size_t hash, struct clause *clause)
+{
+  const size_t mask = capacity - 1;
+  size_t pos = hash & mask;
+  while (table[pos].clause)
+    pos = (pos + 1) & mask;
+  table[pos].hash = hash;
+  table[pos].clause = clause;
+}
+
+// Reinsert all non-garbage clauses into a new table of the given capacity
+// (and release garbage clauses too).
 
 static void
-checker_disconnect_second_watch (unsigned lit, struct clause **p)
+checker_rehash (struct checker *checker, size_t new_capacity)
 {
-  struct clause *c;
-  while ((c = *p))
+  struct bucket *new_table = calloc (new_capacity, sizeof *new_table);
+  if (!new_table)
+    fatal_error ("out-of-memory allocating hash table");
+  struct bucket *const old_table = checker->table;
+  const size_t old_capacity = checker->capacity;
+  for (size_t i = 0; i < old_capacity; i++)
     {
-      const unsigned pos = (c->literals[1] == lit);
-      assert (c->literals[pos] == lit);
-      if (pos)
+      struct clause *const c = old_table[i].clause;
+      if (!c)
+	continue;
+      if (c->garbage)
 	{
-	  *p = c->next[1];
-#ifndef NDEBUG
-	  c->next[1] = 0;	// See assertion ASSERTION below.
-#endif
+	  assert (checker->clauses);
+	  checker->clauses--;
+	  free (c);
 	}
       else
-	p = &c->next[0];
+	checker_insert_bucket (new_table, new_capacity, old_table[i].hash, c);
     }
+  free (old_table);
+  checker->table = new_table;
+  checker->capacity = new_capacity;
 }
 
-// After deleting satisfied clauses during garbage collection we need to
-// watch the second literals in each clause again. This is slightly more
-// tricky since the order in which we add those watches can be random and
-// thus when we traverse the first literal links we might occasionally
-// already use that literal as second watch in the watch list.  For
-// 'checker_release_clauses' this is not possible.
+// Keep the load factor of the hash table below one half.
 
 static void
-checker_reconnect_second_watch (unsigned lit, struct clause **watches)
+checker_insert_clause (struct checker *checker, size_t hash,
+		       struct clause *clause)
 {
-  for (struct clause * c = watches[lit], *next; c; c = next)
+  if (2 * (checker->clauses + 1) > checker->capacity)
     {
-      if (c->literals[0] == lit)
-	{
-	  const unsigned other = c->literals[1];
-	  assert (!c->next[1]);	// ASSERTION
-	  c->next[1] = watches[other];
-	  watches[other] = c;
-	  next = c->next[0];
-	}
-      else
-	{
-	  assert (c->literals[1] == lit);
-	  next = c->next[1];
-	}
+      size_t new_capacity = checker->capacity;
+      if (!new_capacity)
+	new_capacity = MINIMUM_TABLE_SIZE;
+      while (2 * (checker->clauses + 1) > new_capacity)
+	new_capacity *= 2;
+      checker_rehash (checker, new_capacity);
     }
+  checker_insert_bucket (checker->table, checker->capacity, hash, clause);
+  assert (checker->clauses < MAX_SIZE_T);
+  checker->clauses++;
 }
 
-/*------------------------------------------------------------------------*/
-
-// While the two functions above work on watches of individual literals the
-// following two functions go over all literals (using the former though).
+// Removing a clause from the table shifts back following buckets of the
+// same probing sequence instead of using tombstones.
 
 static void
-checker_disconnect_all_second_watches (struct checker *checker)
+checker_remove_bucket (struct checker *checker, size_t pos)
 {
-  struct clause **watches = checker->watches;
-  for (size_t lit = 0; lit < checker->size; lit++)
-    checker_disconnect_second_watch (lit, watches + lit);
+  struct bucket *const table = checker->table;
+  const size_t mask = checker->capacity - 1;
+  table[pos].clause = 0;
+  size_t next = pos;
+  for (;;)
+    {
+      next = (next + 1) & mask;
+      if (!table[next].clause)
+	break;
+      const size_t home = table[next].hash & mask;
+      if (pos <= next ? (pos < home && home <= next)
+	  : (pos < home || home <= next))
+	continue;
+      table[pos] = table[next];
+      table[next].clause = 0;
+      pos = next;
+    }
+  assert (checker->clauses);
+  checker->clauses--;
 }
 
+// Remove the watch of 'lit' to the clause 'c'.
+
 static void
-checker_reconnect_all_second_watches (struct checker *checker)
+checker_disconnect_watch (struct checker *checker,
+			  unsigned lit, struct clause *c)
 {
-  struct clause **watches = checker->watches;
-  for (size_t lit = 0; lit < checker->size; lit++)
-    checker_reconnect_second_watch (lit, watches);
+  struct watches *const watches = checker->watches + lit;
+  struct watch *p = watches->begin;
+  while (assert (p != watches->end), p->clause != c)
+    p++;
+  *p = *--watches->end;
 }
 
 /*------------------------------------------------------------------------*/
@@ -479,77 +607,59 @@ checker_schedule_next_garbage_collection (struct checker *checker)
   checker->wait_to_collect_satisfied_clauses = wait;
 }
 
-// This is similar to connecting / reconnecting watches above.  We assume
-// that we only have first literals watched.  Then we can traverse those
-// first literal links and check a clause for being satisfied.  If we find a
-// satisfied clause we disconnect and delete it from the watch list.
-
-static size_t
-checker_flush_satisfied_clauses (struct checker *checker, unsigned lit,
-				 struct clause **const watches,
-				 const signed char *const values)
+static int
+checker_satisfied_clause (struct checker *checker, struct clause *c)
 {
-  struct clause **p = watches + lit, *c;
-  size_t collected = 0;
-  while ((c = *p))
-    {
-      const unsigned *const literals = c->literals;
-      assert (literals[0] == lit);
-      const unsigned *const end = literals + c->size;
-      int satisfied = 0;
-      for (const unsigned *p = literals; !satisfied && p != end; p++)
-	{
-	  const unsigned other = *p;
-	  const signed char value = values[other];
-	  satisfied = (value > 0);
-	}
-      if (satisfied)
-	{
-	  collected++;
-	  *p = c->next[0];
-	  assert (checker->clauses);
-	  checker->clauses--;
-	  free (c);
-	}
-      else
-	p = c->next;
-    }
-  return collected;
+  const signed char *const values = checker->values;
+  const unsigned *const end = c->literals + c->size;
+  for (const unsigned *p = c->literals; p != end; p++)
+    if (values[*p] > 0)
+      return 1;
+  return 0;
 }
 
-// Applies the above function to all literals and collects and prints
-// statistics (the latter only if verbose messages are enabled).
+// The satisfied clause garbage collection function first marks satisfied
+// clauses in the hash table as garbage, then flushes their watches and
+// finally releases them while rehashing the remaining clauses.
 
 static void
-checker_flush_all_satisfied_clauses (struct checker *checker)
+checker_garbage_collection (struct checker *checker)
 {
   assert (EMPTY_STACK (checker->trail));
+  checker->collections++;
 
   size_t collected = 0;
 
-  struct clause **const watches = checker->watches;
-  const signed char *const values = checker->values;
+  struct bucket *const table = checker->table;
+  for (size_t i = 0; i < checker->capacity; i++)
+    {
+      struct clause *const c = table[i].clause;
+      if (c && checker_satisfied_clause (checker, c))
+	c->garbage = 1, collected++;
+    }
+
+  if (collected)
+    {
+      struct watches *const watches = checker->watches;
+      for (size_t lit = 0; lit < checker->size; lit++)
+	{
+	  struct watches *const lit_watches = watches + lit;
+	  struct watch *q = lit_watches->begin;
+	  for (const struct watch * p = q; p != lit_watches->end; p++)
+	    if (!p->clause->garbage)
+	      *q++ = *p;
+	  lit_watches->end = q;
+	}
+      checker_rehash (checker, checker->capacity);
+    }
 
-  for (size_t lit = 0; lit < checker->size; lit++)
-    collected += checker_flush_satisfied_clauses (checker, lit,
-						  watches, values);
   checker->collected += collected;
 
   if (checker->verbose)
     printf (checker_prefix "collected %zu satisfied clauses "
 	    "in garbage collection %zu\n", collected,
 	    checker->collections), fflush (stdout);
-}
-
-// The satisfied clause garbage collection function.
 
-static void
-checker_garbage_collection (struct checker *checker)
-{
-  checker->collections++;
-  checker_disconnect_all_second_watches (checker);
-  checker_flush_all_satisfied_clauses (checker);
-  checker_reconnect_all_second_watches (checker);
   checker_schedule_next_garbage_collection (checker);
 }
 
@@ -622,14 +732,15 @@ checker_add_clause (struct checker *checker)
       struct clause *clause = malloc (bytes);
       if (!clause)
 	fatal_error ("out-of-memory allocating clause of size %zu", size);
-      assert (checker->clauses < MAX_SIZE_T);
-      checker->clauses++;
-      struct clause **const watches = checker->watches;
-      clause->next[0] = watches[lit];
-      clause->next[1] = watches[other];
-      watches[lit] = watches[other] = clause;
+      clause->garbage = 0;
       clause->size = size;
       memcpy (clause->literals, begin, size * sizeof (unsigned));
+      checker_insert_clause (checker, checker_hash_clause (checker), clause);
+      struct watches *const watches = checker->watches;
+      const struct watch lit_watch = { other, clause };
+      const struct watch other_watch = { lit, clause };
+      PUSH (watches[lit], lit_watch);
+      PUSH (watches[other], other_watch);
     }
 
   if (checker->wait_to_collect_satisfied_clauses)
@@ -642,12 +753,11 @@ checker_add_clause (struct checker *checker)
 
 /*------------------------------------------------------------------------*/
 
-// The delete function works in a similar way but uses mark flags set in
-// 'checker_trivial_clause' to compare clauses.  We try all literals, which
-// is slightly redundant (a one watch scheme for finding the clause would be
-// enough).  In principle we could skip one literal (say the one with the
-// longest watch list).  On the other removing the clause requires to walk
-// that list anyhow, and thus this optimization would not give much.
+// The delete function computes the hash of the temporary clause, probes
+// the hash table for a clause of the same size and hash and then uses the
+// mark flags set in 'checker_trivial_clause' to compare literals.  Only
+// the watch lists of the two watched literals of the found clause have to
+// be traversed to disconnect it.
 
 static void
 checker_internal_delete_clause (struct checker *checker)
@@ -655,66 +765,40 @@ checker_internal_delete_clause (struct checker *checker)
   const size_t size = SIZE_STACK (checker->clause);
   assert (size < UINT_MAX);
 
-  struct clause **const watches = checker->watches;
-  signed char *marks = checker->marks;
-
-  for (all_elements_on_stack (unsigned, lit, checker->clause))
-    {
-      // First search for the link 'cp' which points to the clause 'c' which
-      // matches the marked literals in the temporary clause.
-      //
-      struct clause **cp, *c, **cnext = 0;
-
-      for (cp = watches + lit; (c = *cp); cp = cnext)
-	{
-	  const unsigned *const clits = c->literals;
-	  const unsigned cpos = (clits[1] == lit);
-	  assert (clits[cpos] == lit);
-	  cnext = c->next + cpos;
-
-	  if (c->size != size)	// Size has to match.
-	    continue;
-
-	  const unsigned *const cend = clits + c->size, *cq;
-	  for (cq = clits; cq != cend; cq++)
-	    if (!marks[*cq])
-	      break;		// Literal '*cq' not in temporary clause.
-
-	  if (cq != cend)	// Not all literals marked.
-	    continue;
-
-	  // Now 'c' has exactly the literals as the temporary clause.
+  const size_t hash = checker_hash_clause (checker);
+  const signed char *const marks = checker->marks;
 
-	  *cp = *cnext;		// Remove 'lit' watch on 'c'.
+  struct bucket *const table = checker->table;
+  const size_t mask = checker->capacity - 1;
 
-	  const unsigned other = clits[!cpos];	// The other watched literal.
+  if (table)
+    for (size_t pos = hash & mask; table[pos].clause; pos = (pos + 1) & mask)
+      {
+	if (table[pos].hash != hash)
+	  continue;
 
-	  // Then find the link 'dp' to 'c' but walking the watched list of
-	  // the other watched literal 'other' in 'c'.
+	struct clause *const c = table[pos].clause;
+	if (c->size != size)	// Size has to match.
+	  continue;
 
-	  struct clause **dp = watches + other, *d;
+	const unsigned *const clits = c->literals;
+	const unsigned *const cend = clits + size, *cq;
+	for (cq = clits; cq != cend; cq++)
+	  if (!marks[*cq])
+	    break;		// Literal '*cq' not in temporary clause.
 
-	  while ((d = *dp) != c)
-	    {
-	      assert (d);	// The clause has to be found.
+	if (cq != cend)		// Not all literals marked.
+	  continue;
 
-	      const unsigned *const dlits = d->literals;
-	      const unsigned dpos = (dlits[1] == other);
-	      assert (dlits[dpos] == other);
-
-	      dp = d->next + dpos;
-	    }
-
-	  *dp = c->next[!cpos];	// Remove 'other' watch.
-
-	  assert (checker->clauses);
-	  checker->clauses--;
+	// Now 'c' has exactly the literals as the temporary clause.
 
-	  free (c);
+	checker_remove_bucket (checker, pos);
+	checker_disconnect_watch (checker, clits[0], c);
+	checker_disconnect_watch (checker, clits[1], c);
+	free (c);
 
-	  return;
-	}
-    }
+	return;
+      }
 
   checker_failed (checker, "clause requested to delete not found");
 }
@@ -763,37 +847,28 @@ check_clause_implied (struct checker *checker)
 /*------------------------------------------------------------------------*/
 
 static void
-checker_release_clauses (struct checker *checker, struct clause *c)
+checker_release_all_clauses (struct checker *checker)
 {
-  const signed char *const values = checker->values;
-
   if (!EMPTY_STACK (checker->trail))
     checker_backtrack (checker);
 
-  while (c)
+  struct bucket *const table = checker->table;
+  for (size_t i = 0; i < checker->capacity; i++)
     {
-      struct clause *next = c->next[0];
-      assert (!c->next[1]);
-      const unsigned *const literals = c->literals;
-      const unsigned *const end = literals + c->size;
-      int satisfied = 0;
-      for (const unsigned *p = literals; !satisfied && p != end; p++)
-	satisfied = (values[*p] > 0);
-      if (!satisfied)
+      struct clause *const c = table[i].clause;
+      if (!c)
+	continue;
+      if (!checker_satisfied_clause (checker, c))
 	checker->remained++;
       assert (checker->clauses);
       checker->clauses--;
       free (c);
-      c = next;
     }
-}
+  free (table);
 
-static void
-checker_release_all_clauses (struct checker *checker)
-{
-  checker_disconnect_all_second_watches (checker);
+  struct watches *const watches = checker->watches;
   for (size_t lit = 0; lit < checker->size; lit++)
-    checker_release_clauses (checker, checker->watches[lit]);
+    RELEASE_STACK (watches[lit]);
 }
 
 /*------------------------------------------------------------------------*/
@@ -883,6 +958,192 @@ checker_log_clause (struct checker *checker, const char *type)
 
 #endif
 
+// The three clause operations work on the temporary clause.  They are
+// either called directly by the API functions or in the checker thread.
+
+static void
+checker_original (struct checker *checker)
+{
+#ifdef LOGGING
+  if (checker->logging)
+    checker_log_clause (checker, "original");
+#endif
+  if (checker->inconsistent)
+    {
+      CLEAR_STACK (checker->clause);
+      return;
+    }
+  checker->original++;
+  if (!checker_trivial_clause (checker))
+    checker_add_clause (checker);
+  checker_clear_clause (checker);
+}
+
+static void
+checker_learned (struct checker *checker)
+{
+#ifdef LOGGING
+  if (checker->logging)
+    checker_log_clause (checker, "learned");
+#endif
+  if (checker->inconsistent)
+    {
+      CLEAR_STACK (checker->clause);
+      return;
+    }
+  checker->learned++;
+  check_clause_implied (checker);
+  if (!checker_trivial_clause (checker))
+    checker_add_clause (checker);
+  checker_clear_clause (checker);
+}
+
+static void
+checker_delete (struct checker *checker)
+{
+#ifdef LOGGING
+  if (checker->logging)
+    checker_log_clause (checker, "delete");
+#endif
+  if (checker->inconsistent)
+    {
+      CLEAR_STACK (checker->clause);
+      return;
+    }
+  checker->deleted++;
+  if (!checker_trivial_clause (checker))
+    checker_internal_delete_clause (checker);
+  checker_clear_clause (checker);
+}
+
+/*------------------------------------------------------------------------*/
+#ifndef NPORTFOLIO
+/*------------------------------------------------------------------------*/
+
+// In the queue buffer operations follow the literals of their clause and
+// are encoded as a zero followed by one of these codes.
+
+#define ORIGINAL_OPERATION	1
+#define LEARNED_OPERATION	2
+#define DELETE_OPERATION	3
+
+static void
+checker_execute (struct checker *checker, const struct int_stack *buffer)
+{
+  for (const int *p = buffer->begin; p != buffer->end; p++)
+    {
+      const int elit = *p;
+      if (elit)
+	{
+	  const unsigned ilit = checker_import (checker, elit);
+	  PUSH (checker->clause, ilit);
+	  continue;
+	}
+      const int operation = *++p;
+      if (operation == ORIGINAL_OPERATION)
+	checker_original (checker);
+      else if (operation == LEARNED_OPERATION)
+	checker_learned (checker);
+      else
+	{
+	  assert (operation == DELETE_OPERATION);
+	  checker_delete (checker);
+	}
+    }
+}
+
+static void *
+checker_run_queue (void *ptr)
+{
+  struct checker *const checker = ptr;
+  struct queue *const queue = checker->queue;
+  pthread_mutex_lock (&queue->lock);
+  for (;;)
+    {
+      while (!queue->busy && !queue->stop)
+	pthread_cond_wait (&queue->handed, &queue->lock);
+      if (!queue->busy)
+	break;
+      pthread_mutex_unlock (&queue->lock);
+      checker_execute (checker, &queue->handed_over);
+      CLEAR_STACK (queue->handed_over);
+      pthread_mutex_lock (&queue->lock);
+      queue->busy = 0;
+      pthread_cond_broadcast (&queue->handed);
+    }
+  pthread_mutex_unlock (&queue->lock);
+  return 0;
+}
+
+// Swap the filled buffer with the (empty) handed over buffer as soon the
+// checker thread is done with the previous one.
+
+static void
+checker_hand_over (struct checker *checker)
+{
+  struct queue *const queue = checker->queue;
+  pthread_mutex_lock (&queue->lock);
+  while (queue->busy)
+    pthread_cond_wait (&queue->handed, &queue->lock);
+  const struct int_stack empty = queue->handed_over;
+  queue->handed_over = checker->buffer;
+  checker->buffer = empty;
+  queue->busy = 1;
+  pthread_cond_broadcast (&queue->handed);
+  pthread_mutex_unlock (&queue->lock);
+}
+
+static void
+checker_enqueue (struct checker *checker, int operation)
+{
+  PUSH (checker->buffer, 0);
+  PUSH (checker->buffer, operation);
+  if (SIZE_STACK (checker->buffer) >= QUEUE_SIZE)
+    checker_hand_over (checker);
+}
+
+// Wait until the checker thread checked all operations.  Afterwards the
+// checker can be accessed safely until the next operation is handed over.
+
+static void
+checker_synchronize (struct checker *checker)
+{
+  struct queue *const queue = checker->queue;
+  if (!queue)
+    return;
+  if (!EMPTY_STACK (checker->buffer))
+    checker_hand_over (checker);
+  pthread_mutex_lock (&queue->lock);
+  while (queue->busy)
+    pthread_cond_wait (&queue->handed, &queue->lock);
+  pthread_mutex_unlock (&queue->lock);
+}
+
+static void
+checker_stop_queue (struct checker *checker)
+{
+  struct queue *const queue = checker->queue;
+  if (!queue)
+    return;
+  checker_synchronize (checker);
+  pthread_mutex_lock (&queue->lock);
+  queue->stop = 1;
+  pthread_cond_broadcast (&queue->handed);
+  pthread_mutex_unlock (&queue->lock);
+  if (pthread_join (queue->thread, 0))
+    fatal_error ("failed to join checker thread");
+  pthread_cond_destroy (&queue->handed);
+  pthread_mutex_destroy (&queue->lock);
+  RELEASE_STACK (queue->handed_over);
+  RELEASE_STACK (checker->buffer);
+  free (queue);
+  checker->queue = 0;
+}
+
+/*------------------------------------------------------------------------*/
+#endif
+/*------------------------------------------------------------------------*/
+
 /*========================================================================*/
 //      Non-static functions defined by the API are put below.            //
 /*========================================================================*/
@@ -901,6 +1162,9 @@ void
 checker_verbose (struct checker *checker)
 {
   assert (checker);
+#ifndef NPORTFOLIO
+  checker_synchronize (checker);
+#endif
   checker->verbose = 1;
   printf (checker_prefix "enabling verbose mode of internal proof checker\n");
   fflush (stdout);
@@ -911,6 +1175,9 @@ checker_logging (struct checker *checker)
 {
 #ifdef LOGGING
   assert (checker);
+#ifndef NPORTFOLIO
+  checker_synchronize (checker);
+#endif
   checker->logging = 1;
   printf (logging_prefix "enabling logging mode of internal proof checker\n");
   fflush (stdout);
@@ -923,6 +1190,9 @@ void
 checker_enable_leak_checking (struct checker *checker)
 {
   assert (checker);
+#ifndef NPORTFOLIO
+  checker_synchronize (checker);
+#endif
   checker->leak_checking = 1;
   if (!checker->verbose)
     return;
@@ -931,10 +1201,35 @@ checker_enable_leak_checking (struct checker *checker)
   fflush (stdout);
 }
 
+void
+checker_asynchronous (struct checker *checker)
+{
+  REQUIRE_NON_ZERO_CHECKER ();
+#ifndef NPORTFOLIO
+  if (checker->queue)
+    return;
+  REQUIRE (EMPTY_STACK (checker->clause), "incomplete clause");
+  struct queue *queue = calloc (1, sizeof *queue);
+  if (!queue)
+    fatal_error ("out-of-memory allocating checker queue");
+  pthread_mutex_init (&queue->lock, 0);
+  pthread_cond_init (&queue->handed, 0);
+  checker->queue = queue;
+  if (pthread_create (&queue->thread, 0, checker_run_queue, checker))
+    fatal_error ("failed to create checker thread");
+  if (checker->verbose)
+    printf (checker_prefix "checking proof in separate thread\n"),
+      fflush (stdout);
+#endif
+}
+
 void
 checker_release (struct checker *checker)
 {
   REQUIRE_NON_ZERO_CHECKER ();
+#ifndef NPORTFOLIO
+  checker_stop_queue (checker);
+#endif
   checker_release_all_clauses (checker);
   if (checker->verbose)
     checker_statistics (checker);
@@ -963,6 +1258,13 @@ checker_add_literal (struct checker *checker, int elit)
   REQUIRE (elit != INT_MIN, "'INT_MIN' literal argument");
   assert (elit);
   assert (elit != INT_MIN);
+#ifndef NPORTFOLIO
+  if (checker->queue)
+    {
+      PUSH (checker->buffer, elit);
+      return;
+    }
+#endif
   unsigned ilit = checker_import (checker, elit);
   PUSH (checker->clause, ilit);
 }
@@ -973,56 +1275,34 @@ void
 checker_add_original_clause (struct checker *checker)
 {
   REQUIRE_NON_ZERO_CHECKER ();
-#ifdef LOGGING
-  if (checker->logging)
-    checker_log_clause (checker, "original");
+#ifndef NPORTFOLIO
+  if (checker->queue)
+    checker_enqueue (checker, ORIGINAL_OPERATION);
+  else
 #endif
-  if (checker->inconsistent)
-    {
-      CLEAR_STACK (checker->clause);
-      return;
-    }
-  checker->original++;
-  if (!checker_trivial_clause (checker))
-    checker_add_clause (checker);
-  checker_clear_clause (checker);
+    checker_original (checker);
 }
 
 void
 checker_add_learned_clause (struct checker *checker)
 {
   REQUIRE_NON_ZERO_CHECKER ();
-#ifdef LOGGING
-  if (checker->logging)
-    checker_log_clause (checker, "learned");
+#ifndef NPORTFOLIO
+  if (checker->queue)
+    checker_enqueue (checker, LEARNED_OPERATION);
+  else
 #endif
-  if (checker->inconsistent)
-    {
-      CLEAR_STACK (checker->clause);
-      return;
-    }
-  checker->learned++;
-  check_clause_implied (checker);
-  if (!checker_trivial_clause (checker))
-    checker_add_clause (checker);
-  checker_clear_clause (checker);
+    checker_learned (checker);
 }
 
 void
 checker_delete_clause (struct checker *checker)
 {
   REQUIRE_NON_ZERO_CHECKER ();
-#ifdef LOGGING
-  if (checker->logging)
-    checker_log_clause (checker, "delete");
+#ifndef NPORTFOLIO
+  if (checker->queue)
+    checker_enqueue (checker, DELETE_OPERATION);
+  else
 #endif
-  if (checker->inconsistent)
-    {
-      CLEAR_STACK (checker->clause);
-      return;
-    }
-  checker->deleted++;
-  if (!checker_trivial_clause (checker))
-    checker_internal_delete_clause (checker);
-  checker_clear_clause (checker);
+    checker_delete (checker);
 }
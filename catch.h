@@ -37,6 +37,14 @@ void checker_logging (struct checker *);
 
 void checker_enable_leak_checking (struct checker *);
 
+// Check clauses in a separate thread.  The literals and clause operations
+// are then only copied to a buffer which is handed over to the checker
+// thread whenever it is full (and during 'checker_release').  Thus errors
+// are reported with a delay.  This has no effect if the checker was
+// compiled without POSIX threads support ('NPORTFOLIO' defined).
+
+void checker_asynchronous (struct checker *);
+
 /*------------------------------------------------------------------------*/
 
 // In contrast to the IPASIR interface, the checker only expects (non-zero)
@@ -11,6 +11,9 @@
 #if defined(NBUMP) && defined(NINVERTED)
 #error "'NBUMP' implies 'NINVERTED' (the latter should not be defined)"
 #endif
+#if defined(NBUMP) && defined(NQUATERNARY)
+#error "'NBUMP' implies 'NQUATERNARY' (the latter should not be defined)"
+#endif
 #if defined(NBUMP) && defined(NRESTART)
 #error "'NBUMP' implies 'NRESTART' (the latter should not be defined)"
 #endif
@@ -29,6 +32,9 @@
 #if defined(NBUMP) && defined(NVSIDS)
 #error "'NBUMP' implies 'NVSIDS' (the latter should not be defined)"
 #endif
+#if defined(NCDCL) && defined(NARENA)
+#error "'NCDCL' implies 'NARENA' (the latter should not be defined)"
+#endif
 #if defined(NCDCL) && defined(NBEST)
 #error "'NCDCL' implies 'NBEST' (the latter should not be defined)"
 #endif
@@ -44,6 +50,9 @@
 #if defined(NCDCL) && defined(NGLUE)
 #error "'NCDCL' implies 'NGLUE' (the latter should not be defined)"
 #endif
+#if defined(NCDCL) && defined(NHYPER)
+#error "'NCDCL' implies 'NHYPER' (the latter should not be defined)"
+#endif
 #if defined(NCDCL) && defined(NINPROCESSING)
 #error "'NCDCL' implies 'NINPROCESSING' (the latter should not be defined)"
 #endif
@@ -53,6 +62,15 @@
 #if defined(NCDCL) && defined(NMINIMIZE)
 #error "'NCDCL' implies 'NMINIMIZE' (the latter should not be defined)"
 #endif
+#if defined(NCDCL) && defined(NOTFS)
+#error "'NCDCL' implies 'NOTFS' (the latter should not be defined)"
+#endif
+#if defined(NCDCL) && defined(NPROBING)
+#error "'NCDCL' implies 'NPROBING' (the latter should not be defined)"
+#endif
+#if defined(NCDCL) && defined(NQUATERNARY)
+#error "'NCDCL' implies 'NQUATERNARY' (the latter should not be defined)"
+#endif
 #if defined(NCDCL) && defined(NREDUCE)
 #error "'NCDCL' implies 'NREDUCE' (the latter should not be defined)"
 #endif
@@ -113,6 +131,15 @@
 #if defined(NELIMINATION) && defined(NELIMINATIONLIMITS)
 #error "'NELIMINATION' implies 'NELIMINATIONLIMITS' (the latter should not be defined)"
 #endif
+#if defined(NELIMINATION) && defined(NGATES)
+#error "'NELIMINATION' implies 'NGATES' (the latter should not be defined)"
+#endif
+#if defined(NELIMINATION) && defined(NHYPER)
+#error "'NELIMINATION' implies 'NHYPER' (the latter should not be defined)"
+#endif
+#if defined(NELIMINATION) && defined(NPROBING)
+#error "'NELIMINATION' implies 'NPROBING' (the latter should not be defined)"
+#endif
 #if defined(NELIMINATION) && defined(NSTRENGTHENING)
 #error "'NELIMINATION' implies 'NSTRENGTHENING' (the latter should not be defined)"
 #endif
@@ -128,15 +155,24 @@
 #if defined(NGLUE) && defined(NTIER2)
 #error "'NGLUE' implies 'NTIER2' (the latter should not be defined)"
 #endif
+#if defined(NLEARN) && defined(NARENA)
+#error "'NLEARN' implies 'NARENA' (the latter should not be defined)"
+#endif
 #if defined(NLEARN) && defined(NGLUE)
 #error "'NLEARN' implies 'NGLUE' (the latter should not be defined)"
 #endif
+#if defined(NLEARN) && defined(NHYPER)
+#error "'NLEARN' implies 'NHYPER' (the latter should not be defined)"
+#endif
 #if defined(NLEARN) && defined(NINPROCESSING)
 #error "'NLEARN' implies 'NINPROCESSING' (the latter should not be defined)"
 #endif
 #if defined(NLEARN) && defined(NMINIMIZE)
 #error "'NLEARN' implies 'NMINIMIZE' (the latter should not be defined)"
 #endif
+#if defined(NLEARN) && defined(NOTFS)
+#error "'NLEARN' implies 'NOTFS' (the latter should not be defined)"
+#endif
 #if defined(NLEARN) && defined(NREDUCE)
 #error "'NLEARN' implies 'NREDUCE' (the latter should not be defined)"
 #endif
@@ -173,6 +209,9 @@
 #if defined(NMINIMIZE) && defined(NSHRINK)
 #error "'NMINIMIZE' implies 'NSHRINK' (the latter should not be defined)"
 #endif
+#if defined(NPROBING) && defined(NHYPER)
+#error "'NPROBING' implies 'NHYPER' (the latter should not be defined)"
+#endif
 #if defined(NREDUCE) && defined(NGLUE)
 #error "'NREDUCE' implies 'NGLUE' (the latter should not be defined)"
 #endif
@@ -215,9 +254,18 @@
 #if defined(NSIMPLIFICATION) && defined(NELIMINATIONLIMITS)
 #error "'NSIMPLIFICATION' implies 'NELIMINATIONLIMITS' (the latter should not be defined)"
 #endif
+#if defined(NSIMPLIFICATION) && defined(NGATES)
+#error "'NSIMPLIFICATION' implies 'NGATES' (the latter should not be defined)"
+#endif
+#if defined(NSIMPLIFICATION) && defined(NHYPER)
+#error "'NSIMPLIFICATION' implies 'NHYPER' (the latter should not be defined)"
+#endif
 #if defined(NSIMPLIFICATION) && defined(NINPROCESSING)
 #error "'NSIMPLIFICATION' implies 'NINPROCESSING' (the latter should not be defined)"
 #endif
+#if defined(NSIMPLIFICATION) && defined(NPROBING)
+#error "'NSIMPLIFICATION' implies 'NPROBING' (the latter should not be defined)"
+#endif
 #if defined(NSIMPLIFICATION) && defined(NSTRENGTHENING)
 #error "'NSIMPLIFICATION' implies 'NSTRENGTHENING' (the latter should not be defined)"
 #endif
@@ -251,6 +299,9 @@
 #if defined(NUSED) && defined(NTIER2)
 #error "'NUSED' implies 'NTIER2' (the latter should not be defined)"
 #endif
+#if defined(NVARIADIC) && defined(NARENA)
+#error "'NVARIADIC' implies 'NARENA' (the latter should not be defined)"
+#endif
 #if defined(NVIVIFICATION) && defined(NVIVIFICATIONLIMITS)
 #error "'NVIVIFICATION' implies 'NVIVIFICATIONLIMITS' (the latter should not be defined)"
 #endif
@@ -260,6 +311,9 @@
 #if defined(NVMTF) && defined(NSORTANALYZED)
 #error "'NVMTF' implies 'NSORTANALYZED' (the latter should not be defined)"
 #endif
+#if defined(NVSIDS) && defined(NQUATERNARY)
+#error "'NVSIDS' implies 'NQUATERNARY' (the latter should not be defined)"
+#endif
 #if defined(NWATCHES) && defined(NBLOCK)
 #error "'NWATCHES' implies 'NBLOCK' (the latter should not be defined)"
 #endif
@@ -272,6 +326,18 @@
 #if defined(NWATCHES) && defined(NELIMINATIONLIMITS)
 #error "'NWATCHES' implies 'NELIMINATIONLIMITS' (the latter should not be defined)"
 #endif
+#if defined(NWATCHES) && defined(NGATES)
+#error "'NWATCHES' implies 'NGATES' (the latter should not be defined)"
+#endif
+#if defined(NWATCHES) && defined(NHYPER)
+#error "'NWATCHES' implies 'NHYPER' (the latter should not be defined)"
+#endif
+#if defined(NWATCHES) && defined(NOTFS)
+#error "'NWATCHES' implies 'NOTFS' (the latter should not be defined)"
+#endif
+#if defined(NWATCHES) && defined(NPROBING)
+#error "'NWATCHES' implies 'NPROBING' (the latter should not be defined)"
+#endif
 #if defined(NWATCHES) && defined(NSTRENGTHENING)
 #error "'NWATCHES' implies 'NSTRENGTHENING' (the latter should not be defined)"
 #endif
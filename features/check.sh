@@ -5,20 +5,26 @@
 [ $block = no -a $virtual = no ] && die "'--no-block' implies '--no-virtual'"
 [ $bump = no -a $bumpreasons = no ] && die "'--no-bump' implies '--no-bump-reasons'"
 [ $bump = no -a $inverted = no ] && die "'--no-bump' implies '--no-inverted'"
+[ $bump = no -a $quaternary = no ] && die "'--no-bump' implies '--no-quaternary'"
 [ $bump = no -a $restart = no ] && die "'--no-bump' implies '--no-restart'"
 [ $bump = no -a $reuse = no ] && die "'--no-bump' implies '--no-reuse'"
 [ $bump = no -a $reusestable = no ] && die "'--no-bump' implies '--no-reusestable'"
 [ $bump = no -a $sortanalyzed = no ] && die "'--no-bump' implies '--no-sort-analyzed'"
 [ $bump = no -a $vmtf = no ] && die "'--no-bump' implies '--no-vmtf'"
 [ $bump = no -a $vsids = no ] && die "'--no-bump' implies '--no-vsids'"
+[ $cdcl = no -a $arena = no ] && die "'--no-cdcl' implies '--no-arena'"
 [ $cdcl = no -a $best = no ] && die "'--no-cdcl' implies '--no-best'"
 [ $cdcl = no -a $chrono = no ] && die "'--no-cdcl' implies '--no-chrono'"
 [ $cdcl = no -a $chronoreuse = no ] && die "'--no-cdcl' implies '--no-chronoreuse'"
 [ $cdcl = no -a $focused = no ] && die "'--no-cdcl' implies '--no-focused'"
 [ $cdcl = no -a $glue = no ] && die "'--no-cdcl' implies '--no-glue'"
+[ $cdcl = no -a $hyper = no ] && die "'--no-cdcl' implies '--no-hyper'"
 [ $cdcl = no -a $inprocessing = no ] && die "'--no-cdcl' implies '--no-inprocessing'"
 [ $cdcl = no -a $learn = no ] && die "'--no-cdcl' implies '--no-learn'"
 [ $cdcl = no -a $minimize = no ] && die "'--no-cdcl' implies '--no-minimize'"
+[ $cdcl = no -a $otfs = no ] && die "'--no-cdcl' implies '--no-otfs'"
+[ $cdcl = no -a $probing = no ] && die "'--no-cdcl' implies '--no-probing'"
+[ $cdcl = no -a $quaternary = no ] && die "'--no-cdcl' implies '--no-quaternary'"
 [ $cdcl = no -a $reduce = no ] && die "'--no-cdcl' implies '--no-reduce'"
 [ $cdcl = no -a $restart = no ] && die "'--no-cdcl' implies '--no-restart'"
 [ $cdcl = no -a $reuse = no ] && die "'--no-cdcl' implies '--no-reuse'"
@@ -39,14 +45,20 @@
 [ $control = no -a $vivificationlimits = no ] && die "'--no-control' implies '--no-vivificationlimits'"
 [ $control = no -a $vivifyimply = no ] && die "'--no-control' implies '--no-vivifyimply'"
 [ $elimination = no -a $eliminationlimits = no ] && die "'--no-elimination' implies '--no-elimination-limits'"
+[ $elimination = no -a $gates = no ] && die "'--no-elimination' implies '--no-gates'"
+[ $elimination = no -a $hyper = no ] && die "'--no-elimination' implies '--no-hyper'"
+[ $elimination = no -a $probing = no ] && die "'--no-elimination' implies '--no-probing'"
 [ $elimination = no -a $strengthening = no ] && die "'--no-elimination' implies '--no-strengthening'"
 [ $elimination = no -a $subsumption = no ] && die "'--no-elimination' implies '--no-subsumption'"
 [ $elimination = no -a $subsumptionlimits = no ] && die "'--no-elimination' implies '--no-subsumption-limits'"
 [ $glue = no -a $tier1 = no ] && die "'--no-glue' implies '--no-tier1'"
 [ $glue = no -a $tier2 = no ] && die "'--no-glue' implies '--no-tier2'"
+[ $learn = no -a $arena = no ] && die "'--no-learn' implies '--no-arena'"
 [ $learn = no -a $glue = no ] && die "'--no-learn' implies '--no-glue'"
+[ $learn = no -a $hyper = no ] && die "'--no-learn' implies '--no-hyper'"
 [ $learn = no -a $inprocessing = no ] && die "'--no-learn' implies '--no-inprocessing'"
 [ $learn = no -a $minimize = no ] && die "'--no-learn' implies '--no-minimize'"
+[ $learn = no -a $otfs = no ] && die "'--no-learn' implies '--no-otfs'"
 [ $learn = no -a $reduce = no ] && die "'--no-learn' implies '--no-reduce'"
 [ $learn = no -a $restart = no ] && die "'--no-learn' implies '--no-restart'"
 [ $learn = no -a $reuse = no ] && die "'--no-learn' implies '--no-reuse'"
@@ -59,6 +71,7 @@
 [ $limits = no -a $eliminationlimits = no ] && die "'--no-limits' implies '--no-elimination-limits'"
 [ $limits = no -a $subsumptionlimits = no ] && die "'--no-limits' implies '--no-subsumption-limits'"
 [ $minimize = no -a $shrink = no ] && die "'--no-minimize' implies '--no-shrink'"
+[ $probing = no -a $hyper = no ] && die "'--no-probing' implies '--no-hyper'"
 [ $reduce = no -a $glue = no ] && die "'--no-reduce' implies '--no-glue'"
 [ $reduce = no -a $tier1 = no ] && die "'--no-reduce' implies '--no-tier1'"
 [ $reduce = no -a $tier2 = no ] && die "'--no-reduce' implies '--no-tier2'"
@@ -73,7 +86,10 @@
 [ $save = no -a $rephase = no ] && die "'--no-save' implies '--no-rephase'"
 [ $simplification = no -a $elimination = no ] && die "'--no-simplification' implies '--no-elimination'"
 [ $simplification = no -a $eliminationlimits = no ] && die "'--no-simplification' implies '--no-elimination-limits'"
+[ $simplification = no -a $gates = no ] && die "'--no-simplification' implies '--no-gates'"
+[ $simplification = no -a $hyper = no ] && die "'--no-simplification' implies '--no-hyper'"
 [ $simplification = no -a $inprocessing = no ] && die "'--no-simplification' implies '--no-inprocessing'"
+[ $simplification = no -a $probing = no ] && die "'--no-simplification' implies '--no-probing'"
 [ $simplification = no -a $strengthening = no ] && die "'--no-simplification' implies '--no-strengthening'"
 [ $simplification = no -a $subsumption = no ] && die "'--no-simplification' implies '--no-subsumption'"
 [ $simplification = no -a $subsumptionlimits = no ] && die "'--no-simplification' implies '--no-subsumption-limits'"
@@ -85,13 +101,19 @@
 [ $target = no -a $best = no ] && die "'--no-target' implies '--no-best'"
 [ $tier1 = no -a $tier2 = no ] && die "'--no-tier1' implies '--no-tier2'"
 [ $used = no -a $tier2 = no ] && die "'--no-used' implies '--no-tier2'"
+[ $variadic = no -a $arena = no ] && die "'--no-variadic' implies '--no-arena'"
 [ $vivification = no -a $vivificationlimits = no ] && die "'--no-vivification' implies '--no-vivificationlimits'"
 [ $vivification = no -a $vivifyimply = no ] && die "'--no-vivification' implies '--no-vivifyimply'"
 [ $vmtf = no -a $sortanalyzed = no ] && die "'--no-vmtf' implies '--no-sort-analyzed'"
+[ $vsids = no -a $quaternary = no ] && die "'--no-vsids' implies '--no-quaternary'"
 [ $watches = no -a $block = no ] && die "'--no-watches' implies '--no-block'"
 [ $watches = no -a $cache = no ] && die "'--no-watches' implies '--no-cache'"
 [ $watches = no -a $elimination = no ] && die "'--no-watches' implies '--no-elimination'"
 [ $watches = no -a $eliminationlimits = no ] && die "'--no-watches' implies '--no-elimination-limits'"
+[ $watches = no -a $gates = no ] && die "'--no-watches' implies '--no-gates'"
+[ $watches = no -a $hyper = no ] && die "'--no-watches' implies '--no-hyper'"
+[ $watches = no -a $otfs = no ] && die "'--no-watches' implies '--no-otfs'"
+[ $watches = no -a $probing = no ] && die "'--no-watches' implies '--no-probing'"
 [ $watches = no -a $strengthening = no ] && die "'--no-watches' implies '--no-strengthening'"
 [ $watches = no -a $subsumption = no ] && die "'--no-watches' implies '--no-subsumption'"
 [ $watches = no -a $subsumptionlimits = no ] && die "'--no-watches' implies '--no-subsumption-limits'"
@@ -2,6 +2,7 @@
 
 # Compiler definitions to disable features.
 
+[ $arena = no ] && CFLAGS="$CFLAGS -DNARENA"
 [ $best = no ] && CFLAGS="$CFLAGS -DNBEST"
 [ $block = no ] && CFLAGS="$CFLAGS -DNBLOCK"
 [ $bump = no ] && CFLAGS="$CFLAGS -DNBUMP"
@@ -16,13 +17,19 @@
 [ $elimination = no ] && CFLAGS="$CFLAGS -DNELIMINATION"
 [ $eliminationlimits = no ] && CFLAGS="$CFLAGS -DNELIMINATIONLIMITS"
 [ $focused = no ] && CFLAGS="$CFLAGS -DNFOCUSED"
+[ $gates = no ] && CFLAGS="$CFLAGS -DNGATES"
 [ $glue = no ] && CFLAGS="$CFLAGS -DNGLUE"
+[ $hyper = no ] && CFLAGS="$CFLAGS -DNHYPER"
 [ $inprocessing = no ] && CFLAGS="$CFLAGS -DNINPROCESSING"
 [ $inverted = no ] && CFLAGS="$CFLAGS -DNINVERTED"
 [ $lazyactivation = no ] && CFLAGS="$CFLAGS -DNLAZYACTIVATION"
 [ $learn = no ] && CFLAGS="$CFLAGS -DNLEARN"
 [ $limits = no ] && CFLAGS="$CFLAGS -DNLIMITS"
 [ $minimize = no ] && CFLAGS="$CFLAGS -DNMINIMIZE"
+[ $otfs = no ] && CFLAGS="$CFLAGS -DNOTFS"
+[ $portfolio = no ] && CFLAGS="$CFLAGS -DNPORTFOLIO"
+[ $probing = no ] && CFLAGS="$CFLAGS -DNPROBING"
+[ $quaternary = no ] && CFLAGS="$CFLAGS -DNQUATERNARY"
 [ $radixsort = no ] && CFLAGS="$CFLAGS -DNRADIXSORT"
 [ $reduce = no ] && CFLAGS="$CFLAGS -DNREDUCE"
 [ $rephase = no ] && CFLAGS="$CFLAGS -DNREPHASE"
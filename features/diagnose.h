@@ -2,6 +2,9 @@
 
 // Print compile time diagnostics on disabled features.
 
+#ifdef NARENA
+#pragma message "#define NARENA"
+#endif
 #ifdef NBEST
 #pragma message "#define NBEST"
 #endif
@@ -44,9 +47,15 @@
 #ifdef NFOCUSED
 #pragma message "#define NFOCUSED"
 #endif
+#ifdef NGATES
+#pragma message "#define NGATES"
+#endif
 #ifdef NGLUE
 #pragma message "#define NGLUE"
 #endif
+#ifdef NHYPER
+#pragma message "#define NHYPER"
+#endif
 #ifdef NINPROCESSING
 #pragma message "#define NINPROCESSING"
 #endif
@@ -65,6 +74,18 @@
 #ifdef NMINIMIZE
 #pragma message "#define NMINIMIZE"
 #endif
+#ifdef NOTFS
+#pragma message "#define NOTFS"
+#endif
+#ifdef NPORTFOLIO
+#pragma message "#define NPORTFOLIO"
+#endif
+#ifdef NPROBING
+#pragma message "#define NPROBING"
+#endif
+#ifdef NQUATERNARY
+#pragma message "#define NQUATERNARY"
+#endif
 #ifdef NRADIXSORT
 #pragma message "#define NRADIXSORT"
 #endif
@@ -11,6 +11,9 @@
 #if defined(NBUMP) && !defined(NINVERTED)
 #define NINVERTED
 #endif
+#if defined(NBUMP) && !defined(NQUATERNARY)
+#define NQUATERNARY
+#endif
 #if defined(NBUMP) && !defined(NRESTART)
 #define NRESTART
 #endif
@@ -29,6 +32,9 @@
 #if defined(NBUMP) && !defined(NVSIDS)
 #define NVSIDS
 #endif
+#if defined(NCDCL) && !defined(NARENA)
+#define NARENA
+#endif
 #if defined(NCDCL) && !defined(NBEST)
 #define NBEST
 #endif
@@ -44,6 +50,9 @@
 #if defined(NCDCL) && !defined(NGLUE)
 #define NGLUE
 #endif
+#if defined(NCDCL) && !defined(NHYPER)
+#define NHYPER
+#endif
 #if defined(NCDCL) && !defined(NINPROCESSING)
 #define NINPROCESSING
 #endif
@@ -53,6 +62,15 @@
 #if defined(NCDCL) && !defined(NMINIMIZE)
 #define NMINIMIZE
 #endif
+#if defined(NCDCL) && !defined(NOTFS)
+#define NOTFS
+#endif
+#if defined(NCDCL) && !defined(NPROBING)
+#define NPROBING
+#endif
+#if defined(NCDCL) && !defined(NQUATERNARY)
+#define NQUATERNARY
+#endif
 #if defined(NCDCL) && !defined(NREDUCE)
 #define NREDUCE
 #endif
@@ -113,6 +131,15 @@
 #if defined(NELIMINATION) && !defined(NELIMINATIONLIMITS)
 #define NELIMINATIONLIMITS
 #endif
+#if defined(NELIMINATION) && !defined(NGATES)
+#define NGATES
+#endif
+#if defined(NELIMINATION) && !defined(NHYPER)
+#define NHYPER
+#endif
+#if defined(NELIMINATION) && !defined(NPROBING)
+#define NPROBING
+#endif
 #if defined(NELIMINATION) && !defined(NSTRENGTHENING)
 #define NSTRENGTHENING
 #endif
@@ -128,15 +155,24 @@
 #if defined(NGLUE) && !defined(NTIER2)
 #define NTIER2
 #endif
+#if defined(NLEARN) && !defined(NARENA)
+#define NARENA
+#endif
 #if defined(NLEARN) && !defined(NGLUE)
 #define NGLUE
 #endif
+#if defined(NLEARN) && !defined(NHYPER)
+#define NHYPER
+#endif
 #if defined(NLEARN) && !defined(NINPROCESSING)
 #define NINPROCESSING
 #endif
 #if defined(NLEARN) && !defined(NMINIMIZE)
 #define NMINIMIZE
 #endif
+#if defined(NLEARN) && !defined(NOTFS)
+#define NOTFS
+#endif
 #if defined(NLEARN) && !defined(NREDUCE)
 #define NREDUCE
 #endif
@@ -173,6 +209,9 @@
 #if defined(NMINIMIZE) && !defined(NSHRINK)
 #define NSHRINK
 #endif
+#if defined(NPROBING) && !defined(NHYPER)
+#define NHYPER
+#endif
 #if defined(NREDUCE) && !defined(NGLUE)
 #define NGLUE
 #endif
@@ -215,9 +254,18 @@
 #if defined(NSIMPLIFICATION) && !defined(NELIMINATIONLIMITS)
 #define NELIMINATIONLIMITS
 #endif
+#if defined(NSIMPLIFICATION) && !defined(NGATES)
+#define NGATES
+#endif
+#if defined(NSIMPLIFICATION) && !defined(NHYPER)
+#define NHYPER
+#endif
 #if defined(NSIMPLIFICATION) && !defined(NINPROCESSING)
 #define NINPROCESSING
 #endif
+#if defined(NSIMPLIFICATION) && !defined(NPROBING)
+#define NPROBING
+#endif
 #if defined(NSIMPLIFICATION) && !defined(NSTRENGTHENING)
 #define NSTRENGTHENING
 #endif
@@ -251,6 +299,9 @@
 #if defined(NUSED) && !defined(NTIER2)
 #define NTIER2
 #endif
+#if defined(NVARIADIC) && !defined(NARENA)
+#define NARENA
+#endif
 #if defined(NVIVIFICATION) && !defined(NVIVIFICATIONLIMITS)
 #define NVIVIFICATIONLIMITS
 #endif
@@ -260,6 +311,9 @@
 #if defined(NVMTF) && !defined(NSORTANALYZED)
 #define NSORTANALYZED
 #endif
+#if defined(NVSIDS) && !defined(NQUATERNARY)
+#define NQUATERNARY
+#endif
 #if defined(NWATCHES) && !defined(NBLOCK)
 #define NBLOCK
 #endif
@@ -272,6 +326,18 @@
 #if defined(NWATCHES) && !defined(NELIMINATIONLIMITS)
 #define NELIMINATIONLIMITS
 #endif
+#if defined(NWATCHES) && !defined(NGATES)
+#define NGATES
+#endif
+#if defined(NWATCHES) && !defined(NHYPER)
+#define NHYPER
+#endif
+#if defined(NWATCHES) && !defined(NOTFS)
+#define NOTFS
+#endif
+#if defined(NWATCHES) && !defined(NPROBING)
+#define NPROBING
+#endif
 #if defined(NWATCHES) && !defined(NSTRENGTHENING)
 #define NSTRENGTHENING
 #endif
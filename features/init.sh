@@ -2,6 +2,7 @@
 
 # Initialize all features to be enabled by default.
 
+arena=yes
 best=yes
 block=yes
 bump=yes
@@ -16,13 +17,19 @@ control=yes
 elimination=yes
 eliminationlimits=yes
 focused=yes
+gates=yes
 glue=yes
+hyper=yes
 inprocessing=yes
 inverted=yes
 lazyactivation=yes
 learn=yes
 limits=yes
 minimize=yes
+otfs=yes
+portfolio=yes
+probing=yes
+quaternary=yes
 radixsort=yes
 reduce=yes
 rephase=yes
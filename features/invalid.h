@@ -2,6 +2,9 @@
 
 // Pairs of invalid features.
 
+"--no-arena", "--no-cdcl",
+"--no-arena", "--no-learn",
+"--no-arena", "--no-variadic",
 "--no-best", "--no-cdcl",
 "--no-best", "--no-rephase",
 "--no-best", "--no-save",
@@ -11,6 +14,7 @@
 "--no-block", "--no-watches",
 "--no-bump", "--no-bump-reasons",
 "--no-bump", "--no-inverted",
+"--no-bump", "--no-quaternary",
 "--no-bump", "--no-restart",
 "--no-bump", "--no-reuse",
 "--no-bump", "--no-reusestable",
@@ -22,9 +26,13 @@
 "--no-cdcl", "--no-chronoreuse",
 "--no-cdcl", "--no-focused",
 "--no-cdcl", "--no-glue",
+"--no-cdcl", "--no-hyper",
 "--no-cdcl", "--no-inprocessing",
 "--no-cdcl", "--no-learn",
 "--no-cdcl", "--no-minimize",
+"--no-cdcl", "--no-otfs",
+"--no-cdcl", "--no-probing",
+"--no-cdcl", "--no-quaternary",
 "--no-cdcl", "--no-reduce",
 "--no-cdcl", "--no-restart",
 "--no-cdcl", "--no-reuse",
@@ -46,6 +54,9 @@
 "--no-control", "--no-vivificationlimits",
 "--no-control", "--no-vivifyimply",
 "--no-elimination", "--no-elimination-limits",
+"--no-elimination", "--no-gates",
+"--no-elimination", "--no-hyper",
+"--no-elimination", "--no-probing",
 "--no-elimination", "--no-simplification",
 "--no-elimination", "--no-strengthening",
 "--no-elimination", "--no-subsumption",
@@ -56,15 +67,22 @@
 "--no-elimination-limits", "--no-watches",
 "--no-focused", "--no-stable",
 "--no-focused", "--no-vmtf",
+"--no-gates", "--no-simplification",
+"--no-gates", "--no-watches",
 "--no-glue", "--no-learn",
 "--no-glue", "--no-reduce",
 "--no-glue", "--no-tier1",
 "--no-glue", "--no-tier2",
+"--no-hyper", "--no-learn",
+"--no-hyper", "--no-probing",
+"--no-hyper", "--no-simplification",
+"--no-hyper", "--no-watches",
 "--no-inprocessing", "--no-learn",
 "--no-inprocessing", "--no-simplification",
 "--no-inverted", "--no-rephase",
 "--no-inverted", "--no-save",
 "--no-learn", "--no-minimize",
+"--no-learn", "--no-otfs",
 "--no-learn", "--no-reduce",
 "--no-learn", "--no-restart",
 "--no-learn", "--no-reuse",
@@ -76,6 +94,10 @@
 "--no-learn", "--no-used",
 "--no-limits", "--no-subsumption-limits",
 "--no-minimize", "--no-shrink",
+"--no-otfs", "--no-watches",
+"--no-probing", "--no-simplification",
+"--no-probing", "--no-watches",
+"--no-quaternary", "--no-vsids",
 "--no-reduce", "--no-tier1",
 "--no-reduce", "--no-tier2",
 "--no-reduce", "--no-used",
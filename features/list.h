@@ -2,6 +2,7 @@
 
 // List of features.
 
+"--no-arena",
 "--no-best",
 "--no-block",
 "--no-bump",
@@ -16,13 +17,19 @@
 "--no-elimination",
 "--no-elimination-limits",
 "--no-focused",
+"--no-gates",
 "--no-glue",
+"--no-hyper",
 "--no-inprocessing",
 "--no-inverted",
 "--no-lazy-activation",
 "--no-learn",
 "--no-limits",
 "--no-minimize",
+"--no-otfs",
+"--no-portfolio",
+"--no-probing",
+"--no-quaternary",
 "--no-radix-sort",
 "--no-reduce",
 "--no-rephase",
@@ -5,6 +5,7 @@
 parse () {
   res=0
   case x"$1" in
+    x"--no-arena") arena=no;;
     x"--no-best") best=no;;
     x"--no-block") block=no;;
     x"--no-bump") bump=no;;
@@ -19,13 +20,19 @@ parse () {
     x"--no-elimination") elimination=no;;
     x"--no-elimination-limits") eliminationlimits=no;;
     x"--no-focused") focused=no;;
+    x"--no-gates") gates=no;;
     x"--no-glue") glue=no;;
+    x"--no-hyper") hyper=no;;
     x"--no-inprocessing") inprocessing=no;;
     x"--no-inverted") inverted=no;;
     x"--no-lazy-activation") lazyactivation=no;;
     x"--no-learn") learn=no;;
     x"--no-limits") limits=no;;
     x"--no-minimize") minimize=no;;
+    x"--no-otfs") otfs=no;;
+    x"--no-portfolio") portfolio=no;;
+    x"--no-probing") probing=no;;
+    x"--no-quaternary") quaternary=no;;
     x"--no-radix-sort") radixsort=no;;
     x"--no-reduce") reduce=no;;
     x"--no-rephase") rephase=no;;
@@ -3,6 +3,7 @@
 # Print option usage to disable features.
 
 cat<<EOF
+--no-arena              disable clause arena (allocate clauses separately)
 --no-best               disable best trail rephasing (in stable mode)
 --no-block              disable blocking literals (thus slower propagation)
 --no-bump               disable variable bumping (during conflict analysis)
@@ -17,13 +18,19 @@ cat<<EOF
 --no-elimination        disable bounded variable elimination
 --no-elimination-limits disable size, occurrence and round limits
 --no-focused            disable focused mode and always use stable mode
+--no-gates              disable gate detection in elimination
 --no-glue               disable glue based clause reduction (use size only)
+--no-hyper              disable hyper binary resolution during probing
 --no-inprocessing       disable inprocessing but enable preprocessing
 --no-inverted           disable inverted target rephasing (in stable mode)
 --no-lazy-activation    disable activating variables lazily
 --no-learn              disable clause learning (no learned clauses)
 --no-limits             disable subsumption and elimination limits
 --no-minimize           disable clause minimization (of 1st UIP clause)
+--no-otfs               disable on-the-fly strengthening of reasons
+--no-portfolio          disable parallel portfolio solving with threads
+--no-probing            disable probing and literal substitution
+--no-quaternary         use binary instead of 4-ary scores heap
 --no-radix-sort         disable radix-sorting of literals and clauses
 --no-reduce             disable clause reduction (keep learned clauses)
 --no-rephase            disable rephasing / resetting of saved phases
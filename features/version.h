@@ -2,6 +2,9 @@
 
 // Version extension string for disabled features.
 
+#ifdef NARENA
+"-arena"
+#endif
 #ifdef NBEST
 "-best"
 #endif
@@ -44,9 +47,15 @@
 #ifdef NFOCUSED
 "-focused"
 #endif
+#ifdef NGATES
+"-gates"
+#endif
 #ifdef NGLUE
 "-glue"
 #endif
+#ifdef NHYPER
+"-hyper"
+#endif
 #ifdef NINPROCESSING
 "-inprocessing"
 #endif
@@ -65,6 +74,18 @@
 #ifdef NMINIMIZE
 "-minimize"
 #endif
+#ifdef NOTFS
+"-otfs"
+#endif
+#ifdef NPORTFOLIO
+"-portfolio"
+#endif
+#ifdef NPROBING
+"-probing"
+#endif
+#ifdef NQUATERNARY
+"-quaternary"
+#endif
 #ifdef NRADIXSORT
 "-radixsort"
 #endif
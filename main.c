@@ -23,8 +23,22 @@ static const char *usage =
 "\n"
 "  -a | --ascii         use ASCII format to write proof to file\n"
 "  -b | --binary        use binary format to write proof to file\n"
+"  --async-proof        write proof asynchronously in a separate thread\n"
+"  --async-check        check proof internally in a separate thread\n"
 "  -f | --force         overwrite proof files and relax parsing\n"
 "  -n | --no-witness    disable printing of satisfying assignment\n"
+"  -w | --binary-witness\n"
+"                       print satisfying assignment in binary format\n"
+"  --strict             strict (but slower) parsing of input file\n"
+"  --encode-xors        encode XOR clauses into CNF (default with proofs)\n"
+"  --stats=json         print statistics as JSON object to '<stderr>'\n"
+"  --stats=json=<file>  write statistics as JSON object to '<file>'\n"
+"  --load=<snapshot>    resume from snapshot instead of parsing '<dimacs>'\n"
+"  --save=<snapshot>    save snapshot if solving stops without result\n"
+"  --cubes=<icnf>       write clauses and cubes instead of solving\n"
+#ifdef TIMELINE
+"  --timeline=<trace>   write recent solver events as Chrome trace\n"
+#endif
 "\n"
 #ifdef LOGGING
 "  -l | --log           enable logging messages\n"
@@ -35,11 +49,21 @@ static const char *usage =
 "or one of these long options setting limits\n"
 "\n"
 "  --conflicts=<limit>\n"
+"  --ticks=<limit>\n"
+"  --time=<seconds>\n"
+"  --cube-depth=<depth> (default 8)\n"
+"\n"
+"and these long options for solving with multiple threads\n"
+"\n"
+"  --threads=<number>\n"
+"  --elimination-threads=<number>\n"
 "\n"
 #ifdef _POSIX_C_SOURCE
 "and '<dimacs>' is an optionally compressed CNF in DIMACS format by\n"
 "default read from '<stdin>'.  For decompression the solver relies on\n"
-"external tools 'gzip', 'bunzip2' and 'xz' determined by the path suffix.\n"
+"external tools 'gzip', 'bzip2', 'xz' and 'zstd' determined by the path\n"
+"suffix unless it was configured to decompress in-process with 'zlib',\n"
+"'liblzma' or 'libzstd'.\n"
 #else
 "where '<dimacs>' is a CNF in DIMACS format.\n"
 #endif
@@ -51,6 +75,17 @@ static const char *usage =
 "(unless '--binary' is specified) while proofs written to a file use the\n"
 "more compact binary format used in the SAT competition (unless '--ascii'\n"
 "is specified).\n"
+"\n"
+"The binary witness format follows the binary proof format, i.e., after\n"
+"the 's SATISFIABLE' line the character 'v' is printed followed by the\n"
+"literals each encoded as variable-length integer '2*abs(lit)+(lit<0)'\n"
+"(seven bits per byte with least significant bits first) and with a\n"
+"terminating zero byte.\n"
+"\n"
+"With '--cubes' the original clauses are written to '<icnf>' in the\n"
+"incremental 'p inccnf' format followed by the cubes generated by\n"
+"look-ahead splitting as 'a ... 0' lines, which together cover the whole\n"
+"search space (after at most '--conflicts' conflicts of solving first).\n"
 ;
 
 // *INDENT-ON*
@@ -84,6 +119,26 @@ static const char *usage =
 #include <sys/stat.h>
 #include <unistd.h>
 
+// Optional libraries for in-process decompression.
+
+#ifdef ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef LZMA
+#include <lzma.h>
+#endif
+
+#ifdef ZSTD
+#include <zstd.h>
+#endif
+
+// Memory mapping input files with 'mmap' is only supported with POSIX.
+
+#ifdef _POSIX_C_SOURCE
+#include <sys/mman.h>
+#endif
+
 /*------------------------------------------------------------------------*/
 
 // We simply use static global data structures here in 'main.c' which
@@ -99,12 +154,13 @@ static const char *usage =
 
 static struct
 {
-  int close;			// Set to 0=no-close, 1=fclose, 2=pclose.
+  int close;			// 0=no-close, 1=fclose, 2=pclose, 3=other.
   FILE *file;
   const char *path;
 } input, proof;
 
 static long lineno = 1;		// Line number for parse error messages.
+static long token_lineno = 1;	// Line number of last strict token.
 static uint64_t bytes;		// Read bytes for verbose message.
 
 /*------------------------------------------------------------------------*/
@@ -122,6 +178,8 @@ static int variables;
 // options are all disabled initially.
 
 static const char *ascii;	// Force ASCII format for proof files.
+static const char *asynchronous;	// Write proof in background thread.
+static const char *checking;	// Check proof in background thread.
 static const char *binary;	// Force binary format writing to stdout.
 static const char *force;	// Overwrite proofs and relax parsing.
 
@@ -129,7 +187,15 @@ static const char *force;	// Overwrite proofs and relax parsing.
 const char *logging;
 #endif
 static const char *quiet;	// Turn off default 'verbose' mode.
+static const char *strict;	// Use strict (slower) DIMACS parser.
+static const char *encode;	// Encode XORs instead of adding them.
 const char *no_witness;		// Do not print satisfying assignment.
+static const char *binary_witness;	// Print witness in binary format.
+static const char *json;	// Print statistics in JSON format.
+static const char *load;	// Load snapshot instead of parsing.
+static const char *save;	// Save snapshot if there is no result.
+static const char *cubes;	// Write cubes instead of solving.
+static const char *timeline;	// Write timeline of events at the end.
 
 static int verbose = 1;		// Verbose level (unless 'quiet' is set).
 
@@ -140,13 +206,22 @@ static int verbose = 1;		// Verbose level (unless 'quiet' is set).
 
 static struct int_stack xors;
 
+// Literals of the currently parsed clause.
+
+static struct int_stack clause;
+
+// Parsed clauses (zero terminated) kept for writing them with the cubes.
+
+static struct int_stack original;
+
 /*------------------------------------------------------------------------*/
 
-// Line buffer for pretty-printing witnesses ('v' lines following the SAT
+// Output buffer for printing witnesses ('v' lines following the SAT
 // competition output format fit to at most 78 characters per line).
 
-static char buffer[80];
-static size_t size_buffer;
+static char output[1 << 16];
+static size_t size_output;	// Bytes in output buffer.
+static size_t size_line;	// Characters in current 'v' line.
 
 /*------------------------------------------------------------------------*/
 
@@ -299,8 +374,11 @@ banner (void)
 // We also allow parsing XOR clauses if the file has an 'p xnf ...' header.
 
 // These XOR clauses are prefixed by an 'x', i.e., the clause 'x -1 2 0'
-// means that the variable '1' is equivalent to variable '2'. We simply
-// encode those XOR clauses back to CNF by introducing Tseitin variables.
+// means that the variable '1' is equivalent to variable '2'.  By default
+// they are added natively to the library with 'satch_add_xor'.  However,
+// XOR reasoning can not be justified in DRUP proofs.  Thus if a proof is
+// traced or with '--encode-xors' we encode those XOR clauses back to CNF
+// by introducing Tseitin variables instead.
 
 static void
 ternary (int a, int b, int c)
@@ -407,7 +485,7 @@ encode_xors (int tseitin, size_t start)
 
 #ifndef NDEBUG
 
-// The XORs are not seen by the library and thus we need to check models
+// Encoded XORs are not seen by the library and thus we need to check models
 // returned by the library manually here (this is mainly used to catch
 // potential issues with incorrect encoding code).
 
@@ -467,24 +545,296 @@ check_xors_satisfied (void)
 
 /*------------------------------------------------------------------------*/
 
+// In-process decompression is optional and selected at configure time
+// with '--zlib', '--lzma' or '--zstd' (defining 'ZLIB', 'LZMA' or 'ZSTD').
+// Otherwise compressed files are read through a pipe from external tools
+// (see 'open_pipe' below).  The in-process decompressors provide their own
+// function for reading decompressed blocks into the input buffer as well
+// as another one for closing the input (marked with 'input.close = 3').
+
+static struct
+{
+  size_t (*read) (unsigned char *, size_t);	// Read decompressed.
+  void (*close) (void);		// Close decompressed input.
+#if defined(LZMA) || defined(ZSTD)
+  unsigned char compressed[1 << 16];	// Buffer for compressed input.
+  bool eof;			// Compressed input exhausted.
+#endif
+#ifdef ZLIB
+  gzFile gzip;
+#endif
+#ifdef LZMA
+  lzma_stream lzma;
+#endif
+#ifdef ZSTD
+  ZSTD_DStream *zstd;
+  ZSTD_inBuffer in;
+  size_t pending;		// Frame incomplete if non-zero.
+#endif
+} decompressor;
+
+#ifdef ZLIB
+
+// The 'zlib' library reads the file itself (through 'gzopen').
+
+static size_t
+read_gzip (unsigned char *buffer, size_t bytes)
+{
+  const int res = gzread (decompressor.gzip, buffer, bytes);
+  if (res < 0 || (size_t) res < bytes)
+    {
+      // A truncated file is only reported through 'gzerror' (with error
+      // code 'Z_BUF_ERROR') while 'gzread' returns the bytes read so far.
+
+      int errnum;
+      const char *msg = gzerror (decompressor.gzip, &errnum);
+      if (errnum == Z_BUF_ERROR)
+	error ("decompressing '%s' failed: truncated file", input.path);
+      if (res < 0 || errnum != Z_OK)
+	error ("decompressing '%s' failed: %s", input.path, msg);
+    }
+  return res;
+}
+
+static void
+close_gzip (void)
+{
+  gzclose (decompressor.gzip);
+}
+
+static void
+open_gzip (void)
+{
+  decompressor.gzip = gzopen (input.path, "rb");
+  if (!decompressor.gzip)
+    return;
+  gzbuffer (decompressor.gzip, 1 << 17);
+  decompressor.read = read_gzip;
+  decompressor.close = close_gzip;
+  input.close = 3;
+}
+
+#endif
+
+#if defined(LZMA) || defined(ZSTD)
+
+// Fill the compressed input buffer of 'liblzma' and 'libzstd' decoders.
+
+static size_t
+read_compressed (void)
+{
+  const size_t res = fread (decompressor.compressed, 1,
+			    sizeof decompressor.compressed, input.file);
+  if (ferror (input.file))
+    error ("reading compressed '%s' failed", input.path);
+  if (!res)
+    decompressor.eof = true;
+  return res;
+}
+
+#endif
+
+#ifdef LZMA
+
+static size_t
+read_lzma (unsigned char *buffer, size_t bytes)
+{
+  lzma_stream *const stream = &decompressor.lzma;
+  stream->next_out = buffer;
+  stream->avail_out = bytes;
+  while (stream->avail_out)
+    {
+      if (!stream->avail_in && !decompressor.eof)
+	{
+	  stream->avail_in = read_compressed ();
+	  stream->next_in = decompressor.compressed;
+	}
+      const lzma_action action = decompressor.eof ? LZMA_FINISH : LZMA_RUN;
+      const lzma_ret ret = lzma_code (stream, action);
+      if (ret == LZMA_STREAM_END)
+	break;
+      if (ret != LZMA_OK)
+	error ("decompressing '%s' failed (liblzma error code %d)",
+	       input.path, (int) ret);
+    }
+  return bytes - stream->avail_out;
+}
+
+static void
+close_lzma (void)
+{
+  lzma_end (&decompressor.lzma);
+  fclose (input.file);
+}
+
+static void
+open_lzma (void)
+{
+  if (!(input.file = fopen (input.path, "rb")))
+    return;
+  const lzma_stream init = LZMA_STREAM_INIT;
+  decompressor.lzma = init;
+  if (lzma_stream_decoder (&decompressor.lzma,
+			   UINT64_MAX, LZMA_CONCATENATED) != LZMA_OK)
+    error ("failed to initialize 'liblzma' decoder");
+  decompressor.read = read_lzma;
+  decompressor.close = close_lzma;
+  input.close = 3;
+}
+
+#endif
+
+#ifdef ZSTD
+
+static size_t
+read_zstd (unsigned char *buffer, size_t bytes)
+{
+  ZSTD_inBuffer *const in = &decompressor.in;
+  ZSTD_outBuffer out = { buffer, bytes, 0 };
+  while (out.pos < out.size)
+    {
+      if (in->pos == in->size && !decompressor.eof)
+	{
+	  in->size = read_compressed ();
+	  in->src = decompressor.compressed;
+	  in->pos = 0;
+	}
+      const size_t consumed = in->pos, produced = out.pos;
+      const size_t ret = ZSTD_decompressStream (decompressor.zstd, &out, in);
+      if (ZSTD_isError (ret))
+	error ("decompressing '%s' failed: %s",
+	       input.path, ZSTD_getErrorName (ret));
+      if (in->pos != consumed || out.pos != produced)
+	decompressor.pending = ret;	// Zero if at end of frame.
+      else if (decompressor.eof)
+	{
+	  if (decompressor.pending)
+	    error ("truncated compressed file '%s'", input.path);
+	  break;
+	}
+    }
+  return out.pos;
+}
+
+static void
+close_zstd (void)
+{
+  ZSTD_freeDStream (decompressor.zstd);
+  fclose (input.file);
+}
+
+static void
+open_zstd (void)
+{
+  if (!(input.file = fopen (input.path, "rb")))
+    return;
+  decompressor.zstd = ZSTD_createDStream ();
+  if (!decompressor.zstd)
+    error ("failed to initialize 'libzstd' decoder");
+  ZSTD_initDStream (decompressor.zstd);
+  decompressor.read = read_zstd;
+  decompressor.close = close_zstd;
+  input.close = 3;
+}
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
+// The input is read through a buffer.  Regular (uncompressed) files are
+// memory mapped if possible and then the buffer simply covers the whole
+// file.  Otherwise large blocks are read into the buffer with 'fread',
+// which avoids the overhead of calling 'getc' for every single character.
+
+static unsigned char read_buffer[1 << 20];
+
+static struct
+{
+  const unsigned char *start;	// Start of buffered input.
+  const unsigned char *pos;	// Next character to read.
+  const unsigned char *end;	// End of buffered input.
+  size_t mapped;		// Size of memory mapped file (if non-zero).
+} buffered;
+
+static bool
+fill_buffer (void)
+{
+  if (buffered.mapped)
+    return false;
+  const size_t size = decompressor.read ?
+    decompressor.read (read_buffer, sizeof read_buffer) :
+    fread (read_buffer, 1, sizeof read_buffer, input.file);
+  buffered.start = buffered.pos = read_buffer;
+  buffered.end = read_buffer + size;
+  return size;
+}
+
+static inline int
+read_char (void)
+{
+  if (buffered.pos == buffered.end && !fill_buffer ())
+    return EOF;
+  return *buffered.pos++;
+}
+
+#ifdef _POSIX_C_SOURCE
+
+// Only files opened with 'fopen' are mapped (not pipes nor '<stdin>').  If
+// mapping fails we silently fall back to reading blocks with 'fread'.
+
+static void
+map_input (void)
+{
+  if (input.close != 1)
+    return;
+  const int fd = fileno (input.file);
+  struct stat buf;
+  if (fstat (fd, &buf) || !S_ISREG (buf.st_mode) || buf.st_size <= 0)
+    return;
+  if ((uintmax_t) buf.st_size > SIZE_MAX)
+    return;
+  const size_t size = buf.st_size;
+  void *start = mmap (0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (start == MAP_FAILED)
+    return;
+  (void) posix_madvise (start, size, POSIX_MADV_SEQUENTIAL);
+  buffered.start = buffered.pos = start;
+  buffered.end = buffered.start + size;
+  buffered.mapped = size;
+}
+
+static void
+unmap_input (void)
+{
+  if (!buffered.mapped)
+    return;
+  munmap ((void *) buffered.start, buffered.mapped);
+  buffered.start = buffered.pos = buffered.end = 0;
+  buffered.mapped = 0;
+}
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
 // This parser for DIMACS files is meant to be pretty robust and precise.
 // For instance it carefully checks that the number of variables as well as
 // literals are valid 32-two bit integers (different from 'INT_MIN'). For
 // the number of clauses it uses 'size_t'.  Thus in a 64-bit environment it
 // can parse really large CNFs with 2^32 clauses and more.
 
-// The following function reads a character from the global input file,
+// The following function reads a character from the input buffer,
 // squeezes out carriage return characters (after checking that they are
 // followed by a newline) and maintains read bytes and lines statistics.
 
 static inline int
 next (void)
 {
-  int res = getc (input.file);
+  int res = read_char ();
   if (res == '\r')		// Care for DOS / Windows '\r\n'.
     {
       bytes++;
-      res = getc (input.file);
+      res = read_char ();
       if (res != '\n')
 	parse_error ("expected new line after carriage return");
     }
@@ -503,9 +853,235 @@ percent (double a, double b)
   return b ? 100 * a / b : 0;
 }
 
+static void
+skip_comment (void)
+{
+  int ch;
+  while ((ch = next ()) != '\n')
+    if (ch == EOF)
+      parse_error ("unexpected end-of-file in comment");
+}
+
+// The body of the DIMACS file after the header is split into tokens which
+// are either 'EOF', the XOR prefix 'x' or a literal.  For literals the
+// character '0' is returned and the literal is stored at the given pointer.
+
+// With '--strict' or if the input file is not memory mapped the following
+// precise tokenizer is used which reads the input character by character.
+
+static int
+strict_token (int *lit_ptr)
+{
+  int ch;
+  for (;;)
+    {
+      ch = next ();
+
+      // Skip white space.
+
+      if (ch == ' ' || ch == '\t' || ch == '\n')
+	continue;
+
+      // Read and skip comments.
+
+      if (ch != 'c')
+	break;
+
+      skip_comment ();
+    }
+
+  // Semantic errors found after reading a literal (and the character
+  // following it, which might be a new line) refer to its first line.
+
+  token_lineno = lineno;
+
+  if (ch == EOF || ch == 'x')
+    return ch;
+
+  // Get sign of next literal and its first digit.
+
+  int sign = 1;
+
+  if (ch == '-')
+    {
+      ch = next ();
+      if (!isdigit (ch))
+	parse_error ("expected digit after '-'");
+      if (ch == '0')
+	parse_error ("expected non-zero digit after '-'");
+      sign = -1;
+    }
+  else if (!isdigit (ch))
+    parse_error ("expected number");
+
+  // Read the variable index and make sure not to overflow.
+
+  int idx = ch - '0';
+  while (isdigit (ch = next ()))
+    {
+      if (!idx)
+	parse_error ("invalid digit after '0' in number");
+      if (INT_MAX / 10 < idx)
+	parse_error ("number way too large");
+      idx *= 10;
+      const int digit = ch - '0';
+      if (INT_MAX - digit < idx)
+	parse_error ("number too large");
+      idx += digit;
+    }
+
+  // Now we have the variable with its sign as parsed literal.
+
+  const int lit = sign * idx;
+
+  // Be careful to check the character after the last digit.
+
+  if (ch != ' ' && ch != '\t' && ch != '\n' && ch != 'c' && ch != EOF)
+    parse_error ("unexpected character after '%d'", lit);
+
+  // We already have read the first character of a comment immediately
+  // starting after a literal, e.g., as in '1comment'.
+
+  if (ch == 'c')
+    skip_comment ();
+
+  *lit_ptr = lit;
+  return '0';
+}
+
+#ifdef _POSIX_C_SOURCE
+
+// The fast tokenizer works directly on the memory mapped file and is used
+// unless '--strict' is specified.  It does not count lines (they are only
+// determined for parse errors) and skips comments with 'memchr'.  Otherwise
+// it checks literals and carriage returns (which have to be followed by a
+// new line) as precisely as the strict tokenizer.
+
+static void
+locate_line (const unsigned char *p)
+{
+  lineno = 1;
+  for (const unsigned char *q = buffered.start;
+       (q = memchr (q, '\n', p - q)); q++)
+    lineno++;
+}
+
+#define FAST_PARSE_ERROR(...) \
+do { \
+  locate_line (p); \
+  parse_error (__VA_ARGS__); \
+} while (0)
+
+static inline bool
+is_digit (int ch)
+{
+  return '0' <= ch && ch <= '9';
+}
+
+static inline bool
+is_space (int ch)
+{
+  return ch == ' ' || ch == '\n' || ch == '\t';
+}
+
+#define CHECK_CARRIAGE_RETURN(Q) \
+do { \
+  if ((Q) + 1 == end || (Q)[1] != '\n') \
+    { \
+      p = (Q); \
+      FAST_PARSE_ERROR ("expected new line after carriage return"); \
+    } \
+} while (0)
+
+static int
+fast_token (int *lit_ptr)
+{
+  const unsigned char *p = buffered.pos;
+  const unsigned char *const end = buffered.end;
+  int ch;
+  for (;;)
+    {
+      while (p != end)
+	{
+	  ch = *p;
+	  if (ch == '\r')
+	    CHECK_CARRIAGE_RETURN (p);
+	  else if (!is_space (ch))
+	    break;
+	  p++;
+	}
+      if (p == end)
+	{
+	  buffered.pos = p;
+	  return EOF;
+	}
+      ch = *p++;
+      if (ch != 'c')
+	break;
+      const unsigned char *const eol = memchr (p, '\n', end - p);
+      if (!eol)
+	{
+	  p = end;
+	  FAST_PARSE_ERROR ("unexpected end-of-file in comment");
+	}
+      const unsigned char *const cr = memchr (p, '\r', eol - p);
+      if (cr)
+	CHECK_CARRIAGE_RETURN (cr);
+      p = eol + 1;
+    }
+
+  if (ch == 'x')
+    {
+      buffered.pos = p;
+      return 'x';
+    }
+
+  int sign = 1;
+
+  if (ch == '-')
+    {
+      if (p == end || !is_digit (*p))
+	FAST_PARSE_ERROR ("expected digit after '-'");
+      ch = *p++;
+      if (ch == '0')
+	FAST_PARSE_ERROR ("expected non-zero digit after '-'");
+      sign = -1;
+    }
+  else if (!is_digit (ch))
+    FAST_PARSE_ERROR ("expected number");
+
+  // Since 'idx' is at most 'INT_MAX' before multiplying it by ten and
+  // adding a digit the result still fits into 64 bits.
+
+  uint64_t idx = ch - '0';
+  while (p != end && is_digit (ch = *p))
+    {
+      if (!idx)
+	FAST_PARSE_ERROR ("invalid digit after '0' in number");
+      if (idx > INT_MAX / 10)
+	FAST_PARSE_ERROR ("number way too large");
+      idx = 10 * idx + (ch - '0');
+      if (idx > INT_MAX)
+	FAST_PARSE_ERROR ("number too large");
+      p++;
+    }
+
+  const int lit = sign * (int) idx;
+
+  if (p != end && !is_space (ch = *p) && ch != '\r' && ch != 'c')
+    FAST_PARSE_ERROR ("unexpected character after '%d'", lit);
+
+  buffered.pos = p;
+  *lit_ptr = lit;
+  return '0';
+}
+
+#endif
+
 // This is the actual DIMACS file parser.  It uses the 'next' function to
-// read bytes from the global file.  Beside proper error messages in case of
-// parse errors it also prints information about parsed clauses etc.
+// read the header and then one of the two tokenizers above for the rest.
+// Beside proper error messages in case of parse errors it also prints
+// information about parsed clauses etc.
 
 // The file is not opened here, since we want to print the 'banner' in
 // 'main' after checking that we can really access and open the file.  But
@@ -517,10 +1093,21 @@ parse (void)
 {
   satch_start_profiling_parsing (solver);
 
+#ifdef _POSIX_C_SOURCE
+  map_input ();
+  const bool fast = !strict && buffered.mapped;
+#endif
+
   if (!quiet)
     {
       satch_section (solver, "parsing");
-      message ("%sparsing '%s'", force ? "force " : "", input.path);
+      message ("%s%sparsing '%s'",
+	       force ? "force " : "", strict ? "strict " : "", input.path);
+#ifdef _POSIX_C_SOURCE
+      if (buffered.mapped)
+	message ("memory mapped %zu bytes (%.0f MB)",
+		 buffered.mapped, buffered.mapped / (double) (1 << 20));
+#endif
     }
 
   int ch;
@@ -602,63 +1189,62 @@ parse (void)
   size_t offset_of_encoded_xors = 0;
 
   int tseitin = force ? 0 : variables;
+  const bool encoding = encode || proof.path;
   char type = 0;
   int lit = 0;
 
-  for (;;)
-    {
-      ch = next ();
+#ifdef _POSIX_C_SOURCE
+  const unsigned char *const body = buffered.pos;
 
-      // Skip white space.
+  // The fast tokenizer does not count lines and thus they have to be
+  // determined explicitly for parse errors (at the current position).  The
+  // strict tokenizer might already have read the new line after a literal
+  // and thus we use the line on which the token started.
 
-      if (ch == ' ' || ch == '\t' || ch == '\n')
-	continue;
+#define BODY_PARSE_ERROR(...) \
+do { \
+  if (fast) \
+    locate_line (buffered.pos); \
+  else \
+    lineno = token_lineno; \
+  parse_error (__VA_ARGS__); \
+} while (0)
+#else
+#define BODY_PARSE_ERROR(...) \
+do { \
+  lineno = token_lineno; \
+  parse_error (__VA_ARGS__); \
+} while (0)
+#endif
 
-      if (ch == EOF)
+  for (;;)
+    {
+#ifdef _POSIX_C_SOURCE
+      const int token = fast ? fast_token (&lit) : strict_token (&lit);
+#else
+      const int token = strict_token (&lit);
+#endif
+      if (token == EOF)
 	break;
 
-      // Read and skip comments.
-
-      if (ch == 'c')
-	{
-
-	COMMENT:		// See below on why we need 'goto' here.
-
-	  while ((ch = next ()) != '\n')
-	    if (ch == EOF)
-	      parse_error ("unexpected end-of-file in comment");
-	  continue;
-	}
-
       // Read XOR type.
 
-      if (ch == 'x')
+      if (token == 'x')
 	{
 	  if (lit)
-	    parse_error ("'x' after non-zero %d'", lit);
+	    BODY_PARSE_ERROR ("'x' after non-zero %d'", lit);
 	  if (type)
-	    parse_error ("'x' after '%c'", type);
+	    BODY_PARSE_ERROR ("'x' after '%c'", type);
 	  if (!force && format != 'x')
-	    parse_error ("unexpected 'x' in CNF (use 'p xnf ...' header)");
+	    BODY_PARSE_ERROR ("unexpected 'x' in CNF "
+			      "(use 'p xnf ...' header)");
+	  if (cubes)
+	    BODY_PARSE_ERROR ("can not write XOR clauses with '%s'", cubes);
 	  type = 'x';
 	  continue;
 	}
 
-      // Get sign of next literal and its first digit.
-
-      int sign = 1;
-
-      if (ch == '-')
-	{
-	  ch = next ();
-	  if (!isdigit (ch))
-	    parse_error ("expected digit after '-'");
-	  if (ch == '0')
-	    parse_error ("expected non-zero digit after '-'");
-	  sign = -1;
-	}
-      else if (!isdigit (ch))
-	parse_error ("expected number");
+      assert (token == '0');
 
       // In forced parsing mode we ignore specified clauses.
 
@@ -666,38 +1252,14 @@ parse (void)
 	{
 	  assert (parsed_clauses <= specified_clauses);
 	  if (parsed_clauses == specified_clauses)
-	    parse_error ("more clauses than specified");
-	}
-
-      // Read the variable index and make sure not to overflow.
-
-      int idx = ch - '0';
-      while (isdigit (ch = next ()))
-	{
-	  if (!idx)
-	    parse_error ("invalid digit after '0' in number");
-	  if (INT_MAX / 10 < idx)
-	    parse_error ("number way too large");
-	  idx *= 10;
-	  const int digit = ch - '0';
-	  if (INT_MAX - digit < idx)
-	    parse_error ("number too large");
-	  idx += digit;
+	    BODY_PARSE_ERROR ("more clauses than specified");
 	}
 
-      // Now we have the variable with its sign as parsed literal.
-
-      lit = sign * idx;
-
-      // Be careful to check the character after the last digit.
-
-      if (ch != ' ' && ch != '\t' && ch != '\n' && ch != 'c' && ch != EOF)
-	parse_error ("unexpected character after '%d'", lit);
-
       assert (lit != INT_MIN);
+      const int idx = abs (lit);
       if (!force && idx > variables)
-	parse_error ("literal '%d' exceeds maximum variable index '%d'",
-		     lit, variables);
+	BODY_PARSE_ERROR ("literal '%d' exceeds maximum variable index '%d'",
+			  lit, variables);
 
       if (idx > parsed_variables)
 	parsed_variables = idx;
@@ -709,10 +1271,23 @@ parse (void)
 	{
 	  // The IPASIR semantics of 'satch_add' in essence just gets the
 	  // numbers in the DIMACS file after the header and 'adds' them
-	  // including the zeroes terminating each clause.  Thus we do not
-	  // have to use another function for adding a clause explicitly.
+	  // including the zeroes terminating each clause.  However, adding
+	  // a whole clause at once with 'satch_add_clause' avoids the
+	  // overhead of calling the library for every single literal.
 
-	  satch_add (solver, lit);
+	  if (lit)
+	    PUSH (clause, lit);
+	  else
+	    {
+	      if (cubes)
+		{
+		  for (const int *p = clause.begin; p != clause.end; p++)
+		    PUSH (original, *p);
+		  PUSH (original, 0);
+		}
+	      satch_add_clause (solver, clause.begin, SIZE_STACK (clause));
+	      CLEAR_STACK (clause);
+	    }
 	}
       else if (lit)
 	{
@@ -729,13 +1304,14 @@ parse (void)
 	  // file before we can start encoding XORs.  In precise parsing
 	  // mode we can simply encode the XOR directly (which also is
 	  // beneficial to activate and place Tseitin variables close to the
-	  // other variables seen so far and thus in this XOR clause).
+	  // other variables seen so far and thus in this XOR clause).  Native
+	  // XORs do not need Tseitin variables and are added right away.
 
 	  const size_t new_offset = SIZE_STACK (xors);
 	  const size_t size = new_offset - offset_of_encoded_xors;
 	  int *x = xors.begin + offset_of_encoded_xors;
 
-	  if (force)
+	  if (force && encoding)
 	    {
 #ifdef LOGGING
 	      if (logging_prefix ("parsed size %zu XOR", size))
@@ -749,7 +1325,10 @@ parse (void)
 	    }
 	  else
 	    {
-	      tseitin = encode_xor (tseitin, size, x);
+	      if (encoding)
+		tseitin = encode_xor (tseitin, size, x);
+	      else
+		satch_add_xor (solver, x, size);
 #ifndef NDEBUG
 	      PUSH (xors, 0);
 	      offset_of_encoded_xors = new_offset + 1;
@@ -762,30 +1341,33 @@ parse (void)
 
 	  parsed_xors++;
 	}
-
-      // The following 'goto' is necessary to avoid reading another
-      // character which would result in a spurious parse error for a comment
-      // immediately starting after a literal, e.g., as in '1comment'.
-
-      if (ch == 'c')
-	goto COMMENT;
     }
 
+#ifdef _POSIX_C_SOURCE
+  if (fast)
+    bytes += buffered.end - body;
+#endif
+
   if (lit)
-    parse_error ("terminating zero after literal '%d' missing", lit);
+    BODY_PARSE_ERROR ("terminating zero after literal '%d' missing", lit);
 
   if (type)
-    assert (format == 'x'), parse_error ("literals missing after 'x'");
+    {
+      assert (format == 'x');
+      BODY_PARSE_ERROR ("literals missing after 'x'");
+    }
 
   if (!force && parsed_clauses < specified_clauses)
     {
       if (parsed_clauses + 1 == specified_clauses)
-	parse_error ("single clause missing");
+	BODY_PARSE_ERROR ("single clause missing");
       else
-	parse_error ("%zu clauses missing",
-		     specified_clauses - parsed_clauses);
+	BODY_PARSE_ERROR ("%zu clauses missing",
+			  specified_clauses - parsed_clauses);
     }
 
+#undef BODY_PARSE_ERROR
+
   // Handle delayed XOR encoding in forced parsing mode.
 
   if (!EMPTY_STACK (xors))
@@ -815,6 +1397,10 @@ parse (void)
   if (force && variables < parsed_variables)
     variables = parsed_variables;
 
+#ifdef _POSIX_C_SOURCE
+  unmap_input ();
+#endif
+
   if (input.close == 1)		// Opened with 'fopen'.
     fclose (input.file);
 
@@ -823,10 +1409,14 @@ parse (void)
     pclose (input.file);
 #endif
 
+  if (input.close == 3)		// In-process decompression.
+    decompressor.close ();
+
   message ("closed '%s'", input.path);
   message ("after reading %" PRIu64 " bytes (%.0f MB)",
 	   bytes, bytes / (double) (1 << 20));
 
+  RELEASE_STACK (clause);
 #ifdef NDEBUG
   RELEASE_STACK (xors);
 #endif
@@ -834,35 +1424,251 @@ parse (void)
 
 /*------------------------------------------------------------------------*/
 
-// These two functions support pretty printing of satisfying assignments.
+// Snapshots given with '--load=<snapshot>' replace parsing a DIMACS file
+// and with '--save=<snapshot>' are written if solving stops without result
+// (for instance after hitting a limit), which allows to resume later.
+
+static const char *
+snapshot_path (const char *option)
+{
+  const char *path = strchr (option, '=');
+  assert (path);
+  return path + 1;
+}
+
+static void
+load_snapshot (void)
+{
+  const char *path = snapshot_path (load);
+  if (!quiet)
+    satch_section (solver, "loading");
+  FILE *file = fopen (path, "rb");
+  if (!file)
+    error ("can not read snapshot '%s'", path);
+  const double start = satch_process_time ();
+  const char *failed = satch_load (solver, file);
+  fclose (file);
+  if (failed)
+    error ("%s '%s'", failed, path);
+  variables = satch_maximum_variable (solver);
+  message ("loaded snapshot '%s' with %d variables in %.2f seconds",
+	   path, variables, satch_process_time () - start);
+}
+
+static void
+save_snapshot (void)
+{
+  const char *path = snapshot_path (save);
+  FILE *file = fopen (path, "wb");
+  if (!file)
+    error ("can not write snapshot '%s'", path);
+  const char *failed = satch_save (solver, file);
+  if (fclose (file) && !failed)
+    failed = "failed to close snapshot";
+  if (failed)
+    error ("%s '%s'", failed, path);
+  message ("saved snapshot '%s'", path);
+}
+
+/*------------------------------------------------------------------------*/
+
+// These functions support pretty printing of satisfying assignments.
 // According to the SAT competition output format these witnesses consist of
 // 'v ...' lines containing the literals which are true followed by '0'.  We
 // want to restrict these lines to 78 characters (including the 'v ' prefix)
-// and use an output line buffer (of 80 characters in size) for that.
+// and format literals directly into a large output buffer for that.
+
+static void
+flush_output (void)
+{
+  fwrite (output, 1, size_output, stdout);
+  size_output = 0;
+}
 
 static void
 flush_printed_values (void)
 {
-  if (!size_buffer)
+  if (!size_line)
     return;
-  assert (size_buffer + 1 < sizeof buffer);
-  buffer[size_buffer++] = 0;
-  fputc ('v', stdout);
-  fputs (buffer, stdout);
-  fputc ('\n', stdout);
-  size_buffer = 0;
+  output[size_output++] = '\n';
+  size_line = 0;
 }
 
 static inline void
 print_value (int lit)
 {
-  char tmp[32];
-  sprintf (tmp, " %d", lit);
-  const size_t size_tmp = strlen (tmp);
-  if (size_buffer + size_tmp > 77)	// Care for 'v'.
+  char tmp[16];
+  char *const end = tmp + sizeof tmp;
+  char *p = end;
+  unsigned tmp_lit = lit < 0 ? -(unsigned) lit : (unsigned) lit;
+  do
+    *--p = '0' + tmp_lit % 10;
+  while (tmp_lit /= 10);
+  if (lit < 0)
+    *--p = '-';
+  *--p = ' ';
+  const size_t size_tmp = end - p;
+  if (size_line + size_tmp > 77)	// Care for 'v'.
     flush_printed_values ();
-  memcpy (buffer + size_buffer, tmp, size_tmp);
-  size_buffer += size_tmp;
+  if (!size_line)
+    {
+      if (size_output + 80 > sizeof output)	// Room for a full line.
+	flush_output ();
+      output[size_output++] = 'v';
+    }
+  memcpy (output + size_output, p, size_tmp);
+  size_output += size_tmp;
+  size_line += size_tmp;
+}
+
+// Variable-length integer encoding as in the binary proof format.
+
+static inline void
+print_binary_value (int lit)
+{
+  if (size_output + 8 > sizeof output)
+    flush_output ();
+  unsigned tmp = 2 * (unsigned) abs (lit) + (lit < 0);
+  while (tmp > 127)
+    {
+      output[size_output++] = (tmp & 127) | 128;
+      tmp >>= 7;
+    }
+  output[size_output++] = tmp;
+}
+
+// Fetch all values from the library at once and print them.
+
+static void
+print_witness (void)
+{
+  signed char *values = malloc (variables + (size_t) 1);
+  if (!values)
+    error ("out-of-memory allocating values");
+  satch_values (solver, values, variables);
+  if (binary_witness)
+    {
+      output[size_output++] = 'v';
+      for (int idx = 1; idx <= variables; idx++)
+	print_binary_value (values[idx] < 0 ? -idx : idx);
+      print_binary_value (0);
+    }
+  else
+    {
+      for (int idx = 1; idx <= variables; idx++)
+	print_value (values[idx] < 0 ? -idx : idx);
+      print_value (0);
+      flush_printed_values ();
+    }
+  flush_output ();
+  free (values);
+}
+
+/*------------------------------------------------------------------------*/
+
+// With '--stats=json' the statistics obtained through the API function
+// 'satch_get_statistics' are printed as one JSON object to '<stderr>' at
+// the end, thus not interfering with the DIMACS output on '<stdout>'.  With
+// '--stats=json=<file>' the object is written to the given file instead.
+// Rates and time per round are derived here to simplify dashboards.
+
+static double
+average (double a, double b)
+{
+  return b ? a / b : 0;
+}
+
+static void
+write_json_statistics (FILE * file, int res)
+{
+  struct satch_stats s;
+  satch_get_statistics (solver, &s);
+  fprintf (file, "{\n  \"version\": \"%s\"", satch_version ());
+  fprintf (file, ",\n  \"result\": %d", res);
+#define COUNTER(NAME) \
+  fprintf (file, ",\n  \"%s\": %" PRIu64, #NAME, s.NAME)
+#define VALUE(NAME,VALUE) \
+  fprintf (file, ",\n  \"%s\": %.6f", NAME, (double) (VALUE))
+  COUNTER (conflicts);
+  COUNTER (decisions);
+  COUNTER (propagations);
+  COUNTER (ticks);
+  COUNTER (focused_ticks);
+  COUNTER (stable_ticks);
+  COUNTER (visited);
+  COUNTER (blocked);
+  COUNTER (searched);
+  COUNTER (cached);
+  VALUE ("cache_hit_rate", average (s.cached, s.searched));
+  COUNTER (deduced);
+  COUNTER (minimized);
+  COUNTER (shrunken);
+  COUNTER (learned);
+  COUNTER (restarts);
+  COUNTER (reductions);
+  COUNTER (reduced);
+  COUNTER (eliminations);
+  COUNTER (eliminated);
+  COUNTER (elimination_ticks);
+  COUNTER (subsumptions);
+  COUNTER (subsumed);
+  COUNTER (strengthened);
+  COUNTER (subsumption_ticks);
+  COUNTER (vivifications);
+  COUNTER (vivified);
+  COUNTER (vivification_ticks);
+  COUNTER (probings);
+  COUNTER (probed);
+  COUNTER (failed);
+  COUNTER (substituted);
+  COUNTER (probe_ticks);
+  COUNTER (fixed);
+  COUNTER (memory);
+  COUNTER (allocations);
+  VALUE ("allocations_per_conflict", average (s.allocations, s.conflicts));
+  VALUE ("eliminate_time", s.eliminate_time);
+  VALUE ("eliminate_time_per_round",
+	 average (s.eliminate_time, s.eliminations));
+  VALUE ("subsume_time", s.subsume_time);
+  VALUE ("subsume_time_per_round",
+	 average (s.subsume_time, s.subsumptions));
+  VALUE ("vivify_time", s.vivify_time);
+  VALUE ("vivify_time_per_round", average (s.vivify_time, s.vivifications));
+  VALUE ("probe_time", s.probe_time);
+  VALUE ("probe_time_per_round", average (s.probe_time, s.probings));
+  VALUE ("reduce_time", s.reduce_time);
+  VALUE ("reduce_time_per_round", average (s.reduce_time, s.reductions));
+  VALUE ("focused_time", s.focused_time);
+  VALUE ("stable_time", s.stable_time);
+  VALUE ("parse_time", s.parse_time);
+  VALUE ("solve_time", s.solve_time);
+  VALUE ("process_time", s.process_time);
+  VALUE ("conflicts_per_second", average (s.conflicts, s.process_time));
+  VALUE ("propagations_per_second",
+	 average (s.propagations, s.process_time));
+#undef COUNTER
+#undef VALUE
+  fprintf (file, "\n}\n");
+}
+
+static void
+print_json_statistics (int res)
+{
+  if (!json[12])
+    {
+      fflush (stdout);
+      write_json_statistics (stderr, res);
+      fflush (stderr);
+      return;
+    }
+  const char *path = json + 13;
+  FILE *file = fopen (path, "w");
+  if (!file)
+    error ("can not write statistics '%s'", path);
+  write_json_statistics (file, res);
+  if (fclose (file))
+    error ("failed to close statistics '%s'", path);
+  message ("wrote statistics '%s'", path);
 }
 
 /*------------------------------------------------------------------------*/
@@ -891,10 +1697,12 @@ file_readable (const char *path)
 
 // Without POSIX support (usually enabled through './configure --pedantic'
 // which in turn enforces '-Werror -std=c99 --pedantic' as compiler options)
-// we do not support compressed input files since 'popen' is missing.
+// we do not support compressed input files since 'popen' is missing,
+// unless in-process decompression was configured (see 'decompressor').
 // Otherwise we rely on external decompression tools and a pipe.
 
-#ifdef _POSIX_C_SOURCE
+#if defined(_POSIX_C_SOURCE) || defined(ZLIB) || \
+    defined(LZMA) || defined(ZSTD)
 
 static bool
 has_suffix (const char *str, const char *suffix)
@@ -903,6 +1711,10 @@ has_suffix (const char *str, const char *suffix)
   return l >= k && !strcmp (str + l - k, suffix);
 }
 
+#endif
+
+#ifdef _POSIX_C_SOURCE
+
 // Open a pipe to a command given as a 'printf' style format string which is
 // expected to contain exactly one '%s' which is replaced by the path.
 
@@ -1015,8 +1827,8 @@ set_option (const char **p, const char *a)
     error ("redundant '%s' and '%s'", *p, a);
 }
 
-// The next function parses a long option with a 32-bit integer argument
-// precisely and checks for under- and overflow.
+// The next function parses a long option with an integer argument in the
+// range from 'min' to 'max' precisely and checks for under- and overflow.
 
 // The first argument 'arg' is the string giving as long option on the
 // command line.  The 'name' denotes the name of the option (without leading
@@ -1028,8 +1840,9 @@ set_option (const char **p, const char *a)
 // 'INT_MAX < -INT_MIN' and the second loop would fail for 'INT_MIN').
 
 static bool
-parse_int_option (const char *arg,
-		  const char *name, const char **option_ptr, int *value_ptr)
+parse_integer_option (const char *arg,
+		      const char *name, const char **option_ptr,
+		      long long min, long long max, long long *value_ptr)
 {
   if (*arg++ != '-')
     return false;
@@ -1042,7 +1855,7 @@ parse_int_option (const char *arg,
     return false;
   if (ch != '=')
     return false;
-  int value;
+  long long value;
   if ((ch = *arg++) == '-')
     {
       ch = *arg++;
@@ -1051,11 +1864,11 @@ parse_int_option (const char *arg,
       value = '0' - ch;
       while (isdigit (ch = *arg++))
 	{
-	  if (INT_MIN / 10 > value)
+	  if (min / 10 > value)
 	    return false;
 	  value *= 10;
 	  const int digit = ch - '0';
-	  if (INT_MIN + digit > value)
+	  if (min + digit > value)
 	    return false;
 	  value -= digit;
 	}
@@ -1067,11 +1880,11 @@ parse_int_option (const char *arg,
       value = ch - '0';
       while (isdigit (ch = *arg++))
 	{
-	  if (INT_MAX / 10 < value)
+	  if (max / 10 < value)
 	    return false;
 	  value *= 10;
 	  const int digit = ch - '0';
-	  if (INT_MAX - digit < value)
+	  if (max - digit < value)
 	    return false;
 	  value += digit;
 	}
@@ -1083,6 +1896,87 @@ parse_int_option (const char *arg,
   return true;
 }
 
+static bool
+parse_int_option (const char *arg,
+		  const char *name, const char **option_ptr, int *value_ptr)
+{
+  long long value;
+  if (!parse_integer_option (arg, name, option_ptr, INT_MIN, INT_MAX, &value))
+    return false;
+  *value_ptr = value;
+  return true;
+}
+
+// The ticks limit of 'satch_set_ticks_limit' has 64 bits.
+
+static bool
+parse_long_long_option (const char *arg, const char *name,
+			const char **option_ptr, long long *value_ptr)
+{
+  return parse_integer_option (arg, name, option_ptr,
+			       LLONG_MIN, LLONG_MAX, value_ptr);
+}
+
+/*------------------------------------------------------------------------*/
+
+// The timeline given with '--timeline=<trace>' is written at the very end.
+
+static void
+write_timeline (void)
+{
+  const char *path = strchr (timeline, '=') + 1;
+  FILE *file = fopen (path, "w");
+  if (!file)
+    error ("can not write timeline '%s'", path);
+  satch_write_timeline (solver, file);
+  if (fclose (file))
+    error ("failed to close timeline '%s'", path);
+  message ("wrote timeline '%s'", path);
+}
+
+/*------------------------------------------------------------------------*/
+
+// With '--cubes=<icnf>' the parsed clauses are written to the given file
+// in the 'p inccnf' format of incremental solvers and then each generated
+// cube is appended as 'a <lit> ... 0' line.  Solving the original clauses
+// under each cube thus splits the problem into independent sub-problems.
+
+static const char *
+cubes_path (void)
+{
+  const char *path = strchr (cubes, '=');
+  assert (path);
+  return path + 1;
+}
+
+static FILE *
+write_clauses_for_cubing (void)
+{
+  const char *path = cubes_path ();
+  if (!force && strcmp (path, "/dev/null") && file_readable (path))
+    error ("will not overwrite '%s' without '-f' (try '-h')", path);
+  FILE *file = fopen (path, "w");
+  if (!file)
+    error ("can not write cubes to '%s'", path);
+  fputs ("p inccnf\n", file);
+  for (const int *p = original.begin; p != original.end; p++)
+    if (*p)
+      fprintf (file, "%d ", *p);
+    else
+      fputs ("0\n", file);
+  RELEASE_STACK (original);
+  return file;
+}
+
+static void
+write_cube (void *file, int size, const int *cube)
+{
+  fputc ('a', file);
+  for (int i = 0; i < size; i++)
+    fprintf (file, " %d", cube[i]);
+  fputs (" 0\n", file);
+}
+
 /*------------------------------------------------------------------------*/
 
 int
@@ -1090,6 +1984,16 @@ main (int argc, char **argv)
 {
   const char *conflict_option = 0;
   int conflict_limit = -1;
+  const char *ticks_option = 0;
+  long long ticks_limit = -1;
+  const char *time_option = 0;
+  int time_limit = -1;
+  const char *threads_option = 0;
+  int threads = 1;
+  const char *elimination_option = 0;
+  int elimination_threads = 1;
+  const char *depth_option = 0;
+  int cube_depth = 8;
 
   for (int i = 1; i < argc; i++)
     {
@@ -1106,16 +2010,41 @@ main (int argc, char **argv)
 	set_option (&ascii, arg);
       else if (!strcmp (arg, "-b") || !strcmp (arg, "--binary"))
 	set_option (&binary, arg);
+      else if (!strcmp (arg, "--async-proof"))
+	set_option (&asynchronous, arg);
+      else if (!strcmp (arg, "--async-check"))
+	set_option (&checking, arg);
       else if (!strcmp (arg, "-f") || !strcmp (arg, "--force"))
 	set_option (&force, arg);
       else if (!strcmp (arg, "-n") || !strcmp (arg, "--no-witness"))
 	set_option (&no_witness, arg);
+      else if (!strcmp (arg, "-w") || !strcmp (arg, "--binary-witness"))
+	set_option (&binary_witness, arg);
 
       else if (!strcmp (arg, "-l") || !strcmp (arg, "--log"))
 #ifdef LOGGING
 	set_option (&logging, arg);
 #else
 	error ("solver configured without logging support");
+#endif
+      else if (!strcmp (arg, "--strict"))
+	set_option (&strict, arg);
+      else if (!strcmp (arg, "--encode-xors"))
+	set_option (&encode, arg);
+      else if (!strcmp (arg, "--stats=json") ||
+	       (!strncmp (arg, "--stats=json=", 13) && arg[13]))
+	set_option (&json, arg);
+      else if (!strncmp (arg, "--load=", 7) && arg[7])
+	set_option (&load, arg);
+      else if (!strncmp (arg, "--save=", 7) && arg[7])
+	set_option (&save, arg);
+      else if (!strncmp (arg, "--cubes=", 8) && arg[8])
+	set_option (&cubes, arg);
+      else if (!strncmp (arg, "--timeline=", 11) && arg[11])
+#ifdef TIMELINE
+	set_option (&timeline, arg);
+#else
+	error ("solver configured without timeline support");
 #endif
       else if (!strcmp (arg, "-q") || !strcmp (arg, "--quiet"))
 	set_option (&quiet, arg);
@@ -1128,6 +2057,34 @@ main (int argc, char **argv)
 	    error ("negative conflict limit '%d' in '%s'",
 		   conflict_limit, arg);
 	}
+      else if (parse_long_long_option (arg, "ticks",
+				       &ticks_option, &ticks_limit))
+	{
+	  if (ticks_limit < 0)
+	    error ("negative ticks limit '%lld' in '%s'", ticks_limit, arg);
+	}
+      else if (parse_int_option (arg, "time", &time_option, &time_limit))
+	{
+	  if (time_limit < 0)
+	    error ("negative time limit '%d' in '%s'", time_limit, arg);
+	}
+      else if (parse_int_option (arg, "threads", &threads_option, &threads))
+	{
+	  if (threads <= 0)
+	    error ("expected positive number of threads in '%s'", arg);
+	}
+      else if (parse_int_option (arg, "elimination-threads",
+				 &elimination_option, &elimination_threads))
+	{
+	  if (elimination_threads <= 0)
+	    error ("expected positive number of threads in '%s'", arg);
+	}
+      else if (parse_int_option (arg, "cube-depth",
+				 &depth_option, &cube_depth))
+	{
+	  if (cube_depth < 0)
+	    error ("negative cube depth '%d' in '%s'", cube_depth, arg);
+	}
       else if (arg[0] == '-' && arg[1])
 	error ("invalid command option '%s' (try '-h')", arg);
       else if (proof.path)
@@ -1154,6 +2111,10 @@ main (int argc, char **argv)
   if (logging)
     satch_enable_logging_messages (solver);
 #endif
+  if (checking)
+    satch_asynchronous_checking (solver);
+  if (timeline)
+    satch_enable_timeline (solver);
 
   if (ascii && binary)
     error ("both '%s' and '%s' specified", ascii, binary);
@@ -1161,12 +2122,18 @@ main (int argc, char **argv)
     error ("invalid '%s' without proof file", ascii);
   if (binary && !proof.path)
     error ("invalid '%s' without proof file", binary);
+  if (asynchronous && !proof.path)
+    error ("invalid '%s' without proof file", asynchronous);
   if (ascii && proof.path && !strcmp (proof.path, "-"))
     error ("invalid '%s' for proofs written to '<stdout>'", ascii);
   if (binary && proof.path && strcmp (proof.path, "-"))
     error ("invalid '%s' for proof written to a file", binary);
   if (binary && proof.path && !strcmp (proof.path, "-") && isatty (1))
     error ("not writing binary proof to terminal ('%s' and '-')", binary);
+  if (binary_witness && no_witness)
+    error ("can not combine '%s' and '%s'", binary_witness, no_witness);
+  if (binary_witness && isatty (1))
+    error ("not writing binary witness to terminal ('%s')", binary_witness);
 
   if (!force &&
       proof.path &&
@@ -1174,21 +2141,55 @@ main (int argc, char **argv)
       strcmp (proof.path, "/dev/null") && file_readable (proof.path))
     error ("will not overwrite '%s' without '-f' (try '-h')", proof.path);
 
-  if (!input.path || !strcmp (input.path, "-"))
+  if (load && input.path)
+    error ("can not combine '%s' and DIMACS file '%s'", load, input.path);
+  if (depth_option && !cubes)
+    error ("invalid '%s' without '--cubes'", depth_option);
+  if (cubes && load)
+    error ("can not combine '%s' and '%s'", cubes, load);
+  if (cubes && save)
+    error ("can not combine '%s' and '%s'", cubes, save);
+  if (cubes && proof.path)
+    error ("can not combine '%s' and proof file '%s'", cubes, proof.path);
+  if (cubes && threads_option)
+    error ("can not combine '%s' and '%s'", cubes, threads_option);
+
+  if (load)
+    ;				// Snapshot is loaded instead of parsing.
+  else if (!input.path || !strcmp (input.path, "-"))
     input.path = "<stdin>", input.file = stdin;
 #ifdef _POSIX_C_SOURCE
   else if (!file_readable (input.path))
     error ("can not access '%s'", input.path);
+#endif
+#ifdef ZLIB
+  else if (has_suffix (input.path, ".gz"))
+    open_gzip ();
+#elif defined(_POSIX_C_SOURCE)
   else if (has_suffix (input.path, ".gz"))
     open_pipe ("gzip -c -d %s");
+#endif
+#ifdef _POSIX_C_SOURCE
   else if (has_suffix (input.path, ".bz2"))
     open_pipe ("bzip2 -c -d %s");
+#endif
+#ifdef LZMA
+  else if (has_suffix (input.path, ".xz"))
+    open_lzma ();
+#elif defined(_POSIX_C_SOURCE)
   else if (has_suffix (input.path, ".xz"))
     open_pipe ("xz -c -d %s");
+#endif
+#ifdef ZSTD
+  else if (has_suffix (input.path, ".zst"))
+    open_zstd ();
+#elif defined(_POSIX_C_SOURCE)
+  else if (has_suffix (input.path, ".zst"))
+    open_pipe ("zstd -c -d %s");
 #endif
   else
     input.file = fopen (input.path, "r"), input.close = 1;
-  if (!input.file)
+  if (!load && !input.file && !decompressor.read)
     error ("can not read DIMACS file '%s'", input.path);
 
   init_signal_handler ();
@@ -1209,18 +2210,53 @@ main (int argc, char **argv)
 
       if (ascii)
 	satch_ascii_proof (solver);
+      if (asynchronous)
+	satch_asynchronous_proof (solver);
       satch_trace_proof (solver, proof.file);
     }
 
-  parse ();
+  if (load)
+    load_snapshot ();
+  else
+    parse ();
 
+  if ((conflict_option || ticks_option || time_option) && !quiet)
+    satch_section (solver, "limits");
   if (conflict_option && !quiet)
+    message ("conflict limit set to %d conflicts", conflict_limit);
+  if (ticks_option)
+    {
+      if (!quiet)
+	message ("ticks limit set to %lld ticks", ticks_limit);
+      satch_set_ticks_limit (solver, ticks_limit);
+    }
+  if (time_option)
     {
-      satch_section (solver, "limits");
-      message ("conflict limit set to %d conflicts", conflict_limit);
+      if (!quiet)
+	message ("time limit set to %d seconds", time_limit);
+      satch_set_time_limit (solver, time_limit);
     }
 
-  int res = satch_solve (solver, conflict_limit);
+  if (elimination_option)
+    satch_set_elimination_threads (solver, elimination_threads);
+
+  if (threads > 1 && proof.file)
+    message ("proof tracing forces sequential solving without threads");
+
+  int res;
+  if (cubes)
+    {
+      FILE *file = write_clauses_for_cubing ();
+      res = conflict_option ? satch_solve (solver, conflict_limit) : 0;
+      if (!res)
+	res = satch_cube (solver, cube_depth, file, write_cube);
+      if (fclose (file))
+	error ("failed to close cubes file '%s'", cubes_path ());
+      if (!quiet)
+	message ("wrote cubes to '%s'", cubes_path ());
+    }
+  else
+    res = satch_solve_parallel (solver, threads, conflict_limit);
 
   if (proof.file)
     {
@@ -1241,12 +2277,7 @@ main (int argc, char **argv)
 #endif
       printf ("s SATISFIABLE\n");
       if (!no_witness)
-	{
-	  for (int i = 1; i <= variables; i++)
-	    print_value (satch_val (solver, i));
-	  print_value (0);
-	  flush_printed_values ();
-	}
+	print_witness ();
       fflush (stdout);
     }
   else if (res == UNSATISFIABLE)
@@ -1255,13 +2286,21 @@ main (int argc, char **argv)
       fflush (stdout);
     }
   else
-    message ("no result");
+    {
+      message ("no result");
+      if (save)
+	save_snapshot ();
+    }
 
   if (!quiet)
     {
       satch_statistics (solver);
       fflush (stdout);
     }
+  if (json)
+    print_json_statistics (res);
+  if (timeline)
+    write_timeline ();
 
   reset_signal_handler ();
 
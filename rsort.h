@@ -16,13 +16,26 @@
 // completely.  This is marked as 'NEW OPTIMIZATION' in the code below.
 
 // Another new optimization is to skip a round partially if elements turn
-// out to be sorted for the current radix.  Similar in spirit one could
-// check in the first round whether all elements are completely sorted or
-// remove a completely sorted initial prefix or suffix.  Allocation (1),
-// deallocation (2) and copying (3) of the temporary space could be mostly
-// avoided by assuming that we only sort stacks and keep a permanent
-// temporary stack for each of them allocated.  Instead of copying we could
-// just swap the 'begin' pointers of the array instead.
+// out to be sorted for the current radix.  Similar in spirit we check
+// before the first round whether all elements are completely sorted,
+// which only needs to rank the elements up to the first unsorted one.
+
+// The temporary space is not allocated (1), deallocated (2) and copied (3)
+// for every sort.  Instead the caller provides a permanent 'scratch'
+// buffer which is only enlarged if too small.  Sorting a stack with
+// 'RSORT' swaps the buffers of the stack and the scratch space if the
+// sorted elements end up in the scratch space.  This requires that the
+// stack is heap allocated.  Arrays (or stacks pointing into memory not
+// owned by the stack) are sorted with 'RSORT_ARRAY' instead, which
+// copies the sorted elements back if necessary.
+
+// Temporary space shared by all radix sorts (of one solver).
+
+struct scratch
+{
+  void *begin;
+  size_t bytes;
+};
 
 /*------------------------------------------------------------------------*/
 
@@ -39,13 +52,60 @@ do { \
 
 /*------------------------------------------------------------------------*/
 
-#define RSORT(VTYPE,RTYPE,S,RANK) \
+// Make sure the scratch space has at least the given number of bytes.
+// Its content is not needed and thus not copied.
+
+#define RESERVE_SCRATCH(SCRATCH,BYTES) \
 do { \
-  const size_t N_RANK = SIZE_STACK (S); \
-  if (N_RANK <= 1) \
+  const size_t NEEDED_RESERVE_SCRATCH = (BYTES); \
+  if (NEEDED_RESERVE_SCRATCH <= (SCRATCH).bytes) \
     break; \
+  size_t NEW_RESERVE_SCRATCH = 2 * (SCRATCH).bytes; \
+  if (NEW_RESERVE_SCRATCH < NEEDED_RESERVE_SCRATCH) \
+    NEW_RESERVE_SCRATCH = NEEDED_RESERVE_SCRATCH; \
+  free ((SCRATCH).begin); \
+  (SCRATCH).begin = malloc (NEW_RESERVE_SCRATCH); /*(1)*/ \
+  if (!(SCRATCH).begin) \
+    out_of_memory (NEW_RESERVE_SCRATCH); \
+  (SCRATCH).bytes = NEW_RESERVE_SCRATCH; \
+} while (0)
+
+#define RELEASE_SCRATCH(SCRATCH) \
+do { \
+  free ((SCRATCH).begin); /*(2)*/ \
+  (SCRATCH).begin = 0; \
+  (SCRATCH).bytes = 0; \
+} while (0)
+
+/*------------------------------------------------------------------------*/
+
+// Sort the 'N' elements in 'V' using 'SCRATCH' as temporary space.  The
+// sorted elements end up either in 'V' or in the scratch space and
+// 'RES' points to them afterwards.
+
+#define RADIX_SORT(VTYPE,RTYPE,N,V,RANK,SCRATCH,RES) \
+do { \
+  const size_t N_RANK = (N); \
+  VTYPE * V_RANK = (V); \
+  (RES) = V_RANK; \
   \
-  VTYPE * V_RANK = (S).begin; \
+  /* Check whether the elements are already completely sorted.  This
+   * usually stops early at the first unsorted element.
+   */ \
+  { \
+    RTYPE LAST_RANK = RANK (V_RANK[0]); \
+    size_t K_RANK = 1; \
+    while (K_RANK != N_RANK) \
+      { \
+	RTYPE R_RANK = RANK (V_RANK[K_RANK]); \
+	if (R_RANK < LAST_RANK) \
+	  break; \
+	LAST_RANK = R_RANK; \
+	K_RANK++; \
+      } \
+    if (K_RANK == N_RANK) \
+      break; \
+  } \
   \
   const size_t LENGTH_RANK = 8; \
   const size_t WIDTH_RANK = (1 << LENGTH_RANK); \
@@ -150,14 +210,13 @@ do { \
 	  POS_RANK += DELTA_RANK; \
 	} \
       \
-      /* Only allocate the temporary copy space on-demand.
+      /* Only reserve the temporary copy space on-demand.
       */ \
       if (!TMP_RANK) \
 	{ \
 	  assert (C_RANK == A_RANK); \
-	  TMP_RANK = malloc (BYTES_TMP_RANK); /*(1)*/ \
-	  if (!TMP_RANK) \
-	    out_of_memory (BYTES_TMP_RANK); \
+	  RESERVE_SCRATCH ((SCRATCH), BYTES_TMP_RANK); \
+	  TMP_RANK = (SCRATCH).begin; \
 	  B_RANK = TMP_RANK; \
 	} \
       \
@@ -177,13 +236,46 @@ do { \
       C_RANK = D_RANK; \
     } \
   \
-  if (C_RANK == B_RANK) \
-    memcpy (A_RANK, B_RANK, N_RANK * sizeof *A_RANK); /*(3)*/ \
-  \
-  if (TMP_RANK) \
-    free (TMP_RANK); /*(2)*/ \
-  \
-  CHECK_RANKED (N_RANK, V_RANK, RANK); \
+  (RES) = C_RANK; \
+  CHECK_RANKED (N_RANK, C_RANK, RANK); \
+} while (0)
+
+// Sort a heap allocated stack and swap the memory of the stack with the
+// scratch space instead of copying if the result ends up in the latter.
+
+#define RSORT(VTYPE,RTYPE,S,RANK,SCRATCH) \
+do { \
+  const size_t N_RSORT = SIZE_STACK (S); \
+  if (N_RSORT <= 1) \
+    break; \
+  VTYPE * V_RSORT = (S).begin; \
+  VTYPE * RES_RSORT; \
+  RADIX_SORT (VTYPE, RTYPE, N_RSORT, V_RSORT, RANK, SCRATCH, RES_RSORT); \
+  if (RES_RSORT == V_RSORT) \
+    break; \
+  assert (RES_RSORT == (SCRATCH).begin); \
+  const size_t BYTES_RSORT = CAPACITY_STACK (S) * sizeof (VTYPE); \
+  (S).begin = RES_RSORT; \
+  (S).end = RES_RSORT + N_RSORT; \
+  (S).allocated = RES_RSORT + (SCRATCH).bytes / sizeof (VTYPE); \
+  (SCRATCH).begin = V_RSORT; \
+  (SCRATCH).bytes = BYTES_RSORT; \
+} while (0)
+
+// Sort an array of 'N' elements (copying the result back if necessary).
+
+#define RSORT_ARRAY(VTYPE,RTYPE,N,A,RANK,SCRATCH) \
+do { \
+  const size_t N_RSORT_ARRAY = (N); \
+  if (N_RSORT_ARRAY <= 1) \
+    break; \
+  VTYPE * A_RSORT_ARRAY = (A); \
+  VTYPE * RES_RSORT_ARRAY; \
+  RADIX_SORT (VTYPE, RTYPE, N_RSORT_ARRAY, A_RSORT_ARRAY, \
+              RANK, SCRATCH, RES_RSORT_ARRAY); \
+  if (RES_RSORT_ARRAY != A_RSORT_ARRAY) \
+    memcpy (A_RSORT_ARRAY, RES_RSORT_ARRAY, \
+            N_RSORT_ARRAY * sizeof *A_RSORT_ARRAY); /*(3)*/ \
 } while (0)
 
 /*------------------------------------------------------------------------*/
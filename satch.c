@@ -56,6 +56,13 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+// Snapshots are memory mapped while loading if POSIX is available.
+
+#ifdef _POSIX_C_SOURCE
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 /*------------------------------------------------------------------------*/
 
 // Rather complex and painful to implement checking of the compatibility of
@@ -72,9 +79,81 @@
 
 /*------------------------------------------------------------------------*/
 
+// Portfolio solving uses POSIX threads ('pthread_create' and friends) and
+// for clause sharing the GCC builtin atomic operations ('__atomic_...').
+
+#ifndef NPORTFOLIO
+#include <pthread.h>
+#endif
+
+// Resolvents of independent pivots can be computed by parallel threads
+// during bounded variable elimination ('satch_set_elimination_threads'),
+// which needs the POSIX threads of portfolio solving.  We use the internal
+// macro 'NPARALLEL' to denote the case where this is not available.
+
+#ifdef NPARALLEL
+#undef NPARALLEL		// Derived below and not an option, thus ignore it.
+#endif
+
+#if defined(NPORTFOLIO) || defined(NELIMINATION)
+#define NPARALLEL
+#endif
+
+/*------------------------------------------------------------------------*/
+
+// The vectorized replacement search in propagation ('SIMD' defined) is
+// only available for GCC compatible compilers on x86 and then uses AVX2
+// gather instructions if the processor supports them at run-time.
+
+#ifdef SIMD
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define AVX2
+#include <immintrin.h>
+#endif
+#endif
+
+// Reserving address space for the per-variable arrays with anonymous
+// memory mappings ('MMAP' defined) needs 'MAP_ANONYMOUS' which is for
+// instance not declared with '-std=c99' ('./configure -p').  We use the
+// internal macro 'MAPPED' to denote the case where it is available.
+
+#ifdef MMAP
+#include <sys/mman.h>
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#ifdef MAP_ANONYMOUS
+#define MAPPED
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+#endif
+#endif
+
+// The cold tier of compressed learned clauses ('COLD' defined) is fed by
+// clause reduction and promotes clauses back to watched clauses during
+// propagation.  It is thus disabled without learning, reduction and
+// watches.
+
+#ifdef COLD
+#if defined(NCDCL) || defined(NLEARN) || defined(NREDUCE) || defined(NWATCHES)
+#undef COLD
+#endif
+#endif
+
+/*------------------------------------------------------------------------*/
+
 // Hard coded options for simplicity.
 
 #define slow_alpha              1e-5	// Exponential moving average rate.
+#define terminate_delay         64	// Checks before polling termination.
+#define proof_buffer_size  (1u << 22)	// Bytes in proof buffer (4 MB).
+#define proof_literal_bytes     16	// Upper bound on encoded literal.
+
+#ifdef MAPPED
+#define mapped_variables   (1u << 22)	// Minimum reserved variables.
+#define mapped_growth           16	// Reserved variables growth factor.
+#endif
 
 #ifndef NSWITCH
 #define initial_focused_mode_conflicts 1e3
@@ -85,6 +164,13 @@
 #define vivification_interval 1000 // Base elimination interval.
 #endif
 
+#ifndef NPROBING
+#ifndef NINPROCESSING
+#define probing_interval	400	// Base probing interval.
+#define probing_ticks_fraction	0.1	// Ticks fraction in probing.
+#endif
+#endif
+
 #ifndef NELIMINATION
 
 #ifndef NINPROCESSING
@@ -99,6 +185,16 @@
 #define elimination_clause_size_limit 100
 #define elimination_rounds 2
 #endif
+
+#ifndef NGATES
+#define gate_occurrence_limit 32	// Occurrences for ITE and XOR gates.
+#define xor_gate_size_limit 5	// Maximum XOR gate clause size.
+#endif
+
+#ifndef NPARALLEL
+#define parallel_elimination_batch 64	// Minimum independent pivots.
+#define parallel_elimination_limit 4096	// Maximum independent pivots.
+#endif
 #endif
 
 #ifndef NSUBSUMPTION
@@ -135,6 +231,25 @@
 #endif
 #endif
 #define reduce_interval         300	// Reduce conflicts interval.
+#ifdef COLD
+#define cold_fraction           0.5	// Fraction of reduced clauses cooled.
+#define cold_reductions         2	// Reductions cold clauses survive.
+#endif
+#endif
+
+#ifndef NPORTFOLIO
+#define shared_glue_limit       2	// Maximum glue of shared clauses.
+#define shared_size_limit       16	// Maximum size of shared clauses.
+#define shared_ring_size        1024	// Slots of clause sharing rings.
+#define import_interval         256	// Import shared clauses interval.
+#endif
+
+#define snapshot_glue_limit     6	// Glue limit of saved redundant clauses.
+
+#define cube_candidates         16	// Variables looked ahead per split.
+
+#ifdef TIMELINE
+#define timeline_size		(1u<<16)	// Events kept (power of two).
 #endif
 
 #ifndef NREPHASE
@@ -167,8 +282,17 @@
 #endif
 
 #ifndef NHEAP
+#ifdef FLOATSCORES
+#define SCORE_TYPE		float	// Single precision scores.
+#define MAX_SCORE		1e30	// Maximum score before rescore.
+#else
+#define SCORE_TYPE		double	// Double precision scores.
 #define MAX_SCORE		1e150	// Maximum score before rescore.
 #endif
+#ifndef NQUATERNARY
+#define heap_arity		4	// Children per heap node.
+#endif
+#endif
 
 
 #ifdef NCDCL
@@ -218,6 +342,7 @@ struct clause
   bool garbage:1;		// Collect at next garbage collection.
   bool protected:1;		// Do not collect current reason clauses.
   bool redundant:1;		// Redundant / learned (not irredundant).
+  bool parity:1;		// Reason of native XOR constraint.
 #ifndef NSUBSUMPTION
   bool subsumed:1;		// Already used in subsumption.
 #endif
@@ -232,6 +357,9 @@ struct clause
   bool shrunken:1;
   unsigned vivify:2;
 #endif
+#ifndef NARENA
+  bool moved:1;			// Moved during arena compaction.
+#endif
 
 #ifdef NWATCHES
  unsigned sum;			// Sum of non-false literals.
@@ -275,6 +403,175 @@ struct clauses
 
 /*------------------------------------------------------------------------*/
 
+// Native XOR constraints added through 'satch_add_xor' are not encoded into
+// clauses but kept separately over variables, where an odd number of them
+// has to be true if 'parity' is set and an even number otherwise.  The
+// first two variables are watched.  Since such a constraint propagates at
+// most one variable at a time, it has its own 'reason' clause which is
+// filled with the current literals whenever it propagates or becomes
+// conflicting.  It is allocated outside of the arena and flagged as
+// 'parity' reason.  This way conflict analysis, minimization, shrinking
+// and chronological backtracking just see a clause.
+
+struct xor
+{
+  bool parity;			// Odd number of variables true.
+#ifndef NDEBUG
+  bool checked;			// Reason clause added to the checker.
+#endif
+  unsigned size;		// Number of variables.
+  struct clause *reason;	// Reason and conflict clause.
+  unsigned variables[2];	// Variable indices (actually 'size').
+};
+
+// Stack of XOR constraint pointers.
+
+struct xors
+{
+  struct xor **begin, **end, **allocated;
+};
+
+#ifdef COLD
+
+// Reduced learned clauses with the best reduction metric are not deleted
+// but cooled, i.e., moved in compressed form to a separate arena of words.
+// Each literal except the two watched literals is stored as difference to
+// the smallest literal 'base' of the clause in the minimum number 'width'
+// of bytes needed for all literals of the clause (frame of reference
+// encoding).  Propagation only permutes the literals of a clause and thus
+// can swap a replacement literal with the watched literal in place, which
+// is not possible for variable length delta encodings of sorted literals.
+
+// Cold clauses are watched with blocking literals in separate watch lists
+// and are promoted to regular (hot) redundant clauses as soon as they
+// become reasons or conflicting during search.  Clauses which were not
+// promoted for 'cold_reductions' reductions are deleted.
+
+struct cold_clause
+{
+  unsigned size;		// Number of literals.
+  unsigned width:2;		// Bytes per compressed literal minus one.
+  bool garbage:1;		// Promoted or deleted.
+  unsigned age:5;		// Reductions survived in the cold tier.
+  unsigned glue:24;		// Saturated glue (LBD) when cooled.
+  unsigned base;		// Smallest literal.
+  unsigned watched[2];		// Uncompressed watched literals.
+  unsigned char compressed[];	// Remaining 'size - 2' literals.
+};
+
+#define max_cold_glue ((1u << 24) - 1)
+
+struct cold_watch
+{
+  unsigned blocking;		// Blocking literal.
+  unsigned reference;		// Word offset of clause in cold arena.
+};
+
+struct cold_watches
+{
+  struct cold_watch *begin, *end, *allocated;
+};
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
+#ifndef NARENA
+
+// By default large clauses are not allocated separately with 'malloc' but
+// consecutively in one contiguous 'arena' of (64-bit) words.  This keeps
+// clauses which are watched by the same literal close to each other in
+// memory, since during compaction in 'compact_arena' we move them in the
+// order in which they occur in watch lists.  The arena is only compacted
+// after reduction and elimination and otherwise just grows.
+
+struct arena
+{
+  uint64_t *begin, *end, *allocated;
+#ifndef NDEBUG
+  bool pinned;			// Clauses are not allowed to move.
+#endif
+};
+
+#endif
+
+// Without arena ('NARENA' defined) each clause is allocated separately.
+// Then deleted small clauses, which dominate learned clauses after
+// minimization and shrinking, are kept on free lists per clause size and
+// reused when allocating clauses of the same size.  This avoids calls to
+// 'malloc' and 'free' for learned clauses in steady state.  We use the
+// internal macro 'NPOOL' to denote the other case.
+
+#ifdef NPOOL
+#undef NPOOL			// Only derived from 'NARENA' (and 'NVARIADIC').
+#endif
+
+#if !defined(NARENA) || defined(NVARIADIC)
+#define NPOOL
+#endif
+
+#ifndef NPOOL
+#define max_pooled_clause_size 16	// Pool clauses up to this size.
+#endif
+
+/*------------------------------------------------------------------------*/
+
+#ifndef NPORTFOLIO
+
+// In portfolio mode ('satch_solve_parallel') several diversified solver
+// instances, called 'workers', run in parallel threads on copies of the
+// same formula.  The first worker which determines satisfiability wins.
+
+// Workers share learned units and clauses with small glue.  Each worker
+// writes the clauses it exports to its own ring buffer of fixed size slots
+// and is the only writer of that ring (single producer), while all the
+// other workers read from it (multiple consumers).  There are no locks.
+// Instead each slot has a sequence number which is odd while the slot is
+// written.  Readers check this number before and after copying a clause
+// and simply drop the clause if it changed in between (a 'seqlock').  If a
+// reader falls behind by more than the size of the ring it skips the
+// overwritten clauses.  Thus sharing is lossy, but it is also cheap and
+// the producer is never blocked.
+
+struct slot
+{
+  uint64_t sequence;		// Odd while written (even if complete).
+  unsigned size;		// Number of literals in the clause.
+  unsigned glue;		// Glue of the clause (zero for units).
+  unsigned literals[shared_size_limit];
+};
+
+struct ring
+{
+  uint64_t exported;		// Number of clauses written so far.
+  struct slot slots[shared_ring_size];
+};
+
+struct portfolio
+{
+  unsigned size;		// Number of workers.
+  int winner;			// First worker with result (or '-1').
+  bool stop;			// Set by winner to stop the others.
+  struct worker *workers;	// All workers (worker zero is the caller).
+};
+
+struct worker
+{
+  unsigned id;			// Index of this worker in portfolio.
+  int limit;			// Conflict limit for 'solve'.
+  int res;			// Result of 'solve'.
+  uint64_t import;		// Next import conflict limit.
+  uint64_t *imported;		// Imported position of other rings.
+  struct satch *solver;		// Solver instance of this worker.
+  struct portfolio *portfolio;	// Shared portfolio state.
+  pthread_t thread;		// Thread running this worker.
+  struct ring ring;		// Exported clauses of this worker.
+};
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
 // Watches are made of a watch header and a clause unless blocking literals
 // are disabled ('NBLOCK' defined).  If blocking literals are enabled
 // ('NBLOCK' undefined) the blocking literal and thus the header is
@@ -299,10 +596,51 @@ struct clauses
 // unions with a single member 'clause', which clutters code slightly
 // (requires to use 'watch.clause').
 
+// If large clauses are allocated in the arena ('NARENA' undefined) a
+// clause can be referenced by its 32-bit word offset in the arena instead
+// of a full 64-bit pointer.  With blocking literals this reference is
+// packed together with the blocking literal and the two bits 'binary' and
+// 'redundant' into the header and thus a long clause watch only needs one
+// 64-bit wide watch instead of two.  This halves the size of watches of
+// large clauses and thus the memory accessed during propagation.  Since
+// this limits the arena to '2^30' words ('8 GB') packing has to be enabled
+// explicitly with './configure --packed' ('PACKED' defined).  We use the
+// internal macro 'NPACKED' to denote the other case.
+
+#ifdef NPACKED
+#undef NPACKED			// Derived below and not an option, thus ignore it.
+#endif
+
+#if !defined(PACKED) || defined(NARENA) || defined(NBLOCK)
+#define NPACKED
+#endif
+
+// Propagating binary clauses of the trail first ('BINARYFIRST' defined by
+// './configure --binary-first', which implies '--packed') relies on packed
+// watches, where every watch has its own header, and is disabled otherwise.
+
+#if defined(BINARYFIRST) && defined(NPACKED)
+#undef BINARYFIRST
+#endif
+
 #ifndef NBLOCK
 
 // The header part of a watch if blocking literals are used.
 
+#ifndef NPACKED
+
+struct header
+{
+  unsigned blocking;		// Blocking literal of the clause.
+  unsigned binary:1;		// Binary clause.
+  unsigned redundant:1;		// Relevant for statistics and logging.
+  unsigned reference:30;	// Arena offset of the clause.
+};
+
+#define long_clause_watch_size 1	// Clause referenced in header.
+
+#else
+
 struct header
 {
   bool binary;			// Binary clause.
@@ -312,6 +650,8 @@ struct header
 
 #define long_clause_watch_size 2	// Two watches per long clause.
 
+#endif
+
 #else
 
 #define long_clause_watch_size 1	// One without blocking literals.
@@ -336,7 +676,9 @@ struct header
 // undefined) there are always one to two watches considered together on
 // watcher stacks.  The 'binary' field of the first one determines whether
 // the second one really exists (or is the start of another single or pair
-// of watches).  If 'binary' is false the second watch is a clause pointer.
+// of watches).  If 'binary' is false the second watch is a clause pointer,
+// unless the clause reference is packed into the header ('NPACKED' is
+// undefined) in which case a header always forms a watch on its own.
 
 union watch
 {
@@ -374,6 +716,7 @@ struct watches
 #ifdef NSUBSUMPTION
 #ifdef NSWITCH
 #ifdef NVIVIFICATION
+#ifdef NPROBING
 #define NLIMITS
 #endif
 #endif
@@ -382,6 +725,7 @@ struct watches
 #endif
 #endif
 #endif
+#endif
 
 #ifndef NLIMITS
 
@@ -399,6 +743,14 @@ struct limits
 #endif
   } eliminate;
 #endif
+#ifndef NPROBING
+  struct
+  {
+    uint64_t conflicts;		// Conflict-limit on probing.
+    uint64_t ticks;		// Ticks limit for probing.
+    uint64_t search;		// Saved search ticks at last probing.
+  } probe;
+#endif
 #ifndef NVIVIFICATION
   struct {
     uint64_t conflicts; // Conflict-limit on elimination.
@@ -483,10 +835,70 @@ struct reluctant
 struct options
 {
   bool ascii;			// Use ASCII proof format.
+#ifndef NPORTFOLIO
+  bool asynchronous;		// Write proof in a separate thread.
+#endif
 #ifdef LOGGING
   bool logging;			// Print logging messages.
 #endif
   unsigned verbose;		// Verbose level for messages 0..4.
+#ifndef NPARALLEL
+  unsigned elimination_threads;	// Threads computing resolvents.
+#endif
+#ifndef NPORTFOLIO
+  bool stable;			// Start in stable mode.
+  signed char phase;		// Original phase (if non-zero).
+  uint64_t seed;		// Shuffle initial decision order.
+#endif
+};
+
+// Proof lines are not written through 'stdio' literal by literal but
+// encoded into a large proof buffer, which is only written to the proof
+// file if it is full, at the end of 'satch_solve' and in 'satch_release'.
+// With an asynchronous writer the full buffer is handed over to a separate
+// writer thread and encoding continues in a second (spare) buffer.
+
+struct tracer
+{
+  unsigned char *begin, *pos, *end;	// Proof buffer.
+  unsigned char *spare;		// Second buffer for asynchronous writing.
+  bool unflushed;		// Written but not flushed yet.
+#ifndef NPORTFOLIO
+  struct writer *writer;	// Asynchronous writer thread (if started).
+#endif
+};
+
+#ifndef NPORTFOLIO
+
+struct writer
+{
+  pthread_t thread;		// Thread writing proof buffers.
+  pthread_mutex_t lock;		// Protects all fields below.
+  pthread_cond_t handed;	// Signals hand-over and completed writes.
+  FILE *file;			// Proof file written to.
+  const unsigned char *data;	// Buffer to be written (if non-zero).
+  size_t size;			// Number of bytes in that buffer.
+  bool stop;			// Writer thread should terminate.
+};
+
+#endif
+
+// Budgets and forced termination of 'satch_solve' calls.  The budgets set
+// through the API are relative to the start of each call and are turned
+// into absolute limits in 'start_terminate'.  The ticks limit is checked
+// every time (it is deterministic), while the terminate call-back and the
+// wall-clock time are only polled after 'terminate_delay' checks.
+
+struct terminate
+{
+  int (*function) (void *);	// Terminate call-back (if non-zero).
+  void *state;			// Argument passed to call-back.
+  long long ticks;		// Ticks budget per call (if non-negative).
+  double seconds;		// Wall-clock budget per call (if non-negative).
+  uint64_t limit;		// Ticks limit of current call.
+  double deadline;		// Wall-clock deadline of current call.
+  unsigned delay;		// Remaining checks before polling.
+  bool forced;			// Termination forced in current call.
 };
 
 /*------------------------------------------------------------------------*/
@@ -499,30 +911,69 @@ struct statistics
   uint64_t activated[2];	// Activated variables (added queue/scores).
 #endif
   uint64_t added;		// Number of added clauses.
+  uint64_t allocations;		// Clause memory allocations.
 #ifndef NBEST
   uint64_t bests;		// Number of saved best trails.
 #endif
+#ifndef NBLOCK
+  uint64_t blocked;		// Watches skipped due to true blocking literal.
+#endif
 #ifndef NBUMP
   uint64_t bumped;		// Bumped literals.
+#endif
+#ifndef NCACHE
+  uint64_t cached;		// Replacement found from cached position.
+#endif
+#ifndef NGATES
+  uint64_t and_gates;		// Found AND gates.
+#endif
+#ifdef COLD
+  uint64_t cold;		// Current number of cold clauses.
 #endif
   uint64_t collected;		// Garbage collected bytes.
+#ifndef NARENA
+  uint64_t compacted;		// Number of arena compactions.
+#endif
   uint64_t conflicts;		// Total number of conflicts.
+#ifdef COLD
+  uint64_t cooled;		// Clauses moved to the cold tier.
+#endif
+  uint64_t cube_ticks;		// Propagation ticks during cubing.
+  uint64_t cubes;		// Generated cubes.
   uint64_t deleted;		// Number of deleted clauses.
   uint64_t decisions;		// Total number of decisions.
   uint64_t deduced;		// Deduced literals (of 1st UIP clause).
+#ifndef NGATES
+  uint64_t equivalence_gates;	// Found equivalence gates.
+#endif
 #ifndef NELIMINATION
   uint64_t eliminated;		// Number of eliminated variables.
   uint64_t elimination_ticks;	// Number of elimination ticks.
   uint64_t eliminations;	// Number of elimination phases.
 #endif
+#ifndef NPORTFOLIO
+  uint64_t exported;		// Exported shared clauses.
+#endif
+#ifndef NPROBING
+  uint64_t failed;		// Failed literals found by probing.
+#endif
 #ifdef NLAZYACTIVATION
   uint64_t filled[2];		// Filled variables (added queue/scores).
 #endif
   uint64_t fixed;		// Root level assigned variables (units).
+#ifndef NHYPER
+  uint64_t hyper;		// Hyper binary resolvents found by probing.
+#endif
+#ifndef NPORTFOLIO
+  uint64_t imported;		// Imported shared clauses.
+#endif
 #ifndef NVSIDS
   uint64_t incremented;		// Bumped by incrementing score.
 #endif
   uint64_t irredundant;		// Current number of irredundant clauses.
+#ifndef NGATES
+  uint64_t ite_gates;		// Found if-then-else gates.
+#endif
   uint64_t learned;		// Learned literals (after minimization).
 #ifndef NELIMINATION
   uint64_t marked_eliminate;	// Marked eliminate candidate variables.
@@ -530,13 +981,28 @@ struct statistics
 #ifndef NSUBSUMPTION
   uint64_t marked_subsume;	// Marked subsume candidate variables.
 #endif
+  uint64_t mode_ticks[2];	// Propagation ticks in focused/stable mode.
 #ifndef NMINIMIZE
   uint64_t minimized;		// Minimized literals.
 #endif
 #ifndef NVMTF
   uint64_t moved;		// Bumped by moving to front.
+#endif
+#ifndef NOTFS
+  uint64_t otfs;		// On-the-fly strengthened reasons.
+#endif
+#ifndef NPROBING
+  uint64_t probe_ticks;		// Number of probing ticks.
+  uint64_t probed;		// Number of probed literals.
+  uint64_t probings;		// Number of probing phases.
+#endif
+#ifdef COLD
+  uint64_t promoted;		// Cold clauses promoted back.
 #endif
   uint64_t propagations;	// Propagated literals.
+#ifndef NELIMINATION
+  uint64_t reactivated;		// Reactivated eliminated variables.
+#endif
 #ifndef NBUMPREASONS
   uint64_t reasons;		// Additionally bumped reason side literals.
 #endif
@@ -565,11 +1031,15 @@ struct statistics
 #ifndef NREUSE
   uint64_t reused;		// Number of reused trails.
 #endif
+  uint64_t searched;		// Searched replacements (of long clauses).
   uint64_t sections;		// Number of calls to 'section'.
 #ifndef NSHRINK
   uint64_t shrunken;		// Shrunken literals.
 #endif
   uint64_t solved;		// Number of calls to 'satch_solve'.
+#ifndef NPROBING
+  uint64_t substituted;		// Substituted equivalent variables.
+#endif
 #ifndef NSUBSUMPTION
   uint64_t strengthened;	// Strengthened clauses.
   uint64_t subsumption_ticks;	// Number of subsumption ticks.
@@ -591,6 +1061,7 @@ struct statistics
 #endif
   uint64_t ticks;		// Propagation ticks.
   uint64_t variables;		// Activated variables.
+  uint64_t visited;		// Visited watches during propagation.
 #ifndef NVIVIFICATION
   uint64_t vivify_reused;
   uint64_t vivify_probes;
@@ -603,6 +1074,12 @@ struct statistics
   uint64_t probing_ticks;       // Number of elimination ticks.
   uint64_t vivify_propagations;	// Propagated literals.
 #endif
+#ifndef NGATES
+  uint64_t xor_gates;		// Found XOR gates.
+#endif
+  uint64_t xor_conflicts;	// Conflicts of XOR constraints.
+  uint64_t xor_propagations;	// Literals implied by XOR constraints.
+  uint64_t xors;		// Added XOR constraints.
 };
 
 /*------------------------------------------------------------------------*/
@@ -638,13 +1115,31 @@ struct queue
 
 #ifndef NHEAP
 
-// Priority queue with (E)VSIDS scores implemented as binary heap.
+// Priority queue with (E)VSIDS scores implemented as binary heap or by
+// default as 4-ary heap ('NQUATERNARY' undefined).  The latter is more
+// shallow and keeps a copy of the score of a variable next to it in the
+// heap, so that moving up and down the heap does not need to access the
+// separate 'score' array for every compared variable.
+
+#ifndef NQUATERNARY
+
+struct heap_entry
+{
+  SCORE_TYPE score;		// Copy of the score of the variable.
+  unsigned idx;			// Variable on the heap.
+};
+
+#endif
 
 struct heap
 {
+#ifndef NQUATERNARY
+  struct heap_entry *begin, *end;	// Pre-allocated heap of variables.
+#else
   unsigned *begin, *end;	// Pre-allocated stack of variables.
+#endif
   unsigned *pos;		// Pre-allocated variable to position map.
-  double *score;		// The actual score of the variable.
+  SCORE_TYPE *score;		// The actual score of the variable.
   unsigned size;		// Size of heap (when last used).
   double increment;		// Exponentially increasing score increment.
   double factor;		// Increased by this factor.
@@ -732,9 +1227,11 @@ struct averages
 
 // *INDENT-OFF*
 #define PROFILES \
+PROFILE (cube)                   /* Time spent generating cubes. */ \
 PROFILE_IF_FOCUSED (focused)     /* Time spent in focused mode. */ \
 PROFILE_IF_ELIMINATION (eliminate) /* Time spent in elimination. */ \
 PROFILE (parse)                  /* Time spent parsing. */ \
+PROFILE_IF_PROBING (probe)       /* Time spent probing. */ \
 PROFILE_IF_REDUCE (reduce)       /* Time spent reduce. */ \
 PROFILE (solve)                  /* Time spent solving. */ \
 PROFILE_IF_STABLE (stable)       /* Time spent in stable mode. */ \
@@ -776,6 +1273,12 @@ PROFILE (total)			 /* Total time spent. */
 #define PROFILE_IF_ELIMINATION DO_NOT_PROFILE
 #endif
 
+#ifndef NPROBING
+#define PROFILE_IF_PROBING PROFILE
+#else
+#define PROFILE_IF_PROBING DO_NOT_PROFILE
+#endif
+
 #ifndef NVIVIFICATION
 #define PROFILE_IF_VIVIFICATION PROFILE
 #else
@@ -794,10 +1297,39 @@ PROFILE (total)			 /* Total time spent. */
 
 // *INDENT-ON*
 
+#ifdef TIMELINE
+
+// Time stamp counter, conflicts and ticks at entry or exit of an event.
+
+struct moment
+{
+  uint64_t cycles, conflicts, ticks;
+};
+
+struct event
+{
+  const char *name;		// Profile or event name.
+  struct moment begin, end;	// Entry and exit of the event.
+};
+
+struct timeline
+{
+  struct event *events;		// Ring buffer (zero if not enabled).
+  uint64_t recorded;		// Number of recorded events.
+  uint64_t cycles;		// Time stamp counter when enabled.
+  double time;			// Wall-clock time when enabled.
+};
+
+#endif
+
 struct profile
 {
   double start, time;		// Start time, and total time.
   const char *name;		// Used in 'print_profiles'.
+#ifdef TIMELINE
+  struct moment moment;		// Recorded entry for the timeline.
+  bool frequent;		// Too frequent to be recorded.
+#endif
 };				// Initialized in 'init_profiles'.
 
 #define MAX_PROFILES            16
@@ -822,11 +1354,30 @@ struct flags
   bool eliminated:1;		// Variable eliminated in 'eliminate'.
 #endif
   bool fixed:1;			// Root-level assigned variable (unit).
+  bool assumed:1;		// Assumed (frozen) in next 'satch_solve'.
+  bool xors:1;			// Occurs in native XOR (frozen).
+  unsigned failed:2;		// Failed assumption (one bit per sign).
 #ifndef NSUBSUMPTION
   unsigned subsume:2;		// Newly added after last 'subsume'.
 #endif
 };
 
+#ifdef RECORDS
+
+// Conflict analysis, minimization and shrinking access the decision level,
+// the reason and the analysis mark of every visited variable together.
+// Instead of separate arrays these hot fields are packed into one 16 byte
+// record per variable, which thus usually only touches one cache line.
+
+struct record
+{
+  struct clause *reason;	// Reason clause of a variable.
+  unsigned level;		// Decision level of a variable.
+  signed char mark;		// Analysis flags of a variable.
+};
+
+#endif
+
 /*------------------------------------------------------------------------*/
 
 // The full solver state is captured in this structure.
@@ -838,11 +1389,20 @@ struct satch
   bool iterate;			// Report learned unit clause.
   bool stable;			// Stable mode (fewer restarts).
   bool dense;			// Dense mode (connected - not watched).
+  bool reset;			// Reset incremental state before changes.
+#ifdef AVX2
+  bool avx2;			// Use AVX2 to search replacements.
+#endif
   unsigned level;		// Current decision level.
   unsigned size;		// Number of variables.
   size_t capacity;		// Allocated variables.
+#ifdef MAPPED
+  size_t mapped;		// Reserved variables (address space).
+#endif
   unsigned unassigned;		// Number of unassigned variables.
+#ifndef RECORDS
   unsigned *levels;		// Decision levels of variables.
+#endif
   signed char *values;		// Current assignment of literals.
   struct flags *flags;		// Variable flags.
 #ifndef NSAVE
@@ -856,7 +1416,7 @@ struct satch
   signed char *bests;		// Best phases.
   unsigned best;		// Best trail size.
 #endif
-  signed char *marks;		// Mark flags of variables.
+  signed char *marks;		// Signed mark flags of variables.
 #ifndef NLAZYACTIVATION
   struct unsigned_stack put[2];	// To be put on decision queue / heap.
 #endif
@@ -877,7 +1437,11 @@ struct satch
 #ifndef NHEAP
   struct heap scores[2];	// Variable decision heap (stable=1).
 #endif
+#ifdef RECORDS
+  struct record *records;	// Level, reason and mark of variables.
+#else
   struct clause **reasons;	// Reason clauses of a variable.
+#endif
 #ifndef NBLOCK
   struct clause binary[2];	// Temporary binary clauses.
 #endif
@@ -894,10 +1458,28 @@ struct satch
   struct control control;	// control structure
 #endif
   struct analyzed_stack analyzed;	// Analyzed literals.
+  struct unsigned_stack assumptions;	// Assumed literals.
+  unsigned assumed;		// Satisfied assumptions (decision cursor).
+  unsigned assumption_level;	// Decision level of last assumption.
   struct unsigned_stack clause;	// Temporary clause.
+#ifndef NRADIXSORT
+  struct scratch scratch;	// Temporary space for radix sorting.
+#endif
   struct unsigned_stack blocks;	// Analyzed decision levels.
   struct clauses irredundant;	// Current irredundant clauses.
   struct clauses redundant;	// Current redundant clauses.
+  struct xors xors;		// Native XOR constraints.
+  struct xors *xor_watches;	// XOR constraints watching a variable.
+#ifdef COLD
+  struct unsigned_stack cold;	// Arena of compressed cold clauses.
+  struct cold_watches *cold_watches;	// Cold clauses watching literals.
+#endif
+#ifndef NARENA
+  struct arena arena;		// Allocated large clauses.
+#endif
+#ifndef NPOOL
+  struct clause *pool[max_pooled_clause_size + 1];	// Free lists.
+#endif
 #ifndef NLIMITS
   struct limits limits;		// Limits on restart, reduce, etc.
 #endif
@@ -905,15 +1487,25 @@ struct satch
   struct reluctant reluctant;	// Doubling for stable restart (Luby).
 #endif
   struct options options;	// Few runtime options.
+  struct terminate terminate;	// Budgets and terminate call-back.
   struct averages averages[2];	// Exponential moving averages (stable=1).
   struct statistics statistics;	// Statistic counters.
   struct profiles profiles;	// Built in run-time profiling.
+#ifdef TIMELINE
+  struct timeline timeline;	// Ring buffer of recent events.
+#endif
 #ifndef NDEBUG
   struct int_stack original;	// Copy of all original clauses.
+  struct int_stack original_xors;	// Copy of all original XORs.
   struct checker *checker;	// Internal proof checker.
 #endif
   struct int_stack added;	// Added external clause.
   FILE *proof;			// Tracing to this file if non-zero.
+  struct tracer tracer;		// Buffered (asynchronous) proof writing.
+#ifndef NPORTFOLIO
+  struct worker *worker;	// Portfolio worker (if solving in parallel).
+  bool copied;			// Model copied from winning worker.
+#endif
 #ifdef LOGGING
   char format[4][128];		// String buffer for logging.
   unsigned next_format;		// Next buffer for logging.
@@ -1121,6 +1713,20 @@ do { \
 #define DECISIONS (solver->statistics.decisions)
 #define TICKS (solver->statistics.ticks)
 
+// Decision level, reason and analysis mark of a variable.  Without records
+// ('RECORDS' undefined) the analysis mark shares 'marks' with the signed
+// marks used during simplification (see 'mark_literal').
+
+#ifdef RECORDS
+#define LEVEL(IDX) (solver->records[IDX].level)
+#define REASON(IDX) (solver->records[IDX].reason)
+#define MARK(IDX) (solver->records[IDX].mark)
+#else
+#define LEVEL(IDX) (solver->levels[IDX])
+#define REASON(IDX) (solver->reasons[IDX])
+#define MARK(IDX) (solver->marks[IDX])
+#endif
+
 /*------------------------------------------------------------------------*/
 
 // Iterators for global solver data.  They can be used in a similar way as
@@ -1415,7 +2021,7 @@ format_literal (struct satch *solver, char *res, unsigned ilit)
     return sprintf (res, "%u(%d)", ilit, elit);
 
   const unsigned iidx = INDEX (ilit);
-  const unsigned level = solver->levels[iidx];
+  const unsigned level = LEVEL (iidx);
   return sprintf (res, "%u(%d)@%u=%d", ilit, elit, level, tmp);
 }
 
@@ -1496,6 +2102,9 @@ logging_clause (struct satch *solver, struct clause *c, const char *fmt, ...)
         printf (" temporary binary clause");
       else
 #endif
+      if (c->parity)
+        printf (" size %u XOR reason clause", c->size);
+      else
         {
           if (c->redundant)
             {
@@ -1606,6 +2215,17 @@ process_time (void)
   return res;
 }
 
+// Wall-clock time since the epoch used for time limits.
+
+static double
+wall_clock_time (void)
+{
+  struct timeval tv;
+  if (gettimeofday (&tv, 0))
+    return 0;
+  return 1e-6 * tv.tv_usec + tv.tv_sec;
+}
+
 // The maximum amount of memory used by this process as seen by the system.
 
 static uint64_t
@@ -1655,30 +2275,121 @@ relative (double a, double b)
 
 /*------------------------------------------------------------------------*/
 
-// Macros and functions to 'START' and 'STOP' profiling a function.
+// Ticks spent in search and in all inprocessing procedures combined.  This
+// is the measure for the deterministic ticks budget of 'satch_solve'.
 
-// References to profiles are pushed on the profile stack in order to
-// include time spent in a function in case that function is interrupted
-// ('START' issued but interrupted without the corresponding 'STOP').
+static uint64_t
+total_ticks (struct satch *solver)
+{
+  const struct statistics *const statistics = &solver->statistics;
+  uint64_t res = statistics->ticks + statistics->cube_ticks;
+#ifndef NELIMINATION
+  res += statistics->elimination_ticks;
+#endif
+#ifndef NSUBSUMPTION
+  res += statistics->subsumption_ticks;
+#endif
+#ifndef NVIVIFICATION
+  res += statistics->probing_ticks;
+#endif
+  return res;
+}
 
-// Having this profiling information printed in optimized code running on a
-// full set of benchmarks is very important to find performance regressions.
+/*------------------------------------------------------------------------*/
 
-#define START(NAME) \
-  start_profiling (solver, &solver->profiles.NAME)
+#ifdef TIMELINE
 
-#define STOP(NAME) \
-  stop_profiling (solver, &solver->profiles.NAME, process_time ())
+// With 'TIMELINE' defined the entry and exit of search and inprocessing
+// phases is recorded as event in a fixed size ring buffer once enabled
+// with 'satch_enable_timeline'.  It keeps only the last 'timeline_size'
+// events, which are written by 'satch_write_timeline' in the Chrome trace
+// format (which can be viewed with 'chrome://tracing' or 'Perfetto').
+
+// Time stamps are read from the time stamp counter of x86 processors,
+// which is much cheaper than 'getrusage' and only converted to wall-clock
+// time while writing the trace by comparing the elapsed cycles with the
+// elapsed wall-clock time since enabling the timeline.
+
+static uint64_t
+timeline_cycles (void)
+{
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+  return __builtin_ia32_rdtsc ();
+#else
+  return 1e9 * wall_clock_time ();
+#endif
+}
 
 static void
-init_profiles (struct satch *solver)
+stamp_moment (struct satch *solver, struct moment *moment)
 {
-  struct profiles *profiles = &solver->profiles;
-  profiles->end = profiles->begin;
-#define PROFILE(NAME) \
+  if (!solver->timeline.events)
+    return;
+  moment->cycles = timeline_cycles ();
+  moment->conflicts = solver->statistics.conflicts;
+  moment->ticks = total_ticks (solver);
+}
+
+static void
+record_event (struct satch *solver, const char *name,
+	      const struct moment *begin)
+{
+  struct timeline *timeline = &solver->timeline;
+  if (!timeline->events || begin->cycles < timeline->cycles)
+    return;
+  struct event *event =
+    timeline->events + (timeline->recorded++ & (timeline_size - 1));
+  event->name = name;
+  event->begin = *begin;
+  stamp_moment (solver, &event->end);
+}
+
+// Events which are not profiled are recorded through these macros.
+
+#define BEGIN_EVENT(NAME) \
+  struct moment NAME ## _moment; \
+  stamp_moment (solver, &NAME ## _moment)
+
+#define END_EVENT(NAME) \
+  record_event (solver, #NAME, &NAME ## _moment)
+
+#else
+
+#define BEGIN_EVENT(NAME) do { } while (0)
+#define END_EVENT(NAME) do { } while (0)
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
+// Macros and functions to 'START' and 'STOP' profiling a function.
+
+// References to profiles are pushed on the profile stack in order to
+// include time spent in a function in case that function is interrupted
+// ('START' issued but interrupted without the corresponding 'STOP').
+
+// Having this profiling information printed in optimized code running on a
+// full set of benchmarks is very important to find performance regressions.
+
+#define START(NAME) \
+  start_profiling (solver, &solver->profiles.NAME)
+
+#define STOP(NAME) \
+  stop_profiling (solver, &solver->profiles.NAME, process_time ())
+
+static void
+init_profiles (struct satch *solver)
+{
+  struct profiles *profiles = &solver->profiles;
+  profiles->end = profiles->begin;
+#define PROFILE(NAME) \
   profiles->NAME.name = #NAME;
   PROFILES
 #undef PROFILE
+#if defined(TIMELINE) && !defined(DNCHEAPPROFILING)
+  profiles->decide.frequent = true;
+  profiles->minishrink.frequent = true;
+#endif
 }
 
 static void
@@ -1689,6 +2400,10 @@ start_profiling (struct satch *solver, struct profile *profile)
   profile->start = start;
   assert (profiles->end < profiles->begin + MAX_PROFILES);
   *profiles->end++ = profile;
+#ifdef TIMELINE
+  if (!profile->frequent)
+    stamp_moment (solver, &profile->moment);
+#endif
 }
 
 // Starting and stopping a profile has to follow a block structure, i.e.,
@@ -1709,6 +2424,10 @@ stop_profiling (struct satch *solver, struct profile *profile, double stop)
   const double time = stop - profile->start;
   profile->time += time;
   (void) POP (*profiles);
+#ifdef TIMELINE
+  if (!profile->frequent)
+    record_event (solver, profile->name, &profile->moment);
+#endif
   return time;
 }
 
@@ -1828,15 +2547,27 @@ print_statistics (struct satch *solver, double seconds)
 
   if (verbose)
     printf (F1 " %" L2 PRIu64 " %" L3 "s clauses\n", "added:", s.added, "");
+  printf (F1 " %" L2 PRIu64 " %" L3 ".2f per conflict\n", "allocations:",
+	  s.allocations, relative (s.allocations, s.conflicts));
 #ifndef NBEST
   printf (F1 " %" L2 PRIu64 " %" L3 ".2f interval\n", "bests:",
 	  s.bests, relative (s.conflicts, s.bests));
 #endif
+#ifndef NBLOCK
+  if (verbose)
+    printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  visited\n", "blocked:",
+	    s.blocked, percent (s.blocked, s.visited));
+#endif
 #ifndef NBUMP
   if (verbose)
     printf (F1 " %" L2 PRIu64 " %" L3 ".2f literals\n", "bumped:",
 	    s.bumped, relative (s.bumped, s.conflicts));
 #endif
+#ifndef NCACHE
+  if (verbose)
+    printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  searched\n", "cached:",
+	    s.cached, percent (s.cached, s.searched));
+#endif
 #ifndef NCHRONO
   if (verbose)
     printf (F1 " %" L2 PRIu64 " %" L3 ".2f per learned\n",
@@ -1849,8 +2580,20 @@ print_statistics (struct satch *solver, double seconds)
 #endif
   printf (F1 " %" L2 PRIu64 " %" L3 ".2f MB\n", "collected:",
 	  s.collected, s.collected / (double) (1u << 20));
+#ifndef NARENA
+  if (verbose)
+    printf (F1 " %" L2 PRIu64 " %" L3 ".2f interval\n", "compacted:",
+	    s.compacted, relative (s.conflicts, s.compacted));
+#endif
   printf (F1 " %" L2 PRIu64 " %" L3 ".2f per second\n", "conflicts:",
 	  s.conflicts, relative (s.conflicts, seconds));
+#ifdef COLD
+  printf (F1 " %" L2 PRIu64 " %" L3 ".2f per reduction\n", "cooled:",
+	  s.cooled, relative (s.cooled, s.reductions));
+#endif
+  if (s.cubes)
+    printf (F1 " %" L2 PRIu64 " %" L3 ".2f per second\n", "cubes:",
+	    s.cubes, relative (s.cubes, seconds));
   printf (F1 " %" L2 PRIu64 " %" L3 ".2f per conflict\n", "decisions:",
 	  s.decisions, relative (s.decisions, s.conflicts));
   if (verbose)
@@ -1865,9 +2608,47 @@ print_statistics (struct satch *solver, double seconds)
   if (verbose)
     printf (F1 " %" L2 PRIu64 " %" L3 ".2f interval\n", "eliminations:",
 	    s.eliminations, relative (s.conflicts, s.eliminations));
+#endif
+#ifndef NGATES
+  {
+    const uint64_t gates = s.and_gates + s.equivalence_gates +
+      s.ite_gates + s.xor_gates;
+    printf (F1 " %" L2 PRIu64 " %" L3 ".2f per round\n", "gates:",
+	    gates, relative (gates, s.eliminations));
+    if (verbose)
+      {
+	printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  gates\n", "  and:",
+		s.and_gates, percent (s.and_gates, gates));
+	printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  gates\n",
+		"  equivalence:", s.equivalence_gates,
+		percent (s.equivalence_gates, gates));
+	printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  gates\n", "  ite:",
+		s.ite_gates, percent (s.ite_gates, gates));
+	printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  gates\n", "  xor:",
+		s.xor_gates, percent (s.xor_gates, gates));
+      }
+  }
+#endif
+#ifndef NPORTFOLIO
+  if (verbose)
+    printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  conflicts\n", "exported:",
+	    s.exported, percent (s.exported, s.conflicts));
+#endif
+#ifndef NPROBING
+  printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  probed\n", "failed:",
+	  s.failed, percent (s.failed, s.probed));
 #endif
   printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  variables\n", "fixed:",
 	  s.fixed, percent (s.fixed, s.variables));
+#ifndef NHYPER
+  printf (F1 " %" L2 PRIu64 " %" L3 ".2f per probed\n", "hyper:",
+	  s.hyper, relative (s.hyper, s.probed));
+#endif
+#ifndef NPORTFOLIO
+  if (verbose)
+    printf (F1 " %" L2 PRIu64 " %" L3 ".2f per conflict\n", "imported:",
+	    s.imported, relative (s.imported, s.conflicts));
+#endif
   printf (F1 " %" L2 PRIu64 " %" L3 ".2f literals\n", "learned:",
 	  s.learned, relative (s.learned, s.conflicts));
 #ifndef NVSIDS
@@ -1884,9 +2665,30 @@ print_statistics (struct satch *solver, double seconds)
   if (verbose)
     printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  bumped\n", "moved:",
 	    s.moved, percent (s.moved, s.bumped));
+#endif
+#ifndef NOTFS
+  printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  conflicts\n", "otfs:",
+	  s.otfs, percent (s.otfs, s.conflicts));
+#endif
+#ifndef NPROBING
+  if (verbose)
+    printf (F1 " %" L2 PRIu64 " %" L3 ".2f per round\n", "probed:",
+	    s.probed, relative (s.probed, s.probings));
+  if (verbose)
+    printf (F1 " %" L2 PRIu64 " %" L3 ".2f interval\n", "probings:",
+	    s.probings, relative (s.conflicts, s.probings));
+#endif
+#ifdef COLD
+  printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  cooled\n", "promoted:",
+	  s.promoted, percent (s.promoted, s.cooled));
 #endif
   printf (F1 " %" L2 PRIu64 " %" L3 ".2f per second\n", "propagations:",
 	  s.propagations, relative (s.propagations, seconds));
+#ifndef NELIMINATION
+  if (verbose)
+    printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  eliminated\n", "reactivated:",
+	    s.reactivated, percent (s.reactivated, s.eliminated));
+#endif
 #ifndef NBUMPREASONS
   if (verbose)
     printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  bumped\n", "reasons:",
@@ -1924,6 +2726,9 @@ print_statistics (struct satch *solver, double seconds)
     printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  restarts\n", "reused:",
 	    s.reused, percent (s.reused, s.restarts));
 #endif
+  if (verbose)
+    printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  visited\n", "searched:",
+	    s.searched, percent (s.searched, s.visited));
 #ifndef NSHRINK
   if (verbose)
     printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  deduced\n", "shrunken:",
@@ -1938,6 +2743,10 @@ print_statistics (struct satch *solver, double seconds)
     printf (F1 " %" L2 PRIu64 " %" L3 ".2f interval\n", "subsumptions:",
 	    s.subsumptions, relative (s.conflicts, s.subsumptions));
 #endif
+#ifndef NPROBING
+  printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  variables\n", "substituted:",
+	  s.substituted, percent (s.substituted, s.variables));
+#endif
 #ifndef NSWITCH
   if (verbose)
     printf (F1 " %" L2 PRIu64 " %" L3 ".2f interval\n", "switched:",
@@ -1971,6 +2780,30 @@ print_statistics (struct satch *solver, double seconds)
   if (verbose)
     printf (F1 " %" L2 PRIu64 " %" L3 ".2f per propagation\n", "ticks:",
 	    s.ticks, relative (s.ticks, s.propagations));
+#ifndef NFOCUSED
+  if (verbose)
+    printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  ticks\n", "  focused:",
+	    s.mode_ticks[0], percent (s.mode_ticks[0], s.ticks));
+#endif
+#ifndef NSTABLE
+  if (verbose)
+    printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  ticks\n", "  stable:",
+	    s.mode_ticks[1], percent (s.mode_ticks[1], s.ticks));
+#endif
+  if (verbose)
+    printf (F1 " %" L2 PRIu64 " %" L3 ".2f per propagation\n", "visited:",
+	    s.visited, relative (s.visited, s.propagations));
+  if (s.xors)
+    {
+      printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  added\n", "xors:",
+	      s.xors, percent (s.xors, s.added + s.xors));
+      printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  conflicts\n",
+	      "  conflicts:", s.xor_conflicts,
+	      percent (s.xor_conflicts, s.conflicts));
+      printf (F1 " %" L2 PRIu64 " %" P3 ".0f %%  propagations\n",
+	      "  propagations:", s.xor_propagations,
+	      percent (s.xor_propagations, s.propagations));
+    }
 }
 
 static void
@@ -1998,29 +2831,219 @@ print_resource_usage (struct satch *solver, double seconds)
 // format. The end of a proof line is indicated by zero (then number zero
 // '0' in the ASCII format and the zero byte in the binary format).
 
+// The proof lines are encoded into the proof buffer of the tracer, which
+// is written to the proof file if less than 'proof_literal_bytes' are left.
+
 static void
-start_addition_proof_line (struct satch *solver)
+write_proof_data (FILE * file, const unsigned char *data, size_t size)
+{
+  if (fwrite (data, 1, size, file) != size)
+    fatal_error ("writing proof failed");
+}
+
+#ifndef NPORTFOLIO
+
+// The asynchronous writer thread waits for buffers handed over by the
+// solver thread, writes them to the proof file and then signals the solver
+// that the buffer can be reused (thus at most one buffer is in flight).
+
+static void *
+run_writer (void *ptr)
+{
+  struct writer *writer = ptr;
+  pthread_mutex_lock (&writer->lock);
+  for (;;)
+    {
+      while (!writer->data && !writer->stop)
+	pthread_cond_wait (&writer->handed, &writer->lock);
+      if (!writer->data)
+	break;
+      const unsigned char *data = writer->data;
+      const size_t size = writer->size;
+      pthread_mutex_unlock (&writer->lock);
+      write_proof_data (writer->file, data, size);
+      pthread_mutex_lock (&writer->lock);
+      writer->data = 0;
+      pthread_cond_broadcast (&writer->handed);
+    }
+  pthread_mutex_unlock (&writer->lock);
+  return 0;
+}
+
+static struct writer *
+start_writer (struct satch *solver)
+{
+  struct writer *writer = malloc (sizeof *writer);
+  if (!writer)
+    out_of_memory (sizeof *writer);
+  writer->file = solver->proof;
+  writer->data = 0;
+  writer->size = 0;
+  writer->stop = false;
+  pthread_mutex_init (&writer->lock, 0);
+  pthread_cond_init (&writer->handed, 0);
+  if (pthread_create (&writer->thread, 0, run_writer, writer))
+    fatal_error ("failed to create proof writer thread");
+  return writer;
+}
+
+// Needs to be called with the writer lock held.
+
+static void
+wait_for_writer (struct writer *writer)
+{
+  while (writer->data)
+    pthread_cond_wait (&writer->handed, &writer->lock);
+}
+
+static void
+synchronize_writer (struct writer *writer)
+{
+  pthread_mutex_lock (&writer->lock);
+  wait_for_writer (writer);
+  pthread_mutex_unlock (&writer->lock);
+}
+
+static void
+stop_writer (struct satch *solver)
+{
+  struct writer *writer = solver->tracer.writer;
+  pthread_mutex_lock (&writer->lock);
+  wait_for_writer (writer);
+  writer->stop = true;
+  pthread_cond_broadcast (&writer->handed);
+  pthread_mutex_unlock (&writer->lock);
+  if (pthread_join (writer->thread, 0))
+    fatal_error ("failed to join proof writer thread");
+  pthread_cond_destroy (&writer->handed);
+  pthread_mutex_destroy (&writer->lock);
+  free (writer);
+  solver->tracer.writer = 0;
+}
+
+// Hand over the full buffer to the writer and continue with the spare one.
+
+static void
+hand_over_proof_buffer (struct satch *solver)
+{
+  struct tracer *tracer = &solver->tracer;
+  if (!tracer->writer)
+    tracer->writer = start_writer (solver);
+  if (!tracer->spare && !(tracer->spare = malloc (proof_buffer_size)))
+    out_of_memory (proof_buffer_size);
+  struct writer *writer = tracer->writer;
+  pthread_mutex_lock (&writer->lock);
+  wait_for_writer (writer);
+  writer->data = tracer->begin;
+  writer->size = tracer->pos - tracer->begin;
+  pthread_cond_broadcast (&writer->handed);
+  pthread_mutex_unlock (&writer->lock);
+  unsigned char *spare = tracer->spare;
+  tracer->spare = tracer->begin;
+  tracer->begin = tracer->pos = spare;
+  tracer->end = spare + proof_buffer_size;
+}
+
+#endif
+
+static void
+flush_proof_buffer (struct satch *solver)
+{
+  struct tracer *tracer = &solver->tracer;
+  const size_t size = tracer->pos - tracer->begin;
+  if (!size)
+    return;
+  tracer->unflushed = true;
+#ifndef NPORTFOLIO
+  if (solver->options.asynchronous)
+    {
+      hand_over_proof_buffer (solver);
+      return;
+    }
+#endif
+  write_proof_data (solver->proof, tracer->begin, size);
+  tracer->pos = tracer->begin;
+}
+
+// Make sure that everything traced so far actually reached the proof file.
+
+static void
+flush_proof (struct satch *solver)
+{
+  struct tracer *tracer = &solver->tracer;
+  if (!solver->proof)
+    return;
+  if (tracer->pos == tracer->begin && !tracer->unflushed)
+    return;
+  flush_proof_buffer (solver);
+#ifndef NPORTFOLIO
+  if (tracer->writer)
+    synchronize_writer (tracer->writer);
+#endif
+  fflush (solver->proof);
+  tracer->unflushed = false;
+}
+
+static void
+release_tracer (struct satch *solver)
+{
+  flush_proof (solver);
+  struct tracer *tracer = &solver->tracer;
+#ifndef NPORTFOLIO
+  if (tracer->writer)
+    stop_writer (solver);
+#endif
+  free (tracer->begin);
+  free (tracer->spare);
+  memset (tracer, 0, sizeof *tracer);
+}
+
+static inline unsigned char *
+reserve_proof_bytes (struct satch *solver)
 {
+  struct tracer *tracer = &solver->tracer;
   assert (solver->proof);
+  if (tracer->end - tracer->pos < proof_literal_bytes)
+    flush_proof_buffer (solver);
+  return tracer->pos;
+}
+
+static void
+start_addition_proof_line (struct satch *solver)
+{
+  unsigned char *pos = reserve_proof_bytes (solver);
   if (!solver->options.ascii)
-    fputc ('a', solver->proof);
+    *pos++ = 'a';
+  solver->tracer.pos = pos;
 }
 
 static void
 start_deletion_proof_line (struct satch *solver)
 {
-  assert (solver->proof);
-  fputc ('d', solver->proof);
+  unsigned char *pos = reserve_proof_bytes (solver);
+  *pos++ = 'd';
   if (solver->options.ascii)
-    fputc (' ', solver->proof);
+    *pos++ = ' ';
+  solver->tracer.pos = pos;
 }
 
 static void
 add_external_literal_to_proof_line (struct satch *solver, int elit)
 {
-  assert (solver->proof);
+  unsigned char *pos = reserve_proof_bytes (solver);
   if (solver->options.ascii)
-    fprintf (solver->proof, "%d ", elit);
+    {
+      unsigned rest = abs (elit);
+      if (elit < 0)
+	*pos++ = '-';
+      unsigned char digits[10], *p = digits;
+      do
+	*p++ = '0' + rest % 10, rest /= 10;
+      while (rest);
+      while (p != digits)
+	*pos++ = *--p;
+      *pos++ = ' ';
+    }
   else
     {
       // This is almost like our internal literal encoding except that it is
@@ -2030,7 +3053,7 @@ add_external_literal_to_proof_line (struct satch *solver, int elit)
 
       const unsigned plit = 2u * abs (elit) + (elit < 0);
 
-      // Now this proof literal 'plit' is written 7-bit wise to the file.
+      // Now this proof literal 'plit' is written 7-bit wise to the buffer.
 
       // The 8th most significant bit of the actual written byte denotes
       // whether further non-zero bits, so at least one more byte, follow.
@@ -2039,13 +3062,13 @@ add_external_literal_to_proof_line (struct satch *solver, int elit)
 
       while (rest & ~0x7f)
 	{
-	  const unsigned char byte = (rest & 0x7f) | 0x80;
-	  fputc (byte, solver->proof);
+	  *pos++ = (rest & 0x7f) | 0x80;
 	  rest >>= 7;
 	}
 
-      fputc ((unsigned char) rest, solver->proof);
+      *pos++ = rest;
     }
+  solver->tracer.pos = pos;
 }
 
 static void
@@ -2058,12 +3081,12 @@ add_internal_literal_to_proof_line (struct satch *solver, unsigned ilit)
 static void
 end_proof_line (struct satch *solver)
 {
-  assert (solver->proof);
+  unsigned char *pos = reserve_proof_bytes (solver);
   if (solver->options.ascii)
-    fputs ("0\n", solver->proof);
+    *pos++ = '0', *pos++ = '\n';
   else
-    fputc (0, solver->proof);
-  fflush (solver->proof);
+    *pos++ = 0;
+  solver->tracer.pos = pos;
 }
 
 /*------------------------------------------------------------------------*/
@@ -2185,113 +3208,462 @@ bytes_clause (size_t size)
   return sizeof (struct clause) + (size - 2) * sizeof (unsigned);
 }
 
-// This default variadic variant just allocates one chunk of memory.
+#ifndef NARENA
 
-static struct clause *
-allocate_clause (size_t size)
+// Clauses in the arena are aligned to 64-bit words.
+
+static size_t
+words_clause (size_t size)
 {
   const size_t bytes = bytes_clause (size);
-  struct clause *res = malloc (bytes);
-  if (!res)
-    out_of_memory (bytes);
-  return res;
+  return (bytes + sizeof (uint64_t) - 1) / sizeof (uint64_t);
 }
 
-static size_t
-deallocate_clause (struct clause *c)
+// Moving a clause to a new arena leaves a forwarding pointer in place of
+// its literals and sets the 'moved' flag.  When the second watch (or the
+// entry on the clause stacks) is reached we thus know where it went.
+
+static struct clause *
+move_clause (struct arena *arena, struct clause *c)
 {
-  const size_t bytes = bytes_clause (c->size);
-  free (c);
-  return bytes;
+  struct clause *res;
+  if (c->moved)
+    {
+      memcpy (&res, c->literals, sizeof res);
+      return res;
+    }
+  const size_t words = words_clause (c->size);
+  assert (words <= (size_t) (arena->allocated - arena->end));
+  res = (struct clause *) arena->end;
+  memcpy (res, c, words * sizeof (uint64_t));
+  arena->end += words;
+  assert (sizeof res <= 2 * sizeof (unsigned));
+  memcpy (c->literals, &res, sizeof res);
+  c->moved = true;
+  return res;
 }
 
-#else
+#ifndef NPACKED
 
-// The non-variadic variant has to allocate two memory blocks.
+// Clause references in packed watches are word offsets into the arena and
+// thus the arena is limited to '2^30' words ('8 GB' on 64-bit machines).
 
-static struct clause *
-allocate_clause (size_t size)
+#define MAX_ARENA ((size_t) 1 << 30)
+
+static inline struct clause *
+dereference_clause (uint64_t * arena, unsigned reference)
 {
-  const size_t header_bytes = sizeof (struct clause);
-  struct clause *res = malloc (header_bytes);
-  if (!res)
-    out_of_memory (header_bytes);
-  const size_t literals_bytes = size * sizeof (unsigned);
-  res->literals = malloc (literals_bytes);
-  if (!res->literals)
-    out_of_memory (literals_bytes);
-  return res;
+  return (struct clause *) (arena + reference);
 }
 
-static size_t
-deallocate_clause (struct clause *c)
+static inline unsigned
+clause_reference (uint64_t * arena, const struct clause *c)
 {
-  const size_t header_bytes = sizeof (struct clause);
-  const size_t literals_bytes = c->size * sizeof (unsigned);
-  free (c->literals);
-  free (c);
-  return header_bytes + literals_bytes;
+  const size_t res = (const uint64_t *) c - arena;
+  assert (res < MAX_ARENA);
+  return res;
 }
 
 #endif
 
-/*------------------------------------------------------------------------*/
+// Watches and reasons might also contain tagged binary clauses (see
+// 'tag_binary_clause' below) which of course can not be moved.  Those are
+// easily recognized as real clauses in the arena are word aligned.
 
-// Adding and deleting clauses.
+static struct clause *
+move_clause_reference (struct arena *arena, struct clause *c)
+{
+  if ((uintptr_t) c & 3)
+    return c;
+  return move_clause (arena, c);
+}
 
-// We start with the shared clause allocation function 'add_clause'.
+// Watches are traversed literal by literal which places clauses watched by
+// the same literal next to each other.  This is the order in which they are
+// accessed during propagation.  The code needs to follow the watch layout
+// described above and in dense mode only has (tagged) clause pointers.
 
-static struct clause *
-#ifndef NGLUE
-add_clause (struct satch *solver, bool redundant, unsigned glue)
-#else
-add_clause (struct satch *solver, bool redundant)
-#endif
+static void
+move_watched_clauses (struct satch *solver, struct arena *arena)
 {
-#if defined(LOGGING) || defined(NRADIXSORT)
-  const uint64_t added =
-#endif
-    INC (added);
-  const size_t size = SIZE_STACK (solver->clause);
-#ifdef NVIRTUAL
-  assert (size > 1);		// Units and empty clauses are implicit.
-#else
-  assert (size > 2);		// No binary clauses allocated at all!
-#endif
-  struct clause *res = allocate_clause (size);
-#if defined(LOGGING) || defined(NRADIXSORT)
-  res->id = added;
-#endif
-  res->garbage = false;
-  res->protected = false;
-  res->redundant = redundant;
-#ifndef NUSED
-  res->used = 0;
-#endif
-#ifndef NSUBSUMPTION
-  res->subsumed = false;
+#ifndef NPACKED
+  uint64_t *const old_arena = solver->arena.begin;
+  uint64_t *const new_arena = arena->begin;
 #endif
-#ifdef NWATCHES
-  res->sum = 0;
-  res->count = 0;
+  for (all_literals (lit))
+    {
+      struct watches *const watches = solver->watches + lit;
+      const union watch *const end = watches->end;
+      union watch *p = watches->begin;
+      while (p != end)
+	{
+#ifndef NBLOCK
+	  if (!solver->dense)
+	    {
+#ifndef NPACKED
+	      struct header *const header = &p++->header;
+#ifndef NVIRTUAL
+	      if (header->binary)
+		continue;
 #endif
-#ifndef NGLUE
-  res->glue = glue;
+	      struct clause *c =
+		dereference_clause (old_arena, header->reference);
+	      c = move_clause (arena, c);
+	      header->reference = clause_reference (new_arena, c);
+	      continue;
+#else
+#ifndef NVIRTUAL
+	      if (p++->header.binary)
+		continue;
+#else
+	      p++;
 #endif
-#ifndef NCACHE
-  res->search = 0;
 #endif
-  res->size = size;
-#ifndef NVIVIFICATION
-  res->vivify = 0;
-  res->shrunken = false;
+	    }
 #endif
-  memcpy (res->literals, solver->clause.begin, size * sizeof (unsigned));
-  return res;
+	  p->clause = move_clause_reference (arena, p->clause);
+	  p++;
+	}
+    }
 }
 
-static struct clause *
-new_irredundant_clause (struct satch *solver)
+static void
+move_clauses_on_stack (struct arena *arena, struct clauses *clauses)
+{
+  struct clause **const end = clauses->end;
+  for (struct clause ** p = clauses->begin; p != end; p++)
+    *p = move_clause (arena, *p);
+}
+
+static void
+move_reasons (struct satch *solver, struct arena *arena)
+{
+  for (all_elements_on_stack (unsigned, lit, solver->trail))
+    {
+      const unsigned idx = INDEX (lit);
+      struct clause *const reason = REASON (idx);
+      if (!reason)
+	continue;
+      if (!((uintptr_t) reason & 3) && reason->parity)
+	continue;		// XOR reasons are not in the arena.
+      REASON (idx) = move_clause_reference (arena, reason);
+    }
+}
+
+static size_t
+live_arena_words (struct satch *solver)
+{
+  size_t res = 0;
+  for (all_irredundant_clauses (c))
+    res += words_clause (c->size);
+  for (all_redundant_clauses (c))
+    res += words_clause (c->size);
+  return res;
+}
+
+// Move all clauses to a new arena with the given capacity in watch order
+// and update all references to them in watches, clause stacks and reasons.
+// Garbage clauses still referenced (for instance in dense mode) are moved
+// too.  Clauses which have already been deleted are not referenced anymore
+// and thus are dropped which implicitly compacts the arena.
+
+// Clauses are referenced by plain pointers, which are not only stored in
+// watches, clause stacks and reasons (all updated here) but also in local
+// variables and the schedules of inprocessing passes.  Therefore clauses
+// are only moved at safe points, i.e., when adding clauses during search
+// (learned, imported or promoted clauses) and when compacting the arena
+// after reduction, probing and elimination.  Inprocessing passes which add
+// clauses reserve enough space up-front with 'reserve_arena' and only add
+// clauses which fit (see 'available_arena_words').  While a pass runs the
+// arena is pinned (see 'pin_arena') and moving clauses is a bug.
+
+static void
+move_clauses (struct satch *solver, size_t capacity)
+{
+  assert (!solver->arena.pinned);
+#ifndef NVIVIFICATION
+  assert (EMPTY_STACK (solver->vivification_schedule));
+#endif
+  struct arena arena;
+  const size_t bytes = capacity * sizeof (uint64_t);
+  arena.begin = malloc (bytes);
+  if (capacity && !arena.begin)
+    out_of_memory (bytes);
+  INC (allocations);
+  arena.end = arena.begin;
+  arena.allocated = arena.begin + capacity;
+#ifndef NDEBUG
+  arena.pinned = false;
+#endif
+
+  move_watched_clauses (solver, &arena);
+  move_clauses_on_stack (&arena, &solver->irredundant);
+  move_clauses_on_stack (&arena, &solver->redundant);
+  move_reasons (solver, &arena);
+
+  free (solver->arena.begin);
+  solver->arena = arena;
+}
+
+// After reduction and elimination we compact the arena, which leaves as
+// much space for new clauses as live clauses are kept (or more precisely
+// how many words they occupy).
+
+static void
+compact_arena (struct satch *solver)
+{
+  struct arena *const arena = &solver->arena;
+  const size_t before = arena->end - arena->begin;
+  const size_t live = live_arena_words (solver);
+  size_t capacity = 2 * live;
+#ifndef NPACKED
+  if (capacity > MAX_ARENA)
+    capacity = MAX_ARENA;
+#endif
+  move_clauses (solver, capacity);
+  INC (compacted);
+  message (solver, 3, "arena", solver->statistics.compacted,
+	   "compacted arena from %zu to %zu words %.0f%%",
+	   before, live, percent (live, before));
+}
+
+// If the arena is full we move all clauses to a new arena which has twice
+// as much space as needed, thus amortizing the costs of moving clauses.
+
+static void
+enlarge_arena (struct satch *solver, size_t words)
+{
+  const size_t live = live_arena_words (solver);
+  const size_t needed = live + words;
+  size_t capacity = 2 * needed;
+#ifndef NPACKED
+  if (needed > MAX_ARENA)
+    fatal_error ("maximum arena size of %zu words exhausted "
+		 "(configure without '--packed')", MAX_ARENA);
+  if (capacity > MAX_ARENA)
+    capacity = MAX_ARENA;
+#endif
+  move_clauses (solver, capacity);
+  LOG ("enlarged arena to %zu words", capacity);
+}
+
+#ifndef NELIMINATION
+
+static size_t
+available_arena_words (struct satch *solver)
+{
+  const struct arena *const arena = &solver->arena;
+  return arena->allocated - arena->end;
+}
+
+// Make sure that at least the given number of words can be allocated
+// without moving clauses (thus only to be called at safe points).
+
+static void
+reserve_arena (struct satch *solver, size_t words)
+{
+  if (available_arena_words (solver) < words)
+    enlarge_arena (solver, words);
+  assert (available_arena_words (solver) >= words);
+}
+
+#endif
+
+static void
+pin_arena (struct satch *solver)
+{
+#ifndef NDEBUG
+  assert (!solver->arena.pinned);
+  solver->arena.pinned = true;
+#else
+  (void) solver;
+#endif
+}
+
+static void
+unpin_arena (struct satch *solver)
+{
+#ifndef NDEBUG
+  assert (solver->arena.pinned);
+  solver->arena.pinned = false;
+#else
+  (void) solver;
+#endif
+}
+
+static struct clause *
+allocate_clause (struct satch *solver, size_t size)
+{
+  const size_t words = words_clause (size);
+  struct arena *const arena = &solver->arena;
+  if ((size_t) (arena->allocated - arena->end) < words)
+    enlarge_arena (solver, words);
+  struct clause *res = (struct clause *) arena->end;
+  arena->end += words;
+  return res;
+}
+
+// Deleted clauses become holes in the arena until the next compaction.
+
+static size_t
+deallocate_clause (struct satch *solver, struct clause *c)
+{
+  (void) solver;
+  return bytes_clause (c->size);
+}
+
+#else
+
+// This default variadic variant just allocates one chunk of memory, unless
+// a deleted clause of the same size is found on its free list.  The next
+// pointer of the free list is stored at the start of a deleted clause.
+
+static struct clause *
+allocate_clause (struct satch *solver, size_t size)
+{
+  struct clause *res;
+  if (size <= max_pooled_clause_size && (res = solver->pool[size]))
+    {
+      memcpy (&solver->pool[size], res, sizeof res);
+      return res;
+    }
+  const size_t bytes = bytes_clause (size);
+  res = malloc (bytes);
+  if (!res)
+    out_of_memory (bytes);
+  INC (allocations);
+  return res;
+}
+
+// Clauses shrunken in place are put on the free list of their new size,
+// which is fine, since their memory is large enough for that size.
+
+static size_t
+deallocate_clause (struct satch *solver, struct clause *c)
+{
+  const size_t size = c->size;
+  const size_t bytes = bytes_clause (size);
+  if (size <= max_pooled_clause_size)
+    {
+      assert (sizeof c <= bytes);
+      memcpy (c, &solver->pool[size], sizeof c);
+      solver->pool[size] = c;
+    }
+  else
+    free (c);
+  return bytes;
+}
+
+static void
+release_pool (struct satch *solver)
+{
+  for (size_t size = 0; size <= max_pooled_clause_size; size++)
+    {
+      struct clause *next;
+      for (struct clause * c = solver->pool[size]; c; c = next)
+	{
+	  memcpy (&next, c, sizeof next);
+	  free (c);
+	}
+      solver->pool[size] = 0;
+    }
+}
+
+#endif
+
+#else
+
+// The non-variadic variant has to allocate two memory blocks.
+
+static struct clause *
+allocate_clause (struct satch *solver, size_t size)
+{
+  (void) solver;
+  const size_t header_bytes = sizeof (struct clause);
+  struct clause *res = malloc (header_bytes);
+  if (!res)
+    out_of_memory (header_bytes);
+  const size_t literals_bytes = size * sizeof (unsigned);
+  res->literals = malloc (literals_bytes);
+  if (!res->literals)
+    out_of_memory (literals_bytes);
+  return res;
+}
+
+static size_t
+deallocate_clause (struct satch *solver, struct clause *c)
+{
+  (void) solver;
+  const size_t header_bytes = sizeof (struct clause);
+  const size_t literals_bytes = c->size * sizeof (unsigned);
+  free (c->literals);
+  free (c);
+  return header_bytes + literals_bytes;
+}
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
+// Adding and deleting clauses.
+
+// We start with the shared clause allocation function 'add_clause'.
+
+static struct clause *
+#ifndef NGLUE
+add_clause (struct satch *solver, bool redundant, unsigned glue)
+#else
+add_clause (struct satch *solver, bool redundant)
+#endif
+{
+#if defined(LOGGING) || defined(NRADIXSORT)
+  const uint64_t added =
+#endif
+    INC (added);
+  const size_t size = SIZE_STACK (solver->clause);
+#ifdef NVIRTUAL
+  assert (size > 1);		// Units and empty clauses are implicit.
+#else
+  assert (size > 2);		// No binary clauses allocated at all!
+#endif
+  struct clause *res = allocate_clause (solver, size);
+#if defined(LOGGING) || defined(NRADIXSORT)
+  res->id = added;
+#endif
+  res->garbage = false;
+  res->protected = false;
+  res->redundant = redundant;
+  res->parity = false;
+#ifndef NUSED
+  res->used = 0;
+#endif
+#ifndef NSUBSUMPTION
+  res->subsumed = false;
+#endif
+#ifdef NWATCHES
+  res->sum = 0;
+  res->count = 0;
+#endif
+#ifndef NGLUE
+  res->glue = glue;
+#endif
+#ifndef NCACHE
+  res->search = 0;
+#endif
+  res->size = size;
+#ifndef NVIVIFICATION
+  res->vivify = 0;
+  res->shrunken = false;
+#endif
+#ifndef NARENA
+  res->moved = false;
+#endif
+  memcpy (res->literals, solver->clause.begin, size * sizeof (unsigned));
+  return res;
+}
+
+static struct clause *
+new_irredundant_clause (struct satch *solver)
 {
 #ifndef NGLUE
   struct clause *res = add_clause (solver, false, 0);
@@ -2344,7 +3716,7 @@ delete_clause (struct satch *solver, struct clause *c)
       else
 	DEC (irredundant);
     }
-  return deallocate_clause (c);
+  return deallocate_clause (solver, c);
 }
 
 /*------------------------------------------------------------------------*/
@@ -2364,9 +3736,14 @@ watch_literal (struct satch *solver, bool redundant,
   watch.header.redundant = redundant;
   watch.header.blocking = blocking;
   LOGCLS (c, "watching %s blocking %s in", LOGLIT (lit), LOGLIT (blocking));
+#ifndef NPACKED
+  watch.header.reference = clause_reference (solver->arena.begin, c);
+  PUSH (*watches, watch);
+#else
   PUSH (*watches, watch);
   watch.clause = c;
   PUSH (*watches, watch);
+#endif
 }
 
 #elif !defined(NWATCHES)
@@ -2385,7 +3762,8 @@ watch_literal (struct satch *solver, unsigned lit, struct clause *c)
 #endif
 
 #if !defined(NREDUCE) || !defined(NELIMINATION) || \
-    !defined(NCHRONO) || !defined(NVIVIFICATION)
+    !defined(NCHRONO) || !defined(NVIVIFICATION) || \
+    !defined(NOTFS) || !defined(NHYPER)
 
 #ifndef NBLOCK
 
@@ -2396,10 +3774,13 @@ unwatch_literal (struct satch *solver, unsigned lit, struct clause *c)
   struct watches *watches = solver->watches + lit;
   const union watch *const end = watches->end;
   union watch *q = watches->begin;
+#ifndef NPACKED
+  const unsigned reference = clause_reference (solver->arena.begin, c);
+#endif
   for (;;)
     {
       assert (q != end);
-#if !defined(NVIRTUAL) || defined(LOGGING)
+#if !defined(NVIRTUAL) || defined(LOGGING) || !defined(NPACKED)
       const union watch watch = *q++;
       const struct header header = watch.header;
 #endif
@@ -2407,8 +3788,12 @@ unwatch_literal (struct satch *solver, unsigned lit, struct clause *c)
       if (header.binary)
 	continue;
 #endif
+#ifndef NPACKED
+      if (header.reference == reference)
+#else
       const struct clause *d = q++->clause;
       if (c == d)
+#endif
 	{
 	  LOGCLS (c, "unwatching %s blocking %s in",
 		  LOGLIT (lit), LOGLIT (header.blocking));
@@ -2416,8 +3801,8 @@ unwatch_literal (struct satch *solver, unsigned lit, struct clause *c)
 	}
     }
   while (q != end)
-    q[-2] = *q, q++;
-  watches->end -= 2;
+    q[-long_clause_watch_size] = *q, q++;
+  watches->end -= long_clause_watch_size;
 }
 
 #elif !defined(NWATCHES)
@@ -2651,6 +4036,80 @@ do { \
   (P) = chunk; \
 } while (0)
 
+// The arrays allocated in 'increase_capacity' are resized with the
+// following macro and released with 'release_chunk'.
+
+#ifndef MAPPED
+
+#define RESIZE_CHUNK RESIZE_ZERO_INITIALIZED
+
+static void
+release_chunk (void *chunk)
+{
+  free (chunk);
+}
+
+#else
+
+// With 'MAPPED' these arrays are anonymous memory mappings reserving
+// address space for 'mapped' variables.  The kernel only backs touched
+// pages by (zero initialized) real memory.  Thus increasing the capacity
+// up to 'mapped' variables neither copies nor initializes data and does
+// not need additional memory while resizing.  Only if the reserved space
+// is exhausted we map larger chunks and copy the used part of the arrays.
+// Queue and heap arrays are still just reallocated.
+
+// The size of the mapping is stored in front of the returned pointer in
+// order to unmap it later.  This header keeps 16 byte alignment.
+
+#define MAPPED_HEADER_BYTES 16
+
+static void *
+map_chunk (size_t bytes)
+{
+  const size_t mapped_bytes = bytes + MAPPED_HEADER_BYTES;
+  void *start = mmap (0, mapped_bytes, PROT_READ | PROT_WRITE,
+		      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (start == MAP_FAILED)
+    out_of_memory (mapped_bytes);
+  *(size_t *) start = mapped_bytes;
+  return (char *) start + MAPPED_HEADER_BYTES;
+}
+
+static void
+release_chunk (void *chunk)
+{
+  if (!chunk)
+    return;
+  char *start = (char *) chunk - MAPPED_HEADER_BYTES;
+  munmap (start, *(size_t *) start);
+}
+
+static void *
+remap_chunk (void *old_chunk, size_t old_bytes, size_t new_bytes)
+{
+  assert (old_bytes <= new_bytes);
+  void *new_chunk = map_chunk (new_bytes);
+  if (old_bytes)
+    memcpy (new_chunk, old_chunk, old_bytes);
+  release_chunk (old_chunk);
+  return new_chunk;
+}
+
+#define RESIZE_CHUNK(FACTOR,P,ADJUST) \
+do { \
+  if (new_mapped == old_mapped) \
+    break; \
+  const size_t size = sizeof *(P); \
+  const size_t old_bytes = \
+    old_capacity ? FACTOR * (size_t) (old_capacity + ADJUST) * size : 0; \
+  const size_t new_bytes = FACTOR * \
+                           (size_t) (new_mapped + ADJUST) * size; \
+  (P) = remap_chunk ((P), old_bytes, new_bytes); \
+} while (0)
+
+#endif
+
 /*------------------------------------------------------------------------*/
 #ifndef NHEAP
 /*------------------------------------------------------------------------*/
@@ -2664,6 +4123,8 @@ do { \
 // initialized lazily on-demand, i.e., by comparing the solver size with the
 // zero initialized 'size'.
 
+#ifndef NQUATERNARY
+
 #if 0
 
 static void
@@ -2671,21 +4132,177 @@ check_heap (struct heap *heap)
 {
 #ifndef NDEBUG
   const unsigned size = SIZE_STACK (*heap);
-  const unsigned *const begin = heap->begin;
+  const struct heap_entry *const begin = heap->begin;
   const unsigned *const pos = heap->pos;
-  const double *const score = heap->score;
+  const SCORE_TYPE *const score = heap->score;
   for (unsigned i = 0; i < size; i++)
     {
-      const unsigned idx = begin[i];
-      const unsigned idx_pos = pos[idx];
-      assert (idx_pos == i);
-      unsigned child_pos = 2 * idx_pos + 1;
-      unsigned parent_pos = (child_pos - 1) / 2;
-      assert (parent_pos == idx_pos);
-      if (child_pos < size)
-	{
-	  unsigned child = begin[child_pos];
-	  assert (score[idx] >= score[child]);
+      const struct heap_entry entry = begin[i];
+      assert (pos[entry.idx] == i);
+      assert (score[entry.idx] == entry.score);
+      if (i)
+	assert (begin[(i - 1) / heap_arity].score >= entry.score);
+    }
+#else
+  (void) heap;			// Prevent unsigned 'heap' warning.
+#endif
+}
+
+#else
+#define check_heap(...) do { } while (0)
+#endif
+
+static void
+bubble_up (struct satch *solver, struct heap *heap, unsigned idx)
+{
+  struct heap_entry *const begin = heap->begin;
+  unsigned *const pos = heap->pos;
+  unsigned idx_pos = pos[idx];
+  const SCORE_TYPE idx_score = heap->score[idx];
+  while (idx_pos)
+    {
+      const unsigned parent_pos = (idx_pos - 1) / heap_arity;
+      const struct heap_entry parent = begin[parent_pos];
+      if (parent.score >= idx_score)
+	break;
+
+      LOG ("swap heap[%u] = %u (%g) with heap[%u] = %u (%g)",
+	   idx_pos, idx, (double) idx_score,
+	   parent_pos, parent.idx, (double) parent.score);
+
+      begin[idx_pos] = parent;
+      pos[parent.idx] = idx_pos;
+      idx_pos = parent_pos;
+    }
+  begin[idx_pos].score = idx_score;
+  begin[idx_pos].idx = idx;
+  pos[idx] = idx_pos;
+  LOG ("settled to heap[%u] = %u (%g)", idx_pos, idx, (double) idx_score);
+  check_heap (heap);
+}
+
+// All (up to 'heap_arity') children of a node are consecutive in memory
+// and together with their scores usually fit into one cache line.
+
+static void
+bubble_down (struct satch *solver, struct heap *heap, unsigned idx)
+{
+  struct heap_entry *const begin = heap->begin;
+  unsigned *const pos = heap->pos;
+
+  const unsigned size = SIZE_STACK (*heap);
+
+  const SCORE_TYPE idx_score = heap->score[idx];
+  unsigned idx_pos = pos[idx];
+
+  for (;;)
+    {
+      const unsigned first_pos = heap_arity * idx_pos + 1;
+      if (first_pos >= size)
+	break;
+
+      const unsigned end_pos =
+	size - first_pos > heap_arity ? first_pos + heap_arity : size;
+
+      unsigned child_pos = first_pos;
+      SCORE_TYPE child_score = begin[first_pos].score;
+
+      for (unsigned sibling_pos = first_pos + 1;
+	   sibling_pos != end_pos; sibling_pos++)
+	{
+	  const SCORE_TYPE sibling_score = begin[sibling_pos].score;
+	  if (sibling_score > child_score)
+	    {
+	      child_pos = sibling_pos;
+	      child_score = sibling_score;
+	    }
+	}
+
+      if (child_score <= idx_score)
+	break;
+
+      const struct heap_entry child = begin[child_pos];
+
+      assert (idx_pos < child_pos);
+      LOG ("swap heap[%u] = %u (%g) with heap[%u] = %u (%g)",
+	   idx_pos, idx, (double) idx_score,
+	   child_pos, child.idx, (double) child.score);
+
+      begin[idx_pos] = child;
+      pos[child.idx] = idx_pos;
+      idx_pos = child_pos;
+    }
+  begin[idx_pos].score = idx_score;
+  begin[idx_pos].idx = idx;
+  pos[idx] = idx_pos;
+  LOG ("settled to heap[%u] = %u (%g)", idx_pos, idx, (double) idx_score);
+  check_heap (heap);
+}
+
+static void
+push_heap (struct satch *solver, struct heap *heap, unsigned idx)
+{
+  const unsigned size = SIZE_STACK (*heap);
+  assert (size < solver->size);
+  unsigned *pos = heap->pos;
+  assert (pos[idx] == INVALID);
+  pos[idx] = size;
+  struct heap_entry entry;
+  entry.score = heap->score[idx];
+  entry.idx = idx;
+  *heap->end++ = entry;
+  LOG ("push heap[%u] = %u (%g)", size, idx, (double) entry.score);
+  bubble_up (solver, heap, idx);
+}
+
+static unsigned
+max_heap (struct heap *heap)
+{
+  return ACCESS (*heap, 0).idx;
+}
+
+static unsigned
+pop_heap (struct satch *solver, struct heap *heap)
+{
+  check_heap (heap);
+  const unsigned res = max_heap (heap);
+  LOG ("pop heap[0] = %u (%g)", res, (double) heap->score[res]);
+  unsigned *pos = heap->pos;
+  assert (!pos[res]);
+  pos[res] = INVALID;
+  const struct heap_entry last = POP (*heap);
+  if (last.idx == res)
+    return res;
+  pos[last.idx] = 0;
+  heap->begin[0] = last;
+  bubble_down (solver, heap, last.idx);
+  return res;
+}
+
+#else
+
+#if 0
+
+static void
+check_heap (struct heap *heap)
+{
+#ifndef NDEBUG
+  const unsigned size = SIZE_STACK (*heap);
+  const unsigned *const begin = heap->begin;
+  const unsigned *const pos = heap->pos;
+  const SCORE_TYPE *const score = heap->score;
+  for (unsigned i = 0; i < size; i++)
+    {
+      const unsigned idx = begin[i];
+      const unsigned idx_pos = pos[idx];
+      assert (idx_pos == i);
+      unsigned child_pos = 2 * idx_pos + 1;
+      unsigned parent_pos = (child_pos - 1) / 2;
+      assert (parent_pos == idx_pos);
+      if (child_pos < size)
+	{
+	  unsigned child = begin[child_pos];
+	  assert (score[idx] >= score[child]);
 	  if (++child_pos < size)
 	    {
 	      parent_pos = (child_pos - 1) / 2;
@@ -2710,7 +4327,7 @@ bubble_up (struct satch *solver, struct heap *heap, unsigned idx)
   unsigned *stack = heap->begin;
   unsigned *pos = heap->pos;
   unsigned idx_pos = pos[idx];
-  const double *const score = heap->score;
+  const SCORE_TYPE *const score = heap->score;
   const double idx_score = score[idx];
   while (idx_pos)
     {
@@ -2736,7 +4353,7 @@ bubble_up (struct satch *solver, struct heap *heap, unsigned idx)
 static void
 bubble_down (struct satch *solver, struct heap *heap, unsigned idx)
 {
-  const double *score = heap->score;
+  const SCORE_TYPE *score = heap->score;
   unsigned *begin = heap->begin;
   unsigned *pos = heap->pos;
 
@@ -2821,6 +4438,8 @@ pop_heap (struct satch *solver, struct heap *heap)
   return res;
 }
 
+#endif
+
 #ifndef NVSIDS
 
 static void
@@ -2828,7 +4447,7 @@ update_heap (struct satch *solver, struct heap *heap,
 	     unsigned idx, double new_score)
 {
   check_heap (heap);
-  double *score = heap->score;
+  SCORE_TYPE *score = heap->score;
   const double old_score = score[idx];
   if (old_score < new_score)
     {
@@ -2854,7 +4473,7 @@ rescore_scores (struct satch *solver, struct heap *scores)
 {
   const uint64_t rescored = INC (rescored);
   const unsigned size = solver->size;
-  double *score = scores->score;
+  SCORE_TYPE *score = scores->score;
   assert (size);
   double max_score = score[0];
   for (unsigned idx = 1; idx < size; idx++)
@@ -2868,6 +4487,11 @@ rescore_scores (struct satch *solver, struct heap *scores)
 	   "rescoring heap with maximum score %g", max_score);
   for (unsigned idx = 0; idx < size; idx++)
     score[idx] /= max_score;
+#ifndef NQUATERNARY
+  struct heap_entry *const end = scores->end;
+  for (struct heap_entry * p = scores->begin; p != end; p++)
+    p->score = score[p->idx];
+#endif
   scores->increment /= max_score;
   message (solver, 3, "rescore", rescored,
 	   "new score increment %g", scores->increment);
@@ -2932,7 +4556,7 @@ activate_scores (struct satch *solver, struct heap *scores,
   LOG ("activating %zu variables on scores[%u]", SIZE_STACK (*activate),
        stable);
   unsigned *pos = scores->pos;
-  double *score = scores->score;
+  SCORE_TYPE *score = scores->score;
   for (all_elements_on_stack (unsigned, idx, *activate))
     {
       const uint64_t activated = INC (activated[stable]);
@@ -2960,7 +4584,7 @@ fill_scores (struct satch *solver, struct heap *scores)
   if (scores->size == solver->size)
     return;
   unsigned *pos = scores->pos;
-  double *score = scores->score;
+  SCORE_TYPE *score = scores->score;
   const size_t delta = solver->size - scores->size;
   memset (pos + scores->size, 0xff, delta * sizeof *pos);
   while (scores->size < solver->size)
@@ -2981,7 +4605,9 @@ get_scores (struct satch *solver)
   struct heap *scores = &solver->scores[stable];
 #ifndef NLAZYACTIVATION
   struct unsigned_stack *activate = &solver->put[stable];
-  if (!EMPTY_STACK (*activate))
+  // Variables only occurring in tautological clauses added after solving
+  // increase the size without being activated, thus also check the size.
+  if (!EMPTY_STACK (*activate) || scores->size < solver->size)
     activate_scores (solver, scores, activate);
 #else
   if (scores->size < solver->size)
@@ -3135,8 +4761,10 @@ max_score_dlis (struct satch *solver)
 							  blocking_lit),
 				   counts, values);
 	    }
+#ifdef NPACKED
 	  else
               ++p;
+#endif
 	}
 #endif
     }
@@ -3150,6 +4778,14 @@ max_score_dlis (struct satch *solver)
   for (all_variables (idx)) {
     if (solver->values[LITERAL (idx)])
       continue;
+    // Variables which have never been activated (as they do not occur in
+    // any clause) are not counted as unassigned and thus are not decided.
+#ifndef NELIMINATION
+    if (!flags[idx].active && !flags[idx].eliminated)
+#else
+    if (!flags[idx].active)
+#endif
+      continue;
     if (var == INVALID) {
       var = idx;
       if (solver->flags[idx].active)
@@ -3269,6 +4905,9 @@ watch_binary (struct satch *solver,
   watch.header.binary = true;
   watch.header.redundant = redundant;
   watch.header.blocking = blocking;
+#ifndef NPACKED
+  watch.header.reference = 0;
+#endif
   PUSH (solver->watches[lit], watch);
   LOGBIN (redundant, lit, blocking,
 	  "watching %s blocking %s in", LOGLIT (lit), LOGLIT (blocking));
@@ -3503,8 +5142,8 @@ assignement_level (struct satch *solver, unsigned lit, struct clause *reason)
     {
       const unsigned other = tagged_clause_to_literal (reason);
       assert (solver->values[other]);
-      LOG ("found assignment level %d", solver->levels[INDEX (other)]);
-      return solver->levels[INDEX (other)];
+      LOG ("found assignment level %d", LEVEL (INDEX (other)));
+      return LEVEL (INDEX (other));
     }
   else
 #endif
@@ -3515,7 +5154,7 @@ assignement_level (struct satch *solver, unsigned lit, struct clause *reason)
       if (other == lit)
 	continue;
       assert (solver->values[other]);
-      const unsigned tmp = solver->levels[INDEX (other)];
+      const unsigned tmp = LEVEL (INDEX (other));
       if (tmp > level)
 	level = tmp;
     }
@@ -3591,7 +5230,8 @@ assign (struct satch *solver, unsigned lit, struct clause *reason,
 #ifndef NBLOCK
 	  if (!is_tagged_clause (reason))
 #endif
-	    mark_garbage (solver, reason, "root-level forcing");
+	    if (!reason->parity)
+	      mark_garbage (solver, reason, "root-level forcing");
 	  reason = 0;
 	}
     }
@@ -3615,8 +5255,8 @@ assign (struct satch *solver, unsigned lit, struct clause *reason,
 #endif
     solver->saved[idx] = INT_SIGN (lit);
 #endif
-  solver->reasons[idx] = reason;	// Remember reason clause.
-  solver->levels[idx] = level;	// Remember decision level.
+  REASON (idx) = reason;	// Remember reason clause.
+  LEVEL (idx) = level;	// Remember decision level.
 
 #ifndef NCONTROL
   solver->position[idx] = SIZE_STACK (solver->trail);
@@ -3660,37 +5300,40 @@ assign (struct satch *solver, unsigned lit, struct clause *reason,
 // filled in the order in which the variables occur in the formula.
 
 static void
-activate_literals (struct satch *solver)
+activate_literal (struct satch *solver, unsigned lit)
 {
-  struct flags *flags = solver->flags;
-  for (all_elements_on_stack (unsigned, lit, solver->clause))
-    {
-      const unsigned idx = INDEX (lit);
-      struct flags *f = flags + idx;
-      if (f->active)
-	continue;
-      f->active = true;
+  const unsigned idx = INDEX (lit);
+  struct flags *f = solver->flags + idx;
+  if (f->active)
+    return;
+  f->active = true;
 #ifndef NSUBSUMPTION
-      f->subsume = 1;
-      INC (marked_subsume);
+  f->subsume = 1;
+  INC (marked_subsume);
 #endif
 #ifndef NELIMINATION
-      f->eliminate = true;
-      INC (marked_eliminate);
+  f->eliminate = true;
+  INC (marked_eliminate);
 #endif
-      LOG ("activated %s", LOGVAR (idx));
+  LOG ("activated %s", LOGVAR (idx));
 #ifndef NLAZYACTIVATION
 #ifndef NFOCUSED
-      PUSH (solver->put[0], idx);
+  PUSH (solver->put[0], idx);
 #endif
 #ifndef NSTABLE
-      PUSH (solver->put[1], idx);
+  PUSH (solver->put[1], idx);
 #endif
 #endif
-      solver->statistics.remaining++;
-      solver->statistics.variables++;
-      solver->unassigned++;
-    }
+  solver->statistics.remaining++;
+  solver->statistics.variables++;
+  solver->unassigned++;
+}
+
+static void
+activate_literals (struct satch *solver)
+{
+  for (all_elements_on_stack (unsigned, lit, solver->clause))
+      activate_literal (solver, lit);
 }
 
 /*------------------------------------------------------------------------*/
@@ -3895,7 +5538,8 @@ get_queue (struct satch *solver)
   struct queue *queue = &solver->queue[stable];
 #ifndef NLAZYACTIVATION
   struct unsigned_stack *activate = &solver->put[stable];
-  if (!EMPTY_STACK (*activate))
+  // Size increases without activation as in 'get_scores'.
+  if (!EMPTY_STACK (*activate) || queue->size < solver->size)
     activate_queue (solver, queue, activate);
 #else
   if (queue->size < solver->size)
@@ -3939,10 +5583,8 @@ release_queue (struct queue *queue)
 
 // This whole section of the code can be simplified substantially if we
 // could assume a fixed number of variables, which unfortunately is not
-// possible for incremental SAT solving.  We went through the effort to work
-// out this resizing logic even though the solver is not incremental yet, as
-// currently the API does not allow yet to add further clauses after the
-// first call to 'satch_solve' (checked by 'REQUIRE_NON_INCREMENTAL').
+// possible for incremental SAT solving, where further clauses (and thus
+// new variables) can be added after calling 'satch_solve'.
 
 // There are no global data structures. Thus multiple solvers can exist at
 // the same time in the same process and clauses can be added incrementally
@@ -3965,9 +5607,13 @@ resize_trail (struct trail *trail, size_t new_capacity)
   const size_t size = SIZE_STACK (*trail);
   const size_t bytes = new_capacity * sizeof (unsigned);
   const unsigned propagate = trail->propagate - trail->begin;
+#ifndef MAPPED
   trail->begin = realloc (trail->begin, bytes);
   if (!trail->begin)
     out_of_memory (bytes);
+#else
+  trail->begin = remap_chunk (trail->begin, size * sizeof (unsigned), bytes);
+#endif
   trail->end = trail->begin + size;
   trail->propagate = trail->begin + propagate;
 }
@@ -3987,26 +5633,62 @@ increase_capacity (struct satch *solver, unsigned new_capacity)
   LOG ("increasing capacity from %u to %u", old_capacity, new_capacity);
   assert (old_capacity < new_capacity);
   assert (new_capacity <= 1u << 31);
-  RESIZE_ZERO_INITIALIZED (2, solver->watches, 0);
-  RESIZE_ZERO_INITIALIZED (1, solver->reasons, 0);
-  RESIZE_ZERO_INITIALIZED (1, solver->levels, 0);
-  RESIZE_ZERO_INITIALIZED (2, solver->values, 0);
+#ifdef MAPPED
+  // Reserve address space for at least 'mapped_variables' and otherwise
+  // grow the reservation geometrically by a large factor.
+  const size_t old_mapped = solver->mapped;
+  size_t new_mapped = old_mapped;
+  if (new_capacity > old_mapped)
+    {
+      new_mapped = old_mapped ? mapped_growth * old_mapped : mapped_variables;
+      if (new_mapped < new_capacity)
+	new_mapped = new_capacity;
+      if (new_mapped > 1u << 31)
+	new_mapped = 1u << 31;
+      LOG ("reserving address space for %zu variables", new_mapped);
+    }
+#endif
+  RESIZE_CHUNK (2, solver->watches, 0);
+#ifdef RECORDS
+  RESIZE_CHUNK (1, solver->records, 0);
+#else
+  RESIZE_CHUNK (1, solver->reasons, 0);
+  RESIZE_CHUNK (1, solver->levels, 0);
+#endif
+#ifdef AVX2
+  // Gathering values reads four bytes per literal and thus the values of
+  // the last literal are followed by padding bytes.
+  RESIZE_CHUNK (2, solver->values, 2);
+#else
+  RESIZE_CHUNK (2, solver->values, 0);
+#endif
 #ifndef NSAVE
-  RESIZE_ZERO_INITIALIZED (1, solver->saved, 0);
+  RESIZE_CHUNK (1, solver->saved, 0);
 #endif
 #ifndef NTARGET
-  RESIZE_ZERO_INITIALIZED (1, solver->targets, 0);
+  RESIZE_CHUNK (1, solver->targets, 0);
 #endif
 #ifndef NBEST
-  RESIZE_ZERO_INITIALIZED (1, solver->bests, 0);
+  RESIZE_CHUNK (1, solver->bests, 0);
+#endif
+  RESIZE_CHUNK (1, solver->marks, 0);
+  RESIZE_CHUNK (1, solver->flags, 0);
+  RESIZE_CHUNK (1, solver->frames, 1);
+  if (solver->xor_watches)
+    RESIZE_CHUNK (1, solver->xor_watches, 0);
+#ifdef COLD
+  if (solver->cold_watches)
+    RESIZE_CHUNK (2, solver->cold_watches, 0);
 #endif
-  RESIZE_ZERO_INITIALIZED (1, solver->marks, 0);
-  RESIZE_ZERO_INITIALIZED (1, solver->flags, 0);
-  RESIZE_ZERO_INITIALIZED (1, solver->frames, 1);
 #ifndef NCONTROL
   RESIZE_UNINITIALIZED (solver->position);
 #endif
+#ifndef MAPPED
   resize_trail (&solver->trail, new_capacity);
+#else
+  if (new_mapped != old_mapped)
+    resize_trail (&solver->trail, new_mapped);
+#endif
 
 #ifndef NQUEUE
 #ifndef NQUEUE0
@@ -4038,7 +5720,10 @@ increase_capacity (struct satch *solver, unsigned new_capacity)
 #endif
 #endif
 #ifndef NVIVIFICATION
-  RESIZE_ZERO_INITIALIZED (1, solver->vivify_marks, 0);
+  RESIZE_CHUNK (1, solver->vivify_marks, 0);
+#endif
+#ifdef MAPPED
+  solver->mapped = new_mapped;
 #endif
   solver->capacity = new_capacity;
 }
@@ -4225,6 +5910,33 @@ cache_lines (const void *begin, const void *end)
 
 /*------------------------------------------------------------------------*/
 
+// Propagation on large instances is dominated by memory latency, since
+// dereferencing the clause of a watch usually misses the cache.  With
+// '--prefetch' ('PREFETCH' defined) propagation issues prefetches for the
+// clause of the watch 'prefetch_distance' watches ahead of the current
+// one while processing it, and for the watches of the next literal on
+// the trail.  Locating the watch ahead is only possible if every watch
+// has the same size, i.e., with packed watches ('NPACKED' undefined) or
+// without blocking literals ('NBLOCK' defined).  Otherwise only watches
+// of the next literal on the trail are prefetched.
+
+#ifdef PREFETCH
+
+#if defined(__GNUC__) || defined(__clang__)
+#define PREFETCH_MEMORY(PTR) __builtin_prefetch ((PTR))
+#else
+#define PREFETCH_MEMORY(PTR) do { (void) (PTR); } while (0)
+#endif
+
+#if !defined(NPACKED) || defined(NBLOCK)
+#define PREFETCH_WINDOW
+#define prefetch_distance 4
+#endif
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
 #ifndef NWATCHES
 
 // ------------------------ //
@@ -4235,8 +5947,91 @@ cache_lines (const void *begin, const void *end)
 // more precisely for which its negation is watched, is the hot-spot of
 // CDCL solving.  This is further pronounced by learning many long clauses.
 
-static struct clause *
-propagate_literal (struct satch *solver, unsigned lit,
+#ifdef SIMD
+
+// Search for the first non-false literal in the given range of literals
+// and return a pointer to it or the end of the range if all are false.
+
+static inline const unsigned *
+search_replacement (const signed char *values,
+		    const unsigned *begin, const unsigned *end)
+{
+  const unsigned *p = begin;
+  while (p != end && values[*p] < 0)
+    p++;
+  return p;
+}
+
+#ifdef AVX2
+
+// The same search but gathering the values of eight literals at once.
+// Each gathered 32-bit word holds the value of the literal in its least
+// significant byte and thus shifting that byte to the most significant
+// one turns the sign bits of the words into the sign bits of the values.
+// The literals are used as signed 32-bit indices, which is fine unless
+// the number of variables exceeds '2^30' (checked by the caller).  Since
+// with the cached search position the replacement is often the first
+// literal searched, the first two literals are still checked one by one.
+
+__attribute__ ((target ("avx2")))
+static const unsigned *
+search_replacement_avx2 (const signed char *values,
+			 const unsigned *begin, const unsigned *end)
+{
+  const unsigned *p = begin;
+  for (const unsigned *e = end - p > 2 ? p + 2 : end; p != e; p++)
+    if (values[*p] >= 0)
+      return p;
+  while (end - p >= 8)
+    {
+      const __m256i literals = _mm256_loadu_si256 ((const __m256i *) p);
+      const __m256i words =
+	_mm256_i32gather_epi32 ((const int *) values, literals, 1);
+      const __m256i signs = _mm256_slli_epi32 (words, 24);
+      const unsigned nonfalse =
+	~(unsigned) _mm256_movemask_ps (_mm256_castsi256_ps (signs)) & 0xff;
+      if (nonfalse)
+	return p + __builtin_ctz (nonfalse);
+      p += 8;
+    }
+  return search_replacement (values, p, end);
+}
+
+#endif
+
+#endif
+
+#ifdef PREFETCH_WINDOW
+
+// Binary clause watches and those with a true blocking literal do not
+// need their clause and thus are not prefetched.
+
+#ifndef NBLOCK
+#define PREFETCH_WATCH(W) \
+do { \
+  const struct header PREFETCH_HEADER = (W).header; \
+  if (!PREFETCH_HEADER.binary && values[PREFETCH_HEADER.blocking] <= 0) \
+    PREFETCH_MEMORY (dereference_clause (arena, PREFETCH_HEADER.reference)); \
+} while (0)
+#else
+#define PREFETCH_WATCH(W) PREFETCH_MEMORY ((W).clause)
+#endif
+
+#endif
+
+// The propagation code below is instantiated as specialized kernels by
+// calling it with a constant 'ignore' argument and forcing it to be
+// inlined.  The search kernel ignores no clause and thus does not need the
+// corresponding check, which only the vivification kernel performs.
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ALWAYS_INLINE __attribute__ ((always_inline))
+#else
+#define ALWAYS_INLINE
+#endif
+
+static inline ALWAYS_INLINE struct clause *
+propagate_watches (struct satch *solver, unsigned lit,
 		   struct clause *ignore, uint64_t * ticking)
 {
   LOG ("propagating %s", LOGLIT (lit));
@@ -4279,10 +6074,62 @@ propagate_literal (struct satch *solver, unsigned lit,
   // Furthermore it is pretty difficult to keep the same behaviour with and
   // without blocking literals (avoiding different watch replacement).
 
+  // With packed watches ('NPACKED' undefined) a long clause watch needs
+  // half the memory and accordingly traversing watches costs less ticks.
+  // This matches the actual memory traffic and since the other ticks based
+  // limits are relative to search ticks the scheduling stays balanced.
+
   uint64_t ticks = 1 + cache_lines (q, end_watches);
 
+  // The remaining counters are only used for statistics and are kept in
+  // local variables to update the global statistics counters once.
+
+  uint64_t visited = 0, searched = 0;
+#ifndef NBLOCK
+  uint64_t blocked = 0;
+#endif
+#ifndef NCACHE
+  uint64_t cached = 0;
+#endif
+
+#ifndef NPACKED
+  uint64_t *const arena = solver->arena.begin;
+#endif
+
+#ifdef SIMD
+#ifdef AVX2
+  const bool avx2 = solver->avx2 && solver->capacity <= (1u << 30);
+#define SEARCH_REPLACEMENT(BEGIN,END) \
+  (avx2 ? search_replacement_avx2 (values, (BEGIN), (END)) : \
+          search_replacement (values, (BEGIN), (END)))
+#else
+#define SEARCH_REPLACEMENT(BEGIN,END) \
+  search_replacement (values, (BEGIN), (END))
+#endif
+#endif
+
+#ifdef PREFETCH_WINDOW
+
+  // Prefetching of the first watches fills the window.  Afterwards the
+  // clause of the watch which is 'prefetch_distance' watches ahead of the
+  // current watch is prefetched right before processing the current one.
+
+  const bool window = end_watches - p > prefetch_distance;
+  const union watch *const end_window =
+    window ? p + prefetch_distance : end_watches;
+  const union watch *const end_prefetch =
+    window ? end_watches - prefetch_distance : p;
+  for (const union watch *r = p; r != end_window; r++)
+    PREFETCH_WATCH (*r);
+#endif
+
   while (!conflict && p != end_watches)
     {
+      visited++;
+#ifdef PREFETCH_WINDOW
+      if (p < end_prefetch)
+	PREFETCH_WATCH (p[prefetch_distance]);
+#endif
 #ifndef NBLOCK
       const union watch watch = *q++ = *p++;	// Keep header by default.
       const struct header header = watch.header;
@@ -4309,7 +6156,7 @@ propagate_literal (struct satch *solver, unsigned lit,
 		      tag_binary_clause (header.redundant, not_lit), false);
 	      ticks++;
 	    }
-#ifdef NVIRTUAL
+#if defined(NVIRTUAL) && defined(NPACKED)
 	  *q++ = *p++;		// Copy clause too.
 #endif
 	  continue;
@@ -4320,16 +6167,23 @@ propagate_literal (struct satch *solver, unsigned lit,
 	// enabled or both cases (binary and non-binary clauses) if they are.
 
 	{
+#ifndef NPACKED
+	  struct clause *clause =
+	    dereference_clause (arena, header.reference);
+#else
 	  struct clause *clause = (*q++ = *p++).clause;	// Copy clause.
+#endif
 	  if (clause->garbage)
 	    LOGCLS (clause, "clause should not be garbage");
 	  assert (!clause->garbage);
-	  if (clause == ignore) {
+	  if (ignore && clause == ignore)
 	    continue;
-    }
 #ifndef NBLOCK
 	  if (blocking_value > 0)
-	    continue;
+	    {
+	      blocked++;
+	      continue;
+	    }
 #endif
 	  unsigned *const literals = clause->literals;
 
@@ -4363,7 +6217,7 @@ propagate_literal (struct satch *solver, unsigned lit,
 	  if (other_value > 0)
 	    {
 #ifndef NBLOCK
-	      q[-2].header.blocking = other;
+	      q[-long_clause_watch_size].header.blocking = other;
 #endif
 	      continue;
 	    }
@@ -4383,6 +6237,7 @@ propagate_literal (struct satch *solver, unsigned lit,
 	  signed char replacement_value = -1;
 	  const unsigned *end_search = end_literals;
 	  unsigned *start_search = literals + 2, *r;
+	  searched++;
 #ifndef NCACHE
 
 	  // Use and remember the old offset were we found a replacement
@@ -4392,6 +6247,14 @@ propagate_literal (struct satch *solver, unsigned lit,
 
 	  start_search += clause->search;
 #endif
+#ifdef SIMD
+	  r = (unsigned *) SEARCH_REPLACEMENT (start_search, end_search);
+	  if (r != end_search)
+	    {
+	      replacement = *r;
+	      replacement_value = values[replacement];
+	    }
+#else
 	  for (r = start_search; r != end_search; r++)
 	    {
 	      replacement = *r;
@@ -4399,12 +6262,22 @@ propagate_literal (struct satch *solver, unsigned lit,
 	      if (replacement_value >= 0)
 		break;
 	    }
+#endif
 #ifndef NCACHE
 	  if (replacement_value < 0)
 	    {
 	      end_search = start_search;
 	      start_search = literals + 2;
 
+#ifdef SIMD
+	      r = (unsigned *) SEARCH_REPLACEMENT (start_search, end_search);
+	      if (r != end_search)
+		{
+		  replacement = *r;
+		  replacement_value = values[replacement];
+		  clause->search = r - start_search;
+		}
+#else
 	      for (r = start_search; r != end_search; r++)
 		{
 		  replacement = *r;
@@ -4415,16 +6288,20 @@ propagate_literal (struct satch *solver, unsigned lit,
 		      break;
 		    }
 		}
+#endif
 	    }
 	  else
-	    clause->search = r - start_search;
+	    {
+	      clause->search = r - start_search;
+	      cached++;
+	    }
 #endif
 	  if (replacement_value > 0)	// Replacement literal true.
 	    {
 #ifndef NBLOCK
 	      // Update blocking literal only.
 
-	      q[-2].header.blocking = replacement;
+	      q[-long_clause_watch_size].header.blocking = replacement;
 #endif
 	    }
 	  else if (!replacement_value)	// Replacement literal unassigned.
@@ -4433,9 +6310,10 @@ propagate_literal (struct satch *solver, unsigned lit,
 	      // originally watched literal by simply decreasing 'q'.
 
 	      // Depending on whether blocking literals are disabled the
-	      // actual decrement is either '2' (if 'NBLOCK' is defined) or
-	      // '1' (if 'NBLOCK' is undefined). This difference is hidden
-	      // in the definition of 'long_clause_watch_size'.
+	      // actual decrement is either '2' (if 'NBLOCK' is undefined) or
+	      // '1' (if 'NBLOCK' is defined or the clause reference is
+	      // packed into the header). This difference is hidden in the
+	      // definition of 'long_clause_watch_size'.
 
 	      LOGCLS (clause, "unwatching %s in", LOGLIT (not_lit));
 	      q -= long_clause_watch_size;
@@ -4475,6 +6353,16 @@ propagate_literal (struct satch *solver, unsigned lit,
 
   *ticking += ticks;
 
+  struct statistics *statistics = &solver->statistics;
+  statistics->visited += visited;
+  statistics->searched += searched;
+#ifndef NBLOCK
+  statistics->blocked += blocked;
+#endif
+#ifndef NCACHE
+  statistics->cached += cached;
+#endif
+
   // After a conflicting clause is found we break out of the propagation but
   // still need to copy the rest of the watches and reset the stack size.
 
@@ -4485,18 +6373,99 @@ propagate_literal (struct satch *solver, unsigned lit,
   return conflict;
 }
 
-#else // of '#ifndef NWATCHES'
+// Propagation of all watches during search, probing and cubing.
 
-// ------------------------- //
-// Propagation with counters //
-// ------------------------- //
+static struct clause *
+propagate_literal (struct satch *solver, unsigned lit, uint64_t * ticking)
+{
+  return propagate_watches (solver, lit, NULL, ticking);
+}
 
-// Updating the non-false literal counters of literals in clauses is the
-// hot-spot for CDCL with counters (instead of watches).  This effort occurs
-// during propagation in this function and then also during backtracking.
+#ifndef NVIVIFICATION
 
-struct clause *
-propagate_literal (struct satch *solver, unsigned lit, struct clause *ignore, uint64_t * ticking)
+static struct clause *
+vivify_propagate_literal (struct satch *solver, unsigned lit,
+			  struct clause *ignore, uint64_t * ticking)
+{
+  return propagate_watches (solver, lit, ignore, ticking);
+}
+
+#endif
+
+#ifdef BINARYFIRST
+
+// With '--binary-first' ('BINARYFIRST' defined) binary clause watches of
+// all literals on the trail are propagated during search before the large
+// clause watches of the first not completely propagated literal (see
+// 'boolean_constraint_propagation').  This finds conflicts and implied
+// literals of binary clauses earlier without dereferencing large clauses.
+// Binary clause watches are kept in front of large clause watches by
+// 'flush_garbage_watches' and this pass stops at the first large clause
+// watch.  Binary clauses watched later are only propagated together with
+// large clauses by 'propagate_literal'.  Since that second pass reads all
+// watches of the literal again, this was measured to be slower than a
+// single pass and thus is not the default.
+
+// This pass only reads watches and does not change watch stacks.  It only
+// counts ticks for assignments since reading the watches is accounted for
+// in 'propagate_literal' anyhow.
+
+static struct clause *
+propagate_binary_watches (struct satch *solver, unsigned lit,
+			  uint64_t * ticking)
+{
+  LOG ("propagating binary clauses of %s", LOGLIT (lit));
+
+  const unsigned not_lit = NOT (lit);
+  const struct watches *const watches = solver->watches + not_lit;
+  signed char *const values = solver->values;
+  const union watch *const end = watches->end;
+
+  struct clause *conflict = 0;
+  uint64_t ticks = 0;
+
+  for (const union watch * p = watches->begin; p != end; p++)
+    {
+      const struct header header = p->header;
+      if (!header.binary)
+	break;
+      const unsigned other = header.blocking;
+      const signed char value = values[other];
+      if (value < 0)
+	{
+	  conflict = binary_clause (solver, 0, header.redundant,
+				    not_lit, other);
+	  LOGCLS (conflict, "conflicting");
+	  break;
+	}
+      if (!value)
+	{
+	  assign (solver, other,
+		  tag_binary_clause (header.redundant, not_lit), false);
+	  ticks++;
+	}
+    }
+
+  *ticking += ticks;
+
+  return conflict;
+}
+
+#endif
+
+#else // of '#ifndef NWATCHES'
+
+// ------------------------- //
+// Propagation with counters //
+// ------------------------- //
+
+// Updating the non-false literal counters of literals in clauses is the
+// hot-spot for CDCL with counters (instead of watches).  This effort occurs
+// during propagation in this function and then also during backtracking.
+
+static struct clause *
+propagate_counters (struct satch *solver, unsigned lit,
+		    struct clause *ignore, uint64_t * ticking)
 {
   LOG ("propagating %s", LOGLIT (lit));
 
@@ -4546,10 +6515,28 @@ propagate_literal (struct satch *solver, unsigned lit, struct clause *ignore, ui
     }
 
   *ticking += ticks;
+  ADD (visited, SIZE_STACK (*watches));
 
   return conflict;
 }
 
+static struct clause *
+propagate_literal (struct satch *solver, unsigned lit, uint64_t * ticking)
+{
+  return propagate_counters (solver, lit, NULL, ticking);
+}
+
+#ifndef NVIVIFICATION
+
+static struct clause *
+vivify_propagate_literal (struct satch *solver, unsigned lit,
+			  struct clause *ignore, uint64_t * ticking)
+{
+  return propagate_counters (solver, lit, ignore, ticking);
+}
+
+#endif
+
 // Without watches and just counters we have to update the counters of
 // propagated literals during backtracking, which we call 'unpropagating'.
 
@@ -4601,7 +6588,7 @@ flush_units (struct satch *solver)
   assert (trail->propagate >= trail->begin);
   assert (trail->propagate <= trail->end);
   unsigned *new_start = trail->begin;
-  while (new_start < trail->end && !solver->levels[INDEX (*new_start)])
+  while (new_start < trail->end && !LEVEL (INDEX (*new_start)))
     {
       ++new_start;
     }
@@ -4636,7502 +6623,12753 @@ flush_units (struct satch *solver)
 
 /*------------------------------------------------------------------------*/
 
-// While 'propagate_literal' propagates the assignment of one literal, the
-// process of 'boolean constraint propagation' (BCP) implemented in the next
-// function propagates all not yet propagated literals pushed on the trail.
+// Native XOR constraints (see 'struct xor' above).
 
-// Note that propagation of a literal might produce new assigned literals
-// (beside finding conflicting clauses) and thus the following loop can be
-// seen as breadth-first search over the unit implied literals of the
-// current assignment.
+// Allocate the reason clause of an XOR constraint outside of the arena.
 
 static struct clause *
-boolean_constraint_propagation (struct satch *solver)
+new_xor_reason (unsigned size)
 {
-  LOG ("BCP");
-  struct trail *trail = &solver->trail;
-  unsigned *propagate = trail->propagate;
-  unsigned *p;
+#ifndef NVARIADIC
+  const size_t bytes = bytes_clause (size);
+  struct clause *res = calloc (1, bytes);
+  if (!res)
+    out_of_memory (bytes);
+#else
+  struct clause *res = calloc (1, sizeof *res);
+  if (!res)
+    out_of_memory (sizeof *res);
+  const size_t bytes = size * sizeof (unsigned);
+  if (!(res->literals = malloc (bytes)))
+    out_of_memory (bytes);
+#endif
+  res->parity = true;
+  res->size = size;
+  return res;
+}
 
-  assert (trail->begin <= propagate);
-  assert (propagate <= trail->begin + VARIABLES);
+static void
+delete_xor (struct satch *solver, struct xor *x)
+{
+  struct clause *const reason = x->reason;
+#ifndef NDEBUG
+  if (x->checked)
+    {
+      for (all_literals_in_clause (lit, reason))
+	  checker_add_literal (solver->checker, export_literal (lit));
+      checker_delete_clause (solver->checker);
+    }
+#else
+  (void) solver;
+#endif
+#ifdef NVARIADIC
+  free (reason->literals);
+#endif
+  free (reason);
+  free (x);
+}
+
+// Fill the reason clause of an XOR constraint with the literals of its
+// variables which are falsified by the current assignment, where the first
+// literal is replaced by the 'implied' literal unless it is 'INVALID' (for
+// conflicts).  The internal proof checker does not know XOR constraints and
+// thus we add the filled reason clause as original clause to it.
+
+static struct clause *
+xor_reason (struct satch *solver, struct xor *x, unsigned implied)
+{
+  struct clause *const reason = x->reason;
+  unsigned *const literals = reason->literals;
+  const unsigned size = x->size;
+#ifndef NDEBUG
+  if (x->checked)
+    {
+      for (all_elements_in_array (unsigned, lit, size, literals))
+	  checker_add_literal (solver->checker, export_literal (lit));
+      checker_delete_clause (solver->checker);
+    }
+#endif
+  const signed char *const values = solver->values;
+  for (unsigned i = 0; i < size; i++)
+    {
+      const unsigned lit = LITERAL (x->variables[i]);
+      literals[i] = values[lit] > 0 ? NOT (lit) : lit;
+    }
+  if (implied != INVALID)
+    literals[0] = implied;
+#ifndef NDEBUG
+  for (all_elements_in_array (unsigned, lit, size, literals))
+      checker_add_literal (solver->checker, export_literal (lit));
+  checker_add_original_clause (solver->checker);
+  x->checked = true;
+#endif
+  return reason;
+}
+
+// Propagate the assignment of the variable of 'lit' over the XOR
+// constraints watching it.  The propagated variable is moved to the second
+// position and then we try to find an unassigned replacement among the
+// other variables while computing the parity the first watched variable
+// has to satisfy.  If there is no replacement the first variable is either
+// implied or, if it is already assigned, the constraint is either
+// satisfied or falsified.
+
+// With chronological backtracking we further have to make sure that after
+// all variables have been assigned one of the watches is on a variable with
+// maximum assignment level.  Otherwise backtracking might unassign other
+// variables but keep both watched variables assigned and then the
+// constraint would not be checked anymore.
+
+static struct clause *
+propagate_xors (struct satch *solver, unsigned lit, uint64_t * ticking)
+{
+  const unsigned idx = INDEX (lit);
+  struct xors *const watches = solver->xor_watches + idx;
+  const signed char *const values = solver->values;
+
+  struct xor **q = watches->begin;
+  struct xor *const *p = q;
+  struct xor *const *const end = watches->end;
 
+  uint64_t ticks = 1 + cache_lines (p, end);
   struct clause *conflict = 0;
-  uint64_t ticks = 0;
 
-  for (p = propagate; !conflict && p != trail->end; p++)
-    conflict = propagate_literal (solver, *p, NULL, &ticks);
+  while (p != end)
+    {
+      struct xor *const x = *q++ = *p++;
+      if (conflict)
+	continue;
 
-  ADD (ticks, ticks);
-  solver->trail.propagate = p;
-  const unsigned propagated = p - propagate;
+      const unsigned size = x->size;
+      unsigned *const variables = x->variables;
+      ticks += 1 + cache_lines (variables, variables + size);
 
-  ADD (propagations, propagated);
+      if (variables[0] == idx)
+	variables[0] = variables[1], variables[1] = idx;
+      assert (variables[1] == idx);
+
+      bool parity = x->parity;
+      unsigned i;
+
+      for (i = 1; i < size; i++)
+	{
+	  const signed char value = values[LITERAL (variables[i])];
+	  if (!value)
+	    break;
+	  if (value > 0)
+	    parity = !parity;
+	}
+
+      if (i < size)
+	{
+	  const unsigned replacement = variables[i];
+	  variables[i] = idx;
+	  variables[1] = replacement;
+	  PUSH (solver->xor_watches[replacement], x);
+	  q--;
+	  continue;
+	}
+
+      const unsigned other = LITERAL (variables[0]);
+      const signed char value = values[other];
+
+      if (!value)
+	{
+	  const unsigned implied = parity ? other : NOT (other);
+	  struct clause *const reason = xor_reason (solver, x, implied);
+	  assign (solver, implied, reason, false);
+	  INC (xor_propagations);
+	  ticks++;
+	  continue;
+	}
 
-  if (conflict)
-    INC (conflicts);
-  else if (!solver->level
 #ifndef NCHRONO
-	   || solver->iterate
+      unsigned highest = 1;
+      unsigned highest_level = LEVEL (idx);
+      for (i = 0; i < size; i++)
+	{
+	  const unsigned level = LEVEL (variables[i]);
+	  if (level > highest_level)
+	    highest = i, highest_level = level;
+	}
+      if (highest > 1)
+	{
+	  const unsigned replacement = variables[highest];
+	  variables[highest] = idx;
+	  variables[1] = replacement;
+	  PUSH (solver->xor_watches[replacement], x);
+	  q--;
+	}
 #endif
-    )
-    flush_units (solver);
+
+      if ((value > 0) != parity)
+	{
+	  LOG ("conflicting size %u XOR constraint", size);
+	  conflict = xor_reason (solver, x, INVALID);
+	  INC (xor_conflicts);
+	}
+    }
+
+  watches->end = q;
+  *ticking += ticks;
 
   return conflict;
 }
 
+/*------------------------------------------------------------------------*/
+#ifdef COLD
 /*------------------------------------------------------------------------*/
 
-// Update target and best-phases from a consistent trail.  The user has to
-// make sure that the trail is consistent though.  For instance in conflict
-// analysis we first have to backtrack one level.
-
-#ifndef NTARGET
+// Cold clauses (see 'struct cold_clause' above).
 
-static void
-save_phases (struct satch *solver, signed char *phases)
+static inline struct cold_clause *
+dereference_cold_clause (struct satch *solver, unsigned reference)
 {
-  const signed char *end = solver->values + LITERALS;
-  signed char *q = phases, tmp;
-  for (const signed char *p = solver->values; p != end; p += 2, q++)
-    if ((tmp = *p))
-      *q = tmp;
-  assert (q == phases + VARIABLES);
+  return (struct cold_clause *) (solver->cold.begin + reference);
 }
 
-static void
-update_target_phases (struct satch *solver, const unsigned assigned)
+static size_t
+cold_clause_words (unsigned size, unsigned width)
 {
-  const uint64_t targets = INC (targets);
-  save_phases (solver, solver->targets);
-  solver->target = assigned;
-  message (solver, 3, "target", targets, "targeting %u assigned variables "
-	   "%.0f%% after %" PRIu64 " conflicts", assigned,
-	   percent (assigned, VARIABLES), CONFLICTS);
+  const size_t bytes = sizeof (struct cold_clause) + (size - 2) * width;
+  return (bytes + sizeof (unsigned) - 1) / sizeof (unsigned);
 }
 
-#ifndef NBEST
-
-static void
-update_best_phases (struct satch *solver, const unsigned assigned)
+static inline unsigned
+get_cold_literal (const struct cold_clause *c, unsigned i)
 {
-  const uint64_t bests = INC (bests);
-  save_phases (solver, solver->bests);
-  solver->best = assigned;
-  message (solver, 3, "best", bests, "best trail %u assigned variables "
-	   "%.0f%% after %" PRIu64 " conflicts", assigned,
-	   percent (assigned, VARIABLES), CONFLICTS);
+  const unsigned width = c->width + 1;
+  const unsigned char *const bytes = c->compressed + i * (size_t) width;
+  unsigned offset = 0;
+  for (unsigned j = width; j--;)
+    offset = (offset << 8) | bytes[j];
+  return c->base + offset;
 }
 
-#endif
+static inline void
+set_cold_literal (struct cold_clause *c, unsigned i, unsigned lit)
+{
+  const unsigned width = c->width + 1;
+  unsigned char *const bytes = c->compressed + i * (size_t) width;
+  assert (c->base <= lit);
+  unsigned offset = lit - c->base;
+  for (unsigned j = 0; j < width; j++)
+    bytes[j] = offset & 255, offset >>= 8;
+  assert (!offset);
+}
 
-// Make sure to care for root-level assigned variables when computing the
-// number of assigned variables.  Those are flushed from the trail after
-// unit propagation on the root-level completes. The trail size itself is
-// not correct and makes target and stable phases actually behave badly.
+// Copy all literals of a cold clause to the temporary clause.
 
-static inline unsigned
-assigned_variables (struct satch *solver)
+static void
+decompress_cold_clause (struct satch *solver, const struct cold_clause *c)
 {
-  assert (VARIABLES >= solver->unassigned);
-  return VARIABLES - solver->unassigned;
+  assert (EMPTY_STACK (solver->clause));
+  PUSH (solver->clause, c->watched[0]);
+  PUSH (solver->clause, c->watched[1]);
+  const unsigned compressed = c->size - 2;
+  for (unsigned i = 0; i < compressed; i++)
+    PUSH (solver->clause, get_cold_literal (c, i));
 }
 
 static void
-update_phases (struct satch *solver)
+cold_watch_literal (struct satch *solver, unsigned lit,
+		    unsigned blocking, unsigned reference)
 {
-  assert (solver->stable);
-  const unsigned assigned = assigned_variables (solver);
-  if (assigned > solver->target)
-    update_target_phases (solver, assigned);
-#ifndef NBEST
-  if (assigned > solver->best)
-    update_best_phases (solver, assigned);
-#endif
+  struct cold_watch watch;
+  watch.blocking = blocking;
+  watch.reference = reference;
+  PUSH (solver->cold_watches[lit], watch);
 }
 
-#endif
-
-/*------------------------------------------------------------------------*/
+static void
+cold_watch_clause (struct satch *solver, unsigned reference)
+{
+  const struct cold_clause *const c =
+    dereference_cold_clause (solver, reference);
+  const unsigned lit = c->watched[0];
+  const unsigned other = c->watched[1];
+  cold_watch_literal (solver, lit, other, reference);
+  cold_watch_literal (solver, other, lit, reference);
+}
 
-// Backtracking to a certain decision level in essence just unassigns the
-// literals assigned on higher decisn level. Then it reset the decision
-// level and the propagation pointer.
+// Deleting a cold clause needs to add a deletion line to the proof and
+// delete it from the checker, while cooling and promoting a clause does
+// not change the set of clauses (in the proof and the checker).
 
-// This procedure is slightly more complicated though since we first need to
-// put back unassigned variables back to the binary heap for (E)VSIDS and
-// second update the search index for the VMTF queue. Third without clause
-// learning ('NLEARN' defined) learned clauses are only used for computing
-// scores and back-jumping and during backtracking have to be deleted.
+static void
+delete_cold_clause (struct satch *solver, struct cold_clause *c)
+{
+  assert (!c->garbage);
+  decompress_cold_clause (solver, c);
+  LOGTMP ("deleting cold");
+  trace_and_check_deletion (solver, SIZE_STACK (solver->clause),
+			    solver->clause.begin);
+  CLEAR_STACK (solver->clause);
+  c->garbage = true;
+  DEC (cold);
+}
 
-// Unfortunately this leads to rather complex code due to conditional
-// compilation and allowing all combinations of features, including various
-// ways to use EVSIDS scores and VMTF queue in stable and focused mode,
-// disabling learning and blocking literals.
+// Move the reduced but not yet deleted redundant clause to the cold tier.
 
 static void
-backtrack (struct satch *solver, unsigned new_level)
+cool_clause (struct satch *solver, struct clause *c)
 {
-  LOG ("backtracking to level %u", new_level);
-  assert (new_level < solver->level);
-#if !defined(NDEBUG) || !defined(NCHRONO) || defined(NCONTROL)
-  const unsigned *levels = solver->levels;
-#endif
-  signed char *values = solver->values;
-
-#ifndef NQUEUE
-  struct queue *queue = 0;
-  const struct link *links = 0;
-  unsigned search = INVALID;
-  unsigned max_stamp = INVALID;
-#ifndef NHEAP
-  if (!solver->stable)
-#endif
+  assert (c->redundant);
+  assert (!c->garbage);
+  assert (!c->protected);
+  assert (c->size > 2);
+  const unsigned size = c->size;
+  unsigned *const literals = c->literals;
+  unsigned base = UINT_MAX, max = 0;
+  for (all_elements_in_array (unsigned, lit, size, literals))
     {
-      queue = get_queue (solver);
-      links = queue->links;
-      search = queue->search;
-      max_stamp = search == INVALID ? 0 : links[search].stamp;
+      if (lit < base)
+	base = lit;
+      if (lit > max)
+	max = lit;
     }
-#endif
-
-#ifndef NHEAP
-  struct heap *scores = 0;
-  const unsigned *pos = 0;
-#ifndef NQUEUE
-  if (solver->stable)
-#endif
+  const unsigned range = max - base;
+  unsigned width = 1;
+  while (width < 4 && (range >> (8 * width)))
+    width++;
+  const size_t words = cold_clause_words (size, width);
+  const size_t reference = SIZE_STACK (solver->cold);
+  if (reference + words > UINT_MAX)
     {
-      scores = get_scores (solver);
-      pos = scores->pos;
+      mark_garbage (solver, c, "cold tier full");
+      return;
     }
+  if (!solver->cold_watches)
+    {
+#ifndef MAPPED
+      const size_t watches_bytes =
+	2 * solver->capacity * sizeof *solver->cold_watches;
+      if (!(solver->cold_watches = calloc (1, watches_bytes)))
+	out_of_memory (watches_bytes);
+#else
+      const size_t watches_bytes =
+	2 * solver->mapped * sizeof *solver->cold_watches;
+      solver->cold_watches = map_chunk (watches_bytes);
 #endif
-
-#ifdef NLEARN
-  struct clause *const *const reasons = solver->reasons;
+    }
+  RESERVE_STACK (solver->cold, words);
+  solver->cold.end += words;
+  struct cold_clause *const cold =
+    dereference_cold_clause (solver, reference);
+  cold->size = size;
+  cold->width = width - 1;
+  cold->garbage = false;
+  cold->age = 0;
+#ifndef NGLUE
+  cold->glue = c->glue < max_cold_glue ? c->glue : max_cold_glue;
+#else
+  cold->glue = 0;
 #endif
+  cold->base = base;
+  cold->watched[0] = literals[0];
+  cold->watched[1] = literals[1];
+  for (unsigned i = 2; i < size; i++)
+    set_cold_literal (cold, i - 2, literals[i]);
+  cold_watch_clause (solver, reference);
+  LOGCLS (c, "cooling %u byte literals of", width);
+  c->garbage = true;		// Deallocated without deleting it.
+  DEC (redundant);
+  INC (cold);
+  INC (cooled);
+}
 
-#ifdef NWATCHES
-  const unsigned * const propagated = solver->trail.propagate;
-#endif
-  struct trail *trail = &solver->trail;
-#ifndef NCONTROL
-  unsigned *target_lit = ACCESS (solver->control, new_level).trail;
-  assert (target_lit >= solver->trail.begin);
-  assert (target_lit < solver->trail.end);
-  assert (target_lit <= trail->propagate);
-  unsigned *starting = target_lit;
+// A cold clause which became a reason or is conflicting is promoted to a
+// regular watched redundant clause.  Its stale cold watch is dropped when
+// it is visited the next time or during the next reduction.
 
+static struct clause *
+promote_cold_clause (struct satch *solver, struct cold_clause *c)
+{
+  decompress_cold_clause (solver, c);
+#ifndef NGLUE
+  struct clause *res = new_redundant_clause (solver, c->glue);
+#else
+  struct clause *res = new_redundant_clause (solver);
 #endif
-#if !defined(NCHRONO) && !defined(NLOGGING)
-  unsigned *position = solver->position;
-  int starting_position = target_lit - solver->trail.begin;
-  LOG ("backtracking to position %d corresponding", starting_position);
+  CLEAR_STACK (solver->clause);
+#ifndef NUSED
+  res->used = 1;
 #endif
+  LOGCLS (res, "promoted cold");
+  watch_clause (solver, res);
+  c->garbage = true;
+  DEC (cold);
+  INC (promoted);
+  return res;
+}
 
-#ifndef NCHRONO
-  trail->propagate = target_lit;
-  int reassigned = 0;
-#endif
+// Propagate the assignment of 'lit' over the cold clauses watching its
+// negation.  This follows 'propagate_literal' except that the literals are
+// decoded on-the-fly while searching for a replacement.
 
-#ifndef NCONTROL
-  while (target_lit != solver->trail.end)
-    {
-      const unsigned lit = *target_lit;
-#ifdef NWATCHES
-      const unsigned *p = target_lit;
-#endif
-      ++target_lit;
-      const unsigned idx = INDEX (lit);
-      assert (starting <= target_lit);
-#if !defined(NCHRONO) || !defined(NDEBUG)
-      const unsigned lit_level = levels[idx];
-#endif
-#else
-  const unsigned * const begin = trail->begin;
-  unsigned *p = trail->end;
-  while (p != begin)
+static struct clause *
+propagate_cold (struct satch *solver, unsigned lit, uint64_t * ticking)
+{
+  const unsigned not_lit = NOT (lit);
+  struct cold_watches *const watches = solver->cold_watches + not_lit;
+  const signed char *const values = solver->values;
+
+  struct cold_watch *q = watches->begin;
+  const struct cold_watch *p = q;
+  const struct cold_watch *const end = watches->end;
+
+  uint64_t ticks = 1 + cache_lines (p, end);
+  struct clause *conflict = 0;
+
+  while (p != end)
     {
-      unsigned * next = p - 1;
-      const unsigned lit = *next;
-      const unsigned idx = INDEX (lit);
-      const unsigned lit_level = levels[idx];
-      if (lit_level == new_level)
-	break;
-      p = next;
-#endif
-      LOG ("unassign %s", LOGLIT (lit));
-      assert (solver->unassigned < solver->size);
-#ifndef NCHRONO
-      assert (trail->end > starting);
-      assert (starting_position == starting - trail->begin);
-      if (lit_level <= new_level)
+      const struct cold_watch watch = *q++ = *p++;
+      if (conflict)
+	continue;
+      if (values[watch.blocking] > 0)
+	continue;
+
+      struct cold_clause *const c =
+	dereference_cold_clause (solver, watch.reference);
+      ticks++;
+
+      if (c->garbage)
 	{
-	  LOG ("keeping literal %s", LOGLIT (lit));
-	  *starting = lit;
-	  position[idx] = starting_position;
-	  ++reassigned;
-	  ++starting;
-	  ++starting_position;
-#ifdef NWATCHES
-	  if (p < propagated)
-	    unpropagate_literal (solver, lit);
-#endif
+	  q--;
 	  continue;
 	}
-      LOG ("popping literal %s", LOGLIT (lit));
-#else
-      assert (lit_level > new_level);
-#endif
-      solver->unassigned++;
-      const unsigned not_lit = NOT (lit);
 
-#if !defined(NELIMINATION) && !defined(NLEARN)
-      assert (values[lit] > 0);
-      assert (values[not_lit] < 0);
-#else
-      // Both Might be flipped in 'extend_solution'.
-      //
-      assert (values[lit]);
-      assert (values[not_lit]);
-#endif
-      assert (values[lit] == -values[not_lit]);
+      unsigned *const watched = c->watched;
+      const unsigned other = watched[0] ^ watched[1] ^ not_lit;
+      const signed char other_value = values[other];
+      if (other_value > 0)
+	{
+	  q[-1].blocking = other;
+	  continue;
+	}
 
-      values[lit] = 0;
-      values[not_lit] = 0;
+      watched[0] = other;
+      watched[1] = not_lit;
 
-#ifdef NLEARN
-      struct clause *reason = reasons[idx];
-      if (reason &&
-#ifdef NCDCL
-          reason != DUMMY_REASON &&
-#endif
-#ifndef NBLOCK
-	  !is_tagged_clause (reason) &&
-#endif
-	  reason->redundant)
-	(void) delete_clause (solver, reason);
-#endif
-#ifndef NQUEUE
-      if (links)
+      const unsigned compressed = c->size - 2;
+      unsigned replacement = INVALID, i;
+      signed char replacement_value = -1;
+      for (i = 0; i < compressed; i++)
 	{
-	  const unsigned stamp = links[idx].stamp;
-	  if (stamp > max_stamp)
-	    search = idx, max_stamp = stamp;
+	  replacement = get_cold_literal (c, i);
+	  replacement_value = values[replacement];
+	  if (replacement_value >= 0)
+	    break;
 	}
-#endif
-#ifndef NHEAP
-      if (pos && pos[idx] == INVALID)
-	push_heap (solver, scores, idx);
-#endif
-#ifdef NWATCHES
-      if (p < propagated)
-	unpropagate_literal (solver, lit);
-      else {
-	LOG ("%ld and pos vs propagated %ld", p - propagated, p - trail->propagate);
-      }
-#endif
-    }
 
-#ifndef NCONTROL
-  solver->trail.end = starting;
-#ifdef NCHRONO
-  trail->propagate = trail->end;
-#endif
-#else
-  LOG ("p = %s", LOGLIT (*p));
-  trail->end = trail->propagate = p;
-#endif
-#ifndef NQUEUE
-  if (queue)
-    {
-      LOG ("searched variable index %u", search);
-      queue->search = search;
+      if (replacement_value > 0)
+	q[-1].blocking = replacement;
+      else if (!replacement_value)
+	{
+	  q--;
+	  set_cold_literal (c, i, not_lit);
+	  watched[1] = replacement;
+	  cold_watch_literal (solver, replacement, other, watch.reference);
+	  ticks++;
+	}
+      else
+	{
+	  q--;
+	  struct clause *const promoted = promote_cold_clause (solver, c);
+	  if (other_value)
+	    {
+	      LOGCLS (promoted, "conflicting");
+	      conflict = promoted;
+	    }
+	  else
+	    assign (solver, other, promoted, false);
+	  ticks++;
+	}
     }
-#endif
 
-#ifndef NCONTROL
-  solver->control.end = solver->control.begin + new_level;
-  assert (new_level == SIZE_STACK (solver->control));
-#endif
-
-#ifdef DLIS
-  LOG ("backtracking DLIS stack to level %d", new_level);
-  solver->irred_sat_upto.end = solver->irred_sat_upto.begin + new_level;
-  solver->red_sat_upto.end = solver->red_sat_upto.begin + new_level;
-  assert (new_level == SIZE_STACK (solver->irred_sat_upto));
-#endif
+  watches->end = q;
+  *ticking += ticks;
 
-#ifndef NCHRONO
-  assert (trail->propagate <= trail->end);
-#endif
-  solver->level = new_level;
+  return conflict;
 }
 
-#if !defined(NREDUCE) || !defined(NELIMINATION) || !defined(NVIVIFICATION)
+// At the root-level satisfied cold clauses are deleted and otherwise two
+// unassigned literals are moved to the watched positions.  If there are
+// less than two the clause is deleted too (it is unit or falsified which
+// can only happen if root-level units were propagated without cold
+// clauses during probing or vivification).
+
+static bool
+watch_cold_clause_on_root_level (struct satch *solver,
+				 struct cold_clause *c)
+{
+  const signed char *const values = solver->values;
+  unsigned *const watched = c->watched;
+  unsigned found = 0;
+  for (unsigned i = 0; i < 2; i++)
+    {
+      const unsigned lit = watched[i];
+      const signed char value = values[lit];
+      if (value > 0)
+	return false;
+      if (value)
+	continue;
+      watched[i] = watched[found];
+      watched[found++] = lit;
+    }
+  const unsigned compressed = c->size - 2;
+  for (unsigned i = 0; i < compressed; i++)
+    {
+      const unsigned lit = get_cold_literal (c, i);
+      const signed char value = values[lit];
+      if (value > 0)
+	return false;
+      if (value || found == 2)
+	continue;
+      set_cold_literal (c, i, watched[found]);
+      watched[found++] = lit;
+    }
+  return found == 2;
+}
 
 static void
-update_phases_and_backtrack_to_root_level (struct satch *solver)
+reduce_cold_clauses (struct satch *solver, bool new_fixed)
 {
-  if (!solver->level)
+  if (!solver->cold_watches)
     return;
-#ifndef  NTARGET
-  if (solver->stable)
-    update_phases (solver);
-#endif
-  backtrack (solver, 0);
+  for (all_literals (lit))
+    CLEAR_STACK (solver->cold_watches[lit]);
+  unsigned *const begin = solver->cold.begin;
+  const unsigned *const end = solver->cold.end;
+  unsigned *q = begin;
+  size_t kept = 0, deleted = 0;
+  for (const unsigned *p = begin; p != end;)
+    {
+      struct cold_clause *const c = (struct cold_clause *) p;
+      const size_t words = cold_clause_words (c->size, c->width + 1);
+      p += words;
+      if (c->garbage)
+	continue;
+      if (++c->age > cold_reductions ||
+	  (new_fixed && !watch_cold_clause_on_root_level (solver, c)))
+	{
+	  delete_cold_clause (solver, c);
+	  deleted++;
+	  continue;
+	}
+      const unsigned reference = q - begin;
+      memmove (q, c, words * sizeof *q);
+      q += words;
+      cold_watch_clause (solver, reference);
+      kept++;
+    }
+  solver->cold.end = q;
+  SHRINK_STACK (solver->cold);
+  message (solver, 3, "reduce", solver->statistics.reductions,
+	   "kept %zu cold clauses and deleted %zu (%zu bytes)", kept,
+	   deleted, SIZE_STACK (solver->cold) * sizeof (unsigned));
+}
 
-#ifndef NCHRONO
-  const struct clause *conflict = boolean_constraint_propagation (solver);
-  if (conflict)
-    solver->inconsistent = true;
-#endif
+// Elimination and substitution remove variables which thus can not occur
+// in clauses anymore (also not in redundant cold clauses).  Instead of
+// updating cold clauses we just delete all of them.
+
+static void
+discard_cold_clauses (struct satch *solver)
+{
+  if (EMPTY_STACK (solver->cold))
+    return;
+  unsigned *const begin = solver->cold.begin;
+  const unsigned *const end = solver->cold.end;
+  for (const unsigned *p = begin; p != end;)
+    {
+      struct cold_clause *const c = (struct cold_clause *) p;
+      p += cold_clause_words (c->size, c->width + 1);
+      if (!c->garbage)
+	delete_cold_clause (solver, c);
+    }
+  assert (!solver->statistics.cold);
+  CLEAR_STACK (solver->cold);
+  for (all_literals (lit))
+    RELEASE_STACK (solver->cold_watches[lit]);
 }
 
+/*------------------------------------------------------------------------*/
 #endif
-
 /*------------------------------------------------------------------------*/
 
-// We have fast and slow-moving exponential averages, all updated during
-// conflict clause analysis.  The slow moving averages are biased towards
-// their initial value (zero) and we use a method described in the
-// literature (the well known ADAM machine learning paper) to correct the
-// bias by multiplying with '1/(1-beta^n)' where 'beta = 1 - alpha' and
-// 'beta' is the smoothing factor (decay) and 'n' is the number of updates
-// to the exponential moving average.  The alphas are defined above as
-// macros since some compilers will otherwise not allow the following line.
-
-const double slow_beta = 1.0 - slow_alpha;
-
-// We have two sets of independent averages for stable and focused mode.
-// During mode switching the 'stable' bit is flipped which makes the other
-// set of averages active.  However if stable mode is disabled we only have
-// one set of averages and only update and use that.  To hide this logic we
-// use the following function which returns the active set of averages.
+// Propagate the assignment of 'lit' over clauses and XOR constraints.
 
-static struct averages *
-averages (struct satch *solver)
+static inline struct clause *
+propagate_assignment (struct satch *solver, unsigned lit, uint64_t * ticking)
 {
-  return solver->averages + solver->stable;
+  struct clause *conflict = propagate_literal (solver, lit, ticking);
+  if (!conflict && solver->xor_watches)
+    conflict = propagate_xors (solver, lit, ticking);
+  return conflict;
 }
 
-static void
-update_slow_average (double *average, unsigned value)
-{
-  *average += slow_alpha * (value - *average);
-}
+#ifndef NVIVIFICATION
 
-static double
-unbiased_slow_average (struct averages *a, double avg)
+static inline struct clause *
+vivify_propagate_assignment (struct satch *solver, unsigned lit,
+			     struct clause *ignore, uint64_t * ticking)
 {
-  const double div = 1 - a->slow_exp;
-  return !div ? 0 : div == 1 ? avg : avg / div;
+  struct clause *conflict =
+    vivify_propagate_literal (solver, lit, ignore, ticking);
+  if (!conflict && solver->xor_watches)
+    conflict = propagate_xors (solver, lit, ticking);
+  return conflict;
 }
 
-#ifndef NRESTART
+#endif
 
-// Only 'restarting' needs a fast moving average ('fast_glue').
+/*------------------------------------------------------------------------*/
 
-const double fast_beta = 1.0 - fast_alpha;
+// While 'propagate_literal' propagates the assignment of one literal, the
+// process of 'boolean constraint propagation' (BCP) implemented in the next
+// function propagates all not yet propagated literals pushed on the trail.
 
-static void
-update_fast_average (double *average, unsigned value)
-{
-  *average += fast_alpha * (value - *average);
-}
+// Note that propagation of a literal might produce new assigned literals
+// (beside finding conflicting clauses) and thus the following loop can be
+// seen as breadth-first search over the unit implied literals of the
+// current assignment.
 
-static double
-unbiased_fast_average (struct averages *a, double avg)
+static struct clause *
+boolean_constraint_propagation (struct satch *solver)
 {
-  const double div = 1 - a->fast_exp;
-  return !div ? 0 : div == 1 ? avg : avg / div;
-}
+  LOG ("BCP");
+  struct trail *trail = &solver->trail;
+  unsigned *propagate = trail->propagate;
+  unsigned *p;
 
-#endif
+  assert (trail->begin <= propagate);
+  assert (propagate <= trail->begin + VARIABLES);
 
-// We assume that all fast and slow moving averages are updated at the same
-// time and then just update 'beta^n' for both too (even though there is a
-// fast one and a slow one).
+  struct clause *conflict = 0;
+  uint64_t ticks = 0;
 
-static void
-update_betas (struct satch *solver)
-{
-  struct averages *a = averages (solver);
-#ifndef NRESTART
-  if (a->fast_exp)
-    a->fast_exp *= fast_beta;
+#ifdef BINARYFIRST
+  unsigned *binary = propagate;
 #endif
-  if (a->slow_exp)
-    a->slow_exp *= slow_beta;
-}
 
-static void
-init_one_set_of_averages (struct averages *a)
-{
-  a->slow_exp = 1.0;
-#ifndef NRESTART
-  a->fast_exp = 1.0;
+  for (p = propagate; !conflict && p != trail->end; p++)
+    {
+#ifdef BINARYFIRST
+      while (!conflict && binary != trail->end)
+	conflict = propagate_binary_watches (solver, *binary++, &ticks);
+      if (conflict)
+	break;
 #endif
-}
+#ifdef PREFETCH
+      if (p + 1 != trail->end)
+	PREFETCH_MEMORY (solver->watches[NOT (p[1])].begin);
+#endif
+      conflict = propagate_assignment (solver, *p, &ticks);
+#ifdef COLD
+      // Promoting cold clauses while vivifying would overwrite the learned
+      // clause on 'solver->clause' and might move the arena under the
+      // vivification schedule.  Like probing we thus skip cold clauses and
+      // the next reduction watches them again on the root level.
+      if (!conflict && solver->cold_watches && !solver->dense
+#ifndef NVIVIFICATION
+	  && !solver->vivifying
+#endif
+	)
+	conflict = propagate_cold (solver, *p, &ticks);
+#endif
+    }
 
-static void
-init_averages (struct satch *solver)
-{
-  for (int i = 0; i < 2; i++)
-    init_one_set_of_averages (&solver->averages[i]);
+  ADD (ticks, ticks);
+  ADD (mode_ticks[solver->stable], ticks);
+  solver->trail.propagate = p;
+  const unsigned propagated = p - propagate;
+
+  ADD (propagations, propagated);
+
+  if (conflict)
+    INC (conflicts);
+  else if (!solver->level
+#ifndef NCHRONO
+	   || solver->iterate
+#endif
+    )
+    flush_units (solver);
+
+  return conflict;
 }
 
 /*------------------------------------------------------------------------*/
 
-#ifndef NSORTDEDUCED
-
-// Shrinking requires that the temporary learned clause is partitioned into
-// its decision levels.  Each such partition is called a block and we
-// require the blocks to be in descending level order.  It is in general
-// beneficial to sort literals in descending level order in learned clauses
-// too and thus we sort the deduced clause even if shrinking is disabled.
+// Update target and best-phases from a consistent trail.  The user has to
+// make sure that the trail is consistent though.  For instance in conflict
+// analysis we first have to backtrack one level.
 
-#ifndef NRADIXSORT
+#ifndef NTARGET
 
-#define RANK_LITERAL_BY_INVERSE_LEVEL(LIT)	(~levels[INDEX (LIT)])
+static void
+save_phases (struct satch *solver, signed char *phases)
+{
+  const signed char *end = solver->values + LITERALS;
+  signed char *q = phases, tmp;
+  for (const signed char *p = solver->values; p != end; p += 2, q++)
+    if ((tmp = *p))
+      *q = tmp;
+  assert (q == phases + VARIABLES);
+}
 
 static void
-sort_deduced_clause (struct satch *solver)
+update_target_phases (struct satch *solver, const unsigned assigned)
 {
-  const unsigned *const levels = solver->levels;
-  RSORT (unsigned, unsigned, solver->clause, RANK_LITERAL_BY_INVERSE_LEVEL);
+  const uint64_t targets = INC (targets);
+  save_phases (solver, solver->targets);
+  solver->target = assigned;
+  message (solver, 3, "target", targets, "targeting %u assigned variables "
+	   "%.0f%% after %" PRIu64 " conflicts", assigned,
+	   percent (assigned, VARIABLES), CONFLICTS);
 }
 
-#else
+#ifndef NBEST
 
-// Without radix sort we need to get the levels from the sorted array and
-// thus have to allocate a temporary array with literals and their levels.
+static void
+update_best_phases (struct satch *solver, const unsigned assigned)
+{
+  const uint64_t bests = INC (bests);
+  save_phases (solver, solver->bests);
+  solver->best = assigned;
+  message (solver, 3, "best", bests, "best trail %u assigned variables "
+	   "%.0f%% after %" PRIu64 " conflicts", assigned,
+	   percent (assigned, VARIABLES), CONFLICTS);
+}
 
-// Since we want stable sorting (to match the radix-sort version) we also
-// add a position argument and thus keep literals in their original order
-// in the clause within one block (literals with the same level).
+#endif
 
-struct lit_level_pos
-{
-  unsigned lit, level, pos;
-};
+// Make sure to care for root-level assigned variables when computing the
+// number of assigned variables.  Those are flushed from the trail after
+// unit propagation on the root-level completes. The trail size itself is
+// not correct and makes target and stable phases actually behave badly.
 
-static int
-cmp_lit_level_pos (const void *p, const void *q)
+static inline unsigned
+assigned_variables (struct satch *solver)
 {
-  struct lit_level_pos *l = (struct lit_level_pos *) p;
-  struct lit_level_pos *k = (struct lit_level_pos *) q;
-  if (l->level > k->level)
-    return -1;
-  if (l->level < k->level)
-    return 1;
-  assert (l->pos != k->pos);
-  return l->pos < k->pos ? -1 : 1;
+  assert (VARIABLES >= solver->unassigned);
+  return VARIABLES - solver->unassigned;
 }
 
 static void
-sort_deduced_clause (struct satch *solver)
+update_phases (struct satch *solver)
 {
-  struct unsigned_stack *clause = &solver->clause;
-  const unsigned size = SIZE_STACK (*clause);
-  const size_t bytes = size * sizeof (struct lit_level_pos);
-  struct lit_level_pos *a = malloc (bytes);
-  if (!a)
-    out_of_memory (bytes);
-  const unsigned *levels = solver->levels;
-  unsigned pos = 0;
-  for (all_elements_on_stack (unsigned, lit, *clause))
-    {
-      struct lit_level_pos *p = a + pos;
-      p->lit = lit;
-      p->level = levels[INDEX (lit)];
-      p->pos = pos++;
-    }
-  qsort (a, size, sizeof *a, cmp_lit_level_pos);
-  const struct lit_level_pos *const end = a + size;
-  unsigned *c = clause->begin;
-  for (const struct lit_level_pos * p = a; p != end; p++)
-    *c++ = p->lit;
-  free (a);
-}
-
+  assert (solver->stable);
+  const unsigned assigned = assigned_variables (solver);
+  if (assigned > solver->target)
+    update_target_phases (solver, assigned);
+#ifndef NBEST
+  if (assigned > solver->best)
+    update_best_phases (solver, assigned);
 #endif
+}
 
 #endif
 
 /*------------------------------------------------------------------------*/
 
-// The 'ANALYZED' flag is used for 'analyze' but also during minimization.
-
-#define ANALYZED 1		// Literal seen during conflict analysis.
-
-// Conflict clause minimization is implemented here.
-
-#ifndef NMINIMIZE
-
-// The following two flags can be set independently of 'ANALYZED' and thus
-// have different bits.  During shrinking we additionally have 'SHRUNKEN'.
+// Backtracking to a certain decision level in essence just unassigns the
+// literals assigned on higher decisn level. Then it reset the decision
+// level and the propagation pointer.
 
-#define REMOVABLE 2		// Literal can be be minimized.
-#define POISONED 4		// Literal can not be minimized.
+// This procedure is slightly more complicated though since we first need to
+// put back unassigned variables back to the binary heap for (E)VSIDS and
+// second update the search index for the VMTF queue. Third without clause
+// learning ('NLEARN' defined) learned clauses are only used for computing
+// scores and back-jumping and during backtracking have to be deleted.
 
-static void
-mark_removable (struct satch *solver, unsigned idx)
-{
-  assert (!(solver->marks[idx] & REMOVABLE));
-  solver->marks[idx] |= REMOVABLE;
-  PUSH (solver->removable, idx);
-  LOG ("removable %s", LOGVAR (idx));
-}
+// Unfortunately this leads to rather complex code due to conditional
+// compilation and allowing all combinations of features, including various
+// ways to use EVSIDS scores and VMTF queue in stable and focused mode,
+// disabling learning and blocking literals.
 
 static void
-mark_poisoned (struct satch *solver, unsigned idx)
+backtrack (struct satch *solver, unsigned new_level)
 {
-  assert (!(solver->marks[idx] & POISONED));
-  solver->marks[idx] |= POISONED;
-  PUSH (solver->poisoned, idx);
-  LOG ("poisoned %s", LOGVAR (idx));
-}
+  LOG ("backtracking to level %u", new_level);
+  assert (new_level < solver->level);
+#if !defined(NDEBUG) || !defined(NCHRONO) || defined(NCONTROL)
+#endif
+  signed char *values = solver->values;
+
+#ifndef NQUEUE
+  struct queue *queue = 0;
+  const struct link *links = 0;
+  unsigned search = INVALID;
+  unsigned max_stamp = INVALID;
+#ifndef NHEAP
+  if (!solver->stable)
+#endif
+    {
+      queue = get_queue (solver);
+      links = queue->links;
+      search = queue->search;
+      max_stamp = search == INVALID ? 0 : links[search].stamp;
+    }
+#endif
+
+#ifndef NHEAP
+  struct heap *scores = 0;
+  const unsigned *pos = 0;
+#ifndef NQUEUE
+  if (solver->stable)
+#endif
+    {
+      scores = get_scores (solver);
+      pos = scores->pos;
+    }
+#endif
+
+#ifdef NLEARN
+#endif
+
+#ifdef NWATCHES
+  const unsigned * const propagated = solver->trail.propagate;
+#endif
+  struct trail *trail = &solver->trail;
+#ifndef NCONTROL
+  unsigned *target_lit = ACCESS (solver->control, new_level).trail;
+  assert (target_lit >= solver->trail.begin);
+  assert (target_lit < solver->trail.end);
+  assert (target_lit <= trail->propagate);
+  unsigned *starting = target_lit;
+
+#endif
+#if !defined(NCHRONO) && !defined(NLOGGING)
+  unsigned *position = solver->position;
+  int starting_position = target_lit - solver->trail.begin;
+  LOG ("backtracking to position %d corresponding", starting_position);
+#endif
+
+#ifndef NCHRONO
+  trail->propagate = target_lit;
+  int reassigned = 0;
+#endif
+
+#ifndef NCONTROL
+  while (target_lit != solver->trail.end)
+    {
+      const unsigned lit = *target_lit;
+#ifdef NWATCHES
+      const unsigned *p = target_lit;
+#endif
+      ++target_lit;
+      const unsigned idx = INDEX (lit);
+      assert (starting <= target_lit);
+#if !defined(NCHRONO) || !defined(NDEBUG)
+      const unsigned lit_level = LEVEL (idx);
+#endif
+#else
+  const unsigned * const begin = trail->begin;
+  unsigned *p = trail->end;
+  while (p != begin)
+    {
+      unsigned * next = p - 1;
+      const unsigned lit = *next;
+      const unsigned idx = INDEX (lit);
+      const unsigned lit_level = LEVEL (idx);
+      if (lit_level == new_level)
+	break;
+      p = next;
+#endif
+      LOG ("unassign %s", LOGLIT (lit));
+      assert (solver->unassigned < solver->size);
+#ifndef NCHRONO
+      assert (trail->end > starting);
+      assert (starting_position == starting - trail->begin);
+      if (lit_level <= new_level)
+	{
+	  LOG ("keeping literal %s", LOGLIT (lit));
+	  *starting = lit;
+	  position[idx] = starting_position;
+	  ++reassigned;
+	  ++starting;
+	  ++starting_position;
+#ifdef NWATCHES
+	  if (p < propagated)
+	    unpropagate_literal (solver, lit);
+#endif
+	  continue;
+	}
+      LOG ("popping literal %s", LOGLIT (lit));
+#else
+      assert (lit_level > new_level);
+#endif
+      solver->unassigned++;
+      const unsigned not_lit = NOT (lit);
+
+#ifdef NELIMINATION
+      assert (values[lit] > 0);
+      assert (values[not_lit] < 0);
+#else
+      // Both Might be flipped in 'extend_solution'.
+      //
+      assert (values[lit]);
+      assert (values[not_lit]);
+#endif
+      assert (values[lit] == -values[not_lit]);
+
+      values[lit] = 0;
+      values[not_lit] = 0;
+
+#ifdef NLEARN
+      struct clause *reason = REASON (idx);
+      if (reason &&
+#ifdef NCDCL
+          reason != DUMMY_REASON &&
+#endif
+#ifndef NBLOCK
+	  !is_tagged_clause (reason) &&
+#endif
+	  reason->redundant)
+	(void) delete_clause (solver, reason);
+#endif
+#ifndef NQUEUE
+      if (links)
+	{
+	  const unsigned stamp = links[idx].stamp;
+	  if (stamp > max_stamp)
+	    search = idx, max_stamp = stamp;
+	}
+#endif
+#ifndef NHEAP
+      if (pos && pos[idx] == INVALID)
+	push_heap (solver, scores, idx);
+#endif
+#ifdef NWATCHES
+      if (p < propagated)
+	unpropagate_literal (solver, lit);
+      else {
+	LOG ("%ld and pos vs propagated %ld", p - propagated, p - trail->propagate);
+      }
+#endif
+    }
+
+#ifndef NCONTROL
+  solver->trail.end = starting;
+#ifdef NCHRONO
+  trail->propagate = trail->end;
+#endif
+#else
+  LOG ("p = %s", LOGLIT (*p));
+  trail->end = trail->propagate = p;
+#endif
+#ifndef NQUEUE
+  if (queue)
+    {
+      LOG ("searched variable index %u", search);
+      queue->search = search;
+    }
+#endif
+
+#ifndef NCONTROL
+  solver->control.end = solver->control.begin + new_level;
+  assert (new_level == SIZE_STACK (solver->control));
+#endif
+
+#ifdef DLIS
+  LOG ("backtracking DLIS stack to level %d", new_level);
+  solver->irred_sat_upto.end = solver->irred_sat_upto.begin + new_level;
+  solver->red_sat_upto.end = solver->red_sat_upto.begin + new_level;
+  assert (new_level == SIZE_STACK (solver->irred_sat_upto));
+#endif
+
+#ifndef NCHRONO
+  assert (trail->propagate <= trail->end);
+#endif
+  solver->level = new_level;
+
+  // If we backtrack over assumption decisions we have to check all of them
+  // again in 'decide', since some of them might have become unassigned.
+
+  if (new_level < solver->assumption_level)
+    {
+      solver->assumption_level = new_level;
+      solver->assumed = 0;
+    }
+}
+
+#if !defined(NREDUCE) || !defined(NELIMINATION) || \
+    !defined(NVIVIFICATION) || !defined(NPORTFOLIO)
+
+static void
+update_phases_and_backtrack_to_root_level (struct satch *solver)
+{
+  if (!solver->level)
+    return;
+#ifndef  NTARGET
+  if (solver->stable)
+    update_phases (solver);
+#endif
+  backtrack (solver, 0);
+
+#ifndef NCHRONO
+  const struct clause *conflict = boolean_constraint_propagation (solver);
+  if (conflict)
+    solver->inconsistent = true;
+#endif
+}
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
+// We have fast and slow-moving exponential averages, all updated during
+// conflict clause analysis.  The slow moving averages are biased towards
+// their initial value (zero) and we use a method described in the
+// literature (the well known ADAM machine learning paper) to correct the
+// bias by multiplying with '1/(1-beta^n)' where 'beta = 1 - alpha' and
+// 'beta' is the smoothing factor (decay) and 'n' is the number of updates
+// to the exponential moving average.  The alphas are defined above as
+// macros since some compilers will otherwise not allow the following line.
+
+const double slow_beta = 1.0 - slow_alpha;
+
+// We have two sets of independent averages for stable and focused mode.
+// During mode switching the 'stable' bit is flipped which makes the other
+// set of averages active.  However if stable mode is disabled we only have
+// one set of averages and only update and use that.  To hide this logic we
+// use the following function which returns the active set of averages.
+
+static struct averages *
+averages (struct satch *solver)
+{
+  return solver->averages + solver->stable;
+}
+
+static void
+update_slow_average (double *average, unsigned value)
+{
+  *average += slow_alpha * (value - *average);
+}
+
+static double
+unbiased_slow_average (struct averages *a, double avg)
+{
+  const double div = 1 - a->slow_exp;
+  return !div ? 0 : div == 1 ? avg : avg / div;
+}
+
+#ifndef NRESTART
+
+// Only 'restarting' needs a fast moving average ('fast_glue').
+
+const double fast_beta = 1.0 - fast_alpha;
+
+static void
+update_fast_average (double *average, unsigned value)
+{
+  *average += fast_alpha * (value - *average);
+}
+
+static double
+unbiased_fast_average (struct averages *a, double avg)
+{
+  const double div = 1 - a->fast_exp;
+  return !div ? 0 : div == 1 ? avg : avg / div;
+}
+
+#endif
+
+// We assume that all fast and slow moving averages are updated at the same
+// time and then just update 'beta^n' for both too (even though there is a
+// fast one and a slow one).
+
+static void
+update_betas (struct satch *solver)
+{
+  struct averages *a = averages (solver);
+#ifndef NRESTART
+  if (a->fast_exp)
+    a->fast_exp *= fast_beta;
+#endif
+  if (a->slow_exp)
+    a->slow_exp *= slow_beta;
+}
+
+static void
+init_one_set_of_averages (struct averages *a)
+{
+  a->slow_exp = 1.0;
+#ifndef NRESTART
+  a->fast_exp = 1.0;
+#endif
+}
+
+static void
+init_averages (struct satch *solver)
+{
+  for (int i = 0; i < 2; i++)
+    init_one_set_of_averages (&solver->averages[i]);
+}
+
+/*------------------------------------------------------------------------*/
+
+#ifndef NSORTDEDUCED
+
+// Shrinking requires that the temporary learned clause is partitioned into
+// its decision levels.  Each such partition is called a block and we
+// require the blocks to be in descending level order.  It is in general
+// beneficial to sort literals in descending level order in learned clauses
+// too and thus we sort the deduced clause even if shrinking is disabled.
+
+#ifndef NRADIXSORT
+
+#define RANK_LITERAL_BY_INVERSE_LEVEL(LIT)	(~LEVEL (INDEX (LIT)))
+
+static void
+sort_deduced_clause (struct satch *solver)
+{
+  RSORT (unsigned, unsigned, solver->clause,
+	 RANK_LITERAL_BY_INVERSE_LEVEL, solver->scratch);
+}
+
+#else
+
+// Without radix sort we need to get the levels from the sorted array and
+// thus have to allocate a temporary array with literals and their levels.
+
+// Since we want stable sorting (to match the radix-sort version) we also
+// add a position argument and thus keep literals in their original order
+// in the clause within one block (literals with the same level).
+
+struct lit_level_pos
+{
+  unsigned lit, level, pos;
+};
+
+static int
+cmp_lit_level_pos (const void *p, const void *q)
+{
+  struct lit_level_pos *l = (struct lit_level_pos *) p;
+  struct lit_level_pos *k = (struct lit_level_pos *) q;
+  if (l->level > k->level)
+    return -1;
+  if (l->level < k->level)
+    return 1;
+  assert (l->pos != k->pos);
+  return l->pos < k->pos ? -1 : 1;
+}
+
+static void
+sort_deduced_clause (struct satch *solver)
+{
+  struct unsigned_stack *clause = &solver->clause;
+  const unsigned size = SIZE_STACK (*clause);
+  const size_t bytes = size * sizeof (struct lit_level_pos);
+  struct lit_level_pos *a = malloc (bytes);
+  if (!a)
+    out_of_memory (bytes);
+  unsigned pos = 0;
+  for (all_elements_on_stack (unsigned, lit, *clause))
+    {
+      struct lit_level_pos *p = a + pos;
+      p->lit = lit;
+      p->level = LEVEL (INDEX (lit));
+      p->pos = pos++;
+    }
+  qsort (a, size, sizeof *a, cmp_lit_level_pos);
+  const struct lit_level_pos *const end = a + size;
+  unsigned *c = clause->begin;
+  for (const struct lit_level_pos * p = a; p != end; p++)
+    *c++ = p->lit;
+  free (a);
+}
+
+#endif
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
+// The 'ANALYZED' flag is used for 'analyze' but also during minimization.
+
+#define ANALYZED 1		// Literal seen during conflict analysis.
+
+// Conflict clause minimization is implemented here.
+
+#ifndef NMINIMIZE
+
+// The following two flags can be set independently of 'ANALYZED' and thus
+// have different bits.  During shrinking we additionally have 'SHRUNKEN'.
+
+#define REMOVABLE 2		// Literal can be be minimized.
+#define POISONED 4		// Literal can not be minimized.
+
+static void
+mark_removable (struct satch *solver, unsigned idx)
+{
+  assert (!(MARK (idx) & REMOVABLE));
+  MARK (idx) |= REMOVABLE;
+  PUSH (solver->removable, idx);
+  LOG ("removable %s", LOGVAR (idx));
+}
+
+static void
+mark_poisoned (struct satch *solver, unsigned idx)
+{
+  assert (!(MARK (idx) & POISONED));
+  MARK (idx) |= POISONED;
+  PUSH (solver->poisoned, idx);
+  LOG ("poisoned %s", LOGVAR (idx));
+}
 
 // Return either 'REMOVABLE' (literal can be removed) or 'POISONED'.
 
-// This recursive function is guarded against stack-overflow by providing an
-// additional 'depth' parameter, which is increase with each recursive call.
-// If 'depth' hits the 'minimize_depth' limit the procedure conservatively
-// assumes that the literal can not be minimized away.
+// This recursive function is guarded against stack-overflow by providing an
+// additional 'depth' parameter, which is increase with each recursive call.
+// If 'depth' hits the 'minimize_depth' limit the procedure conservatively
+// assumes that the literal can not be minimized away.
+
+// Previously computed results are cached in mark flags. Root-level
+// assigned literals are ignored.  The function aborts negatively if a
+// decision variable is reached which has not been marked as being in the
+// clause before (marked 'REMOVABLE') or the decision level of the literal
+// is not in the learned clause.
+
+static int
+minimize_literal (struct satch *solver, unsigned lit, unsigned depth)
+{
+  const unsigned idx = INDEX (lit);
+  signed char mark = MARK (idx);
+  assert (mark >= 0);
+  if (mark & POISONED)
+    return POISONED;		// Previously shown not to be removable.
+  if (mark & REMOVABLE)
+    return REMOVABLE;		// Previously shown to be removable.
+  if (depth && (mark & ANALYZED))
+    return REMOVABLE;		// Analyzed thus removable (unless start).
+  const unsigned level = LEVEL (idx);
+  if (!level)
+    return REMOVABLE;		// Root-level units can be removed.
+  if (depth > minimize_depth)
+    return POISONED;		// Avoids deep recursion (stack overflow).
+#ifndef NCONTROL
+  if (!depth && ACCESS (solver->control, level - 1).seen.count < 2)
+    return POISONED;
+  if (solver->position[idx] <=
+      ACCESS (solver->control, level - 1).seen.earliest)
+    return POISONED;
+#endif
+  assert (solver->values[lit] < 0);
+  struct clause *reason = REASON (idx);
+  if (!reason)
+    return POISONED;		// Decisions can not be removed.
+  if (!solver->frames[level])
+    return POISONED;		// Level not pulled into clause.
+  int res = REMOVABLE;
+#ifndef NBLOCK
+  if (is_tagged_clause (reason))
+    reason = untag_clause (solver, 0, NOT (lit), reason);
+  else
+#endif
+    INC (ticks);
+  const unsigned not_lit = NOT (lit);
+  LOGCLS (reason, "trying to minimize %s at depth %u along",
+	  LOGLIT (not_lit), depth);
+  for (all_literals_in_clause (other, reason))
+    {
+      if (other == not_lit)
+	continue;
+      if (minimize_literal (solver, other, depth + 1) == REMOVABLE)
+	continue;
+      res = POISONED;
+      break;
+    }
+  if (depth)
+    {
+      if (res == REMOVABLE)
+	mark_removable (solver, idx);
+      else
+	mark_poisoned (solver, idx);
+    }
+  LOG ("%s %s at depth %u",
+       (res == REMOVABLE ? "removable" : "poisoned"), LOGLIT (lit), depth);
+  return res;
+}
+
+#ifdef NSHRINK
+
+// Minimize the deduced first unique implication point (1st UIP) clause.
+
+// By default ('NSHRINK' undefined) we employ all-UIP shrinking though which
+// minimizes (in 'minimize_block') each block of literals in the learned
+// clause with the same decision level in the deduced clause separately
+// after shrinking unless shrinking was able to replace the whole block by a
+// single literal.  Thus with shrinking this function becomes obsolete.
+
+static void
+minimize_deduced_clause (struct satch *solver)
+{
+  assert (EMPTY_STACK (solver->poisoned));
+  assert (EMPTY_STACK (solver->removable));
+
+  unsigned *const end = solver->clause.end;
+  unsigned *const begin = solver->clause.begin;
+  for (unsigned *p = end - 1; p != begin; p--)
+    if (minimize_literal (solver, *p, 0) == REMOVABLE)
+      *p = INVALID;
+
+  unsigned *q = begin, lit;
+  for (const unsigned *p = q; p != end; p++)
+    if ((lit = *p) != INVALID)
+      *q++ = lit;
+
+  const size_t minimized = end - q;
+  solver->clause.end = q;
+
+  LOG ("minimized %zu literals", minimized);
+  ADD (minimized, minimized);
+
+  LOGTMP ("minimized");
+}
+
+#endif
+
+// Reset the 'POISONED' and 'REMOVABLE' flags set during minimization.
+
+static void
+reset_removable_and_poisoned (struct satch *solver)
+{
+  for (all_elements_on_stack (unsigned, idx, solver->poisoned))
+      MARK (idx) &= ~POISONED;
+  CLEAR_STACK (solver->poisoned);
+
+  for (all_elements_on_stack (unsigned, idx, solver->removable))
+      MARK (idx) &= ~REMOVABLE;
+  CLEAR_STACK (solver->removable);
+}
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
+// Mark a literal as 'ANALYZED' if it has not been visited yet during
+// conflict analysis (or during reason-side-bumping).  Since the 'analyze'
+// function below needs the assignment level of the literal to mark decision
+// levels and decide whether the literal is added to the learned clause we
+// use that level as return value or 'INVALID' as result if the literal has
+// been marked before (or has been assigned on the root-level zero).
+
+static void
+mark_analyzed (struct satch *solver, unsigned idx)
+{
+  assert (!(MARK (idx) & ANALYZED));
+  MARK (idx) |= ANALYZED;
+  struct analyzed analyzed;
+  analyzed.idx = idx;
+#ifndef NSORTANALYZED
+  analyzed.stamp = INVALID;
+#endif
+  PUSH (solver->analyzed, analyzed);
+  LOG ("analyzed %s", LOGVAR (idx));
+}
+
+static inline unsigned
+analyze_literal (struct satch *solver, unsigned lit)
+{
+  const unsigned idx = INDEX (lit);
+  const unsigned lit_level = LEVEL (idx);
+  if (!lit_level)
+    return INVALID;
+  if (MARK (idx))
+    return INVALID;
+  mark_analyzed (solver, idx);
+  return lit_level;
+}
+
+/*------------------------------------------------------------------------*/
+
+// More thorough shrinking than classical clause minimization by trying to
+// find unique implication points on all previous decision levels without
+// introducing new decision levels into the learned clause.
+
+#ifndef NSHRINK
+
+// Mark-bit different from 'ANALYZED', 'REMOVABLE', and 'POISONED'.
+
+#define SHRUNKEN 8
+
+static void
+mark_shrunken (struct satch *solver, unsigned idx)
+{
+  assert (!(MARK (idx) & SHRUNKEN));
+  MARK (idx) |= SHRUNKEN;
+  PUSH (solver->shrunken, idx);
+  LOG ("shrunken %s", LOGVAR (idx));
+}
+
+// Reset literals marked 'SHRUNKEN' in any case (successful or unsuccessful).
+
+static void
+reset_shrunken (struct satch *solver)
+{
+  LOG ("resetting %zu shrunken variables", SIZE_STACK (solver->shrunken));
+  for (all_elements_on_stack (unsigned, idx, solver->shrunken))
+      MARK (idx) &= ~SHRUNKEN;
+  CLEAR_STACK (solver->shrunken);
+}
+
+// Positive case: literals can be shrunken to one unique implication point.
+
+static void
+mark_shrunken_as_removable (struct satch *solver)
+{
+  for (all_elements_on_stack (unsigned, idx, solver->shrunken))
+    if (!(MARK (idx) & REMOVABLE))
+        mark_removable (solver, idx);
+}
+
+// Return '0' if literal is removable or has already been shrunken. Return
+// '-1' if it can definitely not be shrunken, and '1' if it can in principle
+// be shrunken and thus has been marked as such.
+
+// The encoding of these result values has the idea that it matches the
+// number of new additionally marked literals by which 'open' is increased
+// in 'shrink_block' except that if '-1' is returned the search is aborted.
+
+// On lower decision level than the given level of the considered block we
+// use 'minimize_literal' which tries to resolve the literal away based on
+// other literals already in the (partially) minimized and shrunken clause.
+
+static int
+shrink_literal (struct satch *solver, unsigned block_level, unsigned lit)
+{
+  const unsigned idx = INDEX (lit);
+  const unsigned lit_level = LEVEL (idx);
+  if (!lit_level)
+    return 0;
+  if (MARK (idx) & SHRUNKEN)
+    return 0;
+  if (lit_level < block_level)
+    return (minimize_literal (solver, lit, 1) == REMOVABLE) ? 0 : -1;
+  mark_shrunken (solver, idx);
+  return 1;
+}
+
+// In case 'shrink_block' is successful it calls this function and shrinks
+// the literals in the clause from 'begin' to 'end' to the given unique
+// implication point and further resets the shrunken literals.
+
+static void
+shrunken_block (struct satch *solver,
+		unsigned *begin, unsigned *end, unsigned uip)
+{
+  for (unsigned *p = begin; p != end; p++)
+    *p = INVALID;
+  *begin = NOT (uip);
+  const unsigned idx = INDEX (uip);
+  if (!(MARK (idx) & ANALYZED))
+    mark_analyzed (solver, idx);
+#ifndef NCONTROL
+  const unsigned level = LEVEL (idx);
+  if (level != 0)
+    {
+      struct level *saved = &ACCESS (solver->control, level - 1);
+      if (saved->seen.earliest > solver->position[idx])
+	saved->seen.earliest = solver->position[idx];
+      ++saved->seen.count;
+      LOG ("updating level %d with: %d %d", level, saved->seen.earliest,
+	   saved->seen.count);
+    }
+#endif
+  mark_shrunken_as_removable (solver);
+  reset_shrunken (solver);
+}
+
+// Get start of the level-block ending right before 'end' in the temporary
+// clause which is assumed to be sorted by decreasing decision levels.
+
+static unsigned *
+next_block (struct satch *solver, unsigned *end)
+{
+  unsigned block_level = INVALID;
+  unsigned *begin = end;
+  while (solver->clause.begin < begin)
+    {
+      const unsigned lit = begin[-1];
+      const unsigned idx = INDEX (lit);
+      const unsigned lit_level = LEVEL (idx);
+      if (lit_level > block_level)
+	break;
+      block_level = lit_level;
+      begin--;
+    }
+  return begin;
+}
+
+// Find a first unique implication point of the given block of literals with
+// the same decision level in the deduced clause.
+
+static bool
+shrink_block (struct satch *solver, unsigned *begin, unsigned *end)
+{
+  assert (begin < end);
+  unsigned open = end - begin;
+  if (open < 2)
+    return true;		// Already shrunken so avoid 'minimize_block'.
+
+  const unsigned block_level = LEVEL (INDEX (*begin));
+  LOG ("trying to shrink block of size %u at level %u", open, block_level);
+
+  // First mark all literals in the block as 'SHRUNKEN' and also compute
+  // the maximum trail position of the literals in this block.
+
+  unsigned trail = 0;
+  {
+    const unsigned *const position = solver->position;
+    assert (EMPTY_STACK (solver->shrunken));
+    for (unsigned *p = begin; p != end; p++)
+      {
+	const unsigned lit = *p;
+	const unsigned idx = INDEX (lit);
+	mark_shrunken (solver, idx);
+
+	const unsigned pos = position[idx];
+	assert (solver->trail.begin[pos] == NOT (lit));
+	if (pos > trail)
+	  trail = pos;
+      }
+    assert (SIZE_STACK (solver->shrunken) == open);
+  }
+
+  // Now we can start traversing the trail for this block going backward
+  // from the last its literal on the trail.  This traversal follows a
+  // topological order, i.e., an inverse assignment order, and is similar to
+  // the trail traversal in 'analyze' which deduces the learned clause in
+  // the first place.  This order allows us to properly maintain 'open', the
+  // number of literals marked 'SHRUNKEN' and not yet resolved.  If this
+  // number drops to one we have found a unique implication point for this
+  // block.  An alternative to this linear traversal along the trail is
+  // to use a binary heap (we actually tried a radix heap) or some clever
+  // depth first search. The latter however would need to be aborted early
+  // if a literal can not be shrunken and probably is more complicated.
+
+  const unsigned *t = solver->trail.begin + trail;
+  unsigned uip = INVALID;
+  bool failed = false;
+
+
+  while (!failed)
+    {
+      unsigned idx;
+      do
+	assert (t >= solver->trail.begin), uip = *t--;
+      while (!(MARK (idx = INDEX (uip)) & SHRUNKEN));
+      if (!--open)
+	break;
+      struct clause *reason = REASON (idx);
+      assert (reason);
+#ifndef NBLOCK
+      if (is_tagged_clause (reason))
+	reason = untag_clause (solver, 0, uip, reason);
+      else
+#endif
+	INC (ticks);
+      LOGCLS (reason, "trying to shrink %s along", LOGLIT (uip));
+      for (all_literals_in_clause (lit, reason))
+	if (lit != uip)
+	  {
+	    int tmp = shrink_literal (solver, block_level, lit);
+	    if ((failed = (tmp < 0)))
+	      break;
+	    open += (tmp > 0);
+	  }
+    }
+
+  if (failed)
+    reset_shrunken (solver);
+  else
+    shrunken_block (solver, begin, end, uip);
+
+  LOG ("shrinking of block of size %zu at level %u %s",
+       (size_t) (end - begin), block_level, failed ? "failed" : "succeeded");
+
+  return !failed;
+}
+
+// Minimize the block if it could not be shrunken.
+
+static void
+minimize_block (struct satch *solver, unsigned *begin, unsigned *end)
+{
+  unsigned minimized = 0;
+  for (unsigned *p = begin; p != end; p++)
+    if (minimize_literal (solver, *p, 0) == REMOVABLE)
+      *p = INVALID, minimized++;
+  ADD (minimized, minimized);
+  LOG ("minimized %u literals", minimized);
+}
+
+// This is the main shrinking function.  It requires the temporary clause to
+// be sorted with respect to decreasing decision level of its literals (thus
+// 'sort_deduced_clause' has to be called first).
+
+static void
+shrink_deduced_clause (struct satch *solver)
+{
+  assert (EMPTY_STACK (solver->poisoned));
+  assert (EMPTY_STACK (solver->removable));
+
+  {
+    unsigned *end = solver->clause.end;
+    while (end != solver->clause.begin)
+      {
+	unsigned *begin = next_block (solver, end);
+	if (!shrink_block (solver, begin, end))
+	  minimize_block (solver, begin, end);
+	end = begin;
+      }
+  }
+
+  // Removed literals of each block are overwritten with 'INVALID' in place
+  // and in a last pass we have to flush these invalid literals.
+
+  {
+    const unsigned *const end = solver->clause.end;
+    unsigned *q = solver->clause.begin, lit;
+    for (const unsigned *p = q; p != end; p++)
+      if ((lit = *p) != INVALID)
+	*q++ = lit;
+
+    const unsigned shrunken = end - q;
+    solver->clause.end = q;
+    LOG ("shrunken %u literals", shrunken);
+    ADD (shrunken, shrunken);
+  }
+
+  LOGTMP ("shrunken");
+}
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
+// Bumping reason side literals was introduced in the Maple solver in 2016.
+
+// The idea is to also bump those literals in the reason of the literals in
+// the learned clauses.  It seems that using target phases during stable
+// mode really needs this technique in order to be effective (and the same
+// applies to rephasing to best-phases and probably rephasing in general).
+
+#ifndef NBUMPREASONS
+
+static inline void
+bump_reason_side_literals (struct satch *solver)
+{
+  struct averages *a = averages (solver);
+  if (unbiased_slow_average (a, a->decision_rate) >=
+      bump_reason_decision_rate_limit)
+    return;
+
+  for (all_elements_on_stack (unsigned, lit, solver->clause))
+    {
+      const unsigned idx = INDEX (lit);
+      struct clause *reason = REASON (idx);
+#ifndef NBLOCK
+      if (is_tagged_clause (reason))
+	reason = untag_clause (solver, 0, NOT (lit), reason);
+#endif
+      if (!reason)
+	continue;
+      for (all_literals_in_clause (other, reason))
+	if (analyze_literal (solver, other) != INVALID)
+	  INC (reasons);
+    }
+}
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
+// Sorting the analyzed variable indices to be bumped with respect to their
+// enqueue time stamp on the VMTF decision queue makes sure that they keep
+// the same relative order on the queue after bumping which empirically
+// improves the effectiveness of the decision heuristic (less conflicts).
+
+#ifndef NSORTANALYZED
+
+// The enqueue time stamps could be added to the 'analyzed' stack while
+// pushing variable indices to it.  This makes that code more complex given
+// all the different ways of disabling and enabling VMTF and sorting.
+// Instead we simply put this here to keep that complexity out of 'analyze'.
+
+static void
+add_stamps (struct satch *solver)
+{
+  struct queue *queue = get_queue (solver);
+  const struct link *const links = queue->links;
+  const struct analyzed *const end = solver->analyzed.end;
+  struct analyzed *const begin = solver->analyzed.begin;
+  for (struct analyzed * p = begin; p != end; p++)
+    p->stamp = links[p->idx].stamp;
+}
+
+#ifndef NRADIXSORT
+
+// Ranking function for radix-sorting the analyzed variables stack.
+
+// Without using radix sort the time spent in 'sort_analyzed' can reach 20%
+// of the total running time (including both time spent in focused and
+// stable mode) even though 'sort_analyzed' is by default only used in
+// focused mode for the VMTF decision heuristic.  This might then increase
+// relative time spent in focused mode since we do not want to account for
+// sorting with our 'ticks' counter.  We have seen cases where this effect
+// lead to 70% time spent in focused mode and only 30% time in stable mode.
+// Using faster radix sorting allows to achieve a more balanced split of
+// search time into focused and stable mode.
+
+// Note that for CaDiCaL and early versions of Kissat we determined
+// empirically that quick sort is faster when sorting 800 or less variables.
+// With a new optimization which computes upper and lower bounds once for
+// all radix rounds, this number of 800 could be reduced to only 32
+// elements, where the dedicated inlined quick sort is faster.
+
+// These numbers are with respect to a dedicated fast header only quick sort
+// implementation.  For the standard 'qsort' function of the C library which
+// requires comparison function call-backs instead of inlined comparison
+// this number would be smaller anyhow.  Thus for 'satch' we do not
+// implement quick sort at this point.  Note also that quick-sort itself
+// usually has some kind of 'leaf-coarsening' and in essence switches to
+// insertion sort if for instance the number of elements drops below 10.
+
+#define rank_analyzed(A) (A).stamp
+
+static void
+sort_analyzed (struct satch *solver)
+{
+  add_stamps (solver);
+  RSORT (struct analyzed, unsigned, solver->analyzed, rank_analyzed,
+	 solver->scratch);
+}
+
+#else
+
+// Comparison function for 'qsort' to sort variable indices by stamp time.
+// Note that, time stamps are unique. Thus we get stable sorting for free.
+
+static int
+cmp_analyzed (const void *p, const void *q)
+{
+  const struct analyzed *a = p, *b = q;
+  unsigned s = a->stamp, t = b->stamp;
+  return (s < t) ? -1 : 1;
+}
+
+static void
+sort_analyzed (struct satch *solver)
+{
+  add_stamps (solver);
+  qsort (solver->analyzed.begin, SIZE_STACK (solver->analyzed),
+	 sizeof (struct analyzed), cmp_analyzed);
+}
+
+#endif
+#endif
+
+/*------------------------------------------------------------------------*/
+
+// The CDCL conflict analysis function.
+
+// Find the highest level present in the conflict. Without chronological backtracking this is
+// always the current decision level
+#ifndef NCHRONO
+
+static int
+find_conflict_level (struct satch *solver, struct clause *conflict,
+		     unsigned *forced)
+{
+  assert (!solver->inconsistent);
+
+  (void) *forced;
+  unsigned res = 0;
+  int count = 0;
+  unsigned *lits = conflict->literals;
+  const int size = conflict->size;
+  unsigned *const end = lits + size;
+  unsigned *const begin = lits;
+  for (unsigned *p = begin; p != end; ++p)
+    {
+      LOG ("find conflict: lit %s", LOGLIT (*p));
+      const unsigned idx = INDEX (*p);
+      const unsigned level = LEVEL (idx);
+      if (level > res)
+	{
+	  res = level;
+	  *forced = *p;
+	  count = 1;
+	}
+      else if (level == res)
+	{
+	  count++;
+	}
+    }
+
+  LOG ("%d literals on actual conflict level %d, forced: %s", count, res,
+       forced && *forced != INVALID ? LOGLIT (*forced) : "no");
+
+  // Move the two highest level literals to the front (XOR reasons are not
+  // watched and thus do not need this).
+  //
+  if (
+#ifndef NVIRTUAL
+       !is_temporary_binary (solver, conflict) &&
+#endif
+       !conflict->parity)
+    {
+      for (unsigned i = 0; i < 2; i++)
+	{
+
+	  const unsigned lit = lits[i];
+
+	  unsigned highest_position = i;
+	  unsigned highest_literal = lit;
+	  const unsigned idx = INDEX (lit);
+	  unsigned highest_level = LEVEL (idx);
+
+	  for (int j = i + 1; j < size; j++)
+	    {
+	      const int other = lits[j];
+	      const unsigned idx_other = INDEX (other);
+	      const unsigned tmp = LEVEL (idx_other);
+	      if (highest_level >= tmp)
+		continue;
+	      highest_literal = other;
+	      highest_position = j;
+	      highest_level = tmp;
+	      if (highest_level == res)
+		break;
+	    }
+
+	  // No unwatched higher assignment level literal.
+	  //
+	  if (highest_position == i)
+	    continue;
+
+#ifndef NWATCHES
+	  if (highest_position > 1)
+	    {
+	      LOGCLS (conflict, "unwatch %d in", lit);
+	      unwatch_literal (solver, lit, conflict);
+	    }
+#endif
+
+	  lits[highest_position] = lit;
+	  lits[i] = highest_literal;
+
+#ifndef NWATCHES
+	  if (highest_position > 1)
+#ifndef NBLOCK
+	    watch_literal (solver, conflict->redundant, highest_literal,
+			   lits[!i], conflict);
+#else
+	    watch_literal (solver, highest_literal, conflict);
+#endif
+#endif
+	}
+    }
+
+
+  // Only if the number of highest level literals in the conflict is one
+  // then we can reuse the conflict clause as driving clause for 'forced'.
+  //
+  if (count != 1)
+    {
+      *forced = UINT32_MAX;
+      LOG ("no forcing literal");
+    }
+
+  return res;
+
+}
+
+#ifndef NHEAP
+unsigned
+reuse_scored_trail_from (struct satch *solver, unsigned asserting_level)
+{
+  unsigned next = max_score_unassigned_variable_on_binary_heap (solver);
+  const SCORE_TYPE *const scores = solver->scores[solver->stable].score;
+  struct control const control = solver->control;
+  unsigned *const end = solver->trail.end;
+  const double next_score = scores[next];
+  double decision_score = MAX_SCORE;
+  const unsigned control_position =
+    asserting_level ? asserting_level - 1 : asserting_level;
+  for (unsigned *lit = ACCESS (control, control_position).trail; lit != end;
+       ++lit)
+    {
+      const unsigned idx = INDEX (*lit);
+      const double score = scores[idx];
+      const unsigned level = LEVEL (idx);
+      if (level <= asserting_level)
+	continue;
+      if (decision_score < score || score < next_score)
+	return level - 1;
+      if (!REASON (idx))
+	decision_score = score;
+    }
+  return solver->level - 1;
+}
+#endif
+
+#ifndef NQUEUE
+unsigned
+reuse_stamped_trail_from (struct satch *solver, unsigned asserting_level)
+{
+  unsigned next = max_stamped_unassigned_variable_on_decision_queue (solver);
+  const struct link *const links = solver->queue[solver->stable].links;
+  struct control const control = solver->control;
+  unsigned *const end = solver->trail.end;
+  const unsigned next_stamp = links[next].stamp;
+  unsigned decision_stamp = UINT_MAX;
+  const unsigned control_position =
+    asserting_level ? asserting_level - 1 : asserting_level;
+  for (unsigned *lit = ACCESS (control, control_position).trail; lit != end;
+       ++lit)
+    {
+      const unsigned idx = INDEX (*lit);
+      const unsigned stamp = links[idx].stamp;
+      const unsigned level = LEVEL (idx);
+      if (level <= asserting_level)
+	continue;
+      if (decision_stamp < stamp || stamp < next_stamp)
+	return level - 1;
+      if (!REASON (idx))
+	decision_stamp = stamp;
+    }
+  return solver->level - 1;
+}
+#endif
+
+#endif
+
+#ifndef NCHRONO
+#define CHRONOLEVELS 100
+#endif
+
+#ifndef NCDCL
+// Determine the level we should jump back to. Without chronological backtracking, this is
+// simply the asserting level. With it, there are three possibilities:
+//    - if backtracking does not make sense (e.g., when vivifying), backjump
+//    - otherwise, we use a restart-like heuristic to determine how much should be reused...
+//    - ...unless all variables have been decided. Then we jump to the lastest level.
+static unsigned
+determine_jump_level (struct satch *solver, unsigned conflict_level,
+		      unsigned *asserting_level)
+{
+  signed char *frames = solver->frames;
+  unsigned jump_level = 0;
+  *asserting_level = 0;
+
+  for (all_elements_on_stack (unsigned, lit_level, solver->blocks))
+    {
+      frames[lit_level] = 0;
+      if (lit_level != conflict_level && *asserting_level < lit_level)
+	*asserting_level = lit_level;
+#ifndef NCONTROL
+      if (lit_level)
+	ACCESS (solver->control, lit_level - 1).seen.count = 0,
+	  ACCESS (solver->control, lit_level - 1).seen.earliest = UINT32_MAX;
+#endif
+    }
+  LOG ("asserting level: %d", *asserting_level);
+
+#ifndef NCHRONO
+  if (solver->level - *asserting_level < CHRONOLEVELS ||
+      solver->level - 1 == *asserting_level
+#ifndef NVIVIFICATION
+      || solver->vivifying
+#endif
+    )
+    {
+      LOG ("normal backjumping");
+      return *asserting_level;
+    }
+  LOG ("backjumping considered too inefficient");
+  if (!solver->unassigned)
+    {
+      jump_level = solver->level - 1;
+      if (*asserting_level != solver->level - 1)
+	{
+	  INC (chrono);
+	  ADD (chronosaved, jump_level - *asserting_level);
+	}
+      return jump_level;
+    }
+#ifndef NCHRONOREUSE
+#ifndef NQUEUE
+  if (!solver->queue[solver->stable].size)
+    return solver->level - 1;
+#endif
+
+#if defined(NHEAP)
+  jump_level = reuse_stamped_trail_from (solver, *asserting_level);
+#elif defined(NQUEUE)
+  jump_level = reuse_scored_trail_from (solver, *asserting_level);
+#else
+  if (solver->stable)
+    {
+      jump_level = reuse_scored_trail_from (solver, *asserting_level);
+    }
+
+  else
+    {
+      jump_level = reuse_stamped_trail_from (solver, *asserting_level);
+    }
+#endif
+#else // NCHRONOREUSE = always backtrack to lastest level
+  jump_level = solver->level - 1;
+#endif
+  assert (jump_level >= *asserting_level);
+  if (*asserting_level != jump_level)
+    {
+      INC (chrono);
+      ADD (chronosaved, jump_level - *asserting_level);
+    }
+
+#else // no backtracking
+  jump_level = *asserting_level;
+#endif
+  return jump_level;
+}
+#endif
+
+#ifdef NCDCL
+static void
+produce_reason_for_checker (struct satch *solver)
+{
+  for (unsigned *lit = solver->trail.begin; lit != solver->trail.end; ++lit)
+    {
+      const unsigned idx = INDEX (*lit);
+      if (!REASON (idx))
+	{
+	  PUSH (solver->clause, NOT (*lit));
+	}
+    }
+
+  struct averages *a = averages (solver);
+  {
+    double trail_filled = percent (SIZE_STACK (solver->trail),
+				   solver->statistics.remaining);
+    update_slow_average (&a->trail_filled, trail_filled);
+    update_slow_average (&a->conflict_level, solver->level);
+  }
+  {
+    const uint64_t decisions = DECISIONS;
+    const uint64_t delta_decisions = decisions - a->saved_decisions;
+    a->saved_decisions = decisions;
+    update_slow_average (&a->decision_rate, delta_decisions);
+  }
+  update_betas (solver);
+
+  trace_and_check_temporary_addition (solver);
+
+  CLEAR_STACK (solver->clause);
+
+}
+#endif
+
+/*------------------------------------------------------------------------*/
+
+// Assumptions are decided first in the order they were added, each on its
+// own decision level, before any other decision is made.  The 'assumed'
+// cursor points to the first assumption not known to be satisfied and is
+// reset in 'backtrack' if an assumption decision level is backtracked.
+
+// If an assumption is falsified we determine the set of assumptions which
+// are responsible for this by going backward over the trail and following
+// reasons starting from the falsified assumption.  The analyzed decisions
+// are assumptions and become part of the failed assumption core.
+
+static void
+mark_failed_assumption (struct satch *solver, unsigned lit)
+{
+  struct flags *f = solver->flags + INDEX (lit);
+  assert (f->assumed);
+  f->failed |= 1u << SIGN_BIT (lit);
+  LOG ("failed assumption %s", LOGLIT (lit));
+}
+
+static void
+analyze_failed_assumption (struct satch *solver, unsigned failed)
+{
+  LOG ("analyzing failed assumption %s", LOGLIT (failed));
+  assert (solver->values[failed] < 0);
+  mark_failed_assumption (solver, failed);
+  const unsigned failed_idx = INDEX (failed);
+  if (!LEVEL (failed_idx))
+    return;
+#ifdef NCDCL
+  // Without conflict analysis reasons are only 'DUMMY_REASON' and we can
+  // only conservatively consider all assumptions as failed.
+
+  for (all_elements_on_stack (unsigned, lit, solver->assumptions))
+      mark_failed_assumption (solver, lit);
+#else
+  const unsigned *t = solver->trail.end;
+  MARK (failed_idx) = ANALYZED;
+  unsigned open = 1;
+  while (open)
+    {
+      assert (t > solver->trail.begin);
+      const unsigned lit = *--t;
+      const unsigned idx = INDEX (lit);
+      if (!MARK (idx))
+	continue;
+      MARK (idx) = 0;
+      open--;
+      struct clause *reason = REASON (idx);
+      if (!reason)
+	{
+	  mark_failed_assumption (solver, lit);
+	  continue;
+	}
+#ifndef NBLOCK
+      if (is_tagged_clause (reason))
+	reason = untag_clause (solver, 0, lit, reason);
+#endif
+      for (all_literals_in_clause (other, reason))
+	{
+	  const unsigned other_idx = INDEX (other);
+	  if (other_idx == idx || MARK (other_idx) || !LEVEL (other_idx))
+	    continue;
+	  MARK (other_idx) = ANALYZED;
+	  open++;
+	}
+    }
+#endif
+}
+
+// Find the first assumption which is not satisfied.  Return 'INVALID' if
+// all assumptions are satisfied.
+
+static unsigned
+next_assumption (struct satch *solver)
+{
+  const unsigned *const assumptions = solver->assumptions.begin;
+  const unsigned size = SIZE_STACK (solver->assumptions);
+  const signed char *const values = solver->values;
+  while (solver->assumed < size)
+    {
+      const unsigned lit = assumptions[solver->assumed];
+      if (values[lit] <= 0)
+	return lit;
+      solver->assumed++;
+    }
+  return INVALID;
+}
+
+// All variables are assigned but maybe not all assumptions are satisfied.
+
+static int
+satisfied_under_assumptions (struct satch *solver)
+{
+  assert (!solver->unassigned);
+  const unsigned assumption = next_assumption (solver);
+  if (assumption == INVALID)
+    return 10;
+  analyze_failed_assumption (solver, assumption);
+  return 20;
+}
+
+/*------------------------------------------------------------------------*/
+
+#if !defined(NPORTFOLIO) && !defined(NCDCL)
+
+// Portfolio workers export learned units and learned clauses with small
+// glue to their ring, where other workers pick them up during import.
+
+static void
+export_learned_clause (struct satch *solver, unsigned glue)
+{
+  const size_t size = SIZE_STACK (solver->clause);
+  assert (size);
+  if (size > shared_size_limit)
+    return;
+  if (size > 1 && glue > shared_glue_limit)
+    return;
+#ifdef NLEARN
+  if (size > 1)			// Only units are imported without learning.
+    return;
+#endif
+  struct ring *ring = &solver->worker->ring;
+  const uint64_t exported = ring->exported;
+  struct slot *slot = ring->slots + exported % shared_ring_size;
+  __atomic_store_n (&slot->sequence, 2 * exported + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence (__ATOMIC_RELEASE);
+  __atomic_store_n (&slot->size, size, __ATOMIC_RELAXED);
+  __atomic_store_n (&slot->glue, size > 1 ? glue : 0, __ATOMIC_RELAXED);
+  const unsigned *const literals = solver->clause.begin;
+  for (size_t i = 0; i != size; i++)
+    __atomic_store_n (slot->literals + i, literals[i], __ATOMIC_RELAXED);
+  __atomic_store_n (&slot->sequence, 2 * exported + 2, __ATOMIC_RELEASE);
+  __atomic_store_n (&ring->exported, exported + 1, __ATOMIC_RELEASE);
+  LOGTMP ("exported");
+  INC (exported);
+}
+
+#endif
+
+#ifndef NOTFS
+
+// On-the-fly strengthening (OTFS) checks after resolving the reason of the
+// literal 'pivot' during conflict analysis whether the resolvent consists
+// exactly of the other (not root-level falsified) literals of the reason.
+// Then the resolvent subsumes the reason and we strengthen it in place by
+// removing 'pivot' (and root-level falsified literals).  This is only done
+// if at least two literals on the conflict level remain, which become the
+// new watches and are thus unassigned after backjumping.  Since the reason
+// does not change anymore during analysis, it is fine that it is not the
+// reason of 'pivot' anymore, which in any case is unassigned afterwards.
+
+static void
+strengthen_reason_on_the_fly (struct satch *solver, struct clause *reason,
+			      unsigned pivot, unsigned conflict_level,
+			      unsigned resolvent)
+{
+  unsigned *const literals = reason->literals;
+  const unsigned old_size = reason->size;
+
+  unsigned new_size = 0;
+  for (unsigned i = 0; i != old_size; i++)
+    {
+      const unsigned lit = literals[i];
+      if (lit != pivot && LEVEL (INDEX (lit)))
+	new_size++;
+    }
+  if (new_size != resolvent)
+    return;
+
+  LOGCLS (reason, "on-the-fly strengthening by removing %s", LOGLIT (pivot));
+
+  // Move the remaining literals to the front and keep the removed ones
+  // after them, such that deleting the old clause can still be traced.
+
+  const unsigned old_watched[2] = { literals[0], literals[1] };
+  new_size = 0;
+  for (unsigned i = 0; i != old_size; i++)
+    {
+      const unsigned lit = literals[i];
+      if (lit == pivot || !LEVEL (INDEX (lit)))
+	continue;
+      literals[i] = literals[new_size];
+      literals[new_size++] = lit;
+    }
+  assert (new_size == resolvent);
+
+  unsigned watched = 0;
+  for (unsigned i = 0; watched != 2; i++)
+    {
+      assert (i < new_size);
+      const unsigned lit = literals[i];
+      if (LEVEL (INDEX (lit)) != conflict_level)
+	continue;
+      literals[i] = literals[watched];
+      literals[watched++] = lit;
+    }
+
+  trace_and_check_addition (solver, new_size, literals, INVALID);
+  trace_and_check_deletion (solver, old_size, literals);
+
+  unwatch_literal (solver, old_watched[0], reason);
+  unwatch_literal (solver, old_watched[1], reason);
+  reason->size = new_size;
+#ifndef NCACHE
+  reason->search = 0;
+#endif
+#ifndef NGLUE
+  if (reason->glue >= new_size)
+    reason->glue = new_size - 1;
+#endif
+  if (!reason->redundant)
+    {
+#ifndef NELIMINATION
+      for (unsigned i = new_size; i != old_size; i++)
+	mark_eliminate_literal (solver, literals[i]);
+#endif
+#if !defined(NSUBSUMPTION) && (!defined(NREDUCE) || !defined(NELIMINATION))
+      for (unsigned i = 0; i != new_size; i++)
+	mark_subsume_literal (solver, literals[i]);
+#endif
+    }
+  watch_clause (solver, reason);
+  LOGCLS (reason, "on-the-fly strengthened");
+  INC (otfs);
+}
+
+#endif
+
+// First we deduce the 'first unique implication point' (1st UIP) clause,
+// minimize, shrink and learn it, then determine backjump level, backtrack
+// and assign the 1st UIP literal to the opposite value with the learned
+// clause as reason.  We also update various statistics during the analysis.
+static bool
+analyze_conflict (struct satch *solver, struct clause *conflict)
+{
+  assert (!solver->inconsistent);
+  assert (EMPTY_STACK (solver->clause));	// Clause learned.
+
+  if (!solver->level)
+    {
+      LOG ("learned empty clause");
+      trace_and_check_empty_addition (solver);
+      solver->inconsistent = true;
+      return false;
+    }
+
+#ifdef NCDCL
+  (void) conflict;
+  produce_reason_for_checker (solver);
+#ifndef NCONTROL
+  struct level const *const saved =
+    &ACCESS (solver->control, solver->level - 1);
+  const unsigned uip = *saved->trail;
+  assert (solver->values[uip]);
+  assert (saved->lvl == solver->level);
+#else
+  assert (!EMPTY_STACK (solver->trail));
+  unsigned *uipp = solver->trail.end - 1;
+  while (REASON (INDEX (*uipp)))
+    {
+      assert (uipp > solver->trail.begin);
+      --uipp;
+    }
+  const unsigned uip = *uipp;
+#endif
+  if (solver->level <= solver->assumption_level)
+    {
+      // Assumption decisions can not be flipped and without learned
+      // clauses we have to consider all assumptions as failed.
+
+      LOG ("conflict under assumptions");
+      for (all_elements_on_stack (unsigned, lit, solver->assumptions))
+	  mark_failed_assumption (solver, lit);
+      return false;
+    }
+#ifndef NTARGET
+  if (solver->stable)
+    update_phases (solver);
+#endif
+  unsigned not_uip = NOT (uip);
+  backtrack (solver, solver->level - 1);
+  LOG ("swapping last decision %s", LOGLIT (uip));
+  assert (!solver->values[uip]);
+  assign (solver, not_uip, DUMMY_REASON, solver->level == 0);
+
+  return true;
+#else
+  assert (EMPTY_STACK (solver->blocks));	// Decision levels analyzed.
+  assert (EMPTY_STACK (solver->analyzed));	// Analyzed literals.
+
+  PUSH (solver->clause, INVALID);	// Reserve room for 1st UIP.
+
+#ifndef NCHRONO
+  unsigned forced = INVALID;
+  unsigned *forcedp = &forced;
+  const unsigned conflict_level =
+    find_conflict_level (solver, conflict, forcedp);
+  if (!conflict_level)
+    {
+      LOG ("learned empty clause");
+      trace_and_check_empty_addition (solver);
+      solver->inconsistent = true;
+      return false;
+    }
+  if (*forcedp != INVALID)
+    {
+      assert (solver->values[*forcedp] < 0);
+#ifndef NBLOCK
+      assert (!is_tagged_clause (conflict));
+#endif
+      LOG ("missed propagation of lit %s from level %d", LOGLIT (*forcedp),
+	   conflict_level);
+      backtrack (solver, conflict_level - 1);
+#ifndef NBLOCK
+      if (is_temporary_binary (solver, conflict) || conflict->size == 2)
+	{
+#ifndef NBLOCK
+	  unsigned other =
+	    *forcedp ^ conflict->literals[0] ^ conflict->literals[1];
+	  struct clause *reason = tag_binary_clause (true, other);
+	  assign (solver, *forcedp, reason, false);
+#else
+	  assign (solver, *forcedp, conflict, false);
+#endif
+	}
+      else
+#endif
+	assign (solver, *forcedp, conflict, false);
+      CLEAR_STACK (solver->blocks);
+      CLEAR_STACK (solver->clause);
+      assert (solver->level == conflict_level - 1);
+      return true;
+    }
+  if (conflict_level < solver->level)
+    {
+      LOG ("conflict was on level %d instead of current level %d",
+	   conflict_level, solver->level);
+      backtrack (solver, conflict_level);
+    }
+  else
+    {
+      LOG ("conflict is on current level");
+    }
+#else
+  const unsigned conflict_level = solver->level;
+#endif
+  signed char *frames = solver->frames;
+
+  struct clause *reason = conflict;
+
+  const unsigned *t = solver->trail.end;
+  unsigned unresolved_on_current_level = 0;
+  unsigned uip = INVALID;
+
+  uint64_t ticks = 0;
+
+  for (;;)
+    {
+      assert (reason);
+      LOGCLS (reason, "analyzing");
+#ifndef NUSED
+#ifndef NBLOCK
+      if (!is_temporary_binary (solver, reason))
+#endif
+	{
+	  assert (uip == INVALID || solver->values[uip] > 0);
+	  if (!reason->used)
+	    reason->used = 1;
+#ifndef NTIER2
+	  else if (reason->glue <= tier2_glue_limit)
+	    reason->used = 2;
+#endif
+	  ticks++;
+	}
+#endif
+      for (all_literals_in_clause (lit, reason))
+	{
+	  if (lit == uip)
+	    continue;
+	  const unsigned lit_level = analyze_literal (solver, lit);
+	  if (lit_level == INVALID)
+	    continue;
+	  assert (solver->values[lit] < 0);
+	  if (lit_level < conflict_level)
+	    {
+	      if (!frames[lit_level])
+		{
+		  LOG ("analyzing decision level %u", lit_level);
+		  PUSH (solver->blocks, lit_level);
+		  frames[lit_level] = 1;
+		}
+	      PUSH (solver->clause, lit);
+#ifndef NCONTROL
+	      const unsigned idx = INDEX (lit);
+	      const unsigned level = LEVEL (idx);
+	      if (level != 0)
+		{
+		  struct level *saved = &ACCESS (solver->control, level - 1);
+		  if (saved->seen.earliest > solver->position[idx])
+		    saved->seen.earliest = solver->position[idx];
+		  ++saved->seen.count;
+		  LOG ("updating level %d with: %d %d", level,
+		       saved->seen.earliest, saved->seen.count);
+		}
+#endif
+	    }
+	  else
+	    unresolved_on_current_level++;
+	}
+#ifndef NOTFS
+      if (uip != INVALID && unresolved_on_current_level > 1)
+	{
+	  const unsigned resolvent =
+	    SIZE_STACK (solver->clause) - 1 + unresolved_on_current_level;
+	  if (2 < resolvent && resolvent < reason->size &&
+	      !reason->parity && !reason->garbage)
+	    strengthen_reason_on_the_fly (solver, reason, uip,
+					  conflict_level, resolvent);
+	}
+#endif
+      unsigned uip_idx;
+      do
+	{
+	  assert (solver->trail.begin < t);
+#ifndef NCHRONO
+	  if (LEVEL (INDEX (*--t)) == solver->level)
+	    uip = *t;
+	  else
+	    uip = INVALID;
+#else
+	  uip = *--t;
+#endif
+	}
+      while (uip == INVALID || !MARK (uip_idx = INDEX (uip)));
+      LOG ("next lit to analyze is %s", LOGLIT (uip));
+      if (!--unresolved_on_current_level)
+	break;
+      reason = REASON (uip_idx);
+#ifndef NBLOCK
+      if (is_tagged_clause (reason))
+	reason = untag_clause (solver, 0, uip, reason);
+#endif
+    }
+  assert (uip != INVALID);
+  LOG ("first unique implication point %s (1st UIP)", LOGLIT (uip));
+  const unsigned not_uip = NOT (uip);
+  ACCESS (solver->clause, 0) = not_uip;
+  ADD (ticks, ticks);
+
+  LOGTMP ("deduced");
+  unsigned size = SIZE_STACK (solver->clause);
+  ADD (deduced, size);
+  assert (size);
+
+#ifndef NSORTDEDUCED
+  sort_deduced_clause (solver);
+#endif
+
+#ifndef NMINIMIZE
+  START_IF_NCHEAP (minishrink);
+#ifndef NSHRINK
+  shrink_deduced_clause (solver);
+#else
+  minimize_deduced_clause (solver);
+#endif
+  reset_removable_and_poisoned (solver);
+  STOP_IF_NCHEAP (minishrink);
+  size = SIZE_STACK (solver->clause);
+#endif
+
+  const unsigned glue = SIZE_STACK (solver->blocks);
+  unsigned asserting_level = 0;
+  unsigned jump_level =
+    determine_jump_level (solver, conflict_level, &asserting_level);
+  CLEAR_STACK (solver->blocks);
+
+  {
+    struct averages *a = averages (solver);
+#ifndef NRESTART
+    update_fast_average (&a->fast_glue, glue);
+#endif
+    update_slow_average (&a->slow_glue, glue);
+    update_slow_average (&a->conflict_level, conflict_level);
+    {
+      const uint64_t decisions = DECISIONS;
+      const uint64_t delta_decisions = decisions - a->saved_decisions;
+      a->saved_decisions = decisions;
+      update_slow_average (&a->decision_rate, delta_decisions);
+    }
+    {
+      double trail_filled = percent (SIZE_STACK (solver->trail),
+				     solver->statistics.remaining);
+      update_slow_average (&a->trail_filled, trail_filled);
+    }
+    update_betas (solver);
+
+    LOG ("determined jump level %u and glue %u", jump_level, glue);
+    LOG ("exponential 'conflict_level' moving average %g",
+	 unbiased_slow_average (a, a->conflict_level));
+#ifndef NRESTART
+    LOG ("exponential 'fast_glue' moving average %g",
+	 unbiased_fast_average (a, a->fast_glue));
+#endif
+    LOG ("exponential 'slow_glue' moving average %g",
+	 unbiased_slow_average (a, a->slow_glue));
+  }
+
+#ifndef NBUMPREASONS
+  bump_reason_side_literals (solver);
+#endif
+
+#ifndef NSORTANALYZED
+#ifndef NVSIDS
+  if (!solver->stable)
+#endif
+    sort_analyzed (solver);	// Sort analyzed variables on time stamp.
+#endif
+
+  for (all_elements_on_stack (struct analyzed, analyzed, solver->analyzed))
+    {
+      const unsigned idx = analyzed.idx;
+#if !defined(NVMTF) || !defined(NVSIDS)
+#ifndef NBUMP
+      INC (bumped);
+#if defined(NVMTF) || defined(NQUEUE)
+      bump_variable_score (solver, idx);
+#elif defined(NVSIDS) || defined(NHEAP)
+      move_variable_to_front (solver, idx);
+#else
+      if (solver->stable)
+	bump_variable_score (solver, idx);
+      else
+	move_variable_to_front (solver, idx);
+#endif
+#endif
+#endif
+      assert (MARK (idx));
+      MARK (idx) = 0;
+    }
+  CLEAR_STACK (solver->analyzed);
+
+#ifndef NVSIDS
+#ifndef NSWITCH
+  if (solver->stable)
+#endif
+    bump_score_increment (solver);
+#endif
+
+  trace_and_check_temporary_addition (solver);
+#ifndef NPORTFOLIO
+  if (solver->worker)
+    export_learned_clause (solver, glue);
+#endif
+
+#ifndef NTARGET
+  assert (solver->level);
+  backtrack (solver, solver->level - 1);
+  if (solver->stable)
+    update_phases (solver);
+  if (jump_level < solver->level)
+#endif
+    backtrack (solver, jump_level);
+
+  if (size == 1)		// Learned a unit clause.
+    {
+#ifdef NCHRONO
+      assert (!jump_level);
+#endif
+      solver->iterate = true;
+      assign (solver, not_uip, 0, true);
+    }
+#ifndef NVIRTUAL
+  else if (size == 2)
+    {
+      const unsigned other = ACCESS (solver->clause, 1);
+      LOGBIN (true, not_uip, other, "learned");
+#ifndef NLEARN
+      add_new_binary_and_watch_it (solver, true);
+#endif
+      ADD (learned, 2);
+      struct clause *reason = tag_binary_clause (true, other);
+      assign (solver, not_uip, reason, false);
+    }
+#endif
+  else
+    {
+      assert (size > 1);	// Learned and at least binary clause.
+      assert (jump_level > 0);
+
+      // First literal at jump-level becomes other watch.  Such a literal
+      // has to exist and thus the 'break' below has to be hit.  We further
+      // rely on backtracking not to reset the level of unassigned literals.
+      for (unsigned *p = solver->clause.begin + 1, *q = p;; q++)
+	{
+	  assert (q != solver->clause.end);
+	  const unsigned lit = *q;
+	  unsigned idx = INDEX (lit);
+	  unsigned lit_level = LEVEL (idx);
+	  assert (lit_level <= asserting_level);
+	  if (lit_level == asserting_level)
+	    {
+	      *q = *p;
+	      *p = lit;
+	      break;
+	    }
+	}
+
+#ifndef NGLUE
+      struct clause *learned = new_redundant_clause (solver, glue);
+#else
+      struct clause *learned = new_redundant_clause (solver);
+#endif
+
+#ifndef NUSED
+#ifndef NTIER2
+      if (glue <= tier2_glue_limit)
+	learned->used = 2;
+      else
+#endif
+	learned->used = 1;
+#endif
+      LOGCLS (learned, "learned");
+      ADD (learned, size);
+#ifndef NLEARN
+#ifndef NWATCHES
+      watch_clause (solver, learned);
+#else
+      connect_clause (solver, learned);
+      count_clause (solver, learned);
+#endif
+#endif
+      assign (solver, not_uip, learned, false);
+    }
+
+  CLEAR_STACK (solver->clause);
+  return true;
+#endif
+}
+
+/*------------------------------------------------------------------------*/
+
+#ifndef NQUEUE
+
+unsigned
+max_stamped_unassigned_variable_on_decision_queue (struct satch *solver)
+{
+  struct queue *queue = get_queue (solver);
+  const struct link *const links = queue->links;
+  const signed char *const values = solver->values;
+
+  unsigned idx = queue->search;
+
+  for (;;)
+    {
+      assert (idx != INVALID);
+      const unsigned lit = LITERAL (idx);
+      const signed char value = values[lit];
+      if (!value)
+	break;
+      idx = links[idx].prev;
+    }
+  queue->search = idx;		// Cache search position.
+
+  LOG ("maximum stamped unassigned %s with stamp %u",
+       LOGVAR (idx), links[idx].stamp);
+
+  return idx;
+}
+
+#endif
+
+#ifndef NHEAP
+unsigned
+max_score_unassigned_variable_on_binary_heap (struct satch *solver)
+{
+  const signed char *const values = solver->values;
+  struct heap *scores = get_scores (solver);
+
+  unsigned idx;
+
+  for (;;)
+    {
+      idx = max_heap (scores);
+      const unsigned lit = LITERAL (idx);
+      const signed char value = values[lit];
+      if (!value)
+	break;
+      pop_heap (solver, scores);
+    }
+
+  LOG ("maximum score unassigned %s with score %g",
+       LOGVAR (idx), scores->score[idx]);
+
+  return idx;
+}
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
+// Decision variable heuristic uses exponential 'VSIDS' in stable mode and
+// 'VMTF' in focused mode unless one of these heuristics is disabled.
+
+// The different cases in this function should match those in 'reuse_trail',
+// except that the latter is only enabled if bumping is enabled too (thus we
+// can replace 'NHEAP' with 'NVSIDS' and 'NQUEUE' with 'NVMTF' there).
+
+#if !defined(DLIS) || !defined(NSAVE)
+
+static unsigned
+decide_variable (struct satch *solver)
+{
+  unsigned idx;
+
+#ifdef DLIS
+  idx = max_score_dlis (solver);
+#else
+#if defined(NHEAP)
+  idx = max_stamped_unassigned_variable_on_decision_queue (solver);
+#elif defined(NQUEUE)
+  idx = max_score_unassigned_variable_on_binary_heap (solver);
+#else
+  if (solver->stable)
+    idx = max_score_unassigned_variable_on_binary_heap (solver);
+  else
+    idx = max_stamped_unassigned_variable_on_decision_queue (solver);
+#endif
+#endif
+  LOG ("decision %s", LOGVAR (idx));
+
+  return idx;
+}
+
+// The decision phase is the value assigned to the decision variable. In the
+// default configuration we use 'phase saving', i.e., the previous assigned
+// variable to that variable and fall back to the default phase 'true' for
+// never assigned variables (unless 'NTRUE' is defined, where the default
+// original phase value becomes 'false').  The default value is always
+// picked if phase saving is disabled ('NSAVE' is defined).  Portfolio
+// workers might overwrite the original phase for diversification.
+
+static int
+original_phase (struct satch *solver)
+{
+#ifndef NPORTFOLIO
+  if (solver->options.phase)
+    return solver->options.phase;
+#endif
+  (void) solver;
+#ifndef NTRUE
+  return 1;			// Default is 'true'.
+#else
+  return -1;			// Otherwise 'false' (if 'NTRUE' defined).
+#endif
+}
+
+static int
+decide_phase (struct satch *solver, unsigned idx)
+{
+  signed char value = 0;
+#ifndef NTARGET
+  if (solver->stable)
+    value = solver->targets[idx];
+#endif
+#ifndef NSAVE
+  if (!value)
+    value = solver->saved[idx];
+#endif
+  if (!value)
+    value = original_phase (solver);
+  LOG ("decision phase %d", (int) value);
+  (void) idx;			// Prevent unused 'idx' warning.
+  return value;
+}
+#endif
+
+static unsigned
+decide_literal (struct satch *solver)
+{
+#if defined(DLIS) && defined(NSAVE)
+  const unsigned decision = max_score_dlis (solver);	// actually returns a literal
+#else
+  const unsigned idx = decide_variable (solver);
+  const int value = decide_phase (solver, idx);
+
+  const unsigned lit = LITERAL (idx);
+  const unsigned decision = (value < 0 ? NOT (lit) : lit);
+  LOG ("decision literal %s", LOGLIT (decision));
+#endif
+  return decision;
+}
+
+// Pick a decision variable and phase to which it is assigned as decision
+// literal. Then increase decision level and assign the decision literal.
+// Unsatisfied assumptions are picked first and if one of them turns out to
+// be falsified we return '20'.
+
+static int
+decide (struct satch *solver)
+{
+#ifdef NWATCHES
+#ifndef NVIVIFICATION
+  if (!solver->vivifying)
+#endif
+    {
+    for (all_irredundant_clauses(clause)) {
+      unsigned count = 0;
+      if (clause->garbage)
+        continue;
+      for (all_literals_in_clause(lit, clause)) {
+	if (solver->values[lit] != -1)
+	  ++count;
+      }
+      assert (count == clause->count);
+    }
+    for (all_redundant_clauses(clause)) {
+      if (clause->garbage)
+        continue;
+      unsigned count = 0;
+      for (all_literals_in_clause(lit, clause)) {
+	if (solver->values[lit] != -1)
+	  ++count;
+      }
+      assert (count == clause->count);
+    }
+  }
+#endif
+  const unsigned assumption = next_assumption (solver);
+  if (assumption != INVALID && solver->values[assumption])
+    {
+      analyze_failed_assumption (solver, assumption);
+      return 20;
+    }
+
+  START_IF_NCHEAP (decide);
+  INC (decisions);
+
+  assert (solver->unassigned);
+  assert (!solver->inconsistent);
+  assert (solver->level < solver->size);
+
+#ifndef NCHRONO
+  assert (solver->level == SIZE_STACK (solver->control));
+#endif
+  solver->level++;
+  unsigned decision;
+  if (assumption != INVALID)
+    {
+      LOG ("assumption decision %s", LOGLIT (assumption));
+      solver->assumption_level = solver->level;
+      decision = assumption;
+#ifdef DLIS
+      // Keep one entry per decision level on both DLIS stacks.
+      const int irred_sat_upto = EMPTY_STACK (solver->irred_sat_upto) ?
+	0 : TOP (solver->irred_sat_upto);
+      const int red_sat_upto = EMPTY_STACK (solver->red_sat_upto) ?
+	0 : TOP (solver->red_sat_upto);
+      PUSH (solver->irred_sat_upto, irred_sat_upto);
+      PUSH (solver->red_sat_upto, red_sat_upto);
+#endif
+    }
+  else
+    decision = decide_literal (solver);
+  assign (solver, decision, 0, false);
+  STOP_IF_NCHEAP (decide);
+  return 0;
+}
+
+/*------------------------------------------------------------------------*/
+
+// Report verbose message lines listing the following statistics. We use the
+// same trick as for signal handlers in 'main.c' and for profiles above of
+// listing all different reported statistics as 'REPORT' item in 'REPORTS'.
+// Then we redefine 'REPORT' to instantiate 'REPORTS' accordingly.
+
+// *INDENT-OFF*
+
+#define REPORTS \
+REPORT(seconds, "%.2f") \
+REPORT(MB, "%.0f") \
+REPORT(level, "%.0f") \
+REPORT_IF_SWITCH(switched, "%" PRIu64) \
+REPORT_IF_REDUCE(reductions, "%" PRIu64) \
+REPORT_IF_RESTART(restarts, "%" PRIu64) \
+REPORT(rate, "%.0f") \
+REPORT(conflicts, "%" PRIu64) \
+REPORT_IF_LEARN(redundant, "%" PRIu64) \
+REPORT(trail, "%.0f%%") \
+REPORT(glue, "%.0f") \
+REPORT(irredundant, "%" PRIu64) \
+REPORT(variables, "%" PRIu64) \
+REPORT(remaining, "%.0f%%")
+
+// Need to exclude 'restart' and 'reduce' reports if disabled.
+
+#define DO_NO_REPORT(A,B) /**/
+
+#ifdef NSWITCH
+#define REPORT_IF_SWITCH DO_NO_REPORT
+#else
+#define REPORT_IF_SWITCH REPORT
+#endif
+
+#ifdef NLEARN
+#define REPORT_IF_LEARN DO_NO_REPORT
+#else
+#define REPORT_IF_LEARN REPORT
+#endif
+
+#ifdef NRESTART
+#define REPORT_IF_RESTART DO_NO_REPORT
+#else
+#define REPORT_IF_RESTART REPORT
+#endif
+
+#ifdef NREDUCE
+#define REPORT_IF_REDUCE DO_NO_REPORT
+#else
+#define REPORT_IF_REDUCE REPORT
+#endif
+
+#define MAX_HEADER      3	// Number of header lines.
+#define MAX_LINE        256	// Maximum expected line length.
+#define MAX_REPORTS     16	// Maximum number of reported values.
+
+// *INDENT-ON*
+
+static void
+report (struct satch *solver, unsigned verbose, int type)
+{
+  if (solver->options.verbose < verbose)
+    return;
+
+  INC (reported);
+
+  // If you want to print a certain statistic you need to add a line to the
+  // 'REPORTS' macro above and also define a matching local constant here.
+
+  struct averages *a = averages (solver);
+  const double seconds = process_time ();
+  const double MB = current_resident_set_size () / (double) (1 << 20);
+  const double level = unbiased_slow_average (a, a->conflict_level);
+#ifndef NSWITCH
+  const uint64_t switched = solver->statistics.switched;
+#endif
+#ifndef NREDUCE
+  const uint64_t reductions = solver->statistics.reductions;
+#endif
+#ifndef NRESTART
+  const uint64_t restarts = solver->statistics.restarts;
+#endif
+  const double rate = unbiased_slow_average (a, a->decision_rate);
+  const uint64_t conflicts = CONFLICTS;
+#ifndef NLEARN
+  const uint64_t redundant = solver->statistics.redundant;
+#endif
+  const double trail = unbiased_slow_average (a, a->trail_filled);
+  const double glue = unbiased_slow_average (a, a->slow_glue);
+  const uint64_t irredundant = solver->statistics.irredundant;
+  const uint64_t variables = solver->statistics.remaining;
+  double remaining = percent (variables, solver->statistics.variables);
+
+  // Start formatting the values in 'line'.
+
+  int num_reported = 0;		// Number of reported values.
+
+  int column[MAX_REPORTS];	// Save start of columns to format headers.
+  char line[MAX_LINE];		// Actual line of values printed.
+  int end_line = 0;		// End of the value line.
+
+  line[end_line++] = 'c';
+
+  // The values line has the following two characters less space than the
+  // header lines which makes some room for the first header to stick out to
+  // the left (this is also necessary for the usual 'seconds' header).
+
+  line[end_line++] = ' ';
+  line[end_line++] = type;
+
+  // Print values to 'line' remembering starting positions and widths.
+
+// *INDENT-OFF*
+
+#define REPORT(NAME,FMT) \
+  { \
+    assert (end_line < MAX_LINE); \
+    line[end_line++] = ' '; \
+    column[num_reported++] = end_line; \
+    char buffer[32]; \
+    sprintf (buffer, FMT, NAME); \
+    for (const char * p = buffer; *p; p++) \
+      assert (end_line < MAX_LINE), \
+      line[end_line++] = *p; \
+  }
+  REPORTS
+#undef REPORT
+
+// *INDENT-ON*
+
+  // Initially and after 16 rows without printing a header we print one.
+  // This gives 20 rows with 3 header lines (and one empty line) which
+  // perfectly matches typical (classical small) terminal height of 24.
+
+  COLORS (1);
+
+  if ((solver->statistics.reported % 16) == 1)
+    {
+      char header[MAX_HEADER][MAX_LINE];
+      int end_header[MAX_HEADER];
+
+      for (int i = 0; i < MAX_HEADER; i++)
+	{
+	  header[i][0] = 'c';
+	  end_header[i] = 1;
+	}
+
+      int reported = 0;
+
+      // This is the really tricky part to get a nicely adjusted header for
+      // the columns of values which vary in size.  The goal is to keep the
+      // column names in the middle above the values split in different
+      // header rows so that they do not overlap.  It becomes even more
+      // complicated due to the possibility that strings for header names
+      // can be smaller or larger than the value strings.
+
+// *INDENT-OFF*
+
+#define REPORT(NAME, FMT) \
+      { \
+        const int row = reported % MAX_HEADER; \
+        assert (end_header[row] < MAX_LINE); \
+        header[row][end_header[row]++] = ' '; \
+        assert (reported < num_reported); \
+        const int start = column[reported++]; \
+        const int end = \
+          (reported == num_reported ? end_line : column[reported]); \
+        const int value_width = end - start - 1; \
+        const int name_width = strlen (#NAME); \
+        int target; \
+        if (name_width > value_width) \
+          target = start - (name_width - value_width + 1)/2; \
+        else \
+          target = start + (value_width - name_width + 1)/2; \
+        assert (target <= MAX_LINE); \
+        while (end_header[row] < target) \
+          { \
+            assert (end_header[row] < MAX_LINE); \
+            header[row][end_header[row]++] = ' '; \
+          } \
+        for (const char * p = #NAME; *p; p++) \
+          { \
+            assert (end_header[row] < MAX_LINE); \
+            header[row][end_header[row]++] = *p; \
+          } \
+      }
+      REPORTS
+#undef REPORT
+
+// *INDENT-ON*
+
+      fputs ("c\n", stdout);
+
+      // Print the header lines.
+
+      for (int i = 0; i < MAX_HEADER; i++)
+	{
+	  fputc ('c', stdout);
+	  COLOR (YELLOW);
+	  for (int j = 1; j < end_header[i]; j++)
+	    fputc (header[i][j], stdout);
+	  COLOR (NORMAL);
+	  fputc ('\n', stdout);
+	}
+
+      fputs ("c\n", stdout);
+    }
+
+  // Print the values line.
+
+  fputs ("c ", stdout);
+
+#ifndef NCOLOR
+  bool reset = false;
+  if (colors)
+    {
+      bool magenta = false;
+
+      switch (type)
+	{
+	case '0':
+	case '1':
+	case '?':
+	case 'i':
+	  fputs (BOLD_CODE, stdout);
+	  reset = true;
+	  break;
+	case 's':
+	  fputs (GREEN_CODE, stdout);
+	  reset = true;
+	  break;
+	case 'e':
+	case 'p':
+	  fputs (BOLD_GREEN_CODE, stdout);
+	  reset = true;
+	  break;
+	case '[':
+	case ']':
+	  fputs (MAGENTA_CODE, stdout);
+	  magenta = true;
+	  break;
+	}
+
+      assert (line[2] == type);
+      fputc (line[2], stdout);
+
+      if (reset)
+	fputs (NORMAL_CODE, stdout);
+
+      if (magenta)
+	reset = true;
+      else if (solver->stable)
+	{
+	  fputs (MAGENTA_CODE, stdout);
+	  reset = true;
+	}
+    }
+  else
+#endif
+    fputc (line[2], stdout);
+
+  for (int i = 3; i < end_line; i++)
+    fputc (line[i], stdout);
+#ifndef NCOLOR
+  if (reset)
+    fputs (NORMAL_CODE, stdout);
+#endif
+  fputc ('\n', stdout);
+
+  fflush (stdout);
+}
+
+/*------------------------------------------------------------------------*/
+
+// Report statistics after a unit clause has been learned and propagated.
+
+// The reason for not reporting a unit immediately, when it is learned in
+// 'analyze' above, is that such a learned root-level unit often implies
+// many other literals on the root-level too and we prefer to see this
+// effect of learning the unit instead of when exactly it was learned.
+
+static void
+iterate (struct satch *solver)
+{
+  report (solver, 1, 'i');
+  solver->iterate = false;
+}
+
+/*------------------------------------------------------------------------*/
+
+// The ticks and time limits are relative to the start of each call.
+
+static void
+start_terminate (struct satch *solver)
+{
+  struct terminate *const terminate = &solver->terminate;
+  terminate->forced = false;
+  terminate->delay = 0;
+  if (terminate->ticks < 0)
+    terminate->limit = UINT64_MAX;
+  else
+    terminate->limit = total_ticks (solver) + terminate->ticks;
+  if (terminate->seconds < 0)
+    terminate->deadline = -1;
+  else
+    terminate->deadline = wall_clock_time () + terminate->seconds;
+}
+
+static bool
+force_termination (struct satch *solver, const char *reason)
+{
+  message (solver, 1, "terminate", solver->statistics.solved,
+	   "%s after %" PRIu64 " conflicts", reason, CONFLICTS);
+  solver->terminate.forced = true;
+  return true;
+}
+
+// Checked in the main search loop as well as in elimination and
+// vivification rounds, which thus can be interrupted too.
+
+static bool
+terminating (struct satch *solver)
+{
+  struct terminate *const terminate = &solver->terminate;
+  if (terminate->forced)
+    return true;
+  if (total_ticks (solver) >= terminate->limit)
+    return force_termination (solver, "ticks limit hit");
+  if (terminate->delay)
+    {
+      terminate->delay--;
+      return false;
+    }
+  terminate->delay = terminate_delay;
+  if (terminate->function && terminate->function (terminate->state))
+    return force_termination (solver, "forced by terminate call-back");
+  if (terminate->deadline >= 0 && wall_clock_time () >= terminate->deadline)
+    return force_termination (solver, "time limit hit");
+  return false;
+}
+
+/*------------------------------------------------------------------------*/
+
+// Functions used for scaling conflict and ticks intervals.
+
+#ifndef NRESTART
+
+static double
+logn (uint64_t n)
+{
+  assert (n);
+  const double res = log10 (n + 9);
+  assert (res >= 1);
+  return res;
+}
 
-// Previously computed results are cached in mark flags. Root-level
-// assigned literals are ignored.  The function aborts negatively if a
-// decision variable is reached which has not been marked as being in the
-// clause before (marked 'REMOVABLE') or the decision level of the literal
-// is not in the learned clause.
+#endif
 
-static int
-minimize_literal (struct satch *solver, unsigned lit, unsigned depth)
+#if (!defined(NELIMINATION)) && !defined(NINPROCESSING)
+
+static double
+nlognlogn (uint64_t n)
 {
-  const unsigned idx = INDEX (lit);
-  signed char mark = solver->marks[idx];
-  assert (mark >= 0);
-  if (mark & POISONED)
-    return POISONED;		// Previously shown not to be removable.
-  if (mark & REMOVABLE)
-    return REMOVABLE;		// Previously shown to be removable.
-  if (depth && (mark & ANALYZED))
-    return REMOVABLE;		// Analyzed thus removable (unless start).
-  const unsigned level = solver->levels[idx];
-  if (!level)
-    return REMOVABLE;		// Root-level units can be removed.
-  if (depth > minimize_depth)
-    return POISONED;		// Avoids deep recursion (stack overflow).
-#ifndef NCONTROL
-  if (!depth && ACCESS (solver->control, level - 1).seen.count < 2)
-    return POISONED;
-  if (solver->position[idx] <=
-      ACCESS (solver->control, level - 1).seen.earliest)
-    return POISONED;
+  assert (n);
+  const double tmp = log10 (n + 9);
+  assert (tmp >= 1);
+  const double res = n * tmp * tmp;
+  assert (res >= 1);
+  return res;
+}
 #endif
-  assert (solver->values[lit] < 0);
-  struct clause *reason = solver->reasons[idx];
-  if (!reason)
-    return POISONED;		// Decisions can not be removed.
-  if (!solver->frames[level])
-    return POISONED;		// Level not pulled into clause.
-  int res = REMOVABLE;
-#ifndef NBLOCK
-  if (is_tagged_clause (reason))
-    reason = untag_clause (solver, 0, NOT (lit), reason);
+
+#ifndef NVIVIFICATION
+static double
+nlogn (uint64_t n)
+{
+  assert (n);
+  const double tmp = log10 (n + 9);
+  assert (tmp >= 1);
+  const double res = n * tmp;
+  assert (res >= 1);
+  return res;
+}
+
+#endif
+
+#ifndef NREPHASE
+
+static double
+nlognlognlogn (uint64_t n)
+{
+  assert (n);
+  const double tmp = log10 (n + 9);
+  assert (tmp >= 1);
+  const double res = n * tmp * tmp * tmp;
+  assert (res >= 1);
+  return res;
+}
+
+#endif
+
+#ifndef NREDUCE
+
+static double
+ndivlogn (uint64_t n)
+{
+  assert (n);
+  const double div = log10 (n + 9);
+  assert (div > 0);
+  const double res = n / div;
+  assert (res >= 1);
+  return res;
+}
+
+#endif
+
+#ifndef NSWITCH
+
+static double
+quadratic (uint64_t n)
+{
+  assert (n);
+  const double res = n * n;
+  assert (res >= 1);
+  return res;
+}
+
+#endif
+
+#if (defined(NELIMINATION) || defined(NINPROCESSING)) && defined (NVIVIFICATION)
+#ifdef NREDUCE
+#ifdef NREPHASE
+#ifdef NSWITCH
+#define NSCALE
+#endif
+#endif
+#endif
+#endif
+
+#ifndef NSCALE
+
+// Use one of the above scaling functions to scale the base interval based
+// on the number of counts given as last argument.  For instance if you want
+// to set the conflict limit for the next clause reduction in 'reduce',
+// which was just was executed 'count' times, then for scaling the 'base'
+// interval between 'reduce' quadratically you would  use 'quadratic' as
+// argument for 'scale' (and 'base' and 'count' as further arguments).
+
+static double
+scale_interval (uint64_t base, double (*scale) (uint64_t), uint64_t count)
+{
+  assert (count > 0);
+  double scaling = scale (count);
+  assert (scaling >= 1);
+  double res = base * scaling;
+  assert (res >= 1);
+  return res;
+}
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
+// Before restarting we can figure out the maximum number of decisions that
+// will be picked in the same way as they are currently picked.  If we find
+// such a non-empty decision prefix of the trail we can reuse it and will
+// not backtrack over it.  This is the strongest version of reusing the
+// trail using the 'matching trail level' (MTL).  For weaker versions, both
+// the 'permutation' (PTL) and 'reuse' trail level (RTL), we got worse
+// results.  Thus we use the strongest one in contrast to previous solvers.
+
+#ifndef NREUSE
+
+#ifndef NVMTF
+
+// Decisions are picked based on the enqueue time stamp.
+
+static unsigned
+reuse_stamped_trail (struct satch *solver)
+{
+#ifndef NCHRONO
+  return reuse_stamped_trail_from (solver, 1);
+#else
+  unsigned next = max_stamped_unassigned_variable_on_decision_queue (solver);
+  const struct link *const links = solver->queue[solver->stable].links;
+  const unsigned next_stamp = links[next].stamp;
+  unsigned decision_stamp = UINT_MAX;
+  for (all_elements_on_stack (unsigned, lit, solver->trail))
+    {
+      const unsigned idx = INDEX (lit);
+      const unsigned stamp = links[idx].stamp;
+      if (decision_stamp < stamp || stamp < next_stamp)
+	return LEVEL (idx) - 1;
+      if (!REASON (idx))
+	decision_stamp = stamp;
+    }
+  return solver->level;
+#endif
+}
+
+#endif
+
+#ifndef NVSIDS
+
+// Decisions are picked based on their EVSIDS score.
+
+static unsigned
+reuse_scored_trail (struct satch *solver)
+{
+#ifndef NCHRONO
+  return reuse_scored_trail_from (solver, 1);
+#else
+  unsigned next = max_score_unassigned_variable_on_binary_heap (solver);
+  const SCORE_TYPE *const scores = solver->scores[solver->stable].score;
+  const double next_score = scores[next];
+  double decision_score = MAX_SCORE;
+  for (all_elements_on_stack (unsigned, lit, solver->trail))
+    {
+      const unsigned idx = INDEX (lit);
+      const double score = scores[idx];
+      if (decision_score < score || score < next_score)
+	return LEVEL (idx) - 1;
+      if (!REASON (idx))
+	decision_score = score;
+    }
+  return solver->level;
+#endif
+}
+
+#endif
+
+// The logic of which decision heuristic to use is complex and hidden in
+// this function (which needs to have the same cases as 'decide_variable').
+
+static unsigned
+reuse_trail (struct satch *solver)
+{
+  unsigned res;
+
+  assert (solver->level);
+  assert (!EMPTY_STACK (solver->trail));
+  assert (LEVEL (INDEX (ACCESS (solver->trail, 0))));
+
+#if defined(NVMTF) && defined(NVSIDS)
+  res = 0;
+#else
+#ifdef NREUSESTABLE
+  if (solver->stable)
+    res = 0;
   else
 #endif
-    INC (ticks);
-  const unsigned not_lit = NOT (lit);
-  LOGCLS (reason, "trying to minimize %s at depth %u along",
-	  LOGLIT (not_lit), depth);
-  for (all_literals_in_clause (other, reason))
     {
-      if (other == not_lit)
-	continue;
-      if (minimize_literal (solver, other, depth + 1) == REMOVABLE)
-	continue;
-      res = POISONED;
-      break;
+#if defined(NHEAP)
+      res = reuse_stamped_trail (solver);
+#elif defined(NQUEUE)
+      res = reuse_scored_trail (solver);
+#else
+      if (solver->stable)
+	res = reuse_scored_trail (solver);
+      else
+	res = reuse_stamped_trail (solver);
+#endif
     }
-  if (depth)
+#endif
+
+  if (res)
     {
-      if (res == REMOVABLE)
-	mark_removable (solver, idx);
-      else
-	mark_poisoned (solver, idx);
+      message (solver, 4, "restart", solver->statistics.restarts,
+	       "reusing trail up-to level %u out of %u levels %.0f%%",
+	       res, solver->level, percent (res, solver->level));
+      INC (reused);
     }
-  LOG ("%s %s at depth %u",
-       (res == REMOVABLE ? "removable" : "poisoned"), LOGLIT (lit), depth);
+  else
+    LOG ("trail not reused");
+
   return res;
 }
 
-#ifdef NSHRINK
+#endif
 
-// Minimize the deduced first unique implication point (1st UIP) clause.
+/*------------------------------------------------------------------------*/
 
-// By default ('NSHRINK' undefined) we employ all-UIP shrinking though which
-// minimizes (in 'minimize_block') each block of literals in the learned
-// clause with the same decision level in the deduced clause separately
-// after shrinking unless shrinking was able to replace the whole block by a
-// single literal.  Thus with shrinking this function becomes obsolete.
+// Restarts are in principle triggered by restart intervals (measured in the
+// number of conflicts passed).  However in focused mode we use exponential
+// moving averages of the glucose level (glue) of learned clauses to
+// determine whether we are in a phase where those levels go down or
+// increase.  If the glue goes down we do not restart but if it goes up,
+// that is the fast moving average is above a certain margin over the slower
+// moving average, then we restart.
 
-static void
-minimize_deduced_clause (struct satch *solver)
-{
-  assert (EMPTY_STACK (solver->poisoned));
-  assert (EMPTY_STACK (solver->removable));
+#ifndef NRESTART
 
-  unsigned *const end = solver->clause.end;
-  unsigned *const begin = solver->clause.begin;
-  for (unsigned *p = end - 1; p != begin; p--)
-    if (minimize_literal (solver, *p, 0) == REMOVABLE)
-      *p = INVALID;
+static bool
+restarting (struct satch *solver)
+{
+  assert (solver->unassigned);
+  assert (!solver->inconsistent);
 
-  unsigned *q = begin, lit;
-  for (const unsigned *p = q; p != end; p++)
-    if ((lit = *p) != INVALID)
-      *q++ = lit;
+  if (!solver->level)
+    return false;
+  if (solver->limits.restart > CONFLICTS)
+    return false;
 
-  const size_t minimized = end - q;
-  solver->clause.end = q;
+#ifndef NSTABLE
 
-  LOG ("minimized %zu literals", minimized);
-  ADD (minimized, minimized);
+  // Use only (large) conflict intervals in stable mode to trigger restarts.
+  // However during computing the next restart limit below we use reluctant
+  // doubling of the base restart interval (also called 'Luby' scheme).
 
-  LOGTMP ("minimized");
-}
+  if (solver->stable)
+    return true;
 
 #endif
 
-// Reset the 'POISONED' and 'REMOVABLE' flags set during minimization.
+  struct averages *a = averages (solver);
+
+  const double fast = unbiased_fast_average (a, a->fast_glue);
+  const double slow = unbiased_slow_average (a, a->slow_glue);
+  const double limit = restart_margin * slow;
+
+  return limit <= fast;
+}
 
 static void
-reset_removable_and_poisoned (struct satch *solver)
+restart (struct satch *solver)
 {
-  for (all_elements_on_stack (unsigned, idx, solver->poisoned))
-      solver->marks[idx] &= ~POISONED;
-  CLEAR_STACK (solver->poisoned);
+  BEGIN_EVENT (restart);
+  const uint64_t restarts = INC (restarts);
+  message (solver, 4, "restart", restarts,
+	   "restarting after %" PRIu64 " conflicts (limit %" PRIu64 ")",
+	   CONFLICTS, solver->limits.restart);
+  report (solver, 3, 'r');
 
-  for (all_elements_on_stack (unsigned, idx, solver->removable))
-      solver->marks[idx] &= ~REMOVABLE;
-  CLEAR_STACK (solver->removable);
+#ifndef NTARGET
+  if (solver->stable)
+    update_phases (solver);
+#endif
+
+#ifndef NREUSE
+  {
+    unsigned new_level = reuse_trail (solver);
+    if (new_level < solver->level)
+      backtrack (solver, new_level);
+  }
+#else
+  backtrack (solver, 0);
+#endif
+
+  uint64_t interval;
+#ifndef NSTABLE
+  if (solver->stable)
+    {
+      // This is the approach of Donald Knuth to compute the 'reluctant
+      // doubling' sequence. In other solvers it is called 'Luby' sequence.
+      // We further use a much longer base interval than in focused mode.
+
+      struct reluctant *r = &solver->reluctant;
+      uint64_t u = r->u, v = r->v;
+
+      // The base interval is multiplied with the reluctant doubling
+      // sequence number (1,2,1,1,2,4,1,1,2,4,8,1,1,2,1,1,2,4,1,1,...).
+
+      interval = v * stable_restart_interval;
+
+      if ((u & -u) == v)
+	u++, v = 1;
+      else
+	assert (UINT64_MAX / 2 >= v), v *= 2;
+      r->u = u, r->v = v;
+    }
+  else
+#endif
+    {
+      assert (restart_interval >= 1);
+      interval = (restart_interval - 1) + logn (restarts);
+      assert (restart_interval <= interval);
+    }
+
+  solver->limits.restart = CONFLICTS + interval;
+
+  message (solver, 4, "restart", restarts,
+	   "new %s restart limit %" PRIu64 " after %" PRIu64 " conflicts",
+	   solver->stable ? "stable" : "focused",
+	   solver->limits.restart, interval);
+  END_EVENT (restart);
 }
 
 #endif
 
 /*------------------------------------------------------------------------*/
 
-// Mark a literal as 'ANALYZED' if it has not been visited yet during
-// conflict analysis (or during reason-side-bumping).  Since the 'analyze'
-// function below needs the assignment level of the literal to mark decision
-// levels and decide whether the literal is added to the learned clause we
-// use that level as return value or 'INVALID' as result if the literal has
-// been marked before (or has been assigned on the root-level zero).
+// Rephasing is the process of resetting the saved phases of the solver in
+// increasing intervals.  It can be seen as a diversification method with
+// respect to the selected phases (since phase saving might be considered
+// to be too stubborn).  However, in combination with reusing best-phases
+// and particularly target-phases it has more an intensification flavor.
 
-static void
-mark_analyzed (struct satch *solver, unsigned idx)
+// In the past, we experimented with many variants on how to reset phases
+// and now reached the following set-up, which seems to give consistent
+// improvements. First it seems that rephasing is only beneficial in stable
+// mode. Second we only reset to the original, the inverted-original or the
+// best-phase seen. Third we schedule rephasing slightly more frequently than
+// mode switching, such that for instance initially maybe the phases are
+// reset twice in one stable mode interval and then this number increases
+// slowly in later stable mode intervals.
+
+// At this point we do not have local search rephasing incorporated yet
+// which we do consider to give benefits.  It is also not combined with
+// autarky simplification either which allows to save partial satisfying
+// assignments. Both are implemented in Kissat and need to be ported.
+
+#ifndef NREPHASE
+
+static bool
+rephasing (struct satch *solver)
 {
-  assert (!(solver->marks[idx] & ANALYZED));
-  solver->marks[idx] |= ANALYZED;
-  struct analyzed analyzed;
-  analyzed.idx = idx;
-#ifndef NSORTANALYZED
-  analyzed.stamp = INVALID;
-#endif
-  PUSH (solver->analyzed, analyzed);
-  LOG ("analyzed %s", LOGVAR (idx));
+  if (!solver->stable)
+    return false;
+  return solver->limits.rephase <= CONFLICTS;
 }
 
-static inline unsigned
-analyze_literal (struct satch *solver, unsigned lit)
+static char
+original_phases (struct satch *solver)
 {
-  const unsigned idx = INDEX (lit);
-  const unsigned lit_level = solver->levels[idx];
-  if (!lit_level)
-    return INVALID;
-  if (solver->marks[idx])
-    return INVALID;
-  mark_analyzed (solver, idx);
-  return lit_level;
+  const signed char value = original_phase (solver);
+  memset (solver->saved, value, VARIABLES);
+  return 'O';
 }
 
-/*------------------------------------------------------------------------*/
+#ifndef NINVERTED
 
-// More thorough shrinking than classical clause minimization by trying to
-// find unique implication points on all previous decision levels without
-// introducing new decision levels into the learned clause.
+static char
+inverted_phases (struct satch *solver)
+{
+  const signed char value = -original_phase (solver);
+  memset (solver->saved, value, VARIABLES);
+  return 'I';
+}
 
-#ifndef NSHRINK
+#endif
+
+#ifndef NBEST
+
+static char
+best_phases (struct satch *solver)
+{
+  const signed char *const bests = solver->bests;
+  const signed char *const end = bests + VARIABLES;
+  signed char *const saved = solver->saved;
+  signed char *q = saved, tmp;
+  for (const signed char *p = bests; p != end; p++, q++)
+    if ((tmp = *p))
+      *q = tmp;
+  solver->best = 0;
+  return 'B';
+}
+
+#endif
+
+static void
+rephase (struct satch *solver)
+{
+  BEGIN_EVENT (rephase);
+  char (*functions[4]) (struct satch *);
+  unsigned size_functions = 0;
+
+#ifndef NINVERTED
+  functions[size_functions++] = inverted_phases;
+#ifndef NBEST
+  functions[size_functions++] = best_phases;
+#endif
+#endif
+  functions[size_functions++] = original_phases;
+#ifndef NBEST
+  functions[size_functions++] = best_phases;
+#endif
+  assert (size_functions <= sizeof functions / sizeof *functions);
+
+  const uint64_t rephased = INC (rephased);
+  const char type = functions[rephased % size_functions] (solver);
+
+  const uint64_t interval =
+    scale_interval (rephase_interval, nlognlognlogn, rephased);
+  solver->limits.rephase = CONFLICTS + interval;
+  message (solver, 4, "rephase", rephased,
+	   "new rephase limit %" PRIu64 " conflicts after %" PRIu64,
+	   solver->limits.rephase, interval);
+#ifndef NTARGET
+  if (solver->stable)
+    {
+      LOG ("reset target size");
+      memcpy (solver->targets, solver->saved, VARIABLES);
+      solver->target = 0;
+    }
+#endif
+  report (solver, 1, type);
+  END_EVENT (rephase);
+}
 
-// Mark-bit different from 'ANALYZED', 'REMOVABLE', and 'POISONED'.
+#endif
 
-#define SHRUNKEN 8
+/*------------------------------------------------------------------------*/
 
-static void
-mark_shrunken (struct satch *solver, unsigned idx)
-{
-  assert (!(solver->marks[idx] & SHRUNKEN));
-  solver->marks[idx] |= SHRUNKEN;
-  PUSH (solver->shrunken, idx);
-  LOG ("shrunken %s", LOGVAR (idx));
-}
+// Reducing the clause data base by removing useless redundant clauses is
+// important to keep the memory usage of the solver low, but also to
+// speed-up propagation.  The reduction interval in terms of conflicts is
+// increased (almost) arithmetically by 'reduce_interval'.  We combine
+// reductions with clause data base simplifications which remove root-level
+// satisfied clauses.  Removing falsified literals is not implemented yet.
 
-// Reset literals marked 'SHRUNKEN' in any case (successful or unsuccessful).
+#ifndef NREDUCE
 
-static void
-reset_shrunken (struct satch *solver)
+static bool
+reducing (struct satch *solver)
 {
-  LOG ("resetting %zu shrunken variables", SIZE_STACK (solver->shrunken));
-  signed char *marks = solver->marks;
-  for (all_elements_on_stack (unsigned, idx, solver->shrunken))
-      marks[idx] &= ~SHRUNKEN;
-  CLEAR_STACK (solver->shrunken);
+  return solver->limits.reduce.conflicts <= CONFLICTS;
 }
 
-// Positive case: literals can be shrunken to one unique implication point.
+// Protect reason clauses from garbage collection. The same function can
+// be used afterwards to make reason clauses unprotected again.  It is
+// better to lazily protect clauses during reductions instead of eagerly
+// setting the 'protect' bit during assignments to avoid dereferencing
+// pointers to binary clause reasons (if 'NBLOCK' is defined).
 
 static void
-mark_shrunken_as_removable (struct satch *solver)
+set_protect_flag_of_reasons (struct satch *solver, bool protect)
 {
-  signed char *marks = solver->marks;
-  for (all_elements_on_stack (unsigned, idx, solver->shrunken))
-    if (!(marks[idx] & REMOVABLE))
-        mark_removable (solver, idx);
+  for (all_elements_on_stack (unsigned, lit, solver->trail))
+    {
+      const unsigned idx = INDEX (lit);
+      struct clause *reason = REASON (idx);
+      if (!reason)
+	continue;
+#ifndef NBLOCK
+      if (is_tagged_clause (reason))
+	continue;
+#endif
+      LOGCLS (reason, "%sprotecting", protect ? "" : "un");
+      assert (reason->protected != protect);
+      reason->protected = protect;
+    }
 }
 
-// Return '0' if literal is removable or has already been shrunken. Return
-// '-1' if it can definitely not be shrunken, and '1' if it can in principle
-// be shrunken and thus has been marked as such.
-
-// The encoding of these result values has the idea that it matches the
-// number of new additionally marked literals by which 'open' is increased
-// in 'shrink_block' except that if '-1' is returned the search is aborted.
-
-// On lower decision level than the given level of the considered block we
-// use 'minimize_literal' which tries to resolve the literal away based on
-// other literals already in the (partially) minimized and shrunken clause.
+#endif
 
-static int
-shrink_literal (struct satch *solver, unsigned block_level, unsigned lit)
-{
-  const unsigned idx = INDEX (lit);
-  const unsigned lit_level = solver->levels[idx];
-  if (!lit_level)
-    return 0;
-  if (solver->marks[idx] & SHRUNKEN)
-    return 0;
-  if (lit_level < block_level)
-    return (minimize_literal (solver, lit, 1) == REMOVABLE) ? 0 : -1;
-  mark_shrunken (solver, idx);
-  return 1;
-}
+#if !defined(NREDUCE) || !defined(NELIMINATION)
 
-// In case 'shrink_block' is successful it calls this function and shrinks
-// the literals in the clause from 'begin' to 'end' to the given unique
-// implication point and further resets the shrunken literals.
+// Check whether a clause is root-level satisfied, i.e., it contains a
+// literal which is assigned to true on decision-level zero.  Otherwise
+// flush (at least) virtually all root-level falsified literals.  The latter
+// is important for marking flushed literals as new subsume candidates.
 
-static void
-shrunken_block (struct satch *solver,
-		unsigned *begin, unsigned *end, unsigned uip)
+static bool
+clause_satisfied (struct satch *solver, struct clause *c)
 {
-  for (unsigned *p = begin; p != end; p++)
-    *p = INVALID;
-  *begin = NOT (uip);
-  const unsigned idx = INDEX (uip);
-  if (!(solver->marks[idx] & ANALYZED))
-    mark_analyzed (solver, idx);
-#ifndef NCONTROL
-  const unsigned level = solver->levels[idx];
-  if (level != 0)
-    {
-      struct level *saved = &ACCESS (solver->control, level - 1);
-      if (saved->seen.earliest > solver->position[idx])
-	saved->seen.earliest = solver->position[idx];
-      ++saved->seen.count;
-      LOG ("updating level %d with: %d %d", level, saved->seen.earliest,
-	   saved->seen.count);
-    }
+  assert (!solver->level);
+#ifndef NVIRTUAL
+  assert (!is_tagged_clause (c));
+  assert (!is_temporary_binary (solver, c));
+  assert (!c->protected);
 #endif
-  mark_shrunken_as_removable (solver);
-  reset_shrunken (solver);
-}
 
-// Get start of the level-block ending right before 'end' in the temporary
-// clause which is assumed to be sorted by decreasing decision levels.
+  const signed char *const values = solver->values;
+  unsigned num_false = 0;
 
-static unsigned *
-next_block (struct satch *solver, unsigned *end)
-{
-  const unsigned *const levels = solver->levels;
-  unsigned block_level = INVALID;
-  unsigned *begin = end;
-  while (solver->clause.begin < begin)
+  for (all_literals_in_clause (lit, c))
     {
-      const unsigned lit = begin[-1];
-      const unsigned idx = INDEX (lit);
-      const unsigned lit_level = levels[idx];
-      if (lit_level > block_level)
-	break;
-      block_level = lit_level;
-      begin--;
+      const signed char value = values[lit];
+      if (value > 0)
+	return true;
+      if (value < 0)
+	num_false++;
     }
-  return begin;
-}
 
-// Find a first unique implication point of the given block of literals with
-// the same decision level in the deduced clause.
+  if (!num_false)
+    return false;
 
-static bool
-shrink_block (struct satch *solver, unsigned *begin, unsigned *end)
-{
-  assert (begin < end);
-  unsigned open = end - begin;
-  if (open < 2)
-    return true;		// Already shrunken so avoid 'minimize_block'.
+  LOGCLS (c, "found %u root-level falsified in", num_false);
 
-  const unsigned block_level = solver->levels[INDEX (*begin)];
-  LOG ("trying to shrink block of size %u at level %u", open, block_level);
+  assert (EMPTY_STACK (solver->clause));
+  for (all_literals_in_clause (lit, c))
+    if (!values[lit])
+      PUSH (solver->clause, lit);
 
-  // First mark all literals in the block as 'SHRUNKEN' and also compute
-  // the maximum trail position of the literals in this block.
+#ifndef NSUBSUMPTION
+  for (all_elements_on_stack (unsigned, lit, solver->clause))
+      mark_subsume_literal (solver, lit);
+#endif
 
-  unsigned trail = 0;
-  {
-    const unsigned *const position = solver->position;
-    assert (EMPTY_STACK (solver->shrunken));
-    for (unsigned *p = begin; p != end; p++)
-      {
-	const unsigned lit = *p;
-	const unsigned idx = INDEX (lit);
-	mark_shrunken (solver, idx);
+  if (!solver->dense)
+    {
+      trace_and_check_temporary_addition (solver);
+      trace_and_check_clause_deletion (solver, c);
 
-	const unsigned pos = position[idx];
-	assert (solver->trail.begin[pos] == NOT (lit));
-	if (pos > trail)
-	  trail = pos;
-      }
-    assert (SIZE_STACK (solver->shrunken) == open);
-  }
+#ifndef NWATCHES
+      const unsigned *old_lits = c->literals;
+      const unsigned *new_lits = solver->clause.begin;
 
-  // Now we can start traversing the trail for this block going backward
-  // from the last its literal on the trail.  This traversal follows a
-  // topological order, i.e., an inverse assignment order, and is similar to
-  // the trail traversal in 'analyze' which deduces the learned clause in
-  // the first place.  This order allows us to properly maintain 'open', the
-  // number of literals marked 'SHRUNKEN' and not yet resolved.  If this
-  // number drops to one we have found a unique implication point for this
-  // block.  An alternative to this linear traversal along the trail is
-  // to use a binary heap (we actually tried a radix heap) or some clever
-  // depth first search. The latter however would need to be aborted early
-  // if a literal can not be shrunken and probably is more complicated.
+      // Unwatching might break code where we traverse watchers, which is
+      // currently only the case when called in dense mode from
+      // 'actual_number_of_occurrences' and thus not reached.
 
-  const unsigned *t = solver->trail.begin + trail;
-  unsigned uip = INVALID;
-  bool failed = false;
+      unwatch_literal (solver, old_lits[0], c);
+      unwatch_literal (solver, old_lits[1], c);
+#else
+      for (all_literals_in_clause (lit, c))
+	disconnect_literal (solver, lit, c);
+#endif
 
-  const signed char *const marks = solver->marks;
-  struct clause *const *const reasons = solver->reasons;
+      const size_t size = SIZE_STACK (solver->clause);
+      assert (size == c->size - num_false);
+      assert (size >= 2);
 
-  while (!failed)
-    {
-      unsigned idx;
-      do
-	assert (t >= solver->trail.begin), uip = *t--;
-      while (!(marks[idx = INDEX (uip)] & SHRUNKEN));
-      if (!--open)
-	break;
-      struct clause *reason = reasons[idx];
-      assert (reason);
-#ifndef NBLOCK
-      if (is_tagged_clause (reason))
-	reason = untag_clause (solver, 0, uip, reason);
+      // We can not simply add a new clause since this function is called
+      // while traversing the 'irredundant' or 'redundant' stacks.  Instead
+      // we disconnect and add new watches.  Partially keeping unassigned
+      // watches is possible but needs more complex code (it might also
+      // result in blocking literals not in the clause anymore).
+
+#ifndef NVIRTUAL
+      if (size == 2)
+	{
+	  watch_binary (solver, c->redundant, new_lits[0], new_lits[1]);
+	  watch_binary (solver, c->redundant, new_lits[1], new_lits[0]);
+	  LOGCLS (c, "garbage after flushing %u literals", num_false);
+	  c->garbage = true;
+	}
       else
 #endif
-	INC (ticks);
-      LOGCLS (reason, "trying to shrink %s along", LOGLIT (uip));
-      for (all_literals_in_clause (lit, reason))
-	if (lit != uip)
-	  {
-	    int tmp = shrink_literal (solver, block_level, lit);
-	    if ((failed = (tmp < 0)))
-	      break;
-	    open += (tmp > 0);
-	  }
-    }
+	{
+#ifndef NWATCHES
+#ifndef NBLOCK
+	  watch_literal (solver, c->redundant, new_lits[0], new_lits[1], c);
+	  watch_literal (solver, c->redundant, new_lits[1], new_lits[0], c);
+#else
+	  watch_literal (solver, new_lits[0], c);
+	  watch_literal (solver, new_lits[1], c);
+#endif
+#endif
+	  unsigned *p = c->literals;
+	  for (all_elements_on_stack (unsigned, lit, solver->clause))
+	     *p++ = lit;
+
+	  c->size = size;
+#ifndef NGLUE
+	  if (c->redundant && c->size >= c->glue)
+	    c->glue = size - 1;
+#endif
+#ifndef NCACHE
+	  c->search = 0;
+#endif
+#ifdef NWATCHES
+	  connect_clause (solver, c);
+	  count_clause (solver, c);
+#endif
+	  LOGCLS (c, "flushing %u literals yields", num_false);
+	}
 
-  if (failed)
-    reset_shrunken (solver);
-  else
-    shrunken_block (solver, begin, end, uip);
+      // But there is no need to update clause statistics.
+    }
 
-  LOG ("shrinking of block of size %zu at level %u %s",
-       (size_t) (end - begin), block_level, failed ? "failed" : "succeeded");
+  CLEAR_STACK (solver->clause);
 
-  return !failed;
+  return false;
 }
 
-// Minimize the block if it could not be shrunken.
+// This function is called in default sparse mode from 'reduce' only and
+// then (through 'clause_satisfied') also flushes falsified literals.  In
+// dense mode it is only called from 'actual_number_of_occurrences' during
+// variable elimination attempts.  There it only updates 'subsume'
+// candidates if the clause is not garbage but contains falsified literals.
 
-static void
-minimize_block (struct satch *solver, unsigned *begin, unsigned *end)
+static bool
+mark_garbage_if_satisfied (struct satch *solver, struct clause *c)
 {
-  unsigned minimized = 0;
-  for (unsigned *p = begin; p != end; p++)
-    if (minimize_literal (solver, *p, 0) == REMOVABLE)
-      *p = INVALID, minimized++;
-  ADD (minimized, minimized);
-  LOG ("minimized %u literals", minimized);
+  assert (!solver->level);
+#ifndef NVIRTUAL
+  assert (!is_tagged_clause (c));
+  assert (!is_temporary_binary (solver, c));
+#endif
+  if (c->garbage)
+    return true;
+  if (!clause_satisfied (solver, c))
+    return false;
+  mark_garbage (solver, c, "root-level satisfied");
+  return true;
 }
 
-// This is the main shrinking function.  It requires the temporary clause to
-// be sorted with respect to decreasing decision level of its literals (thus
-// 'sort_deduced_clause' has to be called first).
-
-static void
-shrink_deduced_clause (struct satch *solver)
-{
-  assert (EMPTY_STACK (solver->poisoned));
-  assert (EMPTY_STACK (solver->removable));
-
-  {
-    unsigned *end = solver->clause.end;
-    while (end != solver->clause.begin)
-      {
-	unsigned *begin = next_block (solver, end);
-	if (!shrink_block (solver, begin, end))
-	  minimize_block (solver, begin, end);
-	end = begin;
-      }
-  }
-
-  // Removed literals of each block are overwritten with 'INVALID' in place
-  // and in a last pass we have to flush these invalid literals.
+// Irredundant clauses are not reduced, but marked garbage if they are
+// root-level satisfied clauses and can then be collected during reduction
+// too.  This is only necessary if there are new root-level fixed variables
+// since the last reduction though (and restricted to unprotected clauses).
 
-  {
-    const unsigned *const end = solver->clause.end;
-    unsigned *q = solver->clause.begin, lit;
-    for (const unsigned *p = q; p != end; p++)
-      if ((lit = *p) != INVALID)
-	*q++ = lit;
+// We also use this function after variable elimination since we might not
+// have found and marked all the satisfied clauses during elimination.
 
-    const unsigned shrunken = end - q;
-    solver->clause.end = q;
-    LOG ("shrunken %u literals", shrunken);
-    ADD (shrunken, shrunken);
-  }
+// For subsumption an important side-effect of this function is to mark
+// unassigned literals in not-satisfied irredundant clauses which contain
+// false literals too as subsumption candidates.
 
-  LOGTMP ("shrunken");
+static void
+mark_irredundant_clauses_as_garbage_if_satisfied (struct satch *solver)
+{
+  assert (!solver->level);
+  for (all_irredundant_clauses (c))
+    (void) mark_garbage_if_satisfied (solver, c);
 }
 
 #endif
 
-/*------------------------------------------------------------------------*/
-
-// Bumping reason side literals was introduced in the Maple solver in 2016.
-
-// The idea is to also bump those literals in the reason of the literals in
-// the learned clauses.  It seems that using target phases during stable
-// mode really needs this technique in order to be effective (and the same
-// applies to rephasing to best-phases and probably rephasing in general).
+#ifndef NREDUCE
 
-#ifndef NBUMPREASONS
+// Redundant clauses with large enough glucose level (glue) which have not
+// been used since the last reduction are deletion candidates. If there
+// are new root-level fixed variables since the last reduction we also
+// mark clauses as garbage which are root-level satisfied.
 
-static inline void
-bump_reason_side_literals (struct satch *solver)
+static void
+gather_reduce_candidates (struct satch *solver, bool new_fixed,
+			  struct clauses *candidates)
 {
-  struct averages *a = averages (solver);
-  if (unbiased_slow_average (a, a->decision_rate) >=
-      bump_reason_decision_rate_limit)
-    return;
+  // Reverse order is needed for radix sort to ensure that more recently
+  // learned clauses are kept if they have the same size and glue.
 
-  struct clause *const *const reasons = solver->reasons;
-  for (all_elements_on_stack (unsigned, lit, solver->clause))
+  // Without radix sort we need to use clause id's as tie-breaker anyhow and
+  // thus reversing the redundant clauses on the candidates stack is not
+  // necessary but also not harmful.
+
+  for (all_redundant_clauses_in_reverse (c))
     {
-      const unsigned idx = INDEX (lit);
-      struct clause *reason = reasons[idx];
-#ifndef NBLOCK
-      if (is_tagged_clause (reason))
-	reason = untag_clause (solver, 0, NOT (lit), reason);
+      assert (c->redundant);
+      if (c->garbage)
+	continue;
+      if (c->protected)
+	continue;
+      if (new_fixed)
+	{
+	  if (mark_garbage_if_satisfied (solver, c))
+	    continue;
+	  if (c->garbage)
+	    continue;
+	}
+#ifndef NVIRTUAL
+      assert (c->size > 2);
+#else
+      // As we can not protect binary reason clauses we just ignore them as.
+      assert (c->size > 1);
+      if (c->size == 2)
+	continue;
 #endif
-      if (!reason)
+#ifndef NTIER1
+      if (c->glue <= tier1_glue_limit)
 	continue;
-      for (all_literals_in_clause (other, reason))
-	if (analyze_literal (solver, other) != INVALID)
-	  INC (reasons);
-    }
-}
-
 #endif
+#ifndef NUSED
+      if (c->used)
+	{
+	  c->used--;		// Works for both 'used:1' and 'used:2'.
+#ifndef NTIER2
+	  if (c->glue <= tier2_glue_limit)
+#endif
+	    continue;
+	}
+#endif
+      PUSH (*candidates, c);
+    }
 
-/*------------------------------------------------------------------------*/
-
-// Sorting the analyzed variable indices to be bumped with respect to their
-// enqueue time stamp on the VMTF decision queue makes sure that they keep
-// the same relative order on the queue after bumping which empirically
-// improves the effectiveness of the decision heuristic (less conflicts).
-
-#ifndef NSORTANALYZED
-
-// The enqueue time stamps could be added to the 'analyzed' stack while
-// pushing variable indices to it.  This makes that code more complex given
-// all the different ways of disabling and enabling VMTF and sorting.
-// Instead we simply put this here to keep that complexity out of 'analyze'.
+  if (solver->options.verbose < 2)
+    return;
 
-static void
-add_stamps (struct satch *solver)
-{
-  struct queue *queue = get_queue (solver);
-  const struct link *const links = queue->links;
-  const struct analyzed *const end = solver->analyzed.end;
-  struct analyzed *const begin = solver->analyzed.begin;
-  for (struct analyzed * p = begin; p != end; p++)
-    p->stamp = links[p->idx].stamp;
+  const size_t size_candidates = SIZE_STACK (*candidates);
+  const size_t redundant = SIZE_STACK (solver->redundant);
+  message (solver, 2, "reduce", solver->statistics.reductions,
+	   "gathered %zu reduce candidate clauses %.0f%%",
+	   size_candidates, percent (size_candidates, redundant));
 }
 
-#ifndef NRADIXSORT
-
-// Ranking function for radix-sorting the analyzed variables stack.
-
-// Without using radix sort the time spent in 'sort_analyzed' can reach 20%
-// of the total running time (including both time spent in focused and
-// stable mode) even though 'sort_analyzed' is by default only used in
-// focused mode for the VMTF decision heuristic.  This might then increase
-// relative time spent in focused mode since we do not want to account for
-// sorting with our 'ticks' counter.  We have seen cases where this effect
-// lead to 70% time spent in focused mode and only 30% time in stable mode.
-// Using faster radix sorting allows to achieve a more balanced split of
-// search time into focused and stable mode.
-
-// Note that for CaDiCaL and early versions of Kissat we determined
-// empirically that quick sort is faster when sorting 800 or less variables.
-// With a new optimization which computes upper and lower bounds once for
-// all radix rounds, this number of 800 could be reduced to only 32
-// elements, where the dedicated inlined quick sort is faster.
-
-// These numbers are with respect to a dedicated fast header only quick sort
-// implementation.  For the standard 'qsort' function of the C library which
-// requires comparison function call-backs instead of inlined comparison
-// this number would be smaller anyhow.  Thus for 'satch' we do not
-// implement quick sort at this point.  Note also that quick-sort itself
-// usually has some kind of 'leaf-coarsening' and in essence switches to
-// insertion sort if for instance the number of elements drops below 10.
+#ifdef BINARYFIRST
 
-#define rank_analyzed(A) (A).stamp
+// Move binary clause watches in front of large clause watches for the
+// binary clause propagation pass 'propagate_binary_watches' (this swaps
+// misplaced watches from both ends and thus does not keep their order).
 
 static void
-sort_analyzed (struct satch *solver)
+move_binary_watches_first (struct watches *watches)
 {
-  add_stamps (solver);
-  RSORT (struct analyzed, unsigned, solver->analyzed, rank_analyzed);
+  union watch *begin = watches->begin, *end = watches->end;
+  for (;;)
+    {
+      while (begin != end && begin->header.binary)
+	begin++;
+      while (begin != end && !end[-1].header.binary)
+	end--;
+      if (begin == end)
+	break;
+      const union watch tmp = *begin;
+      *begin++ = *--end;
+      *end = tmp;
+    }
 }
 
-#else
-
-// Comparison function for 'qsort' to sort variable indices by stamp time.
-// Note that, time stamps are unique. Thus we get stable sorting for free.
+#endif
 
-static int
-cmp_analyzed (const void *p, const void *q)
-{
-  const struct analyzed *a = p, *b = q;
-  unsigned s = a->stamp, t = b->stamp;
-  return (s < t) ? -1 : 1;
-}
+// Before actually deleting the garbage clauses we have to flush of course
+// watches from the watcher lists pointing to such garbage clauses.
 
 static void
-sort_analyzed (struct satch *solver)
+flush_garbage_watches (struct satch *solver)
 {
-  add_stamps (solver);
-  qsort (solver->analyzed.begin, SIZE_STACK (solver->analyzed),
-	 sizeof (struct analyzed), cmp_analyzed);
-}
+  struct watches *all_watches = solver->watches;
+#ifndef NPACKED
+  uint64_t *const arena = solver->arena.begin;
+#endif
+#ifndef NVIRTUAL
+  signed char *const values = solver->values;
+#endif
+  for (all_literals (lit))
+    {
+#ifndef NVIRTUAL
+      signed char lit_value = values[lit];
+      if (lit_value && LEVEL (INDEX (lit)))
+	lit_value = 0;
+#endif
+      struct watches *const lit_watches = all_watches + lit;
+      union watch *const end = lit_watches->end;
+      union watch *q = lit_watches->begin;
+      const union watch *p = q;
+      while (p != end)
+	{
+#ifndef NBLOCK
+	  const union watch watch = *p++;
+#ifndef NVIRTUAL
+	  const struct header header = watch.header;
+	  if (header.binary)
+	    {
+	      const unsigned blocking = header.blocking;
 
+	      signed char blocking_value = values[blocking];
+	      if (blocking_value && LEVEL (INDEX (blocking)))
+		blocking_value = 0;
+
+	      // We want to eagerly remove root-level satisfied binary
+	      // clauses as well, but since those sit in watch lists only
+	      // (if 'NVIRTUAL' and 'NBLOCK' are undefined) we have to check
+	      // whether the literal or the other blocking literal are
+	      // root-level assigned.  In both cases (since we assume
+	      // propagation went to completion on the root-level) we know
+	      // that the binary clause has to be satisfied.
+
+	      if (lit_value || blocking_value)
+		{
+		  assert (lit_value > 0 || blocking_value > 0);
+		  delete_binary (solver, header.redundant, lit, blocking);
+		  continue;	// Drop header by not copying it.
+		}
+	      *q++ = watch;	// Keep header and skip non-existing clause.
+	      continue;
+	    }
+#endif
+	  *q++ = watch;		// Keep blocking literal header.
+#endif
+#ifndef NPACKED
+	  const struct clause *const clause =
+	    dereference_clause (arena, watch.header.reference);
+#else
+	  const struct clause *const clause = (*q++ = *p++).clause;
 #endif
+	  if (clause->garbage)
+	    q -= long_clause_watch_size;	// Stop watching clause.
+	}
+      lit_watches->end = q;
+#ifdef BINARYFIRST
+      move_binary_watches_first (lit_watches);
 #endif
+      SHRINK_STACK (*lit_watches);
+    }
+}
 
-/*------------------------------------------------------------------------*/
+#endif
 
-// The CDCL conflict analysis function.
+#if !defined(NREDUCE) || !defined(NELIMINATION)
 
-// Find the highest level present in the conflict. Without chronological backtracking this is
-// always the current decision level
-#ifndef NCHRONO
+// After removing garbage watches we can finally delete garbage clauses.
 
-static int
-find_conflict_level (struct satch *solver, struct clause *conflict,
-		     unsigned *forced)
+static void
+delete_garbage_clauses (struct satch *solver, struct clauses *clauses,
+			size_t *bytes_ptr, size_t *count_ptr)
 {
-  assert (!solver->inconsistent);
+  size_t bytes = 0;
+  size_t count = 0;
 
-  (void) *forced;
-  unsigned res = 0;
-  int count = 0;
-  unsigned *lits = conflict->literals;
-  const int size = conflict->size;
-  unsigned *const end = lits + size;
-  unsigned *const begin = lits;
-  for (unsigned *p = begin; p != end; ++p)
+  struct clause *const *const end = clauses->end;
+  struct clause **q = clauses->begin;
+
+  for (struct clause ** p = q; p != end; p++)
     {
-      LOG ("find conflict: lit %s", LOGLIT (*p));
-      const unsigned idx = INDEX (*p);
-      const unsigned level = solver->levels[idx];
-      if (level > res)
-	{
-	  res = level;
-	  *forced = *p;
-	  count = 1;
-	}
-      else if (level == res)
+      struct clause *const c = *p;
+      if (c->garbage)
 	{
+	  assert (!c->protected);
+	  bytes += delete_clause (solver, c);
 	  count++;
 	}
+      else
+	*q++ = c;
     }
+  clauses->end = q;
 
-  LOG ("%d literals on actual conflict level %d, forced: %s", count, res,
-       forced && *forced != INVALID ? LOGLIT (*forced) : "no");
+  *bytes_ptr += bytes;
+  *count_ptr += count;
+}
 
-  // Move the two highest level literals to the front.
-  //
-#ifndef NVIRTUAL
-  if (!is_temporary_binary (solver, conflict))
 #endif
-    {
-      for (unsigned i = 0; i < 2; i++)
-	{
-
-	  const unsigned lit = lits[i];
 
-	  unsigned highest_position = i;
-	  unsigned highest_literal = lit;
-	  const unsigned idx = INDEX (lit);
-	  unsigned highest_level = solver->levels[idx];
-
-	  for (int j = i + 1; j < size; j++)
-	    {
-	      const int other = lits[j];
-	      const unsigned idx_other = INDEX (other);
-	      const unsigned tmp = solver->levels[idx_other];
-	      if (highest_level >= tmp)
-		continue;
-	      highest_literal = other;
-	      highest_position = j;
-	      highest_level = tmp;
-	      if (highest_level == res)
-		break;
-	    }
+#ifndef NREDUCE
 
-	  // No unwatched higher assignment level literal.
-	  //
-	  if (highest_position == i)
-	    continue;
+/*------------------------------------------------------------------------*/
 
-#ifndef NWATCHES
-	  if (highest_position > 1)
-	    {
-	      LOGCLS (conflict, "unwatch %d in", lit);
-	      unwatch_literal (solver, lit, conflict);
-	    }
-#endif
+// Candidate clauses considered to be reduced are sorted with respect to
+// their potential usefulness in the future.  Clauses are considered more
+// useful if they have a smaller glue or smaller size with the same glue.
+// If both glue and size are the same we keep more recently learned clauses.
 
-	  lits[highest_position] = lit;
-	  lits[i] = highest_literal;
+#ifndef NRADIXSORT
 
-#ifndef NWATCHES
-	  if (highest_position > 1)
-#ifndef NBLOCK
-	    watch_literal (solver, conflict->redundant, highest_literal,
-			   lits[!i], conflict);
-#else
-	    watch_literal (solver, highest_literal, conflict);
-#endif
-#endif
-	}
-    }
+#ifndef NGLUE
 
+static uint64_t
+rank_clause (struct clause *c)
+{
+  return ((uint64_t) c->glue << 32) + c->size;
+}
 
-  // Only if the number of highest level literals in the conflict is one
-  // then we can reuse the conflict clause as driving clause for 'forced'.
-  //
-  if (count != 1)
-    {
-      *forced = UINT32_MAX;
-      LOG ("no forcing literal");
-    }
+static void
+sort_reduce_candidates (struct satch *solver, struct clauses *candidates)
+{
+  RSORT (struct clause *, uint64_t, *candidates, rank_clause,
+	 solver->scratch);
+}
 
-  return res;
+#else
 
+static unsigned
+rank_clause (struct clause *c)
+{
+  return c->size;
 }
 
-#ifndef NHEAP
-unsigned
-reuse_scored_trail_from (struct satch *solver, unsigned asserting_level)
+static void
+sort_reduce_candidates (struct satch *solver, struct clauses *candidates)
 {
-  unsigned next = max_score_unassigned_variable_on_binary_heap (solver);
-  const double *const scores = solver->scores[solver->stable].score;
-  struct clause *const *const reasons = solver->reasons;
-  struct control const control = solver->control;
-  unsigned *const end = solver->trail.end;
-  const double next_score = scores[next];
-  double decision_score = MAX_SCORE;
-  const unsigned control_position =
-    asserting_level ? asserting_level - 1 : asserting_level;
-  for (unsigned *lit = ACCESS (control, control_position).trail; lit != end;
-       ++lit)
-    {
-      const unsigned idx = INDEX (*lit);
-      const double score = scores[idx];
-      const unsigned level = solver->levels[idx];
-      if (level <= asserting_level)
-	continue;
-      if (decision_score < score || score < next_score)
-	return level - 1;
-      if (!reasons[idx])
-	decision_score = score;
-    }
-  return solver->level - 1;
+  RSORT (struct clause *, unsigned, *candidates, rank_clause,
+	 solver->scratch);
 }
+
 #endif
 
-#ifndef NQUEUE
-unsigned
-reuse_stamped_trail_from (struct satch *solver, unsigned asserting_level)
+#else
+
+// This the actual comparison functions for 'qsort' to order reduce
+// candidates.  The result is negative if the first argument is more useful
+// than the second.  The result is positive, if the second argument is more
+// useful.  Since 'qsort is not stable we make comparison deterministic by
+// using clause id's as tie-breaker which also makes sure that more recently
+// learned clauses are considered to be more useful in the future if they
+// happen to have the same glue and size.
+
+static int
+cmp_reduce (const void *p, const void *q)
 {
-  unsigned next = max_stamped_unassigned_variable_on_decision_queue (solver);
-  const struct link *const links = solver->queue[solver->stable].links;
-  struct clause *const *const reasons = solver->reasons;
-  struct control const control = solver->control;
-  unsigned *const end = solver->trail.end;
-  const unsigned next_stamp = links[next].stamp;
-  unsigned decision_stamp = UINT_MAX;
-  const unsigned control_position =
-    asserting_level ? asserting_level - 1 : asserting_level;
-  for (unsigned *lit = ACCESS (control, control_position).trail; lit != end;
-       ++lit)
-    {
-      const unsigned idx = INDEX (*lit);
-      const unsigned stamp = links[idx].stamp;
-      const unsigned level = solver->levels[idx];
-      if (level <= asserting_level)
-	continue;
-      if (decision_stamp < stamp || stamp < next_stamp)
-	return level - 1;
-      if (!reasons[idx])
-	decision_stamp = stamp;
-    }
-  return solver->level - 1;
-}
+  const struct clause *const c = *(const struct clause * const *) p;
+  const struct clause *const d = *(const struct clause * const *) q;
+#ifndef NGLUE
+  if (c->glue < d->glue)
+    return -1;
+  if (c->glue > d->glue)
+    return 1;
 #endif
+  if (c->size < d->size)
+    return -1;
+  if (c->size > d->size)
+    return 1;
+  if (c->id < d->id)
+    return 1;
+  assert (c->id > d->id);
+  return -1;
+}
 
-#endif
+static void
+sort_reduce_candidates (struct satch *solver, struct clauses *candidates)
+{
+  (void) solver;
+  struct clause **begin = candidates->begin;
+  qsort (begin, SIZE_STACK (*candidates), sizeof *begin, cmp_reduce);
+}
 
-#ifndef NCHRONO
-#define CHRONOLEVELS 100
 #endif
 
-#ifndef NCDCL
-// Determine the level we should jump back to. Without chronological backtracking, this is
-// simply the asserting level. With it, there are three possibilities:
-//    - if backtracking does not make sense (e.g., when vivifying), backjump
-//    - otherwise, we use a restart-like heuristic to determine how much should be reused...
-//    - ...unless all variables have been decided. Then we jump to the lastest level.
-static unsigned
-determine_jump_level (struct satch *solver, unsigned conflict_level,
-		      unsigned *asserting_level)
+/*------------------------------------------------------------------------*/
+
+// From the remaining candidates we reduce 'reduce_fraction' of clauses.
+
+static void
+mark_garbage_candidates (struct satch *solver, struct clauses *candidates)
 {
-  signed char *frames = solver->frames;
-  unsigned jump_level = 0;
-  *asserting_level = 0;
+  const size_t size = SIZE_STACK (*candidates);
+  assert (0.0 <= reduce_fraction);
+  const size_t reduce = reduce_fraction * size;
 
-  for (all_elements_on_stack (unsigned, lit_level, solver->blocks))
-    {
-      frames[lit_level] = 0;
-      if (lit_level != conflict_level && *asserting_level < lit_level)
-	*asserting_level = lit_level;
-#ifndef NCONTROL
-      if (lit_level)
-	ACCESS (solver->control, lit_level - 1).seen.count = 0,
-	  ACCESS (solver->control, lit_level - 1).seen.earliest = UINT32_MAX;
-#endif
-    }
-  LOG ("asserting level: %d", *asserting_level);
+  message (solver, 4, "reduce", solver->statistics.reductions,
+	   "target is to reduce %zu out of %zu clauses %.0f%%",
+	   reduce, size, percent (reduce, size));
 
-#ifndef NCHRONO
-  if (solver->level - *asserting_level < CHRONOLEVELS ||
-      solver->level - 1 == *asserting_level
-#ifndef NVIVIFICATION
-      || solver->vivifying
+  const double keep_fraction = 1.0 - reduce_fraction;
+  const size_t keep = keep_fraction * size;
+
+  // The best 'cold_fraction' of the reduced clauses are cooled instead.
+
+#ifdef COLD
+  const size_t cold = cold_fraction * (size - keep);
+#else
+  const size_t cold = 0;
 #endif
-    )
+
+  size_t reduced = 0;
+
+  while (SIZE_STACK (*candidates) > keep + cold)
     {
-      LOG ("normal backjumping");
-      return *asserting_level;
+      struct clause *c = POP (*candidates);
+      assert (!c->protected);
+      mark_garbage (solver, c, "reducing");
+      reduced++;
     }
-  LOG ("backjumping considered too inefficient");
-  if (!solver->unassigned)
+
+#ifdef COLD
+  while (SIZE_STACK (*candidates) > keep)
+    cool_clause (solver, POP (*candidates));
+#endif
+
+  ADD (reduced, reduced);
+
+  message (solver, 3, "reduce", solver->statistics.reductions,
+	   "reducing %zu out of %zu clauses %.0f%%",
+	   reduced, size, percent (reduced, size));
+
+}
+
+/*------------------------------------------------------------------------*/
+
+#ifndef NDEBUG
+
+// Even though the 'irredundant' and 'redundant' clause statistics are only
+// used for reporting we still want to accurately measure and maintain them,
+// which unfortunately is not trivial.  These reports are very useful for
+// engineering heuristics (and sometimes debugging).
+
+// Thus we perform this explicit check before and after 'reduce'.
+
+static void
+check_clause_statistics (struct satch *solver)
+{
+  assert (!solver->dense);
+
+  uint64_t irredundant = 0;
+  uint64_t redundant = 0;
+
+#ifndef NVIRTUAL
+  for (all_literals (lit))
     {
-      jump_level = solver->level - 1;
-      if (*asserting_level != solver->level - 1)
+      const struct watches *const watches = solver->watches + lit;
+      const union watch *const end = watches->end;
+      const union watch *p = watches->begin;
+      while (p != end)
 	{
-	  INC (chrono);
-	  ADD (chronosaved, jump_level - *asserting_level);
+	  const union watch watch = *p++;
+	  const struct header header = watch.header;
+	  if (header.binary)
+	    {
+	      const unsigned other = header.blocking;
+	      if (lit < other)
+		{
+		  if (header.redundant)
+		    redundant++;
+		  else
+		    irredundant++;
+		}
+	    }
+#ifdef NPACKED
+	  else
+	    p++;
+#endif
 	}
-      return jump_level;
     }
-#ifndef NCHRONOREUSE
-#ifndef NQUEUE
-  if (!solver->queue[solver->stable].size)
-    return solver->level - 1;
 #endif
 
-#if defined(NHEAP)
-  jump_level = reuse_stamped_trail_from (solver, *asserting_level);
-#elif defined(NQUEUE)
-  jump_level = reuse_scored_trail_from (solver, *asserting_level);
-#else
-  if (solver->stable)
-    {
-      jump_level = reuse_scored_trail_from (solver, *asserting_level);
-    }
+  for (all_irredundant_clauses (c))
+    if (!c->garbage)
+      irredundant++;
 
-  else
-    {
-      jump_level = reuse_stamped_trail_from (solver, *asserting_level);
-    }
-#endif
-#else // NCHRONOREUSE = always backtrack to lastest level
-  jump_level = solver->level - 1;
-#endif
-  assert (jump_level >= *asserting_level);
-  if (*asserting_level != jump_level)
-    {
-      INC (chrono);
-      ADD (chronosaved, jump_level - *asserting_level);
-    }
+  for (all_redundant_clauses (c))
+    if (!c->garbage)
+      redundant++;
 
-#else // no backtracking
-  jump_level = *asserting_level;
-#endif
-  return jump_level;
+  assert (irredundant == solver->statistics.irredundant);
+  assert (redundant == solver->statistics.redundant);
 }
+
 #endif
 
-#ifdef NCDCL
+/*------------------------------------------------------------------------*/
+
+// Reduce less useful redundant clauses frequently.
+
 static void
-produce_reason_for_checker (struct satch *solver)
+reduce (struct satch *solver)
 {
-  struct clause *const *const reasons = solver->reasons;
-  for (unsigned *lit = solver->trail.begin; lit != solver->trail.end; ++lit)
+#ifndef NDEBUG
+  check_clause_statistics (solver);
+#endif
+  START (reduce);
+  const uint64_t reductions = INC (reductions);
+
+  // If there are new fixed (root-level assigned) variables since the last
+  // reduction, we remove both satisfied irredundant clauses here and later
+  // satisfied redundant clauses in 'gather_reduce_candidates'.  Both call
+  // 'mark_garbage_if_satisfied' for large clauses, which in turn calls
+  // 'clause_satisfied' and thus also flushes falsified literals.
+
+  // Without new fixed variable we do not backtrack but protect reasons.
+
+  const bool new_fixed =
+    solver->limits.reduce.fixed < solver->statistics.fixed;
+
+  if (new_fixed)
     {
-      const unsigned idx = INDEX (*lit);
-      if (!reasons[idx])
-	{
-	  PUSH (solver->clause, NOT (*lit));
-	}
+      update_phases_and_backtrack_to_root_level (solver);
+      mark_irredundant_clauses_as_garbage_if_satisfied (solver);
     }
+  else
+    set_protect_flag_of_reasons (solver, true);
+
+#ifndef NARENA
+  pin_arena (solver);		// Reduction does not add clauses.
+#endif
+
+  // At the core of reduction is to first gather potential redundant reduce
+  // candidate clauses (omitting those that are definitely kept).  Then
+  // these candidates are sorted with respect to a metric which is supposed
+  // to reflect potential usefulness. From the less useful clauses a large
+  // fraction ('reduce_fraction') is then marked as garbage to be collected.
+
+#ifdef COLD
+  reduce_cold_clauses (solver, new_fixed);
+#endif
 
-  struct averages *a = averages (solver);
   {
-    double trail_filled = percent (SIZE_STACK (solver->trail),
-				   solver->statistics.remaining);
-    update_slow_average (&a->trail_filled, trail_filled);
-    update_slow_average (&a->conflict_level, solver->level);
+    struct clauses candidates;
+    INIT_STACK (candidates);
+
+    gather_reduce_candidates (solver, new_fixed, &candidates);
+    sort_reduce_candidates (solver, &candidates);
+    mark_garbage_candidates (solver, &candidates);
+
+    RELEASE_STACK (candidates);
   }
+
+  // Before we can delete the garbage clauses we first have to remove
+  // references to those clauses marked as garbage from the watch lists.
+
+  flush_garbage_watches (solver);
+
+  // As next to final step we delete garbage clauses and print statistics.
+
   {
-    const uint64_t decisions = DECISIONS;
-    const uint64_t delta_decisions = decisions - a->saved_decisions;
-    a->saved_decisions = decisions;
-    update_slow_average (&a->decision_rate, delta_decisions);
+    size_t bytes = 0, count = 0;
+    if (new_fixed)
+      delete_garbage_clauses (solver, &solver->irredundant, &bytes, &count);
+    delete_garbage_clauses (solver, &solver->redundant, &bytes, &count);
+
+    // We report on how many clauses we collected during reduction.
+
+    message (solver, 2, "reduce", reductions,
+	     "collected %zu clauses (%zu bytes, %.0f MB)",
+	     count, bytes, bytes / (double) (1u << 20));
+
+    ADD (collected, bytes);
   }
-  update_betas (solver);
 
-  trace_and_check_temporary_addition (solver);
+#ifndef NARENA
+  unpin_arena (solver);
+  compact_arena (solver);
+#endif
 
-  CLEAR_STACK (solver->clause);
+  // No we can mark reasons of literals on the trail as unprotected.
 
-}
-#endif
+  if (!new_fixed)
+    set_protect_flag_of_reasons (solver, false);
 
-// First we deduce the 'first unique implication point' (1st UIP) clause,
-// minimize, shrink and learn it, then determine backjump level, backtrack
-// and assign the 1st UIP literal to the opposite value with the learned
-// clause as reason.  We also update various statistics during the analysis.
-static bool
-analyze_conflict (struct satch *solver, struct clause *conflict)
-{
-  assert (!solver->inconsistent);
-  assert (EMPTY_STACK (solver->clause));	// Clause learned.
+  // Finally we compute and report the next conflict limit for reduction.
 
-  if (!solver->level)
-    {
-      LOG ("learned empty clause");
-      trace_and_check_empty_addition (solver);
-      solver->inconsistent = true;
-      return false;
-    }
+  {
+    solver->limits.reduce.fixed = solver->statistics.fixed;
+    const uint64_t interval =
+      scale_interval (reduce_interval, ndivlogn, reductions);
+    solver->limits.reduce.conflicts = CONFLICTS + interval;
+    message (solver, 4, "reduce", reductions,
+	     "next limit at %" PRIu64 " after %" PRIu64 " conflicts",
+	     solver->limits.reduce.conflicts, interval);
+  }
 
-#ifdef NCDCL
-  (void) conflict;
-  produce_reason_for_checker (solver);
-#ifndef NCONTROL
-  struct level const *const saved =
-    &ACCESS (solver->control, solver->level - 1);
-  const unsigned uip = *saved->trail;
-  assert (solver->values[uip]);
-  assert (saved->lvl == solver->level);
-#else
-  assert (!EMPTY_STACK (solver->trail));
-  unsigned *uipp = solver->trail.end - 1;
-  while (solver->reasons[INDEX (*uipp)])
-    {
-      assert (uipp > solver->trail.begin);
-      --uipp;
-    }
-  const unsigned uip = *uipp;
+  report (solver, 1, '-');
+  STOP (reduce);
+#ifndef NDEBUG
+  check_clause_statistics (solver);
 #endif
-#ifndef NTARGET
-  if (solver->stable)
-    update_phases (solver);
+}
+
 #endif
-  unsigned not_uip = NOT (uip);
-  backtrack (solver, solver->level - 1);
-  LOG ("swapping last decision %s", LOGLIT (uip));
-  assert (!solver->values[uip]);
-  assign (solver, not_uip, DUMMY_REASON, solver->level == 0);
 
-  return true;
-#else
-  assert (EMPTY_STACK (solver->blocks));	// Decision levels analyzed.
-  assert (EMPTY_STACK (solver->analyzed));	// Analyzed literals.
+/*------------------------------------------------------------------------*/
 
-  PUSH (solver->clause, INVALID);	// Reserve room for 1st UIP.
+// Switch between focused mode with aggressive restarting and stable mode
+// with almost no restarting.  At the same time switch between two different
+// decision variable schemes (by default VMTF vs (E)VSIDS).  During stable
+// mode we also enable rephasing and target phases.  The two modes have
+// separate averages ('glue', 'rate', 'level' and 'trail').
 
-#ifndef NCHRONO
-  unsigned forced = INVALID;
-  unsigned *forcedp = &forced;
-  const unsigned conflict_level =
-    find_conflict_level (solver, conflict, forcedp);
-  if (!conflict_level)
+// Starting and ending a mode is indicated by a '{' and '}' pair for focused
+// mode (the initial mode) and '[' and ']' for stable mode.
+
+#ifndef NSWITCH
+
+static void
+start_mode (struct satch *solver)
+{
+  if (solver->stable)
     {
-      LOG ("learned empty clause");
-      trace_and_check_empty_addition (solver);
-      solver->inconsistent = true;
-      return false;
+      START (stable);
+      report (solver, 1, '[');
+      LOG ("start stable mode");
     }
-  if (*forcedp != INVALID)
+  else
     {
-      assert (solver->values[*forcedp] < 0);
-#ifndef NBLOCK
-      assert (!is_tagged_clause (conflict));
-#endif
-      LOG ("missed propagation of lit %s from level %d", LOGLIT (*forcedp),
-	   conflict_level);
-      backtrack (solver, conflict_level - 1);
-#ifndef NBLOCK
-      if (is_temporary_binary (solver, conflict) || conflict->size == 2)
-	{
-#ifndef NBLOCK
-	  unsigned other =
-	    *forcedp ^ conflict->literals[0] ^ conflict->literals[1];
-	  struct clause *reason = tag_binary_clause (true, other);
-	  assign (solver, *forcedp, reason, false);
-#else
-	  assign (solver, *forcedp, conflict, false);
-#endif
-	}
-      else
-#endif
-	assign (solver, *forcedp, conflict, false);
-      CLEAR_STACK (solver->blocks);
-      CLEAR_STACK (solver->clause);
-      assert (solver->level == conflict_level - 1);
-      return true;
+      START (focused);
+      report (solver, 1, '{');
+      LOG ("start focused mode");
     }
-  if (conflict_level < solver->level)
+}
+
+static void
+stop_mode (struct satch *solver)
+{
+  if (solver->stable)
     {
-      LOG ("conflict was on level %d instead of current level %d",
-	   conflict_level, solver->level);
-      backtrack (solver, conflict_level);
+      STOP (stable);
+      LOG ("stop stable mode");
+      report (solver, 1, ']');
     }
   else
     {
-      LOG ("conflict is on current level");
+      STOP (focused);
+      LOG ("stop focused mode");
+      report (solver, 1, '}');
     }
-#else
-  const unsigned conflict_level = solver->level;
-#endif
-  signed char *const marks = solver->marks;
-  const unsigned *const levels = solver->levels;
-  struct clause *const *const reasons = solver->reasons;
-  signed char *frames = solver->frames;
+}
 
-  struct clause *reason = conflict;
+// Initially (for the first focused mode phase) we use a non-zero conflict
+// limit ('initial_mode_conflicts_interval') and then compute the number of
+// 'ticks' spent in this first mode.  This is then used as base ticks
+// interval for the length of the remaining mode phases.
 
-  const unsigned *t = solver->trail.end;
-  unsigned unresolved_on_current_level = 0;
-  unsigned uip = INVALID;
+// To indicate that we moved to a ticks based limits we set
+// 'limits->mode.conflicts' to zero after the first mode switch.
+// Accordingly when testing for switching we first check whether that is
+// zero and then use ticks instead of conflicts.
 
-  uint64_t ticks = 0;
+// As you can see we still use a ticks limit for the first round since we
+// encountered cases were relying on conflicts only took too much time.
 
-  for (;;)
-    {
-      assert (reason);
-      LOGCLS (reason, "analyzing");
-#ifndef NUSED
-#ifndef NBLOCK
-      if (!is_temporary_binary (solver, reason))
-#endif
-	{
-	  assert (uip == INVALID || solver->values[uip] > 0);
-	  if (!reason->used)
-	    reason->used = 1;
-#ifndef NTIER2
-	  else if (reason->glue <= tier2_glue_limit)
-	    reason->used = 2;
-#endif
-	  ticks++;
-	}
-#endif
-      for (all_literals_in_clause (lit, reason))
-	{
-	  if (lit == uip)
-	    continue;
-	  const unsigned lit_level = analyze_literal (solver, lit);
-	  if (lit_level == INVALID)
-	    continue;
-	  assert (solver->values[lit] < 0);
-	  if (lit_level < conflict_level)
-	    {
-	      if (!frames[lit_level])
-		{
-		  LOG ("analyzing decision level %u", lit_level);
-		  PUSH (solver->blocks, lit_level);
-		  frames[lit_level] = 1;
-		}
-	      PUSH (solver->clause, lit);
-#ifndef NCONTROL
-	      const unsigned idx = INDEX (lit);
-	      const unsigned level = solver->levels[idx];
-	      if (level != 0)
-		{
-		  struct level *saved = &ACCESS (solver->control, level - 1);
-		  if (saved->seen.earliest > solver->position[idx])
-		    saved->seen.earliest = solver->position[idx];
-		  ++saved->seen.count;
-		  LOG ("updating level %d with: %d %d", level,
-		       saved->seen.earliest, saved->seen.count);
-		}
-#endif
-	    }
-	  else
-	    unresolved_on_current_level++;
-	}
-      unsigned uip_idx;
-      do
-	{
-	  assert (solver->trail.begin < t);
-#ifndef NCHRONO
-	  if (solver->levels[INDEX (*--t)] == solver->level)
-	    uip = *t;
-	  else
-	    uip = INVALID;
-#else
-	  uip = *--t;
-#endif
-	}
-      while (uip == INVALID || !marks[uip_idx = INDEX (uip)]);
-      LOG ("next lit to analyze is %s", LOGLIT (uip));
-      if (!--unresolved_on_current_level)
-	break;
-      reason = reasons[uip_idx];
-#ifndef NBLOCK
-      if (is_tagged_clause (reason))
-	reason = untag_clause (solver, 0, uip, reason);
-#endif
-    }
-  assert (uip != INVALID);
-  LOG ("first unique implication point %s (1st UIP)", LOGLIT (uip));
-  const unsigned not_uip = NOT (uip);
-  ACCESS (solver->clause, 0) = not_uip;
-  ADD (ticks, ticks);
+static bool
+switching (struct satch *solver)
+{
+  struct limits *limits = &solver->limits;
+  if (limits->mode.conflicts && limits->mode.conflicts <= CONFLICTS)
+    return true;
+  return limits->mode.ticks.limit <= TICKS;
+}
+
+static void
+set_new_mode_switching_limit (struct satch *solver, uint64_t switched)
+{
+  struct limits *limits = &solver->limits;
+  const uint64_t interval = limits->mode.ticks.interval;
+  const uint64_t count = (switched + 1) / 2;
+  const uint64_t scaled = scale_interval (interval, quadratic, count);
+  solver->limits.mode.ticks.limit = TICKS + scaled;
+  message (solver, 3, "switch", switched,
+	   "new %s mode limit of %" PRIu64 " ticks after %" PRIu64 " ticks",
+	   solver->stable ? "focused" : "stable",
+	   limits->mode.ticks.limit, scaled);
+}
 
-  LOGTMP ("deduced");
-  unsigned size = SIZE_STACK (solver->clause);
-  ADD (deduced, size);
-  assert (size);
+static void
+mode_ticks_limit_hit (struct satch *solver, uint64_t switched)
+{
+  message (solver, 2, "switch", switched,
+	   "limit of %" PRIu64 " ticks hit at %" PRIu64 " ticks",
+	   solver->limits.mode.ticks.limit, TICKS);
+}
 
-#ifndef NSORTDEDUCED
-  sort_deduced_clause (solver);
-#endif
+#ifndef NDEBUG
 
-#ifndef NMINIMIZE
-  START_IF_NCHEAP (minishrink);
-#ifndef NSHRINK
-  shrink_deduced_clause (solver);
+// The first mode is focused mode unless a portfolio worker is started in
+// stable mode, in which case the parity of 'switched' is flipped.
+
+static bool
+initially_stable (struct satch *solver)
+{
+#ifndef NPORTFOLIO
+  return solver->options.stable;
 #else
-  minimize_deduced_clause (solver);
+  (void) solver;
+  return false;
 #endif
-  reset_removable_and_poisoned (solver);
-  STOP_IF_NCHEAP (minishrink);
-  size = SIZE_STACK (solver->clause);
+}
+
 #endif
 
-  const unsigned glue = SIZE_STACK (solver->blocks);
-  unsigned asserting_level = 0;
-  unsigned jump_level =
-    determine_jump_level (solver, conflict_level, &asserting_level);
-  CLEAR_STACK (solver->blocks);
+static void
+mode_limit_hit (struct satch *solver, uint64_t switched)
+{
+  struct limits *limits = &solver->limits;
 
-  {
-    struct averages *a = averages (solver);
-#ifndef NRESTART
-    update_fast_average (&a->fast_glue, glue);
-#endif
-    update_slow_average (&a->slow_glue, glue);
-    update_slow_average (&a->conflict_level, conflict_level);
-    {
-      const uint64_t decisions = DECISIONS;
-      const uint64_t delta_decisions = decisions - a->saved_decisions;
-      a->saved_decisions = decisions;
-      update_slow_average (&a->decision_rate, delta_decisions);
-    }
+  if (limits->mode.conflicts)
     {
-      double trail_filled = percent (SIZE_STACK (solver->trail),
-				     solver->statistics.remaining);
-      update_slow_average (&a->trail_filled, trail_filled);
+      message (solver, 2, "switch", switched,
+	       "limit of %" PRIu64 " conflicts hit at %"
+	       PRIu64 " conflicts and %" PRIu64 " ticks",
+	       limits->mode.conflicts, CONFLICTS, TICKS);
+
+      limits->mode.ticks.interval = TICKS;
+      limits->mode.conflicts = 0;
     }
-    update_betas (solver);
+  else
+    mode_ticks_limit_hit (solver, switched);
+}
 
-    LOG ("determined jump level %u and glue %u", jump_level, glue);
-    LOG ("exponential 'conflict_level' moving average %g",
-	 unbiased_slow_average (a, a->conflict_level));
+static void
+switch_to_focused_mode (struct satch *solver, uint64_t switched)
+{
+  assert (solver->stable);
+  mode_limit_hit (solver, switched);
+  solver->stable = false;
+  assert (switched >= 2 || initially_stable (solver));
+  assert (!(switched & 1) == !initially_stable (solver));
+}
+
+static void
+init_stable_mode (struct satch *solver)
+{
 #ifndef NRESTART
-    LOG ("exponential 'fast_glue' moving average %g",
-	 unbiased_fast_average (a, a->fast_glue));
+  solver->reluctant.u = solver->reluctant.v = 1;
+  solver->limits.restart = CONFLICTS + stable_restart_interval;
 #endif
-    LOG ("exponential 'slow_glue' moving average %g",
-	 unbiased_slow_average (a, a->slow_glue));
-  }
 
-#ifndef NBUMPREASONS
-  bump_reason_side_literals (solver);
+#ifndef NTARGET
+  LOG ("reset target size");
+  solver->target = 0;
 #endif
+  (void) solver;
+}
+
+static void
+switch_to_stable_mode (struct satch *solver, uint64_t switched)
+{
+  assert (!solver->stable);
+  mode_limit_hit (solver, switched);
+  solver->stable = true;
+  assert (!(switched & 1) == initially_stable (solver));
+  init_stable_mode (solver);
+}
+
+static void
+switch_mode (struct satch *solver)
+{
+  stop_mode (solver);
+  const uint64_t switched = INC (switched);
+
+  // Make sure to push back all assigned variables to the scores heap and
+  // reset the VMTF queue if there are still variables on the trail.
+  // Otherwise the scores heap respectively the queue is not really saved.
+  // There is even the danger to violate the invariant that unassigned
+  // literals are not all on the binary heap when switching back etc.
+
+  if (solver->level)
+    backtrack (solver, 0);
+
+  if (solver->stable)
+    switch_to_focused_mode (solver, switched);
+  else
+    switch_to_stable_mode (solver, switched);
+
+  // Save the number of decisions when entering the new mode to compute the
+  // mode specific 'decision rate' exponential moving average.
+
+  struct averages *a = averages (solver);
+  a->saved_decisions = DECISIONS;
+
+  set_new_mode_switching_limit (solver, switched);
+  start_mode (solver);
+}
 
-#ifndef NSORTANALYZED
-#ifndef NVSIDS
-  if (!solver->stable)
 #endif
-    sort_analyzed (solver);	// Sort analyzed variables on time stamp.
+
+/*------------------------------------------------------------------------*/
+#ifndef NELIMINATION
+/*------------------------------------------------------------------------*/
+
+static bool
+more_elimination_candidates (struct satch *solver)
+{
+  return solver->statistics.marked_eliminate >
+    solver->limits.eliminate.marked;
+}
+
+#ifndef NSUBSUMPTION
+
+static bool
+more_subsumption_candidates (struct satch *solver)
+{
+  return solver->statistics.marked_subsume > solver->limits.subsume.marked;
+}
+
 #endif
 
-  for (all_elements_on_stack (struct analyzed, analyzed, solver->analyzed))
-    {
-      const unsigned idx = analyzed.idx;
-#if !defined(NVMTF) || !defined(NVSIDS)
-#ifndef NBUMP
-      INC (bumped);
-#if defined(NVMTF) || defined(NQUEUE)
-      bump_variable_score (solver, idx);
-#elif defined(NVSIDS) || defined(NHEAP)
-      move_variable_to_front (solver, idx);
+static bool
+eliminating (struct satch *solver)
+{
+#ifdef NCDCL
+  if (solver->level)
+    return false;
+#endif
+  if (!more_elimination_candidates (solver))
+#ifndef NSUBSUMPTION
+    if (!more_subsumption_candidates (solver))
+#endif
+      return false;
+#ifndef NINPROCESSING
+  return solver->limits.eliminate.conflicts < CONFLICTS;
 #else
-      if (solver->stable)
-	bump_variable_score (solver, idx);
-      else
-	move_variable_to_front (solver, idx);
+  return !solver->statistics.eliminations;
 #endif
+}
+
+/*------------------------------------------------------------------------*/
+
+// The code for switching from sparse to dense mode and back heavily relies
+// on how watches are organized ('NVIRTUAL' or even 'NBLOCK' is defined).
+
+#ifndef NVIRTUAL
+
+// This is the default routine for flushing all redundant watches where we
+// use virtual binary clauses and blocking literals.
+
+// It is the most complex variant because binary clauses reside in watches
+// only and thus the redundant binary clauses have to be saved while the
+// irredundant ones are kept.  The redundant-clause watches are flushed
+// completely, while for the redundant-clause watches we remove the header.
+
+// Furthermore, since in dense mode we only have clause references as watches
+// we need to use the same mechanism as for reasons to store binary clauses
+// (actually only the other literal) through tagged clause pointers.
+
+static void
+flush_redundant_watches (struct satch *solver, bool new_fixed)
+{
+  assert (EMPTY_STACK (solver->binaries));
+  const struct flags *const flags = solver->flags;
+#ifndef NPACKED
+  uint64_t *const arena = solver->arena.begin;
 #endif
+  for (all_literals (lit))
+    {
+      struct watches *watches = solver->watches + lit;
+      const union watch *const end = watches->end;
+      union watch *q = watches->begin, *p = q;
+      const bool lit_active = new_fixed ? true : flags[INDEX (lit)].active;
+      while (p != end)
+	{
+	  struct header header = p->header;
+	  if (header.binary)
+	    {
+	      const unsigned other = header.blocking;
+	      const bool redundant = header.redundant;
+	      const bool other_active =
+		new_fixed ? true : flags[INDEX (other)].active;
+
+	      if (lit_active && other_active)
+		{
+		  if (header.redundant)
+		    {
+		      if (lit < other)
+			{
+			  PUSH (solver->binaries, lit);
+			  PUSH (solver->binaries, other);
+			}
+		    }
+		  else
+		    q++->clause = tag_binary_clause (false, other);
+		}
+	      else
+		delete_binary (solver, redundant, lit, other);
+
+	      p++;
+	    }
+	  else
+	    {
+	      if (!header.redundant)
+		{
+#ifndef NPACKED
+		  struct clause *c =
+		    dereference_clause (arena, header.reference);
+#else
+		  struct clause *c = p[1].clause;
 #endif
-      assert (marks[idx]);
-      marks[idx] = 0;
+		  if (!new_fixed || !c->garbage)
+		    q++->clause = c;
+		}
+
+	      p += long_clause_watch_size;
+	    }
+	}
+      watches->end = q;
+      if (EMPTY_STACK (*watches))
+	RELEASE_STACK (*watches);
     }
-  CLEAR_STACK (solver->analyzed);
+  LOG ("saved %zu redundant binary clauses",
+       SIZE_STACK (solver->binaries) / 2);
+}
 
-#ifndef NVSIDS
-#ifndef NSWITCH
-  if (solver->stable)
-#endif
-    bump_score_increment (solver);
-#endif
+#elif !defined(NBLOCK)
 
-  trace_and_check_temporary_addition (solver);
+// With blocking literals but without virtual clauses the watches all have
+// both a header and a clause.  We always drop the header (the blocking
+// literal) and in addition flush the reference to redundant clauses.
 
-#ifndef NTARGET
-  assert (solver->level);
-  backtrack (solver, solver->level - 1);
-  if (solver->stable)
-    update_phases (solver);
-  if (jump_level < solver->level)
+static void
+flush_redundant_watches (struct satch *solver, bool new_fixed)
+{
+#ifndef NPACKED
+  uint64_t *const arena = solver->arena.begin;
 #endif
-    backtrack (solver, jump_level);
-
-  if (size == 1)		// Learned a unit clause.
+  for (all_literals (lit))
     {
-#ifdef NCHRONO
-      assert (!jump_level);
+      struct watches *watches = solver->watches + lit;
+      const union watch *const end = watches->end;
+      union watch *q = watches->begin;
+      for (const union watch * p = q; p != end;
+	   p += long_clause_watch_size)
+	if (!p->header.redundant)
+	  {
+#ifndef NPACKED
+	    struct clause *c = dereference_clause (arena, p->header.reference);
+	    if (!new_fixed || !c->garbage)
+	      q++->clause = c;
+#else
+	    struct clause *c = p[1].clause;
+	    if (!new_fixed || !c->garbage)
+	      *q++ = p[1];
 #endif
-      solver->iterate = true;
-      assign (solver, not_uip, 0, true);
+	  }
+      watches->end = q;
+      if (EMPTY_STACK (*watches))
+	RELEASE_STACK (*watches);
     }
-#ifndef NVIRTUAL
-  else if (size == 2)
+}
+
+#else
+
+// The simplest case without blocking literals (and also without virtual
+// binary clauses) we just flush redundant clauses. This has the same effect
+// as in the previous case (no virtual binary clauses but with blocking
+// literals) and thus when working in dense mode code we only need to
+// distinguish between having virtual binary clauses or not.
+
+static void
+flush_redundant_watches (struct satch *solver, bool new_fixed)
+{
+  for (all_literals (lit))
     {
-      const unsigned other = ACCESS (solver->clause, 1);
-      LOGBIN (true, not_uip, other, "learned");
-#ifndef NLEARN
-      add_new_binary_and_watch_it (solver, true);
-#endif
-      ADD (learned, 2);
-      struct clause *reason = tag_binary_clause (true, other);
-      assign (solver, not_uip, reason, false);
+      struct watches *watches = solver->watches + lit;
+      const union watch *const end = watches->end;
+      union watch *q = watches->begin;
+      struct clause *c;
+      for (const union watch * p = q; p != end; p++)
+	if (!(c = p->clause)->redundant && (!new_fixed || !c->garbage))
+	  *q++ = *p;
+      watches->end = q;
+      if (EMPTY_STACK (*watches))
+	RELEASE_STACK (*watches);
     }
-#endif
-  else
-    {
-      assert (size > 1);	// Learned and at least binary clause.
-      assert (jump_level > 0);
-
-      // First literal at jump-level becomes other watch.  Such a literal
-      // has to exist and thus the 'break' below has to be hit.  We further
-      // rely on backtracking not to reset the level of unassigned literals.
-      for (unsigned *p = solver->clause.begin + 1, *q = p;; q++)
-	{
-	  assert (q != solver->clause.end);
-	  const unsigned lit = *q;
-	  unsigned idx = INDEX (lit);
-	  unsigned lit_level = levels[idx];
-	  assert (lit_level <= asserting_level);
-	  if (lit_level == asserting_level)
-	    {
-	      *q = *p;
-	      *p = lit;
-	      break;
-	    }
-	}
+}
 
-#ifndef NGLUE
-      struct clause *learned = new_redundant_clause (solver, glue);
-#else
-      struct clause *learned = new_redundant_clause (solver);
 #endif
 
-#ifndef NUSED
-#ifndef NTIER2
-      if (glue <= tier2_glue_limit)
-	learned->used = 2;
-      else
-#endif
-	learned->used = 1;
-#endif
-      LOGCLS (learned, "learned");
-      ADD (learned, size);
-#ifndef NLEARN
-#ifndef NWATCHES
-      watch_clause (solver, learned);
-#else
-      connect_clause (solver, learned);
-      count_clause (solver, learned);
-#endif
-#endif
-      assign (solver, not_uip, learned, false);
+static void
+connect_occurrences_in_irredundant_clauses (struct satch *solver)
+{
+  assert (solver->dense);
+  for (all_irredundant_clauses (c))
+    {
+      const unsigned *const lits = c->literals;
+      const unsigned *const end = lits + c->size;
+      for (const unsigned *p = lits + 2; p != end; p++)
+       if (!c->garbage)
+         connect_literal (solver, *p, c);
     }
+}
 
-  CLEAR_STACK (solver->clause);
-  return true;
-#endif
+static void
+switch_to_dense_mode (struct satch *solver)
+{
+  LOG ("switching to dense mode");
+  assert (!solver->dense);
+  bool new_fixed = solver->limits.eliminate.fixed < solver->statistics.fixed;
+  if (new_fixed)
+    mark_irredundant_clauses_as_garbage_if_satisfied (solver);
+  flush_redundant_watches (solver, new_fixed);
+  solver->dense = true;
+  connect_occurrences_in_irredundant_clauses (solver);
 }
 
 /*------------------------------------------------------------------------*/
 
-#ifndef NQUEUE
-
-unsigned
-max_stamped_unassigned_variable_on_decision_queue (struct satch *solver)
-{
-  struct queue *queue = get_queue (solver);
-  const struct link *const links = queue->links;
-  const signed char *const values = solver->values;
+#ifndef NVIRTUAL
 
-  unsigned idx = queue->search;
+// With virtual binary clauses we need to make sure to keep the irredundant
+// binary clauses in the watcher stacks but otherwise drop all references.
 
-  for (;;)
+static void
+disconnect_all_clauses (struct satch *solver)
+{
+  assert (solver->dense);
+  const struct flags *const flags = solver->flags;
+  for (all_literals (lit))
     {
-      assert (idx != INVALID);
-      const unsigned lit = LITERAL (idx);
-      const signed char value = values[lit];
-      if (!value)
-	break;
-      idx = links[idx].prev;
+      struct watches *watches = solver->watches + lit;
+      const union watch *const end = watches->end;
+      union watch *q = watches->begin;
+      struct clause *c;
+      bool lit_eliminated = flags[INDEX (lit)].eliminated;
+      for (const union watch * p = q; p != end; p++)
+	if (is_tagged_clause (c = p->clause))
+	  {
+	    const unsigned other = tagged_clause_to_literal (c);
+	    const bool other_eliminated = flags[INDEX (other)].eliminated;
+	    if (!lit_eliminated && !other_eliminated)
+	      {
+		union watch watch;
+		watch.header.binary = true;
+		watch.header.redundant = false;
+		watch.header.blocking = other;
+#ifndef NPACKED
+		watch.header.reference = 0;
+#endif
+		*q++ = watch;
+	      }
+	    else
+	      delete_binary (solver, false, lit, other);
+	  }
+      watches->end = q;
     }
-  queue->search = idx;		// Cache search position.
+}
 
-  LOG ("maximum stamped unassigned %s with stamp %u",
-       LOGVAR (idx), links[idx].stamp);
+#else
 
-  return idx;
+static void
+disconnect_all_clauses (struct satch *solver)
+{
+  assert (solver->dense);
+  for (all_literals (lit))
+    CLEAR_STACK (solver->watches[lit]);
 }
 
 #endif
 
-#ifndef NHEAP
-unsigned
-max_score_unassigned_variable_on_binary_heap (struct satch *solver)
-{
-  const signed char *const values = solver->values;
-  struct heap *scores = get_scores (solver);
-
-  unsigned idx;
+#ifndef NVIRTUAL
 
-  for (;;)
+static void
+watch_saved_redundant_binaries (struct satch *solver)
+{
+  const unsigned *begin = solver->binaries.begin;
+  const unsigned *end = solver->binaries.end;
+  const struct flags *const flags = solver->flags;
+  for (const unsigned *p = begin; p != end; p += 2)
     {
-      idx = max_heap (scores);
-      const unsigned lit = LITERAL (idx);
-      const signed char value = values[lit];
-      if (!value)
-	break;
-      pop_heap (solver, scores);
+      const unsigned i[2] = { INDEX (p[0]), INDEX (p[1]) };
+      const struct flags f[2] = { flags[i[0]], flags[i[1]] };
+      const bool eliminated[2] = { f[0].eliminated, f[1].eliminated };
+      if (!eliminated[0] && !eliminated[1])
+	{
+	  watch_binary (solver, true, p[0], p[1]);
+	  watch_binary (solver, true, p[1], p[0]);
+	}
+      else
+	delete_binary (solver, true, p[0], p[1]);
     }
-
-  LOG ("maximum score unassigned %s with score %g",
-       LOGVAR (idx), scores->score[idx]);
-
-  return idx;
+  CLEAR_STACK (solver->binaries);
 }
 
 #endif
 
-/*------------------------------------------------------------------------*/
-
-// Decision variable heuristic uses exponential 'VSIDS' in stable mode and
-// 'VMTF' in focused mode unless one of these heuristics is disabled.
-
-// The different cases in this function should match those in 'reuse_trail',
-// except that the latter is only enabled if bumping is enabled too (thus we
-// can replace 'NHEAP' with 'NVSIDS' and 'NQUEUE' with 'NVMTF' there).
-
-#if !defined(DLIS) || !defined(NSAVE)
-
-static unsigned
-decide_variable (struct satch *solver)
+static void
+watch_clauses (struct satch *solver, struct clauses *clauses)
 {
-  unsigned idx;
+  for (all_pointers_on_stack (struct clause, c, *clauses))
+      watch_clause (solver, c);
+}
 
-#ifdef DLIS
-  idx = max_score_dlis (solver);
-#else
-#if defined(NHEAP)
-  idx = max_stamped_unassigned_variable_on_decision_queue (solver);
-#elif defined(NQUEUE)
-  idx = max_score_unassigned_variable_on_binary_heap (solver);
-#else
-  if (solver->stable)
-    idx = max_score_unassigned_variable_on_binary_heap (solver);
-  else
-    idx = max_stamped_unassigned_variable_on_decision_queue (solver);
-#endif
+static void
+switch_to_sparse_mode (struct satch *solver)
+{
+  LOG ("switching back to sparse mode");
+  assert (solver->dense);
+  disconnect_all_clauses (solver);
+  solver->dense = false;
+#ifndef NVIRTUAL
+  watch_saved_redundant_binaries (solver);
 #endif
-  LOG ("decision %s", LOGVAR (idx));
-
-  return idx;
+  watch_clauses (solver, &solver->irredundant);
+  watch_clauses (solver, &solver->redundant);
 }
 
-// The decision phase is the value assigned to the decision variable. In the
-// default configuration we use 'phase saving', i.e., the previous assigned
-// variable to that variable and fall back to the default phase 'true' for
-// never assigned variables (unless 'NTRUE' is defined, where the default
-// original phase value becomes 'false').  The default value is always
-// picked if phase saving is disabled ('NSAVE' is defined).
+/*------------------------------------------------------------------------*/
 
-static int
-original_phase (void)
+// Check whether a (redundant) clause contains an eliminated literal.
+
+static bool
+clause_eliminated (struct satch *solver, struct clause *c)
 {
-#ifndef NTRUE
-  return 1;			// Default is 'true'.
-#else
-  return -1;			// Otherwise 'false' (if 'NTRUE' defined).
-#endif
+  assert (c->redundant);	// Coincidentally.
+  assert (!solver->level);
+  const struct flags *const flags = solver->flags;
+  for (all_literals_in_clause (lit, c))
+    if (flags[INDEX (lit)].eliminated)
+      return true;
+  return false;
 }
 
-static int
-decide_phase (struct satch *solver, unsigned idx)
+static void
+mark_satisfied_eliminated_redundant_clauses_garbage (struct satch *solver)
 {
-  signed char value = 0;
-#ifndef NTARGET
-  if (solver->stable)
-    value = solver->targets[idx];
-#endif
-#ifndef NSAVE
-  if (!value)
-    value = solver->saved[idx];
-#endif
-  if (!value)
-    value = original_phase ();
-  LOG ("decision phase %d", (int) value);
-  (void) idx;			// Prevent unused 'idx' warning.
-  return value;
+  for (all_redundant_clauses (c))
+    if (!c->garbage)
+      {
+	if (clause_eliminated (solver, c))
+	  mark_garbage (solver, c, "eliminated");
+	else if (clause_satisfied (solver, c))
+	  mark_garbage (solver, c, "root-level satisfied");
+      }
 }
-#endif
 
-// Pick a decision variable and phase to which it is assigned as decision
-// literal. Then increase decision level and assign the decision literal.
+// The irredundant eliminated clauses have been marked explicitly already
+// but we still need to mark redundant clauses with eliminated variables.
 
 static void
-decide (struct satch *solver)
+mark_and_collect_garbage_clauses_after_elimination (struct satch *solver)
 {
-#ifdef NWATCHES
-#ifndef NVIVIFICATION
-  if (!solver->vivifying)
-#endif
-    {
-    for (all_irredundant_clauses(clause)) {
-      unsigned count = 0;
-      if (clause->garbage)
-        continue;
-      for (all_literals_in_clause(lit, clause)) {
-	if (solver->values[lit] != -1)
-	  ++count;
-      }
-      assert (count == clause->count);
-    }
-    for (all_redundant_clauses(clause)) {
-      if (clause->garbage)
-        continue;
-      unsigned count = 0;
-      for (all_literals_in_clause(lit, clause)) {
-	if (solver->values[lit] != -1)
-	  ++count;
-      }
-      assert (count == clause->count);
-    }
-  }
-#endif
-  START_IF_NCHEAP (decide);
-  INC (decisions);
+  assert (solver->dense);	// No flushing in 'clause_satisfied'!
 
-  assert (solver->unassigned);
-  assert (!solver->inconsistent);
-  assert (solver->level < solver->size);
+  if (solver->limits.eliminate.fixed < solver->statistics.fixed)
+    mark_irredundant_clauses_as_garbage_if_satisfied (solver);
 
-#ifndef NCHRONO
-  assert (solver->level == SIZE_STACK (solver->control));
-#endif
-  solver->level++;
-#if defined(DLIS) && defined(NSAVE)
-  const unsigned decision = max_score_dlis (solver);	// actually returns a literal
-#else
-  const unsigned idx = decide_variable (solver);
-  const int value = decide_phase (solver, idx);
+  mark_satisfied_eliminated_redundant_clauses_garbage (solver);
 
-  const unsigned lit = LITERAL (idx);
-  const unsigned decision = (value < 0 ? NOT (lit) : lit);
-  LOG ("decision literal %s", LOGLIT (decision));
-#endif
-  assign (solver, decision, 0, false);
-  STOP_IF_NCHEAP (decide);
+  {
+    size_t bytes = 0, count = 0;
+    delete_garbage_clauses (solver, &solver->irredundant, &bytes, &count);
+    delete_garbage_clauses (solver, &solver->redundant, &bytes, &count);
+
+    // We report on how many clauses we collected during elimination.
+
+    message (solver, 2, "elimination", solver->statistics.eliminations,
+	     "collected %zu clauses (%zu bytes, %.0f MB)",
+	     count, bytes, bytes / (double) (1u << 20));
+
+    ADD (collected, bytes);
+  }
 }
 
 /*------------------------------------------------------------------------*/
 
-// Report verbose message lines listing the following statistics. We use the
-// same trick as for signal handlers in 'main.c' and for profiles above of
-// listing all different reported statistics as 'REPORT' item in 'REPORTS'.
-// Then we redefine 'REPORT' to instantiate 'REPORTS' accordingly.
+#ifndef NSUBSUMPTION
 
-// *INDENT-OFF*
+// Assume 'size' literals have been marked.  Then try to find a clause
+// different from 'skip' in which the literal 'lit' occurs and has all the
+// marked literals.  This clause is then subsumed and marked garbage.  We also
+// perform strengthening through self-subsuming resolution, which removes
+// individual literals from clauses which are almost subsumed except for one
+// literal which occurs negated.
 
-#define REPORTS \
-REPORT(seconds, "%.2f") \
-REPORT(MB, "%.0f") \
-REPORT(level, "%.0f") \
-REPORT_IF_SWITCH(switched, "%" PRIu64) \
-REPORT_IF_REDUCE(reductions, "%" PRIu64) \
-REPORT_IF_RESTART(restarts, "%" PRIu64) \
-REPORT(rate, "%.0f") \
-REPORT(conflicts, "%" PRIu64) \
-REPORT_IF_LEARN(redundant, "%" PRIu64) \
-REPORT(trail, "%.0f%%") \
-REPORT(glue, "%.0f") \
-REPORT(irredundant, "%" PRIu64) \
-REPORT(variables, "%" PRIu64) \
-REPORT(remaining, "%.0f%%")
+// The clause literal 'traversed' denotes a literal whose watches are
+// currently traversed (the 'lit' in 'backward_subsume_literal').  If we
+// modify its watches we have to abort that traversals since iterators
+// (pointers into the stack) become invalid.
 
-// Need to exclude 'restart' and 'reduce' reports if disabled.
+static bool
+backward_subsume_marked (struct satch *solver,
+			 unsigned size, unsigned lit,
+			 struct clause *skip, unsigned traversed)
+{
+#ifdef NSTRENGTHENING
+  (void) traversed;
+#endif
+  assert (solver->flags[INDEX (lit)].active);
 
-#define DO_NO_REPORT(A,B) /**/
+  struct watches *const watches = solver->watches + lit;
+  const signed char *const values = solver->values;
+  const signed char *const marks = solver->marks;
 
-#ifdef NSWITCH
-#define REPORT_IF_SWITCH DO_NO_REPORT
-#else
-#define REPORT_IF_SWITCH REPORT
+  bool touched = false;		// Traversed literal watches touched.
+
+  assert (!solver->level);
+
+  uint64_t ticks = 1 + CACHE_LINES_OF_STACK (watches);
+
+  ADD (subsumption_ticks, ticks);
+
+  const union watch *const end_of_watches = watches->end, *p;
+  union watch *q = watches->begin;
+
+  for (p = q; p != end_of_watches; p++)
+    {
+      const union watch watch = *q++ = *p;
+#ifdef NVIRTUAL
+      if (solver->inconsistent)
+	continue;
+#endif
+      struct clause *c = watch.clause;
+      if (c == skip)
+	continue;
+
+#ifndef NVIRTUAL
+      if (is_tagged_clause (c))
+	{
+	  // We use 'remove_duplicated_virtual_binary_clauses' instead.
+	  continue;
+	}
+      else
 #endif
+	{
+	  ticks++;
+	  if (c->garbage)
+	    continue;
+	}
+
+      if (c->size < size)
+	continue;
 
-#ifdef NLEARN
-#define REPORT_IF_LEARN DO_NO_REPORT
-#else
-#define REPORT_IF_LEARN REPORT
+      bool satisfied = false;	// Clause actually satisfied.
+      unsigned clashed = 0;	// How many clashing literals.
+      unsigned found = 0;	// How many literals found.
+#ifndef NSTRENGTHENING
+      unsigned clashing = INVALID;	// The last clashing literal.
 #endif
-
-#ifdef NRESTART
-#define REPORT_IF_RESTART DO_NO_REPORT
+      for (all_literals_in_clause (other, c))
+	{
+	  const signed char value = values[other];
+	  if (value > 0)
+	    {
+	      satisfied = true;
+	      break;
+	    }
+	  if (value < 0)
+	    continue;
+	  const signed char mark = marked_literal (marks, other);
+	  if (!mark)
+	    continue;
+	  if (mark < 0)
+	    {
+#ifndef NSTRENGTHENING
+	      if (clashed++)
+		break;
+	      clashing = other;
 #else
-#define REPORT_IF_RESTART REPORT
+	      clashed = 1;
+	      break;
 #endif
+	    }
+	  else
+	    assert (mark > 0);
+	  found++;
+	}
 
-#ifdef NREDUCE
-#define REPORT_IF_REDUCE DO_NO_REPORT
+#ifndef NSTRENGTHENING
+      if (clashed > 1)
+	continue;
 #else
-#define REPORT_IF_REDUCE REPORT
+      if (clashed)
+	continue;
 #endif
+      if (satisfied)
+	{
+	  mark_garbage (solver, c, "root-level satisfied");
+	  continue;
+	}
 
-#define MAX_HEADER      3	// Number of header lines.
-#define MAX_LINE        256	// Maximum expected line length.
-#define MAX_REPORTS     16	// Maximum number of reported values.
+      if (found < size)
+	continue;
 
-// *INDENT-ON*
+      assert (found == size);
 
-static void
-report (struct satch *solver, unsigned verbose, int type)
-{
-  if (solver->options.verbose < verbose)
-    return;
+#ifndef NSTRENGTHENING		// Begin of strengthening code.
 
-  INC (reported);
+      if (clashed)
+	{
+#ifndef NSUBSUMPTIONLIMITS
+	  {
+	    const size_t occs = SIZE_STACK (solver->watches[clashing]);
+	    if (occs >= strengthening_occurrence_limit)
+	      continue;
+	  }
+#endif
+	  assert (clashed == 1);
+	  assert (clashing != INVALID);
+	  LOGCLS (c, "single clashing literal %s", LOGLIT (clashing));
 
-  // If you want to print a certain statistic you need to add a line to the
-  // 'REPORTS' macro above and also define a matching local constant here.
+	  // The negation of this assertion as a coverage hole was never
+	  // triggered, It could be accommodated by setting 'touched = true'
+	  // in this case, but as it never happens we added this assertion.
 
-  struct averages *a = averages (solver);
-  const double seconds = process_time ();
-  const double MB = current_resident_set_size () / (double) (1 << 20);
-  const double level = unbiased_slow_average (a, a->conflict_level);
-#ifndef NSWITCH
-  const uint64_t switched = solver->statistics.switched;
-#endif
-#ifndef NREDUCE
-  const uint64_t reductions = solver->statistics.reductions;
-#endif
-#ifndef NRESTART
-  const uint64_t restarts = solver->statistics.restarts;
-#endif
-  const double rate = unbiased_slow_average (a, a->decision_rate);
-  const uint64_t conflicts = CONFLICTS;
-#ifndef NLEARN
-  const uint64_t redundant = solver->statistics.redundant;
-#endif
-  const double trail = unbiased_slow_average (a, a->trail_filled);
-  const double glue = unbiased_slow_average (a, a->slow_glue);
-  const uint64_t irredundant = solver->statistics.irredundant;
-  const uint64_t variables = solver->statistics.remaining;
-  double remaining = percent (variables, solver->statistics.variables);
+	  assert (clashing != traversed);
 
-  // Start formatting the values in 'line'.
+#ifdef NVIRTUAL
+	  unsigned unit = INVALID;
+	  if (c->size == 2)
+	    {
+	      for (all_literals_in_clause (other, c))
+		if (other != clashing)
+		  assert (unit == INVALID), unit = other;
+	      assert (unit != INVALID);
 
-  int num_reported = 0;		// Number of reported values.
+	      const signed char value = solver->values[unit];
+	      assert (value <= 0);
+	      if (value < 0)
+		{
+		  trace_and_check_empty_addition (solver);
+		  LOG ("inconsistent unit %s resolved", LOGLIT (unit));
+		  solver->inconsistent = true;
+		  touched = true;
+		  continue;
+		}
+	    }
+#endif
+	  trace_and_check_clause_addition (solver, c, clashing);
+	  trace_and_check_clause_deletion (solver, c);
 
-  int column[MAX_REPORTS];	// Save start of columns to format headers.
-  char line[MAX_LINE];		// Actual line of values printed.
-  int end_line = 0;		// End of the value line.
+	  mark_eliminate_literal (solver, clashing);
+#ifdef NVIRTUAL
+	  if (c->size == 2)
+	    {
+	      LOG ("resolved unit %s", LOGLIT (unit));
+	      assert (unit != INVALID);
+	      assert (!solver->values[unit]);
+	      assign (solver, unit, 0, false);
+	    }
+	  else
+#endif
+	    {
+	      assert (c->size > 2);
+	      if (lit == clashing)
+		{
+		  LOGCLS (c, "disconnecting %s from", LOGLIT (lit));
+		  q--;
+		}
+	      else
+		{
+		  ticks++;
+		  disconnect_literal (solver, clashing, c);
+		}
 
-  line[end_line++] = 'c';
+	      for (all_literals_in_clause (other, c))
+		if (other != clashing)
+		  mark_subsume_literal (solver, other);
+	    }
 
-  // The values line has the following two characters less space than the
-  // header lines which makes some room for the first header to stick out to
-  // the left (this is also necessary for the usual 'seconds' header).
+#ifndef NVIRTUAL
 
-  line[end_line++] = ' ';
-  line[end_line++] = type;
+	  // Ternary clauses become virtual binary clauses.
 
-  // Print values to 'line' remembering starting positions and widths.
+	  if (c->size == 3)
+	    {
+	      c->garbage = true;
+	      unsigned first = INVALID, second = INVALID;
 
-// *INDENT-OFF*
+	      for (all_literals_in_clause (other, c))
+		if (other != clashing)
+		  {
+		    if (first == INVALID)
+		      first = other;
+		    else
+		      {
+			assert (second == INVALID);
+			second = other;
+		      }
+		    disconnect_literal (solver, other, c);
+		  }
+	      assert (first != INVALID);
+	      assert (second != INVALID);
+	      connect_literal (solver, first, tag_binary_clause (0, second));
+	      connect_literal (solver, second, tag_binary_clause (0, first));
+	      touched = (first == traversed || second == traversed);
+	      ticks += 2;
+	    }
+	  else
+#else
+	  if (c->size > 2)
+#endif
+	    {
+	      // Keep clause as is but remove a literal and reduce size.
 
-#define REPORT(NAME,FMT) \
-  { \
-    assert (end_line < MAX_LINE); \
-    line[end_line++] = ' '; \
-    column[num_reported++] = end_line; \
-    char buffer[32]; \
-    sprintf (buffer, FMT, NAME); \
-    for (const char * p = buffer; *p; p++) \
-      assert (end_line < MAX_LINE), \
-      line[end_line++] = *p; \
-  }
-  REPORTS
-#undef REPORT
+	      unsigned *r = c->literals;
+	      const unsigned *end_of_literals = r + c->size;
+	      while (assert (r != end_of_literals), *r != clashing)
+		r++;
+	      while (++r != end_of_literals)
+		r[-1] = *r;
 
-// *INDENT-ON*
+	      c->size--;
+#ifndef NGLUE
+	      assert (!c->glue);
+#endif
+#ifndef NCACHE
+	      c->search = 0;
+#endif
+	      LOGCLS (c, "strengthened");
+	      INC (strengthened);
+	    }
+	}
+      else
+#endif // if '#ifndef NSTRENGTHENING' so end of strengthening code.
 
-  // Initially and after 16 rows without printing a header we print one.
-  // This gives 20 rows with 3 header lines (and one empty line) which
-  // perfectly matches typical (classical small) terminal height of 24.
+	{
+	  mark_garbage (solver, c, "subsumed");
+	  INC (subsumed);
+	}
+    }
+  watches->end = q;
+  if (EMPTY_STACK (*watches))
+    RELEASE_STACK (*watches);
 
-  COLORS (1);
+  ADD (subsumption_ticks, ticks);
 
-  if ((solver->statistics.reported % 16) == 1)
-    {
-      char header[MAX_HEADER][MAX_LINE];
-      int end_header[MAX_HEADER];
+#ifdef LOGGING
+  if (touched)
+    LOG ("watches of traversed literal %s touched", LOGLIT (traversed));
+#endif
 
-      for (int i = 0; i < MAX_HEADER; i++)
-	{
-	  header[i][0] = 'c';
-	  end_header[i] = 1;
-	}
+  return touched;
+}
 
-      int reported = 0;
+// Use the given clause to subsume other connected clauses.
 
-      // This is the really tricky part to get a nicely adjusted header for
-      // the columns of values which vary in size.  The goal is to keep the
-      // column names in the middle above the values split in different
-      // header rows so that they do not overlap.  It becomes even more
-      // complicated due to the possibility that strings for header names
-      // can be smaller or larger than the value strings.
+// We only traverse the occurrence list of a single literal in the clause
+// with the smallest number of occurrences to find subsumed clauses and also
+// bound the maximum size of that list as well as the size of clauses.
 
-// *INDENT-OFF*
+// Furthermore only clauses with all literals (actually variables) marked as
+// subsume candidate will be considered, since newly added clauses will mark
+// their variables as subsume candidates.
 
-#define REPORT(NAME, FMT) \
-      { \
-        const int row = reported % MAX_HEADER; \
-        assert (end_header[row] < MAX_LINE); \
-        header[row][end_header[row]++] = ' '; \
-        assert (reported < num_reported); \
-        const int start = column[reported++]; \
-        const int end = \
-          (reported == num_reported ? end_line : column[reported]); \
-        const int value_width = end - start - 1; \
-        const int name_width = strlen (#NAME); \
-        int target; \
-        if (name_width > value_width) \
-          target = start - (name_width - value_width + 1)/2; \
-        else \
-          target = start + (value_width - name_width + 1)/2; \
-        assert (target <= MAX_LINE); \
-        while (end_header[row] < target) \
-          { \
-            assert (end_header[row] < MAX_LINE); \
-            header[row][end_header[row]++] = ' '; \
-          } \
-        for (const char * p = #NAME; *p; p++) \
-          { \
-            assert (end_header[row] < MAX_LINE); \
-            header[row][end_header[row]++] = *p; \
-          } \
-      }
-      REPORTS
-#undef REPORT
+// If the watch list of the 'traversed' literals is modified we return 'true'
+// in order for the calling function ('backward_subsume_literal') to restart
+// the watch list traversal (because its iterators became invalid).
 
-// *INDENT-ON*
+static bool
+backward_subsume_with_clause (struct satch *solver,
+			      struct clause *c, unsigned traversed)
+{
+#ifndef NVIRTUAL
+  if (!is_temporary_binary (solver, c))
+#endif
+    {
+      assert (!c->subsumed);
+      c->subsumed = true;
+    }
 
-      fputs ("c\n", stdout);
+  assert (!solver->level);
+  LOGCLS (c, "backward subsumption with");
+  assert (!c->redundant);
 
-      // Print the header lines.
+  bool satisfied = false;	// Clause 'c' satisfied.
+  bool touched = false;		// Literal 'traverse' watches touched.
+  bool subsume = true;		// All literals in 'c' marked 'subsume'.
 
-      for (int i = 0; i < MAX_HEADER; i++)
-	{
-	  fputc ('c', stdout);
-	  COLOR (YELLOW);
-	  for (int j = 1; j < end_header[i]; j++)
-	    fputc (header[i][j], stdout);
-	  COLOR (NORMAL);
-	  fputc ('\n', stdout);
-	}
+  uint64_t min_pos_occs = UINT64_MAX;
+  uint64_t min_neg_occs = UINT64_MAX;
+  unsigned min_pos_lit = INVALID;
+  unsigned min_neg_lit = INVALID;
 
-      fputs ("c\n", stdout);
-    }
+  unsigned actual_size = 0;
 
-  // Print the values line.
+  const struct watches *const watches = solver->watches;
+  const struct flags *const flags = solver->flags;
+  const signed char *values = solver->values;
+  signed char *marks = solver->marks;
 
-  fputs ("c ", stdout);
+  uint64_t ticks = 2;		// Clause plus watch list.
 
-#ifndef NCOLOR
-  bool reset = false;
-  if (colors)
+  for (all_literals_in_clause (lit, c))
     {
-      bool magenta = false;
+      signed char value = values[lit];
 
-      switch (type)
+      if (value > 0)
 	{
-	case '0':
-	case '1':
-	case '?':
-	case 'i':
-	  fputs (BOLD_CODE, stdout);
-	  reset = true;
-	  break;
-	case 's':
-	  fputs (GREEN_CODE, stdout);
-	  reset = true;
-	  break;
-	case 'e':
-	  fputs (BOLD_GREEN_CODE, stdout);
-	  reset = true;
-	  break;
-	case '[':
-	case ']':
-	  fputs (MAGENTA_CODE, stdout);
-	  magenta = true;
+	  LOG ("contains satisfied literal %s", LOGLIT (lit));
+	  satisfied = true;
 	  break;
 	}
 
-      assert (line[2] == type);
-      fputc (line[2], stdout);
-
-      if (reset)
-	fputs (NORMAL_CODE, stdout);
+      if (value < 0)
+	continue;
 
-      if (magenta)
-	reset = true;
-      else if (solver->stable)
+      const unsigned idx = INDEX (lit);
+      if (!flags[idx].subsume)
 	{
-	  fputs (MAGENTA_CODE, stdout);
-	  reset = true;
+	  LOG ("contains non-subsumption candidate %s", LOGVAR (idx));
+	  subsume = false;
+	  break;
 	}
-    }
-  else
-#endif
-    fputc (line[2], stdout);
-
-  for (int i = 3; i < end_line; i++)
-    fputc (line[i], stdout);
-#ifndef NCOLOR
-  if (reset)
-    fputs (NORMAL_CODE, stdout);
-#endif
-  fputc ('\n', stdout);
 
-  fflush (stdout);
-}
-
-/*------------------------------------------------------------------------*/
+      // Otherwise mark the literal for the subsumption check.
 
-// Report statistics after a unit clause has been learned and propagated.
+      mark_literal (marks, lit);
+      actual_size++;
 
-// The reason for not reporting a unit immediately, when it is learned in
-// 'analyze' above, is that such a learned root-level unit often implies
-// many other literals on the root-level too and we prefer to see this
-// effect of learning the unit instead of when exactly it was learned.
+      ticks++;
 
-static void
-iterate (struct satch *solver)
-{
-  report (solver, 1, 'i');
-  solver->iterate = false;
-}
+      const size_t pos_occs = SIZE_STACK (watches[lit]);
+      if (pos_occs < min_pos_occs)
+	min_pos_occs = pos_occs, min_pos_lit = lit;
 
-/*------------------------------------------------------------------------*/
+      const unsigned not_lit = NOT (lit);
 
-// Functions used for scaling conflict and ticks intervals.
+      const size_t neg_occs = SIZE_STACK (watches[not_lit]);
+      if (neg_occs < min_neg_occs)
+	min_neg_occs = neg_occs, min_neg_lit = not_lit;
+    }
 
-#ifndef NRESTART
+  ADD (subsumption_ticks, ticks);
 
-static double
-logn (uint64_t n)
-{
-  assert (n);
-  const double res = log10 (n + 9);
-  assert (res >= 1);
-  return res;
-}
+  if (satisfied)
+    {
+#ifndef NVIRTUAL
+      if (!is_temporary_binary (solver, c))
+#endif
+	mark_garbage (solver, c, "root-level satisfied");
+    }
+  else if (subsume)
+    {
+      LOG ("actual size %u %s clause size %u", actual_size,
+	   actual_size < c->size ? "smaller" : "matches", c->size);
 
+#ifndef NSUBSUMPTIONLIMITS
+      if (min_pos_occs <= subsumption_occurrence_limit)
 #endif
+	{
+	  COVER (min_pos_lit == INVALID);
+	  assert (min_pos_lit != INVALID);
 
-#if (!defined(NELIMINATION)) && !defined(NINPROCESSING)
+	  LOG ("minimum positive occurrences %" PRIu64 " literal %s",
+	       min_pos_occs, LOGLIT (min_pos_lit));
 
-static double
-nlognlogn (uint64_t n)
-{
-  assert (n);
-  const double tmp = log10 (n + 9);
-  assert (tmp >= 1);
-  const double res = n * tmp * tmp;
-  assert (res >= 1);
-  return res;
-}
+	  if (backward_subsume_marked (solver, actual_size,
+				       min_pos_lit, c, traversed))
+	    touched = true;
+	}
+#ifdef NVIRTUAL
+      if (!solver->inconsistent && !solver->values[min_neg_lit])
+#endif
+#ifndef NSUBSUMPTIONLIMITS
+	if (min_neg_occs <= subsumption_occurrence_limit)
 #endif
+	  {
+	    COVER (min_neg_lit == INVALID);
+	    assert (min_neg_lit != INVALID);
 
-#ifndef NVIVIFICATION
-static double
-nlogn (uint64_t n)
-{
-  assert (n);
-  const double tmp = log10 (n + 9);
-  assert (tmp >= 1);
-  const double res = n * tmp;
-  assert (res >= 1);
-  return res;
-}
+	    LOG ("minimum negative occurrences %" PRIu64 " literal %s",
+		 min_neg_occs, LOGLIT (min_neg_lit));
 
-#endif
+	    if (backward_subsume_marked (solver, actual_size,
+					 min_neg_lit, c, traversed))
+	      touched = true;
+	  }
+    }
 
-#ifndef NREPHASE
+  for (all_literals_in_clause (lit, c))
+    unmark_literal (marks, lit);
 
-static double
-nlognlognlogn (uint64_t n)
-{
-  assert (n);
-  const double tmp = log10 (n + 9);
-  assert (tmp >= 1);
-  const double res = n * tmp * tmp * tmp;
-  assert (res >= 1);
-  return res;
+  return touched;
 }
 
+static void
+backward_subsume_literal (struct satch *solver, unsigned lit)
+{
+#ifdef NVIRTUAL
+  if (solver->inconsistent || solver->values[lit])
+    return;
 #endif
 
-#ifndef NREDUCE
-
-static double
-ndivlogn (uint64_t n)
-{
-  assert (n);
-  const double div = log10 (n + 9);
-  assert (div > 0);
-  const double res = n / div;
-  assert (res >= 1);
-  return res;
-}
+  INC (subsumption_ticks);
 
+  const struct watches *const watches = solver->watches + lit;
+#ifndef NSUBSUMPTIONLIMITS
+  if (SIZE_STACK (*watches) > subsumption_occurrence_limit)
+    return;
 #endif
 
-#ifndef NSWITCH
+  LOG ("backward subsumption with clauses containing literal %s",
+       LOGLIT (lit));
 
-static double
-quadratic (uint64_t n)
-{
-  assert (n);
-  const double res = n * n;
-  assert (res >= 1);
-  return res;
-}
+  uint64_t ticks = CACHE_LINES_OF_STACK (watches);
 
-#endif
+RESTART:			// If 'watches' touched (added or removed watches).
 
-#if (defined(NELIMINATION) || defined(NINPROCESSING)) && defined (NVIVIFICATION)
-#ifdef NREDUCE
-#ifdef NREPHASE
-#ifdef NSWITCH
-#define NSCALE
-#endif
+  for (all_elements_on_stack (union watch, watch, *watches))
+    {
+      struct clause *c = watch.clause;
+#ifndef NVIRTUAL
+      if (is_tagged_clause (c))
+	c = untag_clause (solver, 0, lit, c);	// 1st temporary
+      else
 #endif
+	{
+	  ticks++;
+	  if (c->garbage || c->subsumed)
+	    continue;
+	}
+#ifndef NSUBSUMPTIONLIMITS
+      if (c->size <= subsumption_clause_size_limit)
 #endif
+	if (backward_subsume_with_clause (solver, c, lit))
+	  {
+#ifdef NVIRTUAL
+	    if (solver->inconsistent || solver->values[lit])
+	      break;
 #endif
+	    LOG ("need to restart traversing %s watches", LOGLIT (lit));
+	    goto RESTART;
+	  }
+    }
 
-#ifndef NSCALE
-
-// Use one of the above scaling functions to scale the base interval based
-// on the number of counts given as last argument.  For instance if you want
-// to set the conflict limit for the next clause reduction in 'reduce',
-// which was just was executed 'count' times, then for scaling the 'base'
-// interval between 'reduce' quadratically you would  use 'quadratic' as
-// argument for 'scale' (and 'base' and 'count' as further arguments).
-
-static double
-scale_interval (uint64_t base, double (*scale) (uint64_t), uint64_t count)
-{
-  assert (count > 0);
-  double scaling = scale (count);
-  assert (scaling >= 1);
-  double res = base * scaling;
-  assert (res >= 1);
-  return res;
+  ADD (subsumption_ticks, ticks);
 }
 
-#endif
+#ifndef NVIRTUAL
 
-/*------------------------------------------------------------------------*/
+// In 'backward_subsume_marked' we skip over tagged clauses because if such a
+// tagged clause is subsumed the watch has to be removed immediately instead
+// of marking it 'garbage'.  This is pretty awkward in that context and thus
+// we implement a dedicated routine below to just do that.  It actually does
+// all virtual binary clause (self-) subsumption of that literal in one go
+// and thus we also do not enforce an occurrence limit.
 
-// Before restarting we can figure out the maximum number of decisions that
-// will be picked in the same way as they are currently picked.  If we find
-// such a non-empty decision prefix of the trail we can reuse it and will
-// not backtrack over it.  This is the strongest version of reusing the
-// trail using the 'matching trail level' (MTL).  For weaker versions, both
-// the 'permutation' (PTL) and 'reuse' trail level (RTL), we got worse
-// results.  Thus we use the strongest one in contrast to previous solvers.
+static bool
+remove_duplicated_virtual_binary_clauses (struct satch *solver, unsigned lit)
+{
+  LOG ("removing duplicated virtual binary clauses with %s", LOGLIT (lit));
+  assert (solver->flags[INDEX (lit)].active);
+  assert (!solver->level);
 
-#ifndef NREUSE
+  struct watches *const watches = solver->watches + lit;
+  const union watch *const end = watches->end;
+  union watch *q = watches->begin, *p = q;
 
-#ifndef NVMTF
+  uint64_t ticks = 1 + cache_lines (watches->begin, watches->end);
 
-// Decisions are picked based on the enqueue time stamp.
+  signed char *marks = solver->marks;
+  bool assigned = false;
 
-static unsigned
-reuse_stamped_trail (struct satch *solver)
-{
-#ifndef NCHRONO
-  return reuse_stamped_trail_from (solver, 1);
-#else
-  unsigned next = max_stamped_unassigned_variable_on_decision_queue (solver);
-  const struct link *const links = solver->queue[solver->stable].links;
-  struct clause *const *const reasons = solver->reasons;
-  const unsigned next_stamp = links[next].stamp;
-  unsigned decision_stamp = UINT_MAX;
-  for (all_elements_on_stack (unsigned, lit, solver->trail))
+  while (!assigned && p != end)
     {
-      const unsigned idx = INDEX (lit);
-      const unsigned stamp = links[idx].stamp;
-      if (decision_stamp < stamp || stamp < next_stamp)
-	return solver->levels[idx] - 1;
-      if (!reasons[idx])
-	decision_stamp = stamp;
+      const union watch watch = *p++;
+      struct clause *c = watch.clause;
+      if (is_tagged_clause (c))
+	{
+	  const unsigned other = tagged_clause_to_literal (c);
+	  const signed char mark = marked_literal (marks, other);
+	  if (mark > 0)
+	    {
+	      really_delete_binary (solver, false, lit, other);
+	      struct clause *d = tag_binary_clause (false, lit);
+	      disconnect_literal (solver, other, d);
+	      INC (subsumed);
+	      ticks++;
+	      continue;
+	    }
+	  if (mark < 0)
+	    {
+	      LOG ("self-subsuming virtual binary unit %s", LOGLIT (lit));
+	      trace_and_check_unit_addition (solver, lit);
+	      INC (strengthened);
+	      assign (solver, lit, 0, true);
+	      assigned = true;
+	    }
+	  else
+	    mark_literal (marks, other);
+	}
+      *q++ = watch;
     }
-  return solver->level;
-#endif
-}
 
-#endif
+  for (const union watch * r = watches->begin; r != q; r++)
+    if (is_tagged_clause (r->clause))
+      unmark_literal (marks, tagged_clause_to_literal (r->clause));
 
-#ifndef NVSIDS
+  while (p != end)
+    *q++ = *p++;
 
-// Decisions are picked based on their EVSIDS score.
+  watches->end = q;
 
-static unsigned
-reuse_scored_trail (struct satch *solver)
-{
-#ifndef NCHRONO
-  return reuse_scored_trail_from (solver, 1);
-#else
-  unsigned next = max_score_unassigned_variable_on_binary_heap (solver);
-  const double *const scores = solver->scores[solver->stable].score;
-  struct clause *const *const reasons = solver->reasons;
-  const double next_score = scores[next];
-  double decision_score = MAX_SCORE;
-  for (all_elements_on_stack (unsigned, lit, solver->trail))
-    {
-      const unsigned idx = INDEX (lit);
-      const double score = scores[idx];
-      if (decision_score < score || score < next_score)
-	return solver->levels[idx] - 1;
-      if (!reasons[idx])
-	decision_score = score;
-    }
-  return solver->level;
-#endif
+  ADD (subsumption_ticks, ticks);
+
+  return !assigned;
 }
 
 #endif
 
-// The logic of which decision heuristic to use is complex and hidden in
-// this function (which needs to have the same cases as 'decide_variable').
-
-static unsigned
-reuse_trail (struct satch *solver)
+static void
+backward_subsume_variable (struct satch *solver, unsigned idx)
 {
-  unsigned res;
-
-  assert (solver->level);
-  assert (!EMPTY_STACK (solver->trail));
-  assert (solver->levels[INDEX (ACCESS (solver->trail, 0))]);
-
-#if defined(NVMTF) && defined(NVSIDS)
-  res = 0;
-#else
-#ifdef NREUSESTABLE
-  if (solver->stable)
-    res = 0;
-  else
-#endif
-    {
-#if defined(NHEAP)
-      res = reuse_stamped_trail (solver);
-#elif defined(NQUEUE)
-      res = reuse_scored_trail (solver);
-#else
-      if (solver->stable)
-	res = reuse_scored_trail (solver);
-      else
-	res = reuse_stamped_trail (solver);
-#endif
-    }
-#endif
+  LOG ("backward subsumption with clauses containing %s", LOGVAR (idx));
+  assert (solver->flags[idx].subsume);
+  assert (solver->flags[idx].active);
 
-  if (res)
-    {
-      message (solver, 4, "restart", solver->statistics.restarts,
-	       "reusing trail up-to level %u out of %u levels %.0f%%",
-	       res, solver->level, percent (res, solver->level));
-      INC (reused);
-    }
-  else
-    LOG ("trail not reused");
+  const unsigned lit = LITERAL (idx);
+  const unsigned not_lit = NOT (lit);
+#ifndef NVIRTUAL
+  if (!remove_duplicated_virtual_binary_clauses (solver, lit))
+    return;
+  if (!remove_duplicated_virtual_binary_clauses (solver, not_lit))
+    return;
+#endif
+  backward_subsume_literal (solver, lit);
+  backward_subsume_literal (solver, not_lit);
 
-  return res;
+  solver->flags[idx].subsume = 2;
+}
+
+#ifndef NSUBSUMPTIONLIMITS
+
+static bool
+subsumption_ticks_limit_hit (struct satch *solver)
+{
+  return solver->statistics.subsumption_ticks > solver->limits.subsume.ticks;
 }
 
 #endif
 
-/*------------------------------------------------------------------------*/
+static void
+full_backward_subsumption (struct satch *solver)
+{
+  if (!more_subsumption_candidates (solver))
+    return;
 
-// Restarts are in principle triggered by restart intervals (measured in the
-// number of conflicts passed).  However in focused mode we use exponential
-// moving averages of the glucose level (glue) of learned clauses to
-// determine whether we are in a phase where those levels go down or
-// increase.  If the glue goes down we do not restart but if it goes up,
-// that is the fast moving average is above a certain margin over the slower
-// moving average, then we restart.
+  START (subsume);
+  const uint64_t subsumptions = INC (subsumptions);
 
-#ifndef NRESTART
+  LOG ("backward subsumption with clauses containing subsume candidates");
 
-static bool
-restarting (struct satch *solver)
-{
-  assert (solver->unassigned);
-  assert (!solver->inconsistent);
+  struct flags *flags = solver->flags;
 
-  if (!solver->level)
-    return false;
-  if (solver->limits.restart > CONFLICTS)
-    return false;
+  uint64_t total_subsumed = 0, total_strengthened = 0;
+  uint64_t strengthened;
+  unsigned round = 0;
 
-#ifndef NSTABLE
+  do
+    {
+      round++;
 
-  // Use only (large) conflict intervals in stable mode to trigger restarts.
-  // However during computing the next restart limit below we use reluctant
-  // doubling of the base restart interval (also called 'Luby' scheme).
+      const uint64_t subsumed_before = solver->statistics.subsumed;
+      const uint64_t strengthened_before = solver->statistics.strengthened;
+      const unsigned remaining = solver->statistics.remaining;
+      unsigned scheduled = 0, tried = 0;
 
-  if (solver->stable)
-    return true;
+      for (all_variables (idx))
+	{
+	  struct flags *f = flags + idx;
+	  if (f->active && (f->subsume &= 1))
+	    scheduled++;
+	}
 
+      for (all_variables (idx))
+	{
+	  struct flags *f = flags + idx;
+	  if (f->active && f->subsume)
+	    {
+	      backward_subsume_variable (solver, idx);
+	      tried++;
+#ifndef NSUBSUMPTIONLIMITS
+	      if (subsumption_ticks_limit_hit (solver))
+		{
+		  message (solver, 4, "subsumption", subsumptions,
+			   "subsumption ticks limit hit");
+		  break;
+		}
 #endif
+	    }
+	}
 
-  struct averages *a = averages (solver);
+      message (solver, 3, "subsumption", subsumptions,
+	       "tried %u variables %.0f%% of %u scheduled %.0f%%"
+	       " in round %u", tried, percent (tried, scheduled),
+	       scheduled, percent (scheduled, remaining), round);
 
-  const double fast = unbiased_fast_average (a, a->fast_glue);
-  const double slow = unbiased_slow_average (a, a->slow_glue);
-  const double limit = restart_margin * slow;
+      uint64_t subsumed = solver->statistics.subsumed - subsumed_before;
+      strengthened = solver->statistics.strengthened - strengthened_before;
 
-  return limit <= fast;
-}
+      total_subsumed += subsumed;
+      total_strengthened += strengthened;
 
-static void
-restart (struct satch *solver)
-{
-  const uint64_t restarts = INC (restarts);
-  message (solver, 4, "restart", restarts,
-	   "restarting after %" PRIu64 " conflicts (limit %" PRIu64 ")",
-	   CONFLICTS, solver->limits.restart);
-  report (solver, 3, 'r');
+      message (solver, 3, "subsumption", subsumptions,
+	       "subsumed %" PRIu64 " and strengthened %" PRIu64
+	       " clauses in round %u", subsumed, strengthened, round);
 
-#ifndef NTARGET
-  if (solver->stable)
-    update_phases (solver);
+      report (solver, 1 + !(subsumed + strengthened), 's');
+#ifndef NSUBSUMPTIONLIMITS
+      if (round >= subsumption_rounds)
+	break;
+      if (subsumption_ticks_limit_hit (solver))
+	break;
 #endif
+    }
+  while (!solver->inconsistent && strengthened);
 
-#ifndef NREUSE
-  {
-    unsigned new_level = reuse_trail (solver);
-    if (new_level < solver->level)
-      backtrack (solver, new_level);
-  }
-#else
-  backtrack (solver, 0);
-#endif
+  for (all_irredundant_clauses (c))
+    c->subsumed = false;
 
-  uint64_t interval;
-#ifndef NSTABLE
-  if (solver->stable)
+  unsigned kept = 0;
+  for (all_variables (idx))
     {
-      // This is the approach of Donald Knuth to compute the 'reluctant
-      // doubling' sequence. In other solvers it is called 'Luby' sequence.
-      // We further use a much longer base interval than in focused mode.
+      struct flags *f = flags + idx;
+      if (f->active & (f->subsume & 1))
+	kept++;
+    }
 
-      struct reluctant *r = &solver->reluctant;
-      uint64_t u = r->u, v = r->v;
+  message (solver, 3, "subsumption", subsumptions,
+	   "keeping %u variables scheduled %.0f%%",
+	   kept, percent (kept, solver->statistics.remaining));
 
-      // The base interval is multiplied with the reluctant doubling
-      // sequence number (1,2,1,1,2,4,1,1,2,4,8,1,1,2,1,1,2,4,1,1,...).
+  if (!kept)
+    solver->limits.subsume.marked = solver->statistics.marked_subsume;
 
-      interval = v * stable_restart_interval;
+  message (solver, 2, "subsumption", subsumptions,
+	   "subsumed %" PRIu64 " and strengthened %" PRIu64
+	   " clauses in %u rounds",
+	   total_subsumed, total_strengthened, round);
 
-      if ((u & -u) == v)
-	u++, v = 1;
-      else
-	assert (UINT64_MAX / 2 >= v), v *= 2;
-      r->u = u, r->v = v;
-    }
-  else
+  STOP (subsume);
+}
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
+// Flush out garbage (satisfied and eliminated) clause occurrences.  Returns
+// the remaining number of occurrences or 'elimination_occurrence_limit + 1'
+// if a clause exceeds the elimination clause size limit or there are too
+// many, i.e., more than 'elimination_occurrence_limit' remaining.
+
+static unsigned
+actual_number_of_occurrences (struct satch *solver, unsigned lit)
+{
+#ifndef NELIMINATIONLIMITS
+  assert (elimination_occurrence_limit < UINT_MAX);
+#endif
+  assert (!solver->flags[INDEX (lit)].fixed);
+
+  struct watches *watches = solver->watches + lit;
+#ifndef NVIRTUAL
+  signed char *values = solver->values;
 #endif
+
+  union watch *begin = watches->begin, *q = begin;
+  const union watch *end = watches->end, *p = q;
+
+  uint64_t ticks = 1;		// To access 'watches'.
+  unsigned res = 0;
+
+  while (p != end)
     {
-      assert (restart_interval >= 1);
-      interval = (restart_interval - 1) + logn (restarts);
-      assert (restart_interval <= interval);
-    }
+      const union watch watch = *p++;
 
-  solver->limits.restart = CONFLICTS + interval;
+      struct clause *c = watch.clause;
+#ifndef NVIRTUAL
+      if (is_tagged_clause (c))
+	{
+	  const unsigned other = tagged_clause_to_literal (c);
+	  if (values[other] > 0)
+	    {
+	      really_delete_binary (solver, false, lit, other);
+	      struct clause *d = tag_binary_clause (false, lit);
+	      disconnect_literal (solver, other, d);
+	      ticks++;
+	      continue;
+	    }
+	}
+      else
+#endif
+	{
+	  ticks++;
+	  if (mark_garbage_if_satisfied (solver, c))
+	    continue;
+	}
 
-  message (solver, 4, "restart", restarts,
-	   "new %s restart limit %" PRIu64 " after %" PRIu64 " conflicts",
-	   solver->stable ? "stable" : "focused",
-	   solver->limits.restart, interval);
-}
+      *q++ = watch;
+      res++;
 
+#ifndef NELIMINATIONLIMITS
+      if (res > elimination_occurrence_limit)
+	break;
+#ifndef NVIRTUAL
+      if (!is_tagged_clause (c))
+#endif
+	if (c->size > elimination_clause_size_limit)
+	  {
+	    res = elimination_occurrence_limit + 1;
+	    break;
+	  }
 #endif
+    }
 
-/*------------------------------------------------------------------------*/
+  ticks += cache_lines (begin, q);
+  ADD (elimination_ticks, ticks);
 
-// Rephasing is the process of resetting the saved phases of the solver in
-// increasing intervals.  It can be seen as a diversification method with
-// respect to the selected phases (since phase saving might be considered
-// to be too stubborn).  However, in combination with reusing best-phases
-// and particularly target-phases it has more an intensification flavor.
+  while (p != end)
+    *q++ = *p++;
 
-// In the past, we experimented with many variants on how to reset phases
-// and now reached the following set-up, which seems to give consistent
-// improvements. First it seems that rephasing is only beneficial in stable
-// mode. Second we only reset to the original, the inverted-original or the
-// best-phase seen. Third we schedule rephasing slightly more frequently than
-// mode switching, such that for instance initially maybe the phases are
-// reset twice in one stable mode interval and then this number increases
-// slowly in later stable mode intervals.
+  watches->end = q;
+  if (EMPTY_STACK (*watches))
+    RELEASE_STACK (*watches);
 
-// At this point we do not have local search rephasing incorporated yet
-// which we do consider to give benefits.  It is also not combined with
-// autarky simplification either which allows to save partial satisfying
-// assignments. Both are implemented in Kissat and need to be ported.
+  return res;
+}
 
-#ifndef NREPHASE
+// Check if the given variable matches is still active, its clauses stay
+// below the clause size limit and it does not occur too often.  Assumed
+// variables and those in XOR constraints are frozen and thus can not be
+// eliminated.
 
 static bool
-rephasing (struct satch *solver)
+can_be_eliminated (struct satch *solver, unsigned pivot_idx)
 {
-  if (!solver->stable)
+  const struct flags *const f = solver->flags + pivot_idx;
+  if (!f->active)
+    return false;
+  if (!f->eliminate)
+    return false;
+  if (f->assumed || f->xors)
     return false;
-  return solver->limits.rephase <= CONFLICTS;
-}
 
-static char
-original_phases (struct satch *solver)
-{
-  const signed char value = original_phase ();
-  memset (solver->saved, value, VARIABLES);
-  return 'O';
-}
+  const unsigned lit = LITERAL (pivot_idx);
+  const unsigned not_lit = NOT (lit);
 
-#ifndef NINVERTED
+#ifndef NELIMINATIONLIMITS
 
-static char
-inverted_phases (struct satch *solver)
-{
-  const signed char value = -original_phase ();
-  memset (solver->saved, value, VARIABLES);
-  return 'I';
-}
+  const uint64_t pos = actual_number_of_occurrences (solver, lit);
+  const uint64_t neg = actual_number_of_occurrences (solver, not_lit);
 
-#endif
+  if (pos && neg > elimination_occurrence_limit)
+    return false;
 
-#ifndef NBEST
+  if (neg && pos > elimination_occurrence_limit)
+    return false;
 
-static char
-best_phases (struct satch *solver)
-{
-  const signed char *const bests = solver->bests;
-  const signed char *const end = bests + VARIABLES;
-  signed char *const saved = solver->saved;
-  signed char *q = saved, tmp;
-  for (const signed char *p = bests; p != end; p++, q++)
-    if ((tmp = *p))
-      *q = tmp;
-  solver->best = 0;
-  return 'B';
-}
+#else
+
+  (void) actual_number_of_occurrences (solver, lit);
+  (void) actual_number_of_occurrences (solver, not_lit);
 
 #endif
 
-static void
-rephase (struct satch *solver)
-{
-  char (*functions[4]) (struct satch *);
-  unsigned size_functions = 0;
+  return true;
+}
 
-#ifndef NINVERTED
-  functions[size_functions++] = inverted_phases;
-#ifndef NBEST
-  functions[size_functions++] = best_phases;
-#endif
-#endif
-  functions[size_functions++] = original_phases;
-#ifndef NBEST
-  functions[size_functions++] = best_phases;
-#endif
-  assert (size_functions <= sizeof functions / sizeof *functions);
+#if !defined(NGATES) || !defined(NPROBING)
 
-  const uint64_t rephased = INC (rephased);
-  const char type = functions[rephased % size_functions] (solver);
+// In dense mode return the other literal of an active binary clause in the
+// occurrence list of 'lit' and 'INVALID' otherwise.
 
-  const uint64_t interval =
-    scale_interval (rephase_interval, nlognlognlogn, rephased);
-  solver->limits.rephase = CONFLICTS + interval;
-  message (solver, 4, "rephase", rephased,
-	   "new rephase limit %" PRIu64 " conflicts after %" PRIu64,
-	   solver->limits.rephase, interval);
-#ifndef NTARGET
-  if (solver->stable)
+static unsigned
+binary_occurrence (struct satch *solver, unsigned lit, struct clause *c)
+{
+  unsigned other;
+#ifndef NVIRTUAL
+  if (is_tagged_clause (c))
+    other = tagged_clause_to_literal (c);
+  else
+#endif
     {
-      LOG ("reset target size");
-      memcpy (solver->targets, solver->saved, VARIABLES);
-      solver->target = 0;
+      if (c->garbage || c->size != 2)
+	return INVALID;
+      other = c->literals[0] ^ c->literals[1] ^ lit;
     }
-#endif
-  report (solver, 1, type);
+  if (!solver->flags[INDEX (other)].active)
+    return INVALID;
+  return other;
 }
 
 #endif
 
+/*------------------------------------------------------------------------*/
+#ifndef NGATES
 /*------------------------------------------------------------------------*/
 
-// Reducing the clause data base by removing useless redundant clauses is
-// important to keep the memory usage of the solver low, but also to
-// speed-up propagation.  The reduction interval in terms of conflicts is
-// increased (almost) arithmetically by 'reduce_interval'.  We combine
-// reductions with clause data base simplifications which remove root-level
-// satisfied clauses.  Removing falsified literals is not implemented yet.
-
-#ifndef NREDUCE
+// If the clauses of the pivot contain a definition of the pivot (an AND,
+// equivalence, ITE or XOR gate encoded as in the Tseitin transformation)
+// we only need to resolve gate clauses against non-gate clauses.  The
+// resolvents among gate clauses are tautological and those among non-gate
+// clauses are implied by the other resolvents, since the gate clauses with
+// the pivot removed are unsatisfiable.  Gate detection moves the gate
+// clauses to the front of the two occurrence lists of the pivot and returns
+// the number of gate clauses in those lists.
 
-static bool
-reducing (struct satch *solver)
+struct gate
 {
-  return solver->limits.reduce.conflicts <= CONFLICTS;
-}
+  size_t pos;			// Number of positive gate clauses.
+  size_t neg;			// Number of negative gate clauses.
+};
 
-// Protect reason clauses from garbage collection. The same function can
-// be used afterwards to make reason clauses unprotected again.  It is
-// better to lazily protect clauses during reductions instead of eagerly
-// setting the 'protect' bit during assignments to avoid dereferencing
-// pointers to binary clause reasons (if 'NBLOCK' is defined).
+// Move the occurrence of the gate clause to the end of the gate clauses at
+// the front of the occurrence list and return the new number gate clauses.
 
-static void
-set_protect_flag_of_reasons (struct satch *solver, bool protect)
+static size_t
+move_gate_clause_to_front (struct watches *watches, size_t gates,
+			   struct clause *c)
 {
-  struct clause *const *const reasons = solver->reasons;
-  for (all_elements_on_stack (unsigned, lit, solver->trail))
-    {
-      const unsigned idx = INDEX (lit);
-      struct clause *reason = reasons[idx];
-      if (!reason)
-	continue;
-#ifndef NBLOCK
-      if (is_tagged_clause (reason))
-	continue;
-#endif
-      LOGCLS (reason, "%sprotecting", protect ? "" : "un");
-      assert (reason->protected != protect);
-      reason->protected = protect;
-    }
+  union watch *const begin = watches->begin;
+  union watch *p = begin + gates;
+  while (assert (p != watches->end), p->clause != c)
+    p++;
+  const union watch tmp = begin[gates];
+  begin[gates] = *p;
+  *p = tmp;
+  return gates + 1;
 }
 
-#endif
-
-#if !defined(NREDUCE) || !defined(NELIMINATION)
-
-// Check whether a clause is root-level satisfied, i.e., it contains a
-// literal which is assigned to true on decision-level zero.  Otherwise
-// flush (at least) virtually all root-level falsified literals.  The latter
-// is important for marking flushed literals as new subsume candidates.
+// Find a definition 'lit = l_1 & ... & l_n' from binary clauses '(-lit | l_i)'
+// and a base clause '(lit | -l_1 | ... | -l_n)'.  For 'n = 1' this gives an
+// equivalence 'lit = l_1' (if substitution by probing did not find it yet).
 
 static bool
-clause_satisfied (struct satch *solver, struct clause *c)
+find_and_gate (struct satch *solver, unsigned lit,
+	       size_t *lit_gates, size_t *not_lit_gates)
 {
-  assert (!solver->level);
-#ifndef NVIRTUAL
-  assert (!is_tagged_clause (c));
-  assert (!is_temporary_binary (solver, c));
-  assert (!c->protected);
-#endif
+  const unsigned not_lit = NOT (lit);
+  struct watches *const watches = solver->watches + lit;
+  struct watches *const not_watches = solver->watches + not_lit;
+  signed char *const marks = solver->marks;
+  struct unsigned_stack *const marked = &solver->clause;
+  assert (EMPTY_STACK (*marked));
 
-  const signed char *const values = solver->values;
-  unsigned num_false = 0;
+  uint64_t ticks = 0;
 
-  for (all_literals_in_clause (lit, c))
+  for (all_elements_on_stack (union watch, watch, *not_watches))
     {
-      const signed char value = values[lit];
-      if (value > 0)
-	return true;
-      if (value < 0)
-	num_false++;
+      const unsigned other = binary_occurrence (solver, not_lit, watch.clause);
+      if (other == INVALID || marks[INDEX (other)])
+	continue;
+      mark_literal (marks, other);
+      PUSH (*marked, other);
     }
 
-  if (!num_false)
-    return false;
-
-  LOGCLS (c, "found %u root-level falsified in", num_false);
-
-  assert (EMPTY_STACK (solver->clause));
-  for (all_literals_in_clause (lit, c))
-    if (!values[lit])
-      PUSH (solver->clause, lit);
-
-#ifndef NSUBSUMPTION
-  for (all_elements_on_stack (unsigned, lit, solver->clause))
-      mark_subsume_literal (solver, lit);
-#endif
-
-  if (!solver->dense)
-    {
-      trace_and_check_temporary_addition (solver);
-      trace_and_check_clause_deletion (solver, c);
-
-#ifndef NWATCHES
-      const unsigned *old_lits = c->literals;
-      const unsigned *new_lits = solver->clause.begin;
-
-      // Unwatching might break code where we traverse watchers, which is
-      // currently only the case when called in dense mode from
-      // 'actual_number_of_occurrences' and thus not reached.
-
-      unwatch_literal (solver, old_lits[0], c);
-      unwatch_literal (solver, old_lits[1], c);
-#else
-      for (all_literals_in_clause (lit, c))
-	disconnect_literal (solver, lit, c);
-#endif
-
-      const size_t size = SIZE_STACK (solver->clause);
-      assert (size == c->size - num_false);
-      assert (size >= 2);
+  ticks += 1 + CACHE_LINES_OF_STACK (not_watches);
 
-      // We can not simply add a new clause since this function is called
-      // while traversing the 'irredundant' or 'redundant' stacks.  Instead
-      // we disconnect and add new watches.  Partially keeping unassigned
-      // watches is possible but needs more complex code (it might also
-      // result in blocking literals not in the clause anymore).
+  struct clause *base = 0;
+  unsigned size = 0;
 
+  if (!EMPTY_STACK (*marked))
+    for (all_elements_on_stack (union watch, watch, *watches))
+      {
+	struct clause *c = watch.clause;
 #ifndef NVIRTUAL
-      if (size == 2)
-	{
-	  watch_binary (solver, c->redundant, new_lits[0], new_lits[1]);
-	  watch_binary (solver, c->redundant, new_lits[1], new_lits[0]);
-	  LOGCLS (c, "garbage after flushing %u literals", num_false);
-	  c->garbage = true;
-	}
-      else
-#endif
-	{
-#ifndef NWATCHES
-#ifndef NBLOCK
-	  watch_literal (solver, c->redundant, new_lits[0], new_lits[1], c);
-	  watch_literal (solver, c->redundant, new_lits[1], new_lits[0], c);
-#else
-	  watch_literal (solver, new_lits[0], c);
-	  watch_literal (solver, new_lits[1], c);
-#endif
-#endif
-	  unsigned *p = c->literals;
-	  for (all_elements_on_stack (unsigned, lit, solver->clause))
-	     *p++ = lit;
-
-	  c->size = size;
-#ifndef NGLUE
-	  if (c->redundant && c->size >= c->glue)
-	    c->glue = size - 1;
-#endif
-#ifndef NCACHE
-	  c->search = 0;
-#endif
-#ifdef NWATCHES
-	  connect_clause (solver, c);
-	  count_clause (solver, c);
+	if (is_tagged_clause (c))
+	  {
+	    const unsigned other = tagged_clause_to_literal (c);
+	    if (marked_literal (marks, NOT (other)) > 0)
+	      {
+		base = c;
+		size = 2;
+		break;
+	      }
+	    continue;
+	  }
 #endif
-	  LOGCLS (c, "flushing %u literals yields", num_false);
-	}
+	ticks++;
+	if (c->garbage || c->size - 1 > SIZE_STACK (*marked))
+	  continue;
+	bool defined = true;
+	for (all_literals_in_clause (other, c))
+	  if (other != lit && marked_literal (marks, NOT (other)) <= 0)
+	    {
+	      defined = false;
+	      break;
+	    }
+	if (!defined)
+	  continue;
+	base = c;
+	size = c->size;
+	break;
+      }
 
-      // But there is no need to update clause statistics.
+  for (all_elements_on_stack (unsigned, other, *marked))
+      unmark_literal (marks, other);
+  CLEAR_STACK (*marked);
+
+  if (!base)
+    {
+      ADD (elimination_ticks, ticks);
+      return false;
     }
 
-  CLEAR_STACK (solver->clause);
+  // Mark the negated base clause literals to find the gate binary clauses.
 
-  return false;
-}
+  {
+#ifndef NVIRTUAL
+    struct clause *const c = is_tagged_clause (base) ?
+      untag_clause (solver, 0, lit, base) : base;
+#else
+    struct clause *const c = base;
+#endif
+    for (all_literals_in_clause (other, c))
+      if (other != lit)
+	mark_literal (marks, NOT (other));
+  }
 
-// This function is called in default sparse mode from 'reduce' only and
-// then (through 'clause_satisfied') also flushes falsified literals.  In
-// dense mode it is only called from 'actual_number_of_occurrences' during
-// variable elimination attempts.  There it only updates 'subsume'
-// candidates if the clause is not garbage but contains falsified literals.
+  union watch *const begin = not_watches->begin;
+  const union watch *const end = not_watches->end;
+  size_t gates = 0;
 
-static bool
-mark_garbage_if_satisfied (struct satch *solver, struct clause *c)
-{
-  assert (!solver->level);
+  for (union watch * p = begin; p != end; p++)
+    {
+      const unsigned other = binary_occurrence (solver, not_lit, p->clause);
+      if (other == INVALID || marked_literal (marks, other) <= 0)
+	continue;
+      const union watch tmp = begin[gates];
+      begin[gates++] = *p;
+      *p = tmp;
+    }
+
+  {
 #ifndef NVIRTUAL
-  assert (!is_tagged_clause (c));
-  assert (!is_temporary_binary (solver, c));
+    struct clause *const c = is_tagged_clause (base) ?
+      untag_clause (solver, 0, lit, base) : base;
+#else
+    struct clause *const c = base;
 #endif
-  if (c->garbage)
-    return true;
-  if (!clause_satisfied (solver, c))
-    return false;
-  mark_garbage (solver, c, "root-level satisfied");
-  return true;
-}
+    for (all_literals_in_clause (other, c))
+      if (other != lit)
+	unmark_literal (marks, other);
+  }
 
-// Irredundant clauses are not reduced, but marked garbage if they are
-// root-level satisfied clauses and can then be collected during reduction
-// too.  This is only necessary if there are new root-level fixed variables
-// since the last reduction though (and restricted to unprotected clauses).
+  assert (gates >= size - 1);
+  *not_lit_gates = gates;
+  *lit_gates = move_gate_clause_to_front (watches, 0, base);
 
-// We also use this function after variable elimination since we might not
-// have found and marked all the satisfied clauses during elimination.
+  ticks += 1 + CACHE_LINES_OF_STACK (not_watches);
+  ADD (elimination_ticks, ticks);
 
-// For subsumption an important side-effect of this function is to mark
-// unassigned literals in not-satisfied irredundant clauses which contain
-// false literals too as subsumption candidates.
+  if (size == 2)
+    {
+      LOG ("found equivalence gate for %s", LOGLIT (lit));
+      INC (equivalence_gates);
+    }
+  else
+    {
+      LOG ("found AND gate with %u inputs for %s", size - 1, LOGLIT (lit));
+      INC (and_gates);
+    }
+
+  return true;
+}
+
+// Count the number of irredundant clauses of size up to the XOR gate size
+// limit, which allows to skip ITE and XOR gate detection if there are not
+// enough clauses of the required size for such a gate.
 
 static void
-mark_irredundant_clauses_as_garbage_if_satisfied (struct satch *solver)
+count_gate_clause_sizes (struct satch *solver, struct watches *watches,
+			 unsigned *counts)
 {
-  assert (!solver->level);
-  for (all_irredundant_clauses (c))
-    (void) mark_garbage_if_satisfied (solver, c);
+  for (all_elements_on_stack (union watch, watch, *watches))
+    {
+      struct clause *c = watch.clause;
+#ifndef NVIRTUAL
+      if (is_tagged_clause (c))
+	continue;
+#endif
+      if (!c->garbage && c->size <= xor_gate_size_limit)
+	counts[c->size]++;
+    }
+  ADD (elimination_ticks, 1 + CACHE_LINES_OF_STACK (watches));
 }
 
+// Find an irredundant ternary clause with 'lit', 'a' and 'b'.
+
+static struct clause *
+find_ternary_clause (struct satch *solver,
+		     unsigned lit, unsigned a, unsigned b, uint64_t * ticks)
+{
+  struct watches *const watches = solver->watches + lit;
+  for (all_elements_on_stack (union watch, watch, *watches))
+    {
+      struct clause *c = watch.clause;
+#ifndef NVIRTUAL
+      if (is_tagged_clause (c))
+	continue;
 #endif
+      *ticks += 1;
+      if (c->garbage || c->size != 3)
+	continue;
+      const unsigned *const literals = c->literals;
+      bool found_a = false, found_b = false;
+      for (unsigned i = 0; i != 3; i++)
+	if (literals[i] == a)
+	  found_a = true;
+	else if (literals[i] == b)
+	  found_b = true;
+      if (found_a && found_b)
+	return c;
+    }
+  return 0;
+}
 
-#ifndef NREDUCE
+// Return the literal of the ternary clause different from 'a' and 'b' or
+// 'INVALID' if the clause does not contain 'b'.
 
-// Redundant clauses with large enough glucose level (glue) which have not
-// been used since the last reduction are deletion candidates. If there
-// are new root-level fixed variables since the last reduction we also
-// mark clauses as garbage which are root-level satisfied.
+static unsigned
+third_literal (struct clause *c, unsigned a, unsigned b)
+{
+  assert (c->size == 3);
+  bool found = false;
+  unsigned res = INVALID;
+  for (all_literals_in_clause (lit, c))
+    if (lit == b)
+      found = true;
+    else if (lit != a)
+      res = lit;
+  return found ? res : INVALID;
+}
 
-static void
-gather_reduce_candidates (struct satch *solver, bool new_fixed,
-			  struct clauses *candidates)
+// Find an if-then-else gate 'pivot = (c ? t : e)' encoded by the clauses
+// '(pivot | -c | -t)', '(pivot | c | -e)', '(-pivot | -c | t)' and
+// '(-pivot | c | e)'.  Below we use 'first = -c', 'second = -t' and 'third
+// = -e' with the first clause as base clause.
+
+static bool
+find_ite_gate (struct satch *solver, unsigned pivot,
+	       const unsigned *pos_counts, const unsigned *neg_counts,
+	       size_t *pos_gates, size_t *neg_gates)
 {
-  // Reverse order is needed for radix sort to ensure that more recently
-  // learned clauses are kept if they have the same size and glue.
+  if (pos_counts[3] < 2 || neg_counts[3] < 2)
+    return false;
 
-  // Without radix sort we need to use clause id's as tie-breaker anyhow and
-  // thus reversing the redundant clauses on the candidates stack is not
-  // necessary but also not harmful.
+  const unsigned not_pivot = NOT (pivot);
+  struct watches *const pos_watches = solver->watches + pivot;
+  struct watches *const neg_watches = solver->watches + not_pivot;
+  struct clause *gates[4] = { 0, 0, 0, 0 };
+  uint64_t ticks = 0;
 
-  for (all_redundant_clauses_in_reverse (c))
+  for (all_elements_on_stack (union watch, watch, *pos_watches))
     {
-      assert (c->redundant);
-      if (c->garbage)
-	continue;
-      if (c->protected)
-	continue;
-      if (new_fixed)
-	{
-	  if (mark_garbage_if_satisfied (solver, c))
-	    continue;
-	  if (c->garbage)
-	    continue;
-	}
+      struct clause *a = watch.clause;
 #ifndef NVIRTUAL
-      assert (c->size > 2);
-#else
-      // As we can not protect binary reason clauses we just ignore them as.
-      assert (c->size > 1);
-      if (c->size == 2)
+      if (is_tagged_clause (a))
 	continue;
 #endif
-#ifndef NTIER1
-      if (c->glue <= tier1_glue_limit)
+      ticks++;
+      if (a->garbage || a->size != 3)
 	continue;
-#endif
-#ifndef NUSED
-      if (c->used)
+      unsigned other[2], size = 0;
+      for (all_literals_in_clause (lit, a))
+	if (lit != pivot)
+	  other[size++] = lit;
+      assert (size == 2);
+      for (unsigned i = 0; !gates[0] && i != 2; i++)
 	{
-	  c->used--;		// Works for both 'used:1' and 'used:2'.
-#ifndef NTIER2
-	  if (c->glue <= tier2_glue_limit)
-#endif
+	  const unsigned first = other[i], second = other[!i];
+	  struct clause *c = find_ternary_clause (solver, not_pivot,
+						  first, NOT (second),
+						  &ticks);
+	  if (!c)
 	    continue;
-	}
+	  for (all_elements_on_stack (union watch, other_watch, *pos_watches))
+	    {
+	      struct clause *b = other_watch.clause;
+#ifndef NVIRTUAL
+	      if (is_tagged_clause (b))
+		continue;
 #endif
-      PUSH (*candidates, c);
+	      ticks++;
+	      if (b == a || b->garbage || b->size != 3)
+		continue;
+	      const unsigned third = third_literal (b, pivot, NOT (first));
+	      if (third == INVALID)
+		continue;
+	      struct clause *d = find_ternary_clause (solver, not_pivot,
+						      NOT (first),
+						      NOT (third), &ticks);
+	      if (!d)
+		continue;
+	      gates[0] = a, gates[1] = b, gates[2] = c, gates[3] = d;
+	      break;
+	    }
+	}
+      if (gates[0])
+	break;
     }
 
-  if (solver->options.verbose < 2)
-    return;
+  ADD (elimination_ticks, ticks);
 
-  const size_t size_candidates = SIZE_STACK (*candidates);
-  const size_t redundant = SIZE_STACK (solver->redundant);
-  message (solver, 2, "reduce", solver->statistics.reductions,
-	   "gathered %zu reduce candidate clauses %.0f%%",
-	   size_candidates, percent (size_candidates, redundant));
+  if (!gates[0])
+    return false;
+
+  LOGCLS (gates[0], "found ITE gate for %s with base", LOGLIT (pivot));
+  INC (ite_gates);
+
+  *pos_gates = move_gate_clause_to_front (pos_watches, 0, gates[0]);
+  *pos_gates = move_gate_clause_to_front (pos_watches, 1, gates[1]);
+  *neg_gates = move_gate_clause_to_front (neg_watches, 0, gates[2]);
+  *neg_gates = move_gate_clause_to_front (neg_watches, 1, gates[3]);
+
+  return true;
 }
 
-// Before actually deleting the garbage clauses we have to flush of course
-// watches from the watcher lists pointing to such garbage clauses.
+// Find an XOR gate, i.e., all '2^(size-1)' clauses over the variables of
+// a base clause of the given 'size' with the same parity of negations.  We
+// identify these clauses by the 'pattern' of literals which are negated
+// with respect to the base clause.  This also covers the encoding of long
+// XOR constraints in the front-end (see 'encode_xors' in 'main.c').
 
-static void
-flush_garbage_watches (struct satch *solver)
+static bool
+find_xor_gate (struct satch *solver, unsigned pivot,
+	       const unsigned *pos_counts, const unsigned *neg_counts,
+	       size_t *pos_gates, size_t *neg_gates)
 {
-  struct watches *all_watches = solver->watches;
-#ifndef NVIRTUAL
-  signed char *const values = solver->values;
-  const unsigned *const levels = solver->levels;
-#endif
-  for (all_literals (lit))
+  const unsigned not_pivot = NOT (pivot);
+  struct watches *const pos_watches = solver->watches + pivot;
+  struct watches *const neg_watches = solver->watches + not_pivot;
+  struct clause *gates[1u << xor_gate_size_limit];
+  uint64_t ticks = 0;
+  unsigned size = 0;
+
+  for (all_elements_on_stack (union watch, watch, *pos_watches))
     {
+      struct clause *base = watch.clause;
 #ifndef NVIRTUAL
-      signed char lit_value = values[lit];
-      if (lit_value && levels[INDEX (lit)])
-	lit_value = 0;
+      if (is_tagged_clause (base))
+	continue;
 #endif
-      struct watches *const lit_watches = all_watches + lit;
-      union watch *const end = lit_watches->end;
-      union watch *q = lit_watches->begin;
-      const union watch *p = q;
-      while (p != end)
-	{
-#ifndef NBLOCK
-	  const union watch watch = *p++;
-#ifndef NVIRTUAL
-	  const struct header header = watch.header;
-	  if (header.binary)
-	    {
-	      const unsigned blocking = header.blocking;
+      ticks++;
+      if (base->garbage || base->size < 3 ||
+	  base->size > xor_gate_size_limit)
+	continue;
 
-	      signed char blocking_value = values[blocking];
-	      if (blocking_value && levels[INDEX (blocking)])
-		blocking_value = 0;
+      size = base->size;
+      const unsigned needed = 1u << (size - 1);
+      if (pos_counts[size] < needed / 2 || neg_counts[size] < needed / 2)
+	{
+	  size = 0;
+	  continue;
+	}
+      const unsigned *const literals = base->literals;
+      unsigned found = 0;
 
-	      // We want to eagerly remove root-level satisfied binary
-	      // clauses as well, but since those sit in watch lists only
-	      // (if 'NVIRTUAL' and 'NBLOCK' are undefined) we have to check
-	      // whether the literal or the other blocking literal are
-	      // root-level assigned.  In both cases (since we assume
-	      // propagation went to completion on the root-level) we know
-	      // that the binary clause has to be satisfied.
+      memset (gates, 0, sizeof gates);
 
-	      if (lit_value || blocking_value)
+      for (unsigned sign = 0; found != needed && sign != 2; sign++)
+	{
+	  struct watches *watches = sign ? neg_watches : pos_watches;
+	  for (all_elements_on_stack (union watch, other_watch, *watches))
+	    {
+	      struct clause *c = other_watch.clause;
+#ifndef NVIRTUAL
+	      if (is_tagged_clause (c))
+		continue;
+#endif
+	      ticks++;
+	      if (c->garbage || c->size != size)
+		continue;
+	      unsigned pattern = 0;
+	      bool parity = false, matched = true;
+	      for (all_literals_in_clause (lit, c))
 		{
-		  assert (lit_value > 0 || blocking_value > 0);
-		  delete_binary (solver, header.redundant, lit, blocking);
-		  continue;	// Drop header by not copying it.
+		  unsigned i = 0;
+		  while (i != size && INDEX (literals[i]) != INDEX (lit))
+		    i++;
+		  if (i == size)
+		    {
+		      matched = false;
+		      break;
+		    }
+		  if (literals[i] != lit)
+		    {
+		      pattern |= 1u << i;
+		      parity = !parity;
+		    }
 		}
-	      *q++ = watch;	// Keep header and skip non-existing clause.
-	      continue;
+	      if (!matched || parity || gates[pattern])
+		continue;
+	      gates[pattern] = c;
+	      if (++found == needed)
+		break;
 	    }
-#endif
-	  *q++ = watch;		// Keep blocking literal header.
-#endif
-	  const struct clause *const clause = (*q++ = *p++).clause;
-	  if (clause->garbage)
-	    q -= long_clause_watch_size;	// Stop watching clause.
 	}
-      lit_watches->end = q;
+
+      if (found == needed)
+	break;
+
+      size = 0;
+    }
+
+  ADD (elimination_ticks, ticks);
+
+  if (!size)
+    return false;
+
+  LOG ("found XOR gate of size %u for %s", size, LOGLIT (pivot));
+  INC (xor_gates);
+
+  *pos_gates = *neg_gates = 0;
+
+  for (unsigned pattern = 0; pattern != 1u << size; pattern++)
+    {
+      struct clause *c = gates[pattern];
+      if (!c)
+	continue;
+      bool positive = false;
+      for (all_literals_in_clause (lit, c))
+	if (lit == pivot)
+	  positive = true;
+      if (positive)
+	*pos_gates = move_gate_clause_to_front (pos_watches, *pos_gates, c);
+      else
+	*neg_gates = move_gate_clause_to_front (neg_watches, *neg_gates, c);
     }
+
+  return true;
+}
+
+static bool
+find_gate (struct satch *solver, unsigned pivot, struct gate *gate)
+{
+  const unsigned not_pivot = NOT (pivot);
+  if (find_and_gate (solver, pivot, &gate->pos, &gate->neg))
+    return true;
+  if (find_and_gate (solver, not_pivot, &gate->neg, &gate->pos))
+    return true;
+
+  // Detecting ITE and XOR gates is quadratic in the number of occurrences.
+
+  struct watches *const pos_watches = solver->watches + pivot;
+  struct watches *const neg_watches = solver->watches + not_pivot;
+  if (SIZE_STACK (*pos_watches) + SIZE_STACK (*neg_watches) >
+      gate_occurrence_limit)
+    return false;
+
+  unsigned pos_counts[xor_gate_size_limit + 1] = { 0 };
+  unsigned neg_counts[xor_gate_size_limit + 1] = { 0 };
+  count_gate_clause_sizes (solver, pos_watches, pos_counts);
+  count_gate_clause_sizes (solver, neg_watches, neg_counts);
+  if (find_ite_gate (solver, pivot, pos_counts, neg_counts,
+		     &gate->pos, &gate->neg))
+    return true;
+  if (find_xor_gate (solver, pivot, pos_counts, neg_counts,
+		     &gate->pos, &gate->neg))
+    return true;
+  return false;
 }
 
+/*------------------------------------------------------------------------*/
 #endif
+/*------------------------------------------------------------------------*/
 
-#if !defined(NREDUCE) || !defined(NELIMINATION)
+// Check whether the given variable produces few resolvents and add them to
+// the resolvents stack.  The limit is the number of original clauses.
 
-// After removing garbage watches we can finally delete garbage clauses.
+// Process unit and empty clauses eagerly though which also requires that we
+// need to check antecedent clauses (again) and later also the saved
+// resolvents for being satisfied (or falsified).
 
-static void
-delete_garbage_clauses (struct satch *solver, struct clauses *clauses,
-			size_t *bytes_ptr, size_t *count_ptr)
+static bool
+produces_few_resolvents (struct satch *solver, unsigned pivot_idx)
 {
-  size_t bytes = 0;
-  size_t count = 0;
+  assert (!solver->inconsistent);
 
-  struct clause *const *const end = clauses->end;
-  struct clause **q = clauses->begin;
+  const unsigned pivot = LITERAL (pivot_idx);
+  const unsigned not_pivot = NOT (pivot);
 
-  for (struct clause ** p = q; p != end; p++)
+  struct watches *const pos_watches = solver->watches + pivot;
+  struct watches *const neg_watches = solver->watches + not_pivot;
+
+  assert (EMPTY_STACK (solver->resolvents));
+
+  LOG ("trying to eliminate %s", LOGVAR (pivot_idx));
+
+  const size_t pos_count = SIZE_STACK (*pos_watches);
+  const size_t neg_count = SIZE_STACK (*neg_watches);
+
+  const uint64_t limit = pos_count + neg_count;
+  uint64_t resolvents = 0;
+
+  uint64_t ticks = 2;
+  ticks += CACHE_LINES_OF_STACK (pos_watches);
+  ticks += CACHE_LINES_OF_STACK (neg_watches);
+
+  signed char *marks = solver->marks;
+
+  assert (!solver->level);
+  assert (!solver->values[pivot]);
+
+#ifndef NGATES
+  struct gate gate = { 0, 0 };
+  const bool gated = find_gate (solver, pivot, &gate);
+  size_t pos_index = 0;
+#endif
+
+  // Go over all clauses 'c' in which the variable occurs positively (outer
+  // loop) and all clauses 'd' in which it occurs negative (inner loop) and
+  // resolve 'c' with 'd' on the given variable.  Make sure to skip
+  // satisfied clauses and tautological resolvents.  Save the resolvents on
+  // the resolvents stack but eagerly add units (and the empty clause).
+
+  // If a gate was found we skip resolving gate with gate clauses and
+  // non-gate with non-gate clauses.
+
+  for (all_elements_on_stack (union watch, pos_watch, *pos_watches))
     {
-      struct clause *const c = *p;
-      if (c->garbage)
+      struct clause *c = pos_watch.clause;
+#ifndef NGATES
+      const bool c_gate = pos_index++ < gate.pos;
+      size_t neg_index = 0;
+#endif
+#ifndef NVIRTUAL
+      if (is_tagged_clause (c))
+	c = untag_clause (solver, 0, pivot, c);
+      else
+#endif
 	{
-	  assert (!c->protected);
-	  bytes += delete_clause (solver, c);
-	  count++;
+	  ticks++;
+	  if (c->garbage)
+	    continue;
 	}
-      else
-	*q++ = c;
-    }
-  clauses->end = q;
 
-  *bytes_ptr += bytes;
-  *count_ptr += count;
-}
+      // Mark literals in 'c' to detect if a literal in 'c' occurs negated
+      // in a 'd' clause which would produce a tautological resolvent.
+
+      for (all_literals_in_clause (lit, c))
+	mark_literal (marks, lit);
 
+      for (all_elements_on_stack (union watch, neg_watch, *neg_watches))
+	{
+	  struct clause *d = neg_watch.clause;
+#ifndef NGATES
+	  const bool d_gate = neg_index++ < gate.neg;
+	  if (gated && c_gate == d_gate)
+	    continue;
+#endif
+#ifndef NVIRTUAL
+	  if (is_tagged_clause (d))
+	    d = untag_clause (solver, 1, not_pivot, d);
+	  else
 #endif
+	    {
+	      ticks++;
+	      if (d->garbage)
+		continue;
+	    }
 
-#ifndef NREDUCE
+	  LOGCLS (c, "1st antecedent");
+	  LOGCLS (d, "2nd antecedent");
 
-/*------------------------------------------------------------------------*/
+	  INC (resolutions);
 
-// Candidate clauses considered to be reduced are sorted with respect to
-// their potential usefulness in the future.  Clauses are considered more
-// useful if they have a smaller glue or smaller size with the same glue.
-// If both glue and size are the same we keep more recently learned clauses.
+	  bool tautological = false;
+	  for (all_literals_in_clause (lit, d))
+	    if (lit != not_pivot && marked_literal (marks, lit) < 0)
+	      {
+		LOG ("tautological resolvent with clashing %s and %s",
+		     LOGLIT (NOT (lit)), LOGLIT (lit));
+		tautological = true;
+		break;
+	      }
 
-#ifndef NRADIXSORT
+	  if (tautological)
+	    continue;
 
-#ifndef NGLUE
+	  LOG ("resolvent non-tautological");
 
-static uint64_t
-rank_clause (struct clause *c)
-{
-  return ((uint64_t) c->glue << 32) + c->size;
-}
+	  if (++resolvents > limit)
+	    break;
 
-static void
-sort_reduce_candidates (struct clauses *candidates)
-{
-  RSORT (struct clause *, uint64_t, *candidates, rank_clause);
-}
+	  // Copy literals of 'c' and 'd' to the resolvent stack skipping
+	  // over the pivot and duplicated literals.
 
-#else
+	  for (all_literals_in_clause (lit, c))
+	    if (lit != pivot)
+	      PUSH (solver->resolvents, lit);
 
-static unsigned
-rank_clause (struct clause *c)
-{
-  return c->size;
-}
+	  for (all_literals_in_clause (lit, d))
+	    if (!marks[INDEX (lit)])
+	      PUSH (solver->resolvents, lit);
 
-static void
-sort_reduce_candidates (struct clauses *candidates)
-{
-  RSORT (struct clause *, unsigned, *candidates, rank_clause);
-}
+	  PUSH (solver->resolvents, INVALID);
+	}
 
-#endif
+      for (all_literals_in_clause (lit, c))
+	unmark_literal (marks, lit);
 
-#else
+      if (resolvents > limit)
+	break;
 
-// This the actual comparison functions for 'qsort' to order reduce
-// candidates.  The result is negative if the first argument is more useful
-// than the second.  The result is positive, if the second argument is more
-// useful.  Since 'qsort is not stable we make comparison deterministic by
-// using clause id's as tie-breaker which also makes sure that more recently
-// learned clauses are considered to be more useful in the future if they
-// happen to have the same glue and size.
+      if (solver->inconsistent)
+	break;
+    }
 
-static int
-cmp_reduce (const void *p, const void *q)
-{
-  const struct clause *const c = *(const struct clause * const *) p;
-  const struct clause *const d = *(const struct clause * const *) q;
-#ifndef NGLUE
-  if (c->glue < d->glue)
-    return -1;
-  if (c->glue > d->glue)
-    return 1;
-#endif
-  if (c->size < d->size)
-    return -1;
-  if (c->size > d->size)
-    return 1;
-  if (c->id < d->id)
-    return 1;
-  assert (c->id > d->id);
-  return -1;
-}
+  ADD (elimination_ticks, ticks);
 
-static void
-sort_reduce_candidates (struct clauses *candidates)
-{
-  struct clause **begin = candidates->begin;
-  qsort (begin, SIZE_STACK (*candidates), sizeof *begin, cmp_reduce);
-}
+  if (solver->inconsistent)
+    return false;
 
-#endif
+  if (resolvents > limit)
+    {
+      CLEAR_STACK (solver->resolvents);
+      LOG ("many resolvents %" PRIu64 " > limit %" PRIu64, resolvents, limit);
+      return false;
+    }
 
-/*------------------------------------------------------------------------*/
+  LOG ("few resolvents %" PRIu64 " <= limit %" PRIu64, resolvents, limit);
+  return true;
+}
 
-// From the remaining candidates we reduce 'reduce_fraction' of clauses.
+// Add and connect the temporary resolvent clause.
 
 static void
-mark_garbage_candidates (struct satch *solver, struct clauses *candidates)
+add_and_connect_resolvent (struct satch *solver)
 {
-  const size_t size = SIZE_STACK (*candidates);
-  assert (0.0 <= reduce_fraction);
-  const size_t reduce = reduce_fraction * size;
-
-  message (solver, 4, "reduce", solver->statistics.reductions,
-	   "target is to reduce %zu out of %zu clauses %.0f%%",
-	   reduce, size, percent (reduce, size));
-
-  const double keep_fraction = 1.0 - reduce_fraction;
-  const size_t keep = keep_fraction * size;
-
-  size_t reduced = 0;
+  const size_t size = SIZE_STACK (solver->clause);
+  assert (size <= UINT_MAX);
 
-  while (SIZE_STACK (*candidates) > keep)
+  if (!size)
     {
-      struct clause *c = POP (*candidates);
-      assert (!c->protected);
-      mark_garbage (solver, c, "reducing");
-      reduced++;
+      LOG ("empty resolvent");
+      solver->inconsistent = true;
+    }
+  else if (size == 1)
+    {
+      const unsigned unit = ACCESS (solver->clause, 0);
+      LOG ("unit resolvent %s", LOGLIT (unit));
+      assign (solver, unit, 0, true);
+    }
+#ifndef NVIRTUAL
+  else if (size == 2)
+    {
+      const unsigned lit = ACCESS (solver->clause, 0);
+      const unsigned other = ACCESS (solver->clause, 1);
+      LOGBIN (false, lit, other, "resolvent");
+      connect_literal (solver, lit, tag_binary_clause (false, other));
+      connect_literal (solver, other, tag_binary_clause (false, lit));
+      INC (irredundant);
+    }
+#endif
+  else
+    {
+      struct clause *resolvent = new_irredundant_clause (solver);
+      LOGCLS (resolvent, "resolvent");
+      connect_clause (solver, resolvent);
     }
 
-  ADD (reduced, reduced);
-
-  message (solver, 3, "reduce", solver->statistics.reductions,
-	   "reducing %zu out of %zu clauses %.0f%%",
-	   reduced, size, percent (reduced, size));
+#ifndef NSUBSUMPTION
 
-}
+  // Mark variables in resolvent as subsumption candidates.
 
-/*------------------------------------------------------------------------*/
+  for (all_elements_on_stack (unsigned, lit, solver->clause))
+      mark_subsume_literal (solver, lit);
 
-#ifndef NDEBUG
+#endif
+}
 
-// Even though the 'irredundant' and 'redundant' clause statistics are only
-// used for reporting we still want to accurately measure and maintain them,
-// which unfortunately is not trivial.  These reports are very useful for
-// engineering heuristics (and sometimes debugging).
+// Push the clause on the extension stack with 'eliminated' literal first.
+// See 'extend_solution' for more explanations on why we need this.
 
-// Thus we perform this explicit check before and after 'reduce'.
+static void
+push_clause_on_extension_stack (struct satch *solver,
+				unsigned eliminated, struct clause *c)
+{
+#ifndef NVIRTUAL
+  if (is_tagged_clause (c))
+    c = untag_clause (solver, 0, eliminated, c);
+#endif
+  PUSH (solver->extend, INVALID);	// Clause separator.
+  PUSH (solver->extend, eliminated);
+  for (all_literals_in_clause (lit, c))
+    if (lit != eliminated)
+      PUSH (solver->extend, lit);
+}
 
 static void
-check_clause_statistics (struct satch *solver)
+push_clauses_on_extension_stack (struct satch *solver,
+				 unsigned eliminated, struct watches *watches)
 {
-  assert (!solver->dense);
+  for (all_elements_on_stack (union watch, watch, *watches))
+      push_clause_on_extension_stack (solver, eliminated, watch.clause);
+}
 
-  uint64_t irredundant = 0;
-  uint64_t redundant = 0;
+// Eliminate clause and push it on extension stack with 'eliminated' first.
 
+static void
+eliminate_watched_clause (struct satch *solver,
+			  unsigned eliminated, struct clause *c)
+{
 #ifndef NVIRTUAL
-  for (all_literals (lit))
+  if (is_tagged_clause (c))
     {
-      const struct watches *const watches = solver->watches + lit;
-      const union watch *const end = watches->end;
-      const union watch *p = watches->begin;
-      while (p != end)
-	{
-	  const union watch watch = *p++;
-	  const struct header header = watch.header;
-	  if (header.binary)
-	    {
-	      const unsigned other = header.blocking;
-	      if (lit < other)
-		{
-		  if (header.redundant)
-		    redundant++;
-		  else
-		    irredundant++;
-		}
-	    }
-	  else
-	    p++;
-	}
+      const unsigned other = tagged_clause_to_literal (c);
+      really_delete_binary (solver, false, eliminated, other);
+      struct clause *d = tag_binary_clause (false, eliminated);
+      disconnect_literal (solver, other, d);
+      INC (elimination_ticks);
+      c = untag_clause (solver, 0, eliminated, c);
     }
+  else
+#endif
+  if (c->garbage)
+    return;
+#ifndef NVIRTUAL
+  else
 #endif
+    mark_garbage (solver, c, "eliminated");
 
-  for (all_irredundant_clauses (c))
-    if (!c->garbage)
-      irredundant++;
+#ifdef NVIRTUAL
+  (void) eliminated;
+#endif
+}
 
-  for (all_redundant_clauses (c))
-    if (!c->garbage)
-      redundant++;
+// Eliminate clauses with literal 'eliminated' by flushing their occurrence
+// lists, marking them as garbage, and pushing them on the extension stack.
 
-  assert (irredundant == solver->statistics.irredundant);
-  assert (redundant == solver->statistics.redundant);
+static void
+eliminate_watched_clauses (struct satch *solver,
+			   unsigned eliminated, struct watches *watches)
+{
+  for (all_elements_on_stack (union watch, watch, *watches))
+      eliminate_watched_clause (solver, eliminated, watch.clause);
+  RELEASE_STACK (*watches);
+}
+
+#ifndef NARENA
+
+// Resolvents are only added if they fit into the space reserved in the
+// arena before elimination, i.e., as many words as all live clauses occupy
+// at that point.  Otherwise the variable is not eliminated (and has to
+// become an elimination candidate again to be tried later).  This only
+// happens if resolvents already added in this elimination phase occupy
+// that much space, which in practice is rare.
+
+static bool
+resolvents_fit_into_arena (struct satch *solver)
+{
+  size_t words = 0, size = 0;
+  for (all_elements_on_stack (unsigned, lit, solver->resolvents))
+    if (lit != INVALID)
+      size++;
+    else
+      {
+	if (size > 1)
+	  words += words_clause (size);
+	size = 0;
+      }
+  if (words <= available_arena_words (solver))
+    return true;
+  LOG ("resolvents of %zu words do not fit into arena", words);
+  CLEAR_STACK (solver->resolvents);
+  return false;
 }
 
 #endif
 
-/*------------------------------------------------------------------------*/
+// Now eliminate the variable by adding all the saved resolvents from the
+// resolvents stack and then eliminate the clauses in which it occurs.
 
-// Reduce less useful redundant clauses frequently.
+// Since we might have generated units in the mean time we have to check for
+// satisfied and falsified clauses again (the second time).
 
 static void
-reduce (struct satch *solver)
+eliminate_variable (struct satch *solver, unsigned pivot_idx)
 {
-#ifndef NDEBUG
-  check_clause_statistics (solver);
-#endif
-  START (reduce);
-  const uint64_t reductions = INC (reductions);
+  assert (!solver->inconsistent);
+  assert (EMPTY_STACK (solver->clause));
 
-  // If there are new fixed (root-level assigned) variables since the last
-  // reduction, we remove both satisfied irredundant clauses here and later
-  // satisfied redundant clauses in 'gather_reduce_candidates'.  Both call
-  // 'mark_garbage_if_satisfied' for large clauses, which in turn calls
-  // 'clause_satisfied' and thus also flushes falsified literals.
+  const unsigned pivot = LITERAL (pivot_idx);
+  const unsigned not_pivot = NOT (pivot);
 
-  // Without new fixed variable we do not backtrack but protect reasons.
+  LOG ("eliminating %s", LOGVAR (pivot_idx));
 
-  const bool new_fixed =
-    solver->limits.reduce.fixed < solver->statistics.fixed;
+  // First mark the variable as eliminated and update counters.
 
-  if (new_fixed)
-    {
-      update_phases_and_backtrack_to_root_level (solver);
-      mark_irredundant_clauses_as_garbage_if_satisfied (solver);
-    }
-  else
-    set_protect_flag_of_reasons (solver, true);
+  {
+    struct flags *f = solver->flags + pivot_idx;
+    assert (f->active);
+    assert (!f->eliminated);
+    f->eliminated = true;
+    f->active = false;
+    DEC (remaining);
+    INC (eliminated);
+  }
 
-  // At the core of reduction is to first gather potential redundant reduce
-  // candidate clauses (omitting those that are definitely kept).  Then
-  // these candidates are sorted with respect to a metric which is supposed
-  // to reflect potential usefulness. From the less useful clauses a large
-  // fraction ('reduce_fraction') is then marked as garbage to be collected.
+  // Now copy and add the clauses from the resolvents stack.
 
-  {
-    struct clauses candidates;
-    INIT_STACK (candidates);
+  uint64_t ticks = 0;
 
-    gather_reduce_candidates (solver, new_fixed, &candidates);
-    sort_reduce_candidates (&candidates);
-    mark_garbage_candidates (solver, &candidates);
+  {
+    const signed char *const values = solver->values;
+    bool satisfied = false;
 
-    RELEASE_STACK (candidates);
+    for (all_elements_on_stack (unsigned, lit, solver->resolvents))
+      {
+	if (lit != INVALID)
+	  {
+	    signed char value = values[lit];
+	    if (value > 0)
+	      satisfied = true;
+	    else if (!satisfied && !value)
+	      PUSH (solver->clause, lit);
+	  }
+	else if (satisfied)
+	  {
+	    CLEAR_STACK (solver->clause);
+	    satisfied = false;
+	  }
+	else
+	  {
+	    LOGTMP ("previously resolved");
+	    trace_and_check_temporary_addition (solver);
+	    add_and_connect_resolvent (solver);
+	    ticks += SIZE_STACK (solver->clause);
+	    CLEAR_STACK (solver->clause);
+	    ticks++;
+	    if (solver->inconsistent)
+	      break;
+	  }
+      }
   }
 
-  // Before we can delete the garbage clauses we first have to remove
-  // references to those clauses marked as garbage from the watch lists.
-
-  flush_garbage_watches (solver);
+  if (solver->inconsistent)
+    return;
 
-  // As next to final step we delete garbage clauses and print statistics.
+  CLEAR_STACK (solver->resolvents);
 
   {
-    size_t bytes = 0, count = 0;
-    if (new_fixed)
-      delete_garbage_clauses (solver, &solver->irredundant, &bytes, &count);
-    delete_garbage_clauses (solver, &solver->redundant, &bytes, &count);
+    struct watches *const pos_watches = solver->watches + pivot;
+    struct watches *const neg_watches = solver->watches + not_pivot;
 
-    // We report on how many clauses we collected during reduction.
+    const size_t pos_lines = 1 + CACHE_LINES_OF_STACK (pos_watches);
+    const size_t neg_lines = 1 + CACHE_LINES_OF_STACK (neg_watches);
 
-    message (solver, 2, "reduce", reductions,
-	     "collected %zu clauses (%zu bytes, %.0f MB)",
-	     count, bytes, bytes / (double) (1u << 20));
+    // Push eliminated clauses on the extension stack.  For non-incremental
+    // SAT solving we could push only one set of the two clauses and then
+    // simulate the other by pushing a unit. But for incremental solving we
+    // need all clauses in order to restore them if the variable reappears.
 
-    ADD (collected, bytes);
-  }
+    ticks += 2 + pos_lines + neg_lines;
 
-  // No we can mark reasons of literals on the trail as unprotected.
+    push_clauses_on_extension_stack (solver, pivot, pos_watches);
+    push_clauses_on_extension_stack (solver, not_pivot, neg_watches);
 
-  if (!new_fixed)
-    set_protect_flag_of_reasons (solver, false);
+    // Finally remove all the clauses with the eliminated variables and
+    // release their watcher stacks.
 
-  // Finally we compute and report the next conflict limit for reduction.
+    ticks += 2 + pos_lines + neg_lines;
 
-  {
-    solver->limits.reduce.fixed = solver->statistics.fixed;
-    const uint64_t interval =
-      scale_interval (reduce_interval, ndivlogn, reductions);
-    solver->limits.reduce.conflicts = CONFLICTS + interval;
-    message (solver, 4, "reduce", reductions,
-	     "next limit at %" PRIu64 " after %" PRIu64 " conflicts",
-	     solver->limits.reduce.conflicts, interval);
+    eliminate_watched_clauses (solver, pivot, pos_watches);
+    eliminate_watched_clauses (solver, not_pivot, neg_watches);
   }
 
-  report (solver, 1, '-');
-  STOP (reduce);
-#ifndef NDEBUG
-  check_clause_statistics (solver);
-#endif
+  ADD (elimination_ticks, ticks);
 }
 
-#endif
-
 /*------------------------------------------------------------------------*/
 
-// Switch between focused mode with aggressive restarting and stable mode
-// with almost no restarting.  At the same time switch between two different
-// decision variable schemes (by default VMTF vs (E)VSIDS).  During stable
-// mode we also enable rephasing and target phases.  The two modes have
-// separate averages ('glue', 'rate', 'level' and 'trail').
-
-// Starting and ending a mode is indicated by a '{' and '}' pair for focused
-// mode (the initial mode) and '[' and ']' for stable mode.
+#ifndef NELIMINATIONLIMITS
 
-#ifndef NSWITCH
+// Variable elimination and particularly subsumption have to be bounded for
+// large instances.  Otherwise almost all time is spent in these procedures.
+// We bound the time spent by 'ticks' (predicted cache line accesses) as for
+// propagation during search and allow a fixed fraction (10%) in terms of
+// search ticks since the last variable elimination. We have separate limits
+// for subsumption and elimination to allow each a fair share of the time.
+// The limits are set at the start of variable elimination (for both).
 
 static void
-start_mode (struct satch *solver)
+set_elimination_ticks_limit (struct satch *solver)
 {
-  if (solver->stable)
-    {
-      START (stable);
-      report (solver, 1, '[');
-      LOG ("start stable mode");
-    }
-  else
-    {
-      START (focused);
-      report (solver, 1, '{');
-      LOG ("start focused mode");
-    }
+  struct limits *const limits = &solver->limits;
+  const struct statistics *const statistics = &solver->statistics;
+  const uint64_t eliminations = statistics->eliminations;
+#ifndef NINPROCESSING
+  const uint64_t delta = statistics->ticks - limits->eliminate.search;
+  uint64_t limit = delta * elimination_ticks_fraction;
+  message (solver, 2, "elimination", eliminations,
+	   "elimination limit of %" PRIu64 " ticks = %g * search ticks %"
+	   PRIu64, limit, (double) elimination_ticks_fraction, delta);
+  limits->eliminate.ticks = statistics->elimination_ticks + limit;
+#else
+  limits->eliminate.ticks = UINT64_MAX;
+  message (solver, 2, "elimination", eliminations,
+	   "no elimination ticks-limit during preprocessing "
+	   "(inprocessing disabled)");
+#endif
 }
 
-static void
-stop_mode (struct satch *solver)
+static bool
+elimination_ticks_limit_hit (struct satch *solver)
 {
-  if (solver->stable)
-    {
-      STOP (stable);
-      LOG ("stop stable mode");
-      report (solver, 1, ']');
-    }
-  else
-    {
-      STOP (focused);
-      LOG ("stop focused mode");
-      report (solver, 1, '}');
-    }
+  return solver->statistics.elimination_ticks >
+    solver->limits.eliminate.ticks;
 }
 
-// Initially (for the first focused mode phase) we use a non-zero conflict
-// limit ('initial_mode_conflicts_interval') and then compute the number of
-// 'ticks' spent in this first mode.  This is then used as base ticks
-// interval for the length of the remaining mode phases.
-
-// To indicate that we moved to a ticks based limits we set
-// 'limits->mode.conflicts' to zero after the first mode switch.
-// Accordingly when testing for switching we first check whether that is
-// zero and then use ticks instead of conflicts.
-
-// As you can see we still use a ticks limit for the first round since we
-// encountered cases were relying on conflicts only took too much time.
+#endif
 
-static bool
-switching (struct satch *solver)
-{
-  struct limits *limits = &solver->limits;
-  if (limits->mode.conflicts && limits->mode.conflicts <= CONFLICTS)
-    return true;
-  return limits->mode.ticks.limit <= TICKS;
-}
+#ifndef NSUBSUMPTIONLIMITS
 
 static void
-set_new_mode_switching_limit (struct satch *solver, uint64_t switched)
+set_subsumption_ticks_limit (struct satch *solver)
 {
-  struct limits *limits = &solver->limits;
-  const uint64_t interval = limits->mode.ticks.interval;
-  const uint64_t count = (switched + 1) / 2;
-  const uint64_t scaled = scale_interval (interval, quadratic, count);
-  solver->limits.mode.ticks.limit = TICKS + scaled;
-  message (solver, 3, "switch", switched,
-	   "new %s mode limit of %" PRIu64 " ticks after %" PRIu64 " ticks",
-	   solver->stable ? "focused" : "stable",
-	   limits->mode.ticks.limit, scaled);
+  struct limits *const limits = &solver->limits;
+  const struct statistics *const statistics = &solver->statistics;
+  const uint64_t eliminations = statistics->eliminations;
+#ifndef NINPROCESSING
+  const uint64_t delta = statistics->ticks - limits->subsume.search;
+  uint64_t limit = delta * subsumption_ticks_fraction;
+  message (solver, 2, "elimination", eliminations,
+	   "subsumption limit of %" PRIu64 " ticks = %g * search ticks %"
+	   PRIu64, limit, (double) subsumption_ticks_fraction, delta);
+  limits->subsume.ticks = statistics->subsumption_ticks + limit;
+#else
+  limits->subsume.ticks = UINT64_MAX;
+  message (solver, 2, "elimination", eliminations,
+	   "no subsumption ticks-limit during preprocessing "
+	   "(inprocessing disabled)");
+#endif
 }
 
-static void
-mode_ticks_limit_hit (struct satch *solver, uint64_t switched)
-{
-  message (solver, 2, "switch", switched,
-	   "limit of %" PRIu64 " ticks hit at %" PRIu64 " ticks",
-	   solver->limits.mode.ticks.limit, TICKS);
-}
+#endif
 
-static void
-switch_to_focused_mode (struct satch *solver, uint64_t switched)
+/*------------------------------------------------------------------------*/
+#ifndef NPARALLEL
+/*------------------------------------------------------------------------*/
+
+// With several elimination threads ('satch_set_elimination_threads') each
+// elimination round starts with batches of pivots which do not occur in the
+// clauses of each other.  The main thread flushes their occurrence lists
+// and finds gates as in the sequential case.  Then all threads compute the
+// resolvents of the pivots in the batch without modifying solver state.
+// Thus virtual binary clauses are expanded locally and each thread has its
+// own marks.  Afterwards the main thread eliminates those pivots which
+// produce few resolvents in the original order.  Eliminating a pivot can
+// neither change the clauses nor the occurrence lists of another pivot in
+// the same batch.  So its saved resolvents stay valid, while satisfied and
+// falsified literals are checked again in 'eliminate_variable' anyhow.
+// The result is the same for any number of at least two threads and does
+// not depend on scheduling.  But pivots are considered in a different order
+// than in the sequential loop used for one thread (independent pivots
+// first, their neighbours in later batches) and thus usually fewer (and
+// other) variables are eliminated than with one thread.
+
+struct candidate
+{
+  unsigned idx;			// Pivot variable.
+  unsigned resolver;		// Resolver which saved its resolvents.
+  bool few;			// Produces few resolvents.
+#ifndef NGATES
+  bool gated;			// Gate found.
+  struct gate gate;		// Gate clauses in front of occurrences.
+#endif
+  uint64_t ticks;		// Ticks spent in resolving.
+  uint64_t resolutions;		// Resolution steps.
+  size_t begin, end;		// Saved resolvents on resolver stack.
+};
+
+struct candidates
 {
-  assert (solver->stable);
-  mode_ticks_limit_hit (solver, switched);
-  solver->stable = false;
-  assert (switched >= 2);
-  assert (!(switched & 1));
-}
+  struct candidate *begin, *end, *allocated;
+};
 
-static void
-switch_to_stable_mode (struct satch *solver, uint64_t switched)
+struct resolver
 {
-  assert (!solver->stable);
+  unsigned id;			// Index of this resolver.
+  struct satch *solver;		// Only read while resolving.
+  struct candidates *candidates;	// Shared candidates of batch.
+  size_t *next;			// Next candidate to be resolved.
+  signed char *marks;		// Own variable marks.
+  struct unsigned_stack resolvents;	// Saved resolvents.
+  pthread_t thread;		// Thread running this resolver.
+};
 
-  struct limits *limits = &solver->limits;
+// Return the literals of a clause in the occurrence list of 'lit' or zero
+// if it is garbage.  Virtual binary clauses are copied to 'binary' instead
+// of using the shared temporary binary clauses of 'untag_clause'.
 
-  if (limits->mode.conflicts)
+static unsigned *
+resolved_literals (union watch watch, unsigned lit,
+		   unsigned *binary, unsigned *size, uint64_t * ticks)
+{
+  struct clause *const c = watch.clause;
+#ifndef NVIRTUAL
+  if (is_tagged_clause (c))
     {
-      message (solver, 2, "switch", switched,
-	       "limit of %" PRIu64 " conflicts hit at %"
-	       PRIu64 " conflicts and %" PRIu64 " ticks",
-	       limits->mode.conflicts, CONFLICTS, TICKS);
-
-      limits->mode.ticks.interval = TICKS;
-      limits->mode.conflicts = 0;
+      binary[0] = lit;
+      binary[1] = tagged_clause_to_literal (c);
+      *size = 2;
+      return binary;
     }
-  else
-    mode_ticks_limit_hit (solver, switched);
-
-  solver->stable = true;
-  assert ((switched & 1));
-
-#ifndef NRESTART
-  solver->reluctant.u = solver->reluctant.v = 1;
-  solver->limits.restart = CONFLICTS + stable_restart_interval;
-#endif
-
-#ifndef NTARGET
-  LOG ("reset target size");
-  solver->target = 0;
+#else
+  (void) lit;
+  (void) binary;
 #endif
+  *ticks += 1;
+  if (c->garbage)
+    return 0;
+  *size = c->size;
+  return c->literals;
 }
 
+// Thread-safe version of 'produces_few_resolvents' which saves resolvents
+// on the resolver stack and the statistics in the candidate.
+
 static void
-switch_mode (struct satch *solver)
+resolve_candidate (struct resolver *resolver, struct candidate *candidate)
 {
-  stop_mode (solver);
-  const uint64_t switched = INC (switched);
+  struct satch *const solver = resolver->solver;
 
-  // Make sure to push back all assigned variables to the scores heap and
-  // reset the VMTF queue if there are still variables on the trail.
-  // Otherwise the scores heap respectively the queue is not really saved.
-  // There is even the danger to violate the invariant that unassigned
-  // literals are not all on the binary heap when switching back etc.
+  const unsigned pivot = LITERAL (candidate->idx);
+  const unsigned not_pivot = NOT (pivot);
 
-  if (solver->level)
-    backtrack (solver, 0);
+  struct watches *const pos_watches = solver->watches + pivot;
+  struct watches *const neg_watches = solver->watches + not_pivot;
 
-  if (solver->stable)
-    switch_to_focused_mode (solver, switched);
-  else
-    switch_to_stable_mode (solver, switched);
+  const size_t pos_count = SIZE_STACK (*pos_watches);
+  const size_t neg_count = SIZE_STACK (*neg_watches);
 
-  // Save the number of decisions when entering the new mode to compute the
-  // mode specific 'decision rate' exponential moving average.
+  const uint64_t limit = pos_count + neg_count;
+  uint64_t resolvents = 0, resolutions = 0;
 
-  struct averages *a = averages (solver);
-  a->saved_decisions = DECISIONS;
+  uint64_t ticks = 2;
+  ticks += CACHE_LINES_OF_STACK (pos_watches);
+  ticks += CACHE_LINES_OF_STACK (neg_watches);
 
-  set_new_mode_switching_limit (solver, switched);
-  start_mode (solver);
-}
+  signed char *const marks = resolver->marks;
+  struct unsigned_stack *const saved = &resolver->resolvents;
 
-#endif
+  candidate->resolver = resolver->id;
+  candidate->begin = SIZE_STACK (*saved);
 
-/*------------------------------------------------------------------------*/
-#ifndef NELIMINATION
-/*------------------------------------------------------------------------*/
+#ifndef NGATES
+  const struct gate gate = candidate->gate;
+  const bool gated = candidate->gated;
+  size_t pos_index = 0;
+#endif
 
-static bool
-more_elimination_candidates (struct satch *solver)
-{
-  return solver->statistics.marked_eliminate >
-    solver->limits.eliminate.marked;
-}
+  unsigned c_binary[2], d_binary[2];
+  unsigned c_size = 0, d_size = 0;
 
-#ifndef NSUBSUMPTION
+  for (all_elements_on_stack (union watch, pos_watch, *pos_watches))
+    {
+#ifndef NGATES
+      const bool c_gate = pos_index++ < gate.pos;
+      size_t neg_index = 0;
+#endif
+      unsigned *const c_literals =
+	resolved_literals (pos_watch, pivot, c_binary, &c_size, &ticks);
+      if (!c_literals)
+	continue;
 
-static bool
-more_subsumption_candidates (struct satch *solver)
-{
-  return solver->statistics.marked_subsume > solver->limits.subsume.marked;
-}
+      for (all_elements_in_array (unsigned, lit, c_size, c_literals))
+	mark_literal (marks, lit);
 
+      for (all_elements_on_stack (union watch, neg_watch, *neg_watches))
+	{
+#ifndef NGATES
+	  const bool d_gate = neg_index++ < gate.neg;
+	  if (gated && c_gate == d_gate)
+	    continue;
 #endif
+	  unsigned *const d_literals =
+	    resolved_literals (neg_watch, not_pivot, d_binary, &d_size,
+			       &ticks);
+	  if (!d_literals)
+	    continue;
 
-static bool
-eliminating (struct satch *solver)
-{
-#ifdef NCDCL
-  if (solver->level)
-    return false;
-#endif
-  if (!more_elimination_candidates (solver))
-#ifndef NSUBSUMPTION
-    if (!more_subsumption_candidates (solver))
-#endif
-      return false;
-#ifndef NINPROCESSING
-  return solver->limits.eliminate.conflicts < CONFLICTS;
-#else
-  return !solver->statistics.eliminations;
-#endif
-}
+	  resolutions++;
+
+	  bool tautological = false;
+	  for (all_elements_in_array (unsigned, lit, d_size, d_literals))
+	    if (lit != not_pivot && marked_literal (marks, lit) < 0)
+	      {
+		tautological = true;
+		break;
+	      }
+
+	  if (tautological)
+	    continue;
+
+	  if (++resolvents > limit)
+	    break;
 
-/*------------------------------------------------------------------------*/
+	  for (all_elements_in_array (unsigned, lit, c_size, c_literals))
+	    if (lit != pivot)
+	      PUSH (*saved, lit);
 
-// The code for switching from sparse to dense mode and back heavily relies
-// on how watches are organized ('NVIRTUAL' or even 'NBLOCK' is defined).
+	  for (all_elements_in_array (unsigned, lit, d_size, d_literals))
+	    if (!marks[INDEX (lit)])
+	      PUSH (*saved, lit);
 
-#ifndef NVIRTUAL
+	  PUSH (*saved, INVALID);
+	}
 
-// This is the default routine for flushing all redundant watches where we
-// use virtual binary clauses and blocking literals.
+      for (all_elements_in_array (unsigned, lit, c_size, c_literals))
+	unmark_literal (marks, lit);
 
-// It is the most complex variant because binary clauses reside in watches
-// only and thus the redundant binary clauses have to be saved while the
-// irredundant ones are kept.  The redundant-clause watches are flushed
-// completely, while for the redundant-clause watches we remove the header.
+      if (resolvents > limit)
+	break;
+    }
 
-// Furthermore, since in dense mode we only have clause references as watches
-// we need to use the same mechanism as for reasons to store binary clauses
-// (actually only the other literal) through tagged clause pointers.
+  candidate->few = resolvents <= limit;
+  if (!candidate->few)
+    saved->end = saved->begin + candidate->begin;
+  candidate->end = SIZE_STACK (*saved);
+  candidate->ticks = ticks;
+  candidate->resolutions = resolutions;
+}
+
+static void *
+run_resolver (void *ptr)
+{
+  struct resolver *const resolver = ptr;
+  struct candidates *const candidates = resolver->candidates;
+  const size_t size = SIZE_STACK (*candidates);
+  for (;;)
+    {
+      const size_t i =
+	__atomic_fetch_add (resolver->next, 1, __ATOMIC_RELAXED);
+      if (i >= size)
+	break;
+      resolve_candidate (resolver, candidates->begin + i);
+    }
+  return 0;
+}
+
+// Block all variables occurring in clauses with 'lit' for this batch.  We
+// do not count ticks since 'can_be_eliminated' just accessed these clauses.
 
 static void
-flush_redundant_watches (struct satch *solver, bool new_fixed)
+block_occurrences (struct satch *solver, bool *blocked,
+		   struct unsigned_stack *stack, unsigned lit)
 {
-  assert (EMPTY_STACK (solver->binaries));
-  const struct flags *const flags = solver->flags;
-  for (all_literals (lit))
+  const struct watches *const watches = solver->watches + lit;
+  for (all_elements_on_stack (union watch, watch, *watches))
     {
-      struct watches *watches = solver->watches + lit;
-      const union watch *const end = watches->end;
-      union watch *q = watches->begin, *p = q;
-      const bool lit_active = new_fixed ? true : flags[INDEX (lit)].active;
-      while (p != end)
+      struct clause *const c = watch.clause;
+#ifndef NVIRTUAL
+      if (is_tagged_clause (c))
 	{
-	  struct header header = p->header;
-	  if (header.binary)
+	  const unsigned idx = INDEX (tagged_clause_to_literal (c));
+	  if (!blocked[idx])
 	    {
-	      const unsigned other = header.blocking;
-	      const bool redundant = header.redundant;
-	      const bool other_active =
-		new_fixed ? true : flags[INDEX (other)].active;
-
-	      if (lit_active && other_active)
-		{
-		  if (header.redundant)
-		    {
-		      if (lit < other)
-			{
-			  PUSH (solver->binaries, lit);
-			  PUSH (solver->binaries, other);
-			}
-		    }
-		  else
-		    q++->clause = tag_binary_clause (false, other);
-		}
-	      else
-		delete_binary (solver, redundant, lit, other);
-
-	      p++;
+	      blocked[idx] = true;
+	      PUSH (*stack, idx);
 	    }
-	  else
+	  continue;
+	}
+#endif
+      if (c->garbage)
+	continue;
+      for (all_literals_in_clause (other, c))
+	{
+	  const unsigned idx = INDEX (other);
+	  if (!blocked[idx])
 	    {
-	      if (!header.redundant)
-		{
-		  struct clause *c = p[1].clause;
-		  if (!new_fixed || !c->garbage)
-		    q++->clause = c;
-		}
-
-	      p += 2;
+	      blocked[idx] = true;
+	      PUSH (*stack, idx);
 	    }
 	}
-      watches->end = q;
-      if (EMPTY_STACK (*watches))
-	RELEASE_STACK (*watches);
     }
-  LOG ("saved %zu redundant binary clauses",
-       SIZE_STACK (solver->binaries) / 2);
 }
 
-#elif !defined(NBLOCK)
-
-// With blocking literals but without virtual clauses the watches all have
-// both a header and a clause.  We always drop the header (the blocking
-// literal) and in addition flush the reference to redundant clauses.
+// Resolve the candidates of a batch in parallel and then eliminate those
+// with few resolvents.  Returns 'false' if elimination should stop.
 
-static void
-flush_redundant_watches (struct satch *solver, bool new_fixed)
+static bool
+eliminate_candidates (struct satch *solver, struct resolver *resolvers,
+		      unsigned threads, unsigned *eliminated)
 {
-  for (all_literals (lit))
+  struct candidates *const candidates = resolvers->candidates;
+  const size_t size = SIZE_STACK (*candidates);
+  if (threads > size)
+    threads = size;
+
+  *resolvers->next = 0;
+  for (unsigned id = 0; id != threads; id++)
+    CLEAR_STACK (resolvers[id].resolvents);
+
+  for (unsigned id = 1; id != threads; id++)
     {
-      struct watches *watches = solver->watches + lit;
-      const union watch *const end = watches->end;
-      union watch *q = watches->begin;
-      for (const union watch * p = q; p != end; p += 2)
-	if (!p->header.redundant)
-	  {
-	    struct clause *c = p[1].clause;
-	    if (!new_fixed || !c->garbage)
-	      *q++ = p[1];
-	  }
-      watches->end = q;
-      if (EMPTY_STACK (*watches))
-	RELEASE_STACK (*watches);
+      struct resolver *const resolver = resolvers + id;
+      if (pthread_create (&resolver->thread, 0, run_resolver, resolver))
+	fatal_error ("failed to create resolver thread %u", id);
     }
-}
+  run_resolver (resolvers);
+  for (unsigned id = 1; id != threads; id++)
+    if (pthread_join (resolvers[id].thread, 0))
+      fatal_error ("failed to join resolver thread %u", id);
 
-#else
+  message (solver, 4, "elimination", solver->statistics.eliminations,
+	   "resolved batch of %zu independent candidates with %u threads",
+	   size, threads);
 
-// The simplest case without blocking literals (and also without virtual
-// binary clauses) we just flush redundant clauses. This has the same effect
-// as in the previous case (no virtual binary clauses but with blocking
-// literals) and thus when working in dense mode code we only need to
-// distinguish between having virtual binary clauses or not.
+  struct flags *const flags = solver->flags;
 
-static void
-flush_redundant_watches (struct satch *solver, bool new_fixed)
-{
-  for (all_literals (lit))
+  for (all_elements_on_stack (struct candidate, candidate, *candidates))
     {
-      struct watches *watches = solver->watches + lit;
-      const union watch *const end = watches->end;
-      union watch *q = watches->begin;
-      struct clause *c;
-      for (const union watch * p = q; p != end; p++)
-	if (!(c = p->clause)->redundant && (!new_fixed || !c->garbage))
-	  *q++ = *p;
-      watches->end = q;
-      if (EMPTY_STACK (*watches))
-	RELEASE_STACK (*watches);
-    }
-}
+      ADD (elimination_ticks, candidate.ticks);
+      ADD (resolutions, candidate.resolutions);
+
+      const unsigned idx = candidate.idx;
+      if (!candidate.few)
+	{
+	  LOG ("many resolvents of %s", LOGVAR (idx));
+	  flags[idx].eliminate = false;
+	  continue;
+	}
 
+      assert (flags[idx].active);
+      assert (!solver->values[LITERAL (idx)]);
+      assert (EMPTY_STACK (solver->resolvents));
+
+      const struct resolver *const resolver = resolvers + candidate.resolver;
+      const unsigned *const begin = resolver->resolvents.begin;
+      for (const unsigned *p = begin + candidate.begin,
+	   *const end = begin + candidate.end; p != end; p++)
+	PUSH (solver->resolvents, *p);
+#ifndef NARENA
+      if (!resolvents_fit_into_arena (solver))
+	{
+	  flags[idx].eliminate = false;
+	  continue;
+	}
 #endif
 
-static void
-connect_occurrences_in_irredundant_clauses (struct satch *solver)
-{
-  assert (solver->dense);
-  for (all_irredundant_clauses (c))
-    {
-      const unsigned *const lits = c->literals;
-      const unsigned *const end = lits + c->size;
-      for (const unsigned *p = lits + 2; p != end; p++)
-       if (!c->garbage)
-         connect_literal (solver, *p, c);
+      eliminate_variable (solver, idx);
+      (*eliminated)++;
+
+      if (solver->inconsistent)
+	return false;
+
+      if (terminating (solver))
+	return false;
+
+#ifndef NELIMINATIONLIMITS
+      if (elimination_ticks_limit_hit (solver))
+	{
+	  message (solver, 4, "elimination", solver->statistics.eliminations,
+		   "elimination ticks limit hit");
+	  return false;
+	}
+#endif
     }
+
+  return true;
 }
 
-static void
-switch_to_dense_mode (struct satch *solver)
+// Eliminate batches of independent pivots until batches become too small
+// and return the number of eliminated variables.  Remaining candidates are
+// then tried by the sequential loop in 'eliminate_variables'.  Batches are
+// bounded in size such that hitting the ticks limit while eliminating the
+// candidates of a batch does not waste too much work (and independent of
+// the number of threads to keep the result deterministic).
+
+static unsigned
+eliminate_variables_in_parallel (struct satch *solver, unsigned threads)
 {
-  LOG ("switching to dense mode");
-  assert (!solver->dense);
-  bool new_fixed = solver->limits.eliminate.fixed < solver->statistics.fixed;
-  if (new_fixed)
-    mark_irredundant_clauses_as_garbage_if_satisfied (solver);
-  flush_redundant_watches (solver, new_fixed);
-  solver->dense = true;
-  connect_occurrences_in_irredundant_clauses (solver);
-}
+  const unsigned variables = VARIABLES;
+  struct flags *const flags = solver->flags;
 
-/*------------------------------------------------------------------------*/
+  bool *const blocked = calloc (variables, sizeof *blocked);
+  if (!blocked)
+    out_of_memory (variables * sizeof *blocked);
 
-#ifndef NVIRTUAL
+  struct resolver *const resolvers = calloc (threads, sizeof *resolvers);
+  if (!resolvers)
+    out_of_memory (threads * sizeof *resolvers);
 
-// With virtual binary clauses we need to make sure to keep the irredundant
-// binary clauses in the watcher stacks but otherwise drop all references.
+  struct candidates candidates;
+  INIT_STACK (candidates);
+  size_t next = 0;
 
-static void
-disconnect_all_clauses (struct satch *solver)
-{
-  assert (solver->dense);
-  const struct flags *const flags = solver->flags;
-  for (all_literals (lit))
+  for (unsigned id = 0; id != threads; id++)
     {
-      struct watches *watches = solver->watches + lit;
-      const union watch *const end = watches->end;
-      union watch *q = watches->begin;
-      struct clause *c;
-      bool lit_eliminated = flags[INDEX (lit)].eliminated;
-      for (const union watch * p = q; p != end; p++)
-	if (is_tagged_clause (c = p->clause))
-	  {
-	    const unsigned other = tagged_clause_to_literal (c);
-	    const bool other_eliminated = flags[INDEX (other)].eliminated;
-	    if (!lit_eliminated && !other_eliminated)
-	      {
-		union watch watch;
-		watch.header.binary = true;
-		watch.header.redundant = false;
-		watch.header.blocking = other;
-		*q++ = watch;
-	      }
-	    else
-	      delete_binary (solver, false, lit, other);
-	  }
-      watches->end = q;
+      struct resolver *const resolver = resolvers + id;
+      resolver->id = id;
+      resolver->solver = solver;
+      resolver->candidates = &candidates;
+      resolver->next = &next;
+      resolver->marks = calloc (variables, 1);
+      if (!resolver->marks)
+	out_of_memory (variables);
     }
-}
-
-#else
-
-static void
-disconnect_all_clauses (struct satch *solver)
-{
-  assert (solver->dense);
-  for (all_literals (lit))
-    CLEAR_STACK (solver->watches[lit]);
-}
-
-#endif
 
-#ifndef NVIRTUAL
+  struct unsigned_stack pending, stack;
+  INIT_STACK (pending);
+  INIT_STACK (stack);
 
-static void
-watch_saved_redundant_binaries (struct satch *solver)
-{
-  const unsigned *begin = solver->binaries.begin;
-  const unsigned *end = solver->binaries.end;
-  const struct flags *const flags = solver->flags;
-  for (const unsigned *p = begin; p != end; p += 2)
+  for (all_variables (idx))
     {
-      const unsigned i[2] = { INDEX (p[0]), INDEX (p[1]) };
-      const struct flags f[2] = { flags[i[0]], flags[i[1]] };
-      const bool eliminated[2] = { f[0].eliminated, f[1].eliminated };
-      if (!eliminated[0] && !eliminated[1])
-	{
-	  watch_binary (solver, true, p[0], p[1]);
-	  watch_binary (solver, true, p[1], p[0]);
-	}
-      else
-	delete_binary (solver, true, p[0], p[1]);
+      const struct flags *const f = flags + idx;
+      if (f->active && f->eliminate)
+	PUSH (pending, idx);
     }
-  CLEAR_STACK (solver->binaries);
-}
 
-#endif
+  unsigned eliminated = 0, batches = 0;
+  bool proceed = true;
 
-static void
-watch_clauses (struct satch *solver, struct clauses *clauses)
-{
-  for (all_pointers_on_stack (struct clause, c, *clauses))
-      watch_clause (solver, c);
-}
+  while (proceed && !EMPTY_STACK (pending))
+    {
+      CLEAR_STACK (candidates);
+
+      unsigned *q = pending.begin;
+      for (all_elements_on_stack (unsigned, idx, pending))
+	{
+	  if (!proceed || blocked[idx] ||
+	      SIZE_STACK (candidates) == parallel_elimination_limit)
+	    {
+	      *q++ = idx;
+	      continue;
+	    }
 
-static void
-switch_to_sparse_mode (struct satch *solver)
-{
-  LOG ("switching back to sparse mode");
-  assert (solver->dense);
-  disconnect_all_clauses (solver);
-  solver->dense = false;
-#ifndef NVIRTUAL
-  watch_saved_redundant_binaries (solver);
-#endif
-  watch_clauses (solver, &solver->irredundant);
-  watch_clauses (solver, &solver->redundant);
-}
+	  struct flags *const f = flags + idx;
+	  if (!f->active || !f->eliminate)
+	    continue;
 
-/*------------------------------------------------------------------------*/
+	  if (!can_be_eliminated (solver, idx))
+	    {
+	      f->eliminate = false;
+	      continue;
+	    }
 
-// Check whether a (redundant) clause contains an eliminated literal.
+	  const unsigned pivot = LITERAL (idx);
 
-static bool
-clause_eliminated (struct satch *solver, struct clause *c)
-{
-  assert (c->redundant);	// Coincidentally.
-  assert (!solver->level);
-  const struct flags *const flags = solver->flags;
-  for (all_literals_in_clause (lit, c))
-    if (flags[INDEX (lit)].eliminated)
-      return true;
-  return false;
-}
+	  struct candidate candidate;
+	  memset (&candidate, 0, sizeof candidate);
+	  candidate.idx = idx;
+#ifndef NGATES
+	  candidate.gated = find_gate (solver, pivot, &candidate.gate);
+#endif
+	  PUSH (candidates, candidate);
 
-static void
-mark_satisfied_eliminated_redundant_clauses_garbage (struct satch *solver)
-{
-  for (all_redundant_clauses (c))
-    if (!c->garbage)
-      {
-	if (clause_eliminated (solver, c))
-	  mark_garbage (solver, c, "eliminated");
-	else if (clause_satisfied (solver, c))
-	  mark_garbage (solver, c, "root-level satisfied");
-      }
-}
+	  block_occurrences (solver, blocked, &stack, pivot);
+	  block_occurrences (solver, blocked, &stack, NOT (pivot));
 
-// The irredundant eliminated clauses have been marked explicitly already
-// but we still need to mark redundant clauses with eliminated variables.
+#ifndef NELIMINATIONLIMITS
+	  if (elimination_ticks_limit_hit (solver))
+	    proceed = false;
+#endif
+	}
+      pending.end = q;
 
-static void
-mark_and_collect_garbage_clauses_after_elimination (struct satch *solver)
-{
-  assert (solver->dense);	// No flushing in 'clause_satisfied'!
+      for (all_elements_on_stack (unsigned, idx, stack))
+	blocked[idx] = false;
+      CLEAR_STACK (stack);
 
-  if (solver->limits.eliminate.fixed < solver->statistics.fixed)
-    mark_irredundant_clauses_as_garbage_if_satisfied (solver);
+      const size_t size = SIZE_STACK (candidates);
+      if (!size)
+	break;
 
-  mark_satisfied_eliminated_redundant_clauses_garbage (solver);
+      batches++;
+      if (!eliminate_candidates (solver, resolvers, threads, &eliminated))
+	proceed = false;
 
-  {
-    size_t bytes = 0, count = 0;
-    delete_garbage_clauses (solver, &solver->irredundant, &bytes, &count);
-    delete_garbage_clauses (solver, &solver->redundant, &bytes, &count);
+      if (size < parallel_elimination_batch)
+	break;
+    }
 
-    // We report on how many clauses we collected during elimination.
+  message (solver, 3, "elimination", solver->statistics.eliminations,
+	   "eliminated %u variables in %u parallel batches", eliminated,
+	   batches);
 
-    message (solver, 2, "elimination", solver->statistics.eliminations,
-	     "collected %zu clauses (%zu bytes, %.0f MB)",
-	     count, bytes, bytes / (double) (1u << 20));
+  for (unsigned id = 0; id != threads; id++)
+    {
+      struct resolver *const resolver = resolvers + id;
+      RELEASE_STACK (resolver->resolvents);
+      free (resolver->marks);
+    }
+  RELEASE_STACK (candidates);
+  RELEASE_STACK (pending);
+  RELEASE_STACK (stack);
+  free (resolvers);
+  free (blocked);
 
-    ADD (collected, bytes);
-  }
+  return eliminated;
 }
 
+/*------------------------------------------------------------------------*/
+#endif
 /*------------------------------------------------------------------------*/
 
-#ifndef NSUBSUMPTION
-
-// Assume 'size' literals have been marked.  Then try to find a clause
-// different from 'skip' in which the literal 'lit' occurs and has all the
-// marked literals.  This clause is then subsumed and marked garbage.  We also
-// perform strengthening through self-subsuming resolution, which removes
-// individual literals from clauses which are almost subsumed except for one
-// literal which occurs negated.
+/*------------------------------------------------------------------------*/
 
-// The clause literal 'traversed' denotes a literal whose watches are
-// currently traversed (the 'lit' in 'backward_subsume_literal').  If we
-// modify its watches we have to abort that traversals since iterators
-// (pointers into the stack) become invalid.
+// The main bounded variable elimination function.
 
-static bool
-backward_subsume_marked (struct satch *solver,
-			 unsigned size, unsigned lit,
-			 struct clause *skip, unsigned traversed)
+static int
+eliminate_variables (struct satch *solver)
 {
-#ifdef NSTRENGTHENING
-  (void) traversed;
-#endif
-  assert (solver->flags[INDEX (lit)].active);
+  START (eliminate);
+  const uint64_t eliminations = INC (eliminations);
 
-  struct watches *const watches = solver->watches + lit;
-  const signed char *const values = solver->values;
-  const signed char *const marks = solver->marks;
+  // First backtrack to decision level zero.
 
-  bool touched = false;		// Traversed literal watches touched.
+  update_phases_and_backtrack_to_root_level (solver);
+  assert (solver->trail.propagate == solver->trail.end);
+#ifdef COLD
+  discard_cold_clauses (solver);
+#endif
 
-  assert (!solver->level);
+#ifndef NELIMINATIONLIMITS
+  set_elimination_ticks_limit (solver);
+#endif
+#ifndef NSUBSUMPTIONLIMITS
+  set_subsumption_ticks_limit (solver);
+#endif
 
-  uint64_t ticks = 1 + CACHE_LINES_OF_STACK (watches);
+  // Switch to dense mode which flushes all watches to redundant clauses and
+  // connects all occurrences of literals in irredundant clauses.
 
-  ADD (subsumption_ticks, ticks);
+  switch_to_dense_mode (solver);
+#ifndef NARENA
+  reserve_arena (solver, live_arena_words (solver));
+  pin_arena (solver);
+#endif
 
-  const union watch *const end_of_watches = watches->end, *p;
-  union watch *q = watches->begin;
+  // Main elimination loop.
 
-  for (p = q; p != end_of_watches; p++)
+  unsigned eliminated, total = 0, round = 0;
+  const unsigned original = solver->statistics.remaining;
+
+  do
     {
-      const union watch watch = *q++ = *p;
-#ifdef NVIRTUAL
-      if (solver->inconsistent)
-	continue;
+#ifndef NSUBSUMPTION
+      full_backward_subsumption (solver);
+      if (!more_elimination_candidates (solver))
+	break;
 #endif
-      struct clause *c = watch.clause;
-      if (c == skip)
-	continue;
+      const unsigned remaining = solver->statistics.remaining;
+      eliminated = 0;
+      round++;
 
-#ifndef NVIRTUAL
-      if (is_tagged_clause (c))
-	{
-	  // We use 'remove_duplicated_virtual_binary_clauses' instead.
-	  continue;
-	}
-      else
+#ifndef NPARALLEL
+      const unsigned threads = solver->options.elimination_threads;
+      if (threads > 1)
+	eliminated = eliminate_variables_in_parallel (solver, threads);
 #endif
+      for (all_variables (idx))
 	{
-	  ticks++;
-	  if (c->garbage)
-	    continue;
-	}
-
-      if (c->size < size)
-	continue;
+	  if (solver->inconsistent)
+	    break;
 
-      bool satisfied = false;	// Clause actually satisfied.
-      unsigned clashed = 0;	// How many clashing literals.
-      unsigned found = 0;	// How many literals found.
-#ifndef NSTRENGTHENING
-      unsigned clashing = INVALID;	// The last clashing literal.
+	  if (can_be_eliminated (solver, idx) &&	// Check limits.
+	      produces_few_resolvents (solver, idx)	// Save resolvents.
+#ifndef NARENA
+	      && resolvents_fit_into_arena (solver)	// Without moving.
 #endif
-      for (all_literals_in_clause (other, c))
-	{
-	  const signed char value = values[other];
-	  if (value > 0)
+	    )
 	    {
-	      satisfied = true;
-	      break;
+	      eliminate_variable (solver, idx);	// Add resolvents.
+	      eliminated++;
 	    }
-	  if (value < 0)
-	    continue;
-	  const signed char mark = marked_literal (marks, other);
-	  if (!mark)
-	    continue;
-	  if (mark < 0)
+	  else
+	    solver->flags[idx].eliminate = false;
+
+	  if (terminating (solver))
+	    break;
+
+#ifndef NELIMINATIONLIMITS
+	  if (elimination_ticks_limit_hit (solver))
 	    {
-#ifndef NSTRENGTHENING
-	      if (clashed++)
-		break;
-	      clashing = other;
-#else
-	      clashed = 1;
+	      message (solver, 4, "elimination", eliminations,
+		       "elimination ticks limit hit");
 	      break;
-#endif
 	    }
-	  else
-	    assert (mark > 0);
-	  found++;
+#endif
 	}
 
-#ifndef NSTRENGTHENING
-      if (clashed > 1)
-	continue;
-#else
-      if (clashed)
-	continue;
+      total += eliminated;
+      message (solver, 3, "elimination", eliminations,
+	       "eliminated %u variables %.0f%% of remaining %u in round %u",
+	       eliminated, percent (eliminated, remaining), remaining, round);
+
+      report (solver, 1 + !eliminated, 'e');
+      if (terminating (solver))
+	break;
+#ifndef NELIMINATIONLIMITS
+      if (round >= elimination_rounds)
+	break;
+      if (elimination_ticks_limit_hit (solver))
+	break;
 #endif
-      if (satisfied)
-	{
-	  mark_garbage (solver, c, "root-level satisfied");
-	  continue;
-	}
+    }
+  while (!solver->inconsistent && eliminated);
 
-      if (found < size)
+  unsigned kept = 0;
+  const struct flags *const flags = solver->flags;
+  for (all_variables (idx))
+    {
+      const struct flags *const f = flags + idx;
+      if (!f->active)
 	continue;
+      if (f->eliminate)
+	kept++;
+    }
 
-      assert (found == size);
-
-#ifndef NSTRENGTHENING		// Begin of strengthening code.
+  message (solver, 3, "elimination", eliminations,
+	   "keeping %u variables scheduled %.0f%%",
+	   kept, percent (kept, solver->statistics.remaining));
 
-      if (clashed)
-	{
-#ifndef NSUBSUMPTIONLIMITS
-	  {
-	    const size_t occs = SIZE_STACK (solver->watches[clashing]);
-	    if (occs >= strengthening_occurrence_limit)
-	      continue;
-	  }
-#endif
-	  assert (clashed == 1);
-	  assert (clashing != INVALID);
-	  LOGCLS (c, "single clashing literal %s", LOGLIT (clashing));
+  message (solver, 2, "elimination", eliminations,
+	   "eliminated %u variables %.0f%% in total in %u rounds",
+	   total, percent (total, original), round);
 
-	  // The negation of this assertion as a coverage hole was never
-	  // triggered, It could be accommodated by setting 'touched = true'
-	  // in this case, but as it never happens we added this assertion.
+  // Collect clauses which are marked garbage, i.e., are root-level
+  // satisfied or contain an eliminated variable.
 
-	  assert (clashing != traversed);
+  mark_and_collect_garbage_clauses_after_elimination (solver);
 
-#ifdef NVIRTUAL
-	  unsigned unit = INVALID;
-	  if (c->size == 2)
-	    {
-	      for (all_literals_in_clause (other, c))
-		if (other != clashing)
-		  assert (unit == INVALID), unit = other;
-	      assert (unit != INVALID);
+  // Switch back to sparse mode watching all clauses.
 
-	      const signed char value = solver->values[unit];
-	      assert (value <= 0);
-	      if (value < 0)
-		{
-		  trace_and_check_empty_addition (solver);
-		  LOG ("inconsistent unit %s resolved", LOGLIT (unit));
-		  solver->inconsistent = true;
-		  touched = true;
-		  continue;
-		}
-	    }
+  switch_to_sparse_mode (solver);
+#ifndef NARENA
+  unpin_arena (solver);
+  compact_arena (solver);
 #endif
-	  trace_and_check_clause_addition (solver, c, clashing);
-	  trace_and_check_clause_deletion (solver, c);
 
-	  mark_eliminate_literal (solver, clashing);
-#ifdef NVIRTUAL
-	  if (c->size == 2)
-	    {
-	      LOG ("resolved unit %s", LOGLIT (unit));
-	      assert (unit != INVALID);
-	      assert (!solver->values[unit]);
-	      assign (solver, unit, 0, false);
-	    }
-	  else
-#endif
-	    {
-	      assert (c->size > 2);
-	      if (lit == clashing)
-		{
-		  LOGCLS (c, "disconnecting %s from", LOGLIT (lit));
-		  q--;
-		}
-	      else
-		{
-		  ticks++;
-		  disconnect_literal (solver, clashing, c);
-		}
+  // Need to propagate over redundant clauses too.
 
-	      for (all_literals_in_clause (other, c))
-		if (other != clashing)
-		  mark_subsume_literal (solver, other);
-	    }
+  solver->trail.propagate = solver->trail.begin;
 
-#ifndef NVIRTUAL
+#ifndef NINPROCESSING
 
-	  // Ternary clauses become virtual binary clauses.
+  // Finally update limits.
 
-	  if (c->size == 3)
-	    {
-	      c->garbage = true;
-	      unsigned first = INVALID, second = INVALID;
+  {
+    const struct statistics *const statistics = &solver->statistics;
+    struct limits *const limits = &solver->limits;
 
-	      for (all_literals_in_clause (other, c))
-		if (other != clashing)
-		  {
-		    if (first == INVALID)
-		      first = other;
-		    else
-		      {
-			assert (second == INVALID);
-			second = other;
-		      }
-		    disconnect_literal (solver, other, c);
-		  }
-	      assert (first != INVALID);
-	      assert (second != INVALID);
-	      connect_literal (solver, first, tag_binary_clause (0, second));
-	      connect_literal (solver, second, tag_binary_clause (0, first));
-	      touched = (first == traversed || second == traversed);
-	      ticks += 2;
-	    }
-	  else
-#else
-	  if (c->size > 2)
+    if (!kept)
+      {
+	limits->eliminate.fixed = statistics->fixed;
+	limits->eliminate.marked = statistics->marked_eliminate;
+      }
+
+#ifndef NELIMINATIONLIMITS
+    limits->eliminate.search = statistics->ticks;
+#endif
+#ifndef NSUBSUMPTIONLIMITS
+    limits->subsume.search = statistics->ticks;
 #endif
-	    {
-	      // Keep clause as is but remove a literal and reduce size.
 
-	      unsigned *r = c->literals;
-	      const unsigned *end_of_literals = r + c->size;
-	      while (assert (r != end_of_literals), *r != clashing)
-		r++;
-	      while (++r != end_of_literals)
-		r[-1] = *r;
+    const uint64_t interval =
+      scale_interval (elimination_interval, nlognlogn, eliminations);
+    limits->eliminate.conflicts = CONFLICTS + interval;
 
-	      c->size--;
-#ifndef NGLUE
-	      assert (!c->glue);
-#endif
-#ifndef NCACHE
-	      c->search = 0;
+    message (solver, 4, "elimination", eliminations,
+	     "next limit at %" PRIu64 " after %" PRIu64 " conflicts",
+	     limits->eliminate.conflicts, interval);
+  }
 #endif
-	      LOGCLS (c, "strengthened");
-	      INC (strengthened);
-	    }
-	}
-      else
-#endif // if '#ifndef NSTRENGTHENING' so end of strengthening code.
 
+  STOP (eliminate);
+
+  return solver->inconsistent ? 20 : 0;
+}
+
+static void
+extend_solution (struct satch *solver)
+{
+  const unsigned *const begin = solver->extend.begin;
+  signed char *const values = solver->values;
+
+  const unsigned *p = solver->extend.end;
+
+  unsigned last = INVALID;
+  bool satisfied = false;
+  signed char value = -1;
+
+  while (p != begin)
+    {
+      const unsigned lit = *--p;
+      if (lit != INVALID)
 	{
-	  mark_garbage (solver, c, "subsumed");
-	  INC (subsumed);
+	  value = values[lit];
+	  assert (value);
+	  if (value > 0)
+	    satisfied = true;
+	}
+      else if (!satisfied)
+	{
+	  assert (last != INVALID);
+	  values[last] = 1;
+	  values[NOT (last)] = -1;
+	  LOG ("flipped value of %s", LOGLIT (last));
 	}
+      else
+	satisfied = false;
+      last = lit;
     }
-  watches->end = q;
-  if (EMPTY_STACK (*watches))
-    RELEASE_STACK (*watches);
+}
 
-  ADD (subsumption_ticks, ticks);
+/*------------------------------------------------------------------------*/
+#endif // of '#ifndef NELIMINATION'
+/*------------------------------------------------------------------------*/
 
-#ifdef LOGGING
-  if (touched)
-    LOG ("watches of traversed literal %s touched", LOGLIT (traversed));
-#endif
+#ifndef NPROBING
+/*------------------------------------------------------------------------*/
 
-  return touched;
-}
+// Failed literal probing and equivalent literal substitution both work on
+// the binary implication graph, in which each irredundant binary clause
+// '(a | b)' gives the two implications '-a -> b' and '-b -> a'.
 
-// Use the given clause to subsume other connected clauses.
+// First, in dense mode, we compute the strongly connected components of
+// this graph with an iterative version of Tarjan's algorithm.  All literals
+// in a component are equivalent and are substituted by a representative.
+// Substituted variables are treated exactly like eliminated variables, with
+// the two binary clauses of the equivalence pushed on the extension stack.
+// If a literal and its negation end up in the same component the formula
+// is unsatisfiable.
 
-// We only traverse the occurrence list of a single literal in the clause
-// with the smallest number of occurrences to find subsumed clauses and also
-// bound the maximum size of that list as well as the size of clauses.
+// Second, back in sparse mode, the roots of the binary implication graph
+// (literals with implied but without implying literals) are probed by
+// assigning them on the first decision level and propagating.  If this
+// yields a conflict the negation of the probe is a (failed literal) unit.
 
-// Furthermore only clauses with all literals (actually variables) marked as
-// subsume candidate will be considered, since newly added clauses will mark
-// their variables as subsume candidates.
+// Per literal state of Tarjan's algorithm.
 
-// If the watch list of the 'traversed' literals is modified we return 'true'
-// in order for the calling function ('backward_subsume_literal') to restart
-// the watch list traversal (because its iterators became invalid).
+struct tarjan
+{
+  unsigned index;		// Depth-first search index ('INVALID' if done).
+  unsigned low;			// Smallest reachable index on the stack.
+  unsigned next;		// Next occurrence to traverse.
+};
+
+// Found a new strongly connected component of literals on the 'component'
+// stack starting at 'begin'.  Its representative is the literal of the
+// variable which is frozen (assumed or in an XOR constraint) or otherwise
+// has the smallest index and thus the representative of the negated
+// component is the negated literal.
 
 static bool
-backward_subsume_with_clause (struct satch *solver,
-			      struct clause *c, unsigned traversed)
+new_equivalent_literals (struct satch *solver, unsigned *repr,
+			 const unsigned *begin, const unsigned *end)
 {
-#ifndef NVIRTUAL
-  if (!is_temporary_binary (solver, c))
-#endif
+  const struct flags *const flags = solver->flags;
+  signed char *const marks = solver->marks;
+  unsigned representative = INVALID;
+  const unsigned *p;
+
+  for (p = begin; p != end; p++)
     {
-      assert (!c->subsumed);
-      c->subsumed = true;
+      const unsigned lit = *p;
+      const unsigned idx = INDEX (lit);
+      if (marks[idx])
+	break;
+      mark_literal (marks, lit);
+      if (representative == INVALID)
+	representative = lit;
+      else
+	{
+	  const unsigned best = INDEX (representative);
+	  const bool frozen = flags[idx].assumed || flags[idx].xors;
+	  const bool best_frozen = flags[best].assumed || flags[best].xors;
+	  if (frozen > best_frozen || (frozen == best_frozen && idx < best))
+	    representative = lit;
+	}
     }
 
-  assert (!solver->level);
-  LOGCLS (c, "backward subsumption with");
-  assert (!c->redundant);
+  for (const unsigned *q = begin; q != p; q++)
+    unmark_literal (marks, *q);
 
-  bool satisfied = false;	// Clause 'c' satisfied.
-  bool touched = false;		// Literal 'traverse' watches touched.
-  bool subsume = true;		// All literals in 'c' marked 'subsume'.
+  if (p != end)
+    {
+      // Both 'lit' and 'NOT (lit)' are in this component.  Then the unit
+      // 'NOT (lit)' and afterwards the empty clause are implied by binary
+      // clause propagation and thus can be added (and checked) as RUP.
 
-  uint64_t min_pos_occs = UINT64_MAX;
-  uint64_t min_neg_occs = UINT64_MAX;
-  unsigned min_pos_lit = INVALID;
-  unsigned min_neg_lit = INVALID;
+      const unsigned lit = *p;
+      LOG ("literal %s and its negation are equivalent", LOGLIT (lit));
+      assign (solver, NOT (lit), 0, true);
+      trace_and_check_empty_addition (solver);
+      solver->inconsistent = true;
+      return false;
+    }
 
-  unsigned actual_size = 0;
+  for (p = begin; p != end; p++)
+    {
+      const unsigned lit = *p;
+      repr[lit] = representative;
+      if (lit != representative)
+	LOG ("literal %s equivalent to representative %s",
+	     LOGLIT (lit), LOGLIT (representative));
+    }
 
-  const struct watches *const watches = solver->watches;
-  const struct flags *const flags = solver->flags;
-  const signed char *values = solver->values;
-  signed char *marks = solver->marks;
+  return true;
+}
 
-  uint64_t ticks = 2;		// Clause plus watch list.
+// Compute all strongly connected components of the binary implication
+// graph where the implied literals of 'lit' are the other literals of the
+// binary clauses in which 'NOT (lit)' occurs.
 
-  for (all_literals_in_clause (lit, c))
-    {
-      signed char value = values[lit];
+static void
+find_equivalent_literals (struct satch *solver, unsigned *repr)
+{
+  struct tarjan *const tarjan = calloc (LITERALS, sizeof *tarjan);
+  if (!tarjan)
+    fatal_error ("could not allocate Tarjan state for probing");
 
-      if (value > 0)
-	{
-	  LOG ("contains satisfied literal %s", LOGLIT (lit));
-	  satisfied = true;
-	  break;
-	}
+  const struct flags *const flags = solver->flags;
+  struct unsigned_stack work, component;
+  INIT_STACK (work);
+  INIT_STACK (component);
 
-      if (value < 0)
+  unsigned visited = 0;
+  uint64_t ticks = 0;
+
+  for (all_literals (root))
+    {
+      if (!flags[INDEX (root)].active || tarjan[root].index)
 	continue;
 
-      const unsigned idx = INDEX (lit);
-      if (!flags[idx].subsume)
+      PUSH (work, root);
+
+      while (!EMPTY_STACK (work))
 	{
-	  LOG ("contains non-subsumption candidate %s", LOGVAR (idx));
-	  subsume = false;
-	  break;
-	}
+	  const unsigned lit = TOP (work);
+	  struct tarjan *const t = tarjan + lit;
+	  if (!t->index)
+	    {
+	      t->index = t->low = ++visited;
+	      PUSH (component, lit);
+	    }
 
-      // Otherwise mark the literal for the subsumption check.
+	  // Continue traversing implied literals where we left off.
 
-      mark_literal (marks, lit);
-      actual_size++;
+	  const unsigned not_lit = NOT (lit);
+	  const struct watches *const watches = solver->watches + not_lit;
+	  const unsigned size = SIZE_STACK (*watches);
+	  unsigned child = INVALID;
 
-      ticks++;
+	  while (child == INVALID && t->next < size)
+	    {
+	      struct clause *c = watches->begin[t->next++].clause;
+	      const unsigned other = binary_occurrence (solver, not_lit, c);
+	      ticks++;
+	      if (other == INVALID)
+		continue;
+	      const struct tarjan *const u = tarjan + other;
+	      if (!u->index)
+		child = other;
+	      else if (u->index != INVALID && u->index < t->low)
+		t->low = u->index;
+	    }
 
-      const size_t pos_occs = SIZE_STACK (watches[lit]);
-      if (pos_occs < min_pos_occs)
-	min_pos_occs = pos_occs, min_pos_lit = lit;
+	  if (child != INVALID)
+	    {
+	      PUSH (work, child);
+	      continue;
+	    }
 
-      const unsigned not_lit = NOT (lit);
+	  (void) POP (work);
 
-      const size_t neg_occs = SIZE_STACK (watches[not_lit]);
-      if (neg_occs < min_neg_occs)
-	min_neg_occs = neg_occs, min_neg_lit = not_lit;
-    }
+	  if (!EMPTY_STACK (work))
+	    {
+	      struct tarjan *const parent = tarjan + TOP (work);
+	      if (t->low < parent->low)
+		parent->low = t->low;
+	    }
 
-  ADD (subsumption_ticks, ticks);
+	  if (t->low != t->index)
+	    continue;
 
-  if (satisfied)
-    {
-#ifndef NVIRTUAL
-      if (!is_temporary_binary (solver, c))
-#endif
-	mark_garbage (solver, c, "root-level satisfied");
+	  unsigned *const end = component.end;
+	  unsigned *begin = end;
+	  while (*--begin != lit)
+	    ;
+
+	  if (!new_equivalent_literals (solver, repr, begin, end))
+	    break;
+
+	  for (const unsigned *p = begin; p != end; p++)
+	    tarjan[*p].index = INVALID;
+	  component.end = begin;
+	}
+
+      if (solver->inconsistent)
+	break;
     }
-  else if (subsume)
-    {
-      LOG ("actual size %u %s clause size %u", actual_size,
-	   actual_size < c->size ? "smaller" : "matches", c->size);
 
-#ifndef NSUBSUMPTIONLIMITS
-      if (min_pos_occs <= subsumption_occurrence_limit)
-#endif
-	{
-	  COVER (min_pos_lit == INVALID);
-	  assert (min_pos_lit != INVALID);
+  RELEASE_STACK (component);
+  RELEASE_STACK (work);
+  free (tarjan);
 
-	  LOG ("minimum positive occurrences %" PRIu64 " literal %s",
-	       min_pos_occs, LOGLIT (min_pos_lit));
+  ADD (probe_ticks, ticks);
+}
 
-	  if (backward_subsume_marked (solver, actual_size,
-				       min_pos_lit, c, traversed))
-	    touched = true;
-	}
-#ifdef NVIRTUAL
-      if (!solver->inconsistent && !solver->values[min_neg_lit])
-#endif
-#ifndef NSUBSUMPTIONLIMITS
-	if (min_neg_occs <= subsumption_occurrence_limit)
-#endif
-	  {
-	    COVER (min_neg_lit == INVALID);
-	    assert (min_neg_lit != INVALID);
+// Add the clause with 'pivot' replaced by 'substitute' unless it becomes
+// root-level satisfied or a tautology.  Since the equivalence between the
+// two literals is implied by binary clauses this is a RUP step.
 
-	    LOG ("minimum negative occurrences %" PRIu64 " literal %s",
-		 min_neg_occs, LOGLIT (min_neg_lit));
+static void
+substitute_clause (struct satch *solver,
+		   unsigned pivot, unsigned substitute, struct clause *c)
+{
+  assert (EMPTY_STACK (solver->clause));
+  const signed char *const values = solver->values;
+  signed char *const marks = solver->marks;
+  bool trivial = false;
 
-	    if (backward_subsume_marked (solver, actual_size,
-					 min_neg_lit, c, traversed))
-	      touched = true;
-	  }
+  for (all_literals_in_clause (lit, c))
+    {
+      const unsigned other = lit == pivot ? substitute : lit;
+      const signed char value = values[other];
+      if (value < 0)
+	continue;
+      const signed char mark = marked_literal (marks, other);
+      if (value > 0 || mark < 0)
+	{
+	  trivial = true;
+	  break;
+	}
+      if (mark)
+	continue;
+      mark_literal (marks, other);
+      PUSH (solver->clause, other);
     }
 
-  for (all_literals_in_clause (lit, c))
-    unmark_literal (marks, lit);
+  for (all_elements_on_stack (unsigned, lit, solver->clause))
+      unmark_literal (marks, lit);
 
-  return touched;
+  if (!trivial)
+    {
+      LOGTMP ("substituted");
+      trace_and_check_temporary_addition (solver);
+      add_and_connect_resolvent (solver);
+    }
+
+  CLEAR_STACK (solver->clause);
 }
 
+// Substitute all occurrences of the variable by its representative, save
+// the equivalence on the extension stack and then remove its clauses.
+
 static void
-backward_subsume_literal (struct satch *solver, unsigned lit)
+substitute_variable (struct satch *solver, unsigned idx, const unsigned *repr)
 {
-#ifdef NVIRTUAL
-  if (solver->inconsistent || solver->values[lit])
-    return;
-#endif
+  assert (!solver->inconsistent);
 
-  INC (subsumption_ticks);
+  const unsigned lit = LITERAL (idx);
+  const unsigned not_lit = NOT (lit);
+  const unsigned other = repr[lit];
+  const unsigned not_other = NOT (other);
 
-  const struct watches *const watches = solver->watches + lit;
-#ifndef NSUBSUMPTIONLIMITS
-  if (SIZE_STACK (*watches) > subsumption_occurrence_limit)
-    return;
-#endif
+  assert (other != lit);
+  assert (repr[not_lit] == not_other);
 
-  LOG ("backward subsumption with clauses containing literal %s",
-       LOGLIT (lit));
+  LOG ("substituting %s by %s", LOGLIT (lit), LOGLIT (other));
 
-  uint64_t ticks = CACHE_LINES_OF_STACK (watches);
+  {
+    struct flags *f = solver->flags + idx;
+    assert (f->active);
+    assert (!f->eliminated);
+    f->eliminated = true;
+    f->active = false;
+    DEC (remaining);
+    INC (substituted);
+  }
 
-RESTART:			// If 'watches' touched (added or removed watches).
+  struct watches *const pos_watches = solver->watches + lit;
+  struct watches *const neg_watches = solver->watches + not_lit;
 
-  for (all_elements_on_stack (union watch, watch, *watches))
+  uint64_t ticks = 2 + CACHE_LINES_OF_STACK (pos_watches) +
+    CACHE_LINES_OF_STACK (neg_watches);
+
+  for (unsigned sign = 0; sign != 2; sign++)
     {
-      struct clause *c = watch.clause;
+      const unsigned pivot = sign ? not_lit : lit;
+      const unsigned substitute = sign ? not_other : other;
+      struct watches *const watches = sign ? neg_watches : pos_watches;
+      for (all_elements_on_stack (union watch, watch, *watches))
+	{
+	  struct clause *c = watch.clause;
 #ifndef NVIRTUAL
-      if (is_tagged_clause (c))
-	c = untag_clause (solver, 0, lit, c);	// 1st temporary
-      else
+	  if (is_tagged_clause (c))
+	    c = untag_clause (solver, 0, pivot, c);
+	  else
 #endif
-	{
-	  ticks++;
-	  if (c->garbage || c->subsumed)
+	  if (c->garbage)
 	    continue;
+	  ticks += 1 + c->size;
+	  substitute_clause (solver, pivot, substitute, c);
+	  if (solver->inconsistent)
+	    break;
 	}
-#ifndef NSUBSUMPTIONLIMITS
-      if (c->size <= subsumption_clause_size_limit)
-#endif
-	if (backward_subsume_with_clause (solver, c, lit))
-	  {
-#ifdef NVIRTUAL
-	    if (solver->inconsistent || solver->values[lit])
-	      break;
-#endif
-	    LOG ("need to restart traversing %s watches", LOGLIT (lit));
-	    goto RESTART;
-	  }
+      if (solver->inconsistent)
+	break;
     }
 
-  ADD (subsumption_ticks, ticks);
-}
-
-#ifndef NVIRTUAL
+  // Both '(lit | -other)' and '(-lit | other)' are needed to restore the
+  // value of 'lit' and to restore both clauses if 'lit' is reactivated.
 
-// In 'backward_subsume_marked' we skip over tagged clauses because if such a
-// tagged clause is subsumed the watch has to be removed immediately instead
-// of marking it 'garbage'.  This is pretty awkward in that context and thus
-// we implement a dedicated routine below to just do that.  It actually does
-// all virtual binary clause (self-) subsumption of that literal in one go
-// and thus we also do not enforce an occurrence limit.
+  PUSH (solver->extend, INVALID);
+  PUSH (solver->extend, lit);
+  PUSH (solver->extend, not_other);
+  PUSH (solver->extend, INVALID);
+  PUSH (solver->extend, not_lit);
+  PUSH (solver->extend, other);
 
-static bool
-remove_duplicated_virtual_binary_clauses (struct satch *solver, unsigned lit)
-{
-  LOG ("removing duplicated virtual binary clauses with %s", LOGLIT (lit));
-  assert (solver->flags[INDEX (lit)].active);
-  assert (!solver->level);
+  eliminate_watched_clauses (solver, lit, pos_watches);
+  eliminate_watched_clauses (solver, not_lit, neg_watches);
 
-  struct watches *const watches = solver->watches + lit;
-  const union watch *const end = watches->end;
-  union watch *q = watches->begin, *p = q;
+  ADD (probe_ticks, ticks);
+}
 
-  uint64_t ticks = 1 + cache_lines (watches->begin, watches->end);
+#ifndef NARENA
 
-  signed char *marks = solver->marks;
-  bool assigned = false;
+// Each clause is substituted at most once for each of its substituted
+// variables and substituted clauses are not larger than the original ones.
+// Thus this bounds the number of words needed to add substituted clauses.
 
-  while (!assigned && p != end)
+static size_t
+substitution_words (struct satch *solver, const unsigned *repr)
+{
+  const struct flags *const flags = solver->flags;
+  size_t res = 0;
+  for (all_variables (idx))
     {
-      const union watch watch = *p++;
-      struct clause *c = watch.clause;
-      if (is_tagged_clause (c))
+      const struct flags *const f = flags + idx;
+      if (!f->active || f->assumed)
+	continue;
+      const unsigned lit = LITERAL (idx);
+      if (repr[lit] == lit)
+	continue;
+      for (unsigned sign = 0; sign != 2; sign++)
 	{
-	  const unsigned other = tagged_clause_to_literal (c);
-	  const signed char mark = marked_literal (marks, other);
-	  if (mark > 0)
-	    {
-	      really_delete_binary (solver, false, lit, other);
-	      struct clause *d = tag_binary_clause (false, lit);
-	      disconnect_literal (solver, other, d);
-	      INC (subsumed);
-	      ticks++;
-	      continue;
-	    }
-	  if (mark < 0)
+	  struct watches *const watches = solver->watches + (lit ^ sign);
+	  for (all_elements_on_stack (union watch, watch, *watches))
 	    {
-	      LOG ("self-subsuming virtual binary unit %s", LOGLIT (lit));
-	      trace_and_check_unit_addition (solver, lit);
-	      INC (strengthened);
-	      assign (solver, lit, 0, true);
-	      assigned = true;
+	      const struct clause *const c = watch.clause;
+#ifndef NVIRTUAL
+	      if (is_tagged_clause (c))
+		continue;
+#endif
+	      if (!c->garbage)
+		res += words_clause (c->size);
 	    }
-	  else
-	    mark_literal (marks, other);
 	}
-      *q++ = watch;
     }
-
-  for (const union watch * r = watches->begin; r != q; r++)
-    if (is_tagged_clause (r->clause))
-      unmark_literal (marks, tagged_clause_to_literal (r->clause));
-
-  while (p != end)
-    *q++ = *p++;
-
-  watches->end = q;
-
-  ADD (subsumption_ticks, ticks);
-
-  return !assigned;
+  return res;
 }
 
 #endif
 
 static void
-backward_subsume_variable (struct satch *solver, unsigned idx)
+substitute_equivalent_literals (struct satch *solver)
 {
-  LOG ("backward subsumption with clauses containing %s", LOGVAR (idx));
-  assert (solver->flags[idx].subsume);
-  assert (solver->flags[idx].active);
+  unsigned *const repr = malloc (LITERALS * sizeof *repr);
+  if (!repr)
+    fatal_error ("could not allocate representatives for probing");
+  for (all_literals (lit))
+    repr[lit] = lit;
 
-  const unsigned lit = LITERAL (idx);
-  const unsigned not_lit = NOT (lit);
-#ifndef NVIRTUAL
-  if (!remove_duplicated_virtual_binary_clauses (solver, lit))
-    return;
-  if (!remove_duplicated_virtual_binary_clauses (solver, not_lit))
-    return;
+  find_equivalent_literals (solver, repr);
+
+  const uint64_t substituted = solver->statistics.substituted;
+  const unsigned remaining = solver->statistics.remaining;
+
+  if (!solver->inconsistent)
+    {
+#ifndef NARENA
+      reserve_arena (solver, substitution_words (solver, repr));
+      pin_arena (solver);
 #endif
-  backward_subsume_literal (solver, lit);
-  backward_subsume_literal (solver, not_lit);
+      const struct flags *const flags = solver->flags;
+      for (all_variables (idx))
+	{
+	  const struct flags *const f = flags + idx;
+	  if (!f->active || f->assumed || f->xors)
+	    continue;
+	  const unsigned lit = LITERAL (idx);
+	  if (repr[lit] == lit)
+	    continue;
+#ifdef COLD
+	  discard_cold_clauses (solver);
+#endif
+	  substitute_variable (solver, idx, repr);
+	  if (solver->inconsistent)
+	    break;
+	}
+#ifndef NARENA
+      unpin_arena (solver);
+#endif
+    }
 
-  solver->flags[idx].subsume = 2;
+  free (repr);
+
+  const uint64_t delta = solver->statistics.substituted - substituted;
+  message (solver, 2, "probing", solver->statistics.probings,
+	   "substituted %" PRIu64 " variables %.0f%% of remaining %u",
+	   delta, percent (delta, remaining), remaining);
 }
 
-#ifndef NSUBSUMPTIONLIMITS
+// Literals occurring in binary clauses are implied by the negation of the
+// other literal.  Thus if a literal does not occur in any binary clause but
+// its negation does, then it is a root of the binary implication graph.
 
 static bool
-subsumption_ticks_limit_hit (struct satch *solver)
+occurs_in_binary_clause (struct satch *solver, unsigned lit)
 {
-  return solver->statistics.subsumption_ticks > solver->limits.subsume.ticks;
+  const struct watches *const watches = solver->watches + lit;
+  for (all_elements_on_stack (union watch, watch, *watches))
+    if (binary_occurrence (solver, lit, watch.clause) != INVALID)
+      return true;
+  return false;
 }
 
-#endif
-
 static void
-full_backward_subsumption (struct satch *solver)
+schedule_probes (struct satch *solver, struct unsigned_stack *probes)
 {
-  if (!more_subsumption_candidates (solver))
-    return;
-
-  START (subsume);
-  const uint64_t subsumptions = INC (subsumptions);
-
-  LOG ("backward subsumption with clauses containing subsume candidates");
+  assert (EMPTY_STACK (*probes));
+  const struct flags *const flags = solver->flags;
+  uint64_t ticks = 0;
+  for (all_variables (idx))
+    {
+      if (!flags[idx].active)
+	continue;
+      const unsigned lit = LITERAL (idx);
+      const unsigned not_lit = NOT (lit);
+      const bool pos = occurs_in_binary_clause (solver, lit);
+      const bool neg = occurs_in_binary_clause (solver, not_lit);
+      ticks += 2;
+      if (pos && !neg)
+	PUSH (*probes, not_lit);
+      else if (neg && !pos)
+	PUSH (*probes, lit);
+    }
+  ADD (probe_ticks, ticks);
+  message (solver, 3, "probing", solver->statistics.probings,
+	   "scheduled %zu probes", SIZE_STACK (*probes));
+}
 
-  struct flags *flags = solver->flags;
+/*------------------------------------------------------------------------*/
 
-  uint64_t total_subsumed = 0, total_strengthened = 0;
-  uint64_t strengthened;
-  unsigned round = 0;
+#ifndef NINPROCESSING
 
-  do
-    {
-      round++;
+// As for elimination we bound the time spent in probing by a fraction of
+// the search ticks since the last probing phase.
 
-      const uint64_t subsumed_before = solver->statistics.subsumed;
-      const uint64_t strengthened_before = solver->statistics.strengthened;
-      const unsigned remaining = solver->statistics.remaining;
-      unsigned scheduled = 0, tried = 0;
+static void
+set_probing_ticks_limit (struct satch *solver)
+{
+  struct limits *const limits = &solver->limits;
+  const struct statistics *const statistics = &solver->statistics;
+  const uint64_t delta = statistics->ticks - limits->probe.search;
+  const uint64_t limit = delta * probing_ticks_fraction;
+  message (solver, 2, "probing", statistics->probings,
+	   "probing limit of %" PRIu64 " ticks = %g * search ticks %"
+	   PRIu64, limit, (double) probing_ticks_fraction, delta);
+  limits->probe.ticks = statistics->probe_ticks + limit;
+}
 
-      for (all_variables (idx))
-	{
-	  struct flags *f = flags + idx;
-	  if (f->active && (f->subsume &= 1))
-	    scheduled++;
-	}
+static bool
+probing_ticks_limit_hit (struct satch *solver)
+{
+  return solver->statistics.probe_ticks > solver->limits.probe.ticks;
+}
 
-      for (all_variables (idx))
-	{
-	  struct flags *f = flags + idx;
-	  if (f->active && f->subsume)
-	    {
-	      backward_subsume_variable (solver, idx);
-	      tried++;
-#ifndef NSUBSUMPTIONLIMITS
-	      if (subsumption_ticks_limit_hit (solver))
-		{
-		  message (solver, 4, "subsumption", subsumptions,
-			   "subsumption ticks limit hit");
-		  break;
-		}
 #endif
-	    }
-	}
 
-      message (solver, 3, "subsumption", subsumptions,
-	       "tried %u variables %.0f%% of %u scheduled %.0f%%"
-	       " in round %u", tried, percent (tried, scheduled),
-	       scheduled, percent (scheduled, remaining), round);
+// Propagation during probing accounts for ticks separately.
 
-      uint64_t subsumed = solver->statistics.subsumed - subsumed_before;
-      strengthened = solver->statistics.strengthened - strengthened_before;
-
-      total_subsumed += subsumed;
-      total_strengthened += strengthened;
+static struct clause *
+probe_propagate (struct satch *solver)
+{
+  struct trail *trail = &solver->trail;
+  unsigned *propagate = trail->propagate;
+  unsigned *p;
 
-      message (solver, 3, "subsumption", subsumptions,
-	       "subsumed %" PRIu64 " and strengthened %" PRIu64
-	       " clauses in round %u", subsumed, strengthened, round);
+  struct clause *conflict = 0;
+  uint64_t ticks = 0;
 
-      report (solver, 1 + !(subsumed + strengthened), 's');
-#ifndef NSUBSUMPTIONLIMITS
-      if (round >= subsumption_rounds)
-	break;
-      if (subsumption_ticks_limit_hit (solver))
-	break;
-#endif
-    }
-  while (!solver->inconsistent && strengthened);
+  for (p = propagate; !conflict && p != trail->end; p++)
+    conflict = propagate_assignment (solver, *p, &ticks);
 
-  for (all_irredundant_clauses (c))
-    c->subsumed = false;
+  ADD (probe_ticks, ticks);
+  trail->propagate = p;
 
-  unsigned kept = 0;
-  for (all_variables (idx))
-    {
-      struct flags *f = flags + idx;
-      if (f->active & (f->subsume & 1))
-	kept++;
-    }
+  if (!conflict && !solver->level)
+    flush_units (solver);
 
-  message (solver, 3, "subsumption", subsumptions,
-	   "keeping %u variables scheduled %.0f%%",
-	   kept, percent (kept, solver->statistics.remaining));
+  return conflict;
+}
 
-  if (!kept)
-    solver->limits.subsume.marked = solver->statistics.marked_subsume;
+#ifndef NHYPER
 
-  message (solver, 2, "subsumption", subsumptions,
-	   "subsumed %" PRIu64 " and strengthened %" PRIu64
-	   " clauses in %u rounds",
-	   total_subsumed, total_strengthened, round);
+// Lazy hyper binary resolution turns the implication graph of a probe into
+// a tree of binary reasons after propagation.  For each literal on the trail
+// implied by a large clause all the other (false) literals of its reason are
+// implied by binary reasons already.  Their dominator in that tree implies
+// the literal and the hyper binary resolvent of the dominator and the literal
+// becomes its new binary reason.
 
-  STOP (subsume);
-}
+// Return the literal implying 'lit' through a binary reason or 'INVALID' if
+// 'lit' is the probe or its reason is not binary.
 
+static unsigned
+binary_reason_parent (struct satch *solver, unsigned lit)
+{
+  const struct clause *const reason = REASON (INDEX (lit));
+  if (!reason)
+    return INVALID;
+#ifndef NBLOCK
+  if (is_tagged_clause (reason))
+    return NOT (tagged_clause_to_literal (reason));
 #endif
+  if (reason->parity || reason->size != 2)
+    return INVALID;
+  return NOT (lit ^ reason->literals[0] ^ reason->literals[1]);
+}
 
-/*------------------------------------------------------------------------*/
-
-// Flush out garbage (satisfied and eliminated) clause occurrences.  Returns
-// the remaining number of occurrences or 'elimination_occurrence_limit + 1'
-// if a clause exceeds the elimination clause size limit or there are too
-// many, i.e., more than 'elimination_occurrence_limit' remaining.
+// Find the closest common ancestor of both literals in the tree.
 
 static unsigned
-actual_number_of_occurrences (struct satch *solver, unsigned lit)
+probing_dominator (struct satch *solver, unsigned a, unsigned b,
+		   uint64_t * ticks)
 {
-#ifndef NELIMINATIONLIMITS
-  assert (elimination_occurrence_limit < UINT_MAX);
-#endif
-  assert (!solver->flags[INDEX (lit)].fixed);
+  signed char *const marks = solver->marks;
+  unsigned lit, res;
+  for (lit = a; lit != INVALID; lit = binary_reason_parent (solver, lit))
+    mark_literal (marks, lit), ++*ticks;
+  for (res = b; res != INVALID; res = binary_reason_parent (solver, res))
+    if (marks[INDEX (res)])
+      break;
+    else
+      ++*ticks;
+  for (lit = a; lit != INVALID; lit = binary_reason_parent (solver, lit))
+    unmark_literal (marks, lit);
+  return res;
+}
 
-  struct watches *watches = solver->watches + lit;
+// Add the binary clause on the temporary clause stack and return it as
+// reason for its first literal.
+
+static struct clause *
+add_hyper_binary_resolvent (struct satch *solver, bool redundant)
+{
+  trace_and_check_temporary_addition (solver);
 #ifndef NVIRTUAL
-  signed char *values = solver->values;
+  const unsigned other = ACCESS (solver->clause, 1);
+  add_new_binary_and_watch_it (solver, redundant);
+  return tag_binary_clause (redundant, other);
+#else
+  struct clause *res;
+  if (redundant)
+    {
+#ifndef NGLUE
+      res = new_redundant_clause (solver, 1);
+#else
+      res = new_redundant_clause (solver);
+#endif
+#ifndef NUSED
+      res->used = 1;
+#endif
+    }
+  else
+    res = new_irredundant_clause (solver);
+  watch_clause (solver, res);
+  return res;
 #endif
+}
 
-  union watch *begin = watches->begin, *q = begin;
-  const union watch *end = watches->end, *p = q;
+// The trail starting at 'begin' contains the probe and its implied
+// literals.  If the dominator of a large reason is the negation of one of
+// its literals then the hyper binary resolvent subsumes the reason, which
+// thus is replaced (and otherwise the resolvent is redundant).
 
-  uint64_t ticks = 1;		// To access 'watches'.
-  unsigned res = 0;
+static void
+hyper_binary_resolve (struct satch *solver, const unsigned *begin)
+{
+  assert (solver->level == 1);
+  assert (EMPTY_STACK (solver->clause));
+  const unsigned *const end = solver->trail.end;
+  uint64_t ticks = 0, hyper = 0;
 
-  while (p != end)
+  for (const unsigned *p = begin + 1; p != end; p++)
     {
-      const union watch watch = *p++;
-
-      struct clause *c = watch.clause;
-#ifndef NVIRTUAL
-      if (is_tagged_clause (c))
-	{
-	  const unsigned other = tagged_clause_to_literal (c);
-	  if (values[other] > 0)
-	    {
-	      really_delete_binary (solver, false, lit, other);
-	      struct clause *d = tag_binary_clause (false, lit);
-	      disconnect_literal (solver, other, d);
-	      ticks++;
-	      continue;
-	    }
-	}
-      else
+      const unsigned lit = *p;
+      const unsigned idx = INDEX (lit);
+      struct clause *reason = REASON (idx);
+      assert (reason);
+#ifndef NBLOCK
+      if (is_tagged_clause (reason))
+	continue;
 #endif
+      if (reason->parity || reason->size == 2)
+	continue;
+
+      ticks++;
+      unsigned dominator = INVALID;
+      bool first = true;
+      for (all_literals_in_clause (other, reason))
 	{
-	  ticks++;
-	  if (mark_garbage_if_satisfied (solver, c))
+	  if (other == lit || !LEVEL (INDEX (other)))
 	    continue;
+	  assert (solver->values[other] < 0);
+	  if (first)
+	    dominator = NOT (other), first = false;
+	  else
+	    dominator =
+	      probing_dominator (solver, dominator, NOT (other), &ticks);
+	  if (dominator == INVALID)
+	    break;
 	}
+      if (dominator == INVALID)
+	continue;
 
-      *q++ = watch;
-      res++;
-
-#ifndef NELIMINATIONLIMITS
-      if (res > elimination_occurrence_limit)
-	break;
-#ifndef NVIRTUAL
-      if (!is_tagged_clause (c))
+#if defined(NVIRTUAL) && !defined(NARENA)
+      if (available_arena_words (solver) < words_clause (2))
+	break;			// Would move clauses.
 #endif
-	if (c->size > elimination_clause_size_limit)
-	  {
-	    res = elimination_occurrence_limit + 1;
-	    break;
-	  }
-#endif
-    }
+      const unsigned not_dominator = NOT (dominator);
+      bool subsumed = false;
+      for (all_literals_in_clause (other, reason))
+	if (other == not_dominator)
+	  subsumed = true;
 
-  ticks += cache_lines (begin, q);
-  ADD (elimination_ticks, ticks);
+      PUSH (solver->clause, lit);
+      PUSH (solver->clause, not_dominator);
+      LOGTMP ("hyper binary resolvent");
+      const bool redundant = !subsumed || reason->redundant;
+      struct clause *binary = add_hyper_binary_resolvent (solver, redundant);
+      CLEAR_STACK (solver->clause);
 
-  while (p != end)
-    *q++ = *p++;
+      if (subsumed)
+	{
+	  unwatch_literal (solver, reason->literals[0], reason);
+	  unwatch_literal (solver, reason->literals[1], reason);
+	  mark_garbage (solver, reason, "hyper binary resolvent subsumed");
+	}
 
-  watches->end = q;
-  if (EMPTY_STACK (*watches))
-    RELEASE_STACK (*watches);
+      REASON (idx) = binary;
+      hyper++;
+    }
 
-  return res;
+  ADD (probe_ticks, ticks);
+  ADD (hyper, hyper);
 }
 
-// Check if the given variable matches is still active, its clauses stay
-// below the clause size limit and it does not occur too often.
+#endif
 
-static bool
-can_be_eliminated (struct satch *solver, unsigned pivot_idx)
+static void
+probe_literals (struct satch *solver, struct unsigned_stack *probes)
 {
-  const struct flags *const f = solver->flags + pivot_idx;
-  if (!f->active)
-    return false;
-  if (!f->eliminate)
-    return false;
-
-  const unsigned lit = LITERAL (pivot_idx);
-  const unsigned not_lit = NOT (lit);
+  assert (!solver->level);
 
-#ifndef NELIMINATIONLIMITS
+  if (probe_propagate (solver))
+    {
+      LOG ("root-level propagation after substitution yields conflict");
+      trace_and_check_empty_addition (solver);
+      solver->inconsistent = true;
+      return;
+    }
 
-  const uint64_t pos = actual_number_of_occurrences (solver, lit);
-  const uint64_t neg = actual_number_of_occurrences (solver, not_lit);
+  const signed char *const values = solver->values;
+  const uint64_t failed = solver->statistics.failed;
+  uint64_t probed = 0;
 
-  if (pos && neg > elimination_occurrence_limit)
-    return false;
+  for (all_elements_on_stack (unsigned, probe, *probes))
+    {
+      if (terminating (solver))
+	break;
+#ifndef NINPROCESSING
+      if (probing_ticks_limit_hit (solver))
+	{
+	  message (solver, 4, "probing", solver->statistics.probings,
+		   "probing ticks limit hit");
+	  break;
+	}
+#endif
+      if (values[probe])
+	continue;
 
-  if (neg && pos > elimination_occurrence_limit)
-    return false;
+      LOG ("probing %s", LOGLIT (probe));
+      probed++;
+      solver->level++;
+#ifndef NHYPER
+      const unsigned *const begin = solver->trail.end;
+#endif
+      assign (solver, probe, 0, false);
+      struct clause *conflict = probe_propagate (solver);
+#ifndef NHYPER
+      if (!conflict)
+	hyper_binary_resolve (solver, begin);
+#endif
+      backtrack (solver, 0);
+      if (!conflict)
+	continue;
 
-#else
+      LOG ("failed literal %s", LOGLIT (probe));
+      INC (failed);
+      assign (solver, NOT (probe), 0, true);
+      if (!probe_propagate (solver))
+	continue;
 
-  (void) actual_number_of_occurrences (solver, lit);
-  (void) actual_number_of_occurrences (solver, not_lit);
+      LOG ("propagating failed literal %s yields conflict", LOGLIT (probe));
+      trace_and_check_empty_addition (solver);
+      solver->inconsistent = true;
+      break;
+    }
 
-#endif
+  ADD (probed, probed);
 
-  return true;
+  const uint64_t delta = solver->statistics.failed - failed;
+  message (solver, 2, "probing", solver->statistics.probings,
+	   "found %" PRIu64 " failed literals %.0f%% of %" PRIu64 " probed",
+	   delta, percent (delta, probed), probed);
 }
 
-// Check whether the given variable produces few resolvents and add them to
-// the resolvents stack.  The limit is the number of original clauses.
+/*------------------------------------------------------------------------*/
 
-// Process unit and empty clauses eagerly though which also requires that we
-// need to check antecedent clauses (again) and later also the saved
-// resolvents for being satisfied (or falsified).
+// The main probing function, which first substitutes equivalent literals
+// and then probes roots of the binary implication graph.
 
-static bool
-produces_few_resolvents (struct satch *solver, unsigned pivot_idx)
+static int
+probe (struct satch *solver)
 {
-  assert (!solver->inconsistent);
+  START (probe);
+  const uint64_t probings = INC (probings);
 
-  const unsigned pivot = LITERAL (pivot_idx);
-  const unsigned not_pivot = NOT (pivot);
+  update_phases_and_backtrack_to_root_level (solver);
+  assert (solver->trail.propagate == solver->trail.end);
 
-  struct watches *const pos_watches = solver->watches + pivot;
-  struct watches *const neg_watches = solver->watches + not_pivot;
+#ifndef NINPROCESSING
+  set_probing_ticks_limit (solver);
+#endif
 
-  assert (EMPTY_STACK (solver->resolvents));
+  struct unsigned_stack probes;
+  INIT_STACK (probes);
 
-  LOG ("trying to eliminate %s", LOGVAR (pivot_idx));
+  // Substitution needs full occurrence lists (and thus dense mode).
 
-  const size_t pos_count = SIZE_STACK (*pos_watches);
-  const size_t neg_count = SIZE_STACK (*neg_watches);
+  switch_to_dense_mode (solver);
+  substitute_equivalent_literals (solver);
+  if (!solver->inconsistent)
+    schedule_probes (solver, &probes);
+  mark_and_collect_garbage_clauses_after_elimination (solver);
+  switch_to_sparse_mode (solver);
+#ifndef NARENA
+  compact_arena (solver);
+#endif
 
-  const uint64_t limit = pos_count + neg_count;
-  uint64_t resolvents = 0;
+  // Need to propagate over redundant clauses too.
 
-  uint64_t ticks = 2;
-  ticks += CACHE_LINES_OF_STACK (pos_watches);
-  ticks += CACHE_LINES_OF_STACK (neg_watches);
+  solver->trail.propagate = solver->trail.begin;
 
-  signed char *marks = solver->marks;
+  if (!solver->inconsistent)
+    {
+#ifndef NARENA
+      pin_arena (solver);
+#endif
+      probe_literals (solver, &probes);
+#ifndef NARENA
+      unpin_arena (solver);
+#endif
+    }
 
-  assert (!solver->level);
-  assert (!solver->values[pivot]);
+  RELEASE_STACK (probes);
 
-  // Go over all clauses 'c' in which the variable occurs positively (outer
-  // loop) and all clauses 'd' in which it occurs negative (inner loop) and
-  // resolve 'c' with 'd' on the given variable.  Make sure to skip
-  // satisfied clauses and tautological resolvents.  Save the resolvents on
-  // the resolvents stack but eagerly add units (and the empty clause).
+  report (solver, 1, 'p');
 
-  for (all_elements_on_stack (union watch, pos_watch, *pos_watches))
-    {
-      struct clause *c = pos_watch.clause;
-#ifndef NVIRTUAL
-      if (is_tagged_clause (c))
-	c = untag_clause (solver, 0, pivot, c);
-      else
+#ifndef NINPROCESSING
+
+  // Finally update limits.
+
+  {
+    struct limits *const limits = &solver->limits;
+    limits->probe.search = solver->statistics.ticks;
+    const uint64_t interval =
+      scale_interval (probing_interval, nlognlogn, probings);
+    limits->probe.conflicts = CONFLICTS + interval;
+    message (solver, 4, "probing", probings,
+	     "next limit at %" PRIu64 " after %" PRIu64 " conflicts",
+	     limits->probe.conflicts, interval);
+  }
+#else
+  (void) probings;
 #endif
-	{
-	  ticks++;
-	  if (c->garbage)
-	    continue;
-	}
 
-      // Mark literals in 'c' to detect if a literal in 'c' occurs negated
-      // in a 'd' clause which would produce a tautological resolvent.
+  STOP (probe);
 
-      for (all_literals_in_clause (lit, c))
-	mark_literal (marks, lit);
+  return solver->inconsistent ? 20 : 0;
+}
 
-      for (all_elements_on_stack (union watch, neg_watch, *neg_watches))
-	{
-	  struct clause *d = neg_watch.clause;
-#ifndef NVIRTUAL
-	  if (is_tagged_clause (d))
-	    d = untag_clause (solver, 1, not_pivot, d);
-	  else
+static bool
+probing (struct satch *solver)
+{
+#ifndef NINPROCESSING
+  return solver->limits.probe.conflicts < CONFLICTS;
+#else
+  return !solver->statistics.probings;
 #endif
-	    {
-	      ticks++;
-	      if (d->garbage)
-		continue;
-	    }
+}
 
-	  LOGCLS (c, "1st antecedent");
-	  LOGCLS (d, "2nd antecedent");
+/*------------------------------------------------------------------------*/
+#endif // of '#ifndef NPROBING'
+/*------------------------------------------------------------------------*/
 
-	  INC (resolutions);
+#ifndef NVIVIFICATION
 
-	  bool tautological = false;
-	  for (all_literals_in_clause (lit, d))
-	    if (lit != not_pivot && marked_literal (marks, lit) < 0)
-	      {
-		LOG ("tautological resolvent with clashing %s and %s",
-		     LOGLIT (NOT (lit)), LOGLIT (lit));
-		tautological = true;
-		break;
-	      }
+static signed char
+satch_fixed (struct satch *solver, unsigned lit)
+{
 
-	  if (tautological)
-	    continue;
+  assert (lit < LITERALS);
+  const signed char value = solver->values[lit];
+  if (!value)
+    return 0;
+  if (LEVEL (INDEX (lit)))
+    return 0;
+  return value;
+}
 
-	  LOG ("resolvent non-tautological");
+static inline int
+int_compare (long int a, long int b)
+{
+  if (a < b)
+    return -1;
+  if (a == b)
+    return 0;
+  return 1;
+}
 
-	  if (++resolvents > limit)
-	    break;
+#ifdef NRADIXSORT
 
-	  // Copy literals of 'c' and 'd' to the resolvent stack skipping
-	  // over the pivot and duplicated literals.
+static inline int
+more_occurrences (const void *cp, const void *dp, void *countsp)
+  {
+      unsigned *counts = (unsigned *) countsp;
+      const unsigned litA = *((unsigned*) cp);
+      const unsigned litB = *((unsigned*) dp);
+      return int_compare (counts[litA], counts[litB]);
+  }
 
-	  for (all_literals_in_clause (lit, c))
-	    if (lit != pivot)
-	      PUSH (solver->resolvents, lit);
+#endif
 
-	  for (all_literals_in_clause (lit, d))
-	    if (!marks[INDEX (lit)])
-	      PUSH (solver->resolvents, lit);
+static void
+vivify_sort_lits_by_counts (struct satch *solver, unsigned *counts,
+			    struct unsigned_stack *c)
+{
 
-	  PUSH (solver->resolvents, INVALID);
-	}
+#ifndef NRADIXSORT
+#define MORE_OCCURRENCES(LIT) \
+  ~counts[LIT]
 
-      for (all_literals_in_clause (lit, c))
-	unmark_literal (marks, lit);
+  // The literals might be those of a clause and thus are not a stack.
 
-      if (resolvents > limit)
-	break;
+  RSORT_ARRAY (unsigned, unsigned, SIZE_STACK (*c), c->begin,
+	       MORE_OCCURRENCES, solver->scratch);
+#else
 
-      if (solver->inconsistent)
-	break;
-    }
+#define MORE_OCCURRENCES(LITA,LITB) \
+  ((~counts[LITA]) < (~counts[LITB]))
+  SORT_STACK (unsigned, *c, MORE_OCCURRENCES);
+#endif
+}
 
-  ADD (elimination_ticks, ticks);
+static void
+vivify_sort_stack_by_counts (struct satch *solver, unsigned *counts,
+			     struct unsigned_stack *c)
+{
+  vivify_sort_lits_by_counts (solver, counts, c);
+}
 
-  if (solver->inconsistent)
+static void
+vivify_sort_clause_by_counts (struct satch *solver, unsigned *counts,
+			      struct clause *c)
+{
+#ifndef NBLOCK
+  assert (!is_tagged_clause (c));
+#endif
+#ifndef NVIRTUAL
+  assert (!is_temporary_binary (solver, c));
+#endif
+  struct unsigned_stack c2 = {.begin = c->literals,
+    .end = c->literals + c->size,
+    .allocated = c->literals + c->size
+  };
+  vivify_sort_lits_by_counts (solver, counts, &c2);
+}
+
+
+static inline bool
+worse_candidate (unsigned* counts, const struct clause *const c, const struct clause *const d)
+{
+  assert (c);
+  assert (d);
+  assert (counts);
+#ifndef NBLOCK
+  assert (!is_tagged_clause (c));
+  assert (!is_tagged_clause (d));
+#endif
+  if (!c->vivify && d->vivify)
+    return true;
+
+  if (c->vivify && !d->vivify)
     return false;
 
-  if (resolvents > limit)
+  unsigned const *p = c->literals;
+  unsigned const *q = d->literals;
+  const unsigned *const e = c->literals + c->size;
+  const unsigned *const f = d->literals + d->size;
+
+  while (p != e && q != f)
     {
-      CLEAR_STACK (solver->resolvents);
-      LOG ("many resolvents %" PRIu64 " > limit %" PRIu64, resolvents, limit);
-      return false;
+      const unsigned a = *p++;
+      const unsigned b = *q++;
+      if (a == b)
+	continue;
+      const unsigned u = counts[a];
+      const unsigned v = counts[b];
+      if (u < v)
+        return true;
+      if (u > v)
+        return false;
+      return a < b;
     }
 
-  LOG ("few resolvents %" PRIu64 " <= limit %" PRIu64, resolvents, limit);
-  return true;
+  if (p != e && q == f)
+    return true;
+  if (p == e && q != f)
+    return false;
+
+  return (long int)c < (long int)d;
 }
 
-// Add and connect the temporary resolvent clause.
 
 static void
-add_and_connect_resolvent (struct satch *solver)
+sort_vivification_candidates (struct satch *solver,
+			      struct clauses *schedule, unsigned *counts)
 {
-  const size_t size = SIZE_STACK (solver->clause);
-  assert (size <= UINT_MAX);
-
-  if (!size)
-    {
-      LOG ("empty resolvent");
-      solver->inconsistent = true;
-    }
-  else if (size == 1)
-    {
-      const unsigned unit = ACCESS (solver->clause, 0);
-      LOG ("unit resolvent %s", LOGLIT (unit));
-      assign (solver, unit, 0, true);
-    }
-#ifndef NVIRTUAL
-  else if (size == 2)
-    {
-      const unsigned lit = ACCESS (solver->clause, 0);
-      const unsigned other = ACCESS (solver->clause, 1);
-      LOGBIN (false, lit, other, "resolvent");
-      connect_literal (solver, lit, tag_binary_clause (false, other));
-      connect_literal (solver, other, tag_binary_clause (false, lit));
-      INC (irredundant);
-    }
-#endif
-  else
+  for (all_pointers_on_stack (struct clause, c, *schedule))
     {
-      struct clause *resolvent = new_irredundant_clause (solver);
-      LOGCLS (resolvent, "resolvent");
-      connect_clause (solver, resolvent);
+      vivify_sort_clause_by_counts (solver, counts, c);
     }
+#define WORSE_CANDIDATE(c, d) \
+  worse_candidate (counts, c, d)
 
-#ifndef NSUBSUMPTION
-
-  // Mark variables in resolvent as subsumption candidates.
-
-  for (all_elements_on_stack (unsigned, lit, solver->clause))
-      mark_subsume_literal (solver, lit);
-
-#endif
+  SORT_STACK (struct clause*, *schedule, WORSE_CANDIDATE);
 }
 
-// Push the clause on the extension stack with 'eliminated' literal first.
-// See 'extend_solution' for more explanations on why we need this.
-
 static void
-push_clause_on_extension_stack (struct satch *solver,
-				unsigned eliminated, struct clause *c)
+count_literal (unsigned lit, unsigned *counts)
 {
-#ifndef NVIRTUAL
-  if (is_tagged_clause (c))
-    c = untag_clause (solver, 0, eliminated, c);
-#endif
-  PUSH (solver->extend, INVALID);	// Clause separator.
-  PUSH (solver->extend, eliminated);
-  for (all_literals_in_clause (lit, c))
-    if (lit != eliminated)
-      PUSH (solver->extend, lit);
+  const unsigned old_count = counts[lit];
+  const unsigned new_count =
+    (old_count < UINT_MAX) ? old_count + 1 : UINT_MAX;
+  counts[lit] = new_count;
 }
 
 static void
-push_unit_on_extension_stack (struct satch *solver, unsigned eliminated)
+vivify_count_clause (struct clause *c, unsigned *counts)
 {
-  PUSH (solver->extend, INVALID);	// Clause separator.
-  PUSH (solver->extend, eliminated);
+  for (all_literals_in_clause (lit, c))
+    count_literal (lit, counts);
 }
 
-static void
-push_clauses_on_extension_stack (struct satch *solver,
-				 unsigned eliminated, struct watches *watches)
+void
+flush_large_watches (struct satch *solver)
 {
-  for (all_elements_on_stack (union watch, watch, *watches))
-      push_clause_on_extension_stack (solver, eliminated, watch.clause);
+#ifdef NWATCHES
+  (void)solver;
+#else
+  LOG ("flush large clause watches");
+  struct watches *all_watches = solver->watches;
+  for (all_literals (lit))
+    {
+      struct watches *lit_watches = all_watches + lit;
+#ifndef NBLOCK
+      union watch *q = lit_watches->begin;
+      const union watch *const end = lit_watches->end, *p = q;
+      while (p != end)
+	{
+	  const union watch watch = *q++ = *p++;	// Keep header by default.
+	  const struct header header = watch.header;
+	  if (header.binary)
+	    {
+#if defined(NVIRTUAL) && defined(NPACKED)
+	      *q++ = *p++;	// Copy clause too.
+#endif
+	    }
+	  else
+	    {
+	      q--;		// don't keep clause
+#ifdef NPACKED
+	      p++;
+#endif
+	    }
+	}
+      lit_watches->end = q;
+#else
+      lit_watches->end = lit_watches->begin;
+#endif
+    }
+#endif
+#ifndef NDEBUG
+  solver->watching = false;
+#endif
 }
 
-// Eliminate clause and push it on extension stack with 'eliminated' first.
-
-static void
-eliminate_watched_clause (struct satch *solver,
-			  unsigned eliminated, struct clause *c)
+void
+watch_large_clauses (struct satch *solver)
 {
-#ifndef NVIRTUAL
-  if (is_tagged_clause (c))
+  LOG ("rewatch large clause watches");
+  for (all_irredundant_clauses (c))
     {
-      const unsigned other = tagged_clause_to_literal (c);
-      really_delete_binary (solver, false, eliminated, other);
-      struct clause *d = tag_binary_clause (false, eliminated);
-      disconnect_literal (solver, other, d);
-      INC (elimination_ticks);
-      c = untag_clause (solver, 0, eliminated, c);
+      if (c->garbage)
+	continue;
+#ifndef NCACHE
+      c->search = 0;
+#endif
+#ifndef NWATCHES
+      watch_clause (solver, c);
+#endif
     }
-  else
+  for (all_redundant_clauses (c))
+    {
+      if (c->garbage)
+	continue;
+#ifndef NCACHE
+      c->search = 0;
 #endif
-  if (c->garbage)
-    return;
-#ifndef NVIRTUAL
-  else
+#ifndef NWATCHES
+      watch_clause (solver, c);
 #endif
-    mark_garbage (solver, c, "eliminated");
-
-#ifdef NVIRTUAL
-  (void) eliminated;
+    }
+#ifndef NDEBUG
+  solver->watching = true;
 #endif
 }
 
-// Eliminate clauses with literal 'eliminated' by flushing their occurrence
-// lists, marking them as garbage, and pushing them on the extension stack.
-
-static void
-eliminate_watched_clauses (struct satch *solver,
-			   unsigned eliminated, struct watches *watches)
-{
-  for (all_elements_on_stack (union watch, watch, *watches))
-      eliminate_watched_clause (solver, eliminated, watch.clause);
-  RELEASE_STACK (*watches);
-}
-
-// Now eliminate the variable by adding all the saved resolvents from the
-// resolvents stack and then eliminate the clauses in which it occurs.
-
-// Since we might have generated units in the mean time we have to check for
-// satisfied and falsified clauses again (the second time).
-
 static void
-eliminate_variable (struct satch *solver, unsigned pivot_idx)
+promote_clause (struct satch *solver, struct clause *c, unsigned glue)
 {
-  assert (!solver->inconsistent);
-  assert (EMPTY_STACK (solver->clause));
-
-  const unsigned pivot = LITERAL (pivot_idx);
-  const unsigned not_pivot = NOT (pivot);
-
-  LOG ("eliminating %s", LOGVAR (pivot_idx));
-
-  // First mark the variable as eliminated and update counters.
-
-  {
-    struct flags *f = solver->flags + pivot_idx;
-    assert (f->active);
-    assert (!f->eliminated);
-    f->eliminated = true;
-    f->active = false;
-    DEC (remaining);
-    INC (eliminated);
-  }
-
-  // Now copy and add the clauses from the resolvents stack.
-
-  uint64_t ticks = 0;
-
-  {
-    const signed char *const values = solver->values;
-    bool satisfied = false;
-
-    for (all_elements_on_stack (unsigned, lit, solver->resolvents))
-      {
-	if (lit != INVALID)
-	  {
-	    signed char value = values[lit];
-	    if (value > 0)
-	      satisfied = true;
-	    else if (!satisfied && !value)
-	      PUSH (solver->clause, lit);
-	  }
-	else if (satisfied)
-	  {
-	    CLEAR_STACK (solver->clause);
-	    satisfied = false;
-	  }
-	else
-	  {
-	    LOGTMP ("previously resolved");
-	    trace_and_check_temporary_addition (solver);
-	    add_and_connect_resolvent (solver);
-	    ticks += SIZE_STACK (solver->clause);
-	    CLEAR_STACK (solver->clause);
-	    ticks++;
-	    if (solver->inconsistent)
-	      break;
-	  }
-      }
-  }
+#ifdef NGLUE
+  (void) solver;
+  (void) c;
+  (void) glue;
+  return;
+#else
+#ifndef NTIER1
+  const unsigned old_glue = c->glue;
+  assert (old_glue >= c->glue);
 
-  if (solver->inconsistent)
-    return;
+  c->glue = glue;
+  if (old_glue > tier1_glue_limit && glue <= tier1_glue_limit)
+    {
+      LOGCLS (c, "promoting to TIER1");
+    }
+#ifndef NTIER2
+  else if (old_glue > tier2_glue_limit && glue <= tier2_glue_limit)
+    {
+      LOGCLS (c, "promoting to TIER2");
+#ifndef NUSED
+      c->used = 2;
+#endif
+    }
+  else
+    {
+      LOGCLS (c, "keeping to new glue %u in tier3", glue);
+    }
+#endif
+#else
+  (void) solver;
+  c->glue = glue;
+#endif
+#endif
+}
 
-  CLEAR_STACK (solver->resolvents);
+// The function marked_literal cannot be used for vivification because it only marks variables
+// instead of literals despite the name (!).
+inline static signed char
+vivify_marked_literal (struct satch *solver, unsigned lit)
+{
+  const unsigned idx = INDEX (lit);
+  signed char res = solver->vivify_marks[idx];
+  return (res == INT_SIGN (lit));
+}
 
-  {
-    struct watches *const pos_watches = solver->watches + pivot;
-    struct watches *const neg_watches = solver->watches + not_pivot;
+void
+vivify_mark_literal (struct satch *solver, unsigned lit)
+{
 
-    const size_t pos_lines = 1 + CACHE_LINES_OF_STACK (pos_watches);
-    const size_t neg_lines = 1 + CACHE_LINES_OF_STACK (neg_watches);
+  const unsigned idx = INDEX (lit);
+  assert (!solver->vivify_marks[idx]);
+  solver->vivify_marks[idx] = INT_SIGN (lit);
+}
 
-    // Push eliminated clauses on the extension stack.
+static struct clause *
+vivify_boolean_constraint_propagation (struct satch *solver,
+				       struct clause *ignore)
+{
+  struct trail *trail = &solver->trail;
+  unsigned *propagate = trail->propagate;
+  unsigned *p;
 
-#if 1
-    // For non-incremental SAT solving we can push only one set of the two
-    // clauses to the stack and simulate the other by pushing a unit.
+  assert (trail->begin <= propagate);
+  assert (propagate <= trail->begin + VARIABLES);
 
-    if (SIZE_STACK (*pos_watches) < SIZE_STACK (*neg_watches))
-      {
-	ticks += 1 + pos_lines;
-	push_clauses_on_extension_stack (solver, pivot, pos_watches);
-	push_unit_on_extension_stack (solver, not_pivot);
-      }
-    else
-      {
-	ticks += 1 + neg_lines;
-	push_clauses_on_extension_stack (solver, not_pivot, neg_watches);
-	push_unit_on_extension_stack (solver, pivot);
-      }
-#else
-    // For incremental SAT solving we would need to save all clauses.
+  struct clause *conflict = 0;
+  uint64_t ticks = 0;
 
-    push_clauses_on_extension_stack (solver, pivot, pos_watches);
-    push_clauses_on_extension_stack (solver, not_pivot, neg_watches);
-#endif
+  if (ignore)
+    LOGCLS (ignore, "vivify: BCP ignoring");
+  for (p = propagate; !conflict && p != trail->end; p++)
+    conflict = vivify_propagate_assignment (solver, *p, ignore, &ticks);
 
-    // Finally remove all the clauses with the eliminated variables and
-    // release their watcher stacks.
+  ADD (probing_ticks, ticks);
+  solver->trail.propagate = p;
+  const unsigned propagated = p - propagate;
 
-    ticks += 2 + pos_lines + neg_lines;
+  ADD (vivify_propagations, propagated);
 
-    eliminate_watched_clauses (solver, pivot, pos_watches);
-    eliminate_watched_clauses (solver, not_pivot, neg_watches);
-  }
+  if (conflict)
+    INC (vivify_conflicts);
 
-  ADD (elimination_ticks, ticks);
+  return conflict;
 }
 
-/*------------------------------------------------------------------------*/
-
-#ifndef NELIMINATIONLIMITS
-
-// Variable elimination and particularly subsumption have to be bounded for
-// large instances.  Otherwise almost all time is spent in these procedures.
-// We bound the time spent by 'ticks' (predicted cache line accesses) as for
-// propagation during search and allow a fixed fraction (10%) in terms of
-// search ticks since the last variable elimination. We have separate limits
-// for subsumption and elimination to allow each a fair share of the time.
-// The limits are set at the start of variable elimination (for both).
+static void
+vivify_binary_or_large_conflict (struct satch *solver,
+				 struct clause *conflict)
+{
+  assert (solver->level);
+  assert (conflict->size >= 2);
+  LOGCLS (conflict, "vivify analyzing conflict (red: %d)",
+	  conflict->redundant);
+#if LOGGING || !defined(NDEBUG)
+  unsigned conflict_level = 0;
+#endif
+  for (all_literals_in_clause (lit, conflict))
+    {
+      assert (solver->values[lit] < 0);
+      const unsigned level = LEVEL (INDEX (lit));
+      if (!level)
+	continue;
+#if LOGGING || !defined(NDEBUG)
+      if (level > conflict_level)
+	conflict_level = level;
+#endif
+      mark_analyzed (solver, INDEX (lit));
+    }
+  LOG ("vivify conflict level %u", conflict_level);
+  assert (0 < conflict_level);
+  assert (conflict_level == solver->level);
+}
 
 static void
-set_elimination_ticks_limit (struct satch *solver)
+vivify_mark_garbage (struct satch *solver, struct clause *c, const char *msg)
 {
-  struct limits *const limits = &solver->limits;
-  const struct statistics *const statistics = &solver->statistics;
-  const uint64_t eliminations = statistics->eliminations;
-#ifndef NINPROCESSING
-  const uint64_t delta = statistics->ticks - limits->eliminate.search;
-  uint64_t limit = delta * elimination_ticks_fraction;
-  message (solver, 2, "elimination", eliminations,
-	   "elimination limit of %" PRIu64 " ticks = %g * search ticks %"
-	   PRIu64, limit, (double) elimination_ticks_fraction, delta);
-  limits->eliminate.ticks = statistics->elimination_ticks + limit;
+  assert (solver->watching);
+#ifndef NWATCHES
+  unwatch_literal (solver, c->literals[0], c);
+  unwatch_literal (solver, c->literals[1], c);
 #else
-  limits->eliminate.ticks = UINT64_MAX;
-  message (solver, 2, "elimination", eliminations,
-	   "no elimination ticks-limit during preprocessing "
-	   "(inprocessing disabled)");
+  for (all_literals_in_clause (lit, c))
+    disconnect_literal (solver, lit, c);
 #endif
+  mark_garbage (solver, c, msg);
 }
 
 static bool
-elimination_ticks_limit_hit (struct satch *solver)
+vivify_learn (struct satch *solver,
+	      struct clause *c,
+	      unsigned non_false, bool irredundant, unsigned implied)
 {
-  return solver->statistics.elimination_ticks >
-    solver->limits.eliminate.ticks;
-}
+  bool res;
+
+  size_t size = SIZE_STACK (solver->clause);
+  assert (size <= non_false);
+  assert (2 < non_false);
+
+  if (size == 1)
+    {
+      LOG ("size 1 learned unit clause forces jump level 0");
+      if (solver->level)
+	backtrack (solver, 0);
+
+      const unsigned unit = ACCESS (solver->clause, 0);
+      assign (solver, unit, 0, true);
+      solver->iterate = true;
+      vivify_mark_garbage (solver, c, "subsumed by unit");
+      assert (!solver->level);
+      struct clause *conflict = boolean_constraint_propagation (solver);
+      if (conflict)
+	{
+	  assert (solver->level == 0);
+	  LOGCLS (conflict, "found conflict at level 0");
+	  solver->inconsistent = true;
+	  return false;
+	}
+      INC (vivify_strengthened);
+      res = true;
+    }
+  else
+    {
+      const signed char *const values = solver->values;
+
+      unsigned highest_level = 0;
+      for (all_elements_on_stack (unsigned, lit, solver->clause))
+	{
+	  const signed char value = values[lit];
+	  if (!value)
+	    {
+	      LOG ("unassigned literal %s in learned clause", LOGLIT (lit));
+	      highest_level = INVALID_LEVEL;
+	      break;
+	    }
+	  const unsigned idx = INDEX (lit);
+	  const unsigned level = LEVEL (idx);
+	  assert (level > 0);
+	  if (level > highest_level)
+	    highest_level = level;
+	}
+
+      if (highest_level != INVALID_LEVEL)
+	LOG ("highest level %u in learned clause", highest_level);
+
+      unsigned literals_on_highest_level = 0;
+      for (all_elements_on_stack (unsigned, lit, solver->clause))
+	{
+	  const unsigned value = values[lit];
+	  if (!value)
+	    literals_on_highest_level++;
+	  else
+	    {
+	      const unsigned idx = INDEX (lit);
+	      const unsigned level = LEVEL (idx);
+	      assert (level > 0);
+	      if (level == highest_level)
+		literals_on_highest_level++;
+	    }
+	}
+#ifdef LOGGING
+      if (highest_level == INVALID_LEVEL)
+	LOG ("found %u unassigned literals", literals_on_highest_level);
+      else
+	LOG ("found %u literals on highest level", literals_on_highest_level);
+#endif
+      if (highest_level == INVALID_LEVEL && literals_on_highest_level > 1)
+	LOG ("no need to backtrack with more than one unassigned literal");
+      else
+	{
+	  unsigned jump_level = 0;
+	  for (all_elements_on_stack (unsigned, lit, solver->clause))
+	    {
+	      const signed char value = values[lit];
+	      if (!value)
+		continue;
+	      const unsigned idx = INDEX (lit);
+	      const unsigned level = LEVEL (idx);
+	      if (level == highest_level)
+		continue;
+	      if (level > jump_level)
+		jump_level = level;
+	    }
+	  LOG ("determined jump level %u", jump_level);
+
+	  if (jump_level < solver->level)
+	    backtrack (solver, jump_level);
+	}
+
+#ifndef NVIRTUAL
+      if (size == 2)
+	{
+#ifdef LOGGING
+	  const unsigned lit = ACCESS (solver->clause, 0);
+	  const unsigned other = ACCESS (solver->clause, 1);
+#endif
+	  const bool redundant = c->redundant;
+	  LOGBIN (false, lit, other, "vivification");
+	  trace_and_check_temporary_addition (solver);
+	  add_new_binary_and_watch_it (solver, redundant);
 
+	  vivify_mark_garbage (solver, c, "vivified clause");
+	  INC (vivify_strengthened);
+	  res = true;
+	}
+      else
 #endif
-
-#ifndef NSUBSUMPTIONLIMITS
-
-static void
-set_subsumption_ticks_limit (struct satch *solver)
-{
-  struct limits *const limits = &solver->limits;
-  const struct statistics *const statistics = &solver->statistics;
-  const uint64_t eliminations = statistics->eliminations;
-#ifndef NINPROCESSING
-  const uint64_t delta = statistics->ticks - limits->subsume.search;
-  uint64_t limit = delta * subsumption_ticks_fraction;
-  message (solver, 2, "elimination", eliminations,
-	   "subsumption limit of %" PRIu64 " ticks = %g * search ticks %"
-	   PRIu64, limit, (double) subsumption_ticks_fraction, delta);
-  limits->subsume.ticks = statistics->subsumption_ticks + limit;
+      if (size < non_false)
+	{
+#ifndef NVIRTUAL
+	  assert (size > 2);
 #else
-  limits->subsume.ticks = UINT64_MAX;
-  message (solver, 2, "elimination", eliminations,
-	   "no subsumption ticks-limit during preprocessing "
-	   "(inprocessing disabled)");
+	  assert (size >= 2);
 #endif
-}
-
+	  CLEAR_STACK (solver->clause);
+	  assert (EMPTY_STACK (solver->clause));
+	  const unsigned old_size = c->size;
+	  unsigned new_size = 0, *lits = c->literals;
+#ifndef NWATCHES
+	  const unsigned litA = lits[0];
+	  const unsigned litB = lits[1];
 #endif
 
-/*------------------------------------------------------------------------*/
+	  assert (EMPTY_STACK (solver->clause));
+	  for (unsigned i = 0; i < old_size; i++)
+	    {
+	      const unsigned lit = lits[i];
+	      assert (lit < LITERALS);
+	      PUSH (solver->clause, lit);
+	      bool keep = true;
+	      if (lit != implied)
+		{
+		  const unsigned idx = INDEX (lit);
+		  const signed char mark = MARK (idx);
+		  if (!(mark & ANALYZED))
+		    keep = false;
+		  else if (REASON (idx))
+		    keep = false;
+		  if (!keep)
+		    LOG
+		      ("literal %s not to be kept (has reason? %d; not analyzed? %d)",
+		       LOGLIT (lit), REASON (idx) ? 1 : 0,
+		       !(mark & ANALYZED) ? 1 : 0);
+		}
+	      if (!c->redundant)
+		{
+#if !defined(NSUBSUMPTION) && (!defined(NREDUCE) || !defined(NELIMINATION))
+		  if (keep)
+		    mark_subsume_variable (solver, INDEX (lit));
+#endif
+#ifndef NELIMINATION
+		  if (!keep)
+		    mark_eliminate_literal (solver, lit);
+#endif
+		}
+	      if (keep)
+		lits[new_size++] = lit;
+              else {
+#ifdef NWATCHES
+                    disconnect_literal (solver, lit, c);
+#endif
+              }
+	    }
+	  assert (new_size < old_size);
+	  assert (new_size == size);
+	  if (!c->shrunken)
+	    {
+	      c->shrunken = true;
+	      lits[old_size - 1] = INVALID;
+	    }
+	  c->size = new_size;
+	  trace_and_check_clause_addition (solver, c, INVALID);
+	  trace_and_check_deletion (solver, SIZE_STACK (solver->clause),
+				    solver->clause.begin);
+	  CLEAR_STACK (solver->clause);
+	  if (!c->redundant
+#ifndef NGLUE
+	      && c->glue >= new_size
+#endif
+	    )
+	    {
+	      promote_clause (solver, c, new_size - 1);
+	    }
+#ifndef NWATCHES
+	  unwatch_literal (solver, litA, c);
+	  unwatch_literal (solver, litB, c);
+#endif
 
-// The main bounded variable elimination function.
+#ifndef NVIRTUAL
+	  if (new_size == 2)
+	    {
+	      assert (EMPTY_STACK (solver->clause));
+	      PUSH (solver->clause, c->literals[0]);
+	      PUSH (solver->clause, c->literals[1]);
+	      add_new_binary_and_watch_it (solver, c->redundant);
+	      CLEAR_STACK (solver->clause);
+	      vivify_mark_garbage (solver, c,
+				   "vivify shortened to binary clause");
+	    }
+	  else
+#endif
+	    {
+#ifndef NCACHE
+	      c->search = 0;
+#endif
+	      LOGCLS (c, "vivified shrunken");
+	      INC (vivify_strengthened);
 
-static int
-eliminate_variables (struct satch *solver)
-{
-  START (eliminate);
-  const uint64_t eliminations = INC (eliminations);
+#ifndef NWATCHES
+	      // Beware of 'stale blocking literals' ... so rewatch if shrunken.
+	      watch_clause (solver, c);
+#else
+              count_clause (solver, c);
+#endif
+	    }
+	  res = true;
+	}
+      else if (irredundant && !c->redundant)
+	{
+	  INC (vivify_subsume);
+	  vivify_mark_garbage (solver, c, "vivify subsumed (learn)");
+	  res = true;
+	}
+      else
+	{
+	  LOG ("vivify failed");
+	  res = false;
+	}
+    }
 
-  // First backtrack to decision level zero.
+  return res;
+}
 
-  update_phases_and_backtrack_to_root_level (solver);
-  assert (solver->trail.propagate == solver->trail.end);
+static bool
+vivify_analyze (struct satch *solver, struct clause *c,
+		struct clause *conflict, bool *irredundant_ptr)
+{
+  assert (conflict);
+  assert (!EMPTY_STACK (solver->analyzed));
+  LOGCLS (conflict, "vivify analyze: marking");
 
-#ifndef NELIMINATIONLIMITS
-  set_elimination_ticks_limit (solver);
-#endif
-#ifndef NSUBSUMPTIONLIMITS
-  set_subsumption_ticks_limit (solver);
-#endif
+  signed char *vivify_marks = solver->vivify_marks;
+  for (all_literals_in_clause (lit, c))
+    {
+      LOG ("marking literal %s %s", LOGLIT (lit), LOGLIT (NOT (lit)));
+      vivify_mark_literal (solver, lit);
+    }
 
-  // Switch to dense mode which flushes all watches to redundant clauses and
-  // connects all occurrences of literals in irredundant clauses.
+  bool subsumed = false;
 
-  switch_to_dense_mode (solver);
+  if (c->redundant || !conflict->redundant)
+    {
+      subsumed = true;
+      for (all_literals_in_clause (lit, conflict))
+	{
+	  const signed char value = satch_fixed (solver, lit);
+	  if (value < 0)
+	    continue;
+	  assert (!value);
+	  if (vivify_marked_literal (solver, lit) > 0)
+	    continue;
+	  subsumed = false;
+	  break;
+	}
+      if (subsumed)
+	LOGCLS (conflict, "vivify subsuming");
+    }
 
-  // Main elimination loop.
+  size_t analyzed = 0;
+  bool irredundant = conflict && !conflict->redundant;
 
-  unsigned eliminated, total = 0, round = 0;
-  const unsigned original = solver->statistics.remaining;
+  const signed char *const values = solver->values;
 
-  do
+  while (analyzed < SIZE_STACK (solver->analyzed))
     {
-#ifndef NSUBSUMPTION
-      full_backward_subsumption (solver);
-      if (!more_elimination_candidates (solver))
-	break;
+      const unsigned idx = ACCESS (solver->analyzed, analyzed).idx;
+      const unsigned lit = values[LITERAL (idx)] > 0 ?
+	LITERAL (idx) : NOT (LITERAL (idx));
+      assert (values[lit]);
+      const unsigned not_lit = NOT (lit);
+      struct clause *const reason = REASON (INDEX (lit));
+      analyzed++;
+      assert (LEVEL (idx));
+      assert (MARK (idx) & ANALYZED);
+      if (!REASON (idx))
+	{
+	  LOG ("vivify analyzing decision %s", LOGLIT (not_lit));
+	  PUSH (solver->clause, not_lit);
+	}
+#ifndef NBLOCK
+      else if (is_tagged_clause (reason))
+	{
+	  const unsigned other = tagged_clause_to_literal (reason);
+	  const bool redundant = tagged_clause_to_redundant (reason);
+	  if (redundant)
+	    irredundant = false;
+	  assert (values[other] < 0);
+	  assert (LEVEL (INDEX (other)));
+	  if (c->redundant || !redundant)
+	    {
+	      if (vivify_marked_literal (solver, lit) < 0 &&
+		  vivify_marked_literal (solver, other) < 0)
+		{
+		  LOG ("vivify subsuming by binary clause %s %s",
+		       LOGLIT (lit), LOGLIT (other));
+		  subsumed = true;
+		}
+	    }
+	  if (MARK (INDEX (other)) & ANALYZED)
+	    continue;
+	  LOG ("vivify analyzing %s reason %s %s",
+	       LOGLIT (lit), LOGLIT (lit), LOGLIT (other));
+	  mark_analyzed (solver, INDEX (other));
+	}
 #endif
-      const unsigned remaining = solver->statistics.remaining;
-      eliminated = 0;
-      round++;
-
-      for (all_variables (idx))
+      else
 	{
-	  if (can_be_eliminated (solver, idx) &&	// Check limits.
-	      produces_few_resolvents (solver, idx))	// Save resolvents.
+	  LOGCLS (reason, "vivify analyzing %s reason", LOGLIT (lit));
+	  if (reason->redundant)
+	    irredundant = false;
+	  bool subsuming = vivify_marked_literal (solver, lit);
+	  for (all_literals_in_clause (other, reason))
 	    {
-	      eliminate_variable (solver, idx);	// Add resolvents.
-	      eliminated++;
+	      if (other == lit)
+		continue;
+	      if (other == not_lit)
+		continue;
+	      assert (values[other] < 0);
+	      if (!LEVEL (INDEX (other)))
+		continue;
+	      if (!vivify_marked_literal (solver, other))
+		subsuming = false;
+	      if (MARK (INDEX (other)) & ANALYZED)
+		continue;
+	      mark_analyzed (solver, INDEX (other));
 	    }
-	  else
-	    solver->flags[idx].eliminate = false;
-
-	  if (solver->inconsistent)
-	    break;
-
-#ifndef NELIMINATIONLIMITS
-	  if (elimination_ticks_limit_hit (solver))
+	  if (subsuming && (c->redundant || !reason->redundant))
 	    {
-	      message (solver, 4, "elimination", eliminations,
-		       "elimination ticks limit hit");
-	      break;
+	      subsumed = true;
+	      LOGCLS (reason, "vivify subsuming");
 	    }
-#endif
 	}
+    }
 
-      total += eliminated;
-      message (solver, 3, "elimination", eliminations,
-	       "eliminated %u variables %.0f%% of remaining %u in round %u",
-	       eliminated, percent (eliminated, remaining), remaining, round);
+  for (all_literals_in_clause (lit, c))
+    {
+      LOG ("unmarking literal %s %s", LOGLIT (lit), LOGLIT (NOT (lit)));
+      unmark_literal (vivify_marks, lit);
+    }
 
-      report (solver, 1 + !eliminated, 'e');
-#ifndef NELIMINATIONLIMITS
-      if (round >= elimination_rounds)
-	break;
-      if (elimination_ticks_limit_hit (solver))
-	break;
+  const size_t size = SIZE_STACK (solver->clause);
+  assert (size > 0);
+  if (subsumed)
+    {
+      if (size == 1)
+	{
+	  LOG ("ignoring subsumed and instead learning unit clause");
+#ifndef NDEBUG
+	  assert (solver->level);
+	  const unsigned decision =
+	    *ACCESS (solver->control, solver->level - 1).trail;
+	  const unsigned unit = ACCESS (solver->clause, 0);
+	  assert (NOT (unit) == decision);
 #endif
+	  subsumed = false;
+	}
+      else
+	LOGTMP ("vivify ignored learned");
     }
-  while (!solver->inconsistent && eliminated);
-
-  unsigned kept = 0;
-  const struct flags *const flags = solver->flags;
-  for (all_variables (idx))
+  if (!subsumed)
     {
-      const struct flags *const f = flags + idx;
-      if (!f->active)
-	continue;
-      if (f->eliminate)
-	kept++;
+      *irredundant_ptr = irredundant;
+      LOGTMP ("vivify learned");
     }
 
-  message (solver, 3, "elimination", eliminations,
-	   "keeping %u variables scheduled %.0f%%",
-	   kept, percent (kept, solver->statistics.remaining));
-
-  message (solver, 2, "elimination", eliminations,
-	   "eliminated %u variables %.0f%% in total in %u rounds",
-	   total, percent (total, original), round);
+  return subsumed;
+}
 
-  // Collect clauses which are marked garbage, i.e., are root-level
-  // satisfied or contain an eliminated variable.
+static void
+vivify_reset_analyzed (struct satch *solver)
+{
+  for (all_elements_on_stack (struct analyzed, analyzed, solver->analyzed))
+    {
+      const unsigned idx = analyzed.idx;
+      MARK (idx) &= ~ANALYZED;
+    }
+  CLEAR_STACK (solver->analyzed);
+  CLEAR_STACK (solver->clause);
+}
 
-  mark_and_collect_garbage_clauses_after_elimination (solver);
+#ifndef NVIVIFYIMPLY
+static struct clause *
+vivify_unit_conflict (struct satch *solver, unsigned lit)
+{
+  assert (solver->values[lit] > 0);
+  const unsigned idx = INDEX (lit);
+  LOG ("vivify analyzing conflict unit %s", LOGLIT (NOT (lit)));
+  assert (!(MARK (idx) & ANALYZED));
+  struct clause *conflict;
+  struct clause *const reason = REASON (idx);
 
-  // Switch back to sparse mode watching all clauses.
+#ifndef NBLOCK
+  if (is_tagged_clause (reason))
+    {
+      conflict = untag_clause (solver, 0, lit, reason);
+    }
+  else
+#endif
+    conflict = reason;
+  mark_analyzed (solver, idx);
+  PUSH (solver->clause, lit);
+  return conflict;
+}
+#endif
 
-  switch_to_sparse_mode (solver);
 
-  // Need to propagate over redundant clauses too.
+static bool
+vivify_clause (struct satch *solver, struct clause *c, unsigned *counts)
+{
+  assert (!c->garbage);
+  assert (!solver->inconsistent);
+  struct unsigned_stack *sorted = &solver->sorted;
 
-  solver->trail.propagate = solver->trail.begin;
+  LOGCLS (c, "trying to vivify candidate");
+  CLEAR_STACK (*sorted);
 
-#ifndef NINPROCESSING
+  for (all_literals_in_clause (lit, c))
+    {
+      const signed char value = satch_fixed (solver, lit);
+      if (value < 0)
+	continue;
+      if (value > 0)
+	{
+	  vivify_mark_garbage (solver, c, "root-level satisfied");
+	  break;
+	}
+      PUSH (*sorted, lit);
+    }
 
-  // Finally update limits.
 
-  {
-    const struct statistics *const statistics = &solver->statistics;
-    struct limits *const limits = &solver->limits;
+  if (c->garbage)
+    return false;
+  const unsigned non_false = SIZE_STACK (*sorted);
 
-    if (!kept)
-      {
-	limits->eliminate.fixed = statistics->fixed;
-	limits->eliminate.marked = statistics->marked_eliminate;
-      }
+  assert (1 < non_false);
+  assert (non_false <= c->size);
 
-#ifndef NELIMINATIONLIMITS
-    limits->eliminate.search = statistics->ticks;
-#endif
-#ifndef NSUBSUMPTIONLIMITS
-    limits->subsume.search = statistics->ticks;
+#ifndef NLOGGING
+  if (!non_false)
+    LOG ("no root level falsified literal");
+  else if (non_false == c->size)
+    LOG ("all literals root level unassigned");
+  else
+    LOG ("found %u root level non-falsified literals", non_false);
 #endif
+  if (non_false == 2)
+    {
+      LOGCLS (c, "skipping actually binary");
+      return false;
+    }
 
-    const uint64_t interval =
-      scale_interval (elimination_interval, nlognlogn, eliminations);
-    limits->eliminate.conflicts = CONFLICTS + interval;
+  unsigned unit = INVALID;
 
-    message (solver, 4, "elimination", eliminations,
-	     "next limit at %" PRIu64 " after %" PRIu64 " conflicts",
-	     limits->eliminate.conflicts, interval);
-  }
-#endif
+  for (all_literals_in_clause (lit, c))
+    {
+      const signed char value = solver->values[lit];
+      if (value < 0)
+	continue;
+      if (!value)
+	{
+	  unit = INVALID;
+	  break;
+	}
+      assert (value > 0);
+      if (unit != INVALID)
+	{
+	  unit = INVALID;
+	  break;
+	}
+      unit = lit;
+    }
+  if (unit == INVALID)
+    LOG ("non-reason candidate clause");
+  else
+    {
+      LOG ("candidate is the reason of %s", LOGLIT (unit));
+      const unsigned level = LEVEL (INDEX (unit));
+      assert (level > 0);
+      LOG ("forced to backtrack to level %u", level - 1);
+      backtrack (solver, level - 1);
+    }
 
-  STOP (eliminate);
+  vivify_sort_stack_by_counts (solver, counts, sorted);
 
-  return solver->inconsistent ? 20 : 0;
-}
+  unsigned implied = INVALID;
+  unsigned falsified = 0;
+  unsigned satisfied = 0;
+  struct clause *conflict = 0;
+  unsigned level = 0;
+  bool res = false;
+  assert (non_false == SIZE_STACK (*sorted));
+  for (all_elements_on_stack (unsigned, lit, *sorted))
+    {
+      if (level++ < solver->level)
+	{
+	  struct level frame = ACCESS (solver->control, level - 1);
+	  const unsigned not_lit = NOT (lit);
+	  if (*frame.trail == not_lit)
+	    {
+	      LOG ("reusing assumption %s", LOGLIT (not_lit));
+	      INC (vivify_reused);
+	      INC (vivify_probes);
+	      assert (solver->values[lit] < 0);
+	      continue;
+	    }
 
-static void
-extend_solution (struct satch *solver)
-{
-  const unsigned *const begin = solver->extend.begin;
-  signed char *const values = solver->values;
+	  LOG ("forced to backtrack to decision level %u", level - 1);
+	  backtrack (solver, level - 1);
+	}
+      const signed char value = solver->values[lit];
+      assert (!value || LEVEL (INDEX (lit)) <= level);
+      if (!value)
+	{
+	  LOG ("literal %s unassigned", LOGLIT (lit));
+	  const unsigned not_lit = NOT (lit);
+	  INC (vivify_probes);
+	  solver->level++;
+	  assign (solver, not_lit, 0, false);
+	  assert (solver->level >= 1);
+	  conflict = vivify_boolean_constraint_propagation (solver, c);
+	  if (!conflict)
+	    continue;
+	  vivify_binary_or_large_conflict (solver, conflict);
+	  assert (!EMPTY_STACK (solver->analyzed));
+	  break;
+	}
+
+      if (value < 0)
+	{
+	  assert (LEVEL (INDEX (lit)));
+	  LOG ("literal %s already falsified", LOGLIT (lit));
+	  falsified++;
+	  continue;
+	}
 
-  const unsigned *p = solver->extend.end;
+      satisfied++;
+      assert (value > 0);
+      assert (LEVEL (INDEX (lit)));
+      LOG ("literal %s already satisfied", LOGLIT (lit));
 
-  unsigned last = INVALID;
-  bool satisfied = false;
-  signed char value = -1;
+#ifndef NVIVIFYIMPLY
+      if (!c->redundant)
+	{
+	  implied = lit;
+	  conflict = vivify_unit_conflict (solver, lit);
+	  assert (!EMPTY_STACK (solver->analyzed));
+	  assert (conflict);
+	}
+      else
+	{
+	  vivify_mark_garbage (solver, c, "vivify implied");
+	  INC (vivify_implied);
+	  res = true;
+	}
+#endif
+      break;
+    }
 
-  while (p != begin)
+  if (c->garbage)
     {
-      const unsigned lit = *--p;
-      if (lit != INVALID)
+      assert (!conflict);
+      assert (EMPTY_STACK (solver->analyzed));
+    }
+  else if (conflict)
+    {
+      assert (!EMPTY_STACK (solver->analyzed));
+      assert (solver->level);
+      bool irredundant;
+      const bool subsumed =
+	vivify_analyze (solver, c, conflict, &irredundant);
+
+      backtrack (solver, solver->level - 1);
+
+      if (subsumed)
 	{
-	  value = values[lit];
-	  assert (value);
-	  if (value > 0)
-	    satisfied = true;
+	  vivify_mark_garbage (solver, c, "vivify subsumed");
+	  LOGCLS (c, "subsuming clause: ");
+	  INC (vivify_subsume);
+	  INC (subsumed);
+	  res = true;
 	}
-      else if (!satisfied)
+      else
+	res = vivify_learn (solver, c, non_false, irredundant, implied);
+      vivify_reset_analyzed (solver);
+    }
+  else if (falsified && !satisfied)
+    {
+      LOG ("vivified %u false literals", falsified);
+      assert (EMPTY_STACK (solver->clause));
+      assert (non_false == SIZE_STACK (*sorted));
+      for (all_elements_on_stack (unsigned, lit, *sorted))
 	{
-	  assert (last != INVALID);
-	  values[last] = 1;
-	  values[NOT (last)] = -1;
-	  LOG ("flipped value of %s", LOGLIT (last));
+	  const unsigned idx = INDEX (lit);
+	  assert (LEVEL (idx));
+	  if (REASON (idx))
+	    continue;
+	  assert (!(MARK (idx) & ANALYZED));
+	  mark_analyzed (solver, idx);
+	  PUSH (solver->clause, lit);
 	}
-      else
-	satisfied = false;
-      last = lit;
+      res = vivify_learn (solver, c, non_false, false, INVALID);
+      vivify_reset_analyzed (solver);
+    }
+  else
+    {
+      assert (EMPTY_STACK (solver->analyzed));
+      LOG ("vivify failed");
     }
-}
-
-/*------------------------------------------------------------------------*/
-#endif // of '#ifndef NELIMINATION'
-/*------------------------------------------------------------------------*/
 
-#ifndef NVIVIFICATION
+  if (!res)
+    return false;
 
-static signed char
-satch_fixed (struct satch *solver, unsigned lit)
-{
+  INC (vivified);
 
-  assert (lit < LITERALS);
-  const signed char value = solver->values[lit];
-  if (!value)
-    return 0;
-  if (solver->levels[INDEX (lit)])
-    return 0;
-  return value;
+  assert (EMPTY_STACK (solver->analyzed));
+  assert (EMPTY_STACK (solver->clause));
+  return true;
 }
 
-static inline int
-int_compare (long int a, long int b)
+static bool
+simplify_vivification_candidate (struct satch *solver, struct clause *const c)
 {
-  if (a < b)
-    return -1;
-  if (a == b)
-    return 0;
-  return 1;
-}
-
-#ifdef NRADIXSORT
-
-static inline int
-more_occurrences (const void *cp, const void *dp, void *countsp)
-  {
-      unsigned *counts = (unsigned *) countsp;
-      const unsigned litA = *((unsigned*) cp);
-      const unsigned litB = *((unsigned*) dp);
-      return int_compare (counts[litA], counts[litB]);
-  }
+  assert (!solver->level);
+  assert (!c->garbage);
+  bool satisfied = false;
+  assert (EMPTY_STACK (solver->clause));
+  const signed char *const values = solver->values;
+  LOGCLS (c, "simplifying for vivification");
+  for (all_literals_in_clause (lit, c))
+    {
+      const signed char value = values[lit];
+      if (value > 0)
+	{
+	  satisfied = true;
+	  mark_garbage (solver, c, "vivification satisfied candidate");
+	  break;
+	}
+      if (!value)
+	PUSH (solver->clause, lit);
+    }
+  unsigned non_false = SIZE_STACK (solver->clause);
+  if (satisfied)
+    {
+      CLEAR_STACK (solver->clause);
+      return true;
+    }
+  if (non_false == c->size)
+    {
+      CLEAR_STACK (solver->clause);
+      return false;
+    }
+  assert (1 < non_false);
+  assert (non_false <= c->size);
 
+#ifdef NWATCHES
+      for (all_literals_in_clause (lit, c)) {
+        disconnect_literal (solver, lit, c);
+      }
 #endif
 
-static void
-vivify_sort_lits_by_counts (struct satch *solver, unsigned *counts,
-			    struct unsigned_stack *c)
-{
-
-#ifndef NRADIXSORT
-  (void) solver;
-#define MORE_OCCURRENCES(LIT) \
-  ~counts[LIT]
-
-  RSORT (unsigned, unsigned, *c, MORE_OCCURRENCES);
-#else
-
-#define MORE_OCCURRENCES(LITA,LITB) \
-  ((~counts[LITA]) < (~counts[LITB]))
-  SORT_STACK (unsigned, *c, MORE_OCCURRENCES);
+#ifndef NVIRTUAL
+  if (non_false == 2)
+    {
+#ifdef LOGGING
+      const unsigned first = ACCESS (solver->clause, 0);
+      const unsigned second = ACCESS (solver->clause, 1);
 #endif
-}
-
-static void
-vivify_sort_stack_by_counts (struct satch *solver, unsigned *counts,
-			     struct unsigned_stack *c)
-{
-  vivify_sort_lits_by_counts (solver, counts, c);
-}
-
-static void
-vivify_sort_clause_by_counts (struct satch *solver, unsigned *counts,
-			      struct clause *c)
-{
-#ifndef NBLOCK
-  assert (!is_tagged_clause (c));
+      trace_and_check_temporary_addition (solver);
+      LOGBIN (c->redundant, first, second, "vivification shrunken candidate");
+      add_new_binary_and_watch_it (solver, c->redundant);
+      mark_garbage (solver, c, "vivification shrunken candidate");
+    }
+  else
 #endif
+    {
+      const unsigned old_size = c->size;
+      unsigned new_size = 0, *lits = c->literals;
+      CLEAR_STACK (solver->clause);
+      for (unsigned i = 0; i < old_size; i++)
+	{
+	  const unsigned lit = lits[i];
+	  PUSH (solver->clause, lit);
+	  const signed char value = solver->values[lit];
+	  if (value != 0 && LEVEL (INDEX (lit)) == 0)
+	    continue;
+	  assert (value <= 0);
+	  if (value < 0)
+	    continue;
+	  lits[new_size++] = lit;
+	}
 #ifndef NVIRTUAL
-  assert (!is_temporary_binary (solver, c));
+      assert (2 < new_size);
 #endif
-  struct unsigned_stack c2 = {.begin = c->literals,
-    .end = c->literals + c->size,
-    .allocated = c->literals + c->size
-  };
-  vivify_sort_lits_by_counts (solver, counts, &c2);
-}
-
-
-static inline bool
-worse_candidate (unsigned* counts, const struct clause *const c, const struct clause *const d)
-{
-  assert (c);
-  assert (d);
-  assert (counts);
-#ifndef NBLOCK
-  assert (!is_tagged_clause (c));
-  assert (!is_tagged_clause (d));
+      assert (new_size == non_false);
+      assert (new_size < old_size);
+      c->size = new_size;
+#ifndef NCACHE
+      c->search = 0;
+#endif
+      if (c->redundant
+#ifndef NGLUE
+	  && c->glue >= new_size
+#endif
+	)
+	promote_clause (solver, c, new_size - 1);
+      if (!c->shrunken)
+	{
+	  c->shrunken = true;
+	  lits[old_size - 1] = INVALID;
+	}
+      LOGCLS (c, "vivification shrunken candidate");
+      trace_and_check_clause_addition (solver, c, INVALID);
+      trace_and_check_deletion (solver, SIZE_STACK (solver->clause),
+				solver->clause.begin);
+#ifdef NWATCHES
+      connect_clause (solver, c);
+      count_clause (solver, c);
 #endif
-  if (!c->vivify && d->vivify)
-    return true;
-
-  if (c->vivify && !d->vivify)
-    return false;
-
-  unsigned const *p = c->literals;
-  unsigned const *q = d->literals;
-  const unsigned *const e = c->literals + c->size;
-  const unsigned *const f = d->literals + d->size;
 
-  while (p != e && q != f)
-    {
-      const unsigned a = *p++;
-      const unsigned b = *q++;
-      if (a == b)
-	continue;
-      const unsigned u = counts[a];
-      const unsigned v = counts[b];
-      if (u < v)
-        return true;
-      if (u > v)
-        return false;
-      return a < b;
     }
-
-  if (p != e && q == f)
-    return true;
-  if (p == e && q != f)
-    return false;
-
-  return (long int)c < (long int)d;
+  CLEAR_STACK (solver->clause);
+  return false;
 }
 
-
 static void
-sort_vivification_candidates (struct satch *solver,
-			      struct clauses *schedule, unsigned *counts)
+schedule_vivification_candidates (struct satch *solver, unsigned *counts
+#ifdef LOGGING
+				  , const char *type
+#endif
+				  , bool redundant
+#ifndef NTIER2
+				  , bool tier2
+#endif
+  )
 {
-  for (all_pointers_on_stack (struct clause, c, *schedule))
+  unsigned lower_glue_limit, upper_glue_limit;
+#ifndef NTIER2
+  if (tier2)
     {
-      vivify_sort_clause_by_counts (solver, counts, c);
+      lower_glue_limit = tier1_glue_limit + 1;
+      upper_glue_limit = tier2_glue_limit;
+    }
+  else
+#endif
+#ifndef NTIER1
+    {
+      lower_glue_limit = 0;
+      upper_glue_limit = tier1_glue_limit;
+    }
+#endif
+#if (defined(NTIER1) && defined(NTIER2)) || defined(NGLUE)
+    {
+      lower_glue_limit = 0;
+      upper_glue_limit = 10;
     }
-#define WORSE_CANDIDATE(c, d) \
-  worse_candidate (counts, c, d)
-
-  SORT_STACK (struct clause*, *schedule, WORSE_CANDIDATE);
-}
-
-static void
-count_literal (unsigned lit, unsigned *counts)
-{
-  const unsigned old_count = counts[lit];
-  const unsigned new_count =
-    (old_count < UINT_MAX) ? old_count + 1 : UINT_MAX;
-  counts[lit] = new_count;
-}
-
-static void
-vivify_count_clause (struct clause *c, unsigned *counts)
-{
-  for (all_literals_in_clause (lit, c))
-    count_literal (lit, counts);
-}
 
-void
-flush_large_watches (struct satch *solver)
-{
-#ifdef NWATCHES
-  (void)solver;
-#else
-  LOG ("flush large clause watches");
-  struct watches *all_watches = solver->watches;
-  for (all_literals (lit))
+#endif
+  size_t prioritized = 0;
+  for (unsigned prioritize = 0; prioritize < 2; prioritize++)
     {
-      struct watches *lit_watches = all_watches + lit;
-#ifndef NBLOCK
-      union watch *q = lit_watches->begin;
-      const union watch *const end = lit_watches->end, *p = q;
-      while (p != end)
+      if (!redundant)
 	{
-	  const union watch watch = *q++ = *p++;	// Keep header by default.
-	  const struct header header = watch.header;
-	  if (header.binary)
+	  for (all_irredundant_clauses (c))
 	    {
+	      if (c->garbage)
+		continue;
+	      if (c->redundant)
+		continue;
 #ifdef NVIRTUAL
-	      *q++ = *p++;	// Copy clause too.
+	      if (c->size == 2)
+		continue;
 #endif
-	    }
-	  else
-	    {
-	      q--;		// don't keep clause
-	      p++;
+	      if (c->vivify != prioritize)
+		{
+		  continue;
+		}
+	      if (simplify_vivification_candidate (solver, c))
+		continue;
+	      if (prioritize)
+		prioritized++;
+	      vivify_count_clause (c, counts);
+	      PUSH (solver->vivification_schedule, c);
 	    }
 	}
-      lit_watches->end = q;
+      else
+	{
+	  for (all_redundant_clauses (c))
+	    {
+	      if (c->garbage)
+		continue;
+	      if (!c->redundant)
+		continue;
+#ifdef NVIRTUAL
+	      if (c->size == 2)
+		continue;
+#endif
+
+#if !(defined(NTIER1) && defined(NTIER2)) && !defined(NGLUE)
+	      if (c->glue < lower_glue_limit)
+		continue;
+	      if (c->glue > upper_glue_limit)
+		continue;
 #else
-      lit_watches->end = lit_watches->begin;
+	      if (c->size < lower_glue_limit)
+		continue;
+	      if (c->size > upper_glue_limit)
+		continue;
 #endif
+	      if (c->vivify != prioritize)
+		{
+		  continue;
+		}
+	      if (simplify_vivification_candidate (solver, c))
+		continue;
+	      if (prioritize)
+		prioritized++;
+	      vivify_count_clause (c, counts);
+	      PUSH (solver->vivification_schedule, c);
+	    }
+	}
     }
+
+#ifdef LOGGING
+  size_t scheduled = SIZE_STACK (solver->vivification_schedule);
 #endif
-#ifndef NDEBUG
-  solver->watching = false;
+  if (prioritized)
+    {
+      LOG ("prioritized %zu %s clauses %.0f%%", prioritized,
+	   type, percent (prioritized, scheduled));
+    }
+  else
+    {
+      LOG ("prioritized all %zu clauses %s", scheduled, type);
+      for (all_pointers_on_stack
+	   (struct clause, c, solver->vivification_schedule))
+	{
+#ifndef NVIRTUAL
+	  assert (!is_tagged_clause (c));
 #endif
+	  c->vivify = true;
+	}
+    }
 }
 
-void
-watch_large_clauses (struct satch *solver)
+enum round
 {
-  LOG ("rewatch large clause watches");
-  for (all_irredundant_clauses (c))
-    {
-      if (c->garbage)
-	continue;
-#ifndef NCACHE
-      c->search = 0;
+#if (defined(NTIER1) && defined(NTIER1)) || defined(NGLUE)
+  REDUNDANT_ROUND = 0,
 #endif
-#ifndef NWATCHES
-      watch_clause (solver, c);
+#ifndef NTIER1
+  REDUNDANT_TIER1_ROUND = 1,
 #endif
+#ifndef NTIER2
+  REDUNDANT_TIER2_ROUND = 2,
+#endif
+  IRREDUNDANT_ROUND = 3
+};
+
+static size_t
+vivify_round (struct satch *solver, unsigned round, uint64_t delta,
+	      double effort)
+{
+  assert (EMPTY_STACK (solver->vivification_schedule));
+  char tag;
+#ifdef LOGGING
+  const char *type;
+#if (defined (NTIER1) && defined (NTIER2)) || defined(NGLUE)
+  if (round == REDUNDANT_ROUND)
+    {
+      type = "redundant";
+      tag = 'u';
     }
-  for (all_redundant_clauses (c))
+  else
+#endif
+#ifndef NTIER2
+  if (round == REDUNDANT_TIER2_ROUND)
     {
-      if (c->garbage)
-	continue;
-#ifndef NCACHE
-      c->search = 0;
+      type = "redundant";
+      tag = 'u';
+    }
+  else
 #endif
-#ifndef NWATCHES
-      watch_clause (solver, c);
+#ifndef NTIER1
+  if (round == REDUNDANT_TIER1_ROUND)
+    {
+      type = "redundant";
+      tag = 'v';
+    }
+  else
+#endif
+    {
+      assert (round == IRREDUNDANT_ROUND);
+      type = "irredundant";
+      tag = 'w';
+    }
+#else
+#if (defined (NTIER1) && defined (NTIER2)) || defined(NGLUE)
+  if (round == REDUNDANT_ROUND)
+    {
+      tag = 'u';
+    }
+  else
 #endif
+#ifndef NTIER2
+  if (round == REDUNDANT_TIER2_ROUND)
+    {
+      tag = 'u';
     }
-#ifndef NDEBUG
-  solver->watching = true;
+  else
 #endif
-}
-
-static void
-promote_clause (struct satch *solver, struct clause *c, unsigned glue)
-{
-#ifdef NGLUE
-  (void) solver;
-  (void) c;
-  (void) glue;
-  return;
-#else
 #ifndef NTIER1
-  const unsigned old_glue = c->glue;
-  assert (old_glue >= c->glue);
-
-  c->glue = glue;
-  if (old_glue > tier1_glue_limit && glue <= tier1_glue_limit)
+  if (round == REDUNDANT_TIER1_ROUND)
     {
-      LOGCLS (c, "promoting to TIER1");
+      tag = 'v';
     }
-#ifndef NTIER2
-  else if (old_glue > tier2_glue_limit && glue <= tier2_glue_limit)
+  else
+#endif
     {
-      LOGCLS (c, "promoting to TIER2");
-#ifndef NUSED
-      c->used = 2;
+      assert (round == IRREDUNDANT_ROUND);
+      tag = 'w';
+    }
+#endif
+
+  flush_large_watches (solver);
+#ifndef NVIVIFICATIONLIMITS
+  const uint64_t scaled = effort * delta;
+  uint64_t start = solver->statistics.probing_ticks;
+  const uint64_t ticks_limit = start + scaled;
+#else
+  (void) effort;
+  (void) delta;
+  const uint64_t ticks_limit = UINT64_MAX;
 #endif
+  bool redundant, tier2;
+#if defined(NGLUE)
+  if (round == REDUNDANT_ROUND)
+    {
+      redundant = true;
     }
   else
+#endif
+#if (defined (NTIER1) && defined (NTIER2)) || defined(NGLUE)
+  if (round == REDUNDANT_ROUND)
     {
-      LOGCLS (c, "keeping to new glue %u in tier3", glue);
+       redundant = true;
     }
+  else
 #endif
-#else
-  (void) solver;
-  c->glue = glue;
+#ifndef NTIER1
+  if (round == REDUNDANT_TIER1_ROUND)
+    redundant = true, tier2 = false;
+  else
 #endif
+#ifndef NTIER2
+  if (round == REDUNDANT_TIER2_ROUND)
+    redundant = tier2 = true;
+  else
 #endif
-}
+    {
+      assert (round == IRREDUNDANT_ROUND);
+      redundant = tier2 = false;
+    }
 
-// The function marked_literal cannot be used for vivification because it only marks variables
-// instead of literals despite the name (!).
-inline static signed char
-vivify_marked_literal (struct satch *solver, unsigned lit)
-{
-  const unsigned idx = INDEX (lit);
-  signed char res = solver->vivify_marks[idx];
-  return (res == INT_SIGN (lit));
-}
+  unsigned *counts = calloc (LITERALS, sizeof (unsigned));
 
-void
-vivify_mark_literal (struct satch *solver, unsigned lit)
-{
+  if (!counts)
+    fatal_error ("could not allocate counts for vivification");
+  struct clauses *schedule = &solver->vivification_schedule;
 
-  const unsigned idx = INDEX (lit);
-  assert (!solver->vivify_marks[idx]);
-  solver->vivify_marks[idx] = INT_SIGN (lit);
-}
 
-static struct clause *
-vivify_boolean_constraint_propagation (struct satch *solver,
-				       struct clause *ignore)
-{
-  struct trail *trail = &solver->trail;
-  unsigned *propagate = trail->propagate;
-  unsigned *p;
+  schedule_vivification_candidates (solver, counts,
+#ifdef LOGGING
+				    type,
+#endif
+				    redundant
+#ifndef NTIER2
+				    , tier2
+#endif
+    );
+  const size_t scheduled = SIZE_STACK (*schedule);
+#ifdef LOGGING
+  const size_t total =
+    (round ==
+     IRREDUNDANT_ROUND) ? solver->statistics.irredundant : solver->statistics.
+    redundant;
+#endif
 
-  assert (trail->begin <= propagate);
-  assert (propagate <= trail->begin + VARIABLES);
+  LOG ("scheduled %zu %s clauses %.0f%% of %zu", scheduled, type,
+       percent (scheduled, total), total);
+  size_t vivified = 0, tried = 0;
 
-  struct clause *conflict = 0;
-  uint64_t ticks = 0;
+  sort_vivification_candidates (solver, schedule, counts);
+  watch_large_clauses (solver);
 
-  if (ignore)
-    LOGCLS (ignore, "vivify: BCP ignoring");
-  for (p = propagate; !conflict && p != trail->end; p++)
-    conflict = propagate_literal (solver, *p, ignore, &ticks);
+  while (!EMPTY_STACK (*schedule))
+    {
+      if (solver->statistics.probing_ticks > ticks_limit)
+	break;
+      if (terminating (solver))
+	break;
+      struct clause *c = POP (*schedule);
+      if (c->garbage)
+	continue;
+      tried++;
+      if (vivify_clause (solver, c, counts))
+	++vivified;
+      c->vivify = false;
+      if (solver->inconsistent)
+	break;
+    }
 
-  ADD (probing_ticks, ticks);
-  solver->trail.propagate = p;
-  const unsigned propagated = p - propagate;
+  if (solver->level)
+    backtrack (solver, 0);
+  if (!solver->inconsistent)
+    {
+      size_t remain = SIZE_STACK (*schedule);
+      const bool keep = true;
+      size_t prioritized = 0;
+      if (remain)
+	{
+	  while (!EMPTY_STACK (*schedule))
+	    {
+	      struct clause *c = POP (*schedule);
+	      if (!c->vivify)
+		continue;
+	      prioritized++;
+	      if (!keep)
+		c->vivify = false;
+	    }
+	  if (!prioritized)
+	    LOG ("no prioritized %s clauses left", type);
+	  else if (keep)
+	    LOG ("keeping %zu %s clauses prioritized %.0f%%",
+		 prioritized, type, percent (prioritized, remain));
+	}
+      else
+	LOG ("all scheduled %s clauses tried", type);
+    }
 
-  ADD (vivify_propagations, propagated);
+  CLEAR_STACK (*schedule);
+  assert (EMPTY_STACK (solver->clause));
 
-  if (conflict)
-    INC (vivify_conflicts);
+  report (solver, 1, tag);
+  free (counts);
+  return scheduled;
+}
 
-  return conflict;
+#if (defined(NTIER1) && defined(NTIER1)) || defined(NGLUE)
+static size_t
+vivify_redundant (struct satch *solver, uint64_t delta, double effort)
+{
+  return vivify_round (solver, REDUNDANT_ROUND, delta, effort);
+}
+#endif
+#ifndef NTIER1
+static size_t
+vivify_redundant_tier1 (struct satch *solver, uint64_t delta, double effort)
+{
+  return vivify_round (solver, REDUNDANT_TIER1_ROUND, delta, effort);
 }
+#endif
 
-static void
-vivify_binary_or_large_conflict (struct satch *solver,
-				 struct clause *conflict)
+#ifndef NTIER2
+static size_t
+vivify_redundant_tier2 (struct satch *solver, uint64_t delta, double effort)
 {
-  assert (solver->level);
-  assert (conflict->size >= 2);
-  LOGCLS (conflict, "vivify analyzing conflict (red: %d)",
-	  conflict->redundant);
-#if LOGGING || !defined(NDEBUG)
-  unsigned conflict_level = 0;
+  return vivify_round (solver, REDUNDANT_TIER2_ROUND, delta, effort);
+}
 #endif
-  for (all_literals_in_clause (lit, conflict))
+
+static void
+vivify_irredundant (struct satch *solver, uint64_t redundant_scheduled,
+		    uint64_t delta, double effort)
+{
+
+  const double factor = 10;
+  const uint64_t limit = factor * redundant_scheduled;
+  uint64_t irredundant_candidates = 0;
+
+  for (all_irredundant_clauses (c))
     {
-      assert (solver->values[lit] < 0);
-      const unsigned level = solver->levels[INDEX (lit)];
-      if (!level)
+      assert (!c->redundant);
+      if (c->garbage)
 	continue;
-#if LOGGING || !defined(NDEBUG)
-      if (level > conflict_level)
-	conflict_level = level;
-#endif
-      mark_analyzed (solver, INDEX (lit));
+      else if (++irredundant_candidates > limit)
+	break;
+    }
+
+  if (irredundant_candidates > limit)
+    LOG ("skipping %" PRIu64 " vivify-irredundant "
+	 "candidates > limit %" PRIu64 " = %g * %" PRIu64
+	 " scheduled redundant clauses",
+	 irredundant_candidates, limit, factor, redundant_scheduled);
+  else
+    {
+      LOG ("vivify-irredundant with "
+	   "%" PRIu64 " candidates <= %" PRIu64
+	   " = %g * %" PRIu64 " scheduled redundant clauses",
+	   irredundant_candidates, limit, factor, redundant_scheduled);
+      if (irredundant_candidates > redundant_scheduled)
+	{
+	  LOG ("not sorting %" PRIu64
+	       " vivify-irredundant candidates > %" PRIu64
+	       " scheduled redundant clauses",
+	       irredundant_candidates, redundant_scheduled);
+	}
+
+      (void) vivify_round (solver, IRREDUNDANT_ROUND, delta, effort);
     }
-  LOG ("vivify conflict level %u", conflict_level);
-  assert (0 < conflict_level);
-  assert (conflict_level == solver->level);
 }
 
-static void
-vivify_mark_garbage (struct satch *solver, struct clause *c, const char *msg)
+static uint64_t
+vivify_adjustment (struct satch *solver)
 {
-  assert (solver->watching);
-#ifndef NWATCHES
-  unwatch_literal (solver, c->literals[0], c);
-  unwatch_literal (solver, c->literals[1], c);
-#else
-  for (all_literals_in_clause (lit, c))
-    disconnect_literal (solver, lit, c);
-#endif
-  mark_garbage (solver, c, msg);
+  return nlogn (1 + solver->statistics.irredundant +
+		solver->statistics.redundant);
 }
 
 static bool
-vivify_learn (struct satch *solver,
-	      struct clause *c,
-	      unsigned non_false, bool irredundant, unsigned implied)
+really_vivify (struct satch *solver)
 {
-  bool res;
+  const uint64_t limit = vivify_adjustment (solver);
+  const uint64_t search_ticks = solver->statistics.ticks;
+  return limit < search_ticks;
+}
 
-  size_t size = SIZE_STACK (solver->clause);
-  assert (size <= non_false);
-  assert (2 < non_false);
 
-  if (size == 1)
-    {
-      LOG ("size 1 learned unit clause forces jump level 0");
-      if (solver->level)
-	backtrack (solver, 0);
 
-      const unsigned unit = ACCESS (solver->clause, 0);
-      assign (solver, unit, 0, true);
-      solver->iterate = true;
-      vivify_mark_garbage (solver, c, "subsumed by unit");
-      assert (!solver->level);
-      struct clause *conflict = boolean_constraint_propagation (solver);
-      if (conflict)
-	{
-	  assert (solver->level == 0);
-	  LOGCLS (conflict, "found conflict at level 0");
-	  solver->inconsistent = true;
-	  return false;
-	}
-      INC (vivify_strengthened);
-      res = true;
-    }
-  else
-    {
-      const unsigned *const levels = solver->levels;
-      const signed char *const values = solver->values;
+#define MINEFFORT 1e4
 
-      unsigned highest_level = 0;
-      for (all_elements_on_stack (unsigned, lit, solver->clause))
-	{
-	  const signed char value = values[lit];
-	  if (!value)
-	    {
-	      LOG ("unassigned literal %s in learned clause", LOGLIT (lit));
-	      highest_level = INVALID_LEVEL;
-	      break;
-	    }
-	  const unsigned idx = INDEX (lit);
-	  const unsigned level = levels[idx];
-	  assert (level > 0);
-	  if (level > highest_level)
-	    highest_level = level;
-	}
 
-      if (highest_level != INVALID_LEVEL)
-	LOG ("highest level %u in learned clause", highest_level);
+#define VIVIFYTIER1 3
+#define VIVIFYTIER2 6
+#define VIVIFYIRREDUNDANT 1
+#define VIVIFYEFFORT 100*1e-3
 
-      unsigned literals_on_highest_level = 0;
-      for (all_elements_on_stack (unsigned, lit, solver->clause))
-	{
-	  const unsigned value = values[lit];
-	  if (!value)
-	    literals_on_highest_level++;
-	  else
-	    {
-	      const unsigned idx = INDEX (lit);
-	      const unsigned level = levels[idx];
-	      assert (level > 0);
-	      if (level == highest_level)
-		literals_on_highest_level++;
-	    }
-	}
-#ifdef LOGGING
-      if (highest_level == INVALID_LEVEL)
-	LOG ("found %u unassigned literals", literals_on_highest_level);
-      else
-	LOG ("found %u literals on highest level", literals_on_highest_level);
-#endif
-      if (highest_level == INVALID_LEVEL && literals_on_highest_level > 1)
-	LOG ("no need to backtrack with more than one unassigned literal");
-      else
-	{
-	  unsigned jump_level = 0;
-	  for (all_elements_on_stack (unsigned, lit, solver->clause))
-	    {
-	      const signed char value = values[lit];
-	      if (!value)
-		continue;
-	      const unsigned idx = INDEX (lit);
-	      const unsigned level = levels[idx];
-	      if (level == highest_level)
-		continue;
-	      if (level > jump_level)
-		jump_level = level;
-	    }
-	  LOG ("determined jump level %u", jump_level);
+static int
+vivify (struct satch *solver)
+{
+  if (solver->inconsistent)
+    return 20;
 
-	  if (jump_level < solver->level)
-	    backtrack (solver, jump_level);
-	}
+  if (solver->level)
+    update_phases_and_backtrack_to_root_level (solver);
+  assert (!solver->level);
+  assert (!solver->dense);
 
-#ifndef NVIRTUAL
-      if (size == 2)
-	{
-#ifdef LOGGING
-	  const unsigned lit = ACCESS (solver->clause, 0);
-	  const unsigned other = ACCESS (solver->clause, 1);
-#endif
-	  const bool redundant = c->redundant;
-	  LOGBIN (false, lit, other, "vivification");
-	  trace_and_check_temporary_addition (solver);
-	  add_new_binary_and_watch_it (solver, redundant);
+  const uint64_t vivifications = INC (vivifications);
 
-	  vivify_mark_garbage (solver, c, "vivified clause");
-	  INC (vivify_strengthened);
-	  res = true;
-	}
-      else
-#endif
-      if (size < non_false)
-	{
-#ifndef NVIRTUAL
-	  assert (size > 2);
-#else
-	  assert (size >= 2);
-#endif
-	  CLEAR_STACK (solver->clause);
-	  assert (EMPTY_STACK (solver->clause));
-	  const unsigned old_size = c->size;
-	  unsigned new_size = 0, *lits = c->literals;
-#ifndef NWATCHES
-	  const unsigned litA = lits[0];
-	  const unsigned litB = lits[1];
+#ifndef NLIMITS
+  // Update vivification limit for next time
+  const uint64_t interval =
+    scale_interval (vivification_interval, nlogn, vivifications);
+  struct limits *const limits = &solver->limits;
+  limits->vivify.conflicts = CONFLICTS + interval;
 #endif
 
-	  assert (EMPTY_STACK (solver->clause));
-	  for (unsigned i = 0; i < old_size; i++)
-	    {
-	      const unsigned lit = lits[i];
-	      assert (lit < LITERALS);
-	      PUSH (solver->clause, lit);
-	      bool keep = true;
-	      if (lit != implied)
-		{
-		  const unsigned idx = INDEX (lit);
-		  const signed char mark = solver->marks[idx];
-		  if (!(mark & ANALYZED))
-		    keep = false;
-		  else if (solver->reasons[idx])
-		    keep = false;
-		  if (!keep)
-		    LOG
-		      ("literal %s not to be kept (has reason? %d; not analyzed? %d)",
-		       LOGLIT (lit), solver->reasons[idx] ? 1 : 0,
-		       !(mark & ANALYZED) ? 1 : 0);
-		}
-	      if (!c->redundant)
-		{
-#if !defined(NSUBSUMPTION) && (!defined(NREDUCE) || !defined(NELIMINATION))
-		  if (keep)
-		    mark_subsume_variable (solver, INDEX (lit));
-#endif
-#ifndef NELIMINATION
-		  if (!keep)
-		    mark_eliminate_literal (solver, lit);
-#endif
-		}
-	      if (keep)
-		lits[new_size++] = lit;
-              else {
-#ifdef NWATCHES
-                    disconnect_literal (solver, lit, c);
-#endif
-              }
-	    }
-	  assert (new_size < old_size);
-	  assert (new_size == size);
-	  if (!c->shrunken)
-	    {
-	      c->shrunken = true;
-	      lits[old_size - 1] = INVALID;
-	    }
-	  c->size = new_size;
-	  trace_and_check_clause_addition (solver, c, INVALID);
-	  trace_and_check_deletion (solver, SIZE_STACK (solver->clause),
-				    solver->clause.begin);
-	  CLEAR_STACK (solver->clause);
-	  if (!c->redundant
-#ifndef NGLUE
-	      && c->glue >= new_size
+  if (!solver->statistics.redundant)
+    return 0;
+  if (!really_vivify (solver))
+    return 0;
+
+  START (vivify);
+
+  solver->vivifying = true;
+#ifndef NARENA
+  pin_arena (solver);		// Vivification only shrinks clauses.
 #endif
-	    )
-	    {
-	      promote_clause (solver, c, new_size - 1);
-	    }
-#ifndef NWATCHES
-	  unwatch_literal (solver, litA, c);
-	  unwatch_literal (solver, litB, c);
+
+#ifndef NVIVIFICATIONLIMITS
+  const struct statistics *const statistics = &solver->statistics;
+  const uint64_t last = statistics->ticks - limits->vivify.search;
+  const uint64_t ticks = last < MINEFFORT ? MINEFFORT : last;
+  const uint64_t adjustment = vivify_adjustment (solver);
+  const uint64_t delta = ticks * VIVIFYEFFORT + adjustment;
+#else
+  const uint64_t delta = UINT64_MAX;
 #endif
 
-#ifndef NVIRTUAL
-	  if (new_size == 2)
-	    {
-	      assert (EMPTY_STACK (solver->clause));
-	      PUSH (solver->clause, c->literals[0]);
-	      PUSH (solver->clause, c->literals[1]);
-	      add_new_binary_and_watch_it (solver, c->redundant);
-	      CLEAR_STACK (solver->clause);
-	      vivify_mark_garbage (solver, c,
-				   "vivify shortened to binary clause");
-	    }
-	  else
+  message (solver, 2, "vivification", vivifications,
+	   "elimination limit of %" PRIu64 " ticks = %g * search ticks %"
+	   PRIu64, TICKS + delta, (double) VIVIFYEFFORT, delta);
+  uint64_t redundant_scheduled = 0;
+  double sum = VIVIFYTIER1 + VIVIFYTIER2 + VIVIFYIRREDUNDANT;
+
+#ifndef NVIVIFICATIONLIMITS
+  const uint64_t vivified = solver->statistics.vivified;
 #endif
-	    {
-#ifndef NCACHE
-	      c->search = 0;
+#if (defined(NTIER1) && defined(NTIER1)) || defined(NGLUE)
+  redundant_scheduled += vivify_redundant (solver, delta, VIVIFYTIER2 / sum);
+#endif
+#ifndef NTIER2
+  redundant_scheduled +=
+    vivify_redundant_tier2 (solver, delta, VIVIFYTIER2 / sum);
 #endif
-	      LOGCLS (c, "vivified shrunken");
-	      INC (vivify_strengthened);
 
-#ifndef NWATCHES
-	      // Beware of 'stale blocking literals' ... so rewatch if shrunken.
-	      watch_clause (solver, c);
-#else
-              count_clause (solver, c);
+
+  if (!solver->inconsistent)
+    {
+#ifndef NTIER1
+      redundant_scheduled +=
+	vivify_redundant_tier1 (solver, delta, VIVIFYTIER1 / sum);
 #endif
-	    }
-	  res = true;
-	}
-      else if (irredundant && !c->redundant)
-	{
-	  INC (vivify_subsume);
-	  vivify_mark_garbage (solver, c, "vivify subsumed (learn)");
-	  res = true;
-	}
-      else
-	{
-	  LOG ("vivify failed");
-	  res = false;
-	}
+
+      if (!solver->inconsistent)
+	vivify_irredundant (solver, redundant_scheduled, delta,
+			    VIVIFYIRREDUNDANT / sum);
+
     }
+  // Finally update limits.
 
-  return res;
+  {
+
+#ifndef NVIVIFICATIONLIMITS
+    const uint64_t limit = limits->vivify.conflicts;
+    limits->vivify.search = TICKS;
+    message (solver, 2, "vivification", vivifications,
+	     "%" PRIu64 " vivified, next limit at %" PRIu64 " after %" PRIu64
+	     " conflicts", solver->statistics.vivified - vivified, limit,
+	     interval);
+#endif
+  }
+  assert (solver->vivifying);
+  solver->vivifying = false;
+#ifndef NARENA
+  unpin_arena (solver);
+#endif
+  CLEAR_STACK (solver->vivification_schedule);
+  STOP (vivify);
+
+  if (solver->inconsistent)
+    return 20;
+  else
+    return 0;
 }
 
 static bool
-vivify_analyze (struct satch *solver, struct clause *c,
-		struct clause *conflict, bool *irredundant_ptr)
+vivifying (struct satch *solver)
 {
-  assert (conflict);
-  assert (!EMPTY_STACK (solver->analyzed));
-  LOGCLS (conflict, "vivify analyze: marking");
+#ifdef NCDCL
+  if (solver->level)
+    return false;
+#endif
+#ifndef NINPROCESSING
+  return solver->limits.vivify.conflicts < CONFLICTS;
+#else
+  return !solver->statistics.vivifications;
+#endif
+}
 
-  signed char *vivify_marks = solver->vivify_marks;
-  signed char *marks = solver->marks;
-  for (all_literals_in_clause (lit, c))
-    {
-      LOG ("marking literal %s %s", LOGLIT (lit), LOGLIT (NOT (lit)));
-      vivify_mark_literal (solver, lit);
-    }
+#endif // of '#ifndef NVIVIFICATION'
 
-  bool subsumed = false;
 
-  if (c->redundant || !conflict->redundant)
-    {
-      subsumed = true;
-      for (all_literals_in_clause (lit, conflict))
-	{
-	  const signed char value = satch_fixed (solver, lit);
-	  if (value < 0)
-	    continue;
-	  assert (!value);
-	  if (vivify_marked_literal (solver, lit) > 0)
-	    continue;
-	  subsumed = false;
-	  break;
-	}
-      if (subsumed)
-	LOGCLS (conflict, "vivify subsuming");
-    }
+/*------------------------------------------------------------------------*/
+#ifndef NPORTFOLIO
+/*------------------------------------------------------------------------*/
 
-  size_t analyzed = 0;
-  bool irredundant = conflict && !conflict->redundant;
+// The winning portfolio worker sets the 'stop' flag of the portfolio which
+// other workers check before each decision.
 
-  const unsigned *const levels = solver->levels;
-  const signed char *const values = solver->values;
-  struct clause *const *const reasons = solver->reasons;
+static bool
+portfolio_stopped (struct satch *solver)
+{
+  const struct worker *const worker = solver->worker;
+  if (!worker)
+    return false;
+  return __atomic_load_n (&worker->portfolio->stop, __ATOMIC_RELAXED);
+}
 
-  while (analyzed < SIZE_STACK (solver->analyzed))
-    {
-      const unsigned idx = ACCESS (solver->analyzed, analyzed).idx;
-      const unsigned lit = values[LITERAL (idx)] > 0 ?
-	LITERAL (idx) : NOT (LITERAL (idx));
-      assert (values[lit]);
-      const unsigned not_lit = NOT (lit);
-      struct clause *const reason = reasons[INDEX (lit)];
-      analyzed++;
-      assert (levels[idx]);
-      assert (marks[idx] & ANALYZED);
-      if (!reasons[idx])
-	{
-	  LOG ("vivify analyzing decision %s", LOGLIT (not_lit));
-	  PUSH (solver->clause, not_lit);
-	}
-#ifndef NBLOCK
-      else if (is_tagged_clause (reason))
-	{
-	  const unsigned other = tagged_clause_to_literal (reason);
-	  const bool redundant = tagged_clause_to_redundant (reason);
-	  if (redundant)
-	    irredundant = false;
-	  assert (values[other] < 0);
-	  assert (levels[INDEX (other)]);
-	  if (c->redundant || !redundant)
-	    {
-	      if (vivify_marked_literal (solver, lit) < 0 &&
-		  vivify_marked_literal (solver, other) < 0)
-		{
-		  LOG ("vivify subsuming by binary clause %s %s",
-		       LOGLIT (lit), LOGLIT (other));
-		  subsumed = true;
-		}
-	    }
-	  if (marks[INDEX (other)] & ANALYZED)
-	    continue;
-	  LOG ("vivify analyzing %s reason %s %s",
-	       LOGLIT (lit), LOGLIT (lit), LOGLIT (other));
-	  mark_analyzed (solver, INDEX (other));
-	}
+// Importing requires to backtrack to the root-level.  In order not to
+// disturb the search too much we only import at restarts, i.e., if the
+// import interval is exhausted and the solver is about to restart anyhow.
+// After importing the actual restart is still performed at the next
+// decision, which is cheap though since the trail is almost empty.
+
+static bool
+importing (struct satch *solver)
+{
+#ifdef NCDCL
+  (void) solver;
+  return false;			// Nothing exported and DPLL can not restart.
+#else
+  const struct worker *const worker = solver->worker;
+  if (!worker)
+    return false;
+  if (worker->import > CONFLICTS)
+    return false;
+#ifndef NRESTART
+  return restarting (solver);
+#else
+  return true;
 #endif
-      else
-	{
-	  LOGCLS (reason, "vivify analyzing %s reason", LOGLIT (lit));
-	  if (reason->redundant)
-	    irredundant = false;
-	  bool subsuming = vivify_marked_literal (solver, lit);
-	  for (all_literals_in_clause (other, reason))
-	    {
-	      if (other == lit)
-		continue;
-	      if (other == not_lit)
-		continue;
-	      assert (values[other] < 0);
-	      if (!levels[INDEX (other)])
-		continue;
-	      if (!vivify_marked_literal (solver, other))
-		subsuming = false;
-	      if (marks[INDEX (other)] & ANALYZED)
-		continue;
-	      mark_analyzed (solver, INDEX (other));
-	    }
-	  if (subsuming && (c->redundant || !reason->redundant))
-	    {
-	      subsumed = true;
-	      LOGCLS (reason, "vivify subsuming");
-	    }
-	}
-    }
+#endif
+}
 
-  for (all_literals_in_clause (lit, c))
+// Import a clause shared by another worker.  Such a clause is implied by
+// the original formula.  It is also implied by the formula of this worker
+// as long as it does not contain variables eliminated by this worker,
+// since variable elimination computes the projection of the formula on
+// the remaining variables.  We further skip clauses with variables never
+// activated by this worker (they might not be on the decision queue) and
+// clauses satisfied at the root-level.  Root-level falsified literals are
+// removed.  In debugging mode the imported clause is added to the checker
+// as original clause (and shortened as in 'internal_add').
+
+static void
+import_shared_clause (struct satch *solver,
+		      unsigned size, unsigned glue, unsigned *literals)
+{
+  assert (!solver->level);
+  assert (!solver->inconsistent);
+  assert (EMPTY_STACK (solver->clause));
+  const signed char *const values = solver->values;
+  const struct flags *const flags = solver->flags;
+  for (all_elements_in_array (unsigned, lit, size, literals))
     {
-      LOG ("unmarking literal %s %s", LOGLIT (lit), LOGLIT (NOT (lit)));
-      unmark_literal (vivify_marks, lit);
+      const unsigned idx = INDEX (lit);
+      if (idx >= solver->size)
+	goto SKIP;
+      const signed char value = values[lit];
+      if (value > 0)
+	goto SKIP;
+      if (value < 0)
+	continue;
+      if (!flags[idx].active)
+	goto SKIP;
+      PUSH (solver->clause, lit);
     }
-
-  const size_t size = SIZE_STACK (solver->clause);
-  assert (size > 0);
-  if (subsumed)
+  INC (imported);
+#ifndef NDEBUG
+  for (all_elements_in_array (unsigned, lit, size, literals))
+      checker_add_literal (solver->checker, export_literal (lit));
+  checker_add_original_clause (solver->checker);
+#endif
+  const size_t shortened = SIZE_STACK (solver->clause);
+  if (shortened < size)
     {
-      if (size == 1)
-	{
-	  LOG ("ignoring subsumed and instead learning unit clause");
+      trace_and_check_temporary_addition (solver);
 #ifndef NDEBUG
-	  assert (solver->level);
-	  const unsigned decision =
-	    *ACCESS (solver->control, solver->level - 1).trail;
-	  const unsigned unit = ACCESS (solver->clause, 0);
-	  assert (NOT (unit) == decision);
+      for (all_elements_in_array (unsigned, lit, size, literals))
+	  checker_add_literal (solver->checker, export_literal (lit));
+      checker_delete_clause (solver->checker);
 #endif
-	  subsumed = false;
-	}
-      else
-	LOGTMP ("vivify ignored learned");
     }
-  if (!subsumed)
+  LOGTMP ("imported");
+  if (!shortened)
     {
-      *irredundant_ptr = irredundant;
-      LOGTMP ("vivify learned");
+      LOG ("imported empty clause");
+      solver->inconsistent = true;
+    }
+  else if (shortened == 1)
+    {
+      const unsigned unit = ACCESS (solver->clause, 0);
+      solver->iterate = true;
+      assign (solver, unit, 0, true);
+    }
+#ifndef NLEARN
+#ifndef NVIRTUAL
+  else if (shortened == 2)
+    add_new_binary_and_watch_it (solver, true);
+#endif
+  else
+    {
+#ifndef NGLUE
+      struct clause *clause = new_redundant_clause (solver, glue);
+#else
+      struct clause *clause = new_redundant_clause (solver);
+#endif
+#ifndef NUSED
+      clause->used = 1;
+#endif
+#ifndef NWATCHES
+      watch_clause (solver, clause);
+#else
+      connect_clause (solver, clause);
+      count_clause (solver, clause);
+#endif
     }
-
-  return subsumed;
+#endif
+  (void) glue;
+SKIP:
+  CLEAR_STACK (solver->clause);
 }
 
-static void
-vivify_reset_analyzed (struct satch *solver)
+// Import clauses from the rings of all other workers on the root-level.
+// For each slot we check that the sequence number before and after reading
+// the clause matches the one of a completely written clause, i.e., twice
+// the position of the clause in the ring plus two.  Otherwise the clause
+// is currently written or was overwritten and we skip it.
+
+static int
+import_shared_clauses (struct satch *solver)
 {
-  signed char *marks = solver->marks;
-  for (all_elements_on_stack (struct analyzed, analyzed, solver->analyzed))
+  struct worker *const worker = solver->worker;
+  worker->import = CONFLICTS + import_interval;
+  update_phases_and_backtrack_to_root_level (solver);
+  const uint64_t before = solver->statistics.imported;
+  const struct portfolio *const portfolio = worker->portfolio;
+  unsigned literals[shared_size_limit];
+  for (unsigned other = 0; other != portfolio->size; other++)
     {
-      const unsigned idx = analyzed.idx;
-      marks[idx] &= ~ANALYZED;
+      if (other == worker->id)
+	continue;
+      struct ring *const ring = &portfolio->workers[other].ring;
+      const uint64_t exported =
+	__atomic_load_n (&ring->exported, __ATOMIC_ACQUIRE);
+      uint64_t next = worker->imported[other];
+      if (exported - next > shared_ring_size)
+	next = exported - shared_ring_size;
+      while (!solver->inconsistent && next != exported)
+	{
+	  struct slot *const slot = ring->slots + next % shared_ring_size;
+	  const uint64_t sequence = 2 * next++ + 2;
+	  if (__atomic_load_n (&slot->sequence, __ATOMIC_ACQUIRE) != sequence)
+	    continue;
+	  const unsigned size =
+	    __atomic_load_n (&slot->size, __ATOMIC_RELAXED);
+	  const unsigned glue =
+	    __atomic_load_n (&slot->glue, __ATOMIC_RELAXED);
+	  if (!size || size > shared_size_limit)
+	    continue;
+	  for (unsigned i = 0; i != size; i++)
+	    literals[i] =
+	      __atomic_load_n (slot->literals + i, __ATOMIC_RELAXED);
+	  __atomic_thread_fence (__ATOMIC_ACQUIRE);
+	  if (__atomic_load_n (&slot->sequence, __ATOMIC_RELAXED) != sequence)
+	    continue;
+	  import_shared_clause (solver, size, glue, literals);
+	}
+      worker->imported[other] = next;
     }
-  CLEAR_STACK (solver->analyzed);
-  CLEAR_STACK (solver->clause);
+  message (solver, 3, "import", solver->statistics.imported,
+	   "imported %" PRIu64 " shared clauses",
+	   solver->statistics.imported - before);
+  return solver->inconsistent ? 20 : 0;
 }
 
-#ifndef NVIVIFYIMPLY
-static struct clause *
-vivify_unit_conflict (struct satch *solver, unsigned lit)
+/*------------------------------------------------------------------------*/
+#endif
+/*------------------------------------------------------------------------*/
+
+#ifndef NLIMITS
+
+static void
+init_limits (struct satch *solver)
 {
-  assert (solver->values[lit] > 0);
-  const unsigned idx = INDEX (lit);
-  LOG ("vivify analyzing conflict unit %s", LOGLIT (NOT (lit)));
-  assert (!(solver->marks[idx] & ANALYZED));
-  struct clause *conflict;
-  struct clause *const reason = solver->reasons[idx];
+  // First initialize all limits.
 
-#ifndef NBLOCK
-  if (is_tagged_clause (reason))
-    {
-      conflict = untag_clause (solver, 0, lit, reason);
-    }
-  else
+#ifndef NELIMINATION
+#ifndef NINPROCESSING
+  solver->limits.eliminate.conflicts = elimination_interval;
 #endif
-    conflict = reason;
-  mark_analyzed (solver, idx);
-  PUSH (solver->clause, lit);
-  return conflict;
+#endif
+#ifndef NREDUCE
+  solver->limits.reduce.conflicts = reduce_interval;
+#endif
+#ifndef NREPHASE
+  solver->limits.rephase = rephase_interval;
+#endif
+#ifndef NRESTART
+  solver->limits.restart = restart_interval;
+#endif
+#ifndef NSWITCH
+  solver->limits.mode.conflicts = initial_focused_mode_conflicts;
+  solver->limits.mode.ticks.limit = initial_focused_mode_ticks;
+#endif
+
+#ifndef NVIVIFICATION
+  solver->limits.vivify.conflicts = vivification_interval;
+#endif
+#ifndef NPROBING
+#ifndef NINPROCESSING
+  solver->limits.probe.conflicts = probing_interval;
+#endif
+#endif
+  // Some sanity checking.
+
+#ifdef NSTABLE
+  assert (!solver->stable);
+#endif
+#ifdef NFOCUSED
+  assert (solver->stable);
+#endif
+
+  (void) solver;
 }
+
 #endif
 
+/*------------------------------------------------------------------------*/
 
-static bool
-vivify_clause (struct satch *solver, struct clause *c, unsigned *counts)
+// This is the main CDCL solving loop.
+
+static int
+solve (struct satch *solver, int delta_limit)
 {
-  assert (!c->garbage);
-  assert (!solver->inconsistent);
-  const unsigned *levels = solver->levels;
-  struct unsigned_stack *sorted = &solver->sorted;
+  START (solve);
+  report (solver, 1, '*');
 
-  LOGCLS (c, "trying to vivify candidate");
-  CLEAR_STACK (*sorted);
+  int res = solver->inconsistent ? 20 : 0;
+  struct clause *conflict;
 
-  for (all_literals_in_clause (lit, c))
-    {
-      const signed char value = satch_fixed (solver, lit);
-      if (value < 0)
-	continue;
-      if (value > 0)
-	{
-	  vivify_mark_garbage (solver, c, "root-level satisfied");
-	  break;
-	}
-      PUSH (*sorted, lit);
-    }
+  uint64_t conflict_limit =
+    delta_limit < 0 ? UINT64_MAX : CONFLICTS + delta_limit;
+  start_terminate (solver);
 
+#ifndef NSWITCH
+  start_mode (solver);
+#endif
+  while (!res)
+    if ((conflict = boolean_constraint_propagation (solver)))
+      {
+	if (!analyze_conflict (solver, conflict))
+	  res = 20;
+      }
+    else
+      {
+	if (solver->iterate)
+	  iterate (solver);
 
-  if (c->garbage)
-    return false;
-  const unsigned non_false = SIZE_STACK (*sorted);
+	if (!solver->unassigned)
+	  res = satisfied_under_assumptions (solver);
+	else
+	  {
+	    if (CONFLICTS >= conflict_limit)
+	      break;
+	    else if (terminating (solver))
+	      break;
+#ifndef NPORTFOLIO
+	    else if (portfolio_stopped (solver))
+	      break;
+	    else if (importing (solver))
+	      res = import_shared_clauses (solver);
+#endif
+	    else
+#ifndef NRESTART
+	    if (restarting (solver))
+	      restart (solver);
+	    else
+#endif
+#ifndef NSWITCH
+	    if (switching (solver))
+	      switch_mode (solver);
+	    else
+#endif
+#ifndef NREDUCE
+	    if (reducing (solver))
+	      reduce (solver);
+	    else
+#endif
+#ifndef NREPHASE
+	    if (rephasing (solver))
+	      rephase (solver);
+	    else
+#endif
+#ifndef NPROBING
+	    if (probing (solver))
+	      res = probe (solver);
+	    else
+#endif
+#ifndef NELIMINATION
+	    if (eliminating (solver))
+	      res = eliminate_variables (solver);
+	    else
+#endif
+#ifndef NVIVIFICATION
+	    if (vivifying (solver))
+	      res = vivify (solver);
+	    else
+#endif
+	      res = decide (solver);
+	  }
+      }
+#ifndef NSWITCH
+  stop_mode (solver);
+#endif
 
-  assert (1 < non_false);
-  assert (non_false <= c->size);
+  report (solver, 1, !res ? '?' : res == 10 ? '1' : '0');
+  STOP (solve);
+  return res;
+}
 
-#ifndef NLOGGING
-  if (!non_false)
-    LOG ("no root level falsified literal");
-  else if (non_false == c->size)
-    LOG ("all literals root level unassigned");
-  else
-    LOG ("found %u root level non-falsified literals", non_false);
+/*------------------------------------------------------------------------*/
+
+// For cube-and-conquer the formula is split into cubes (conjunctions of
+// literals) which are solved independently under assumptions, for instance
+// on different machines.  The cubes are the leaves of a search tree of
+// decisions with bounded depth.  At each node we look ahead on the
+// unassigned variables with the highest scores of the decision heuristic,
+// propagate both of their phases and split on the variable maximizing the
+// product of the number of propagated literals of both phases.  If only one
+// phase fails then on the root-level its negation is a unit and otherwise
+// it is added to the cube without splitting (and without counting towards
+// the depth).  Refuted branches are not produced as cubes.
+
+struct cuber
+{
+  void *state;			// Passed to call-back.
+  void (*cube) (void *state, int size, const int *literals);
+  struct unsigned_stack decisions;	// Literals of the current cube.
+  struct int_stack exported;	// Exported literals of the current cube.
+  unsigned candidates[cube_candidates];	// Variables to look ahead.
+  bool stopped;			// Terminated by limit or call-back.
+};
+
+// Decisions during cubing are not made by 'decide' and thus we have to
+// keep the decision level stacks of DLIS in sync as for assumptions.
+
+static void
+cube_decide (struct satch *solver, unsigned lit)
+{
+  solver->level++;
+#ifdef DLIS
+  const int irred_sat_upto = EMPTY_STACK (solver->irred_sat_upto) ?
+    0 : TOP (solver->irred_sat_upto);
+  const int red_sat_upto = EMPTY_STACK (solver->red_sat_upto) ?
+    0 : TOP (solver->red_sat_upto);
+  PUSH (solver->irred_sat_upto, irred_sat_upto);
+  PUSH (solver->red_sat_upto, red_sat_upto);
 #endif
-  if (non_false == 2)
-    {
-      LOGCLS (c, "skipping actually binary");
-      return false;
-    }
+  assign (solver, lit, 0, false);
+}
 
-  unsigned unit = INVALID;
+static struct clause *
+cube_propagate (struct satch *solver)
+{
+  struct trail *trail = &solver->trail;
+  unsigned *p;
 
-  for (all_literals_in_clause (lit, c))
-    {
-      const signed char value = solver->values[lit];
-      if (value < 0)
-	continue;
-      if (!value)
-	{
-	  unit = INVALID;
-	  break;
-	}
-      assert (value > 0);
-      if (unit != INVALID)
-	{
-	  unit = INVALID;
-	  break;
-	}
-      unit = lit;
-    }
-  if (unit == INVALID)
-    LOG ("non-reason candidate clause");
+  struct clause *conflict = 0;
+  uint64_t ticks = 0;
+
+  for (p = trail->propagate; !conflict && p != trail->end; p++)
+    conflict = propagate_assignment (solver, *p, &ticks);
+
+  ADD (cube_ticks, ticks);
+  trail->propagate = p;
+
+  if (!conflict && !solver->level)
+    flush_units (solver);
+
+  return conflict;
+}
+
+// The score of the decision heuristic which 'decide_variable' would use
+// (without any scores for DLIS the variable index order is kept).
+
+static double
+cube_score (struct satch *solver, unsigned idx)
+{
+#ifdef DLIS
+  (void) solver, (void) idx;
+  return 0;
+#elif defined(NHEAP)
+  return get_queue (solver)->links[idx].stamp;
+#elif defined(NQUEUE)
+  return get_scores (solver)->score[idx];
+#else
+  if (solver->stable)
+    return get_scores (solver)->score[idx];
   else
+    return get_queue (solver)->links[idx].stamp;
+#endif
+}
+
+// Find the unassigned active variables with the highest scores by keeping
+// the candidates sorted by decreasing score with insertion sort.
+
+static unsigned
+select_cube_candidates (struct satch *solver, struct cuber *cuber)
+{
+  const struct flags *const flags = solver->flags;
+  const signed char *const values = solver->values;
+  unsigned *const candidates = cuber->candidates;
+  double scores[cube_candidates];
+  unsigned size = 0;
+
+  for (all_variables (idx))
     {
-      LOG ("candidate is the reason of %s", LOGLIT (unit));
-      const unsigned level = levels[INDEX (unit)];
-      assert (level > 0);
-      LOG ("forced to backtrack to level %u", level - 1);
-      backtrack (solver, level - 1);
+      if (!flags[idx].active || values[LITERAL (idx)])
+	continue;
+      const double score = cube_score (solver, idx);
+      if (size == cube_candidates && score <= scores[size - 1])
+	continue;
+      unsigned i = size < cube_candidates ? size++ : size - 1;
+      while (i && scores[i - 1] < score)
+	{
+	  candidates[i] = candidates[i - 1];
+	  scores[i] = scores[i - 1];
+	  i--;
+	}
+      candidates[i] = idx;
+      scores[i] = score;
     }
 
-  vivify_sort_stack_by_counts (solver, counts, sorted);
+  ADD (cube_ticks, VARIABLES / 8);
+  return size;
+}
 
-  unsigned implied = INVALID;
-  unsigned falsified = 0;
-  unsigned satisfied = 0;
-  struct clause *conflict = 0;
-  unsigned level = 0;
-  bool res = false;
-  assert (non_false == SIZE_STACK (*sorted));
-  for (all_elements_on_stack (unsigned, lit, *sorted))
+// Returns the number of literals propagated by assigning 'lit' on a new
+// decision level or 'INVALID' if propagation yields a conflict.
+
+static unsigned
+look_ahead (struct satch *solver, unsigned lit)
+{
+  const unsigned *const before = solver->trail.end;
+  cube_decide (solver, lit);
+  const struct clause *const conflict = cube_propagate (solver);
+  const unsigned propagated = solver->trail.end - before;
+  backtrack (solver, solver->level - 1);
+  return conflict ? INVALID : propagated;
+}
+
+// Look ahead on the candidates and return the literal to split on.  The
+// result is 'INVALID' if the current node is refuted (and then on the
+// root-level the formula is inconsistent).  If only one phase of a
+// candidate fails, the other phase is returned with 'forced' set.
+
+static unsigned
+split_literal (struct satch *solver, struct cuber *cuber, bool *forced)
+{
+  const signed char *const values = solver->values;
+  for (;;)
     {
-      if (level++ < solver->level)
+      const unsigned size = select_cube_candidates (solver, cuber);
+      assert (size);
+
+      uint64_t best_score = 0;
+      unsigned best = INVALID, implied = INVALID;
+
+      for (unsigned i = 0; implied == INVALID && i != size; i++)
 	{
-	  struct level frame = ACCESS (solver->control, level - 1);
+	  const unsigned idx = cuber->candidates[i];
+	  const unsigned lit = LITERAL (idx);
+	  if (values[lit])
+	    continue;
 	  const unsigned not_lit = NOT (lit);
-	  if (*frame.trail == not_lit)
+	  const unsigned pos = look_ahead (solver, lit);
+	  const unsigned neg = look_ahead (solver, not_lit);
+	  if (pos == INVALID && neg == INVALID)
 	    {
-	      LOG ("reusing assumption %s", LOGLIT (not_lit));
-	      INC (vivify_reused);
-	      INC (vivify_probes);
-	      assert (solver->values[lit] < 0);
-	      continue;
+	      LOG ("both phases of %s fail", LOGVAR (idx));
+	      if (!solver->level)
+		{
+		  trace_and_check_unit_addition (solver, not_lit);
+		  trace_and_check_empty_addition (solver);
+		  solver->inconsistent = true;
+		}
+	      return INVALID;
+	    }
+	  if (pos == INVALID)
+	    implied = not_lit;
+	  else if (neg == INVALID)
+	    implied = lit;
+	  else
+	    {
+	      const uint64_t score = (pos + 1llu) * (neg + 1llu);
+	      if (best != INVALID && score <= best_score)
+		continue;
+	      best = pos < neg ? not_lit : lit;
+	      best_score = score;
 	    }
-
-	  LOG ("forced to backtrack to decision level %u", level - 1);
-	  backtrack (solver, level - 1);
-	}
-      const signed char value = solver->values[lit];
-      assert (!value || levels[INDEX (lit)] <= level);
-      if (!value)
-	{
-	  LOG ("literal %s unassigned", LOGLIT (lit));
-	  const unsigned not_lit = NOT (lit);
-	  INC (vivify_probes);
-	  solver->level++;
-	  assign (solver, not_lit, 0, false);
-	  assert (solver->level >= 1);
-	  conflict = vivify_boolean_constraint_propagation (solver, c);
-	  if (!conflict)
-	    continue;
-	  vivify_binary_or_large_conflict (solver, conflict);
-	  assert (!EMPTY_STACK (solver->analyzed));
-	  break;
 	}
 
-      if (value < 0)
+      if (implied == INVALID)
 	{
-	  assert (levels[INDEX (lit)]);
-	  LOG ("literal %s already falsified", LOGLIT (lit));
-	  falsified++;
-	  continue;
+	  assert (best != INVALID);
+	  LOG ("splitting on %s with score %" PRIu64,
+	       LOGLIT (best), best_score);
+	  *forced = false;
+	  return best;
 	}
 
-      satisfied++;
-      assert (value > 0);
-      assert (levels[INDEX (lit)]);
-      LOG ("literal %s already satisfied", LOGLIT (lit));
-
-#ifndef NVIVIFYIMPLY
-      if (!c->redundant)
+      if (solver->level)
 	{
-	  implied = lit;
-	  conflict = vivify_unit_conflict (solver, lit);
-	  assert (!EMPTY_STACK (solver->analyzed));
-	  assert (conflict);
+	  LOG ("forced %s", LOGLIT (implied));
+	  *forced = true;
+	  return implied;
 	}
-      else
+
+      LOG ("failed literal %s", LOGLIT (NOT (implied)));
+      trace_and_check_unit_addition (solver, implied);
+      assign (solver, implied, 0, true);
+      if (cube_propagate (solver))
 	{
-	  vivify_mark_garbage (solver, c, "vivify implied");
-	  INC (vivify_implied);
-	  res = true;
+	  LOG ("propagating unit %s yields conflict", LOGLIT (implied));
+	  trace_and_check_empty_addition (solver);
+	  solver->inconsistent = true;
+	  return INVALID;
 	}
-#endif
-      break;
+      if (!solver->unassigned)
+	return INVALID;
     }
+}
 
-  if (c->garbage)
+static void
+new_cube (struct satch *solver, struct cuber *cuber)
+{
+  CLEAR_STACK (cuber->exported);
+  for (all_elements_on_stack (unsigned, lit, cuber->decisions))
+      PUSH (cuber->exported, export_literal (lit));
+  const int size = SIZE_STACK (cuber->exported);
+  cuber->cube (cuber->state, size, cuber->exported.begin);
+  LOG ("new cube of size %d", size);
+  INC (cubes);
+}
+
+// Recursively split the current node with the given remaining depth and
+// return '10' if a satisfying assignment was found.  If cubing is stopped
+// early the current node and all not yet split siblings on the path become
+// cubes, such that all produced cubes still cover the whole search space.
+
+static int
+split_cube (struct satch *solver, struct cuber *cuber, unsigned depth)
+{
+  if (!solver->unassigned)
+    return 10;
+  if (!depth || terminating (solver))
     {
-      assert (!conflict);
-      assert (EMPTY_STACK (solver->analyzed));
+      if (depth)
+	cuber->stopped = true;
+      new_cube (solver, cuber);
+      return 0;
     }
-  else if (conflict)
-    {
-      assert (!EMPTY_STACK (solver->analyzed));
-      assert (solver->level);
-      bool irredundant;
-      const bool subsumed =
-	vivify_analyze (solver, c, conflict, &irredundant);
 
-      backtrack (solver, solver->level - 1);
+  bool forced;
+  const unsigned lit = split_literal (solver, cuber, &forced);
+  if (lit == INVALID)
+    return solver->inconsistent ? 20 : !solver->unassigned ? 10 : 0;
 
-      if (subsumed)
+  const unsigned level = solver->level;
+  const unsigned phases = forced ? 1 : 2;
+  for (unsigned phase = 0; phase != phases; phase++)
+    {
+      const unsigned decision = phase ? NOT (lit) : lit;
+      PUSH (cuber->decisions, decision);
+      if (cuber->stopped)
+	new_cube (solver, cuber);
+      else
 	{
-	  vivify_mark_garbage (solver, c, "vivify subsumed");
-	  LOGCLS (c, "subsuming clause: ");
-	  INC (vivify_subsume);
-	  INC (subsumed);
-	  res = true;
+	  cube_decide (solver, decision);
+	  int res = 0;
+	  if (!cube_propagate (solver))
+	    res = split_cube (solver, cuber, depth - !forced);
+	  if (res)
+	    return res;
+	  backtrack (solver, level);
 	}
-      else
-	res = vivify_learn (solver, c, non_false, irredundant, implied);
-      vivify_reset_analyzed (solver);
+      (void) POP (cuber->decisions);
     }
-  else if (falsified && !satisfied)
+
+  return 0;
+}
+
+static int
+cube (struct satch *solver, unsigned depth, void *state,
+      void (*callback) (void *state, int size, const int *literals))
+{
+  START (cube);
+  start_terminate (solver);
+
+  struct cuber cuber;
+  memset (&cuber, 0, sizeof cuber);
+  cuber.state = state;
+  cuber.cube = callback;
+
+  const uint64_t before = solver->statistics.cubes;
+  int res = 0;
+
+  if (solver->inconsistent)
+    res = 20;
+  else if (cube_propagate (solver))
     {
-      LOG ("vivified %u false literals", falsified);
-      assert (EMPTY_STACK (solver->clause));
-      struct clause *const *const reasons = solver->reasons;
-      assert (non_false == SIZE_STACK (*sorted));
-      for (all_elements_on_stack (unsigned, lit, *sorted))
-	{
-	  const unsigned idx = INDEX (lit);
-	  assert (levels[idx]);
-	  if (reasons[idx])
-	    continue;
-	  assert (!(solver->marks[idx] & ANALYZED));
-	  mark_analyzed (solver, idx);
-	  PUSH (solver->clause, lit);
-	}
-      res = vivify_learn (solver, c, non_false, false, INVALID);
-      vivify_reset_analyzed (solver);
+      LOG ("root-level propagation yields conflict");
+      trace_and_check_empty_addition (solver);
+      solver->inconsistent = true;
+      res = 20;
     }
   else
+    res = split_cube (solver, &cuber, depth);
+
+  const uint64_t cubes = solver->statistics.cubes - before;
+  if (!res && !cubes && !cuber.stopped)
     {
-      assert (EMPTY_STACK (solver->analyzed));
-      LOG ("vivify failed");
+      LOG ("all cubes refuted");
+      res = 20;
+    }
+  if (res != 10 && solver->level)
+    backtrack (solver, 0);
+
+  RELEASE_STACK (cuber.decisions);
+  RELEASE_STACK (cuber.exported);
+
+  message (solver, 1, "cube", solver->statistics.cubes,
+	   "generated %" PRIu64 " cubes of depth %u", cubes, depth);
+  STOP (cube);
+  return res;
+}
+
+/*------------------------------------------------------------------------*/
+
+#ifndef NDEBUG
+
+// This witness checker goes over the saved original clauses and checks that
+// each of them is satisfied.  If not a fatal error message is triggered
+// after printing an original clause which was found to be unsatisfied.
+
+static void
+check_witness (struct satch *solver)
+{
+  const int *const begin_original = solver->original.begin;
+  const int *const end_original = solver->original.end;
+  size_t clauses = 0;
+  for (const int *p = begin_original, *c = p; c != end_original; c = p)
+    {
+      clauses++;
+      bool satisfied = false;
+      int lit;
+      while (assert (p != end_original), (lit = *p++))
+	if (satch_val (solver, lit) == lit)
+	  satisfied = true;
+      if (satisfied)
+	continue;
+      COLORS (2);
+      fflush (stdout);
+      fprintf (stderr,
+	       "%slibsatch: %sfatal error: %sclause[%zd] unsatisfied:\n",
+	       BOLD, RED, NORMAL, clauses);
+      for (const int *q = c; (lit = *q); q++)
+	fprintf (stderr, "%d ", *q);
+      fputs ("0\n", stderr);
+      fflush (stderr);
+      abort ();
+    }
+
+  // Then check that the original XOR constraints have odd parity.
+
+  const int *const begin_xors = solver->original_xors.begin;
+  const int *const end_xors = solver->original_xors.end;
+  size_t xors = 0;
+  for (const int *p = begin_xors, *x = p; x != end_xors; x = p)
+    {
+      xors++;
+      bool parity = false;
+      int lit;
+      while (assert (p != end_xors), (lit = *p++))
+	if (satch_val (solver, lit) == lit)
+	  parity = !parity;
+      if (parity)
+	continue;
+      COLORS (2);
+      fflush (stdout);
+      fprintf (stderr,
+	       "%slibsatch: %sfatal error: %sXOR[%zd] unsatisfied:\n",
+	       BOLD, RED, NORMAL, xors);
+      for (const int *q = x; (lit = *q); q++)
+	fprintf (stderr, "%d ", *q);
+      fputs ("0\n", stderr);
+      fflush (stderr);
+      abort ();
     }
 
-  if (!res)
-    return false;
+  LOG ("checked witness successfully");
+}
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
+// The API functions below have several requirements (contracts) and those
+// need to be enforced even in optimized code, particularly in order to help
+// library users to detect, test and debug invalid API usage.
+
+static void
+invalid_usage (const char *message, const char *function)
+{
+  COLORS (2);
+  fprintf (stderr,
+	   "%slibsatch: %sfatal error: %sinvalid API usage in '%s': %s\n",
+	   BOLD, RED, NORMAL, function, message);
+  fflush (stderr);
+  abort ();
+}
+
+// Macros to enforce valid API usage.
+
+#define REQUIRE(CONDITION,MESSAGE) \
+do { \
+  if (!(CONDITION)) \
+    invalid_usage (MESSAGE, __func__); \
+} while (0)
+
+#define REQUIRE_NON_ZERO_SOLVER() \
+  REQUIRE (solver, "zero solver argument")
+
+#define REQUIRE_VALID_LITERAL(ELIT) \
+do { \
+  REQUIRE ((ELIT) != INT_MIN, "'INT_MIN' literal argument"); \
+  REQUIRE (sizeof (void*) > 4 || abs (ELIT) <= (1<<29), \
+           "maximum of '2^29' variables exceeded on 32-bit system"); \
+} while (0)
+
+#define REQUIRE_NON_ZERO_VALID_LITERAL(ELIT) \
+do { \
+  REQUIRE ((ELIT), "zero literal argument"); \
+  REQUIRE ((ELIT) != INT_MIN, "'INT_MIN' literal argument"); \
+} while (0)
+
+#define REQUIRE_COMPLETE_CLAUSE() \
+  REQUIRE (EMPTY_STACK (solver->clause), \
+	   "incomplete clause (zero literal missing)")
+
+/*------------------------------------------------------------------------*/
+
+static struct satch *
+internal_init (void)
+{
+  struct satch *solver = calloc (1, sizeof (struct satch));
+  if (!solver)
+    fatal_error ("could not allocate solver");
+#ifdef NFOCUSED
+  solver->stable = 1;
+#endif
+#ifndef NDEBUG
+  solver->checker = checker_init ();
+#endif
+#ifndef NBLOCK
+  init_binary (solver);
+#endif
+
+#ifndef NVSIDS
+#ifndef NFOCUSED
+  solver->scores[0].factor = focused_score_increment_factor;
+#endif
+#ifndef NSTABLE
+  solver->scores[1].factor = stable_score_increment_factor;
+#endif
+#endif
 
-  INC (vivified);
+  solver->terminate.ticks = -1;
+  solver->terminate.seconds = -1;
 
-  assert (EMPTY_STACK (solver->analyzed));
-  assert (EMPTY_STACK (solver->clause));
-  return true;
+#ifdef AVX2
+  solver->avx2 = __builtin_cpu_supports ("avx2");
+#endif
+
+  init_averages (solver);
+#ifndef NLIMITS
+  init_limits (solver);
+#endif
+  init_profiles (solver);
+  return solver;
 }
 
-static bool
-simplify_vivification_candidate (struct satch *solver, struct clause *const c)
+/*------------------------------------------------------------------------*/
+
+static void
+internal_release (struct satch *solver)
 {
-  assert (!solver->level);
-  assert (!c->garbage);
-  bool satisfied = false;
-  assert (EMPTY_STACK (solver->clause));
-  const signed char *const values = solver->values;
-  LOGCLS (c, "simplifying for vivification");
-  for (all_literals_in_clause (lit, c))
+#ifdef NLEARN
+  if (solver->level)
+    backtrack (solver, 0);	// To delete reason clauses.
+#endif
+
+  release_tracer (solver);
+  solver->proof = 0;
+#ifdef TIMELINE
+  free (solver->timeline.events);
+#endif
+#ifdef COLD
+  if (solver->cold_watches)
     {
-      const signed char value = values[lit];
-      if (value > 0)
-	{
-	  satisfied = true;
-	  mark_garbage (solver, c, "vivification satisfied candidate");
-	  break;
-	}
-      if (!value)
-	PUSH (solver->clause, lit);
+      discard_cold_clauses (solver);
+      for (all_literals (lit))
+	RELEASE_STACK (solver->cold_watches[lit]);
+      release_chunk (solver->cold_watches);
+      RELEASE_STACK (solver->cold);
     }
-  unsigned non_false = SIZE_STACK (solver->clause);
-  if (satisfied)
+#endif
+  for (all_literals (lit))
     {
-      CLEAR_STACK (solver->clause);
-      return true;
+      struct watches *watches = solver->watches + lit;
+#if !defined(NDEBUG) && !defined(NVIRTUAL)
+      const union watch *const end = watches->end;
+      for (const union watch * p = watches->begin; p != end; p++)
+	if (p->header.binary)
+	  delete_header (solver, lit, p->header);
+#ifdef NPACKED
+	else
+	  p++;
+#endif
+#endif
+      RELEASE_STACK (*watches);
     }
-  if (non_false == c->size)
+
+  release_chunk (solver->watches);
+
+#ifdef RECORDS
+  release_chunk (solver->records);
+#else
+  release_chunk (solver->levels);
+#endif
+  release_chunk (solver->values);
+#ifndef NSAVE
+  release_chunk (solver->saved);
+#endif
+#ifndef NTARGET
+  release_chunk (solver->targets);
+#endif
+#ifndef NBEST
+  release_chunk (solver->bests);
+#endif
+  release_chunk (solver->marks);
+#ifndef NVIVIFICATION
+  release_chunk (solver->vivify_marks);
+#endif
+  release_chunk (solver->flags);
+  release_chunk (solver->frames);
+#ifndef NCONTROL
+  free (solver->position);
+  RELEASE_STACK (solver->control);
+#endif
+#ifndef RECORDS
+  release_chunk (solver->reasons);
+#endif
+  release_chunk (solver->trail.begin);
+
+#ifndef NQUEUE
+#ifndef NQUEUE0
+  release_queue (&solver->queue[0]);
+#else
+  assert (!solver->queue[0].links);
+#endif
+#ifndef NQUEUE1
+  release_queue (&solver->queue[1]);
+#else
+  assert (!solver->queue[1].links);
+#endif
+#endif
+
+#ifndef NHEAP
+#ifndef NHEAP0
+  release_heap (&solver->scores[0]);
+#else
+  assert (!solver->scores[0].begin);
+#endif
+#ifndef NHEAP1
+  release_heap (&solver->scores[1]);
+#else
+  assert (!solver->scores[1].begin);
+#endif
+#endif
+
+#ifndef NLAZYACTIVATION
+#ifndef NFOCUSED
+  RELEASE_STACK (solver->put[0]);
+#else
+  assert (EMPTY_STACK (solver->put[0]));
+#endif
+#ifndef NSTABLE
+  RELEASE_STACK (solver->put[1]);
+#else
+  assert (EMPTY_STACK (solver->put[1]));
+#endif
+#endif
+
+#ifndef NELIMINATION
+  RELEASE_STACK (solver->extend);
+  RELEASE_STACK (solver->resolvents);
+#endif
+
+#ifndef NMINIMIZE
+  RELEASE_STACK (solver->poisoned);
+  RELEASE_STACK (solver->removable);
+#endif
+#ifndef NSHRINK
+  RELEASE_STACK (solver->shrunken);
+#endif
+  RELEASE_STACK (solver->analyzed);
+  RELEASE_STACK (solver->assumptions);
+  RELEASE_STACK (solver->clause);
+  RELEASE_STACK (solver->blocks);
+#ifndef NBINARIES
+  RELEASE_STACK (solver->binaries);
+#endif
+
+  for (all_pointers_on_stack (struct clause, c, solver->irredundant))
+      (void) delete_clause (solver, c);
+  RELEASE_STACK (solver->irredundant);
+#ifndef NLEARN
+  for (all_pointers_on_stack (struct clause, c, solver->redundant))
+      (void) delete_clause (solver, c);
+  RELEASE_STACK (solver->redundant);
+#endif
+  assert (!solver->statistics.irredundant);
+  assert (!solver->statistics.redundant);
+  for (all_pointers_on_stack (struct xor, x, solver->xors))
+      delete_xor (solver, x);
+  RELEASE_STACK (solver->xors);
+  if (solver->xor_watches)
     {
-      CLEAR_STACK (solver->clause);
-      return false;
+      for (all_variables (idx))
+	RELEASE_STACK (solver->xor_watches[idx]);
+      release_chunk (solver->xor_watches);
     }
-  assert (1 < non_false);
-  assert (non_false <= c->size);
+#ifndef NARENA
+  free (solver->arena.begin);
+#endif
+#ifndef NPOOL
+  release_pool (solver);
+#endif
+#ifndef NBLOCK
+  release_binary (solver);
+#endif
 
-#ifdef NWATCHES
-      for (all_literals_in_clause (lit, c)) {
-        disconnect_literal (solver, lit, c);
-      }
+  RELEASE_STACK (solver->added);
+#ifndef NDEBUG
+  RELEASE_STACK (solver->original);
+  RELEASE_STACK (solver->original_xors);
+
+#ifndef NLEARN
+  checker_enable_leak_checking (solver->checker);
+#endif
+  checker_release (solver->checker);
+#endif
+#ifndef NVIVIFICATION
+  RELEASE_STACK (solver->vivification_schedule);
+  RELEASE_STACK (solver->sorted);
+#endif
+#ifndef NRADIXSORT
+  RELEASE_SCRATCH (solver->scratch);
 #endif
+  free (solver);
+}
 
-#ifndef NVIRTUAL
-  if (non_false == 2)
+/*------------------------------------------------------------------------*/
+
+// Add the clause in the temporary 'clause' stack (with its external
+// literals on the 'added' stack) as new irredundant clause.
+
+static void
+import_clause (struct satch *solver)
+{
+  assert (!solver->inconsistent);
+#ifndef NDEBUG
+  for (all_elements_on_stack (int, lit, solver->added))
     {
-#ifdef LOGGING
-      const unsigned first = ACCESS (solver->clause, 0);
-      const unsigned second = ACCESS (solver->clause, 1);
-#endif
-      trace_and_check_temporary_addition (solver);
-      LOGBIN (c->redundant, first, second, "vivification shrunken candidate");
-      add_new_binary_and_watch_it (solver, c->redundant);
-      mark_garbage (solver, c, "vivification shrunken candidate");
+      PUSH (solver->original, lit);
+      checker_add_literal (solver->checker, lit);
     }
-  else
+  PUSH (solver->original, 0);
+  checker_add_original_clause (solver->checker);
 #endif
+  bool remove_original_clause;
+
+  // First check whether the imported clause is already (root-level)
+  // satisfied or trivial (contains both a literal and its negation).
+  // During this check falsified and duplicated literals are removed.
+
+  if (!imported_clause_trivial_or_satisfied (solver))
     {
-      const unsigned old_size = c->size;
-      unsigned new_size = 0, *lits = c->literals;
-      CLEAR_STACK (solver->clause);
-      for (unsigned i = 0; i < old_size; i++)
+      // Activate variables in the order they appear in the input CNF.
+      // This gives an implicit order of the variables in the decision
+      // queue as well as in the binary heap keeping variables in the
+      // same clauses close to each other which seems beneficial.
+
+      activate_literals (solver);
+
+      // We need special treatment for empty and unary clauses since all
+      // internally allocated clauses have at least two literals.
+
+      const size_t size = SIZE_STACK (solver->clause);
+
+      if (!size)
 	{
-	  const unsigned lit = lits[i];
-	  PUSH (solver->clause, lit);
-	  const signed char value = solver->values[lit];
-	  if (value != 0 && solver->levels[INDEX (lit)] == 0)
-	    continue;
-	  assert (value <= 0);
-	  if (value < 0)
-	    continue;
-	  lits[new_size++] = lit;
+	  LOG ("empty thus inconsistent imported clause");
+	  solver->inconsistent = true;
+	}
+      else if (size == 1)
+	{
+	  // It is a common technique to represent unit clauses by just
+	  // assigning its literal on the root-level.  This makes sure
+	  // that all allocated clauses are at least binary, but for
+	  // instance requires that 'analyze' treats root-level literals
+	  // in a special way, 'reduce' and thus 'assign' ignore
+	  // clauses forcing root-level assigned literals and finally
+	  // (and maybe really the most severe consequence), makes proof
+	  // tracing semantics rather complex (particularly regarding the
+	  // situation of deleting unit clauses in RUP / DRAT proofs).
+
+	  const unsigned unit = ACCESS (solver->clause, 0);
+	  const signed char value = solver->values[unit];
+	  if (value > 0)
+	    {
+	      LOG ("skipping redundant unit clause %s", LOGLIT (unit));
+	    }
+	  else if (value < 0)
+	    {
+	      LOG ("found inconsistent unit clause %s", LOGLIT (unit));
+	      solver->inconsistent = true;
+	    }
+	  else
+	    {
+	      LOG ("found unit clause %s", LOGLIT (unit));
+	      assign (solver, unit, 0, true);
+	      remove_original_clause = true;
+	    }
 	}
 #ifndef NVIRTUAL
-      assert (2 < new_size);
-#endif
-      assert (new_size == non_false);
-      assert (new_size < old_size);
-      c->size = new_size;
-#ifndef NCACHE
-      c->search = 0;
+      else if (size == 2)
+	{
+	  add_new_binary_and_watch_it (solver, false);
+#ifdef LOGGING
+	  const unsigned lit = ACCESS (solver->clause, 0);
+	  const unsigned other = ACCESS (solver->clause, 1);
+	  LOGBIN (false, lit, other, "imported");
 #endif
-      if (c->redundant
-#ifndef NGLUE
-	  && c->glue >= new_size
+	}
 #endif
-	)
-	promote_clause (solver, c, new_size - 1);
-      if (!c->shrunken)
+      else
 	{
-	  c->shrunken = true;
-	  lits[old_size - 1] = INVALID;
-	}
-      LOGCLS (c, "vivification shrunken candidate");
-      trace_and_check_clause_addition (solver, c, INVALID);
-      trace_and_check_deletion (solver, SIZE_STACK (solver->clause),
-				solver->clause.begin);
-#ifdef NWATCHES
-      connect_clause (solver, c);
-      count_clause (solver, c);
+	  struct clause *clause = new_irredundant_clause (solver);
+	  LOGCLS (clause, "imported");
+#ifndef NWATCHES
+	  watch_clause (solver, clause);
+#else
+	  connect_clause (solver, clause);
+	  count_clause (solver, clause);
 #endif
+	}
+
+      const size_t added = SIZE_STACK (solver->added);
+      assert (size <= added);
 
+      if (size < added)
+	{
+	  trace_and_check_temporary_addition (solver);
+	  remove_original_clause = true;
+	}
+      else
+	remove_original_clause = false;
     }
+  else
+    remove_original_clause = true;
+
   CLEAR_STACK (solver->clause);
-  return false;
+  if (remove_original_clause)
+    {
+      if (solver->proof)
+	{
+	  start_deletion_proof_line (solver);
+	  for (all_elements_on_stack (int, lit, solver->added))
+	      add_external_literal_to_proof_line (solver, lit);
+	  end_proof_line (solver);
+	}
+#ifndef NDEBUG
+      for (all_elements_on_stack (int, lit, solver->added))
+	  checker_add_literal (solver->checker, lit);
+      checker_delete_clause (solver->checker);
+#endif
+    }
+  CLEAR_STACK (solver->added);
 }
 
+/*------------------------------------------------------------------------*/
+#ifndef NELIMINATION
+/*------------------------------------------------------------------------*/
+
+// Incrementally added clauses and assumptions might contain eliminated
+// variables.  Those are reactivated and all their clauses saved on the
+// extension stack are removed from it and added back as irredundant
+// clauses.  This might in turn reactivate further eliminated variables
+// occurring in restored clauses and thus we restore until completion.
+
 static void
-schedule_vivification_candidates (struct satch *solver, unsigned *counts
-#ifdef LOGGING
-				  , const char *type
-#endif
-				  , bool redundant
-#ifndef NTIER2
-				  , bool tier2
-#endif
-  )
+reactivate_variable (struct satch *solver, unsigned idx)
 {
-  unsigned lower_glue_limit, upper_glue_limit;
-#ifndef NTIER2
-  if (tier2)
-    {
-      lower_glue_limit = tier1_glue_limit + 1;
-      upper_glue_limit = tier2_glue_limit;
-    }
-  else
+  struct flags *f = solver->flags + idx;
+  assert (f->eliminated);
+  assert (!f->active);
+  assert (!solver->values[LITERAL (idx)]);
+  f->eliminated = false;
+  f->active = true;
+#ifndef NSUBSUMPTION
+  f->subsume = 1;
+  INC (marked_subsume);
 #endif
-#ifndef NTIER1
-    {
-      lower_glue_limit = 0;
-      upper_glue_limit = tier1_glue_limit;
-    }
+  f->eliminate = true;
+  INC (marked_eliminate);
+  solver->statistics.remaining++;
+  INC (reactivated);
+  LOG ("reactivated %s", LOGVAR (idx));
+}
+
+// Substituted variables are treated as eliminated variables too.
+
+static bool
+eliminated_variables (struct satch *solver)
+{
+  const struct statistics *const statistics = &solver->statistics;
+  uint64_t eliminated = statistics->eliminated;
+#ifndef NPROBING
+  eliminated += statistics->substituted;
 #endif
-#if (defined(NTIER1) && defined(NTIER2)) || defined(NGLUE)
+  return eliminated != statistics->reactivated;
+}
+
+static bool
+reactivate_literals (struct satch *solver)
+{
+  const struct flags *const flags = solver->flags;
+  bool res = false;
+  for (all_elements_on_stack (unsigned, lit, solver->clause))
     {
-      lower_glue_limit = 0;
-      upper_glue_limit = 10;
+      const unsigned idx = INDEX (lit);
+      if (!flags[idx].eliminated)
+	continue;
+      reactivate_variable (solver, idx);
+      res = true;
     }
+  return res;
+}
 
-#endif
-  size_t prioritized = 0;
-  for (unsigned prioritize = 0; prioritize < 2; prioritize++)
+static void
+restore_clauses (struct satch *solver)
+{
+  assert (!solver->level);
+  const struct flags *const flags = solver->flags;
+  struct unsigned_stack *const extend = &solver->extend;
+  struct unsigned_stack restored;
+  INIT_STACK (restored);
+
+  // Remove all clauses with a reactivated witness from the extension stack
+  // and save them on the 'restored' stack (followed by 'INVALID').
+
+  bool reactivated;
+  do
     {
-      if (!redundant)
+      reactivated = false;
+      const unsigned *const end = extend->end;
+      const unsigned *p = extend->begin;
+      unsigned *q = extend->begin;
+      while (p != end)
 	{
-	  for (all_irredundant_clauses (c))
+	  const unsigned *c = p;
+	  assert (*p == INVALID);
+	  assert (p + 1 != end);
+	  const unsigned witness = *++p;
+	  while (p != end && *p != INVALID)
+	    p++;
+	  if (flags[INDEX (witness)].eliminated)
 	    {
-	      if (c->garbage)
-		continue;
-	      if (c->redundant)
-		continue;
-#ifdef NVIRTUAL
-	      if (c->size == 2)
-		continue;
-#endif
-	      if (c->vivify != prioritize)
-		{
-		  continue;
-		}
-	      if (simplify_vivification_candidate (solver, c))
-		continue;
-	      if (prioritize)
-		prioritized++;
-	      vivify_count_clause (c, counts);
-	      PUSH (solver->vivification_schedule, c);
+	      while (c != p)
+		*q++ = *c++;
+	      continue;
 	    }
-	}
-      else
-	{
-	  for (all_redundant_clauses (c))
+	  while (++c != p)
 	    {
-	      if (c->garbage)
-		continue;
-	      if (!c->redundant)
-		continue;
-#ifdef NVIRTUAL
-	      if (c->size == 2)
-		continue;
-#endif
-
-#if !(defined(NTIER1) && defined(NTIER2)) && !defined(NGLUE)
-	      if (c->glue < lower_glue_limit)
-		continue;
-	      if (c->glue > upper_glue_limit)
-		continue;
-#else
-	      if (c->size < lower_glue_limit)
-		continue;
-	      if (c->size > upper_glue_limit)
-		continue;
-#endif
-	      if (c->vivify != prioritize)
-		{
-		  continue;
-		}
-	      if (simplify_vivification_candidate (solver, c))
+	      const unsigned lit = *c;
+	      const unsigned idx = INDEX (lit);
+	      PUSH (restored, lit);
+	      if (!flags[idx].eliminated)
 		continue;
-	      if (prioritize)
-		prioritized++;
-	      vivify_count_clause (c, counts);
-	      PUSH (solver->vivification_schedule, c);
+	      reactivate_variable (solver, idx);
+	      reactivated = true;
 	    }
+	  PUSH (restored, INVALID);
 	}
+      extend->end = q;
     }
+  while (reactivated);
 
-#ifdef LOGGING
-  size_t scheduled = SIZE_STACK (solver->vivification_schedule);
-#endif
-  if (prioritized)
-    {
-      LOG ("prioritized %zu %s clauses %.0f%%", prioritized,
-	   type, percent (prioritized, scheduled));
-    }
-  else
+  // Then add restored clauses as irredundant clauses through 'import_clause'
+  // after saving the temporary clause which triggered restoring clauses.
+
+  const struct unsigned_stack saved_clause = solver->clause;
+  const struct int_stack saved_added = solver->added;
+  INIT_STACK (solver->clause);
+  INIT_STACK (solver->added);
+
+  size_t clauses = 0;
+  for (all_elements_on_stack (unsigned, lit, restored))
     {
-      LOG ("prioritized all %zu clauses %s", scheduled, type);
-      for (all_pointers_on_stack
-	   (struct clause, c, solver->vivification_schedule))
+      if (solver->inconsistent)
+	break;
+      if (lit != INVALID)
 	{
-#ifndef NVIRTUAL
-	  assert (!is_tagged_clause (c));
-#endif
-	  c->vivify = true;
+	  PUSH (solver->clause, lit);
+	  PUSH (solver->added, export_literal (lit));
+	  continue;
 	}
+      if (solver->proof)
+	{
+	  start_addition_proof_line (solver);
+	  for (all_elements_on_stack (int, elit, solver->added))
+	      add_external_literal_to_proof_line (solver, elit);
+	  end_proof_line (solver);
+	}
+      LOGTMP ("restored");
+      import_clause (solver);
+      clauses++;
     }
+  message (solver, 3, "restore", solver->statistics.reactivated,
+	   "restored %zu clauses", clauses);
+
+  RELEASE_STACK (solver->clause);
+  RELEASE_STACK (solver->added);
+  solver->clause = saved_clause;
+  solver->added = saved_added;
+  RELEASE_STACK (restored);
 }
 
-enum round
-{
-#if (defined(NTIER1) && defined(NTIER1)) || defined(NGLUE)
-  REDUNDANT_ROUND = 0,
-#endif
-#ifndef NTIER1
-  REDUNDANT_TIER1_ROUND = 1,
-#endif
-#ifndef NTIER2
-  REDUNDANT_TIER2_ROUND = 2,
+/*------------------------------------------------------------------------*/
 #endif
-  IRREDUNDANT_ROUND = 3
-};
+/*------------------------------------------------------------------------*/
 
-static size_t
-vivify_round (struct satch *solver, unsigned round, uint64_t delta,
-	      double effort)
+static void
+internal_add (struct satch *solver, int elit)
 {
-  assert (EMPTY_STACK (solver->vivification_schedule));
-  char tag;
-#ifdef LOGGING
-  const char *type;
-#if (defined (NTIER1) && defined (NTIER2)) || defined(NGLUE)
-  if (round == REDUNDANT_ROUND)
+  // If an empty clause has been added or derived we do not need to add
+  // anything and just return for the rest of time this solver is used.
+
+  if (solver->inconsistent)
+    return;
+
+  if (elit)
     {
-      type = "redundant";
-      tag = 'u';
+      // Add the literal to the internal temporary 'clause' after importing
+      // it, i.e., adjusting the 'size' (number of active variables) if its
+      // variable has never been seen before.  Also turn the external signed
+      // DIMACS 'int' literal into and internal 'unsigned' literal.
+
+      const unsigned ilit = import_literal (solver, elit);
+      PUSH (solver->clause, ilit);
+      PUSH (solver->added, elit);
     }
   else
-#endif
-#ifndef NTIER2
-  if (round == REDUNDANT_TIER2_ROUND)
     {
-      type = "redundant";
-      tag = 'u';
-    }
-  else
+#ifndef NELIMINATION
+      // Only look for eliminated variables if there are any left.
+
+      if (eliminated_variables (solver) && reactivate_literals (solver))
+	restore_clauses (solver);
+      if (solver->inconsistent)
+	{
+	  CLEAR_STACK (solver->clause);
+	  CLEAR_STACK (solver->added);
+	  return;
+	}
 #endif
-#ifndef NTIER1
-  if (round == REDUNDANT_TIER1_ROUND)
+      import_clause (solver);
+    }
+}
+
+// Adding a whole clause at once avoids the per literal overhead of
+// 'internal_add' (checking for inconsistency, the solver size and pushing
+// on the two temporary stacks).  The caller has to make sure that the
+// solver is large enough and enough space is reserved on these stacks.
+
+static void
+internal_add_clause (struct satch *solver, const int *literals, size_t size)
+{
+  if (solver->inconsistent)
+    return;
+  assert (EMPTY_STACK (solver->clause));
+  assert (EMPTY_STACK (solver->added));
+  assert (CAPACITY_STACK (solver->clause) >= size);
+  assert (CAPACITY_STACK (solver->added) >= size);
+  unsigned *q = solver->clause.begin;
+  const int *const end = literals + size;
+  for (const int *p = literals; p != end; p++)
     {
-      type = "redundant";
-      tag = 'v';
+      const int elit = *p;
+      assert ((unsigned) abs (elit) <= solver->size);
+      unsigned ilit = LITERAL (abs (elit) - 1);
+      if (elit < 0)
+	ilit = NOT (ilit);
+      *q++ = ilit;
     }
-  else
-#endif
+  solver->clause.end = q;
+  memcpy (solver->added.begin, literals, size * sizeof *literals);
+  solver->added.end = solver->added.begin + size;
+  LOGTMP ("added");
+  internal_add (solver, 0);
+}
+
+// Add the clauses of the direct CNF encoding of the XOR constraint over the
+// (at most two) variables of the literals in the temporary clause, i.e.,
+// those clauses with an odd number of negations if 'parity' is unset and
+// an even number otherwise.
+
+static void
+import_xor_clauses (struct satch *solver, bool parity)
+{
+  const size_t size = SIZE_STACK (solver->clause);
+  assert (size <= 2);
+  unsigned variables[2];
+  memcpy (variables, solver->clause.begin, size * sizeof *variables);
+  for (unsigned pattern = 0; pattern != 1u << size; pattern++)
     {
-      assert (round == IRREDUNDANT_ROUND);
-      type = "irredundant";
-      tag = 'w';
+      bool negations = false;
+      for (unsigned i = 0; i < size; i++)
+	if (pattern & (1u << i))
+	  negations = !negations;
+      if (negations == parity)
+	continue;
+      CLEAR_STACK (solver->clause);
+      CLEAR_STACK (solver->added);
+      for (unsigned i = 0; i < size; i++)
+	{
+	  unsigned lit = variables[i];
+	  if (pattern & (1u << i))
+	    lit = NOT (lit);
+	  PUSH (solver->clause, lit);
+	  PUSH (solver->added, export_literal (lit));
+	}
+      LOGTMP ("XOR encoding");
+      if (!solver->inconsistent)
+	import_clause (solver);
     }
-#else
-#if (defined (NTIER1) && defined (NTIER2)) || defined(NGLUE)
-  if (round == REDUNDANT_ROUND)
+}
+
+// Add the XOR constraint over the literals in the temporary 'clause' stack
+// (with its external literals on the 'added' stack).  Negative literals
+// flip the parity as well as root-level true variables, while root-level
+// assigned variables are removed and duplicated variables cancel out each
+// other.  Then constraints over at most two variables are added as clauses
+// and only the others natively.
+
+static void
+import_xor (struct satch *solver)
+{
+  assert (!solver->inconsistent);
+  assert (!solver->level);
+#ifndef NDEBUG
+  for (all_elements_on_stack (int, lit, solver->added))
+      PUSH (solver->original_xors, lit);
+  PUSH (solver->original_xors, 0);
+#endif
+  signed char *const marks = solver->marks;
+  const signed char *const values = solver->values;
+  bool parity = true;
+  for (all_elements_on_stack (unsigned, lit, solver->clause))
     {
-      tag = 'u';
+      const unsigned idx = INDEX (lit);
+      const signed char value = values[LITERAL (idx)];
+      if (SIGN_BIT (lit))
+	parity = !parity;
+      if (value > 0)
+	parity = !parity;
+      else if (!value)
+	marks[idx] = !marks[idx];
     }
-  else
-#endif
-#ifndef NTIER2
-  if (round == REDUNDANT_TIER2_ROUND)
+  unsigned *q = solver->clause.begin;
+  for (all_elements_on_stack (unsigned, lit, solver->clause))
     {
-      tag = 'u';
+      const unsigned idx = INDEX (lit);
+      if (!marks[idx])
+	continue;
+      marks[idx] = 0;
+      *q++ = LITERAL (idx);
     }
-  else
-#endif
-#ifndef NTIER1
-  if (round == REDUNDANT_TIER1_ROUND)
+  solver->clause.end = q;
+
+  const size_t size = SIZE_STACK (solver->clause);
+  LOGTMP ("imported %s parity XOR", parity ? "odd" : "even");
+
+  if (!size)
     {
-      tag = 'v';
+      if (parity)
+	{
+	  LOG ("empty thus inconsistent imported XOR");
+#ifndef NDEBUG
+	  checker_add_original_clause (solver->checker);
+#endif
+	  solver->inconsistent = true;
+	}
     }
+  else if (size <= 2)
+    import_xor_clauses (solver, parity);
   else
-#endif
     {
-      assert (round == IRREDUNDANT_ROUND);
-      tag = 'w';
-    }
+      activate_literals (solver);
+      const size_t bytes = sizeof (struct xor) +
+	(size - 2) * sizeof (unsigned);
+      struct xor *x = malloc (bytes);
+      if (!x)
+	out_of_memory (bytes);
+      x->parity = parity;
+#ifndef NDEBUG
+      x->checked = false;
 #endif
-
-  flush_large_watches (solver);
-#ifndef NVIVIFICATIONLIMITS
-  const uint64_t scaled = effort * delta;
-  uint64_t start = solver->statistics.probing_ticks;
-  const uint64_t ticks_limit = start + scaled;
+      x->size = size;
+      x->reason = new_xor_reason (size);
+      struct flags *const flags = solver->flags;
+      for (unsigned i = 0; i < size; i++)
+	{
+	  const unsigned idx = INDEX (ACCESS (solver->clause, i));
+	  x->variables[i] = idx;
+	  flags[idx].xors = true;
+	}
+      if (!solver->xor_watches)
+	{
+#ifndef MAPPED
+	  const size_t watches_bytes =
+	    solver->capacity * sizeof *solver->xor_watches;
+	  if (!(solver->xor_watches = calloc (1, watches_bytes)))
+	    out_of_memory (watches_bytes);
 #else
-  (void) effort;
-  (void) delta;
-  const uint64_t ticks_limit = UINT64_MAX;
+	  const size_t watches_bytes =
+	    solver->mapped * sizeof *solver->xor_watches;
+	  solver->xor_watches = map_chunk (watches_bytes);
 #endif
-  bool redundant, tier2;
-#if defined(NGLUE)
-  if (round == REDUNDANT_ROUND)
-    {
-      redundant = true;
+	}
+      PUSH (solver->xor_watches[x->variables[0]], x);
+      PUSH (solver->xor_watches[x->variables[1]], x);
+      PUSH (solver->xors, x);
     }
-  else
-#endif
-#if (defined (NTIER1) && defined (NTIER2)) || defined(NGLUE)
-  if (round == REDUNDANT_ROUND)
+
+  CLEAR_STACK (solver->clause);
+  CLEAR_STACK (solver->added);
+}
+
+// Import the external literals of an XOR constraint to the temporary
+// 'clause' and 'added' stacks and reactivate eliminated variables first.
+
+static void
+internal_add_xor (struct satch *solver, const int *literals, size_t size)
+{
+  if (solver->inconsistent)
+    return;
+  INC (xors);
+  assert (EMPTY_STACK (solver->clause));
+  assert (EMPTY_STACK (solver->added));
+  const int *const end = literals + size;
+  for (const int *p = literals; p != end; p++)
     {
-       redundant = true;
+      const int elit = *p;
+      PUSH (solver->clause, import_literal (solver, elit));
+      PUSH (solver->added, elit);
     }
-  else
-#endif
-#ifndef NTIER1
-  if (round == REDUNDANT_TIER1_ROUND)
-    redundant = true, tier2 = false;
-  else
-#endif
-#ifndef NTIER2
-  if (round == REDUNDANT_TIER2_ROUND)
-    redundant = tier2 = true;
-  else
-#endif
+#ifndef NELIMINATION
+  if (eliminated_variables (solver) && reactivate_literals (solver))
+    restore_clauses (solver);
+  if (solver->inconsistent)
     {
-      assert (round == IRREDUNDANT_ROUND);
-      redundant = tier2 = false;
+      CLEAR_STACK (solver->clause);
+      CLEAR_STACK (solver->added);
+      return;
     }
+#endif
+  import_xor (solver);
+}
 
-  unsigned *counts = calloc (LITERALS, sizeof (unsigned));
+// Check literals of clauses to be added in bulk and return the first
+// invalid literal (or zero).  Also determine the maximum variable index and
+// the maximum clause size, which are returned through the pointers.
 
-  if (!counts)
-    fatal_error ("could not allocate counts for vivification");
-  struct clauses *schedule = &solver->vivification_schedule;
+static const int *
+check_bulk_literals (const int *literals, size_t size,
+		     int *max_idx_ptr, size_t *max_size_ptr)
+{
+  const int *const end = literals + size;
+  const int *clause = literals;
+  size_t max_size = 0;
+  int max_idx = 0;
+  for (const int *p = literals; p != end; p++)
+    {
+      const int elit = *p;
+      if (elit == INT_MIN)
+	return p;
+      if (elit)
+	{
+	  const int idx = abs (elit);
+	  if (sizeof (void *) <= 4 && idx > (1 << 29))
+	    return p;
+	  if (idx > max_idx)
+	    max_idx = idx;
+	}
+      else
+	{
+	  const size_t clause_size = p - clause;
+	  if (clause_size > max_size)
+	    max_size = clause_size;
+	  clause = p + 1;
+	}
+    }
+  const size_t clause_size = end - clause;
+  if (clause_size > max_size)
+    max_size = clause_size;
+  *max_idx_ptr = max_idx;
+  *max_size_ptr = max_size;
+  return 0;
+}
 
+// Resize the solver and reserve space for bulk adding clauses.
 
-  schedule_vivification_candidates (solver, counts,
-#ifdef LOGGING
-				    type,
-#endif
-				    redundant
-#ifndef NTIER2
-				    , tier2
-#endif
-    );
-  const size_t scheduled = SIZE_STACK (*schedule);
-#ifdef LOGGING
-  const size_t total =
-    (round ==
-     IRREDUNDANT_ROUND) ? solver->statistics.irredundant : solver->statistics.
-    redundant;
+static void
+reserve_bulk (struct satch *solver, int max_idx, size_t max_size,
+	      size_t literals)
+{
+  if ((unsigned) max_idx > solver->size)
+    increase_size (solver, max_idx);
+  RESERVE_STACK (solver->clause, max_size);
+  RESERVE_STACK (solver->added, max_size);
+#ifndef NDEBUG
+  RESERVE_STACK (solver->original, literals);
+#else
+  (void) literals;
 #endif
+}
 
-  LOG ("scheduled %zu %s clauses %.0f%% of %zu", scheduled, type,
-       percent (scheduled, total), total);
-  size_t vivified = 0, tried = 0;
+/*------------------------------------------------------------------------*/
 
-  sort_vivification_candidates (solver, schedule, counts);
-  watch_large_clauses (solver);
+#ifndef NPORTFOLIO
 
-  while (!EMPTY_STACK (*schedule))
+// The copied model is not on the trail and thus not removed by
+// backtracking.  Before the next change we reset all values and only
+// reassign the root-level units on the trail of this solver.
+
+static void
+reset_copied_assignment (struct satch *solver)
+{
+  assert (solver->copied);
+  assert (!solver->level);
+  LOG ("resetting copied assignment");
+  signed char *const values = solver->values;
+  memset (values, 0, 2 * (size_t) solver->size);
+  for (all_elements_on_stack (unsigned, lit, solver->trail))
     {
-      if (solver->statistics.probing_ticks > ticks_limit)
-	break;
-      struct clause *c = POP (*schedule);
-      if (c->garbage)
-	continue;
-      tried++;
-      if (vivify_clause (solver, c, counts))
-	++vivified;
-      c->vivify = false;
-      if (solver->inconsistent)
-	break;
+      values[lit] = 1;
+      values[NOT (lit)] = -1;
     }
+  solver->copied = false;
+}
+
+#endif
 
+// After solving the model, the failed assumptions and the status are kept
+// until the user adds clauses, assumes literals or solves again.  Then we
+// backtrack to the root-level and reset the status and all assumptions.
+
+static void
+reset_after_solving (struct satch *solver)
+{
+  if (!solver->reset)
+    return;
+  LOG ("resetting solver after solving");
   if (solver->level)
     backtrack (solver, 0);
-  if (!solver->inconsistent)
+#ifndef NPORTFOLIO
+  if (solver->copied)
+    reset_copied_assignment (solver);
+#endif
+  solver->status = 0;
+  struct flags *const flags = solver->flags;
+  for (all_elements_on_stack (unsigned, lit, solver->assumptions))
     {
-      size_t remain = SIZE_STACK (*schedule);
-      const bool keep = true;
-      size_t prioritized = 0;
-      if (remain)
-	{
-	  while (!EMPTY_STACK (*schedule))
-	    {
-	      struct clause *c = POP (*schedule);
-	      if (!c->vivify)
-		continue;
-	      prioritized++;
-	      if (!keep)
-		c->vivify = false;
-	    }
-	  if (!prioritized)
-	    LOG ("no prioritized %s clauses left", type);
-	  else if (keep)
-	    LOG ("keeping %zu %s clauses prioritized %.0f%%",
-		 prioritized, type, percent (prioritized, remain));
-	}
-      else
-	LOG ("all scheduled %s clauses tried", type);
+      struct flags *f = flags + INDEX (lit);
+      f->assumed = false;
+      f->failed = 0;
     }
+  CLEAR_STACK (solver->assumptions);
+  solver->assumption_level = 0;
+  solver->assumed = 0;
+  solver->reset = false;
+}
 
-  CLEAR_STACK (*schedule);
-  assert (EMPTY_STACK (solver->clause));
+// Assumptions are only valid for the next call to 'satch_solve' and
+// assumed variables are frozen, i.e., they are not eliminated.  If they
+// were eliminated before, they are reactivated and their clauses restored.
 
-  report (solver, 1, tag);
-  free (counts);
-  return scheduled;
+static void
+internal_assume (struct satch *solver, int elit)
+{
+  assert (!solver->level);
+  const unsigned ilit = import_literal (solver, elit);
+  const unsigned idx = INDEX (ilit);
+  struct flags *f = solver->flags + idx;
+#ifndef NELIMINATION
+  if (f->eliminated)
+    {
+      reactivate_variable (solver, idx);
+      restore_clauses (solver);
+    }
+  else
+#endif
+  if (!f->active && !f->fixed)
+    activate_literal (solver, ilit);
+  LOG ("assuming %s", LOGLIT (ilit));
+  f->assumed = true;
+  PUSH (solver->assumptions, ilit);
 }
 
-#if (defined(NTIER1) && defined(NTIER1)) || defined(NGLUE)
-static size_t
-vivify_redundant (struct satch *solver, uint64_t delta, double effort)
+/*------------------------------------------------------------------------*/
+
+// Set the status after solving and if satisfiable extend and check the
+// witness (shared by sequential and portfolio solving).
+
+static int
+set_status (struct satch *solver, int res)
 {
-  return vivify_round (solver, REDUNDANT_ROUND, delta, effort);
-}
+  LOG ("internal solving procedure returns '%d'", res);
+  solver->status = res;
+  solver->reset = true;
+  if (res == 10)
+    {
+#ifndef NELIMINATION
+      extend_solution (solver);
 #endif
-#ifndef NTIER1
-static size_t
-vivify_redundant_tier1 (struct satch *solver, uint64_t delta, double effort)
-{
-  return vivify_round (solver, REDUNDANT_TIER1_ROUND, delta, effort);
-}
+
+#ifndef NDEBUG
+      check_witness (solver);
 #endif
+    }
+  return res;
+}
+
+/*------------------------------------------------------------------------*/
+#ifndef NPORTFOLIO
+/*------------------------------------------------------------------------*/
 
-#ifndef NTIER2
-static size_t
-vivify_redundant_tier2 (struct satch *solver, uint64_t delta, double effort)
+// Portfolio workers beside the first one (which uses the solver of the
+// caller) get a copy of the formula of the first solver added through
+// 'internal_add'.  Since this is only done before solving the formula
+// consists of root-level units on the trail, virtual binary clauses in
+// watch lists (unless 'NVIRTUAL' is defined) and the irredundant clauses.
+// As internal variable indices are just external indices minus one the
+// clone uses the same internal literals, which allows to share clauses
+// between workers without mapping literals.
+
+static void
+copy_literals (struct satch *clone, size_t size, unsigned *literals)
 {
-  return vivify_round (solver, REDUNDANT_TIER2_ROUND, delta, effort);
+  for (all_elements_in_array (unsigned, lit, size, literals))
+      internal_add (clone, export_literal (lit));
+  internal_add (clone, 0);
 }
-#endif
 
 static void
-vivify_irredundant (struct satch *solver, uint64_t redundant_scheduled,
-		    uint64_t delta, double effort)
+copy_formula (struct satch *solver, struct satch *clone)
 {
-
-  const double factor = 10;
-  const uint64_t limit = factor * redundant_scheduled;
-  uint64_t irredundant_candidates = 0;
-
-  for (all_irredundant_clauses (c))
+  assert (!solver->level);
+  assert (!solver->dense);
+  if (solver->inconsistent)
     {
-      assert (!c->redundant);
-      if (c->garbage)
-	continue;
-      else if (++irredundant_candidates > limit)
-	break;
+      internal_add (clone, 0);
+      return;
     }
-
-  if (irredundant_candidates > limit)
-    LOG ("skipping %" PRIu64 " vivify-irredundant "
-	 "candidates > limit %" PRIu64 " = %g * %" PRIu64
-	 " scheduled redundant clauses",
-	 irredundant_candidates, limit, factor, redundant_scheduled);
-  else
+  for (all_elements_on_stack (unsigned, lit, solver->trail))
+      copy_literals (clone, 1, &lit);
+#ifndef NVIRTUAL
+  for (all_literals (lit))
     {
-      LOG ("vivify-irredundant with "
-	   "%" PRIu64 " candidates <= %" PRIu64
-	   " = %g * %" PRIu64 " scheduled redundant clauses",
-	   irredundant_candidates, limit, factor, redundant_scheduled);
-      if (irredundant_candidates > redundant_scheduled)
+      const struct watches *const watches = solver->watches + lit;
+      const union watch *const end = watches->end;
+      for (const union watch * p = watches->begin; p != end; p++)
 	{
-	  LOG ("not sorting %" PRIu64
-	       " vivify-irredundant candidates > %" PRIu64
-	       " scheduled redundant clauses",
-	       irredundant_candidates, redundant_scheduled);
+	  const struct header header = p->header;
+	  if (header.binary)
+	    {
+	      const unsigned other = header.blocking;
+	      if (lit < other && !header.redundant)
+		{
+		  unsigned literals[2] = { lit, other };
+		  copy_literals (clone, 2, literals);
+		}
+	    }
+#ifdef NPACKED
+	  else
+	    p++;
+#endif
 	}
-
-      (void) vivify_round (solver, IRREDUNDANT_ROUND, delta, effort);
     }
+#endif
+  for (all_irredundant_clauses (c))
+    if (!c->garbage)
+      copy_literals (clone, c->size, c->literals);
 }
 
-static uint64_t
-vivify_adjustment (struct satch *solver)
+#ifndef NLAZYACTIVATION
+
+// Simple linear congruential generator (as in Knuth's MMIX).
+
+static unsigned
+random_modulo (uint64_t * state, unsigned mod)
 {
-  return nlogn (1 + solver->statistics.irredundant +
-		solver->statistics.redundant);
+  assert (mod);
+  *state = *state * 6364136223846793005ul + 1442695040888963407ul;
+  return (*state >> 32) % mod;
 }
 
-static bool
-really_vivify (struct satch *solver)
+static void
+shuffle_stack (uint64_t * state, struct unsigned_stack *stack)
 {
-  const uint64_t limit = vivify_adjustment (solver);
-  const uint64_t search_ticks = solver->statistics.ticks;
-  return limit < search_ticks;
+  unsigned *const begin = stack->begin;
+  const size_t size = SIZE_STACK (*stack);
+  for (size_t i = size; i > 1; i--)
+    {
+      const unsigned j = random_modulo (state, i);
+      const unsigned tmp = begin[i - 1];
+      begin[i - 1] = begin[j];
+      begin[j] = tmp;
+    }
 }
 
+#endif
 
+// Workers are diversified by their identifier.  Odd workers start in
+// stable mode, every second pair of workers uses the opposite original
+// phase and all but the first worker shuffle the initial decision order,
+// which otherwise follows the order in which variables were activated.
 
-#define MINEFFORT 1e4
-
-
-#define VIVIFYTIER1 3
-#define VIVIFYTIER2 6
-#define VIVIFYIRREDUNDANT 1
-#define VIVIFYEFFORT 100*1e-3
-
-static int
-vivify (struct satch *solver)
+static void
+diversify_worker (struct satch *clone, unsigned id)
 {
-  if (solver->inconsistent)
-    return 20;
-
-  if (solver->level)
-    update_phases_and_backtrack_to_root_level (solver);
-  assert (!solver->level);
-  assert (!solver->dense);
-
-  const uint64_t vivifications = INC (vivifications);
-
-#ifndef NLIMITS
-  // Update vivification limit for next time
-  const uint64_t interval =
-    scale_interval (vivification_interval, nlogn, vivifications);
-  struct limits *const limits = &solver->limits;
-  limits->vivify.conflicts = CONFLICTS + interval;
+  assert (id);
+#ifndef NSWITCH
+  if (id & 1)
+    {
+      clone->options.stable = true;
+      clone->stable = true;
+      init_stable_mode (clone);
+    }
+#endif
+  if (id & 2)
+    clone->options.phase = -original_phase (clone);
+  uint64_t seed = clone->options.seed = id;
+#ifndef NLAZYACTIVATION
+#ifndef NFOCUSED
+  shuffle_stack (&seed, &clone->put[0]);
 #endif
+#ifndef NSTABLE
+  shuffle_stack (&seed, &clone->put[1]);
+#endif
+#endif
+  (void) seed;
+}
 
-  if (!solver->statistics.redundant)
-    return 0;
-  if (!really_vivify (solver))
-    return 0;
+// The first worker returning with a result wins and stops the others.
+// Only the first worker runs in the calling thread and polls the terminate
+// call-back.  If its termination is forced it stops the others too.
 
-  START (vivify);
+static void *
+run_worker (void *ptr)
+{
+  struct worker *const worker = ptr;
+  const int res = solve (worker->solver, worker->limit);
+  worker->res = res;
+  if (res)
+    {
+      struct portfolio *const portfolio = worker->portfolio;
+      int expected = -1;
+      if (__atomic_compare_exchange_n (&portfolio->winner, &expected,
+				       (int) worker->id, false,
+				       __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+	__atomic_store_n (&portfolio->stop, true, __ATOMIC_RELAXED);
+    }
+  else if (!worker->id && worker->solver->terminate.forced)
+    __atomic_store_n (&worker->portfolio->stop, true, __ATOMIC_RELAXED);
+  return 0;
+}
 
-  solver->vivifying = true;
+static void
+init_worker (struct satch *solver, struct portfolio *portfolio,
+	     unsigned id, int conflict_limit)
+{
+  struct worker *const worker = portfolio->workers + id;
+  worker->id = id;
+  worker->limit = conflict_limit;
+  worker->portfolio = portfolio;
+  worker->imported = calloc (portfolio->size, sizeof *worker->imported);
+  if (!worker->imported)
+    out_of_memory (portfolio->size * sizeof *worker->imported);
+  struct satch *clone;
+  if (id)
+    {
+      clone = internal_init ();
+      copy_formula (solver, clone);
+      diversify_worker (clone, id);
+      clone->terminate.ticks = solver->terminate.ticks;
+      clone->terminate.seconds = solver->terminate.seconds;
+    }
+  else
+    clone = solver;
+  worker->import = clone->statistics.conflicts + import_interval;
+  worker->solver = clone;
+  clone->worker = worker;
+}
 
-#ifndef NVIVIFICATIONLIMITS
-  const struct statistics *const statistics = &solver->statistics;
-  const uint64_t last = statistics->ticks - limits->vivify.search;
-  const uint64_t ticks = last < MINEFFORT ? MINEFFORT : last;
-  const uint64_t adjustment = vivify_adjustment (solver);
-  const uint64_t delta = ticks * VIVIFYEFFORT + adjustment;
-#else
-  const uint64_t delta = UINT64_MAX;
+// Copy the assignment of the winning worker to the first solver.  The
+// first solver might have stopped at some decision level and thus we need
+// to backtrack first (root-level units are the same for all workers).
+
+static void
+copy_assignment (struct satch *solver, struct satch *winner)
+{
+#ifndef NELIMINATION
+  extend_solution (winner);
 #endif
+  if (solver->level)
+    backtrack (solver, 0);
+  const unsigned size =
+    solver->size < winner->size ? solver->size : winner->size;
+  memcpy (solver->values, winner->values, 2 * (size_t) size);
+  solver->copied = true;
+}
 
-  message (solver, 2, "vivification", vivifications,
-	   "elimination limit of %" PRIu64 " ticks = %g * search ticks %"
-	   PRIu64, TICKS + delta, (double) VIVIFYEFFORT, delta);
-  uint64_t redundant_scheduled = 0;
-  double sum = VIVIFYTIER1 + VIVIFYTIER2 + VIVIFYIRREDUNDANT;
+static int
+solve_parallel (struct satch *solver, unsigned threads, int conflict_limit)
+{
+  struct portfolio portfolio;
+  portfolio.size = threads;
+  portfolio.winner = -1;
+  portfolio.stop = false;
+  portfolio.workers = calloc (threads, sizeof *portfolio.workers);
+  if (!portfolio.workers)
+    out_of_memory (threads * sizeof *portfolio.workers);
+  for (unsigned id = 0; id != threads; id++)
+    init_worker (solver, &portfolio, id, conflict_limit);
+  message (solver, 1, "portfolio", threads,
+	   "solving with %u worker threads", threads);
+  for (unsigned id = 1; id != threads; id++)
+    {
+      struct worker *const worker = portfolio.workers + id;
+      if (pthread_create (&worker->thread, 0, run_worker, worker))
+	fatal_error ("failed to create worker thread %u", id);
+    }
+  run_worker (portfolio.workers);
+  for (unsigned id = 1; id != threads; id++)
+    if (pthread_join (portfolio.workers[id].thread, 0))
+      fatal_error ("failed to join worker thread %u", id);
+  int res = 0;
+  const int winner = portfolio.winner;
+  if (winner >= 0)
+    {
+      struct worker *const worker = portfolio.workers + winner;
+      res = worker->res;
+      message (solver, 1, "portfolio", threads,
+	       "worker %d wins with result %d", winner, res);
+      if (winner && res == 10)
+	copy_assignment (solver, worker->solver);
+    }
+  for (unsigned id = 0; id != threads; id++)
+    {
+      struct worker *const worker = portfolio.workers + id;
+      if (id)
+	internal_release (worker->solver);
+      free (worker->imported);
+    }
+  free (portfolio.workers);
+  solver->worker = 0;
+  return res;
+}
 
-#ifndef NVIVIFICATIONLIMITS
-  const uint64_t vivified = solver->statistics.vivified;
-#endif
-#if (defined(NTIER1) && defined(NTIER1)) || defined(NGLUE)
-  redundant_scheduled += vivify_redundant (solver, delta, VIVIFYTIER2 / sum);
-#endif
-#ifndef NTIER2
-  redundant_scheduled +=
-    vivify_redundant_tier2 (solver, delta, VIVIFYTIER2 / sum);
+/*------------------------------------------------------------------------*/
 #endif
+/*------------------------------------------------------------------------*/
 
+/*------------------------------------------------------------------------*/
 
-  if (!solver->inconsistent)
-    {
-#ifndef NTIER1
-      redundant_scheduled +=
-	vivify_redundant_tier1 (solver, delta, VIVIFYTIER1 / sum);
-#endif
+// Snapshots written by 'satch_save' and read by 'satch_load' allow to stop
+// solving and resume later without losing the state gathered so far.  They
+// contain the irredundant formula (root-level units, binary and large
+// clauses and native XOR constraints), redundant clauses with glue up to
+// 'snapshot_glue_limit' (thus of tier one and two), the extension stack of
+// eliminated variables, saved, target and best phases, as well as the order
+// of the decision queues and the scores of the heaps.
+
+// The file has a fixed size header, followed by one record of four bytes
+// per variable, then by sections of 32-bit words (clauses separated by
+// 'INVALID'), one optional padding word and finally by the heap scores as
+// 'double' values.  All sizes are given in the header and every section is
+// properly aligned, so a memory mapped snapshot is accessed in place.  We
+// use native byte order and thus check it while loading.
+
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_ORDER 0x01020304u
+
+#define NO_DECISIONS 0
+#define QUEUE_DECISIONS 1
+#define HEAP_DECISIONS 2
+
+struct snapshot_header
+{
+  char magic[8];		// Always "satchsnp".
+  uint32_t order;		// Byte order check 'SNAPSHOT_ORDER'.
+  uint32_t version;		// Format version 'SNAPSHOT_VERSION'.
+  uint32_t variables;		// Number of variables.
+  uint32_t inconsistent;	// Empty clause found or derived.
+  uint32_t target, best;	// Trail sizes of target and best phases.
+  uint32_t decisions[2];	// Decision structures (stable=1).
+  uint64_t units;		// Root-level assigned literals.
+  uint64_t irredundant;		// Words of irredundant clauses.
+  uint64_t redundant;		// Words of redundant clauses (with glue).
+  uint64_t xors;		// Words of native XOR constraints.
+  uint64_t extend;		// Words of the extension stack.
+  uint64_t ordered[2];		// Variables in decision order (stable=1).
+  double increment[2];		// Score increments of heaps (stable=1).
+};
 
-      if (!solver->inconsistent)
-	vivify_irredundant (solver, redundant_scheduled, delta,
-			    VIVIFYIRREDUNDANT / sum);
+struct snapshot_variable
+{
+  signed char eliminated;	// Eliminated or substituted variable.
+  signed char saved;		// Saved phase.
+  signed char target;		// Target phase.
+  signed char best;		// Best phase.
+};
 
-    }
-  // Finally update limits.
+// Snapshot read into or mapped to memory while loading.
 
-  {
+struct snapshot
+{
+  char *start;			// Start of the snapshot data.
+  size_t size;			// Size of the snapshot in bytes.
+  bool mapped;			// Memory mapped (otherwise allocated).
+  const struct snapshot_header *header;
+  const struct snapshot_variable *variables;
+  const unsigned *units, *irredundant, *redundant, *xors, *extend;
+  const unsigned *ordered[2];
+  const double *scores[2];
+};
 
-#ifndef NVIVIFICATIONLIMITS
-    const uint64_t limit = limits->vivify.conflicts;
-    limits->vivify.search = TICKS;
-    message (solver, 2, "vivification", vivifications,
-	     "%" PRIu64 " vivified, next limit at %" PRIu64 " after %" PRIu64
-	     " conflicts", solver->statistics.vivified - vivified, limit,
-	     interval);
-#endif
-  }
-  assert (solver->vivifying);
-  solver->vivifying = false;
-  CLEAR_STACK (solver->vivification_schedule);
-  STOP (vivify);
+struct double_stack
+{
+  double *begin, *end, *allocated;
+};
 
-  if (solver->inconsistent)
-    return 20;
-  else
-    return 0;
-}
+// The decision structure used in focused ('stable=0') and stable mode
+// ('stable=1'), which has to match the cases in 'decide_variable'.
 
-static bool
-vivifying (struct satch *solver)
+static unsigned
+snapshot_decisions (unsigned stable)
 {
-#ifdef NCDCL
-  if (solver->level)
-    return false;
+#ifdef NFOCUSED
+  if (!stable)
+    return NO_DECISIONS;
 #endif
-#ifndef NINPROCESSING
-  return solver->limits.vivify.conflicts < CONFLICTS;
+#ifdef NSTABLE
+  if (stable)
+    return NO_DECISIONS;
+#endif
+#if defined(NQUEUE) && defined(NHEAP)
+  (void) stable;
+  return NO_DECISIONS;
+#elif defined(NHEAP)
+  (void) stable;
+  return QUEUE_DECISIONS;
+#elif defined(NQUEUE)
+  (void) stable;
+  return HEAP_DECISIONS;
 #else
-  return !solver->statistics.vivifications;
+  return stable ? HEAP_DECISIONS : QUEUE_DECISIONS;
 #endif
 }
 
-#endif // of '#ifndef NVIVIFICATION'
-
+// Only save decision structures which were used before and contain all
+// activated variables (are not waiting for lazy activation).
 
-#ifndef NLIMITS
-
-static void
-init_limits (struct satch *solver)
+static bool
+complete_decisions (struct satch *solver, unsigned stable)
 {
-  // First initialize all limits.
-
-#ifndef NELIMINATION
-#ifndef NINPROCESSING
-  solver->limits.eliminate.conflicts = elimination_interval;
-#endif
+  const unsigned decisions = snapshot_decisions (stable);
+  if (decisions == NO_DECISIONS)
+    return false;
+#ifndef NLAZYACTIVATION
+  if (!EMPTY_STACK (solver->put[stable]))
+    return false;
 #endif
-#ifndef NREDUCE
-  solver->limits.reduce.conflicts = reduce_interval;
+#ifndef NQUEUE
+  if (decisions == QUEUE_DECISIONS)
+    {
+      const struct queue *const queue = solver->queue + stable;
+#ifdef NLAZYACTIVATION
+      if (queue->size != solver->size)
+	return false;
 #endif
-#ifndef NREPHASE
-  solver->limits.rephase = rephase_interval;
+      return queue->links;
+    }
 #endif
-#ifndef NRESTART
-  solver->limits.restart = restart_interval;
+#ifndef NHEAP
+  assert (decisions == HEAP_DECISIONS);
+  const struct heap *const scores = solver->scores + stable;
+#ifdef NLAZYACTIVATION
+  if (scores->size != solver->size)
+    return false;
 #endif
-#ifndef NSWITCH
-  solver->limits.mode.conflicts = initial_focused_mode_conflicts;
-  solver->limits.mode.ticks.limit = initial_focused_mode_ticks;
+  return scores->begin;
+#else
+  return false;
 #endif
+}
 
-#ifndef NVIVIFICATION
-  solver->limits.vivify.conflicts = vivification_interval;
-#endif
-  // Some sanity checking.
+#ifndef NHEAP
 
-#ifdef NSTABLE
-  assert (!solver->stable);
-#endif
-#ifdef NFOCUSED
-  assert (solver->stable);
-#endif
+// Variables which were activated have a score (even if inactive now).
 
-  (void) solver;
+static bool
+activated_variable (struct satch *solver, unsigned idx)
+{
+  const struct flags *const f = solver->flags + idx;
+  if (f->active || f->fixed)
+    return true;
+#ifndef NELIMINATION
+  if (f->eliminated)
+    return true;
+#endif
+  return false;
 }
 
 #endif
 
-/*------------------------------------------------------------------------*/
+static void
+save_decisions (struct satch *solver, unsigned stable,
+		struct unsigned_stack *ordered, struct double_stack *scores)
+{
+  const unsigned decisions = snapshot_decisions (stable);
+#ifndef NQUEUE
+  if (decisions == QUEUE_DECISIONS)
+    {
+      const struct queue *const queue = solver->queue + stable;
+      const struct link *const links = queue->links;
+      for (unsigned idx = queue->first; idx != INVALID;
+	   idx = links[idx].next)
+	PUSH (*ordered, idx);
+    }
+#endif
+#ifndef NHEAP
+  if (decisions == HEAP_DECISIONS)
+    {
+      const SCORE_TYPE *const score = solver->scores[stable].score;
+      for (all_variables (idx))
+	if (activated_variable (solver, idx))
+	  {
+	    PUSH (*ordered, idx);
+	    PUSH (*scores, score[idx]);
+	  }
+    }
+#endif
+  (void) solver, (void) decisions, (void) ordered, (void) scores;
+}
 
-// This is the main CDCL solving loop.
+// Clauses are saved without root-level falsified literals unless they are
+// root-level satisfied or contain an eliminated variable (redundant).
 
-static int
-solve (struct satch *solver, int delta_limit)
+static bool
+save_clause (struct satch *solver, size_t size, unsigned *literals)
 {
-  START (solve);
-  report (solver, 1, '*');
+  const signed char *const values = solver->values;
+  const struct flags *const flags = solver->flags;
+  for (all_elements_in_array (unsigned, lit, size, literals))
+    {
+      const signed char value = values[lit];
+      if (value > 0)
+	return false;
+      if (!value && !flags[INDEX (lit)].active)
+	return false;
+    }
+  return true;
+}
 
-  int res = solver->inconsistent ? 20 : 0;
-  struct clause *conflict;
+static void
+save_literals (struct satch *solver, struct unsigned_stack *section,
+	       size_t size, unsigned *literals)
+{
+  const signed char *const values = solver->values;
+  for (all_elements_in_array (unsigned, lit, size, literals))
+    if (!values[lit])
+      PUSH (*section, lit);
+  PUSH (*section, INVALID);
+}
 
-  uint64_t conflict_limit =
-    delta_limit < 0 ? UINT64_MAX : CONFLICTS + delta_limit;
+static bool
+write_words (FILE *file, const void *words, size_t size, size_t bytes)
+{
+  return !size || fwrite (words, bytes, size, file) == size;
+}
 
-#ifndef NSWITCH
-  start_mode (solver);
+static const char *
+save_snapshot (struct satch *solver, FILE *file)
+{
+  assert (!solver->level);
+  assert (!solver->dense);
+
+  struct snapshot_header header;
+  memset (&header, 0, sizeof header);
+  memcpy (header.magic, "satchsnp", sizeof header.magic);
+  header.order = SNAPSHOT_ORDER;
+  header.version = SNAPSHOT_VERSION;
+  header.variables = solver->size;
+  header.inconsistent = solver->inconsistent;
+#ifndef NTARGET
+  header.target = solver->target;
 #endif
-  while (!res)
-    if ((conflict = boolean_constraint_propagation (solver)))
-      {
-	if (!analyze_conflict (solver, conflict))
-	  res = 20;
-      }
-    else
-      {
-	if (solver->iterate)
-	  iterate (solver);
+#ifndef NBEST
+  header.best = solver->best;
+#endif
+
+  struct snapshot_variable *variables = 0;
+  struct unsigned_stack units, irredundant, redundant, xors, extend;
+  struct unsigned_stack ordered[2];
+  struct double_stack scores[2];
+  INIT_STACK (units);
+  INIT_STACK (irredundant);
+  INIT_STACK (redundant);
+  INIT_STACK (xors);
+  INIT_STACK (extend);
+  for (unsigned stable = 0; stable != 2; stable++)
+    {
+      INIT_STACK (ordered[stable]);
+      INIT_STACK (scores[stable]);
+    }
 
-	if (!solver->unassigned)
-	  res = 10;
-	else
-	  {
-	    if (CONFLICTS >= conflict_limit)
-	      break;
-	    else
-#ifndef NRESTART
-	    if (restarting (solver))
-	      restart (solver);
-	    else
+  if (!solver->inconsistent)
+    {
+      const size_t bytes = solver->size * sizeof *variables;
+      variables = calloc (solver->size ? solver->size : 1, sizeof *variables);
+      if (!variables)
+	out_of_memory (bytes);
+
+      const signed char *const values = solver->values;
+      const struct flags *const flags = solver->flags;
+      for (all_variables (idx))
+	{
+	  struct snapshot_variable *v = variables + idx;
+	  const struct flags *const f = flags + idx;
+	  const unsigned lit = LITERAL (idx);
+	  if (f->fixed)
+	    PUSH (units, values[lit] > 0 ? lit : NOT (lit));
+#ifndef NELIMINATION
+	  v->eliminated = f->eliminated;
+#else
+	  (void) f;
 #endif
-#ifndef NSWITCH
-	    if (switching (solver))
-	      switch_mode (solver);
-	    else
+#ifndef NSAVE
+	  v->saved = solver->saved[idx];
 #endif
-#ifndef NREDUCE
-	    if (reducing (solver))
-	      reduce (solver);
-	    else
+#ifndef NTARGET
+	  v->target = solver->targets[idx];
 #endif
-#ifndef NREPHASE
-	    if (rephasing (solver))
-	      rephase (solver);
-	    else
+#ifndef NBEST
+	  v->best = solver->bests[idx];
 #endif
-#ifndef NELIMINATION
-	    if (eliminating (solver))
-	      res = eliminate_variables (solver);
-	    else
+	}
+
+#ifndef NVIRTUAL
+      for (all_literals (lit))
+	{
+	  const struct watches *const watches = solver->watches + lit;
+	  const union watch *const end = watches->end;
+	  for (const union watch * p = watches->begin; p != end; p++)
+	    {
+	      const struct header watch = p->header;
+	      if (watch.binary)
+		{
+		  const unsigned other = watch.blocking;
+		  if (lit > other)
+		    continue;
+		  unsigned literals[2] = { lit, other };
+		  if (!save_clause (solver, 2, literals))
+		    continue;
+		  if (watch.redundant)
+		    {
+		      PUSH (redundant, 2);	// Binary clauses have glue two.
+		      save_literals (solver, &redundant, 2, literals);
+		    }
+		  else
+		    save_literals (solver, &irredundant, 2, literals);
+		}
+#ifdef NPACKED
+	      else
+		p++;
 #endif
-#ifndef NVIVIFICATION
-	    if (vivifying (solver))
-	      res = vivify (solver);
-	    else
+	    }
+	}
 #endif
-	      decide (solver);
+      for (all_irredundant_clauses (c))
+	if (!c->garbage && save_clause (solver, c->size, c->literals))
+	  save_literals (solver, &irredundant, c->size, c->literals);
+#if !defined(NLEARN) && !defined(NGLUE)
+      for (all_redundant_clauses (c))
+	if (!c->garbage && c->glue <= snapshot_glue_limit &&
+	    save_clause (solver, c->size, c->literals))
+	  {
+	    PUSH (redundant, c->glue);
+	    save_literals (solver, &redundant, c->size, c->literals);
 	  }
-      }
-#ifndef NSWITCH
-  stop_mode (solver);
 #endif
+      for (all_pointers_on_stack (struct xor, x, solver->xors))
+	{
+	  const unsigned *const begin = x->variables;
+	  const unsigned *const end = begin + x->size;
+	  for (const unsigned *p = begin; p != end; p++)
+	    {
+	      unsigned lit = LITERAL (*p);
+	      if (p == begin && !x->parity)
+		lit = NOT (lit);
+	      PUSH (xors, lit);
+	    }
+	  PUSH (xors, INVALID);
+	}
+#ifndef NELIMINATION
+      for (all_elements_on_stack (unsigned, lit, solver->extend))
+	  PUSH (extend, lit);
+#endif
+      for (unsigned stable = 0; stable != 2; stable++)
+	if (complete_decisions (solver, stable))
+	  {
+	    header.decisions[stable] = snapshot_decisions (stable);
+	    save_decisions (solver, stable, ordered + stable, scores + stable);
+	  }
+#ifndef NHEAP
+      for (unsigned stable = 0; stable != 2; stable++)
+	header.increment[stable] = solver->scores[stable].increment;
+#endif
+    }
 
-  report (solver, 1, !res ? '?' : res == 10 ? '1' : '0');
-  STOP (solve);
-  return res;
+  header.units = SIZE_STACK (units);
+  header.irredundant = SIZE_STACK (irredundant);
+  header.redundant = SIZE_STACK (redundant);
+  header.xors = SIZE_STACK (xors);
+  header.extend = SIZE_STACK (extend);
+  for (unsigned stable = 0; stable != 2; stable++)
+    header.ordered[stable] = SIZE_STACK (ordered[stable]);
+
+  size_t words = header.units + header.irredundant + header.redundant +
+    header.xors + header.extend + header.ordered[0] + header.ordered[1];
+  if (!header.inconsistent)
+    words += header.variables;
+  const unsigned padding = 0;
+
+  bool written = write_words (file, &header, 1, sizeof header);
+  if (!header.inconsistent)
+    written = written && write_words (file, variables,
+				      header.variables, sizeof *variables);
+  written = written &&
+    write_words (file, units.begin, header.units, sizeof (unsigned)) &&
+    write_words (file, irredundant.begin, header.irredundant,
+		 sizeof (unsigned)) &&
+    write_words (file, redundant.begin, header.redundant,
+		 sizeof (unsigned)) &&
+    write_words (file, xors.begin, header.xors, sizeof (unsigned)) &&
+#ifndef NELIMINATION
+    write_words (file, extend.begin, header.extend, sizeof (unsigned)) &&
+#endif
+    write_words (file, ordered[0].begin, header.ordered[0],
+		 sizeof (unsigned)) &&
+    write_words (file, ordered[1].begin, header.ordered[1],
+		 sizeof (unsigned)) &&
+    write_words (file, &padding, words & 1, sizeof padding) &&
+    write_words (file, scores[0].begin, SIZE_STACK (scores[0]),
+		 sizeof (double)) &&
+    write_words (file, scores[1].begin, SIZE_STACK (scores[1]),
+		 sizeof (double)) && !fflush (file);
+
+  free (variables);
+  RELEASE_STACK (units);
+  RELEASE_STACK (irredundant);
+  RELEASE_STACK (redundant);
+  RELEASE_STACK (xors);
+  RELEASE_STACK (extend);
+  for (unsigned stable = 0; stable != 2; stable++)
+    {
+      RELEASE_STACK (ordered[stable]);
+      RELEASE_STACK (scores[stable]);
+    }
+
+  if (!written)
+    return "failed to write snapshot";
+  message (solver, 2, "save", CONFLICTS, "saved snapshot of %u variables "
+	   "and %zu words", solver->size, words);
+  return 0;
 }
 
 /*------------------------------------------------------------------------*/
 
-#ifndef NDEBUG
-
-// This witness checker goes over the saved original clauses and checks that
-// each of them is satisfied.  If not a fatal error message is triggered
-// after printing an original clause which was found to be unsatisfied.
+// Regular files read from the start are memory mapped, otherwise (or if
+// mapping fails) the snapshot is read in blocks into allocated memory.
 
-static void
-check_witness (struct satch *solver)
+static const char *
+read_snapshot (FILE *file, struct snapshot *snapshot)
 {
-  const int *const begin_original = solver->original.begin;
-  const int *const end_original = solver->original.end;
-  size_t clauses = 0;
-  for (const int *p = begin_original, *c = p; c != end_original; c = p)
+#ifdef _POSIX_C_SOURCE
+  const int fd = fileno (file);
+  struct stat buf;
+  if (!ftell (file) && !fstat (fd, &buf) && S_ISREG (buf.st_mode) &&
+      buf.st_size > 0 && (uintmax_t) buf.st_size <= SIZE_MAX)
     {
-      clauses++;
-      bool satisfied = false;
-      int lit;
-      while (assert (p != end_original), (lit = *p++))
-	if (satch_val (solver, lit) == lit)
-	  satisfied = true;
-      if (satisfied)
-	continue;
-      COLORS (2);
-      fflush (stdout);
-      fprintf (stderr,
-	       "%slibsatch: %sfatal error: %sclause[%zd] unsatisfied:\n",
-	       BOLD, RED, NORMAL, clauses);
-      for (const int *q = c; (lit = *q); q++)
-	fprintf (stderr, "%d ", *q);
-      fputs ("0\n", stderr);
-      fflush (stderr);
-      abort ();
+      const size_t size = buf.st_size;
+      void *start = mmap (0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (start != MAP_FAILED)
+	{
+	  snapshot->start = start;
+	  snapshot->size = size;
+	  snapshot->mapped = true;
+	  (void) fseek (file, 0, SEEK_END);
+	  return 0;
+	}
     }
-
-  LOG ("checked witness successfully");
+#endif
+  size_t capacity = 1 << 16;
+  for (;;)
+    {
+      char *start = realloc (snapshot->start, capacity);
+      if (!start)
+	out_of_memory (capacity);
+      snapshot->start = start;
+      const size_t size = capacity - snapshot->size;
+      const size_t bytes = fread (start + snapshot->size, 1, size, file);
+      snapshot->size += bytes;
+      if (bytes < size)
+	break;
+      capacity *= 2;
+    }
+  if (ferror (file))
+    return "failed to read snapshot";
+  return 0;
 }
 
+static void
+release_snapshot (struct snapshot *snapshot)
+{
+#ifdef _POSIX_C_SOURCE
+  if (snapshot->mapped)
+    {
+      munmap (snapshot->start, snapshot->size);
+      return;
+    }
 #endif
+  free (snapshot->start);
+}
 
-/*------------------------------------------------------------------------*/
-
-// The API functions below have several requirements (contracts) and those
-// need to be enforced even in optimized code, particularly in order to help
-// library users to detect, test and debug invalid API usage.
+// Check that all words of clause sections are literals or 'INVALID', that
+// no clause is empty and that the section ends with 'INVALID'.  Clauses of
+// redundant clauses start with a glue word.
 
-static void
-invalid_usage (const char *message, const char *function)
+static bool
+valid_clauses (const unsigned *begin, size_t words,
+	       unsigned literals, bool glue)
 {
-  COLORS (2);
-  fprintf (stderr,
-	   "%slibsatch: %sfatal error: %sinvalid API usage in '%s': %s\n",
-	   BOLD, RED, NORMAL, function, message);
-  fflush (stderr);
-  abort ();
+  const unsigned *const end = begin + words;
+  const unsigned *p = begin;
+  while (p != end)
+    {
+      if (glue && ++p == end)
+	return false;
+      if (*p == INVALID)
+	return false;
+      while (p != end && *p != INVALID)
+	if (*p++ >= literals)
+	  return false;
+      if (p == end)
+	return false;
+      p++;
+    }
+  return true;
 }
 
-// Macros to enforce valid API usage.
-
-#define REQUIRE(CONDITION,MESSAGE) \
-do { \
-  if (!(CONDITION)) \
-    invalid_usage (MESSAGE, __func__); \
-} while (0)
+// The extension stack consists of clauses each starting with 'INVALID'
+// followed by the witness literal and the other literals.
 
-#define REQUIRE_NON_ZERO_SOLVER() \
-  REQUIRE (solver, "zero solver argument")
+static bool
+valid_extension (const unsigned *begin, size_t words, unsigned literals)
+{
+  const unsigned *const end = begin + words;
+  for (const unsigned *p = begin; p != end; p++)
+    {
+      const unsigned lit = *p;
+      if (lit == INVALID)
+	{
+	  if (p + 1 == end || p[1] == INVALID)
+	    return false;
+	}
+      else if (lit >= literals || p == begin)
+	return false;
+    }
+  return true;
+}
 
-#define REQUIRE_VALID_LITERAL(ELIT) \
-do { \
-  REQUIRE ((ELIT) != INT_MIN, "'INT_MIN' literal argument"); \
-  REQUIRE (sizeof (void*) > 4 || abs (ELIT) <= (1<<29), \
-           "maximum of '2^29' variables exceeded on 32-bit system"); \
-} while (0)
+static bool
+valid_phase (signed char phase)
+{
+  return -1 <= phase && phase <= 1;
+}
 
-#define REQUIRE_NON_ZERO_VALID_LITERAL(ELIT) \
-do { \
-  REQUIRE ((ELIT), "zero literal argument"); \
-  REQUIRE ((ELIT) != INT_MIN, "'INT_MIN' literal argument"); \
-} while (0)
+static const char *
+check_snapshot (struct snapshot *snapshot)
+{
+  const struct snapshot_header *const header =
+    (const struct snapshot_header *) snapshot->start;
+  if (snapshot->size < sizeof *header ||
+      memcmp (header->magic, "satchsnp", sizeof header->magic))
+    return "not a snapshot";
+  if (header->order != SNAPSHOT_ORDER)
+    return "snapshot written with different byte order";
+  if (header->version != SNAPSHOT_VERSION)
+    return "unsupported snapshot version";
+  const unsigned variables = header->variables;
+  if (variables > 1u << 31)
+    return "invalid number of variables in snapshot";
+  const uint64_t limit = snapshot->size / sizeof (unsigned);
+  if (header->units > limit || header->irredundant > limit ||
+      header->redundant > limit || header->xors > limit ||
+      header->extend > limit || header->ordered[0] > limit ||
+      header->ordered[1] > limit)
+    return "invalid section size in snapshot";
+  uint64_t words = header->units + header->irredundant +
+    header->redundant + header->xors + header->extend +
+    header->ordered[0] + header->ordered[1];
+  if (!header->inconsistent)
+    words += variables;
+  uint64_t expected = sizeof *header + words * sizeof (unsigned);
+  expected += (words & 1) * sizeof (unsigned);
+  for (unsigned stable = 0; stable != 2; stable++)
+    {
+      const unsigned decisions = header->decisions[stable];
+      if (decisions > HEAP_DECISIONS ||
+	  (decisions == NO_DECISIONS && header->ordered[stable]))
+	return "invalid decisions in snapshot";
+      if (decisions == HEAP_DECISIONS)
+	{
+	  expected += header->ordered[stable] * sizeof (double);
+	  if (!(header->increment[stable] > 0))
+	    return "invalid score increment in snapshot";
+	}
+    }
+  if (expected != snapshot->size)
+    return "snapshot size mismatch";
 
-#define REQUIRE_NON_INCREMENTAL() \
-  REQUIRE (!solver->statistics.solved, \
-           "incremental usage not implemented yet")
+  snapshot->header = header;
+  const char *p = snapshot->start + sizeof *header;
+  if (!header->inconsistent)
+    {
+      snapshot->variables = (const struct snapshot_variable *) p;
+      p += variables * sizeof *snapshot->variables;
+    }
+  snapshot->units = (const unsigned *) p;
+  p += header->units * sizeof (unsigned);
+  snapshot->irredundant = (const unsigned *) p;
+  p += header->irredundant * sizeof (unsigned);
+  snapshot->redundant = (const unsigned *) p;
+  p += header->redundant * sizeof (unsigned);
+  snapshot->xors = (const unsigned *) p;
+  p += header->xors * sizeof (unsigned);
+  snapshot->extend = (const unsigned *) p;
+  p += header->extend * sizeof (unsigned);
+  for (unsigned stable = 0; stable != 2; stable++)
+    {
+      snapshot->ordered[stable] = (const unsigned *) p;
+      p += header->ordered[stable] * sizeof (unsigned);
+    }
+  p += (words & 1) * sizeof (unsigned);
+  for (unsigned stable = 0; stable != 2; stable++)
+    if (header->decisions[stable] == HEAP_DECISIONS)
+      {
+	snapshot->scores[stable] = (const double *) p;
+	p += header->ordered[stable] * sizeof (double);
+      }
+  assert (p == snapshot->start + snapshot->size);
+
+  const unsigned literals = 2 * variables;
+  for (uint64_t i = 0; i != header->units; i++)
+    if (snapshot->units[i] >= literals)
+      return "invalid unit in snapshot";
+  if (!valid_clauses (snapshot->irredundant, header->irredundant,
+		      literals, false) ||
+      !valid_clauses (snapshot->redundant, header->redundant,
+		      literals, true) ||
+      !valid_clauses (snapshot->xors, header->xors, literals, false))
+    return "invalid clause in snapshot";
+  if (!valid_extension (snapshot->extend, header->extend, literals))
+    return "invalid extension stack in snapshot";
+  for (unsigned stable = 0; stable != 2; stable++)
+    for (uint64_t i = 0; i != header->ordered[stable]; i++)
+      {
+	if (snapshot->ordered[stable][i] >= variables)
+	  return "invalid variable order in snapshot";
+	if (snapshot->scores[stable] && !(snapshot->scores[stable][i] >= 0))
+	  return "invalid score in snapshot";
+      }
+  if (!header->inconsistent)
+    for (unsigned idx = 0; idx != variables; idx++)
+      {
+	const struct snapshot_variable *const v = snapshot->variables + idx;
+	if ((v->eliminated != 0 && v->eliminated != 1) ||
+	    !valid_phase (v->saved) || !valid_phase (v->target) ||
+	    !valid_phase (v->best))
+	  return "invalid variable in snapshot";
+      }
+  if (header->target > variables || header->best > variables)
+    return "invalid phases in snapshot";
+  return 0;
+}
 
 /*------------------------------------------------------------------------*/
 
-static struct satch *
-internal_init (void)
-{
-  struct satch *solver = calloc (1, sizeof (struct satch));
-  if (!solver)
-    fatal_error ("could not allocate solver");
-#ifdef NFOCUSED
-  solver->stable = 1;
-#endif
-#ifndef NDEBUG
-  solver->checker = checker_init ();
-#endif
-#ifndef NBLOCK
-  init_binary (solver);
-#endif
+// Loaded irredundant clauses and units are added as original clauses.
 
-#ifndef NVSIDS
-#ifndef NFOCUSED
-  solver->scores[0].factor = focused_score_increment_factor;
-#endif
-#ifndef NSTABLE
-  solver->scores[1].factor = stable_score_increment_factor;
-#endif
-#endif
+static const unsigned *
+load_clause (struct satch *solver, const unsigned *p)
+{
+  unsigned lit;
+  while ((lit = *p++) != INVALID)
+    internal_add (solver, export_literal (lit));
+  internal_add (solver, 0);
+  return p;
+}
 
-  init_averages (solver);
-#ifndef NLIMITS
-  init_limits (solver);
-#endif
-  init_profiles (solver);
-  return solver;
+static const unsigned *
+load_xor (struct satch *solver, const unsigned *p)
+{
+  assert (EMPTY_STACK (solver->clause));
+  struct int_stack literals;
+  INIT_STACK (literals);
+  unsigned lit;
+  while ((lit = *p++) != INVALID)
+    PUSH (literals, export_literal (lit));
+  internal_add_xor (solver, literals.begin, SIZE_STACK (literals));
+  RELEASE_STACK (literals);
+  return p;
 }
 
-/*------------------------------------------------------------------------*/
+#if !defined(NCDCL) && !defined(NLEARN)
 
-static void
-internal_release (struct satch *solver)
-{
-#ifdef NLEARN
-  if (solver->level)
-    backtrack (solver, 0);	// To delete reason clauses.
-#endif
+// Redundant clauses are watched like learned clauses after removing root
+// level falsified literals.  Those which became root-level satisfied or
+// unit are skipped (as those containing inactive variables).  In debugging
+// mode they are added as original clauses to the checker since they are
+// implied by the formula of the saving solver but not necessarily RUP.
 
-  solver->proof = 0;
-  for (all_literals (lit))
+static const unsigned *
+load_redundant_clause (struct satch *solver, const unsigned *p)
+{
+  const unsigned glue = *p++;
+  const signed char *const values = solver->values;
+  const struct flags *const flags = solver->flags;
+  bool skip = false;
+  unsigned lit;
+  assert (EMPTY_STACK (solver->clause));
+  while ((lit = *p++) != INVALID)
     {
-      struct watches *watches = solver->watches + lit;
-#if !defined(NDEBUG) && !defined(NVIRTUAL)
-      const union watch *const end = watches->end;
-      for (const union watch * p = watches->begin; p != end; p++)
-	if (p->header.binary)
-	  delete_header (solver, lit, p->header);
-	else
-	  p++;
-#endif
-      RELEASE_STACK (*watches);
+      const signed char value = values[lit];
+      if (value > 0 || (!value && !flags[INDEX (lit)].active))
+	skip = true;
+      else if (!value)
+	PUSH (solver->clause, lit);
     }
-
-  free (solver->watches);
-
-  free (solver->levels);
-  free (solver->values);
-#ifndef NSAVE
-  free (solver->saved);
-#endif
-#ifndef NTARGET
-  free (solver->targets);
-#endif
-#ifndef NBEST
-  free (solver->bests);
-#endif
-  free (solver->marks);
-#ifndef NVIVIFICATION
-  free (solver->vivify_marks);
-#endif
-  free (solver->flags);
-  free (solver->frames);
-#ifndef NCONTROL
-  free (solver->position);
-  RELEASE_STACK (solver->control);
+  const size_t size = SIZE_STACK (solver->clause);
+  if (skip || size < 2)
+    {
+      CLEAR_STACK (solver->clause);
+      return p;
+    }
+#ifndef NDEBUG
+  for (all_elements_on_stack (unsigned, lit, solver->clause))
+      checker_add_literal (solver->checker, export_literal (lit));
+  checker_add_original_clause (solver->checker);
 #endif
-  free (solver->reasons);
-  free (solver->trail.begin);
-
-#ifndef NQUEUE
-#ifndef NQUEUE0
-  release_queue (&solver->queue[0]);
-#else
-  assert (!solver->queue[0].links);
+#ifndef NVIRTUAL
+  if (size == 2)
+    {
+      add_new_binary_and_watch_it (solver, true);
+      CLEAR_STACK (solver->clause);
+      return p;
+    }
 #endif
-#ifndef NQUEUE1
-  release_queue (&solver->queue[1]);
+#ifndef NGLUE
+  struct clause *c = new_redundant_clause (solver, glue);
 #else
-  assert (!solver->queue[1].links);
+  struct clause *c = new_redundant_clause (solver);
+  (void) glue;
 #endif
+#ifndef NUSED
+#ifndef NTIER2
+  if (glue <= tier2_glue_limit)
+    c->used = 2;
+  else
 #endif
-
-#ifndef NHEAP
-#ifndef NHEAP0
-  release_heap (&solver->scores[0]);
-#else
-  assert (!solver->scores[0].begin);
+    c->used = 1;
 #endif
-#ifndef NHEAP1
-  release_heap (&solver->scores[1]);
+  LOGCLS (c, "loaded");
+#ifndef NWATCHES
+  watch_clause (solver, c);
 #else
-  assert (!solver->scores[1].begin);
+  connect_clause (solver, c);
+  count_clause (solver, c);
 #endif
+  CLEAR_STACK (solver->clause);
+  return p;
+}
+
 #endif
 
+#if !defined(NQUEUE) || !defined(NHEAP)
+
+// Without lazy activation variables are counted as 'filled'.
+
 #ifndef NLAZYACTIVATION
-#ifndef NFOCUSED
-  RELEASE_STACK (solver->put[0]);
-#else
-  assert (EMPTY_STACK (solver->put[0]));
-#endif
-#ifndef NSTABLE
-  RELEASE_STACK (solver->put[1]);
+#define INC_ACTIVATED(STABLE) INC (activated[STABLE])
 #else
-  assert (EMPTY_STACK (solver->put[1]));
-#endif
+#define INC_ACTIVATED(STABLE) INC (filled[STABLE])
 #endif
 
-#ifndef NELIMINATION
-  RELEASE_STACK (solver->extend);
-  RELEASE_STACK (solver->resolvents);
-#endif
+// Restoring a decision structure replaces its (lazy) activation.  Thus we
+// need all variables which would otherwise be activated.
 
-#ifndef NMINIMIZE
-  RELEASE_STACK (solver->poisoned);
-  RELEASE_STACK (solver->removable);
-#endif
-#ifndef NSHRINK
-  RELEASE_STACK (solver->shrunken);
-#endif
-  RELEASE_STACK (solver->analyzed);
-  RELEASE_STACK (solver->clause);
-  RELEASE_STACK (solver->blocks);
-#ifndef NBINARIES
-  RELEASE_STACK (solver->binaries);
+static void
+activation_stack (struct satch *solver, unsigned stable,
+		  struct unsigned_stack *activate)
+{
+#ifndef NLAZYACTIVATION
+  *activate = solver->put[stable];
+  INIT_STACK (solver->put[stable]);
+#else
+  (void) stable;
+  INIT_STACK (*activate);
+  for (all_variables (idx))
+    PUSH (*activate, idx);
 #endif
+}
 
-  for (all_pointers_on_stack (struct clause, c, solver->irredundant))
-      (void) delete_clause (solver, c);
-  RELEASE_STACK (solver->irredundant);
-#ifndef NLEARN
-  for (all_pointers_on_stack (struct clause, c, solver->redundant))
-      (void) delete_clause (solver, c);
-  RELEASE_STACK (solver->redundant);
-#endif
-  assert (!solver->statistics.irredundant);
-  assert (!solver->statistics.redundant);
-#ifndef NBLOCK
-  release_binary (solver);
 #endif
 
-  RELEASE_STACK (solver->added);
-#ifndef NDEBUG
-  RELEASE_STACK (solver->original);
-
-#ifndef NLEARN
-  checker_enable_leak_checking (solver->checker);
-#endif
-  checker_release (solver->checker);
-#endif
-#ifndef NVIVIFICATION
-  RELEASE_STACK (solver->vivification_schedule);
-  RELEASE_STACK (solver->sorted);
-#endif
-  free (solver);
-}
+#ifndef NQUEUE
 
-/*------------------------------------------------------------------------*/
+// Variables not in the saved order are enqueued first and thus are picked
+// last as decisions.  Marks are one for activated variables and two for
+// activated variables in the saved order.
 
 static void
-internal_add (struct satch *solver, int elit)
+load_queue (struct satch *solver, unsigned stable,
+	    size_t size, const unsigned *ordered)
 {
-#ifndef NDEBUG
-  PUSH (solver->original, elit);
+  struct queue *const queue = solver->queue + stable;
+  init_queue (solver, queue);
+  struct unsigned_stack activate;
+  activation_stack (solver, stable, &activate);
+  signed char *const marks = solver->marks;
+  for (all_elements_on_stack (unsigned, idx, activate))
+      marks[idx] = 1;
+  for (size_t i = 0; i != size; i++)
+    if (marks[ordered[i]] == 1)
+      marks[ordered[i]] = 2;
+  for (all_elements_on_stack (unsigned, idx, activate))
+    if (marks[idx] == 1)
+      {
+	INC_ACTIVATED (stable);
+	enqueue (solver, queue, idx);
+	marks[idx] = 0;
+      }
+  for (size_t i = 0; i != size; i++)
+    {
+      const unsigned idx = ordered[i];
+      if (marks[idx] != 2)
+	continue;
+      INC_ACTIVATED (stable);
+      enqueue (solver, queue, idx);
+      marks[idx] = 0;
+    }
+  RELEASE_STACK (activate);
+  queue->size = solver->size;
+}
+
 #endif
 
-  // If an empty clause has been added or derived we do not need to add
-  // anything and just return for the rest of time this solver is used.
+#ifndef NHEAP
 
-  if (solver->inconsistent)
-    return;
+// Variables without saved score get score zero.
 
-  if (elit)
+static void
+load_scores (struct satch *solver, unsigned stable, size_t size,
+	     const unsigned *ordered, const double *saved, double increment)
+{
+  struct heap *const scores = solver->scores + stable;
+  init_scores (solver, scores);
+  scores->increment = increment;
+  struct unsigned_stack activate;
+  activation_stack (solver, stable, &activate);
+  unsigned *const pos = scores->pos;
+  SCORE_TYPE *const score = scores->score;
+  for (all_elements_on_stack (unsigned, idx, activate))
     {
-      // Add the literal to the internal temporary 'clause' after importing
-      // it, i.e., adjusting the 'size' (number of active variables) if its
-      // variable has never been seen before.  Also turn the external signed
-      // DIMACS 'int' literal into and internal 'unsigned' literal.
-
-      const unsigned ilit = import_literal (solver, elit);
-      PUSH (solver->clause, ilit);
-      PUSH (solver->added, elit);
-#ifndef NDEBUG
-      checker_add_literal (solver->checker, elit);
-#endif
+      pos[idx] = INVALID;
+      score[idx] = 0;
     }
-  else
+  for (size_t i = 0; i != size; i++)
+    score[ordered[i]] = saved[i];
+  for (all_elements_on_stack (unsigned, idx, activate))
     {
-#ifndef NDEBUG
-      checker_add_original_clause (solver->checker);
+      INC_ACTIVATED (stable);
+      push_heap (solver, scores, idx);
+    }
+  RELEASE_STACK (activate);
+  scores->size = solver->size;
+}
+
 #endif
-      bool remove_original_clause;
 
-      // First check whether the imported clause is already (root-level)
-      // satisfied or trivial (contains both a literal and its negation).
-      // During this check falsified and duplicated literals are removed.
+static const char *
+load_snapshot (struct satch *solver, const struct snapshot *snapshot)
+{
+  const struct snapshot_header *const header = snapshot->header;
+  if (header->variables)
+    increase_size (solver, header->variables);
+  if (header->inconsistent)
+    {
+      internal_add (solver, 0);
+      return 0;
+    }
 
-      if (!imported_clause_trivial_or_satisfied (solver))
-	{
-	  // Activate variables in the order they appear in the input CNF.
-	  // This gives an implicit order of the variables in the decision
-	  // queue as well as in the binary heap keeping variables in the
-	  // same clauses close to each other which seems beneficial.
+  for (uint64_t i = 0; i != header->units; i++)
+    {
+      internal_add (solver, export_literal (snapshot->units[i]));
+      internal_add (solver, 0);
+    }
+  {
+    const unsigned *const end = snapshot->irredundant + header->irredundant;
+    for (const unsigned *p = snapshot->irredundant; p != end;)
+      p = load_clause (solver, p);
+  }
+  {
+    const unsigned *const end = snapshot->xors + header->xors;
+    for (const unsigned *p = snapshot->xors; p != end;)
+      p = load_xor (solver, p);
+  }
+
+#ifndef NELIMINATION
+  struct flags *const flags = solver->flags;
+  for (all_variables (idx))
+    {
+      if (!snapshot->variables[idx].eliminated)
+	continue;
+      struct flags *const f = flags + idx;
+      if (f->active || f->fixed)
+	return "eliminated variable in snapshot formula";
+      activate_literal (solver, LITERAL (idx));
+      f->active = false;
+      f->eliminated = true;
+      DEC (remaining);
+      INC (eliminated);
+    }
+  for (uint64_t i = 0; i != header->extend; i++)
+    PUSH (solver->extend, snapshot->extend[i]);
+#else
 
-	  activate_literals (solver);
+  // Without elimination the clauses on the extension stack are simply
+  // added back as irredundant clauses (witness literal first).
 
-	  // We need special treatment for empty and unary clauses since all
-	  // internally allocated clauses have at least two literals.
+  {
+    const unsigned *const end = snapshot->extend + header->extend;
+    const unsigned *p = snapshot->extend;
+    while (p != end)
+      {
+	assert (*p == INVALID);
+	while (++p != end && *p != INVALID)
+	  internal_add (solver, export_literal (*p));
+	internal_add (solver, 0);
+      }
+  }
+#endif
 
-	  const size_t size = SIZE_STACK (solver->clause);
+#if !defined(NCDCL) && !defined(NLEARN)
+  {
+    const unsigned *const end = snapshot->redundant + header->redundant;
+    for (const unsigned *p = snapshot->redundant; p != end;)
+      p = load_redundant_clause (solver, p);
+  }
+#endif
 
-	  if (!size)
-	    {
-	      LOG ("empty thus inconsistent imported clause");
-	      solver->inconsistent = true;
-	    }
-	  else if (size == 1)
-	    {
-	      // It is a common technique to represent unit clauses by just
-	      // assigning its literal on the root-level.  This makes sure
-	      // that all allocated clauses are at least binary, but for
-	      // instance requires that 'analyze' treats root-level literals
-	      // in a special way, 'reduce' and thus 'assign' ignore
-	      // clauses forcing root-level assigned literals and finally
-	      // (and maybe really the most severe consequence), makes proof
-	      // tracing semantics rather complex (particularly regarding the
-	      // situation of deleting unit clauses in RUP / DRAT proofs).
-
-	      const unsigned unit = ACCESS (solver->clause, 0);
-	      const signed char value = solver->values[unit];
-	      if (value > 0)
-		{
-		  LOG ("skipping redundant unit clause %s", LOGLIT (unit));
-		}
-	      else if (value < 0)
-		{
-		  LOG ("found inconsistent unit clause %s", LOGLIT (unit));
-		  solver->inconsistent = true;
-		}
-	      else
-		{
-		  LOG ("found unit clause %s", LOGLIT (unit));
-		  assign (solver, unit, 0, true);
-		  remove_original_clause = true;
-		}
-	    }
-#ifndef NVIRTUAL
-	  else if (size == 2)
-	    {
-	      add_new_binary_and_watch_it (solver, false);
-#ifdef LOGGING
-	      const unsigned lit = ACCESS (solver->clause, 0);
-	      const unsigned other = ACCESS (solver->clause, 1);
-	      LOGBIN (false, lit, other, "imported");
+  for (all_variables (idx))
+    {
+      const struct snapshot_variable *const v = snapshot->variables + idx;
+#ifndef NSAVE
+      solver->saved[idx] = v->saved;
 #endif
-	    }
+#ifndef NTARGET
+      solver->targets[idx] = v->target;
 #endif
-	  else
-	    {
-	      struct clause *clause = new_irredundant_clause (solver);
-	      LOGCLS (clause, "imported");
-#ifndef NWATCHES
-	      watch_clause (solver, clause);
-#else
-	      connect_clause (solver, clause);
-	      count_clause (solver, clause);
+#ifndef NBEST
+      solver->bests[idx] = v->best;
+#endif
+      (void) v;
+    }
+#ifndef NTARGET
+  solver->target = header->target;
+#endif
+#ifndef NBEST
+  solver->best = header->best;
 #endif
-	    }
-
-	  const size_t added = SIZE_STACK (solver->added);
-	  assert (size <= added);
-
-	  if (size < added)
-	    {
-	      trace_and_check_temporary_addition (solver);
-	      remove_original_clause = true;
-	    }
-	  else
-	    remove_original_clause = false;
-	}
-      else
-	remove_original_clause = true;
 
-      CLEAR_STACK (solver->clause);
-      if (remove_original_clause)
-	{
-	  if (solver->proof)
-	    {
-	      start_deletion_proof_line (solver);
-	      for (all_elements_on_stack (int, lit, solver->added))
-		  add_external_literal_to_proof_line (solver, lit);
-	      end_proof_line (solver);
-	    }
-#ifndef NDEBUG
-	  for (all_elements_on_stack (int, lit, solver->added))
-	      checker_add_literal (solver->checker, lit);
-	  checker_delete_clause (solver->checker);
+  for (unsigned stable = 0; stable != 2; stable++)
+    {
+      const unsigned decisions = header->decisions[stable];
+      if (decisions == NO_DECISIONS ||
+	  decisions != snapshot_decisions (stable))
+	continue;
+#ifndef NQUEUE
+      if (decisions == QUEUE_DECISIONS)
+	load_queue (solver, stable, header->ordered[stable],
+		    snapshot->ordered[stable]);
+#endif
+#ifndef NHEAP
+      if (decisions == HEAP_DECISIONS)
+	load_scores (solver, stable, header->ordered[stable],
+		     snapshot->ordered[stable], snapshot->scores[stable],
+		     header->increment[stable]);
 #endif
-	}
-      CLEAR_STACK (solver->added);
     }
+
+  return 0;
 }
 
 /*========================================================================*/
@@ -12161,11 +19399,23 @@ void
 satch_add (struct satch *solver, int elit)
 {
   REQUIRE_NON_ZERO_SOLVER ();
-  REQUIRE_NON_INCREMENTAL ();
   REQUIRE_VALID_LITERAL (elit);
+  reset_after_solving (solver);
   internal_add (solver, elit);
 }
 
+// Assume a literal for the next call to 'satch_solve'.
+
+void
+satch_assume (struct satch *solver, int elit)
+{
+  REQUIRE_NON_ZERO_SOLVER ();
+  REQUIRE_NON_ZERO_VALID_LITERAL (elit);
+  REQUIRE_COMPLETE_CLAUSE ();
+  reset_after_solving (solver);
+  internal_assume (solver, elit);
+}
+
 /*------------------------------------------------------------------------*/
 
 // Short hand for adding empty, unit, binary, ternary, or quaternay clauses.
@@ -12174,7 +19424,7 @@ void
 satch_add_empty (struct satch *solver)
 {
   REQUIRE_NON_ZERO_SOLVER ();
-  REQUIRE_NON_INCREMENTAL ();
+  reset_after_solving (solver);
   internal_add (solver, 0);
 }
 
@@ -12182,8 +19432,8 @@ void
 satch_add_unit (struct satch *solver, int unit)
 {
   REQUIRE_NON_ZERO_SOLVER ();
-  REQUIRE_NON_INCREMENTAL ();
   REQUIRE_NON_ZERO_VALID_LITERAL (unit);
+  reset_after_solving (solver);
   internal_add (solver, unit);
   internal_add (solver, 0);
 }
@@ -12192,9 +19442,9 @@ void
 satch_add_binary_clause (struct satch *solver, int a, int b)
 {
   REQUIRE_NON_ZERO_SOLVER ();
-  REQUIRE_NON_INCREMENTAL ();
   REQUIRE_NON_ZERO_VALID_LITERAL (a);
   REQUIRE_NON_ZERO_VALID_LITERAL (b);
+  reset_after_solving (solver);
   internal_add (solver, a);
   internal_add (solver, b);
   internal_add (solver, 0);
@@ -12204,10 +19454,10 @@ void
 satch_add_ternary_clause (struct satch *solver, int a, int b, int c)
 {
   REQUIRE_NON_ZERO_SOLVER ();
-  REQUIRE_NON_INCREMENTAL ();
   REQUIRE_NON_ZERO_VALID_LITERAL (a);
   REQUIRE_NON_ZERO_VALID_LITERAL (b);
   REQUIRE_NON_ZERO_VALID_LITERAL (c);
+  reset_after_solving (solver);
   internal_add (solver, a);
   internal_add (solver, b);
   internal_add (solver, c);
@@ -12218,11 +19468,11 @@ void
 satch_add_quaternary_clause (struct satch *solver, int a, int b, int c, int d)
 {
   REQUIRE_NON_ZERO_SOLVER ();
-  REQUIRE_NON_INCREMENTAL ();
   REQUIRE_NON_ZERO_VALID_LITERAL (a);
   REQUIRE_NON_ZERO_VALID_LITERAL (b);
   REQUIRE_NON_ZERO_VALID_LITERAL (c);
   REQUIRE_NON_ZERO_VALID_LITERAL (d);
+  reset_after_solving (solver);
   internal_add (solver, a);
   internal_add (solver, b);
   internal_add (solver, c);
@@ -12232,6 +19482,79 @@ satch_add_quaternary_clause (struct satch *solver, int a, int b, int c, int d)
 
 /*------------------------------------------------------------------------*/
 
+// Bulk addition of a single clause with 'size' non-zero literals and of
+// a sequence of zero terminated clauses with 'size' literals in total.
+
+void
+satch_add_clause (struct satch *solver, const int *literals, size_t size)
+{
+  REQUIRE_NON_ZERO_SOLVER ();
+  REQUIRE_COMPLETE_CLAUSE ();
+  REQUIRE (literals || !size, "zero literals argument");
+  size_t max_size;
+  int max_idx;
+  const int *invalid =
+    check_bulk_literals (literals, size, &max_idx, &max_size);
+  if (invalid)
+    REQUIRE_VALID_LITERAL (*invalid);
+  REQUIRE (max_size == size, "zero literal in clause");
+  reset_after_solving (solver);
+  reserve_bulk (solver, max_idx, size, size + 1);
+  internal_add_clause (solver, literals, size);
+}
+
+void
+satch_add_clauses (struct satch *solver, const int *literals, size_t size)
+{
+  REQUIRE_NON_ZERO_SOLVER ();
+  REQUIRE_COMPLETE_CLAUSE ();
+  REQUIRE (literals || !size, "zero literals argument");
+  REQUIRE (!size || !literals[size - 1],
+	   "last clause not terminated by zero literal");
+  size_t max_size;
+  int max_idx;
+  const int *invalid =
+    check_bulk_literals (literals, size, &max_idx, &max_size);
+  if (invalid)
+    REQUIRE_VALID_LITERAL (*invalid);
+  reset_after_solving (solver);
+  reserve_bulk (solver, max_idx, max_size, size);
+  const int *const end = literals + size;
+  const int *clause = literals;
+  for (const int *p = literals; p != end; p++)
+    if (!*p)
+      {
+	internal_add_clause (solver, clause, p - clause);
+	clause = p + 1;
+      }
+}
+
+// Add an XOR constraint natively, which is satisfied if an odd number of
+// its literals is true.  The literals are checked as in 'satch_add_clause'
+// and proofs can not be traced (reasons are not implied through unit
+// propagation by clauses).
+
+void
+satch_add_xor (struct satch *solver, const int *literals, size_t size)
+{
+  REQUIRE_NON_ZERO_SOLVER ();
+  REQUIRE_COMPLETE_CLAUSE ();
+  REQUIRE (literals || !size, "zero literals argument");
+  REQUIRE (!solver->proof, "can not add XOR constraints while tracing proofs");
+  size_t max_size;
+  int max_idx;
+  const int *invalid =
+    check_bulk_literals (literals, size, &max_idx, &max_size);
+  if (invalid)
+    REQUIRE_VALID_LITERAL (*invalid);
+  REQUIRE (max_size == size, "zero literal in XOR constraint");
+  reset_after_solving (solver);
+  reserve_bulk (solver, max_idx, size, 0);
+  internal_add_xor (solver, literals, size);
+}
+
+/*------------------------------------------------------------------------*/
+
 // Reserve at least 'max_var' variables that is the size of the solver. If
 // the users knows this number then pre-allocating everything to that size
 // avoids resizing the solver data.
@@ -12256,6 +19579,61 @@ satch_maximum_variable (struct satch *solver)
 
 /*------------------------------------------------------------------------*/
 
+int
+satch_cube (struct satch *solver, int depth, void *state,
+	    void (*cube_callback) (void *state, int size, const int *cube))
+{
+  REQUIRE_NON_ZERO_SOLVER ();
+  REQUIRE (depth >= 0, "expected non-negative depth");
+  REQUIRE (cube_callback, "zero call-back argument");
+  REQUIRE_COMPLETE_CLAUSE ();
+  reset_after_solving (solver);
+  REQUIRE (EMPTY_STACK (solver->assumptions),
+	   "can not generate cubes under assumptions");
+  if (solver->options.verbose)
+    internal_section (solver, "cubing");
+  const int res = cube (solver, depth, state, cube_callback);
+  flush_proof (solver);
+  return set_status (solver, res);
+}
+
+/*------------------------------------------------------------------------*/
+
+// Snapshots are written at the root-level and after completing solving
+// (thus after resetting assumptions and the status).  They can only be
+// loaded into a new solver.
+
+const char *
+satch_save (struct satch *solver, FILE * file)
+{
+  REQUIRE_NON_ZERO_SOLVER ();
+  REQUIRE (file, "zero file argument");
+  REQUIRE_COMPLETE_CLAUSE ();
+  reset_after_solving (solver);
+  return save_snapshot (solver, file);
+}
+
+const char *
+satch_load (struct satch *solver, FILE * file)
+{
+  REQUIRE_NON_ZERO_SOLVER ();
+  REQUIRE (file, "zero file argument");
+  REQUIRE (!solver->size && !solver->inconsistent,
+	   "can only load snapshot into new solver");
+  REQUIRE (!solver->proof, "can not load snapshot while tracing proofs");
+  struct snapshot snapshot;
+  memset (&snapshot, 0, sizeof snapshot);
+  const char *error = read_snapshot (file, &snapshot);
+  if (!error)
+    error = check_snapshot (&snapshot);
+  if (!error)
+    error = load_snapshot (solver, &snapshot);
+  release_snapshot (&snapshot);
+  return error;
+}
+
+/*------------------------------------------------------------------------*/
+
 // The IPASIR interface returns '-elit' if 'elit' is assigned 'false' and
 // 'elit' if it is assigned to 'true'.  Otherwise it returns zero.  We do
 // not want to use 'import_literal' here, since this forces to adapt the
@@ -12290,30 +19668,127 @@ satch_val (struct satch *solver, int elit)
   return res;
 }
 
+// Bulk version of 'satch_val' which sets 'values[idx]' to '1' if variable
+// 'idx' is assigned to 'true' and to '-1' otherwise, for all variables up
+// to 'max_var' (thus 'values' needs room for 'max_var + 1' elements).
+
+void
+satch_values (struct satch *solver, signed char *values, int max_var)
+{
+  REQUIRE_NON_ZERO_SOLVER ();
+  REQUIRE (values || max_var <= 0, "zero values argument");
+  REQUIRE (solver->status == 10,
+	   (solver->status == 20 ?
+	    "expected status to be '10' and not '20'" :
+	    !solver->status ?
+	    "expected status to be '10' and not '0'" :
+	    "expected status to be '10'"));
+  if (max_var < 0)
+    return;
+  values[0] = 0;
+  const unsigned size = solver->size, max = max_var;
+  const unsigned assigned = max < size ? max : size;
+  const signed char *const internal = solver->values;
+  for (unsigned iidx = 0; iidx != assigned; iidx++)
+    values[iidx + 1] = internal[LITERAL (iidx)] < 0 ? -1 : 1;
+  for (unsigned iidx = assigned; iidx != max; iidx++)
+    values[iidx + 1] = 1;	// By default assigned to 'true'.
+}
+
+// After 'satch_solve' returned '20' determine whether the given assumed
+// literal was part of the failed assumptions responsible for that result.
+
+int
+satch_failed (struct satch *solver, int elit)
+{
+  REQUIRE_NON_ZERO_SOLVER ();
+  REQUIRE_NON_ZERO_VALID_LITERAL (elit);
+  REQUIRE (solver->status == 20,
+	   (solver->status == 10 ?
+	    "expected status to be '20' and not '10'" :
+	    !solver->status ?
+	    "expected status to be '20' and not '0'" :
+	    "expected status to be '20'"));
+  const unsigned iidx = abs (elit) - 1;
+  if (iidx >= solver->size)
+    return 0;
+  const struct flags *const f = solver->flags + iidx;
+  assert (f->failed == 0 || f->assumed);
+  const unsigned bit = 1u << (elit < 0);
+  return !!(f->failed & bit);
+}
+
 int
 satch_solve (struct satch *solver, int conflict_limit)
 {
   REQUIRE_NON_ZERO_SOLVER ();
-  REQUIRE (EMPTY_STACK (solver->clause),
-	   "incomplete clause (zero literal missing)");
-  REQUIRE (!solver->status, "no incremental solving yet");
+  REQUIRE_COMPLETE_CLAUSE ();
+  reset_after_solving (solver);
   INC (solved);
   if (solver->options.verbose)
     internal_section (solver, "solving");
-  int res = solve (solver, conflict_limit);
-  LOG ("internal solving procedure returns '%d'", res);
-  solver->status = res;
-  if (res == 10)
+  const int res = solve (solver, conflict_limit);
+  flush_proof (solver);
+  return set_status (solver, res);
+}
+
+// Portfolio solving falls back to sequential solving with one thread, if
+// proofs are traced, if portfolio solving is disabled ('NPORTFOLIO') or for
+// incremental usage (assumptions or the formula was solved before).
+
+int
+satch_solve_parallel (struct satch *solver, int threads, int conflict_limit)
+{
+  REQUIRE_NON_ZERO_SOLVER ();
+  REQUIRE (threads > 0, "expected positive number of threads");
+#ifndef NPORTFOLIO
+  if (threads > 1 && !solver->proof && !solver->statistics.solved &&
+      EMPTY_STACK (solver->assumptions) && EMPTY_STACK (solver->xors))
     {
-#ifndef NELIMINATION
-      extend_solution (solver);
+      REQUIRE_COMPLETE_CLAUSE ();
+      INC (solved);
+      if (solver->options.verbose)
+	internal_section (solver, "solving");
+      const int res = solve_parallel (solver, threads, conflict_limit);
+      return set_status (solver, res);
+    }
 #endif
+  return satch_solve (solver, conflict_limit);
+}
 
-#ifndef NDEBUG
-      check_witness (solver);
+void
+satch_set_elimination_threads (struct satch *solver, int threads)
+{
+  REQUIRE_NON_ZERO_SOLVER ();
+  REQUIRE (threads > 0, "expected positive number of threads");
+#ifndef NPARALLEL
+  solver->options.elimination_threads = threads;
 #endif
-    }
-  return res;
+}
+
+/*------------------------------------------------------------------------*/
+
+void
+satch_set_terminate (struct satch *solver,
+		     void *state, int (*terminate) (void *state))
+{
+  REQUIRE_NON_ZERO_SOLVER ();
+  solver->terminate.function = terminate;
+  solver->terminate.state = state;
+}
+
+void
+satch_set_ticks_limit (struct satch *solver, long long ticks_limit)
+{
+  REQUIRE_NON_ZERO_SOLVER ();
+  solver->terminate.ticks = ticks_limit < 0 ? -1 : ticks_limit;
+}
+
+void
+satch_set_time_limit (struct satch *solver, double seconds)
+{
+  REQUIRE_NON_ZERO_SOLVER ();
+  solver->terminate.seconds = seconds < 0 ? -1 : seconds;
 }
 
 /*------------------------------------------------------------------------*/
@@ -12352,11 +19827,39 @@ satch_ascii_proof (struct satch *solver)
   solver->options.ascii = true;
 }
 
+void
+satch_asynchronous_proof (struct satch *solver)
+{
+  REQUIRE_NON_ZERO_SOLVER ();
+#ifndef NPORTFOLIO
+  solver->options.asynchronous = true;
+#endif
+}
+
+void
+satch_asynchronous_checking (struct satch *solver)
+{
+  REQUIRE_NON_ZERO_SOLVER ();
+#ifndef NDEBUG
+  checker_asynchronous (solver->checker);
+#endif
+}
+
 void
 satch_trace_proof (struct satch *solver, FILE * proof)
 {
   REQUIRE_NON_ZERO_SOLVER ();
+  REQUIRE (!proof || !solver->statistics.xors,
+	   "can not trace proofs with native XOR constraints");
+  release_tracer (solver);
   solver->proof = proof;
+  if (!proof)
+    return;
+  struct tracer *tracer = &solver->tracer;
+  tracer->begin = tracer->pos = malloc (proof_buffer_size);
+  if (!tracer->begin)
+    out_of_memory (proof_buffer_size);
+  tracer->end = tracer->begin + proof_buffer_size;
 }
 
 /*------------------------------------------------------------------------*/
@@ -12404,3 +19907,206 @@ satch_conflicts (struct satch *solver)
   const uint64_t conflicts = solver->statistics.conflicts;
   return (conflicts > (uint64_t) INT_MAX) ? INT_MAX : conflicts;
 }
+
+// Profiles which are still running (on the profile stack) are not flushed
+// here but the time spent so far is added.  This allows to query these
+// statistics from a terminate call-back during solving.
+
+static double
+current_profile_time (struct satch *solver,
+		      struct profile *profile, double now)
+{
+  double res = profile->time;
+  for (all_pointers_on_stack (struct profile, running, solver->profiles))
+    if (running == profile)
+      res += now - profile->start;
+  return res;
+}
+
+void
+satch_get_statistics (struct satch *solver, struct satch_stats *stats)
+{
+  REQUIRE_NON_ZERO_SOLVER ();
+  REQUIRE (stats, "zero statistics argument");
+  memset (stats, 0, sizeof *stats);
+  const struct statistics *const s = &solver->statistics;
+  stats->conflicts = s->conflicts;
+  stats->allocations = s->allocations;
+  stats->decisions = s->decisions;
+  stats->propagations = s->propagations;
+  stats->ticks = s->ticks;
+  stats->focused_ticks = s->mode_ticks[0];
+  stats->stable_ticks = s->mode_ticks[1];
+  stats->visited = s->visited;
+#ifndef NBLOCK
+  stats->blocked = s->blocked;
+#endif
+  stats->searched = s->searched;
+#ifndef NCACHE
+  stats->cached = s->cached;
+#endif
+  stats->deduced = s->deduced;
+#ifndef NMINIMIZE
+  stats->minimized = s->minimized;
+#endif
+#ifndef NSHRINK
+  stats->shrunken = s->shrunken;
+#endif
+  stats->learned = s->learned;
+#ifndef NRESTART
+  stats->restarts = s->restarts;
+#endif
+#ifndef NREDUCE
+  stats->reductions = s->reductions;
+  stats->reduced = s->reduced;
+#endif
+#ifndef NELIMINATION
+  stats->eliminations = s->eliminations;
+  stats->eliminated = s->eliminated;
+  stats->elimination_ticks = s->elimination_ticks;
+#endif
+#ifndef NSUBSUMPTION
+  stats->subsumptions = s->subsumptions;
+  stats->strengthened = s->strengthened;
+  stats->subsumption_ticks = s->subsumption_ticks;
+#endif
+#if !defined (NSUBSUMPTION) || !defined (NVIVIFICATION)
+  stats->subsumed = s->subsumed;
+#endif
+#ifndef NVIVIFICATION
+  stats->vivifications = s->vivifications;
+  stats->vivified = s->vivified;
+  stats->vivification_ticks = s->probing_ticks;
+#endif
+#ifndef NPROBING
+  stats->probings = s->probings;
+  stats->probed = s->probed;
+  stats->failed = s->failed;
+  stats->substituted = s->substituted;
+  stats->probe_ticks = s->probe_ticks;
+#endif
+  stats->fixed = s->fixed;
+  stats->memory = maximum_resident_set_size ();
+
+  const double now = process_time ();
+  struct profiles *const p = &solver->profiles;
+#define TIME(NAME) current_profile_time (solver, &p->NAME, now)
+#ifndef NELIMINATION
+  stats->eliminate_time = TIME (eliminate);
+#endif
+#ifndef NSUBSUMPTION
+  stats->subsume_time = TIME (subsume);
+#endif
+#ifndef NVIVIFICATION
+  stats->vivify_time = TIME (vivify);
+#endif
+#ifndef NPROBING
+  stats->probe_time = TIME (probe);
+#endif
+#ifndef NREDUCE
+  stats->reduce_time = TIME (reduce);
+#endif
+#ifndef NFOCUSED
+  stats->focused_time = TIME (focused);
+#endif
+#ifndef NSTABLE
+  stats->stable_time = TIME (stable);
+#endif
+  stats->parse_time = TIME (parse);
+  stats->solve_time = TIME (solve);
+#undef TIME
+  stats->process_time = now;
+}
+
+/*------------------------------------------------------------------------*/
+
+// Enabling the timeline allocates the ring buffer of events and remembers
+// the time stamp counter and wall-clock time to convert time stamps later.
+
+void
+satch_enable_timeline (struct satch *solver)
+{
+  REQUIRE_NON_ZERO_SOLVER ();
+#ifdef TIMELINE
+  struct timeline *timeline = &solver->timeline;
+  if (timeline->events)
+    return;
+  const size_t bytes = timeline_size * sizeof *timeline->events;
+  if (!(timeline->events = malloc (bytes)))
+    out_of_memory (bytes);
+  timeline->time = wall_clock_time ();
+  timeline->cycles = timeline_cycles ();
+#endif
+}
+
+#ifdef TIMELINE
+
+// Each event is written as complete event ('X') with conflicts and ticks
+// at entry and those during the event as arguments, followed by counter
+// events ('C') at exit for plotting conflicts and ticks over time.
+
+static void
+write_timeline (struct satch *solver, FILE * file)
+{
+  const struct timeline *const timeline = &solver->timeline;
+  const uint64_t recorded = timeline->recorded;
+  const uint64_t dropped =
+    recorded > timeline_size ? recorded - timeline_size : 0;
+
+  // Time stamps are given in microseconds since enabling the timeline.
+
+  const uint64_t cycles = timeline_cycles () - timeline->cycles;
+  const double elapsed = 1e6 * (wall_clock_time () - timeline->time);
+  const double microseconds_per_cycle = relative (elapsed, cycles);
+
+  fputs ("{\"traceEvents\":[\n", file);
+  for (uint64_t i = dropped; i != recorded; i++)
+    {
+      const struct event *const event =
+	timeline->events + (i & (timeline_size - 1));
+      const struct moment *const begin = &event->begin;
+      const struct moment *const end = &event->end;
+      const double ts =
+	microseconds_per_cycle * (begin->cycles - timeline->cycles);
+      const double stop =
+	microseconds_per_cycle * (end->cycles - timeline->cycles);
+      fprintf (file,
+	       "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+	       "\"ts\":%.3f,\"dur\":%.3f,\"args\":{"
+	       "\"conflicts\":%" PRIu64 ",\"ticks\":%" PRIu64 ","
+	       "\"new_conflicts\":%" PRIu64 ",\"new_ticks\":%" PRIu64 "}},\n",
+	       event->name, ts, stop - ts, begin->conflicts, begin->ticks,
+	       end->conflicts - begin->conflicts, end->ticks - begin->ticks);
+      fprintf (file,
+	       "{\"name\":\"conflicts\",\"ph\":\"C\",\"pid\":1,"
+	       "\"ts\":%.3f,\"args\":{\"conflicts\":%" PRIu64 "}},\n",
+	       stop, end->conflicts);
+      fprintf (file,
+	       "{\"name\":\"ticks\",\"ph\":\"C\",\"pid\":1,"
+	       "\"ts\":%.3f,\"args\":{\"ticks\":%" PRIu64 "}},\n",
+	       stop, end->ticks);
+    }
+  fprintf (file,
+	   "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+	   "\"args\":{\"name\":\"satch\"}}\n"
+	   "],\"displayTimeUnit\":\"ms\",\"otherData\":{"
+	   "\"recorded\":%" PRIu64 ",\"dropped\":%" PRIu64 "}}\n",
+	   recorded, dropped);
+}
+
+#endif
+
+void
+satch_write_timeline (struct satch *solver, FILE * file)
+{
+  REQUIRE_NON_ZERO_SOLVER ();
+  REQUIRE (file, "zero file argument");
+#ifdef TIMELINE
+  if (solver->timeline.events)
+    {
+      write_timeline (solver, file);
+      return;
+    }
+#endif
+  fputs ("{\"traceEvents\":[]}\n", file);
+}
@@ -8,15 +8,16 @@
 // The parser and witness printer implemented in the stand-alone solver
 // front-end 'main.c' are not considered to be part of the library.
 
+#include <stdint.h>
 #include <stdio.h>
 
 /*========================================================================*/
 
 // Functions with IPASIR semantics are listed in this section.
 
-// The solver is only partially incremental as it is not allowed to add
-// clauses after returning from 'satch_solve'.  Furthermore 'satch_assume',
-// 'satch_set_terminate', and 'satch_set_learn' are missing too.
+// The solver is incremental, i.e., clauses can be added after returning
+// from 'satch_solve' and literals can be assumed, but 'satch_set_learn' is
+// missing.
 
 struct satch;			// One solver instance.
 
@@ -32,13 +33,19 @@ void satch_release (struct satch *);	// Release solver.
 // Add literals and thus clauses to the solver, where a zero literal
 // terminates a clause.  Trivial or (root-level) satisfied are implicitly
 // dropped.  You further have to make sure to add a clause completely (add
-// the zero literal) before calling 'satch_solve'.
+// the zero literal) before calling 'satch_assume' or 'satch_solve'.
 
 // Literals have to be different from 'INT_MIN' on a 64-bit machine and its
 // absolute value smaller or equal to '2^30' on a 32-bit machine.
 
 void satch_add (struct satch *, int literal);
 
+// Assume the given literal for the next call to 'satch_solve'.  After that
+// call all assumptions are removed again.  Eliminated variables of assumed
+// literals are reactivated and assumed variables are not eliminated.
+
+void satch_assume (struct satch *, int literal);
+
 // Solve the current formula.  The routine returns the solution status
 // encoded as above 'UNKNOW=0', 'SATISFIABLE=10', or 'UNSATISFIABLE=20'.
 // The second argument if non-negative limits the number of conflicts
@@ -53,6 +60,21 @@ int satch_solve (struct satch *, int conflict_limit_non_negative);
 
 int satch_val (struct satch *, int literal);
 
+// If 'satch_solve' returns 'UNSATISFIABLE=20' then (before adding further
+// clauses or assumptions) you can query whether an assumed literal was
+// part of the set of failed assumptions which made the formula unsatisfiable.
+// The function returns '1' if this is the case and '0' otherwise.
+
+int satch_failed (struct satch *, int literal);
+
+// Set a call-back function which is polled during 'satch_solve' (in the
+// main search loop but also during elimination and vivification) and
+// forces the solver to return 'UNKNOWN=0' as soon as it returns non-zero.
+// The 'state' argument is passed on to the call-back function.
+
+void satch_set_terminate (struct satch *, void *state,
+			  int (*terminate) (void *state));
+
 /*========================================================================*/
 
 /*------------------------------------------------------------------------*/
@@ -65,6 +87,32 @@ void satch_add_binary_clause (struct satch *, int, int);
 void satch_add_ternary_clause (struct satch *, int, int, int);
 void satch_add_quaternary_clause (struct satch *, int, int, int, int);
 
+// Add a whole clause of 'size' non-zero literals at once or a sequence of
+// zero terminated clauses ('size' literals in total including the zeroes,
+// as in the body of a DIMACS file).  This avoids the per literal overhead
+// of 'satch_add' and is faster for programmatically generated formulas.
+
+void satch_add_clause (struct satch *, const int *literals, size_t size);
+void satch_add_clauses (struct satch *, const int *literals, size_t size);
+
+// Add an XOR constraint over 'size' non-zero literals which requires an odd
+// number of them to be true (as 'x' lines in the XNF variant of DIMACS).
+// Instead of encoding it into clauses the solver propagates it natively.
+// Variables in XOR constraints are frozen (not eliminated).  Proofs can not
+// be traced if XORs are added and portfolio solving is not used then.
+
+void satch_add_xor (struct satch *, const int *literals, size_t size);
+
+/*------------------------------------------------------------------------*/
+
+// Bulk version of 'satch_val' for embedding applications, which after
+// 'satch_solve' returned 'SATISFIABLE=10' sets 'values[idx]' to '1' if
+// variable 'idx' is assigned to 'true' and to '-1' otherwise for all
+// variables 'idx' from '1' to 'max_var' (and 'values[0]' to zero).  Thus
+// 'values' needs to have room for 'max_var + 1' elements.
+
+void satch_values (struct satch *, signed char *values, int max_var);
+
 /*------------------------------------------------------------------------*/
 
 // Allocate and activate the given number of variables.  This avoids
@@ -73,6 +121,66 @@ void satch_add_quaternary_clause (struct satch *, int, int, int, int);
 
 void satch_reserve (struct satch *, int maximum_variable_index);
 
+// Save a snapshot of the solver to a binary file, which can later be loaded
+// into a new solver to resume solving without losing irredundant and kept
+// redundant clauses (up to glue six), eliminated variables, phases and the
+// decision order.  Both return zero on success and otherwise an error
+// message.  Snapshots are memory mapped while loading if possible.  After
+// loading fails the solver should be released.  Loading does not restore
+// options, limits and statistics and proofs can not be traced for loaded
+// clauses (thus loading while tracing a proof is not allowed).
+
+const char *satch_save (struct satch *, FILE *);
+const char *satch_load (struct satch *, FILE *);
+
+// Split the formula for cube-and-conquer into cubes of at most 'depth'
+// decisions (and implied literals) by a look-ahead search tree, which picks
+// among the variables with the highest decision heuristic scores the one
+// with the most propagated literals in both phases.  Thus calling
+// 'satch_solve' with a small conflict limit first to learn clauses and
+// initialize scores usually gives better cubes.  For each cube the call-back
+// gets its 'size' literals, which then can be solved (as assumptions) by
+// another solver.  Refuted branches do not produce cubes.  The function
+// returns 'UNSATISFIABLE=20' if all branches are refuted (the empty clause
+// is only traced in a proof if the root-level becomes inconsistent),
+// 'SATISFIABLE=10' if a model was found (which then can be queried) and
+// otherwise 'UNKNOWN=0'.  If the ticks or time limit or the terminate
+// call-back stop cubing early, then remaining open branches become (shorter)
+// cubes, so the cubes still cover the search space.  Assumptions are not
+// allowed.
+
+int satch_cube (struct satch *, int depth, void *state,
+		void (*cube) (void *state, int size, const int *literals));
+
+// Solve the formula with a portfolio of diversified solver threads, which
+// share learned units and clauses with small glue.  The first thread
+// returning a result wins.  It falls back to 'satch_solve' if 'threads' is
+// one, proofs are traced, literals are assumed, this is not the first call
+// to solve the formula or portfolio solving was disabled at compile time.
+
+int satch_solve_parallel (struct satch *, int threads, int conflict_limit);
+
+// Compute resolvents during bounded variable elimination with the given
+// number of threads (default is one).  Batches of pivots which do not occur
+// in the clauses of each other are resolved in parallel and then eliminated
+// in a fixed order, so the result is the same for any number of at least two
+// threads.  It differs from (and usually eliminates fewer variables than)
+// the sequential elimination used with one thread, which considers pivots
+// in a different order.  This has no effect if portfolio solving was
+// disabled at compile time.
+
+void satch_set_elimination_threads (struct satch *, int threads);
+
+// Limit the number of ticks (cache line accesses during propagation and
+// inprocessing) or the wall-clock time in seconds of each following call
+// to 'satch_solve' relative to the start of that call.  The solver returns
+// 'UNKNOWN=0' if the limit is hit.  Unlike the time limit and terminate
+// call-back the ticks limit gives deterministic results.  A negative
+// argument removes the limit (the default).
+
+void satch_set_ticks_limit (struct satch *, long long ticks_limit);
+void satch_set_time_limit (struct satch *, double seconds);
+
 // By default the library does not print any messages (the solver executable
 // however does switch on 'verbose' messages by default unless '-q' is
 // specified). There are four non-zero levels of verbose messages.
@@ -96,10 +204,29 @@ void satch_enable_logging_messages (struct satch *);
 
 void satch_ascii_proof (struct satch *);
 
-// Trace DRAT (actually a DRUP) proof to the given file.
+// Trace DRAT (actually a DRUP) proof to the given file.  Proof lines are
+// buffered internally and only written to the file if the buffer is full,
+// at the end of 'satch_solve' and in 'satch_release' (or when switching to
+// another file by calling this function again, for instance with a zero
+// file argument).  Thus the file should not be closed before that.
 
 void satch_trace_proof (struct satch *, FILE *);
 
+// Write full proof buffers to the proof file in a separate writer thread
+// while solving continues.  This has no effect if the library was
+// configured without portfolio support ('--no-portfolio'), which also
+// disables POSIX threads.
+
+void satch_asynchronous_proof (struct satch *);
+
+// In debugging builds ('./configure -g') all proof steps are checked by the
+// internal proof checker.  This function lets the checker run in a separate
+// thread which checks proof steps while solving continues.  This has no
+// effect if checking is disabled ('NDEBUG') or portfolio solving was
+// disabled at compile time ('--no-portfolio').
+
+void satch_asynchronous_checking (struct satch *);
+
 /*------------------------------------------------------------------------*/
 
 // Return largest added variable index.
@@ -122,6 +249,52 @@ void satch_statistics (struct satch *);
 
 int satch_conflicts (struct satch *);
 
+// Machine readable statistics for embedding applications and dashboards.
+// Counters of features which are disabled at configuration time stay zero.
+// Times are process time in seconds spent in the corresponding profile and
+// together with the number of rounds give the time per inprocessing round.
+
+struct satch_stats
+{
+  uint64_t conflicts, decisions, propagations;
+  uint64_t allocations;		// Clause memory allocations.
+  uint64_t ticks;		// Search ticks (propagation and analysis).
+  uint64_t focused_ticks;	// Propagation ticks in focused mode.
+  uint64_t stable_ticks;	// Propagation ticks in stable mode.
+  uint64_t visited;		// Visited watches during propagation.
+  uint64_t blocked;		// Watches skipped due to blocking literals.
+  uint64_t searched;		// Replacement searches in long clauses.
+  uint64_t cached;		// Replacements found from cached position.
+  uint64_t deduced;		// Deduced literals (of 1st UIP clauses).
+  uint64_t minimized;		// Removed by minimization.
+  uint64_t shrunken;		// Removed by shrinking.
+  uint64_t learned;		// Learned literals.
+  uint64_t restarts, reductions, reduced;
+  uint64_t eliminations, eliminated, elimination_ticks;
+  uint64_t subsumptions, subsumed, strengthened, subsumption_ticks;
+  uint64_t vivifications, vivified, vivification_ticks;
+  uint64_t probings, probed, failed, substituted, probe_ticks;
+  uint64_t fixed;		// Root level assigned variables.
+  uint64_t memory;		// Maximum resident set size in bytes.
+  double eliminate_time, subsume_time, vivify_time, reduce_time;
+  double probe_time, focused_time, stable_time, parse_time, solve_time;
+  double process_time;		// Total process time.
+};
+
+void satch_get_statistics (struct satch *, struct satch_stats *);
+
+// Record entry and exit of restarts, rephasing, reductions, search modes
+// and inprocessing rounds together with conflicts and ticks at that point
+// with time stamp counter based time stamps in a ring buffer of the most
+// recent events.  This needs the library to be configured with
+// '--timeline' and otherwise enabling has no effect.  The recorded events
+// are written as Chrome trace (JSON) to be viewed with 'chrome://tracing'
+// or Perfetto ('ui.perfetto.dev').  Without events an empty trace is
+// written.
+
+void satch_enable_timeline (struct satch *);
+void satch_write_timeline (struct satch *, FILE *);
+
 /*------------------------------------------------------------------------*/
 
 // Record and compute time spent in parsing.
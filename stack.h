@@ -66,6 +66,55 @@ do { \
   *(S).end++ = (E); \
 } while (0)
 
+// Make room for 'N' more elements with at most one reallocation, which
+// allows to push them afterwards without checking for a full stack.
+
+#define RESERVE_STACK(S,N) \
+do { \
+  const size_t old_size = SIZE_STACK (S); \
+  const size_t new_size = old_size + (N); \
+  size_t new_capacity = CAPACITY_STACK (S); \
+  if (new_size <= new_capacity) \
+    break; \
+  if (!new_capacity) \
+    new_capacity = 1; \
+  while (new_capacity < new_size) \
+    new_capacity *= 2; \
+  const size_t new_bytes = new_capacity * sizeof *(S).begin; \
+  (S).begin = realloc ((S).begin, new_bytes); \
+  if (!(S).begin) \
+    fatal_error ("out-of-memory reallocating '%zu' bytes", new_bytes); \
+  (S).end = (S).begin + old_size; \
+  (S).allocated = (S).begin + new_capacity; \
+} while (0)
+
+// Give back memory of stacks which are at most a quarter full by shrinking
+// the capacity to the smallest power of two not smaller than their size.
+// Together with doubling the capacity in 'ENLARGE_STACK' this keeps the
+// cost of reallocation amortized linear.
+
+#define SHRINK_STACK(S) \
+do { \
+  const size_t old_size = SIZE_STACK (S); \
+  const size_t old_capacity = CAPACITY_STACK (S); \
+  if (old_capacity < 4 * old_size + 4) \
+    break; \
+  if (!old_size) \
+    { \
+      RELEASE_STACK (S); \
+      break; \
+    } \
+  size_t new_capacity = 1; \
+  while (new_capacity < old_size) \
+    new_capacity *= 2; \
+  const size_t new_bytes = new_capacity * sizeof *(S).begin; \
+  (S).begin = realloc ((S).begin, new_bytes); \
+  if (!(S).begin) \
+    fatal_error ("out-of-memory reallocating '%zu' bytes", new_bytes); \
+  (S).end = (S).begin + old_size; \
+  (S).allocated = (S).begin + new_capacity; \
+} while (0)
+
 /*------------------------------------------------------------------------*/
 
 // Flush all elements.
@@ -26,12 +26,18 @@ msg () {
 
 msg "SATCH Version `./satch --version` `./satch --id`"
 
+# Proofs and other files written by the tests go to a temporary directory,
+# which is removed on exit.
+
+tmp="`mktemp -d ${TMPDIR:-/tmp}/tatch-XXXXXX`" || \
+  die "could not create temporary directory"
+trap 'rm -rf "$tmp"' 0
+trap 'exit 1' 1 2 15
+
 drattrim="`type drat-trim 2>/dev/null |awk '{print $NF}'`"
 
 if [ "$drattrim" ]
 then
-  rm -f cnfs/false.proof
-  touch cnfs/false.proof
   if [ "`$drattrim cnfs/false.cnf cnfs/false.cnf 2>/dev/null|grep VERIFIED`" ]
   then
     msg "checking proofs with '$drattrim'"
@@ -62,12 +68,12 @@ run () {
     esac
     if [ $xnf = no ]
     then
-      proofpath=cnfs/`basename $cnf .cnf`.proof
+      proofpath=$tmp/`basename $cnf .cnf`.proof
       rm -f $proofpath 2>/dev/null || die "failed to 'rm -f $proofpath'"
       options=""
       case $proofsmod3 in
 	0) proofsmod3=1; ;;
-	1) proofsmod3=2; proof="$proofpath";;
+	1) proofsmod3=2; options="--async-proof"; proof="$proofpath";;
 	2) proofsmod3=0; options="-a"; proof="$proofpath";;
       esac
       [ "$options" ] && command="$command $options"
@@ -209,8 +215,49 @@ run 10 ./satch xnfs/xor11.xnf
 run 10 ./satch xnfs/xor12.xnf
 run 10 ./satch xnfs/xor24.xnf
 
+run 20 ./satch xnfs/false.xnf --encode-xors
+run 20 ./satch xnfs/unit3.xnf --encode-xors
+run 10 ./satch xnfs/xor12.xnf --encode-xors
+run 10 ./satch xnfs/xor24.xnf --encode-xors
+run 10 ./satch xnfs/xor24.xnf -f
+run 20 ./satch xnfs/false.xnf -f /dev/null
+
 run 10 ./satch cnfs/regr1.cnf
 
+run 20 ./satch cnfs/ph6.cnf --strict
+run 10 ./satch xnfs/xor24.xnf --strict
+run 10 ./satch cnfs/prime2209.cnf --strict
+run 10 ./satch cnfs/prime2209.cnf --binary-witness
+run 10 ./satch cnfs/prime2209.cnf --ticks=5000000000
+[ $learning = no ] && [ $dlis = no ] && \
+run 20 ./satch cnfs/prime65537.cnf --stats=json
+run 10 ./satch cnfs/prime2209.cnf --stats=json=$tmp/prime2209.json
+run 10 ./satch cnfs/prime2209.cnf --stats=json --binary-witness
+
+run 20 ./satch cnfs/ph6.cnf --threads=2
+run 20 ./satch cnfs/add4.cnf --threads=4
+run 10 ./satch cnfs/prime2209.cnf --threads=2
+run 10 ./satch cnfs/sqrt1042441.cnf --threads=4
+[ $learning = no ] && [ $dlis = no ] && \
+run 20 ./satch cnfs/add16.cnf --elimination-threads=4
+run 10 ./satch cnfs/prime2209.cnf --elimination-threads=2
+run 20 ./satch cnfs/ph6.cnf --async-check
+run 10 ./satch cnfs/prime2209.cnf --async-check
+if [ $learning = no ] && [ $dlis = no ];
+then
+run 0 ./satch cnfs/prime1681.cnf --conflicts=20 --save=$tmp/prime1681.snapshot
+run 10 ./satch --load=$tmp/prime1681.snapshot
+rm -f $tmp/prime1681.snapshot
+fi
+run 0 ./satch cnfs/ph5.cnf --cubes=$tmp/ph5.icnf --cube-depth=3
+rm -f $tmp/ph5.icnf
+run 0 ./satch cnfs/ph5.cnf --cubes=/dev/null --cube-depth=2 --conflicts=10
+if [ x"`grep DTIMELINE makefile`" != x ]
+then
+run 10 ./satch cnfs/prime2209.cnf --timeline=$tmp/prime2209.trace
+rm -f $tmp/prime2209.trace
+fi
+
 [ $learning = no ] && [ $dlis = no ] && \
 run 20 ./satch cnfs/prime65537.cnf
 
@@ -234,7 +281,7 @@ compile="$compiler -c testapi.c"
 echo $compile
 $compile || die "compilation failed"
 
-compile="$compiler -o testapi testapi.o -L. -lsatch -lm"
+compile="$compiler -o testapi testapi.o -L. -lsatch -lm -lpthread"
 echo $compile
 $compile || die "linking failed"
 
@@ -243,7 +290,7 @@ run 0 ./testapi
 msg "compiling 'testapi.c' directly without linking against library"
 
 compiler="`echo "$compiler"|sed 's, -DNDEBUG,,'`"
-compile="$compiler -DNDEBUG -o testapi testapi.c satch.c -lm"
+compile="$compiler -DNDEBUG -o testapi testapi.c satch.c -lm -lpthread"
 echo $compile
 $compile || die "compilation failed"
 run 0 ./testapi
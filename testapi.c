@@ -1,10 +1,72 @@
 #include "satch.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #undef NDEBUG
 #include <assert.h>
 
+static int
+terminate_after_three_calls (void *state)
+{
+  int *calls = state;
+  return ++*calls > 3;
+}
+
+// Pigeon hole formula where the clauses requiring each pigeon to be in a
+// hole are satisfied by the 'relax' literal unless it is zero.
+
+static void
+add_relaxed_pigeon_hole (struct satch *solver, int holes, int relax)
+{
+#define PIGEON(P,H) (1 + (P) * holes + (H))
+  for (int p = 0; p <= holes; p++)
+    {
+      for (int h = 0; h < holes; h++)
+	satch_add (solver, PIGEON (p, h));
+      if (relax)
+	satch_add (solver, relax);
+      satch_add (solver, 0);
+    }
+  for (int h = 0; h < holes; h++)
+    for (int p = 0; p <= holes; p++)
+      for (int q = p + 1; q <= holes; q++)
+	satch_add (solver, -PIGEON (p, h)),
+	  satch_add (solver, -PIGEON (q, h)), satch_add (solver, 0);
+#undef PIGEON
+}
+
+static void
+add_pigeon_hole (struct satch *solver, int holes)
+{
+  add_relaxed_pigeon_hole (solver, holes, 0);
+}
+
+// Cubes are collected zero terminated on a fixed size array.
+
+struct cubes
+{
+  int count, size, literals[1 << 12];
+};
+
+static void
+collect_cube (void *state, int size, const int *literals)
+{
+  struct cubes *cubes = state;
+  assert (cubes->size + size < (int) (sizeof cubes->literals / sizeof (int)));
+  for (int i = 0; i < size; i++)
+    cubes->literals[cubes->size++] = literals[i];
+  cubes->literals[cubes->size++] = 0;
+  cubes->count++;
+}
+
+static void
+add_ternary (struct satch *solver, int a, int b, int c)
+{
+  satch_add (solver, a), satch_add (solver, b), satch_add (solver, c);
+  satch_add (solver, 0);
+}
+
 int
 main (void)
 {
@@ -71,5 +133,581 @@ main (void)
     assert (res == 20);
     satch_release (solver);
   }
+  {
+    struct satch *solver = satch_init ();
+    for (int r = -1; r <= 1; r += 2)
+      for (int s = -1; s <= 1; s += 2)
+	for (int t = -1; t <= 1; t += 2)
+	  satch_add (solver, r * 1), satch_add (solver, s * 2),
+	    satch_add (solver, t * 3), satch_add (solver, 0);
+    int res = satch_solve_parallel (solver, 4, -1);
+    assert (res == 20);
+    satch_release (solver);
+  }
+  {
+    struct satch *solver = satch_init ();
+    satch_add (solver, 1), satch_add (solver, 2), satch_add (solver, 0);
+    satch_add (solver, -1), satch_add (solver, 3), satch_add (solver, 0);
+    satch_add (solver, -2), satch_add (solver, -3), satch_add (solver, 0);
+    satch_add (solver, 4), satch_add (solver, 0);
+    int res = satch_solve_parallel (solver, 3, -1);
+    assert (res == 10);
+    assert (satch_val (solver, 4) == 4);
+    int a = satch_val (solver, 1) > 0, b = satch_val (solver, 2) > 0;
+    int c = satch_val (solver, 3) > 0;
+    assert (a || b), assert (!a || c), assert (!b || !c);
+    satch_release (solver);
+  }
+  {
+    struct satch *solver = satch_init ();
+    satch_add (solver, 1), satch_add (solver, 2), satch_add (solver, 0);
+    satch_add (solver, -1), satch_add (solver, 3), satch_add (solver, 0);
+    satch_assume (solver, -2), satch_assume (solver, -3);
+    int res = satch_solve (solver, -1);
+    assert (res == 20);
+    assert (satch_failed (solver, -2));
+    assert (satch_failed (solver, -3));
+    res = satch_solve (solver, -1);
+    assert (res == 10);
+    satch_add (solver, -3), satch_add (solver, 0);
+    satch_assume (solver, -2), satch_assume (solver, 4);
+    res = satch_solve (solver, -1);
+    assert (res == 20);
+    assert (satch_failed (solver, -2));
+    assert (!satch_failed (solver, 4));
+    satch_assume (solver, 4);
+    res = satch_solve (solver, -1);
+    assert (res == 10);
+    assert (satch_val (solver, 1) == -1);
+    assert (satch_val (solver, 2) == 2);
+    assert (satch_val (solver, 3) == -3);
+    assert (satch_val (solver, 4) == 4);
+    satch_release (solver);
+  }
+  {
+    // Variable '7' only occurs in a tautological clause added after solving
+    // and thus increases the size of the solver without being activated.
+
+    struct satch *solver = satch_init ();
+    add_ternary (solver, 3, 4, -1);
+    int res = satch_solve (solver, -1);
+    assert (res == 10);
+    satch_add (solver, -3), satch_add (solver, 0);
+    satch_add (solver, 7), satch_add (solver, 1), satch_add (solver, 3);
+    satch_add (solver, -1), satch_add (solver, 0);
+    res = satch_solve (solver, -1);
+    assert (res == 10);
+    assert (satch_val (solver, 3) == -3);
+    satch_release (solver);
+  }
+  {
+    // Incremental sequential solving after portfolio solving, where the
+    // model might have been copied from another worker.  Blocking the model
+    // has to give the same result as solving the same formula from scratch.
+
+    enum { variables = 150, clauses = 600, size = 3 };
+    for (unsigned seed = 1; seed <= 4; seed++)
+      {
+	struct satch *solver = satch_init ();
+	struct satch *fresh = satch_init ();
+	unsigned state = seed;
+#define PICK(MOD) (state = state * 1103515245u + 12345u, \
+                   (int) ((state >> 16) % (MOD)))
+	for (int i = 0; i < clauses; i++)
+	  {
+	    for (int j = 0; j < size; j++)
+	      {
+		int lit = PICK (variables) + 1;
+		if (PICK (2))
+		  lit = -lit;
+		satch_add (solver, lit), satch_add (fresh, lit);
+	      }
+	    satch_add (solver, 0), satch_add (fresh, 0);
+	  }
+#undef PICK
+	int res = satch_solve_parallel (solver, 8, -1);
+	if (res == 10)
+	  {
+	    int blocking[variables + 1];
+	    for (int idx = 1; idx <= variables; idx++)
+	      blocking[idx] = -satch_val (solver, idx);
+	    for (int idx = 1; idx <= variables; idx++)
+	      satch_add (solver, blocking[idx]),
+		satch_add (fresh, blocking[idx]);
+	    satch_add (solver, 0), satch_add (fresh, 0);
+	    res = satch_solve (solver, -1);
+	    assert (res == satch_solve (fresh, -1));
+	  }
+	satch_release (fresh);
+	satch_release (solver);
+      }
+  }
+  {
+    // Random 3-CNF with incrementally added clauses and assumptions.  It
+    // starts with an unsatisfiable pigeon hole formula guarded by 'guard'.
+    // Solving it under the assumption 'guard' produces enough conflicts to
+    // trigger variable elimination and the random clauses added later over
+    // the same variables then reactivate the eliminated variables.
+
+    enum { variables = 50, rounds = 30, size = 3, holes = 6 };
+    struct satch *solver = satch_init ();
+    const int guard = 1;
+#define PIGEON(P,H) (guard + 1 + (P) * holes + (H))
+    for (int p = 0; p <= holes; p++)
+      {
+	satch_add (solver, -guard);
+	for (int h = 0; h < holes; h++)
+	  satch_add (solver, PIGEON (p, h));
+	satch_add (solver, 0);
+      }
+    for (int h = 0; h < holes; h++)
+      for (int p = 0; p <= holes; p++)
+	for (int q = p + 1; q <= holes; q++)
+	  satch_add (solver, -guard), satch_add (solver, -PIGEON (p, h)),
+	    satch_add (solver, -PIGEON (q, h)), satch_add (solver, 0);
+#undef PIGEON
+    satch_assume (solver, guard);
+    int res = satch_solve (solver, -1);
+    assert (res == 20);
+    assert (satch_failed (solver, guard));
+    satch_add (solver, -guard), satch_add (solver, 0);
+    int *clauses = 0;
+    size_t added = 0, allocated = 0;
+    unsigned state = 42;
+#define PICK(MOD) (state = state * 1103515245u + 12345u, \
+                   (int) ((state >> 16) % (MOD)))
+    for (int round = 0; round < rounds; round++)
+      {
+	const int new_clauses = round ? 20 : 4 * variables;
+	for (int i = 0; i < new_clauses; i++)
+	  {
+	    if (added + size + 1 > allocated)
+	      {
+		allocated = allocated ? 2 * allocated : 1024;
+		clauses = realloc (clauses, allocated * sizeof *clauses);
+		assert (clauses);
+	      }
+	    for (int j = 0; j < size; j++)
+	      {
+		int lit = PICK (variables) + 2;
+		if (PICK (2))
+		  lit = -lit;
+		satch_add (solver, lit);
+		clauses[added++] = lit;
+	      }
+	    satch_add (solver, 0);
+	    clauses[added++] = 0;
+	  }
+	int assumptions[4], assumed = 0;
+	while (assumed < 4)
+	  {
+	    int lit = PICK (variables) + 2;
+	    if (PICK (2))
+	      lit = -lit;
+	    satch_assume (solver, lit);
+	    assumptions[assumed++] = lit;
+	  }
+	res = satch_solve (solver, -1);
+	if (res == 10)
+	  {
+	    for (int i = 0; i < assumed; i++)
+	      assert (satch_val (solver, assumptions[i]) == assumptions[i]);
+	    int satisfied = 0;
+	    for (size_t i = 0; i < added; i++)
+	      {
+		const int lit = clauses[i];
+		if (!lit)
+		  assert (satisfied), satisfied = 0;
+		else if (satch_val (solver, lit) == lit)
+		  satisfied = 1;
+	      }
+	  }
+	else
+	  {
+	    assert (res == 20);
+	    int failed = 0;
+	    for (int i = 0; i < assumed; i++)
+	      failed += satch_failed (solver, assumptions[i]);
+	    if (!failed)
+	      break;
+	  }
+      }
+#undef PICK
+    free (clauses);
+    satch_release (solver);
+  }
+  {
+    // Bulk addition with duplicated literals, a tautological clause, an
+    // empty clause list and a root-level satisfied clause.
+
+    struct satch *solver = satch_init ();
+    const int first[] = { 1, 2, 1 }, second[] = { 3, -3, 4 };
+    satch_add_clause (solver, first, 3);
+    satch_add_clause (solver, second, 3);
+    satch_add_clauses (solver, 0, 0);
+    const int clauses[] = { -1, 2, 0, 1, -2, 0, -2, 0, 2, 5, 0 };
+    satch_add_clauses (solver, clauses, sizeof clauses / sizeof *clauses);
+    int res = satch_solve (solver, -1);
+    assert (res == 20);
+    satch_release (solver);
+    solver = satch_init ();
+    satch_add_clauses (solver, clauses, 6);
+    res = satch_solve (solver, -1);
+    assert (res == 10);
+    assert ((satch_val (solver, 1) > 0) == (satch_val (solver, 2) > 0));
+    signed char values[5];
+    satch_values (solver, values, 4);
+    assert (!values[0]);
+    for (int idx = 1; idx <= 4; idx++)
+      assert (values[idx] == (satch_val (solver, idx) > 0 ? 1 : -1));
+    satch_add_clause (solver, 0, 0);
+    res = satch_solve (solver, -1);
+    assert (res == 20);
+    satch_release (solver);
+  }
+  {
+    // Ticks, time and terminate call-back limits on a pigeon hole formula.
+    // Hitting the ticks limit has to be deterministic.
+
+    struct satch *first = satch_init ();
+    struct satch *second = satch_init ();
+    add_pigeon_hole (first, 6);
+    add_pigeon_hole (second, 6);
+    satch_set_ticks_limit (first, 2000);
+    satch_set_ticks_limit (second, 2000);
+    int res = satch_solve (first, -1);
+    assert (!res);
+    res = satch_solve (second, -1);
+    assert (!res);
+    assert (satch_conflicts (first) == satch_conflicts (second));
+    satch_release (second);
+    satch_set_ticks_limit (first, -1);
+    int calls = 0;
+    satch_set_terminate (first, &calls, terminate_after_three_calls);
+    res = satch_solve (first, -1);
+    assert (!res);
+    assert (calls == 4);
+    satch_set_terminate (first, 0, 0);
+    satch_set_time_limit (first, 0);
+    res = satch_solve (first, -1);
+    assert (!res);
+    satch_set_time_limit (first, -1);
+    res = satch_solve (first, -1);
+    assert (res == 20);
+    satch_release (first);
+  }
+  {
+    // The buffered proof has to be complete after 'satch_solve' returns
+    // and be the same for synchronous and asynchronous proof writing.
+
+    struct satch *first = satch_init ();
+    struct satch *second = satch_init ();
+    FILE *first_file = tmpfile (), *second_file = tmpfile ();
+    assert (first_file), assert (second_file);
+    satch_trace_proof (first, first_file);
+    satch_asynchronous_proof (second);
+    satch_trace_proof (second, second_file);
+    add_pigeon_hole (first, 5);
+    add_pigeon_hole (second, 5);
+    int res = satch_solve (first, -1);
+    assert (res == 20);
+    res = satch_solve (second, -1);
+    assert (res == 20);
+    const long bytes = ftell (first_file);
+    assert (bytes > 0);
+    assert (ftell (second_file) == bytes);
+    rewind (first_file), rewind (second_file);
+    for (long i = 0; i < bytes; i++)
+      {
+	const int ch = getc (first_file);
+	assert (ch == 'a' || i);
+	assert (ch == getc (second_file));
+      }
+    satch_release (second);
+    satch_release (first);
+    fclose (second_file);
+    fclose (first_file);
+  }
+  {
+    // Checking proof steps in a separate thread has to give the same
+    // result also for incremental usage.
+
+    struct satch *solver = satch_init ();
+    satch_asynchronous_checking (solver);
+    add_pigeon_hole (solver, 4);
+    int res = satch_solve (solver, -1);
+    assert (res == 20);
+    satch_release (solver);
+    solver = satch_init ();
+    satch_asynchronous_checking (solver);
+    for (int i = 1; i < 8; i++)
+      add_ternary (solver, i, i + 1, -(i + 2));
+    res = satch_solve (solver, -1);
+    assert (res == 10);
+    satch_add (solver, -1), satch_add (solver, 0);
+    satch_add (solver, -2), satch_add (solver, 0);
+    res = satch_solve (solver, -1);
+    assert (res == 10);
+    satch_release (solver);
+  }
+  {
+    // Parallel elimination has to give the same result with any number of
+    // threads.
+
+    struct satch *first = satch_init ();
+    struct satch *second = satch_init ();
+    satch_set_elimination_threads (first, 2);
+    satch_set_elimination_threads (second, 4);
+    add_pigeon_hole (first, 5);
+    add_pigeon_hole (second, 5);
+    int res = satch_solve (first, -1);
+    assert (res == 20);
+    res = satch_solve (second, -1);
+    assert (res == 20);
+    assert (satch_conflicts (first) == satch_conflicts (second));
+    satch_release (second);
+    satch_release (first);
+  }
+  {
+    // Loading a snapshot saved after a conflict limit was hit has to give
+    // a solver which resumes with the same result.
+
+    struct satch *first = satch_init ();
+    add_pigeon_hole (first, 5);
+    int res = satch_solve (first, 10);
+    assert (!res);
+    FILE *file = tmpfile ();
+    assert (file);
+    const char *error = satch_save (first, file);
+    assert (!error);
+    rewind (file);
+    struct satch *second = satch_init ();
+    error = satch_load (second, file);
+    assert (!error);
+    assert (satch_maximum_variable (second) ==
+	    satch_maximum_variable (first));
+    res = satch_solve (second, -1);
+    assert (res == 20);
+    res = satch_solve (first, -1);
+    assert (res == 20);
+    satch_release (second);
+    satch_release (first);
+    fclose (file);
+  }
+  {
+    // Machine readable statistics have to be consistent with counters.
+
+    struct satch *solver = satch_init ();
+    add_pigeon_hole (solver, 6);
+    int res = satch_solve (solver, -1);
+    assert (res == 20);
+    struct satch_stats stats;
+    satch_get_statistics (solver, &stats);
+    assert (stats.conflicts == (uint64_t) satch_conflicts (solver));
+    assert (stats.propagations > 0);
+    assert (stats.visited >= stats.searched);
+    assert (stats.visited >= stats.searched + stats.blocked);
+    assert (stats.searched >= stats.cached);
+    assert (stats.focused_ticks + stats.stable_ticks <= stats.ticks);
+    assert (stats.deduced >= stats.learned);
+    assert (stats.solve_time <= stats.process_time);
+    satch_release (solver);
+  }
+  {
+    // Probing while solving under an assumption substitutes the chain of
+    // equivalent variables and finds the failed literal.  Their values
+    // have to be restored in later models and they can be reactivated.
+
+    struct satch *solver = satch_init ();
+    const int a = 100, f = 101, h = 102, x = 110, n = 10;
+    add_relaxed_pigeon_hole (solver, 6, a);
+    for (int i = 0; i + 1 < n; i++)
+      {
+	satch_add (solver, -(x + i)), satch_add (solver, x + i + 1);
+	satch_add (solver, 0);
+	satch_add (solver, x + i), satch_add (solver, -(x + i + 1));
+	satch_add (solver, 0);
+      }
+    satch_add (solver, -f), satch_add (solver, h), satch_add (solver, 0);
+    satch_add (solver, -f), satch_add (solver, -h), satch_add (solver, 0);
+    satch_assume (solver, -a);
+    int res = satch_solve (solver, -1);
+    assert (res == 20);
+    struct satch_stats stats;
+    satch_get_statistics (solver, &stats);
+    assert (stats.failed <= stats.probed);
+    assert (stats.substituted < (uint64_t) n);
+    res = satch_solve (solver, -1);
+    assert (res == 10);
+    assert (satch_val (solver, f) == -f);
+    const int sign = satch_val (solver, x) < 0 ? -1 : 1;
+    for (int i = 0; i < n; i++)
+      assert (satch_val (solver, x + i) == sign * (x + i));
+    satch_add (solver, -sign * (x + n / 2)), satch_add (solver, 0);
+    res = satch_solve (solver, -1);
+    assert (res == 10);
+    for (int i = 0; i < n; i++)
+      assert (satch_val (solver, x + i) == -sign * (x + i));
+    satch_release (solver);
+  }
+  {
+    // Elimination with gate detection of the XOR chain 't', the ITE gate
+    // 'm' and the AND gate 'g' on top of inputs 'i' while solving under an
+    // assumption.  Values of eliminated gates have to match their inputs.
+
+    struct satch *solver = satch_init ();
+    const int a = 100, i = 200, t = 300, m = 400, g = 401, n = 8;
+    add_relaxed_pigeon_hole (solver, 6, a);
+    satch_add (solver, t), satch_add (solver, -i), satch_add (solver, 0);
+    satch_add (solver, -t), satch_add (solver, i), satch_add (solver, 0);
+    for (int k = 1; k < n; k++)
+      {
+	add_ternary (solver, -(t + k), t + k - 1, i + k);
+	add_ternary (solver, -(t + k), -(t + k - 1), -(i + k));
+	add_ternary (solver, t + k, -(t + k - 1), i + k);
+	add_ternary (solver, t + k, t + k - 1, -(i + k));
+      }
+    add_ternary (solver, -m, -i, i + 1);
+    add_ternary (solver, -m, i, i + 2);
+    add_ternary (solver, m, -i, -(i + 1));
+    add_ternary (solver, m, i, -(i + 2));
+    for (int k = 3; k < 6; k++)
+      satch_add (solver, -g), satch_add (solver, i + k), satch_add (solver, 0);
+    satch_add (solver, g);
+    for (int k = 3; k < 6; k++)
+      satch_add (solver, -(i + k));
+    satch_add (solver, 0);
+    add_ternary (solver, t + n - 1, m, g);
+    satch_assume (solver, -a);
+    int res = satch_solve (solver, -1);
+    assert (res == 20);
+    res = satch_solve (solver, -1);
+    assert (res == 10);
+    int parity = 0;
+    for (int k = 0; k < n; k++)
+      {
+	parity ^= satch_val (solver, i + k) > 0;
+	assert ((satch_val (solver, t + k) > 0) == parity);
+      }
+    const int condition = satch_val (solver, i) > 0;
+    const int branch = condition ? i + 1 : i + 2;
+    assert ((satch_val (solver, m) > 0) == (satch_val (solver, branch) > 0));
+    int conjunction = 1;
+    for (int k = 3; k < 6; k++)
+      conjunction &= satch_val (solver, i + k) > 0;
+    assert ((satch_val (solver, g) > 0) == conjunction);
+    assert (parity || satch_val (solver, m) > 0 || conjunction);
+    satch_release (solver);
+  }
+  {
+    // Native XOR constraints of a random looking linear system while
+    // solving under an assumption.  Models have to satisfy all of them.
+
+    struct satch *solver = satch_init ();
+    const int a = 100, x = 200, m = 6, n = 12;
+    add_relaxed_pigeon_hole (solver, 4, a);
+    int literals[5];
+    for (int i = 0; i < m; i++)
+      {
+	for (int k = 0; k < 5; k++)
+	  literals[k] = (x + (i * 7 + k * 5) % n) * ((i + k) % 3 ? 1 : -1);
+	satch_add_xor (solver, literals, 5);
+      }
+    satch_assume (solver, -a);
+    int res = satch_solve (solver, -1);
+    assert (res == 20);
+    res = satch_solve (solver, -1);
+    assert (res == 10);
+    for (int i = 0; i < m; i++)
+      {
+	int parity = 0;
+	for (int k = 0; k < 5; k++)
+	  {
+	    const int lit = (x + (i * 7 + k * 5) % n) * ((i + k) % 3 ? 1 : -1);
+	    parity ^= satch_val (solver, lit) == lit;
+	  }
+	assert (parity);
+      }
+    satch_release (solver);
+  }
+  {
+    // Adding XOR constraints incrementally over eliminated variables and
+    // checking that an inconsistent linear system is refuted.
+
+    struct satch *solver = satch_init ();
+    const int x = 10;
+    for (int i = 0; i < 4; i++)
+      add_ternary (solver, x + i, x + i + 1, x + i + 2);
+    int res = satch_solve (solver, -1);
+    assert (res == 10);
+    const int first[4] = { x, x + 1, x + 2, x + 3 };
+    satch_add_xor (solver, first, 4);
+    const int second[5] = { x, -(x + 1), x + 2, x + 3, x + 4 };
+    satch_add_xor (solver, second, 5);
+    res = satch_solve (solver, -1);
+    assert (res == 10);
+    assert (satch_val (solver, x + 4) == x + 4);
+    int parity = 0;
+    for (int i = 0; i < 4; i++)
+      parity ^= satch_val (solver, x + i) > 0;
+    assert (parity);
+    const int third[2] = { x + 4, -(x + 4) };
+    satch_add_xor (solver, third, 2);
+    res = satch_solve (solver, -1);
+    assert (res == 10);
+    satch_add (solver, -(x + 4)), satch_add (solver, 0);
+    res = satch_solve (solver, -1);
+    assert (res == 20);
+    satch_release (solver);
+  }
+  {
+    // Cubes cover the search space and thus every cube of an unsatisfiable
+    // formula is refuted, while of a satisfiable one at least one is not.
+
+    for (int relax = 0; relax <= 100; relax += 100)
+      {
+	struct satch *solver = satch_init ();
+	add_relaxed_pigeon_hole (solver, 5, relax);
+	static struct cubes cubes;
+	cubes.count = cubes.size = 0;
+	int res = satch_cube (solver, 3, &cubes, collect_cube);
+	satch_release (solver);
+	assert (relax || res == 0 || res == 20);
+	assert (res || cubes.count > 1);
+	const int cubed = res;
+	int satisfiable = 0;
+	for (const int *p = cubes.literals, *q = p; p != cubes.literals +
+	     cubes.size; p = ++q)
+	  {
+	    solver = satch_init ();
+	    add_relaxed_pigeon_hole (solver, 5, relax);
+	    while (*q)
+	      satch_assume (solver, *q++);
+	    res = satch_solve (solver, -1);
+	    assert (res == 10 || res == 20);
+	    satisfiable |= (res == 10);
+	    satch_release (solver);
+	  }
+	assert (relax ? cubed == 10 || satisfiable : !satisfiable);
+      }
+  }
+  {
+    // Writing the timeline always yields a valid (possibly empty) trace.
+
+    struct satch *solver = satch_init ();
+    satch_enable_timeline (solver);
+    add_pigeon_hole (solver, 4);
+    int res = satch_solve (solver, -1);
+    assert (res == 20);
+    FILE *file = tmpfile ();
+    assert (file);
+    satch_write_timeline (solver, file);
+    rewind (file);
+    char prefix[16] = { 0 };
+    assert (fread (prefix, 1, 15, file) == 15);
+    assert (!strcmp (prefix, "{\"traceEvents\":"));
+    fclose (file);
+    satch_release (solver);
+  }
   return 0;
 }